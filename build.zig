@@ -63,7 +63,7 @@ fn homePath(target: ResolvedTarget, b: *Build) []const u8 {
                     HOME_PATH = b.pathJoin(&.{ home_drive, home_path });
                 }
             }
-        } else if (target.result.os.tag.isDarwin()) {
+        } else if (target.result.os.tag.isDarwin() or target.result.os.tag == .linux) {
             if (envmap.get("HOME")) |path| {
                 HOME_PATH = b.allocator.dupe(u8, path) catch @panic("OOM");
             } else {
@@ -1022,6 +1022,10 @@ pub fn build(b: *Build) !void {
             "-DOC_LOG_COMPILE_DEBUG",
         });
     }
+    if (target.result.os.tag == .linux) {
+        // needed for O_PATH, pthread_setname_np, etc.
+        try orca_platform_compile_flags.append(b.allocator, "-D_GNU_SOURCE");
+    }
     // if (target.result.os.tag == .windows) {
     //     try orca_platform_compile_flags.append("-Wl,--delayload=libEGL.dll");
     //     try orca_platform_compile_flags.append("-Wl,--delayload=libGLESv2.dll");
@@ -1089,6 +1093,12 @@ pub fn build(b: *Build) !void {
         orca_platform_lib.linkSystemLibrary2("webgpu", .{ .weak = true });
 
         try orca_platform_files.append(b.allocator, "src/orca.m");
+    } else if (target.result.os.tag == .linux) {
+        // The linux platform layer is headless and only needs libc. GLESv2 is still required
+        // by the runtime's GLES wasm bindings, and is provided by the system (e.g. mesa).
+        orca_platform_lib.linkSystemLibrary("pthread");
+        orca_platform_lib.linkSystemLibrary("m");
+        orca_platform_lib.linkSystemLibrary("GLESv2");
     }
 
     orca_platform_lib.addCSourceFiles(.{
@@ -1814,9 +1824,37 @@ pub fn build(b: *Build) !void {
             .name = "wrapped_types",
             .run = true,
         },
+        .{
+            .name = "text_buffer",
+            .run = true,
+        },
+        .{
+            .name = "json",
+            .run = true,
+        },
+        .{
+            .name = "utf8",
+            .run = true,
+        },
+        .{
+            .name = "hash",
+            .run = true,
+        },
+        .{
+            .name = "hash_map",
+            .run = true,
+        },
+        .{
+            .name = "pool",
+            .run = true,
+        },
         .{
             .name = "perf",
         },
+        .{
+            .name = "canvas_encoder",
+            .run = true,
+        },
         .{
             .name = "wasm_stdio",
             .run = true,
@@ -1876,6 +1914,7 @@ pub fn build(b: *Build) !void {
                 }),
             });
             test_exe.addIncludePath(b.path("src"));
+            test_exe.addIncludePath(b.path("src/ext"));
             test_exe.addCSourceFiles(.{
                 .files = &.{test_source},
                 .flags = &.{},
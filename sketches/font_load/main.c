@@ -0,0 +1,108 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+#if !OC_PLATFORM_WINDOWS
+    #include <sys/resource.h>
+#endif
+
+//NOTE: measures the time and memory it takes to load a font with every unicode range known to orca,
+//      and to then measure and outline a short multi-script string.
+
+static oc_unicode_range ALL_RANGES[] = {
+#define OC_UNICODE_RANGE(start, count, name) { start, count },
+    OC_UNICODE_RANGES
+#undef OC_UNICODE_RANGE
+};
+
+static const char* TEST_STRING =
+    "The quick brown fox jumps over the lazy dog. "
+    "Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. "
+    "Съешь же ещё этих мягких французских булок.";
+
+static long max_rss_kb(void)
+{
+#if !OC_PLATFORM_WINDOWS
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #if OC_PLATFORM_MACOS
+    return (usage.ru_maxrss / 1024);
+    #else
+    return (usage.ru_maxrss);
+    #endif
+#else
+    return (0);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 fontPath = argc > 1
+                         ? OC_STR8(argv[1])
+                         : oc_path_executable_relative(scratch.allocator, OC_STR8("../../resources/OpenSans-Regular.ttf"));
+
+    oc_file file = oc_file_open(fontPath, OC_FILE_ACCESS_READ, 0).value;
+    if(oc_file_is_nil(file))
+    {
+        oc_log_error("Could not open font file '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    u64 size = oc_file_size(file);
+    char* fontData = oc_arena_push_uninitialized(scratch.arena, size);
+    oc_file_read(file, size, fontData);
+    oc_file_close(file);
+
+    u32 rangeCount = sizeof(ALL_RANGES) / sizeof(oc_unicode_range);
+    u64 codePointCount = 0;
+    for(int i = 0; i < rangeCount; i++)
+    {
+        codePointCount += ALL_RANGES[i].count;
+    }
+
+    oc_canvas_context context = oc_canvas_context_create();
+
+    long startRSS = max_rss_kb();
+    f64 startTime = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+    oc_font font = oc_font_create_from_memory(oc_str8_from_buffer(size, fontData), rangeCount, ALL_RANGES);
+
+    f64 loadTime = oc_clock_time(OC_CLOCK_MONOTONIC);
+    long loadRSS = max_rss_kb();
+
+    oc_str8 text = OC_STR8((char*)TEST_STRING);
+    oc_text_metrics metrics = oc_font_text_metrics(font, 16, text);
+
+    oc_set_font(font);
+    oc_set_font_size(16);
+    oc_move_to(0, -metrics.logical.y);
+    oc_text_outlines(text);
+    oc_fill();
+
+    f64 textTime = oc_clock_time(OC_CLOCK_MONOTONIC);
+    long textRSS = max_rss_kb();
+
+    printf("font: %.*s, %u ranges, %llu codepoints\n", oc_str8_ip(fontPath), rangeCount, (unsigned long long)codePointCount);
+    printf("load:       %8.3fms, max RSS +%ldKB\n", (loadTime - startTime) * 1000, loadRSS - startRSS);
+    printf("first text: %8.3fms, max RSS +%ldKB\n", (textTime - loadTime) * 1000, textRSS - loadRSS);
+
+    oc_font_destroy(font);
+    oc_canvas_context_destroy(context);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
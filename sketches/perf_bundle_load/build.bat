@@ -0,0 +1,6 @@
+
+set INCLUDES=/I ..\..\src /I ..\..\src\util /I ..\..\src\platform /I ../../ext /I ../../ext/angle_headers
+
+if not exist "bin" mkdir bin
+cl /we4013 /Zi /Zc:preprocessor /std:c11 /experimental:c11atomics %INCLUDES% main.c /link /LIBPATH:../../build/bin orca.dll.lib zip.lib zlib.lib /out:bin/example_perf_bundle_load.exe
+copy ..\..\build\bin\orca.dll bin
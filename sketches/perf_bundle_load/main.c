@@ -0,0 +1,219 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+#include "runtime/runtime_bundle.c"
+
+//NOTE: measures the time it takes to load an app bundle until the first frame can run, ie. until the wasm module
+//      and the first resource of the app are loaded. The bundle has a 1MB module and data files of 1MB, half of
+//      them stored (like already compressed images) and half of them deflated (like text).
+//
+//      - legacy: extracts the whole bundle to a temporary directory in 1KB chunks, then copies data/ to the user
+//        data directory, as the runtime used to do.
+//      - extract: extracts data/ to the user data directory with several threads.
+//      - archive: serves data/ from the archive.
+
+enum
+{
+    FILE_SIZE = 1 << 20,
+};
+
+static oc_str8 make_contents(u64 size, bool compressible, u32 seed)
+{
+    char* ptr = malloc(size);
+    u32 x = seed * 2654435761u + 1;
+    for(u64 i = 0; i < size; i++)
+    {
+        x = x * 1664525 + 1013904223;
+        ptr[i] = compressible ? "orca app data "[(i + (x >> 28)) % 14] : (char)(x >> 24);
+    }
+    return (oc_str8_from_buffer(size, ptr));
+}
+
+static void add_entry(zip_t* zip, oc_str8 name, oc_str8 contents, bool stored)
+{
+    zip_source_t* source = zip_source_buffer(zip, contents.ptr, contents.len, 1);
+    i64 index = zip_file_add(zip, name.ptr, source, ZIP_FL_OVERWRITE);
+    zip_set_file_compression(zip, index, stored ? ZIP_CM_STORE : ZIP_CM_DEFLATE, 0);
+}
+
+static void make_bundle(oc_str8 path, u64 fileCount)
+{
+    oc_scratch scratch = oc_scratch_begin();
+
+    zip_t* zip = zip_open(path.ptr, ZIP_CREATE | ZIP_TRUNCATE, 0);
+    add_entry(zip, OC_STR8("modules/main.wasm"), make_contents(FILE_SIZE, true, 0), false);
+
+    for(u64 i = 0; i < fileCount; i++)
+    {
+        oc_str8 name = oc_str8_pushf(scratch.allocator, "data/dir%llu/file%llu.bin", (unsigned long long)(i / 32), (unsigned long long)i);
+        add_entry(zip, name, make_contents(FILE_SIZE, i % 2, i + 1), !(i % 2));
+    }
+    zip_close(zip);
+
+    oc_scratch_end(scratch);
+}
+
+static void remove_dir(oc_str8 path)
+{
+    oc_file_remove(path, &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_RECURSIVE });
+}
+
+static oc_str8 legacy_load(oc_str8 bundlePath, oc_str8 tmpDir, oc_str8 dataDir)
+{
+    oc_scratch scratch = oc_scratch_begin();
+
+    zip_t* zip = zip_open(bundlePath.ptr, ZIP_RDONLY, 0);
+    i64 count = zip_get_num_entries(zip, 0);
+    for(i64 entryIndex = 0; entryIndex < count; entryIndex++)
+    {
+        oc_str8 name = OC_STR8(zip_get_name(zip, entryIndex, 0));
+        oc_str8 dstPath = oc_path_append(scratch.allocator, tmpDir, name);
+
+        oc_file_makedir(oc_path_slice_directory(dstPath), &(oc_file_makedir_options){ .flags = OC_FILE_MAKEDIR_CREATE_PARENTS | OC_FILE_MAKEDIR_IGNORE_EXISTING });
+
+        zip_file_t* srcFile = zip_fopen_index(zip, entryIndex, 0);
+        FILE* dstFile = fopen(dstPath.ptr, "wb");
+        char chunk[1024];
+        i64 n = 0;
+        while((n = zip_fread(srcFile, chunk, 1024)) > 0)
+        {
+            fwrite(chunk, 1, n, dstFile);
+        }
+        fclose(dstFile);
+        zip_fclose(srcFile);
+    }
+    zip_close(zip);
+
+    oc_file_copy(oc_path_append(scratch.allocator, tmpDir, OC_STR8("data/")),
+                 dataDir,
+                 &(oc_file_copy_options){ .flags = OC_FILE_COPY_REPLACE_EXISTING });
+
+    oc_str8 modulePath = oc_path_append(scratch.allocator, tmpDir, OC_STR8("modules/main.wasm"));
+    oc_file file = oc_file_open(modulePath, OC_FILE_ACCESS_READ, 0).value;
+    oc_str8 module = { .len = oc_file_size(file) };
+    module.ptr = malloc(module.len);
+    oc_file_read(file, module.len, module.ptr);
+    oc_file_close(file);
+
+    oc_scratch_end(scratch);
+    return (module);
+}
+
+static u64 read_resource(oc_file_table* table, oc_bundle* bundle, oc_file root, oc_str8 name, char* buffer)
+{
+    oc_io_req req = {
+        .op = OC_IO_OPEN,
+        .handle = root,
+        .open.rights = OC_FILE_ACCESS_READ,
+        .size = name.len,
+        .buffer = name.ptr,
+    };
+    oc_io_cmp cmp = { 0 };
+    if(!bundle || !oc_bundle_handle_open(bundle, table, root, &req, &cmp))
+    {
+        cmp = oc_io_wait_single_req_for_table(&req, table);
+    }
+    oc_file file = cmp.handle;
+
+    req = (oc_io_req){ .op = OC_IO_READ, .handle = file, .size = FILE_SIZE, .buffer = buffer };
+    u64 size = oc_io_wait_single_req_for_table(&req, table).size;
+
+    req = (oc_io_req){ .op = OC_IO_CLOSE, .handle = file };
+    oc_io_wait_single_req_for_table(&req, table);
+    return (size);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    u64 megabytes = (argc > 1) ? atoll(argv[1]) : 1024;
+    u64 fileCount = megabytes;
+
+    oc_str8 workDir = oc_path_append(scratch.allocator, oc_file_tmp_directory_path(scratch.allocator), OC_STR8("orca_perf_bundle_load"));
+    remove_dir(workDir);
+    oc_file_makedir(workDir, 0);
+
+    oc_str8 bundlePath = oc_path_append(scratch.allocator, workDir, OC_STR8("app.orca"));
+    oc_str8 tmpDir = oc_path_append(scratch.allocator, workDir, OC_STR8("tmp"));
+    oc_str8 dataDir = oc_path_append(scratch.allocator, workDir, OC_STR8("userdata"));
+
+    printf("generating a %llu MB bundle...\n", (unsigned long long)megabytes);
+    make_bundle(bundlePath, fileCount);
+
+    char* buffer = malloc(FILE_SIZE);
+    oc_str8 firstResource = OC_STR8("dir0/file1.bin");
+
+    printf("%-10s %18s %18s\n", "mode", "first frame (s)", "read all (s)");
+
+    const char* modeNames[] = { "legacy", "extract", "archive" };
+    for(int mode = 0; mode < 3; mode++)
+    {
+        remove_dir(tmpDir);
+        remove_dir(dataDir);
+        oc_file_makedir(dataDir, 0);
+
+        oc_file_table table = { 0 };
+        oc_bundle bundle = { 0 };
+
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        oc_str8 module = { 0 };
+        if(mode == 0)
+        {
+            module = legacy_load(bundlePath, tmpDir, dataDir);
+        }
+        else
+        {
+            oc_bundle_open(&bundle, bundlePath, dataDir, mode == 1);
+            module = oc_bundle_read(scratch.allocator, &bundle, OC_STR8("modules/main.wasm"));
+        }
+
+        oc_io_req req = { .op = OC_IO_OPEN, .open.rights = OC_FILE_ACCESS_READ, .size = dataDir.len, .buffer = dataDir.ptr };
+        oc_file root = oc_io_wait_single_req_for_table(&req, &table).handle;
+
+        u64 size = read_resource(&table, (mode == 2) ? &bundle : 0, root, firstResource, buffer);
+
+        f64 firstFrame = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        for(u64 i = 0; i < fileCount; i++)
+        {
+            oc_str8 name = oc_str8_pushf(scratch.allocator, "dir%llu/file%llu.bin", (unsigned long long)(i / 32), (unsigned long long)i);
+            size += read_resource(&table, (mode == 2) ? &bundle : 0, root, name, buffer);
+        }
+
+        f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        if(!module.len || size != (fileCount + 1) * FILE_SIZE)
+        {
+            oc_log_error("%s: read %llu bytes\n", modeNames[mode], (unsigned long long)size);
+        }
+        printf("%-10s %18.3f %18.3f\n", modeNames[mode], firstFrame - start, end - firstFrame);
+
+        if(mode == 0)
+        {
+            free(module.ptr);
+        }
+        oc_bundle_close(&bundle);
+    }
+
+    remove_dir(workDir);
+
+    free(buffer);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,197 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures keystroke latency, ie the time of a frame that processes one typed character, for the
+//      single line text box and the text editor, for increasing document sizes.
+
+typedef enum
+{
+    EDITOR_MODE_TEXT_BOX,
+    EDITOR_MODE_TEXT_EDITOR,
+} editor_mode;
+
+static const char* MODE_NAMES[] = { "text box", "text editor" };
+
+static oc_str8 make_document(oc_allocator* allocator, u64 size)
+{
+    oc_str8_list list = { 0 };
+    for(u64 i = 0; list.len < size; i++)
+    {
+        oc_str8_list_pushf(allocator, &list, "Line %llu: lorem ipsum dolor sit amet, consectetur adipiscing elit\n", (unsigned long long)i);
+    }
+    return (oc_str8_list_join(allocator, list));
+}
+
+static void send_event(oc_event event)
+{
+    oc_ui_process_event(&event);
+}
+
+typedef struct frame_times
+{
+    f64 average;
+    f64 worst;
+} frame_times;
+
+static frame_times run(oc_font font, editor_mode mode, oc_str8 document, int keyCount, u32 seed)
+{
+    oc_ui_context* ui = oc_ui_context_create(font);
+    oc_arena arena;
+    oc_arena_init(&arena);
+    oc_arena textArena;
+    oc_arena_init(&textArena);
+
+    oc_text_buffer buffer = { 0 };
+    oc_ui_text_editor_info editorInfo = { .buffer = &buffer, .cursorX = -1 };
+    oc_ui_text_box_info boxInfo = { 0 };
+
+    if(mode == EDITOR_MODE_TEXT_EDITOR)
+    {
+        oc_text_buffer_init_from_str8(&buffer, document);
+    }
+    else
+    {
+        boxInfo.text = document;
+    }
+
+    //NOTE: click in the middle of the widget to give it focus, then type one character per frame
+    send_event((oc_event){ .type = OC_EVENT_MOUSE_MOVE, .mouse = { .x = 200, .y = 100 } });
+
+    //NOTE: the first keystrokes are warmup, they grow the frame arenas and caches to their steady state
+    int warmup = 64;
+    frame_times times = { 0 };
+    for(int frame = 0; frame < keyCount + warmup; frame++)
+    {
+        if(frame == 1)
+        {
+            send_event((oc_event){ .type = OC_EVENT_MOUSE_BUTTON, .key = { .action = OC_KEY_PRESS, .button = OC_MOUSE_LEFT, .clickCount = 1 } });
+        }
+        else if(frame == 2)
+        {
+            send_event((oc_event){ .type = OC_EVENT_MOUSE_BUTTON, .key = { .action = OC_KEY_RELEASE, .button = OC_MOUSE_LEFT } });
+        }
+        else if(frame > 2)
+        {
+            //NOTE: the typed text depends on the seed, so that runs don't hit the shaped strings cached by
+            //      previous runs
+            oc_utf32 c = 'a' + (frame + 7 * seed) % 26;
+            send_event((oc_event){ .type = OC_EVENT_KEYBOARD_CHAR, .character = { .codepoint = c, .sequence = { c }, .seqLen = 1 } });
+        }
+
+        //NOTE: we don't render the frames, so we use a new canvas context each frame to discard the commands
+        oc_canvas_context context = oc_canvas_context_create();
+        oc_canvas_context_select(context);
+
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        oc_vec2 frameSize = { 800, 600 };
+        oc_ui_frame(frameSize)
+        {
+            oc_ui_box("panel")
+            {
+                oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, 800 });
+                oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, 600 });
+
+                if(mode == EDITOR_MODE_TEXT_EDITOR)
+                {
+                    oc_ui_text_editor("editor", &editorInfo);
+                }
+                else
+                {
+                    oc_ui_text_box_result result = oc_ui_text_box("text box", &textArena, &boxInfo);
+                    if(result.changed)
+                    {
+                        boxInfo.text = result.text;
+                    }
+                }
+            }
+        }
+        oc_ui_draw();
+
+        f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+        if(frame >= warmup)
+        {
+            times.average += end - start;
+            times.worst = oc_max(times.worst, end - start);
+        }
+        oc_arena_clear(&arena);
+        oc_canvas_context_destroy(context);
+    }
+    times.average = times.average * 1000 / keyCount;
+    times.worst *= 1000;
+
+    oc_ui_text_editor_cleanup(&editorInfo);
+    oc_text_buffer_cleanup(&buffer);
+    oc_arena_cleanup(&textArena);
+    oc_arena_cleanup(&arena);
+    oc_ui_context_destroy(ui);
+
+    return (times);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 fontPath = argc > 1
+                         ? OC_STR8(argv[1])
+                         : oc_path_executable_relative(scratch.allocator, OC_STR8("../../resources/OpenSans-Regular.ttf"));
+
+    oc_file file = oc_file_open(fontPath, OC_FILE_ACCESS_READ, 0).value;
+    if(oc_file_is_nil(file))
+    {
+        oc_log_error("Could not open font file '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    u64 size = oc_file_size(file);
+    char* fontData = oc_arena_push_uninitialized(scratch.arena, size);
+    oc_file_read(file, size, fontData);
+    oc_file_close(file);
+
+    oc_unicode_range ranges[] = { OC_UNICODE_BASIC_LATIN };
+    oc_font font = oc_font_create_from_memory(oc_str8_from_buffer(size, fontData), 1, ranges);
+
+    u64 documentSizes[] = { 10 << 10, 100 << 10, 1 << 20, 10 << 20 };
+    printf("%-12s %12s %14s %14s\n", "mode", "bytes", "avg ms/key", "worst ms/key");
+
+    for(int mode = 0; mode <= EDITOR_MODE_TEXT_EDITOR; mode++)
+    {
+        for(int i = 0; i < oc_array_size(documentSizes); i++)
+        {
+            //NOTE: the text box re-measures and redraws the whole string on each keystroke, and overflows the
+            //      canvas path buffer past a few tens of kilobytes
+            if(mode == EDITOR_MODE_TEXT_BOX && documentSizes[i] > (10 << 10))
+            {
+                break;
+            }
+            oc_str8 document = make_document(scratch.allocator, documentSizes[i]);
+            int keyCount = (mode == EDITOR_MODE_TEXT_BOX) ? 20 : 200;
+
+            frame_times times = run(font, mode, document, keyCount, i);
+            printf("%-12s %12llu %14.3f %14.3f\n",
+                   MODE_NAMES[mode],
+                   (unsigned long long)document.len,
+                   times.average,
+                   times.worst);
+        }
+    }
+
+    oc_font_destroy(font);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,189 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures copying a data directory of 10000 files of 1KB to 64KB, spread over 100 directories.
+//
+//      - per file: walks the tree with one request per directory and file, and copies each file through a buffer,
+//        as oc_file_copy() used to do.
+//      - tree: copies the tree with oc_file_copy(), which copies all the files in a single request, in the kernel
+//        when possible, and with several threads.
+
+enum
+{
+    DIR_COUNT = 100,
+    FILES_PER_DIR = 100,
+    CHUNK_SIZE = 64 << 10,
+};
+
+static void make_tree(oc_arena* arena, oc_file root)
+{
+    char* contents = malloc(CHUNK_SIZE);
+    for(u64 i = 0; i < CHUNK_SIZE; i++)
+    {
+        contents[i] = "orca data "[i % 10];
+    }
+
+    u32 seed = 1;
+    for(u32 dir = 0; dir < DIR_COUNT; dir++)
+    {
+        oc_file_makedir(oc_str8_pushf(arena, "data/dir%u", dir),
+                        &(oc_file_makedir_options){
+                            .root = root,
+                            .flags = OC_FILE_MAKEDIR_CREATE_PARENTS | OC_FILE_MAKEDIR_IGNORE_EXISTING,
+                        });
+
+        for(u32 i = 0; i < FILES_PER_DIR; i++)
+        {
+            oc_str8 path = oc_str8_pushf(arena, "data/dir%u/file%u.bin", dir, i);
+            oc_file file = oc_file_open(path,
+                                        OC_FILE_ACCESS_WRITE,
+                                        &(oc_file_open_options){
+                                            .root = root,
+                                            .flags = OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE,
+                                        })
+                               .value;
+
+            seed = seed * 1664525 + 1013904223;
+            u64 size = (1 << 10) + (seed >> 8) % (CHUNK_SIZE - (1 << 10));
+            oc_file_write(file, size, contents);
+            oc_file_close(file);
+        }
+        oc_arena_clear(arena);
+    }
+    free(contents);
+}
+
+static oc_io_error copy_per_file(oc_arena* arena, oc_file root, oc_str8 src, oc_str8 dst, char* chunk)
+{
+    oc_file srcFile = oc_file_open(src, OC_FILE_ACCESS_READ, &(oc_file_open_options){ .root = root }).value;
+    oc_file_status status = oc_file_get_status(srcFile);
+    oc_io_error error = OC_IO_OK;
+
+    if(status.type == OC_FILE_DIRECTORY)
+    {
+        oc_file_makedir(dst, &(oc_file_makedir_options){ .root = root, .flags = OC_FILE_MAKEDIR_IGNORE_EXISTING });
+
+        oc_file_list list = oc_file_listdir(arena->allocator, srcFile);
+        oc_file_list_for(list, elt)
+        {
+            error = copy_per_file(arena,
+                                  root,
+                                  oc_path_append(arena->allocator, src, elt->basename),
+                                  oc_path_append(arena->allocator, dst, elt->basename),
+                                  chunk);
+            if(error)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        oc_file dstFile = oc_file_open(dst,
+                                       OC_FILE_ACCESS_WRITE,
+                                       &(oc_file_open_options){
+                                           .root = root,
+                                           .flags = OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE,
+                                       })
+                              .value;
+        u64 n = 0;
+        while((n = oc_file_read(srcFile, CHUNK_SIZE, chunk)) > 0)
+        {
+            oc_file_write(dstFile, n, chunk);
+        }
+        error = oc_file_last_error(dstFile);
+        oc_file_close(dstFile);
+    }
+    oc_file_close(srcFile);
+    return (error);
+}
+
+static u64 tree_size(oc_arena* arena, oc_file root, oc_str8 path)
+{
+    u64 size = 0;
+    for(u32 dir = 0; dir < DIR_COUNT; dir++)
+    {
+        for(u32 i = 0; i < FILES_PER_DIR; i++)
+        {
+            oc_str8 filePath = oc_str8_pushf(arena, "%.*s/dir%u/file%u.bin", oc_str8_ip(path), dir, i);
+            oc_file file = oc_file_open(filePath, OC_FILE_ACCESS_READ, &(oc_file_open_options){ .root = root }).value;
+            size += oc_file_size(file);
+            oc_file_close(file);
+        }
+    }
+    return (size);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    oc_scratch scratch = oc_scratch_begin();
+    //NOTE: the directory where the tree is created can be passed as argument, to compare filesystems
+    oc_str8 parentDir = (argc > 1) ? OC_STR8(argv[1]) : oc_file_tmp_directory_path(scratch.allocator);
+    oc_str8 workDir = oc_path_append(scratch.allocator, parentDir, OC_STR8("orca_perf_file_copy"));
+    oc_file_remove(workDir, &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_RECURSIVE });
+    oc_file_makedir(workDir, 0);
+    oc_file root = oc_file_open(workDir, OC_FILE_ACCESS_READ | OC_FILE_ACCESS_WRITE, 0).value;
+
+    printf("generating %u files...\n", DIR_COUNT * FILES_PER_DIR);
+    make_tree(&arena, root);
+    u64 size = tree_size(&arena, root, OC_STR8("data"));
+
+    char* chunk = malloc(CHUNK_SIZE);
+    printf("%-10s %14s\n", "mode", "time (ms)");
+
+    //NOTE: modes are alternated, so that they see the same state of the page cache and writeback
+    const char* modeNames[] = { "per file", "tree" };
+    for(int run = 0; run < 6; run++)
+    {
+        int mode = run % 2;
+        oc_file_remove(OC_STR8("copy"), &(oc_file_remove_options){ .root = root, .flags = OC_FILE_REMOVE_RECURSIVE });
+
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        oc_io_error error = OC_IO_OK;
+        if(mode == 0)
+        {
+            error = copy_per_file(&arena, root, OC_STR8("data"), OC_STR8("copy"), chunk);
+        }
+        else
+        {
+            error = oc_file_copy(OC_STR8("data"), OC_STR8("copy"), &(oc_file_copy_options){ .srcRoot = root, .dstRoot = root });
+        }
+
+        f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        if(error || tree_size(&arena, root, OC_STR8("copy")) != size)
+        {
+            oc_log_error("%s: copy failed\n", modeNames[mode]);
+        }
+        printf("%-10s %14.3f\n", modeNames[mode], (end - start) * 1000);
+
+        oc_arena_clear(&arena);
+    }
+
+    free(chunk);
+    oc_file_close(root);
+    oc_file_remove(workDir, &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_RECURSIVE });
+
+    oc_scratch_end(scratch);
+    oc_arena_cleanup(&arena);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,113 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the latency of opening a file under a root directory, as the runtime does for guest files,
+//      for increasing path depths. Each iteration opens and closes the file at the bottom of a chain of directories.
+
+static oc_str8 make_chain(oc_allocator* allocator, oc_file root, u64 depth)
+{
+    oc_str8_list list = { 0 };
+    for(u64 i = 0; i < depth; i++)
+    {
+        oc_str8_list_pushf(allocator, &list, "dir%llu", (unsigned long long)i);
+    }
+    oc_str8 dirPath = oc_path_join(allocator, list);
+
+    oc_io_error error = oc_file_makedir(dirPath,
+                                        &(oc_file_makedir_options){
+                                            .root = root,
+                                            .flags = OC_FILE_MAKEDIR_CREATE_PARENTS | OC_FILE_MAKEDIR_IGNORE_EXISTING,
+                                        });
+    if(error != OC_IO_OK)
+    {
+        oc_log_error("Could not create directory '%.*s'\n", oc_str8_ip(dirPath));
+        exit(-1);
+    }
+
+    oc_str8 filePath = oc_path_append(allocator, dirPath, OC_STR8("file.txt"));
+    oc_file file = oc_catch(oc_file_open(filePath,
+                                         OC_FILE_ACCESS_WRITE,
+                                         &(oc_file_open_options){
+                                             .root = root,
+                                             .flags = OC_FILE_OPEN_CREATE,
+                                         }))
+    {
+        oc_log_error("Could not create file '%.*s'\n", oc_str8_ip(filePath));
+        exit(-1);
+    }
+    oc_file_close(file);
+
+    return (filePath);
+}
+
+static f64 run(oc_file root, oc_str8 path, int openCount)
+{
+    //NOTE: the first opens are warmup
+    int warmup = 100;
+    f64 start = 0;
+    for(int i = 0; i < openCount + warmup; i++)
+    {
+        if(i == warmup)
+        {
+            start = oc_clock_time(OC_CLOCK_MONOTONIC);
+        }
+        oc_file file = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, &(oc_file_open_options){ .root = root }))
+        {
+            oc_log_error("Could not open file '%.*s'\n", oc_str8_ip(path));
+            exit(-1);
+        }
+        oc_file_close(file);
+    }
+    f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+    return ((end - start) * 1000000 / openCount);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 rootPath = oc_path_append(scratch.allocator,
+                                      oc_file_tmp_directory_path(scratch.allocator),
+                                      OC_STR8("orca_perf_file_open"));
+
+    oc_file_remove(rootPath, &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_DIR | OC_FILE_REMOVE_RECURSIVE });
+    oc_file_makedir(rootPath, 0);
+
+    oc_file root = oc_catch(oc_file_open(rootPath, OC_FILE_ACCESS_READ | OC_FILE_ACCESS_WRITE, 0))
+    {
+        oc_log_error("Could not open root directory '%.*s'\n", oc_str8_ip(rootPath));
+        return (-1);
+    }
+
+    u64 depths[] = { 1, 4, 16, 64 };
+    printf("%8s %14s\n", "depth", "us/open");
+
+    for(int i = 0; i < oc_array_size(depths); i++)
+    {
+        oc_str8 path = make_chain(scratch.allocator, root, depths[i]);
+        f64 time = run(root, path, 20000);
+        printf("%8llu %14.3f\n", (unsigned long long)depths[i], time);
+    }
+
+    oc_file_close(root);
+    oc_file_remove(rootPath, &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_DIR | OC_FILE_REMOVE_RECURSIVE });
+
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
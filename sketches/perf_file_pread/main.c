@@ -0,0 +1,166 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures random reads of 4KB blocks in a large file, through the io request API.
+//
+//      - seek+read: one seek and one read request per block.
+//      - pread: one positional read request per block.
+//      - seek+read x16: reads runs of 16 consecutive blocks into separate buffers, one seek and 16 reads per run.
+//      - readv x16: reads runs of 16 consecutive blocks into separate buffers, with one vectored read request.
+//
+//      Natively, a request is a function call, so this mostly measures the number of syscalls. In a wasm app,
+//      each request also crosses the host boundary, which is not measured here.
+
+enum
+{
+    BLOCK_SIZE = 4 << 10,
+    RUN_LENGTH = 16,
+};
+
+static u64 next_random(u64* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (*state);
+}
+
+static void make_file(oc_str8 path, u64 size)
+{
+    oc_file file = oc_file_open(path, OC_FILE_ACCESS_WRITE, &(oc_file_open_options){ .flags = OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE }).value;
+
+    u64 chunkSize = 1 << 20;
+    u64* chunk = malloc(chunkSize);
+    u64 state = 0x9e3779b97f4a7c15;
+    for(u64 offset = 0; offset < size; offset += chunkSize)
+    {
+        for(u64 i = 0; i < chunkSize / sizeof(u64); i++)
+        {
+            chunk[i] = next_random(&state);
+        }
+        oc_file_write(file, chunkSize, (char*)chunk);
+    }
+    free(chunk);
+    oc_file_close(file);
+}
+
+typedef enum
+{
+    MODE_SEEK_READ,
+    MODE_PREAD,
+    MODE_SEEK_READ_RUN,
+    MODE_READV,
+    MODE_COUNT,
+} read_mode;
+
+static const char* MODE_NAMES[] = { "seek+read", "pread", "seek+read x16", "readv x16" };
+
+static u64 run(oc_file file, u64 fileSize, read_mode mode, u64 blockCount, char* buffers)
+{
+    u64 state = 0x2545f4914f6cdd1d;
+    u64 runCount = fileSize / BLOCK_SIZE / RUN_LENGTH;
+    u64 total = 0;
+
+    if(mode == MODE_SEEK_READ || mode == MODE_PREAD)
+    {
+        for(u64 i = 0; i < blockCount; i++)
+        {
+            u64 offset = (next_random(&state) % (fileSize / BLOCK_SIZE)) * BLOCK_SIZE;
+            if(mode == MODE_SEEK_READ)
+            {
+                oc_file_seek(file, offset, OC_FILE_SEEK_SET);
+                total += oc_file_read(file, BLOCK_SIZE, buffers);
+            }
+            else
+            {
+                total += oc_file_pread(file, offset, BLOCK_SIZE, buffers);
+            }
+        }
+    }
+    else
+    {
+        oc_io_vec vecs[RUN_LENGTH];
+        for(u64 i = 0; i < RUN_LENGTH; i++)
+        {
+            vecs[i] = (oc_io_vec){ .buffer = buffers + i * BLOCK_SIZE, .size = BLOCK_SIZE };
+        }
+
+        for(u64 i = 0; i < blockCount / RUN_LENGTH; i++)
+        {
+            u64 offset = (next_random(&state) % runCount) * BLOCK_SIZE * RUN_LENGTH;
+            if(mode == MODE_SEEK_READ_RUN)
+            {
+                oc_file_seek(file, offset, OC_FILE_SEEK_SET);
+                for(u64 j = 0; j < RUN_LENGTH; j++)
+                {
+                    total += oc_file_read(file, BLOCK_SIZE, vecs[j].buffer);
+                }
+            }
+            else
+            {
+                total += oc_file_readv(file, offset, RUN_LENGTH, vecs);
+            }
+        }
+    }
+    return (total);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    u64 megabytes = (argc > 1) ? atoll(argv[1]) : 1024;
+    u64 fileSize = megabytes << 20;
+    u64 blockCount = 1 << 18;
+
+    oc_str8 path = oc_path_append(scratch.allocator, oc_file_tmp_directory_path(scratch.allocator), OC_STR8("orca_perf_file_pread.bin"));
+
+    printf("generating a %llu MB file...\n", (unsigned long long)megabytes);
+    make_file(path, fileSize);
+
+    oc_file file = oc_file_open(path, OC_FILE_ACCESS_READ, 0).value;
+    char* buffers = malloc(BLOCK_SIZE * RUN_LENGTH);
+
+    //NOTE: warm up the page cache, so that all modes read from memory
+    run(file, fileSize, MODE_PREAD, blockCount, buffers);
+
+    printf("%-14s %10s %14s %12s\n", "mode", "blocks", "time (ms)", "MB/s");
+    for(int mode = 0; mode < MODE_COUNT; mode++)
+    {
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+        u64 size = run(file, fileSize, mode, blockCount, buffers);
+        f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        if(size != blockCount * BLOCK_SIZE)
+        {
+            oc_log_error("%s: read %llu bytes\n", MODE_NAMES[mode], (unsigned long long)size);
+        }
+        printf("%-14s %10llu %14.3f %12.1f\n",
+               MODE_NAMES[mode],
+               (unsigned long long)blockCount,
+               (end - start) * 1000,
+               size / (end - start) / (1 << 20));
+    }
+
+    free(buffers);
+    oc_file_close(file);
+    oc_file_remove(path, 0);
+
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,154 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the latency of opening files under a root directory, as the runtime does for guest files, across
+//      a tree of 1000 directories holding 100 files each. Files are opened either directory by directory, or in a
+//      random order.
+
+enum
+{
+    TREE_FANOUT = 10,
+    FILES_PER_DIR = 100,
+    FILE_COUNT = TREE_FANOUT * TREE_FANOUT * TREE_FANOUT * FILES_PER_DIR,
+};
+
+static oc_str8 file_path(oc_arena* arena, u32 index)
+{
+    u32 dir = index / FILES_PER_DIR;
+    return (oc_str8_pushf(arena,
+                          "assets/level%u/group%u/set%u/file%u.txt",
+                          dir / (TREE_FANOUT * TREE_FANOUT),
+                          (dir / TREE_FANOUT) % TREE_FANOUT,
+                          dir % TREE_FANOUT,
+                          index % FILES_PER_DIR));
+}
+
+static void make_tree(oc_arena* arena, oc_file root)
+{
+    for(u32 i = 0; i < FILE_COUNT; i++)
+    {
+        oc_str8 path = file_path(arena, i);
+
+        if(i % FILES_PER_DIR == 0)
+        {
+            oc_str8 dirPath = oc_str8_slice(path, 0, path.len - OC_STR8("/file0.txt").len);
+            oc_io_error error = oc_file_makedir(dirPath,
+                                                &(oc_file_makedir_options){
+                                                    .root = root,
+                                                    .flags = OC_FILE_MAKEDIR_CREATE_PARENTS | OC_FILE_MAKEDIR_IGNORE_EXISTING,
+                                                });
+            if(error != OC_IO_OK)
+            {
+                oc_log_error("Could not create directory '%.*s'\n", oc_str8_ip(dirPath));
+                exit(-1);
+            }
+        }
+
+        oc_file file = oc_catch(oc_file_open(path,
+                                             OC_FILE_ACCESS_WRITE,
+                                             &(oc_file_open_options){
+                                                 .root = root,
+                                                 .flags = OC_FILE_OPEN_CREATE,
+                                             }))
+        {
+            oc_log_error("Could not create file '%.*s'\n", oc_str8_ip(path));
+            exit(-1);
+        }
+        oc_file_close(file);
+
+        oc_arena_clear(arena);
+    }
+}
+
+static f64 run(oc_arena* arena, oc_file root, u32* order)
+{
+    f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+    for(u32 i = 0; i < FILE_COUNT; i++)
+    {
+        oc_str8 path = file_path(arena, order[i]);
+
+        oc_file file = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, &(oc_file_open_options){ .root = root }))
+        {
+            oc_log_error("Could not open file '%.*s'\n", oc_str8_ip(path));
+            exit(-1);
+        }
+        oc_file_close(file);
+
+        oc_arena_clear(arena);
+    }
+    f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+    return ((end - start) * 1000000 / FILE_COUNT);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    oc_str8 rootPath = oc_path_append(&arena,
+                                      oc_file_tmp_directory_path(&arena),
+                                      OC_STR8("orca_perf_file_tree"));
+
+    oc_file_remove(rootPath, &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_DIR | OC_FILE_REMOVE_RECURSIVE });
+    oc_file_makedir(rootPath, 0);
+
+    oc_file root = oc_catch(oc_file_open(rootPath, OC_FILE_ACCESS_READ | OC_FILE_ACCESS_WRITE, 0))
+    {
+        oc_log_error("Could not open root directory '%.*s'\n", oc_str8_ip(rootPath));
+        return (-1);
+    }
+
+    //NOTE: paths are built in a separate arena, which is cleared after each file
+    oc_arena pathArena;
+    oc_arena_init(&pathArena);
+
+    make_tree(&pathArena, root);
+
+    u32* order = oc_arena_push_array(&arena, u32, FILE_COUNT);
+    for(u32 i = 0; i < FILE_COUNT; i++)
+    {
+        order[i] = i;
+    }
+
+    printf("%-10s %8s %14s\n", "order", "files", "us/open");
+
+    f64 time = run(&pathArena, root, order);
+    printf("%-10s %8u %14.3f\n", "directory", FILE_COUNT, time);
+
+    //NOTE: shuffle with a fixed seed, so that runs are comparable
+    u32 seed = 1;
+    for(u32 i = FILE_COUNT - 1; i > 0; i--)
+    {
+        seed = seed * 1664525 + 1013904223;
+        u32 j = (seed >> 8) % (i + 1);
+        u32 tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    time = run(&pathArena, root, order);
+    printf("%-10s %8u %14.3f\n", "random", FILE_COUNT, time);
+
+    oc_file_close(root);
+    oc_file_remove(rootPath, &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_DIR | OC_FILE_REMOVE_RECURSIVE });
+
+    oc_arena_cleanup(&pathArena);
+    oc_arena_cleanup(&arena);
+    oc_terminate();
+
+    return (0);
+}
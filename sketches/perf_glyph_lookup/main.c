@@ -0,0 +1,228 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the throughput of codepoint to glyph index lookups, in millions of codepoints per second, for a font
+//      loaded with ranges covering many scripts. oc_font_get_glyph_indices() converts runs of basic latin four
+//      codepoints at a time and looks other codepoints up in the font's page table, while oc_font_get_glyph_index()
+//      looks up a single codepoint. Mixed text alternates short runs of latin, greek, cyrillic, arabic, CJK, hangul
+//      and arrows. The last column gives the share of codepoints outside the font's ranges, which map to glyph 0.
+
+enum
+{
+    TEXT_COUNT = 4 << 20,
+    RUN_COUNT = 20,
+};
+
+typedef enum
+{
+    TEXT_ASCII,
+    TEXT_LATIN,
+    TEXT_MIXED,
+    TEXT_KIND_COUNT,
+} text_kind;
+
+static const char* TEXT_NAMES[TEXT_KIND_COUNT] = { "ascii", "latin", "mixed" };
+
+static oc_unicode_range* font_ranges(u32* count)
+{
+    static oc_unicode_range ranges[] = {
+        OC_UNICODE_BASIC_LATIN,
+        OC_UNICODE_C1_CONTROLS_AND_LATIN_1_SUPPLEMENT,
+        OC_UNICODE_LATIN_EXTENDED_A,
+        OC_UNICODE_LATIN_EXTENDED_B,
+        OC_UNICODE_IPA_EXTENSIONS,
+        OC_UNICODE_SPACING_MODIFIER_LETTERS,
+        OC_UNICODE_COMBINING_DIACRITICAL_MARKS,
+        OC_UNICODE_GREEK_COPTIC,
+        OC_UNICODE_CYRILLIC,
+        OC_UNICODE_CYRILLIC_SUPPLEMENT,
+        OC_UNICODE_ARMENIAN,
+        OC_UNICODE_HEBREW,
+        OC_UNICODE_ARABIC,
+        OC_UNICODE_DEVANAGARI,
+        OC_UNICODE_THAI,
+        OC_UNICODE_GEORGIAN,
+        OC_UNICODE_HANGUL_JAMO,
+        OC_UNICODE_LATIN_EXTENDED_ADDITIONAL,
+        OC_UNICODE_GREEK_EXTENDED,
+        OC_UNICODE_GENERAL_PUNCTUATION,
+        OC_UNICODE_SUPERSCRIPTS_AND_SUBSCRIPTS,
+        OC_UNICODE_CURRENCY_SYMBOLS,
+        OC_UNICODE_LETTERLIKE_SYMBOLS,
+        OC_UNICODE_NUMBER_FORMS,
+        OC_UNICODE_ARROWS,
+        OC_UNICODE_MATHEMATICAL_OPERATORS,
+        OC_UNICODE_MISCELLANEOUS_TECHNICAL,
+        OC_UNICODE_BOX_DRAWING,
+        OC_UNICODE_GEOMETRIC_SHAPES,
+        OC_UNICODE_MISCELLANEOUS_SYMBOLS,
+        OC_UNICODE_CJK_SYMBOLS_AND_PUNCTUATION,
+        OC_UNICODE_HIRAGANA,
+        OC_UNICODE_KATAKANA,
+        OC_UNICODE_CJK_UNIFIED_IDEOGRAPHS,
+        OC_UNICODE_HANGUL_SYLLABLES,
+        OC_UNICODE_SPECIALS,
+    };
+    *count = oc_array_size(ranges);
+    return (ranges);
+}
+
+static void make_text(text_kind kind, u32 count, oc_utf32* codePoints)
+{
+    //NOTE: mixed text picks a script for each run of a few codepoints
+    static const oc_unicode_range scripts[] = {
+        { 'a', 26 },
+        { 0x03b1, 25 },
+        { 0x0430, 32 },
+        { 0x0627, 26 },
+        { 0x4e00, 20000 },
+        { 0xac00, 11000 },
+        { 0x2190, 100 },
+    };
+
+    u32 rng = 12345;
+    for(u32 i = 0; i < count;)
+    {
+        rng = rng * 1664525 + 1013904223;
+        u32 runLen = 1 + (rng >> 8) % 12;
+        oc_unicode_range script = scripts[(rng >> 20) % oc_array_size(scripts)];
+
+        for(u32 j = 0; j < runLen && i < count; j++, i++)
+        {
+            rng = rng * 1664525 + 1013904223;
+            u32 r = rng >> 8;
+
+            switch(kind)
+            {
+                case TEXT_ASCII:
+                    codePoints[i] = (r % 6 == 0) ? ' ' : 'a' + r % 26;
+                    break;
+
+                case TEXT_LATIN:
+                    codePoints[i] = (r % 6 == 0) ? ' ' : ((r % 10 == 1) ? 0xe0 + r % 32 : 'a' + r % 26);
+                    break;
+
+                default:
+                    codePoints[i] = (r % 6 == 0) ? ' ' : script.firstCodePoint + r % script.count;
+                    break;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 fontPath = argc > 1
+                         ? OC_STR8(argv[1])
+                         : oc_path_executable_relative(scratch.allocator, OC_STR8("../../resources/OpenSans-Regular.ttf"));
+
+    oc_file file = oc_file_open(fontPath, OC_FILE_ACCESS_READ, 0).value;
+    if(oc_file_is_nil(file))
+    {
+        oc_log_error("Could not open font file '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    u64 size = oc_file_size(file);
+    char* fontData = oc_arena_push_uninitialized(scratch.arena, size);
+    oc_file_read(file, size, fontData);
+    oc_file_close(file);
+
+    u32 rangeCount = 0;
+    oc_unicode_range* ranges = font_ranges(&rangeCount);
+
+    oc_font font = oc_font_nil();
+    f64 bestCreateTime = 1e9;
+    for(int run = 0; run < RUN_COUNT; run++)
+    {
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+        oc_font candidate = oc_font_create_from_memory(oc_str8_from_buffer(size, fontData), rangeCount, ranges);
+        f64 time = oc_clock_time(OC_CLOCK_MONOTONIC) - start;
+        bestCreateTime = (time < bestCreateTime) ? time : bestCreateTime;
+
+        if(oc_font_is_nil(font))
+        {
+            font = candidate;
+        }
+        else
+        {
+            oc_font_destroy(candidate);
+        }
+    }
+    if(oc_font_is_nil(font))
+    {
+        oc_log_error("Could not create font from '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    printf("font creation with %u ranges: %.3f ms\n\n", rangeCount, bestCreateTime * 1000);
+
+    oc_utf32* codePoints = oc_arena_push_array_uninitialized(scratch.arena, oc_utf32, TEXT_COUNT);
+    u32* indices = oc_arena_push_array_uninitialized(scratch.arena, u32, TEXT_COUNT);
+    u32* reference = oc_arena_push_array_uninitialized(scratch.arena, u32, TEXT_COUNT);
+
+    printf("%-8s %16s %16s %10s\n", "text", "batch (Mcp/s)", "single (Mcp/s)", "unmapped");
+
+    for(int kind = 0; kind < TEXT_KIND_COUNT; kind++)
+    {
+        make_text(kind, TEXT_COUNT, codePoints);
+
+        oc_str32 text = { .ptr = codePoints, .len = TEXT_COUNT };
+        oc_str32 backing = { .ptr = indices, .len = TEXT_COUNT };
+
+        f64 bestBatchTime = 1e9;
+        f64 bestSingleTime = 1e9;
+
+        for(int run = 0; run < RUN_COUNT; run++)
+        {
+            f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+            oc_font_get_glyph_indices(font, text, backing);
+            f64 time = oc_clock_time(OC_CLOCK_MONOTONIC) - start;
+            bestBatchTime = (time < bestBatchTime) ? time : bestBatchTime;
+
+            start = oc_clock_time(OC_CLOCK_MONOTONIC);
+            for(u32 i = 0; i < TEXT_COUNT; i++)
+            {
+                reference[i] = oc_font_get_glyph_index(font, codePoints[i]);
+            }
+            time = oc_clock_time(OC_CLOCK_MONOTONIC) - start;
+            bestSingleTime = (time < bestSingleTime) ? time : bestSingleTime;
+        }
+
+        u32 unmapped = 0;
+        for(u32 i = 0; i < TEXT_COUNT; i++)
+        {
+            if(indices[i] != reference[i])
+            {
+                oc_log_error("glyph index mismatch for codepoint 0x%x: %u != %u\n", codePoints[i], indices[i], reference[i]);
+                return (-1);
+            }
+            unmapped += (indices[i] == 0);
+        }
+
+        printf("%-8s %16.1f %16.1f %9.1f%%\n",
+               TEXT_NAMES[kind],
+               TEXT_COUNT / bestBatchTime / 1e6,
+               TEXT_COUNT / bestSingleTime / 1e6,
+               100. * unmapped / TEXT_COUNT);
+    }
+
+    oc_font_destroy(font);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,135 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the throughput of xxHash64 and XXH3, one-shot and streaming, over a range of input sizes.
+//      Short inputs are typical of UI keys and map keys, long ones of files and module bytes. Results are in
+//      millions of hashes per second and in GB/s.
+
+enum
+{
+    RUN_COUNT = 5,
+    BYTES_PER_RUN = 256 << 20,
+    STREAM_PIECE_SIZE = 4096,
+};
+
+typedef enum
+{
+    MODE_XX64,
+    MODE_XXH3,
+    MODE_XXH3_STREAM,
+    MODE_COUNT,
+} hash_mode;
+
+static const char* MODE_NAMES[MODE_COUNT] = { "xx64", "xxh3", "xxh3 stream" };
+
+static u64 hash_once(hash_mode mode, oc_str8 string, u64 seed)
+{
+    u64 hash = 0;
+    switch(mode)
+    {
+        case MODE_XX64:
+            hash = oc_hash_xx64_string_seed(string, seed);
+            break;
+
+        case MODE_XXH3:
+            hash = oc_hash_xxh3_string_seed(string, seed);
+            break;
+
+        case MODE_XXH3_STREAM:
+        {
+            oc_hash_xxh3_state state;
+            oc_hash_xxh3_init(&state, seed);
+            for(u64 offset = 0; offset < string.len; offset += STREAM_PIECE_SIZE)
+            {
+                u64 size = string.len - offset;
+                size = (size < STREAM_PIECE_SIZE) ? size : STREAM_PIECE_SIZE;
+                oc_hash_xxh3_update(&state, oc_str8_slice(string, offset, offset + size));
+            }
+            hash = oc_hash_xxh3_digest(&state);
+        }
+        break;
+
+        default:
+            break;
+    }
+    return (hash);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    u64 sizes[] = { 8, 16, 32, 64, 128, 240, 256, 1024, 4096, 64 << 10, 16 << 20 };
+    u64 maxSize = sizes[oc_array_size(sizes) - 1];
+
+    char* buffer = malloc(maxSize);
+    u64 state = 0x2545f4914f6cdd1dULL;
+    for(u64 i = 0; i < maxSize; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        buffer[i] = (char)state;
+    }
+
+    printf("%-10s", "size");
+    for(int mode = 0; mode < MODE_COUNT; mode++)
+    {
+        printf(" %12s Mh/s %6s", MODE_NAMES[mode], "GB/s");
+    }
+    printf("\n");
+
+    for(u32 sizeIndex = 0; sizeIndex < oc_array_size(sizes); sizeIndex++)
+    {
+        u64 size = sizes[sizeIndex];
+        u64 hashCount = oc_max(BYTES_PER_RUN / size, 1);
+
+        printf("%-10llu", (unsigned long long)size);
+
+        for(int mode = 0; mode < MODE_COUNT; mode++)
+        {
+            f64 bestTime = 1e9;
+            u64 check = 0;
+
+            for(int run = 0; run < RUN_COUNT; run++)
+            {
+                //NOTE: chain the hashes through the seed so that calls can't be hoisted out of the loop
+                u64 seed = run;
+                f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+                for(u64 i = 0; i < hashCount; i++)
+                {
+                    u64 offset = (i * 64) % (maxSize - size + 1);
+                    seed = hash_once(mode, (oc_str8){ buffer + offset, size }, seed);
+                }
+                f64 time = oc_clock_time(OC_CLOCK_MONOTONIC) - start;
+                bestTime = (time < bestTime) ? time : bestTime;
+                check ^= seed;
+            }
+
+            if(!check)
+            {
+                printf("!");
+            }
+            printf(" %17.1f %6.2f",
+                   hashCount / bestTime / 1e6,
+                   (f64)(hashCount * size) / bestTime / 1e9);
+        }
+        printf("\n");
+    }
+
+    free(buffer);
+    oc_terminate();
+
+    return (0);
+}
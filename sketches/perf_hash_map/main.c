@@ -0,0 +1,267 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: compares oc_hash_map with the chained hash table it replaces in the UI, ie. a fixed array of oc_list buckets
+//      indexed by hash % bucketCount, with one arena-allocated node per entry. It measures inserting, finding present
+//      and missing keys, and erasing, in millions of operations per second, for u64 and string keys.
+
+enum
+{
+    BUCKET_COUNT = 4096,
+    RUN_COUNT = 5,
+};
+
+typedef struct list_node
+{
+    oc_list_links listElt;
+    u64 hash;
+    oc_str8 string;
+    u64 value;
+} list_node;
+
+typedef struct list_map
+{
+    oc_arena* arena;
+    oc_list buckets[BUCKET_COUNT];
+    oc_list freeList;
+} list_map;
+
+static u64 list_map_hash(oc_str8 string, u64 key)
+{
+    return (string.ptr ? oc_hash_xxh3_string(string) : key * 0x9e3779b97f4a7c15ULL);
+}
+
+static list_node* list_map_find(list_map* map, oc_str8 string, u64 key)
+{
+    u64 hash = list_map_hash(string, key);
+    oc_list_for(map->buckets[hash % BUCKET_COUNT], node, list_node, listElt)
+    {
+        if(node->hash == hash && (!string.ptr || !oc_str8_cmp(node->string, string)))
+        {
+            return (node);
+        }
+    }
+    return (0);
+}
+
+static list_node* list_map_insert(list_map* map, oc_str8 string, u64 key)
+{
+    list_node* node = list_map_find(map, string, key);
+    if(!node)
+    {
+        node = oc_list_pop_front_elt(&map->freeList, list_node, listElt);
+        if(!node)
+        {
+            node = oc_arena_push_type(map->arena, list_node);
+        }
+        node->hash = list_map_hash(string, key);
+        node->string = string;
+        oc_list_push_front(&map->buckets[node->hash % BUCKET_COUNT], &node->listElt);
+    }
+    return (node);
+}
+
+static void list_map_erase(list_map* map, oc_str8 string, u64 key)
+{
+    list_node* node = list_map_find(map, string, key);
+    if(node)
+    {
+        oc_list_remove(&map->buckets[node->hash % BUCKET_COUNT], &node->listElt);
+        oc_list_push_front(&map->freeList, &node->listElt);
+    }
+}
+
+typedef struct bench_result
+{
+    f64 insert;
+    f64 findHit;
+    f64 findMiss;
+    f64 erase;
+    u64 check;
+} bench_result;
+
+static f64 now(void)
+{
+    return (oc_clock_time(OC_CLOCK_MONOTONIC));
+}
+
+static void keep_min(f64* time, f64 value)
+{
+    *time = (value < *time) ? value : *time;
+}
+
+static bench_result bench_list(oc_arena* arena, u64 count, u64* keys, oc_str8* strings)
+{
+    bench_result result = { 1e9, 1e9, 1e9, 1e9, 0 };
+    oc_str8 none = { 0 };
+
+    for(int run = 0; run < RUN_COUNT; run++)
+    {
+        oc_arena_clear(arena);
+        list_map* map = oc_arena_push_type(arena, list_map);
+        memset(map, 0, sizeof(list_map));
+        map->arena = arena;
+        u64 check = 0;
+
+        f64 start = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            list_map_insert(map, strings ? strings[i] : none, keys[i])->value = i;
+        }
+        f64 inserted = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            check += list_map_find(map, strings ? strings[i] : none, keys[i])->value;
+        }
+        f64 foundHit = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            check += list_map_find(map, strings ? strings[count + i] : none, keys[count + i]) ? 1 : 0;
+        }
+        f64 foundMiss = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            list_map_erase(map, strings ? strings[i] : none, keys[i]);
+        }
+        f64 erased = now();
+
+        keep_min(&result.insert, inserted - start);
+        keep_min(&result.findHit, foundHit - inserted);
+        keep_min(&result.findMiss, foundMiss - foundHit);
+        keep_min(&result.erase, erased - foundMiss);
+        result.check = check;
+    }
+    return (result);
+}
+
+static bench_result bench_hash_map(u64 count, u64* keys, oc_str8* strings)
+{
+    bench_result result = { 1e9, 1e9, 1e9, 1e9, 0 };
+
+    for(int run = 0; run < RUN_COUNT; run++)
+    {
+        oc_hash_map map;
+        oc_hash_map_init(&map, 0, 0);
+        u64 check = 0;
+
+        f64 start = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            oc_hash_map_entry* entry = strings ? oc_hash_map_insert_str8(&map, strings[i], 0)
+                                               : oc_hash_map_insert_u64(&map, keys[i], 0);
+            entry->value = i;
+        }
+        f64 inserted = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            oc_hash_map_entry* entry = strings ? oc_hash_map_find_str8(&map, strings[i])
+                                               : oc_hash_map_find_u64(&map, keys[i]);
+            check += entry->value;
+        }
+        f64 foundHit = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            oc_hash_map_entry* entry = strings ? oc_hash_map_find_str8(&map, strings[count + i])
+                                               : oc_hash_map_find_u64(&map, keys[count + i]);
+            check += entry ? 1 : 0;
+        }
+        f64 foundMiss = now();
+        for(u64 i = 0; i < count; i++)
+        {
+            if(strings)
+            {
+                oc_hash_map_erase_str8(&map, strings[i]);
+            }
+            else
+            {
+                oc_hash_map_erase_u64(&map, keys[i]);
+            }
+        }
+        f64 erased = now();
+
+        oc_hash_map_cleanup(&map);
+
+        keep_min(&result.insert, inserted - start);
+        keep_min(&result.findHit, foundHit - inserted);
+        keep_min(&result.findMiss, foundMiss - foundHit);
+        keep_min(&result.erase, erased - foundMiss);
+        result.check = check;
+    }
+    return (result);
+}
+
+static void print_result(const char* name, u64 count, bench_result result)
+{
+    f64 mops = (f64)count / 1e6;
+    printf("%-20s %10.1f %10.1f %10.1f %10.1f\n",
+           name,
+           mops / result.insert,
+           mops / result.findHit,
+           mops / result.findMiss,
+           mops / result.erase);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_arena arena;
+    oc_arena_init(&arena);
+    oc_arena keyArena;
+    oc_arena_init(&keyArena);
+
+    //NOTE: the first half of the keys is inserted, the second half is used for missed lookups
+    u64 counts[] = { 1000, 100000, (argc > 1) ? atoll(argv[1]) : 1000000 };
+    u64 maxCount = counts[2];
+    u64* keys = oc_arena_push_array(&keyArena, u64, 2 * maxCount);
+    oc_str8* strings = oc_arena_push_array(&keyArena, oc_str8, 2 * maxCount);
+
+    u64 state = 0x2545f4914f6cdd1dULL;
+    for(u64 i = 0; i < 2 * maxCount; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        keys[i] = state;
+        strings[i] = oc_str8_pushf(keyArena.allocator, "ui_box_%llx/%llu", (unsigned long long)state, (unsigned long long)i);
+    }
+
+    for(u32 countIndex = 0; countIndex < oc_array_size(counts); countIndex++)
+    {
+        u64 count = counts[countIndex];
+        printf("\n%llu keys (Mops/s)\n", (unsigned long long)count);
+        printf("%-20s %10s %10s %10s %10s\n", "map", "insert", "find hit", "find miss", "erase");
+
+        bench_result listU64 = bench_list(&arena, count, keys, 0);
+        bench_result mapU64 = bench_hash_map(count, keys, 0);
+        bench_result listStr8 = bench_list(&arena, count, keys, strings);
+        bench_result mapStr8 = bench_hash_map(count, keys, strings);
+
+        if(listU64.check != mapU64.check || listStr8.check != mapStr8.check)
+        {
+            oc_log_error("maps disagree\n");
+        }
+
+        print_result("list u64", count, listU64);
+        print_result("hash_map u64", count, mapU64);
+        print_result("list str8", count, listStr8);
+        print_result("hash_map str8", count, mapStr8);
+    }
+
+    oc_arena_cleanup(&keyArena);
+    oc_arena_cleanup(&arena);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,172 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+#include "util/json.c"
+
+//NOTE: measures parsing a document shaped like the api description files used by the bindings generator, ie. a
+//      list of function specs with names, types and argument lists, in MB/s of input.
+//
+//      - tree: json_parse_str8(), which allocates a node per value and copies every string.
+//      - reader: walks the document with json_reader_next(), without allocating.
+//      - doc: json_doc_parse(), which builds a flat array of values pointing into the input.
+//
+//      It also measures looking up every field of every spec, with json_find() and json_doc_find().
+
+enum
+{
+    RUN_COUNT = 5,
+};
+
+static oc_str8 make_document(oc_arena* arena, u64 specCount)
+{
+    static const char* types[] = { "i32", "u64", "f32", "oc_str8", "oc_rect", "oc_vec2", "void", "char*" };
+    oc_str8_list list = { 0 };
+
+    oc_str8_list_push(arena->allocator, &list, OC_STR8("[\n"));
+    for(u64 i = 0; i < specCount; i++)
+    {
+        oc_str8_list_pushf(arena->allocator,
+                           &list,
+                           "%s    {\n"
+                           "        \"name\": \"oc_function_%llu\",\n"
+                           "        \"cname\": \"oc_function_%llu\",\n"
+                           "        \"doc\": \"Does thing number %llu.\\nSee \\\"things\\\" for details.\",\n"
+                           "        \"ret\": {\"name\": \"%s\", \"tag\": \"i\"},\n"
+                           "        \"size\": %llu,\n"
+                           "        \"scale\": %.3f,\n"
+                           "        \"deprecated\": %s,\n"
+                           "        \"args\": [\n",
+                           i ? ",\n" : "",
+                           (unsigned long long)i,
+                           (unsigned long long)i,
+                           (unsigned long long)i,
+                           types[i % oc_array_size(types)],
+                           (unsigned long long)(i * 7919 % 100000),
+                           (f64)(i % 1000) / 8,
+                           (i % 3) ? "false" : "true");
+
+        u64 argCount = i % 5;
+        for(u64 j = 0; j < argCount; j++)
+        {
+            oc_str8_list_pushf(arena->allocator,
+                               &list,
+                               "            {\"name\": \"arg%llu\", \"type\": {\"name\": \"%s\", \"tag\": \"p\"}, \"default\": null}%s\n",
+                               (unsigned long long)j,
+                               types[(i + j) % oc_array_size(types)],
+                               (j + 1 < argCount) ? "," : "");
+        }
+        oc_str8_list_push(arena->allocator, &list, OC_STR8("        ]\n    }"));
+    }
+    oc_str8_list_push(arena->allocator, &list, OC_STR8("\n]\n"));
+
+    return (oc_str8_list_join(arena->allocator, list));
+}
+
+static const char* FIELDS[] = { "name", "cname", "doc", "ret", "size", "scale", "deprecated", "args", "missing" };
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_arena arena;
+    oc_arena_init(&arena);
+    oc_arena docArena;
+    oc_arena_init(&docArena);
+
+    u64 specCount = (argc > 1) ? atoll(argv[1]) : 20000;
+    oc_str8 string = make_document(&docArena, specCount);
+    f64 megabytes = (f64)string.len / (1 << 20);
+
+    printf("document: %.1f MB, %llu specs\n", megabytes, (unsigned long long)specCount);
+    printf("%-8s %14s %12s %18s\n", "mode", "parse (ms)", "MB/s", "find all (ms)");
+
+    const char* modeNames[] = { "tree", "reader", "doc" };
+    for(int mode = 0; mode < 3; mode++)
+    {
+        f64 parseTime = 1e9;
+        f64 findTime = 1e9;
+        u64 found = 0;
+
+        for(int run = 0; run < RUN_COUNT; run++)
+        {
+            oc_arena_clear(&arena);
+            found = 0;
+
+            f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+            f64 parsed = 0;
+
+            if(mode == 0)
+            {
+                json_node* root = json_parse_str8(arena.allocator, string);
+                parsed = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+                oc_list_for(root->children, spec, json_node, listElt)
+                {
+                    for(u32 i = 0; i < oc_array_size(FIELDS); i++)
+                    {
+                        found += json_find(spec, OC_STR8(FIELDS[i])) ? 1 : 0;
+                    }
+                }
+            }
+            else if(mode == 1)
+            {
+                json_reader reader;
+                json_reader_init(&reader, string);
+                json_token token = { 0 };
+                do
+                {
+                    token = json_reader_next(&reader);
+                    found += (token.kind == JSON_TOKEN_KEY && token.depth == 2) ? 1 : 0;
+                }
+                while(token.kind != JSON_TOKEN_END && token.kind != JSON_TOKEN_ERROR);
+
+                //NOTE: the reader has no random access, so it only counts the fields of each spec
+                parsed = oc_clock_time(OC_CLOCK_MONOTONIC);
+            }
+            else
+            {
+                json_doc doc = json_doc_parse(arena.allocator, string);
+                parsed = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+                json_doc_for(&doc, 0, spec)
+                {
+                    for(u32 i = 0; i < oc_array_size(FIELDS); i++)
+                    {
+                        found += json_doc_find(&doc, spec, OC_STR8(FIELDS[i])) ? 1 : 0;
+                    }
+                }
+            }
+            f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+            parseTime = oc_min(parseTime, parsed - start);
+            findTime = oc_min(findTime, end - parsed);
+        }
+
+        if(found != specCount * (oc_array_size(FIELDS) - 1))
+        {
+            oc_log_error("%s: found %llu fields\n", modeNames[mode], (unsigned long long)found);
+        }
+
+        printf("%-8s %14.3f %12.1f %18.3f\n",
+               modeNames[mode],
+               parseTime * 1000,
+               megabytes / parseTime,
+               findTime * 1000);
+    }
+
+    oc_arena_cleanup(&docArena);
+    oc_arena_cleanup(&arena);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,174 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the frame time of a scrolling list of log-like rows, built either as plain boxes inside a
+//      scrolling panel, or with the virtualized list widget, for increasing row counts.
+
+typedef enum
+{
+    LIST_MODE_BOXES,
+    LIST_MODE_LIST,
+    LIST_MODE_LIST_VARIABLE,
+} list_mode;
+
+static const char* MODE_NAMES[] = { "boxes", "list (fixed)", "list (variable)" };
+
+static void row_contents(oc_arena* arena, u64 index, bool variable)
+{
+    oc_ui_label_str8(OC_STR8("msg"), oc_str8_pushf(arena, "Row %llu: some log message", (unsigned long long)index));
+    if(variable && (index % 3 == 0))
+    {
+        oc_ui_label_str8(OC_STR8("details"), OC_STR8("more details on a second line"));
+    }
+}
+
+static void build(oc_arena* arena, list_mode mode, u64 rowCount, oc_ui_list_info* info)
+{
+    oc_ui_box("panel")
+    {
+        oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, 600 });
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, 400 });
+        oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+
+        if(mode == LIST_MODE_BOXES)
+        {
+            oc_ui_style_set_i32(OC_UI_OVERFLOW_Y, OC_UI_OVERFLOW_SCROLL);
+            for(u64 i = 0; i < rowCount; i++)
+            {
+                oc_ui_box_str8(oc_str8_pushf(arena, "%llu", (unsigned long long)i))
+                {
+                    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+                    oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, 20 });
+                    oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+                    row_contents(arena, i, false);
+                }
+            }
+        }
+        else
+        {
+            info->rowCount = rowCount;
+            oc_ui_list("list", info)
+            {
+                for(u64 i = info->firstRow; i < info->endRow; i++)
+                {
+                    oc_ui_list_row(i)
+                    {
+                        oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+                        row_contents(arena, i, info->variableHeight);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static f64 run(oc_font font, list_mode mode, u64 rowCount, int frameCount)
+{
+    oc_ui_context* ui = oc_ui_context_create(font);
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    oc_ui_list_info info = {
+        .rowHeight = 20,
+        .variableHeight = (mode == LIST_MODE_LIST_VARIABLE),
+        .overscan = 4,
+    };
+
+    oc_event move = { .type = OC_EVENT_MOUSE_MOVE, .mouse = { .x = 100, .y = 100 } };
+    oc_ui_process_event(&move);
+
+    //NOTE: the first frames are warmup
+    int warmup = 2;
+    f64 total = 0;
+    for(int frame = 0; frame < frameCount + warmup; frame++)
+    {
+        oc_event wheel = { .type = OC_EVENT_MOUSE_WHEEL, .mouse = { .deltaY = 37 } };
+        oc_ui_process_event(&wheel);
+
+        //NOTE: we don't render the frames, so we use a new canvas context each frame to discard the commands
+        oc_canvas_context context = oc_canvas_context_create();
+        oc_canvas_context_select(context);
+
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        oc_vec2 frameSize = { 800, 600 };
+        oc_ui_frame(frameSize)
+        {
+            build(&arena, mode, rowCount, &info);
+        }
+        oc_ui_draw();
+
+        f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+        if(frame >= warmup)
+        {
+            total += end - start;
+        }
+        oc_arena_clear(&arena);
+        oc_canvas_context_destroy(context);
+    }
+
+    oc_arena_cleanup(&arena);
+    oc_ui_context_destroy(ui);
+
+    return (total * 1000 / frameCount);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 fontPath = argc > 1
+                         ? OC_STR8(argv[1])
+                         : oc_path_executable_relative(scratch.allocator, OC_STR8("../../resources/OpenSans-Regular.ttf"));
+
+    oc_file file = oc_file_open(fontPath, OC_FILE_ACCESS_READ, 0).value;
+    if(oc_file_is_nil(file))
+    {
+        oc_log_error("Could not open font file '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    u64 size = oc_file_size(file);
+    char* fontData = oc_arena_push_uninitialized(scratch.arena, size);
+    oc_file_read(file, size, fontData);
+    oc_file_close(file);
+
+    oc_unicode_range ranges[] = { OC_UNICODE_BASIC_LATIN };
+    oc_font font = oc_font_create_from_memory(oc_str8_from_buffer(size, fontData), 1, ranges);
+
+    u64 rowCounts[] = { 1000, 10000, 100000, 1000000 };
+    printf("%-16s %10s %12s\n", "mode", "rows", "ms/frame");
+
+    for(int mode = 0; mode <= LIST_MODE_LIST_VARIABLE; mode++)
+    {
+        for(int i = 0; i < oc_array_size(rowCounts); i++)
+        {
+            //NOTE: plain boxes get too slow to measure past a few thousand rows
+            if(mode == LIST_MODE_BOXES && rowCounts[i] > 10000)
+            {
+                break;
+            }
+            int frameCount = (mode == LIST_MODE_BOXES) ? 10 : 100;
+            f64 frameTime = run(font, mode, rowCounts[i], frameCount);
+            printf("%-16s %10llu %12.3f\n", MODE_NAMES[mode], (unsigned long long)rowCounts[i], frameTime);
+        }
+    }
+
+    oc_font_destroy(font);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
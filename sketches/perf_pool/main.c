@@ -0,0 +1,212 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: compares oc_pool, with and without a cache, with malloc and with the per-type free lists used across the
+//      code base (an oc_list of freed objects, refilled from an arena). Each workload keeps a set of live objects
+//      and repeatedly frees one at random and allocates a new one, touching the first bytes of each allocation.
+//
+//      It reports millions of free+alloc pairs per second, and the footprint of the pool and of the free list,
+//      ie. the memory they took from their arena divided by the size of the live objects at the peak.
+
+enum
+{
+    RUN_COUNT = 5,
+    LIVE_COUNT = 50000,
+    OP_COUNT = 2000000,
+};
+
+typedef enum
+{
+    ALLOC_MALLOC,
+    ALLOC_FREE_LIST,
+    ALLOC_POOL,
+    ALLOC_POOL_CACHE,
+    ALLOC_COUNT,
+} alloc_kind;
+
+static const char* ALLOC_NAMES[ALLOC_COUNT] = { "malloc", "free list", "pool", "pool cache" };
+
+typedef struct free_list_elt
+{
+    oc_list_links listElt;
+} free_list_elt;
+
+typedef struct allocators
+{
+    oc_arena arena;
+    oc_list freeList;
+    oc_pool pool;
+    oc_pool_cache cache;
+} allocators;
+
+static void* bench_alloc(allocators* a, alloc_kind kind, u64 size)
+{
+    void* p = 0;
+    switch(kind)
+    {
+        case ALLOC_MALLOC:
+            p = malloc(size);
+            break;
+        case ALLOC_FREE_LIST:
+            p = oc_list_pop_front_elt(&a->freeList, free_list_elt, listElt);
+            if(!p)
+            {
+                p = oc_arena_push_aligned_uninitialized(&a->arena, size, 16);
+            }
+            break;
+        case ALLOC_POOL:
+            p = oc_pool_push_uninitialized(&a->pool, size);
+            break;
+        case ALLOC_POOL_CACHE:
+            p = oc_pool_cache_push_aligned_uninitialized(&a->cache, size, 1);
+            break;
+        default:
+            break;
+    }
+    memset(p, 0, oc_min(size, 64));
+    return (p);
+}
+
+static void bench_free(allocators* a, alloc_kind kind, void* p, u64 size)
+{
+    switch(kind)
+    {
+        case ALLOC_MALLOC:
+            free(p);
+            break;
+        case ALLOC_FREE_LIST:
+            oc_list_push_front(&a->freeList, &((free_list_elt*)p)->listElt);
+            break;
+        case ALLOC_POOL:
+            oc_pool_free(&a->pool, p, size);
+            break;
+        case ALLOC_POOL_CACHE:
+            oc_pool_cache_free_aligned(&a->cache, p, size, 1);
+            break;
+        default:
+            break;
+    }
+}
+
+static u64 arena_used(oc_arena* arena)
+{
+    u64 used = 0;
+    oc_list_for(arena->chunks, chunk, oc_arena_chunk, listElt)
+    {
+        used += chunk->offset - sizeof(oc_arena_chunk);
+    }
+    return (used);
+}
+
+//NOTE: fixed size workloads use size for every object, mixed workloads draw sizes between 16 and size bytes
+static void bench(const char* name, u64 size, bool mixed)
+{
+    void** ptrs = calloc(LIVE_COUNT, sizeof(void*));
+    u64* sizes = calloc(LIVE_COUNT, sizeof(u64));
+
+    printf("%-24s", name);
+    for(int kind = 0; kind < ALLOC_COUNT; kind++)
+    {
+        if(kind == ALLOC_FREE_LIST && mixed)
+        {
+            printf(" %12s", "n/a");
+            continue;
+        }
+
+        f64 bestTime = 1e9;
+        f64 footprint = 0;
+
+        for(int run = 0; run < RUN_COUNT; run++)
+        {
+            allocators a = { 0 };
+            oc_arena_init(&a.arena);
+            oc_pool_init(&a.pool);
+            oc_pool_cache_init(&a.cache, &a.pool);
+
+            u32 rng = 12345;
+            u64 liveSize = 0;
+            for(u64 i = 0; i < LIVE_COUNT; i++)
+            {
+                rng = rng * 1664525 + 1013904223;
+                sizes[i] = mixed ? 16 + (rng >> 8) % (size - 15) : size;
+                ptrs[i] = bench_alloc(&a, kind, sizes[i]);
+                liveSize += sizes[i];
+            }
+
+            f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+            for(u64 i = 0; i < OP_COUNT; i++)
+            {
+                rng = rng * 1664525 + 1013904223;
+                u64 index = (rng >> 8) % LIVE_COUNT;
+                bench_free(&a, kind, ptrs[index], sizes[index]);
+
+                rng = rng * 1664525 + 1013904223;
+                sizes[index] = mixed ? 16 + (rng >> 8) % (size - 15) : size;
+                ptrs[index] = bench_alloc(&a, kind, sizes[index]);
+            }
+            f64 time = oc_clock_time(OC_CLOCK_MONOTONIC) - start;
+            bestTime = (time < bestTime) ? time : bestTime;
+
+            if(kind == ALLOC_FREE_LIST)
+            {
+                footprint = (f64)arena_used(&a.arena) / liveSize;
+            }
+            else if(kind == ALLOC_POOL || kind == ALLOC_POOL_CACHE)
+            {
+                footprint = (f64)(a.pool.slabSize + a.pool.largeSize) / liveSize;
+            }
+
+            for(u64 i = 0; i < LIVE_COUNT; i++)
+            {
+                bench_free(&a, kind, ptrs[i], sizes[i]);
+            }
+            oc_pool_cleanup(&a.pool);
+            oc_arena_cleanup(&a.arena);
+        }
+
+        if(footprint)
+        {
+            printf(" %7.1f (%.2fx)", OP_COUNT / bestTime / 1e6, footprint);
+        }
+        else
+        {
+            printf(" %12.1f", OP_COUNT / bestTime / 1e6);
+        }
+    }
+    printf("\n");
+
+    free(sizes);
+    free(ptrs);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    printf("%-24s", "workload (Mops/s)");
+    for(int kind = 0; kind < ALLOC_COUNT; kind++)
+    {
+        printf(" %12s", ALLOC_NAMES[kind]);
+    }
+    printf("\n");
+
+    bench("fixed 48 bytes", 48, false);
+    bench("fixed 256 bytes", 256, false);
+    bench("fixed 1200 bytes", 1200, false);
+    bench("mixed 16-256 bytes", 256, true);
+    bench("mixed 16-4096 bytes", 4096, true);
+
+    oc_terminate();
+    return (0);
+}
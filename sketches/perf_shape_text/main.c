@@ -0,0 +1,156 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the throughput of oc_font_shape_text() and oc_font_shape_text_batch(), in millions of glyphs per
+//      second, on UI-like labels. The cached workload shapes the same 500 labels on each pass, which fit in the
+//      glyph run cache, while the uncached workload cycles through more labels than the cache holds, so that every
+//      label is shaped from scratch.
+
+enum
+{
+    RUN_COUNT = 10,
+    PASS_COUNT = 20,
+    CACHED_LABEL_COUNT = 500,
+    UNCACHED_LABEL_COUNT = 4096,
+};
+
+static const char* WORDS[] = {
+    "File", "Edit", "View", "Window", "Help", "Open", "Save", "Close", "Settings", "Tools",
+    "Layer", "Brush", "Opacity", "Width", "Height", "Value", "Average", "Total", "Yesterday", "AVATAR",
+    "Wave", "Type", "Kerning", "Toggle", "Volume", "Favorites", "Account", "Profile", "Theme", "Zoom",
+};
+
+static oc_str8* make_labels(oc_arena* arena, u32 count)
+{
+    oc_str8* labels = oc_arena_push_array(arena, oc_str8, count);
+    u32 rng = 12345;
+    for(u32 i = 0; i < count; i++)
+    {
+        oc_str8_list list = { 0 };
+        oc_str8_list_pushf(arena->allocator, &list, "%u.", i);
+
+        rng = rng * 1664525 + 1013904223;
+        u32 wordCount = 1 + (rng >> 8) % 6;
+        for(u32 j = 0; j < wordCount; j++)
+        {
+            rng = rng * 1664525 + 1013904223;
+            oc_str8_list_pushf(arena->allocator, &list, " %s", WORDS[(rng >> 8) % oc_array_size(WORDS)]);
+        }
+        labels[i] = oc_str8_list_join(arena->allocator, list);
+    }
+    return (labels);
+}
+
+typedef struct bench_result
+{
+    f64 single;
+    f64 batch;
+    f64 hitRate;
+} bench_result;
+
+//NOTE: returns the best throughput of shaping all labels PASS_COUNT times, and the glyph run cache hit rate
+static bench_result bench(oc_font font, u32 labelCount, oc_str8* labels)
+{
+    oc_arena arena = { 0 };
+    oc_arena_init(&arena);
+
+    oc_shaped_text* results = malloc(labelCount * sizeof(oc_shaped_text));
+    bench_result result = { 0 };
+    f64 bestSingleTime = 1e9;
+    f64 bestBatchTime = 1e9;
+    u64 glyphCount = 0;
+
+    oc_glyph_run_cache_stats startStats = oc_glyph_run_cache_get_stats();
+
+    for(int run = 0; run < RUN_COUNT; run++)
+    {
+        glyphCount = 0;
+
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+        for(int pass = 0; pass < PASS_COUNT; pass++)
+        {
+            for(u32 i = 0; i < labelCount; i++)
+            {
+                oc_shaped_text shaped = oc_font_shape_text(arena.allocator, font, 14, labels[i]);
+                glyphCount += shaped.glyphCount;
+            }
+            oc_arena_clear(&arena);
+        }
+        f64 time = oc_clock_time(OC_CLOCK_MONOTONIC) - start;
+        bestSingleTime = (time < bestSingleTime) ? time : bestSingleTime;
+
+        start = oc_clock_time(OC_CLOCK_MONOTONIC);
+        for(int pass = 0; pass < PASS_COUNT; pass++)
+        {
+            oc_font_shape_text_batch(arena.allocator, font, 14, labelCount, labels, results);
+            oc_arena_clear(&arena);
+        }
+        time = oc_clock_time(OC_CLOCK_MONOTONIC) - start;
+        bestBatchTime = (time < bestBatchTime) ? time : bestBatchTime;
+    }
+
+    oc_glyph_run_cache_stats endStats = oc_glyph_run_cache_get_stats();
+    u64 hits = endStats.hits - startStats.hits;
+    u64 misses = endStats.misses - startStats.misses;
+
+    result.single = glyphCount / bestSingleTime / 1e6;
+    result.batch = glyphCount / bestBatchTime / 1e6;
+    result.hitRate = (hits + misses) ? (f64)hits / (hits + misses) : 0;
+
+    free(results);
+    oc_arena_cleanup(&arena);
+    return (result);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 fontPath = argc > 1
+                         ? OC_STR8(argv[1])
+                         : oc_path_executable_relative(scratch.allocator, OC_STR8("../../resources/OpenSans-Regular.ttf"));
+
+    oc_file file = oc_file_open(fontPath, OC_FILE_ACCESS_READ, 0).value;
+    if(oc_file_is_nil(file))
+    {
+        oc_log_error("Could not open font file '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    u64 size = oc_file_size(file);
+    char* fontData = oc_arena_push_uninitialized(scratch.arena, size);
+    oc_file_read(file, size, fontData);
+    oc_file_close(file);
+
+    oc_unicode_range ranges[] = { OC_UNICODE_BASIC_LATIN, OC_UNICODE_C1_CONTROLS_AND_LATIN_1_SUPPLEMENT };
+    oc_font font = oc_font_create_from_memory(oc_str8_from_buffer(size, fontData), oc_array_size(ranges), ranges);
+
+    oc_str8* cachedLabels = make_labels(scratch.arena, CACHED_LABEL_COUNT);
+    oc_str8* uncachedLabels = make_labels(scratch.arena, UNCACHED_LABEL_COUNT);
+
+    printf("%-10s %8s %16s %16s %10s\n", "workload", "labels", "single (Mg/s)", "batch (Mg/s)", "hit rate");
+
+    bench_result cached = bench(font, CACHED_LABEL_COUNT, cachedLabels);
+    printf("%-10s %8u %16.1f %16.1f %9.1f%%\n", "cached", CACHED_LABEL_COUNT, cached.single, cached.batch, 100 * cached.hitRate);
+
+    bench_result uncached = bench(font, UNCACHED_LABEL_COUNT, uncachedLabels);
+    printf("%-10s %8u %16.1f %16.1f %9.1f%%\n", "uncached", UNCACHED_LABEL_COUNT, uncached.single, uncached.batch, 100 * uncached.hitRate);
+
+    oc_font_destroy(font);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
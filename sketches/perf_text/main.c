@@ -175,6 +175,13 @@ int main()
     f32 startX = 10;
     f32 startY = 10 + lineHeights[fontIndex];
 
+    //NOTE: press C to switch between drawing lines from cached glyph runs (oc_text_outlines())
+    //      and from glyph indices computed each frame (oc_glyph_outlines())
+    bool useGlyphRunCache = true;
+    f64 textTime = 0;
+    f32 hitRate = 0;
+    oc_glyph_run_cache_stats lastStats = oc_glyph_run_cache_get_stats();
+
     oc_input_state inputState = { 0 };
 
     while(!oc_should_quit())
@@ -235,6 +242,10 @@ int main()
                     {
                         fontIndex = (fontIndex + 1) % FONT_COUNT;
                     }
+                    if(event->key.keyCode == OC_KEY_C && event->key.action == OC_KEY_PRESS)
+                    {
+                        useGlyphRunCache = !useGlyphRunCache;
+                    }
                 }
                 break;
 
@@ -275,6 +286,8 @@ int main()
 
         oc_move_to(textX, textY);
 
+        f64 startTextTime = oc_clock_time(OC_CLOCK_MONOTONIC);
+
         int startIndex = 0;
         while(startIndex < codePointCount)
         {
@@ -288,10 +301,18 @@ int main()
                 }
             }
 
-            u32 glyphs[512];
-            oc_font_get_glyph_indices(fonts[fontIndex], oc_str32_from_buffer(subIndex, codePoints + startIndex), oc_str32_from_buffer(512, glyphs));
+            if(useGlyphRunCache)
+            {
+                //NOTE: TEST_STRING is ASCII, so codepoint indices are also byte offsets
+                oc_text_outlines(oc_str8_from_buffer(subIndex, (char*)TEST_STRING + startIndex));
+            }
+            else
+            {
+                u32 glyphs[512];
+                oc_font_get_glyph_indices(fonts[fontIndex], oc_str32_from_buffer(subIndex, codePoints + startIndex), oc_str32_from_buffer(512, glyphs));
 
-            oc_glyph_outlines(oc_str32_from_buffer(subIndex, glyphs));
+                oc_glyph_outlines(oc_str32_from_buffer(subIndex, glyphs));
+            }
             oc_fill();
 
             textY += lineHeights[fontIndex];
@@ -303,16 +324,26 @@ int main()
 
         oc_matrix_pop();
 
+        textTime = oc_clock_time(OC_CLOCK_MONOTONIC) - startTextTime;
+
+        oc_glyph_run_cache_stats stats = oc_glyph_run_cache_get_stats();
+        u64 lookups = (stats.hits - lastStats.hits) + (stats.misses - lastStats.misses);
+        hitRate = lookups ? (f32)(stats.hits - lastStats.hits) / lookups : 0;
+        lastStats = stats;
+
         oc_set_color_rgba(0, 0, 1, 1);
         oc_set_font(fonts[fontIndex]);
         oc_set_font_size(14);
         oc_move_to(10, contentRect.h - 10 - lineHeights[fontIndex]);
 
         oc_str8 text = oc_str8_pushf(scratch.allocator,
-                                     "Test program: %i glyphs, frame time = %fs, fps = %f",
+                                     "Test program: %i glyphs, frame time = %fs, fps = %f, text (%s) = %.3fms, glyph run cache hit rate = %.1f%%",
                                      glyphCount,
                                      frameTime,
-                                     1. / frameTime);
+                                     1. / frameTime,
+                                     useGlyphRunCache ? "cached" : "uncached",
+                                     textTime * 1000,
+                                     hitRate * 100);
         oc_text_outlines(text);
         oc_fill();
 
@@ -0,0 +1,133 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the per-frame overhead of the ui context for flat trees of plain boxes, either with the same
+//      boxes every frame, or with a tenth of the boxes replaced by new ones each frame.
+
+typedef enum
+{
+    BOXES_MODE_STABLE,
+    BOXES_MODE_CHURN,
+} boxes_mode;
+
+static const char* MODE_NAMES[] = { "stable", "churn" };
+
+typedef struct frame_times
+{
+    f64 build;
+    f64 end;
+} frame_times;
+
+static frame_times run(oc_font font, boxes_mode mode, u64 boxCount, int frameCount)
+{
+    oc_ui_context* ui = oc_ui_context_create(font);
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    //NOTE: the first frames are warmup
+    int warmup = 2;
+    frame_times times = { 0 };
+    for(int frame = 0; frame < frameCount + warmup; frame++)
+    {
+        u64 firstKey = (mode == BOXES_MODE_CHURN) ? frame * (boxCount / 10) : 0;
+
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        oc_ui_frame_begin((oc_vec2){ 800, 600 });
+
+        oc_ui_box("panel")
+        {
+            oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, 800 });
+            oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, 600 });
+            oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+            oc_ui_style_set_i32(OC_UI_OVERFLOW_Y, OC_UI_OVERFLOW_SCROLL);
+
+            for(u64 i = 0; i < boxCount; i++)
+            {
+                oc_ui_box_str8(oc_str8_pushf(&arena, "%llu", (unsigned long long)(firstKey + i)))
+                {
+                    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, 100 });
+                    oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, 10 });
+                }
+            }
+        }
+
+        f64 mid = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        oc_ui_frame_end();
+
+        f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+        if(frame >= warmup)
+        {
+            times.build += mid - start;
+            times.end += end - mid;
+        }
+        oc_arena_clear(&arena);
+    }
+    times.build = times.build * 1000 / frameCount;
+    times.end = times.end * 1000 / frameCount;
+
+    oc_arena_cleanup(&arena);
+    oc_ui_context_destroy(ui);
+
+    return (times);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 fontPath = argc > 1
+                         ? OC_STR8(argv[1])
+                         : oc_path_executable_relative(scratch.allocator, OC_STR8("../../resources/OpenSans-Regular.ttf"));
+
+    oc_file file = oc_file_open(fontPath, OC_FILE_ACCESS_READ, 0).value;
+    if(oc_file_is_nil(file))
+    {
+        oc_log_error("Could not open font file '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    u64 size = oc_file_size(file);
+    char* fontData = oc_arena_push_uninitialized(scratch.arena, size);
+    oc_file_read(file, size, fontData);
+    oc_file_close(file);
+
+    oc_unicode_range ranges[] = { OC_UNICODE_BASIC_LATIN };
+    oc_font font = oc_font_create_from_memory(oc_str8_from_buffer(size, fontData), 1, ranges);
+
+    u64 boxCounts[] = { 100, 50000 };
+    printf("%-8s %8s %14s %14s\n", "mode", "boxes", "build ms", "end ms");
+
+    for(int mode = 0; mode <= BOXES_MODE_CHURN; mode++)
+    {
+        for(int i = 0; i < oc_array_size(boxCounts); i++)
+        {
+            int frameCount = (boxCounts[i] > 1000) ? 20 : 1000;
+            frame_times times = run(font, mode, boxCounts[i], frameCount);
+            printf("%-8s %8llu %14.3f %14.3f\n",
+                   MODE_NAMES[mode],
+                   (unsigned long long)boxCounts[i],
+                   times.build,
+                   times.end);
+        }
+    }
+
+    oc_font_destroy(font);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,177 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the end of frame time, which is dominated by layout, for wide, wrapping and deep trees of boxes.
+//      The trees are the same each frame, but the frame size changes so that the layout is solved every frame.
+
+typedef enum
+{
+    TREE_WIDE,
+    TREE_WRAP,
+    TREE_DEEP,
+} tree_shape;
+
+static const char* SHAPE_NAMES[] = { "wide", "wrap", "deep" };
+
+static void build_chain(oc_arena* arena, u64 depth)
+{
+    if(depth)
+    {
+        oc_ui_box_str8(oc_str8_pushf(arena, "%llu", (unsigned long long)depth))
+        {
+            oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+            oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+            oc_ui_style_set_f32(OC_UI_MARGIN_X, 1);
+            oc_ui_style_set_f32(OC_UI_MARGIN_Y, 1);
+
+            build_chain(arena, depth - 1);
+        }
+    }
+    else
+    {
+        oc_ui_box("leaf")
+        {
+            oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, 10 });
+            oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, 10 });
+        }
+    }
+}
+
+static void build(oc_arena* arena, tree_shape shape, u64 boxCount)
+{
+    oc_ui_box("panel")
+    {
+        oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+        oc_ui_style_set_i32(OC_UI_OVERFLOW_Y, OC_UI_OVERFLOW_SCROLL);
+
+        switch(shape)
+        {
+            case TREE_WIDE:
+            case TREE_WRAP:
+            {
+                oc_ui_box("contents")
+                {
+                    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+                    oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+                    oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_X);
+                    oc_ui_style_set_i32(OC_UI_WRAP, shape == TREE_WRAP);
+                    oc_ui_style_set_f32(OC_UI_SPACING, 2);
+
+                    for(u64 i = 0; i < boxCount; i++)
+                    {
+                        oc_ui_box_str8(oc_str8_pushf(arena, "%llu", (unsigned long long)i))
+                        {
+                            oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, 20 + i % 7, .shrink = 1 });
+                            oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, 20 });
+                        }
+                    }
+                }
+            }
+            break;
+
+            case TREE_DEEP:
+            {
+                //NOTE: chains of 100 nested boxes
+                oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+                for(u64 i = 0; i < boxCount / 100; i++)
+                {
+                    oc_ui_box_str8(oc_str8_pushf(arena, "chain%llu", (unsigned long long)i))
+                    {
+                        oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+                        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+                        build_chain(arena, 99);
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+static f64 run(oc_font font, tree_shape shape, u64 boxCount, int frameCount)
+{
+    oc_ui_context* ui = oc_ui_context_create(font);
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    //NOTE: the first frames are warmup
+    int warmup = 2;
+    f64 total = 0;
+    for(int frame = 0; frame < frameCount + warmup; frame++)
+    {
+        oc_vec2 frameSize = { 800 + frame % 2, 600 };
+        oc_ui_frame_begin(frameSize);
+        build(&arena, shape, boxCount);
+
+        f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+        oc_ui_frame_end();
+        f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+        if(frame >= warmup)
+        {
+            total += end - start;
+        }
+        oc_arena_clear(&arena);
+    }
+
+    oc_arena_cleanup(&arena);
+    oc_ui_context_destroy(ui);
+
+    return (total * 1000 / frameCount);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 fontPath = argc > 1
+                         ? OC_STR8(argv[1])
+                         : oc_path_executable_relative(scratch.allocator, OC_STR8("../../resources/OpenSans-Regular.ttf"));
+
+    oc_file file = oc_file_open(fontPath, OC_FILE_ACCESS_READ, 0).value;
+    if(oc_file_is_nil(file))
+    {
+        oc_log_error("Could not open font file '%.*s'\n", oc_str8_ip(fontPath));
+        return (-1);
+    }
+    u64 size = oc_file_size(file);
+    char* fontData = oc_arena_push_uninitialized(scratch.arena, size);
+    oc_file_read(file, size, fontData);
+    oc_file_close(file);
+
+    oc_unicode_range ranges[] = { OC_UNICODE_BASIC_LATIN };
+    oc_font font = oc_font_create_from_memory(oc_str8_from_buffer(size, fontData), 1, ranges);
+
+    u64 boxCounts[] = { 1000, 10000, 50000 };
+    printf("%-8s %8s %14s\n", "shape", "boxes", "end ms");
+
+    for(int shape = 0; shape <= TREE_DEEP; shape++)
+    {
+        for(int i = 0; i < oc_array_size(boxCounts); i++)
+        {
+            int frameCount = (boxCounts[i] > 1000) ? 20 : 100;
+            f64 time = run(font, shape, boxCounts[i], frameCount);
+            printf("%-8s %8llu %14.3f\n", SHAPE_NAMES[shape], (unsigned long long)boxCounts[i], time);
+        }
+    }
+
+    oc_font_destroy(font);
+    oc_scratch_end(scratch);
+    oc_terminate();
+
+    return (0);
+}
@@ -0,0 +1,203 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orca.h"
+
+//NOTE: measures the throughput of the utf8 functions on 1MB of text, in GB/s of utf8, for ASCII, latin (mostly
+//      ASCII with some 2 bytes sequences), CJK (3 bytes sequences) and emoji (4 bytes sequences) text. The scalar
+//      versions decode one codepoint at a time, as the utf8 functions used to do.
+
+enum
+{
+    TEXT_SIZE = 1 << 20,
+    RUN_COUNT = 20,
+};
+
+static u64 scalar_count(oc_str8 string)
+{
+    u64 byteOffset = 0;
+    u64 count = 0;
+    for(; (byteOffset < string.len) && (string.ptr[byteOffset] != 0); count++)
+    {
+        byteOffset += oc_utf8_decode_at(string, byteOffset).size;
+    }
+    return (count);
+}
+
+static u64 scalar_to_codepoints(u64 maxCount, oc_utf32* backing, oc_str8 string)
+{
+    u64 count = 0;
+    u64 byteOffset = 0;
+    for(; count < maxCount && byteOffset < string.len; count++)
+    {
+        oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
+        backing[count] = decode.codepoint;
+        byteOffset += decode.size;
+    }
+    return (count);
+}
+
+static u64 scalar_from_codepoints(u64 maxBytes, char* backing, oc_str32 codePoints)
+{
+    u64 byteOffset = 0;
+    for(u64 i = 0; i < codePoints.len; i++)
+    {
+        u32 byteCount = oc_utf8_codepoint_size(codePoints.ptr[i]);
+        if(byteOffset + byteCount > maxBytes)
+        {
+            break;
+        }
+        oc_utf8_encode(backing + byteOffset, codePoints.ptr[i]);
+        byteOffset += byteCount;
+    }
+    return (byteOffset);
+}
+
+static oc_str8 make_text(const char* words[], u32 wordCount)
+{
+    char* ptr = malloc(TEXT_SIZE);
+    u64 len = 0;
+    u32 seed = 1;
+    while(1)
+    {
+        seed = seed * 1664525 + 1013904223;
+        const char* word = words[(seed >> 16) % wordCount];
+        u64 wordLen = strlen(word);
+        if(len + wordLen + 1 > TEXT_SIZE)
+        {
+            break;
+        }
+        memcpy(ptr + len, word, wordLen);
+        len += wordLen;
+        ptr[len++] = ' ';
+    }
+    return (oc_str8_from_buffer(len, ptr));
+}
+
+typedef enum
+{
+    OP_COUNT,
+    OP_VALIDATE,
+    OP_TO_CODEPOINTS,
+    OP_FROM_CODEPOINTS,
+    OP_OP_COUNT,
+} utf8_op;
+
+static const char* OP_NAMES[] = { "count", "validate", "to codepoints", "from codepoints" };
+
+static u64 run(utf8_op op, bool scalar, oc_str8 text, oc_str32 codepoints, oc_utf32* codepointBuffer, char* textBuffer)
+{
+    u64 result = 0;
+    switch(op)
+    {
+        case OP_COUNT:
+            result = scalar ? scalar_count(text) : oc_utf8_codepoint_count_for_string(text);
+            break;
+        case OP_VALIDATE:
+            if(scalar)
+            {
+                //NOTE: validation used to be done by decoding the whole string
+                u64 byteOffset = 0;
+                while(byteOffset < text.len && oc_utf8_decode_at(text, byteOffset).status == OC_UTF8_OK)
+                {
+                    byteOffset += oc_utf8_decode_at(text, byteOffset).size;
+                }
+                result = byteOffset;
+            }
+            else
+            {
+                result = oc_utf8_valid_prefix_size(text);
+            }
+            break;
+        case OP_TO_CODEPOINTS:
+            result = scalar ? scalar_to_codepoints(TEXT_SIZE, codepointBuffer, text)
+                            : oc_utf8_to_codepoints(TEXT_SIZE, codepointBuffer, text).len;
+            break;
+        case OP_FROM_CODEPOINTS:
+            result = scalar ? scalar_from_codepoints(TEXT_SIZE, textBuffer, codepoints)
+                            : oc_utf8_from_codepoints(TEXT_SIZE, textBuffer, codepoints).len;
+            break;
+        default:
+            break;
+    }
+    return (result);
+}
+
+int main(int argc, char** argv)
+{
+    oc_init();
+    oc_clock_init();
+
+    const char* asciiWords[] = { "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "orca", "canvas" };
+    const char* latinWords[] = { "le", "café", "était", "fermé", "à", "cause", "de", "la", "grève", "générale" };
+    const char* cjkWords[] = { "日本語", "の", "テキスト", "中文", "文本", "한국어", "텍스트", "漢字" };
+    const char* emojiWords[] = { "😀😃", "🐳", "🎉🎊", "👍", "🚀🌍", "🍕" };
+
+    struct
+    {
+        const char* name;
+        oc_str8 text;
+    } texts[] = {
+        { "ascii", make_text(asciiWords, oc_array_size(asciiWords)) },
+        { "latin", make_text(latinWords, oc_array_size(latinWords)) },
+        { "cjk", make_text(cjkWords, oc_array_size(cjkWords)) },
+        { "emoji", make_text(emojiWords, oc_array_size(emojiWords)) },
+    };
+
+    oc_utf32* codepointBuffer = malloc(TEXT_SIZE * sizeof(oc_utf32));
+    char* textBuffer = malloc(TEXT_SIZE);
+
+    printf("%-8s %-16s %14s %14s %10s\n", "text", "function", "scalar GB/s", "vector GB/s", "speedup");
+
+    for(u32 textIndex = 0; textIndex < oc_array_size(texts); textIndex++)
+    {
+        oc_str8 text = texts[textIndex].text;
+        oc_utf32* codepointsPtr = malloc(TEXT_SIZE * sizeof(oc_utf32));
+        oc_str32 codepoints = oc_utf8_to_codepoints(TEXT_SIZE, codepointsPtr, text);
+
+        for(int op = 0; op < OP_OP_COUNT; op++)
+        {
+            f64 throughput[2] = { 0 };
+            u64 results[2] = { 0 };
+            for(int scalar = 0; scalar < 2; scalar++)
+            {
+                f64 start = oc_clock_time(OC_CLOCK_MONOTONIC);
+                for(int i = 0; i < RUN_COUNT; i++)
+                {
+                    results[scalar] = run(op, scalar, text, codepoints, codepointBuffer, textBuffer);
+                }
+                f64 end = oc_clock_time(OC_CLOCK_MONOTONIC);
+                throughput[scalar] = (f64)text.len * RUN_COUNT / (end - start) / 1e9;
+            }
+            if(results[0] != results[1])
+            {
+                oc_log_error("%s: results differ\n", OP_NAMES[op]);
+            }
+            printf("%-8s %-16s %14.2f %14.2f %9.1fx\n",
+                   texts[textIndex].name,
+                   OP_NAMES[op],
+                   throughput[1],
+                   throughput[0],
+                   throughput[0] / throughput[1]);
+        }
+        free(codepointsPtr);
+    }
+
+    for(u32 textIndex = 0; textIndex < oc_array_size(texts); textIndex++)
+    {
+        free(texts[textIndex].text.ptr);
+    }
+    free(textBuffer);
+    free(codepointBuffer);
+    oc_terminate();
+
+    return (0);
+}
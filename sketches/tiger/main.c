@@ -49,8 +49,18 @@ oc_font create_font()
     return (font);
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    //NOTE: with --bench <frameCount>, render a fixed number of frames and print the average frame time
+    i64 benchFrameCount = 0;
+    for(int i = 1; i + 1 < argc; i++)
+    {
+        if(!strcmp(argv[i], "--bench"))
+        {
+            benchFrameCount = atoll(argv[i + 1]);
+        }
+    }
+
     oc_init();
 
     oc_rect windowRect = { .x = 100, .y = 100, .w = 810, .h = 610 };
@@ -97,6 +107,8 @@ int main()
     int singlePathIndex = 0;
 
     f64 frameTime = 0;
+    i64 frameCount = 0;
+    f64 benchStartTime = oc_clock_time(OC_CLOCK_MONOTONIC);
 
     oc_input_state inputState = { 0 };
 
@@ -257,6 +269,18 @@ int main()
         oc_scratch_end(scratch);
 
         frameTime = oc_clock_time(OC_CLOCK_MONOTONIC) - startTime;
+
+        frameCount++;
+        if(benchFrameCount && frameCount >= benchFrameCount)
+        {
+            f64 benchTime = oc_clock_time(OC_CLOCK_MONOTONIC) - benchStartTime;
+            printf("%lli frames in %fs: avg frame time = %fms, fps = %f\n",
+                   frameCount,
+                   benchTime,
+                   benchTime * 1000. / frameCount,
+                   frameCount / benchTime);
+            oc_request_quit();
+        }
     }
 
     oc_font_destroy(font);
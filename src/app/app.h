@@ -380,6 +380,13 @@ ORCA_API oc_rect oc_window_frame_rect_for_content_rect(oc_rect contentRect, oc_w
 ORCA_API void oc_vsync_init(void);
 ORCA_API void oc_vsync_wait(oc_window window);
 
+#if OC_PLATFORM_LINUX
+//NOTE: the headless linux backend has no display, oc_vsync_wait() waits on a fixed timestep clock instead.
+//      A period of 0 disables throttling.
+ORCA_API void oc_headless_set_frame_period(f64 seconds);
+ORCA_API f64 oc_headless_get_frame_period(void);
+#endif
+
 //---------------------------------------------------------------
 // Dispatching stuff to the main thread
 //---------------------------------------------------------------
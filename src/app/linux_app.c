@@ -0,0 +1,535 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include "app.c"
+
+#include "platform/platform_thread.h"
+#include "graphics/surface.h"
+
+//--------------------------------------------------------------------
+// app management
+//--------------------------------------------------------------------
+
+void oc_init()
+{
+    if(!oc_appData.init)
+    {
+        memset(&oc_appData, 0, sizeof(oc_appData));
+
+        oc_clock_init();
+        oc_init_common();
+
+        //NOTE: there is no keyboard layout in headless mode, so use the default key map
+        memcpy(oc_appData.keyMap, oc_defaultKeyMap, sizeof(oc_appData.keyMap));
+
+        oc_appData.headless.mainThreadID = oc_thread_self_id();
+        oc_appData.headless.mutex = oc_mutex_create();
+        oc_appData.headless.cond = oc_condition_create();
+
+        oc_vsync_init();
+
+        oc_appData.init = true;
+    }
+}
+
+void oc_terminate()
+{
+    if(oc_appData.init)
+    {
+        oc_condition_destroy(oc_appData.headless.cond);
+        oc_mutex_destroy(oc_appData.headless.mutex);
+
+        if(oc_appData.headless.clipboard.ptr)
+        {
+            free(oc_appData.headless.clipboard.ptr);
+        }
+
+        oc_terminate_common();
+        oc_appData = (oc_app){ 0 };
+    }
+}
+
+bool oc_should_quit()
+{
+    return (oc_appData.shouldQuit);
+}
+
+void oc_cancel_quit()
+{
+    oc_appData.shouldQuit = false;
+}
+
+static void oc_headless_wakeup(void)
+{
+    oc_mutex_lock(oc_appData.headless.mutex);
+    {
+        oc_appData.headless.wakeUp = true;
+        oc_condition_broadcast(oc_appData.headless.cond);
+    }
+    oc_mutex_unlock(oc_appData.headless.mutex);
+}
+
+void oc_request_quit()
+{
+    oc_appData.shouldQuit = true;
+    oc_headless_wakeup();
+}
+
+void oc_set_cursor(oc_mouse_cursor cursor)
+{
+    //NOTE: no cursor in headless mode
+}
+
+void oc_pump_events(f64 timeout)
+{
+    //NOTE: there are no system events in headless mode, so this only waits for a wakeup and serves
+    //      the procedures dispatched on the main thread by oc_dispatch_on_main_thread_sync().
+    oc_mutex_lock(oc_appData.headless.mutex);
+    {
+        if(!oc_appData.headless.wakeUp
+           && oc_list_empty(oc_appData.headless.dispatchQueue))
+        {
+            if(timeout < 0)
+            {
+                oc_condition_wait(oc_appData.headless.cond, oc_appData.headless.mutex);
+            }
+            else if(timeout > 0)
+            {
+                oc_condition_timedwait(oc_appData.headless.cond, oc_appData.headless.mutex, timeout);
+            }
+        }
+        oc_appData.headless.wakeUp = false;
+
+        oc_headless_dispatch* dispatch = 0;
+        while((dispatch = oc_list_pop_front_elt(&oc_appData.headless.dispatchQueue, oc_headless_dispatch, listElt)) != 0)
+        {
+            //NOTE: don't hold the lock while running the procedure, since it could itself dispatch or wake us up.
+            oc_mutex_unlock(oc_appData.headless.mutex);
+            i32 result = dispatch->proc(dispatch->user);
+            oc_mutex_lock(oc_appData.headless.mutex);
+
+            dispatch->result = result;
+            dispatch->done = true;
+            oc_condition_broadcast(oc_appData.headless.cond);
+        }
+    }
+    oc_mutex_unlock(oc_appData.headless.mutex);
+}
+
+i32 oc_dispatch_on_main_thread_sync(oc_dispatch_proc proc, void* user)
+{
+    if(oc_thread_self_id() == oc_appData.headless.mainThreadID)
+    {
+        return proc(user);
+    }
+    else
+    {
+        oc_headless_dispatch dispatch = {
+            .proc = proc,
+            .user = user,
+        };
+
+        oc_mutex_lock(oc_appData.headless.mutex);
+        {
+            oc_list_push_back(&oc_appData.headless.dispatchQueue, &dispatch.listElt);
+            oc_condition_broadcast(oc_appData.headless.cond);
+
+            while(!dispatch.done)
+            {
+                oc_condition_wait(oc_appData.headless.cond, oc_appData.headless.mutex);
+            }
+        }
+        oc_mutex_unlock(oc_appData.headless.mutex);
+
+        return dispatch.result;
+    }
+}
+
+//--------------------------------------------------------------------
+// window management
+//--------------------------------------------------------------------
+
+static void oc_headless_queue_resize_event(oc_window_data* window)
+{
+    oc_event event = {
+        .window = oc_window_handle_from_ptr(window),
+        .type = OC_EVENT_WINDOW_RESIZE,
+        .move.frame = window->headless.contentRect,
+        .move.content = window->headless.contentRect,
+    };
+    oc_queue_event(&event);
+}
+
+oc_window oc_window_create(oc_rect rect, oc_str8 title, oc_window_style style)
+{
+    oc_window_data* window = oc_window_alloc();
+    if(!window)
+    {
+        oc_log_error("Could not allocate window data\n");
+        return (oc_window_nil());
+    }
+
+    u32 generation = window->generation;
+    memset(window, 0, sizeof(oc_window_data));
+    window->generation = generation;
+
+    window->style = style;
+    window->hidden = true;
+    window->headless.contentRect = rect;
+
+    return (oc_window_handle_from_ptr(window));
+}
+
+void oc_window_destroy(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        //TODO: we should invalidate the window surfaces still attached here
+        oc_window_recycle_ptr(windowData);
+    }
+}
+
+void* oc_window_native_pointer(oc_window window)
+{
+    return (0);
+}
+
+bool oc_window_should_close(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        return (windowData->shouldClose);
+    }
+    else
+    {
+        return (false);
+    }
+}
+
+void oc_window_request_close(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->shouldClose = true;
+
+        oc_event event = {
+            .window = window,
+            .type = OC_EVENT_WINDOW_CLOSE,
+        };
+        oc_queue_event(&event);
+        oc_headless_wakeup();
+    }
+}
+
+void oc_window_cancel_close(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->shouldClose = false;
+    }
+}
+
+bool oc_window_is_hidden(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        return (windowData->hidden);
+    }
+    else
+    {
+        return (false);
+    }
+}
+
+void oc_window_hide(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->hidden = true;
+    }
+}
+
+void oc_window_show(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->hidden = false;
+    }
+}
+
+void oc_window_set_title(oc_window window, oc_str8 title)
+{
+    //NOTE: windows don't have a title in headless mode
+}
+
+bool oc_window_is_minimized(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        return (windowData->minimized);
+    }
+    else
+    {
+        return (false);
+    }
+}
+
+bool oc_window_is_maximized(oc_window window)
+{
+    return (false);
+}
+
+void oc_window_minimize(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->minimized = true;
+    }
+}
+
+void oc_window_maximize(oc_window window)
+{
+    //NOTE: there is no screen to maximize to in headless mode
+}
+
+void oc_window_restore(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->minimized = false;
+    }
+}
+
+bool oc_window_has_focus(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        return (windowData->headless.focused);
+    }
+    else
+    {
+        return (false);
+    }
+}
+
+void oc_window_focus(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->headless.focused = true;
+    }
+}
+
+void oc_window_unfocus(oc_window window)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        windowData->headless.focused = false;
+    }
+}
+
+void oc_window_send_to_back(oc_window window)
+{
+}
+
+void oc_window_bring_to_front(oc_window window)
+{
+    oc_window_show(window);
+}
+
+oc_rect oc_window_content_rect_for_frame_rect(oc_rect frameRect, oc_window_style style)
+{
+    //NOTE: headless windows don't have decorations, so the frame and content rects are the same
+    return (frameRect);
+}
+
+oc_rect oc_window_frame_rect_for_content_rect(oc_rect contentRect, oc_window_style style)
+{
+    return (contentRect);
+}
+
+oc_rect oc_window_get_frame_rect(oc_window window)
+{
+    return (oc_window_get_content_rect(window));
+}
+
+void oc_window_set_frame_rect(oc_window window, oc_rect rect)
+{
+    oc_window_set_content_rect(window, rect);
+}
+
+oc_rect oc_window_get_content_rect(oc_window window)
+{
+    oc_rect rect = { 0 };
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        rect = windowData->headless.contentRect;
+    }
+    return (rect);
+}
+
+void oc_window_set_content_rect(oc_window window, oc_rect rect)
+{
+    oc_window_data* windowData = oc_window_ptr_from_handle(window);
+    if(windowData)
+    {
+        bool resized = (rect.w != windowData->headless.contentRect.w)
+                    || (rect.h != windowData->headless.contentRect.h);
+
+        windowData->headless.contentRect = rect;
+
+        if(resized)
+        {
+            oc_headless_queue_resize_event(windowData);
+        }
+    }
+}
+
+void oc_window_center(oc_window window)
+{
+    //NOTE: there is no screen to center on in headless mode
+}
+
+//--------------------------------------------------------------------
+// frame clock
+//--------------------------------------------------------------------
+
+void oc_headless_set_frame_period(f64 seconds)
+{
+    oc_appData.headless.framePeriod = oc_max(seconds, 0);
+    oc_appData.headless.nextFrameTime = 0;
+}
+
+f64 oc_headless_get_frame_period(void)
+{
+    return (oc_appData.headless.framePeriod);
+}
+
+void oc_vsync_init(void)
+{
+    if(oc_appData.headless.framePeriod == 0)
+    {
+        oc_appData.headless.framePeriod = 1. / 60.;
+    }
+    oc_appData.headless.nextFrameTime = 0;
+}
+
+void oc_vsync_wait(oc_window window)
+{
+    //NOTE: we don't have a display to sync to, so we emulate vsync with a fixed timestep clock.
+    //      If we're late by more than a frame, we resync the clock rather than trying to catch up.
+    f64 period = oc_appData.headless.framePeriod;
+    if(period > 0)
+    {
+        f64 now = oc_clock_time(OC_CLOCK_MONOTONIC);
+        f64 next = oc_appData.headless.nextFrameTime;
+
+        if(next == 0 || next + period < now)
+        {
+            next = now;
+        }
+        else if(next > now)
+        {
+            oc_sleep_nano((u64)((next - now) * 1e9));
+        }
+        oc_appData.headless.nextFrameTime = next + period;
+    }
+}
+
+//--------------------------------------------------------------------------------
+// clipboard functions
+//--------------------------------------------------------------------------------
+
+//NOTE: headless mode has no system clipboard, so we keep a process-local one
+
+void oc_clipboard_clear(void)
+{
+    oc_mutex_lock(oc_appData.headless.mutex);
+    {
+        if(oc_appData.headless.clipboard.ptr)
+        {
+            free(oc_appData.headless.clipboard.ptr);
+        }
+        oc_appData.headless.clipboard = (oc_str8){ 0 };
+    }
+    oc_mutex_unlock(oc_appData.headless.mutex);
+}
+
+void oc_clipboard_set_string(oc_str8 string)
+{
+    oc_clipboard_clear();
+
+    oc_mutex_lock(oc_appData.headless.mutex);
+    {
+        if(string.len)
+        {
+            oc_appData.headless.clipboard.ptr = malloc(string.len);
+            oc_appData.headless.clipboard.len = string.len;
+            memcpy(oc_appData.headless.clipboard.ptr, string.ptr, string.len);
+        }
+    }
+    oc_mutex_unlock(oc_appData.headless.mutex);
+}
+
+oc_str8 oc_clipboard_get_string(oc_allocator* allocator)
+{
+    oc_str8 string = { 0 };
+    oc_mutex_lock(oc_appData.headless.mutex);
+    {
+        string = oc_str8_push_copy(allocator, oc_appData.headless.clipboard);
+    }
+    oc_mutex_unlock(oc_appData.headless.mutex);
+    return (string);
+}
+
+oc_str8 oc_clipboard_copy_string(oc_str8 backing)
+{
+    oc_str8 string = { 0 };
+    oc_mutex_lock(oc_appData.headless.mutex);
+    {
+        u64 len = oc_min(backing.len, oc_appData.headless.clipboard.len);
+        memcpy(backing.ptr, oc_appData.headless.clipboard.ptr, len);
+        string = oc_str8_from_buffer(len, backing.ptr);
+    }
+    oc_mutex_unlock(oc_appData.headless.mutex);
+    return (string);
+}
+
+//--------------------------------------------------------------------
+// native open/save/alert windows
+//--------------------------------------------------------------------
+
+oc_file_dialog_result oc_file_dialog_for_table(oc_allocator* allocator, oc_file_dialog_desc* desc, oc_file_table* table)
+{
+    //NOTE: there is nobody to answer a dialog in headless mode, so behave as if it was cancelled
+    oc_log_warning("file dialog '%.*s' cancelled (headless mode)\n", oc_str8_ip(desc->title));
+    return ((oc_file_dialog_result){ .button = OC_FILE_DIALOG_CANCEL });
+}
+
+int oc_alert_popup(oc_str8 title,
+                   oc_str8 message,
+                   oc_str8_list options)
+{
+    //NOTE: log the alert and return the first option, which is the conservative choice
+    //      for the popups we show (e.g. "Deny" for file access requests)
+    oc_log_warning("%.*s: %.*s\n", oc_str8_ip(title), oc_str8_ip(message));
+    return (0);
+}
@@ -0,0 +1,53 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "app.h"
+#include "platform/platform_thread.h"
+
+//NOTE: the linux app layer is headless for now. Windows are plain rectangles that are never
+//      mapped on screen, and frames are paced by a fixed timestep clock instead of vsync. This
+//      lets us run apps and benchmarks on machines that don't have a display server or a GPU.
+
+typedef struct oc_headless_window_data
+{
+    oc_rect contentRect;
+    bool focused;
+    oc_list surfaces;
+
+} oc_headless_window_data;
+
+#define OC_PLATFORM_WINDOW_DATA oc_headless_window_data headless;
+
+typedef struct oc_headless_dispatch
+{
+    oc_list_links listElt;
+    oc_dispatch_proc proc;
+    void* user;
+    i32 result;
+    bool done;
+
+} oc_headless_dispatch;
+
+typedef struct oc_headless_app_data
+{
+    u64 mainThreadID;
+
+    oc_mutex* mutex;
+    oc_condition* cond;
+    oc_list dispatchQueue;
+    bool wakeUp;
+
+    f64 framePeriod;
+    f64 nextFrameTime;
+
+    oc_str8 clipboard;
+
+} oc_headless_app_data;
+
+#define OC_PLATFORM_APP_DATA oc_headless_app_data headless;
@@ -83,6 +83,24 @@
     #if OC_GRAPHICS_ENABLE_GL
         #error "Desktop OpenGL backend is not supported on Orca. Make sure you let OC_GRAPHICS_ENABLE_GL undefined or set to 0"
     #endif
+#elif OC_PLATFORM_LINUX
+    //NOTE: the linux platform layer is headless for now, so the only backend enabled by default on Linux
+    //      is the headless canvas renderer, which draws to offscreen surfaces.
+    #ifndef OC_GRAPHICS_ENABLE_HEADLESS
+        #define OC_GRAPHICS_ENABLE_HEADLESS 1
+    #endif
+
+    #ifndef OC_GRAPHICS_ENABLE_CANVAS
+        #if !OC_GRAPHICS_ENABLE_HEADLESS
+            #error "Canvas surface requires the headless backend on Linux. Make sure you define OC_GRAPHICS_ENABLE_HEADLESS to 1."
+        #endif
+        #define OC_GRAPHICS_ENABLE_CANVAS 1
+    #endif
+
+    //NOTE: surface backends not supported on Linux are: Metal, OpenGL, GLES, WebGPU
+    #if OC_GRAPHICS_ENABLE_METAL || OC_GRAPHICS_ENABLE_GL || OC_GRAPHICS_ENABLE_GLES || OC_GRAPHICS_ENABLE_WEBGPU
+        #error "Only the headless backend is supported on Linux. Make sure you let OC_GRAPHICS_ENABLE_METAL, OC_GRAPHICS_ENABLE_GL, OC_GRAPHICS_ENABLE_GLES and OC_GRAPHICS_ENABLE_WEBGPU undefined or set to 0"
+    #endif
 #else
     #error "unsupported platform"
 #endif
@@ -94,6 +112,7 @@ typedef enum
     OC_SURFACE_GL,
     OC_SURFACE_GLES,
     OC_SURFACE_WEBGPU,
+    OC_SURFACE_HEADLESS,
     OC_SURFACE_CANVAS = 1 << 31,
 
 } oc_surface_api;
@@ -6,6 +6,7 @@
 *
 **************************************************************************/
 #include "canvas_renderer.h"
+#include "platform/platform_trace.h"
 
 //---------------------------------------------------------------
 // typed handles
@@ -59,6 +60,8 @@ void oc_canvas_renderer_submit(oc_canvas_renderer rendererHandle,
                                oc_color clearColor,
                                u32 primitiveCount,
                                oc_primitive* primitives,
+                               u32 attributeCount,
+                               oc_attributes* attributes,
                                u32 eltCount,
                                oc_path_elt* elements)
 {
@@ -66,15 +69,20 @@ void oc_canvas_renderer_submit(oc_canvas_renderer rendererHandle,
 
     if(renderer && renderer->submit)
     {
-        renderer->submit(renderer,
-                         surfaceHandle,
-                         msaaSampleCount,
-                         clear,
-                         clearColor,
-                         primitiveCount,
-                         primitives,
-                         eltCount,
-                         elements);
+        oc_trace_zone("canvas renderer submit")
+        {
+            renderer->submit(renderer,
+                             surfaceHandle,
+                             msaaSampleCount,
+                             clear,
+                             clearColor,
+                             primitiveCount,
+                             primitives,
+                             attributeCount,
+                             attributes,
+                             eltCount,
+                             elements);
+        }
     }
 }
 
@@ -83,7 +91,10 @@ void oc_canvas_present(oc_canvas_renderer rendererHandle, oc_surface surfaceHand
     oc_canvas_renderer_base* renderer = oc_canvas_renderer_from_handle(rendererHandle);
     if(renderer && renderer->present)
     {
-        renderer->present(renderer, surfaceHandle);
+        oc_trace_zone("canvas present")
+        {
+            renderer->present(renderer, surfaceHandle);
+        }
     }
 }
 
@@ -39,6 +39,8 @@ typedef void (*oc_canvas_renderer_submit_proc)(oc_canvas_renderer_base* renderer
                                                oc_color clearColor,
                                                u32 primitiveCount,
                                                oc_primitive* primitives,
+                                               u32 attributeCount,
+                                               oc_attributes* attributes,
                                                u32 eltCount,
                                                oc_path_elt* pathElements);
 
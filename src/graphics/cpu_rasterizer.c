@@ -0,0 +1,1523 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "cpu_rasterizer.h"
+#include "platform/platform_thread.h"
+#include "platform/platform_trace.h"
+
+#if OC_ARCH_X64
+    #include <emmintrin.h>
+    #define OC_CPU_RASTER_SSE 1
+#elif OC_ARCH_ARM64
+    #include <arm_neon.h>
+    #define OC_CPU_RASTER_NEON 1
+#endif
+
+enum
+{
+    OC_CPU_RASTER_BAND_HEIGHT = 16,
+    OC_CPU_RASTER_MAX_SAMPLE_COUNT = 8,
+    OC_CPU_RASTER_MAX_THREAD_COUNT = 64,
+    OC_CPU_RASTER_MAX_CURVE_SEGMENTS = 128,
+    OC_CPU_RASTER_INSERTION_SORT_MAX = 32,
+    OC_CPU_RASTER_SRGB_LUT_SIZE = 4096,
+    OC_CPU_RASTER_BUFFER_DEFAULT_LEN = 1024,
+};
+
+//NOTE: max distance between curves and their flattened polylines, in pixels
+static const f32 OC_CPU_RASTER_TOLERANCE = 0.1;
+
+//NOTE: these are the same sample patterns as the GPU renderers
+static const oc_vec2 OC_CPU_RASTER_OFFSETS[4][OC_CPU_RASTER_MAX_SAMPLE_COUNT] = {
+    // msaaSampleCount = 1
+    {
+        { 0, 0 },
+    },
+    // msaaSampleCount = 2
+    {
+        { 0.25, 0.25 },
+        { -0.25, -0.25 },
+    },
+    // msaaSampleCount = 4
+    {
+        { -2 / 16., 6 / 16. },
+        { 6 / 16., 2 / 16. },
+        { -6 / 16., -2 / 16. },
+        { 2 / 16., -6 / 16. },
+    },
+    //msaaSampleCount = 8
+    {
+        { 1 / 16., 3 / 16. },
+        { -1 / 16., -3 / 16. },
+        { 5 / 16., -1 / 16. },
+        { -3 / 16., 5 / 16. },
+        { -5 / 16., -5 / 16. },
+        { -7 / 16., 1 / 16. },
+        { 3 / 16., -7 / 16. },
+        { 7 / 16., 7 / 16. },
+    },
+};
+
+//NOTE: get offsets table index from number of requested samples. Only sample counts
+//      1, 2, 4, 8 are supported, other sample counts are lowered to the closest supported count.
+static const u32 OC_CPU_RASTER_OFFSETS_LOOKUP[OC_CPU_RASTER_MAX_SAMPLE_COUNT] = {
+    0, 1, 1, 2, 2, 2, 2, 3
+};
+
+static const u32 OC_CPU_RASTER_SAMPLE_COUNTS[4] = { 1, 2, 4, 8 };
+
+typedef struct oc_cpu_raster_edge
+{
+    f32 x0;
+    f32 y0;
+    f32 y1;
+    f32 dxdy;
+    i32 winding;
+    u32 pathIndex;
+
+} oc_cpu_raster_edge;
+
+typedef struct oc_cpu_raster_path
+{
+    oc_primitive_cmd cmd;
+    oc_vec4 box;
+    oc_vec4 clip;
+
+    bool solid;
+    oc_vec4 color; // premultiplied, used when solid is true
+
+    oc_vec4 colors[4]; // non-premultiplied linear colors, bl/br/tr/tl
+    bool hasGradient;
+    oc_gradient_blend_space blendSpace;
+
+    oc_mat2x3 uvTransform;
+    oc_cpu_raster_image image;
+
+} oc_cpu_raster_path;
+
+typedef struct oc_cpu_raster_crossing
+{
+    f32 x;
+    i32 winding;
+
+} oc_cpu_raster_crossing;
+
+typedef struct oc_cpu_raster_worker
+{
+    oc_cpu_rasterizer* rasterizer;
+    oc_thread* thread;
+
+    u32 accumCap;
+    f32* accum;
+
+    u32 rowCap;
+    i32* coverageCounts;
+    f32* coverage;
+
+    u32 crossingCap;
+    oc_cpu_raster_crossing* crossings;
+
+    u32 rowEdgeCap;
+    oc_cpu_raster_edge** rowEdges;
+
+} oc_cpu_raster_worker;
+
+typedef struct oc_cpu_rasterizer
+{
+    u32 threadCount;
+    oc_cpu_raster_worker workers[OC_CPU_RASTER_MAX_THREAD_COUNT];
+
+    oc_mutex* mutex;
+    oc_condition* startCond;
+    oc_condition* doneCond;
+    u64 generation;
+    u32 busyCount;
+    bool quit;
+    _Atomic(u32) nextBand;
+
+    f32 srgbLUT[OC_CPU_RASTER_SRGB_LUT_SIZE];
+
+    //NOTE: frame data. Buffers are kept from one frame to the next to avoid reallocating them.
+    u32 pathCount;
+    u32 pathCap;
+    oc_cpu_raster_path* paths;
+
+    u32 edgeCount;
+    u32 edgeCap;
+    oc_cpu_raster_edge* edges;
+
+    u32 flatCap;
+    oc_vec2* flatPoints;
+
+    u32 bandCount;
+    u32 bandCap;
+    u32* bandOffsets;
+
+    u32 entryCap;
+    u32* bandEntries;
+
+    oc_cpu_raster_target target;
+    u32 sampleCount;
+    const oc_vec2* sampleOffsets;
+    bool clear;
+    u8 clearBytes[4];
+
+} oc_cpu_rasterizer;
+
+static void* oc_cpu_raster_grow(void* buffer, u32* cap, u32 needed, u32 eltSize)
+{
+    if(needed > *cap)
+    {
+        u32 newCap = oc_max(needed, oc_max(*cap + *cap / 2, OC_CPU_RASTER_BUFFER_DEFAULT_LEN));
+        buffer = realloc(buffer, (u64)newCap * eltSize);
+        *cap = newCap;
+    }
+    return (buffer);
+}
+
+//------------------------------------------------------------------------------------------
+// Path building
+//------------------------------------------------------------------------------------------
+
+typedef struct oc_cpu_raster_builder
+{
+    oc_cpu_rasterizer* rasterizer;
+    u32 pathIndex;
+    oc_attributes* attributes;
+    oc_mat2x3 userToDevice;
+    f32 userTolerance;
+
+    oc_vec4 userExtents;
+    oc_vec4 deviceExtents;
+
+} oc_cpu_raster_builder;
+
+static void oc_cpu_raster_update_extents(oc_vec4* extents, oc_vec2 p)
+{
+    extents->x = oc_min(extents->x, p.x);
+    extents->y = oc_min(extents->y, p.y);
+    extents->z = oc_max(extents->z, p.x);
+    extents->w = oc_max(extents->w, p.y);
+}
+
+static void oc_cpu_raster_push_edge(oc_cpu_raster_builder* builder, oc_vec2 a, oc_vec2 b, i32 winding)
+{
+    oc_cpu_raster_update_extents(&builder->deviceExtents, a);
+    oc_cpu_raster_update_extents(&builder->deviceExtents, b);
+
+    if(a.y == b.y)
+    {
+        //NOTE: horizontal edges never cross a scanline
+        return;
+    }
+
+    oc_cpu_rasterizer* rasterizer = builder->rasterizer;
+    rasterizer->edges = oc_cpu_raster_grow(rasterizer->edges, &rasterizer->edgeCap, rasterizer->edgeCount + 1, sizeof(oc_cpu_raster_edge));
+
+    oc_cpu_raster_edge* edge = &rasterizer->edges[rasterizer->edgeCount];
+    rasterizer->edgeCount++;
+
+    if(a.y > b.y)
+    {
+        oc_vec2 tmp = a;
+        a = b;
+        b = tmp;
+        winding = -winding;
+    }
+    edge->x0 = a.x;
+    edge->y0 = a.y;
+    edge->y1 = b.y;
+    edge->dxdy = (b.x - a.x) / (b.y - a.y);
+    edge->winding = winding;
+    edge->pathIndex = builder->pathIndex;
+}
+
+//NOTE: flattens a curve into rasterizer->flatPoints, not including the first control point.
+//      The number of segments is given by Wang's formula.
+static u32 oc_cpu_raster_flatten(oc_cpu_rasterizer* rasterizer, oc_path_elt_type type, oc_vec2* p, f32 tolerance)
+{
+    u32 count = 1;
+    switch(type)
+    {
+        case OC_PATH_QUADRATIC:
+        {
+            f32 dd = sqrtf(oc_square(p[0].x - 2 * p[1].x + p[2].x) + oc_square(p[0].y - 2 * p[1].y + p[2].y));
+            count = (u32)ceilf(sqrtf(dd / (4 * tolerance)));
+        }
+        break;
+
+        case OC_PATH_CUBIC:
+        {
+            f32 dd0 = sqrtf(oc_square(p[0].x - 2 * p[1].x + p[2].x) + oc_square(p[0].y - 2 * p[1].y + p[2].y));
+            f32 dd1 = sqrtf(oc_square(p[1].x - 2 * p[2].x + p[3].x) + oc_square(p[1].y - 2 * p[2].y + p[3].y));
+            count = (u32)ceilf(sqrtf(3 * oc_max(dd0, dd1) / (4 * tolerance)));
+        }
+        break;
+
+        default:
+            break;
+    }
+    count = oc_clamp(count, 1, OC_CPU_RASTER_MAX_CURVE_SEGMENTS);
+
+    rasterizer->flatPoints = oc_cpu_raster_grow(rasterizer->flatPoints, &rasterizer->flatCap, count, sizeof(oc_vec2));
+    oc_vec2* out = rasterizer->flatPoints;
+
+    for(u32 i = 1; i <= count; i++)
+    {
+        f32 t = (f32)i / count;
+        f32 s = 1 - t;
+        switch(type)
+        {
+            case OC_PATH_LINE:
+                out[i - 1] = p[1];
+                break;
+
+            case OC_PATH_QUADRATIC:
+                out[i - 1] = (oc_vec2){
+                    s * s * p[0].x + 2 * s * t * p[1].x + t * t * p[2].x,
+                    s * s * p[0].y + 2 * s * t * p[1].y + t * t * p[2].y,
+                };
+                break;
+
+            case OC_PATH_CUBIC:
+                out[i - 1] = (oc_vec2){
+                    s * s * s * p[0].x + 3 * s * s * t * p[1].x + 3 * s * t * t * p[2].x + t * t * t * p[3].x,
+                    s * s * s * p[0].y + 3 * s * s * t * p[1].y + 3 * s * t * t * p[2].y + t * t * t * p[3].y,
+                };
+                break;
+
+            default:
+                break;
+        }
+    }
+    return (count);
+}
+
+static u32 oc_cpu_raster_elt_point_count(oc_path_elt_type type)
+{
+    switch(type)
+    {
+        case OC_PATH_LINE:
+            return (1);
+        case OC_PATH_QUADRATIC:
+            return (2);
+        case OC_PATH_CUBIC:
+            return (3);
+        default:
+            return (0);
+    }
+}
+
+static void oc_cpu_raster_build_fill(oc_cpu_raster_builder* builder, oc_path_elt* elements, oc_path_descriptor* path)
+{
+    oc_cpu_rasterizer* rasterizer = builder->rasterizer;
+
+    //NOTE: fills are flattened in device space. Subpaths are implicitly closed.
+    oc_vec2 currentUser = path->startPoint;
+    oc_vec2 current = oc_mat2x3_mul(builder->userToDevice, currentUser);
+    oc_vec2 subPathStart = current;
+
+    for(u32 eltIndex = 0; eltIndex < path->count; eltIndex++)
+    {
+        oc_path_elt* elt = &elements[eltIndex];
+
+        if(elt->type == OC_PATH_MOVE)
+        {
+            oc_cpu_raster_push_edge(builder, current, subPathStart, 1);
+            currentUser = elt->p[0];
+            current = oc_mat2x3_mul(builder->userToDevice, currentUser);
+            subPathStart = current;
+        }
+        else
+        {
+            u32 pointCount = oc_cpu_raster_elt_point_count(elt->type);
+
+            oc_vec2 p[4] = { current };
+            oc_cpu_raster_update_extents(&builder->userExtents, currentUser);
+            for(u32 i = 0; i < pointCount; i++)
+            {
+                oc_cpu_raster_update_extents(&builder->userExtents, elt->p[i]);
+                p[i + 1] = oc_mat2x3_mul(builder->userToDevice, elt->p[i]);
+            }
+
+            u32 count = oc_cpu_raster_flatten(rasterizer, elt->type, p, OC_CPU_RASTER_TOLERANCE);
+            for(u32 i = 0; i < count; i++)
+            {
+                oc_cpu_raster_push_edge(builder, current, rasterizer->flatPoints[i], 1);
+                current = rasterizer->flatPoints[i];
+            }
+            current = p[pointCount];
+            currentUser = elt->p[pointCount - 1];
+        }
+    }
+    oc_cpu_raster_push_edge(builder, current, subPathStart, 1);
+}
+
+//NOTE: stroke pieces are emitted as small closed polygons in user space, all with the same orientation
+//      in device space, so that their union is given by the non-zero winding rule.
+static void oc_cpu_raster_push_polygon(oc_cpu_raster_builder* builder, u32 count, oc_vec2* points)
+{
+    oc_vec2 devicePoints[8];
+    OC_DEBUG_ASSERT(count <= oc_array_size(devicePoints));
+
+    f32 area = 0;
+    for(u32 i = 0; i < count; i++)
+    {
+        devicePoints[i] = oc_mat2x3_mul(builder->userToDevice, points[i]);
+    }
+    for(u32 i = 0; i < count; i++)
+    {
+        oc_vec2 a = devicePoints[i];
+        oc_vec2 b = devicePoints[(i + 1) % count];
+        area += a.x * b.y - b.x * a.y;
+    }
+    if(area == 0)
+    {
+        return;
+    }
+    i32 winding = (area > 0) ? 1 : -1;
+
+    for(u32 i = 0; i < count; i++)
+    {
+        oc_cpu_raster_update_extents(&builder->userExtents, points[i]);
+        oc_cpu_raster_push_edge(builder, devicePoints[i], devicePoints[(i + 1) % count], winding);
+    }
+}
+
+static void oc_cpu_raster_stroke_segment(oc_cpu_raster_builder* builder, oc_vec2 p0, oc_vec2 p1)
+{
+    oc_vec2 v = { p1.x - p0.x, p1.y - p0.y };
+    f32 norm = sqrtf(v.x * v.x + v.y * v.y);
+    if(norm == 0)
+    {
+        return;
+    }
+    f32 halfWidth = 0.5 * builder->attributes->width;
+    oc_vec2 n = { v.y * halfWidth / norm, -v.x * halfWidth / norm };
+
+    oc_vec2 points[4] = {
+        { p0.x + n.x, p0.y + n.y },
+        { p1.x + n.x, p1.y + n.y },
+        { p1.x - n.x, p1.y - n.y },
+        { p0.x - n.x, p0.y - n.y },
+    };
+    oc_cpu_raster_push_polygon(builder, 4, points);
+}
+
+static void oc_cpu_raster_stroke_cap(oc_cpu_raster_builder* builder, oc_vec2 p0, oc_vec2 direction)
+{
+    f32 dn = sqrtf(oc_square(direction.x) + oc_square(direction.y));
+    f32 alpha = 0.5 * builder->attributes->width / dn;
+
+    oc_vec2 n0 = { -alpha * direction.y, alpha * direction.x };
+    oc_vec2 m0 = { alpha * direction.x, alpha * direction.y };
+
+    oc_vec2 points[4] = {
+        { p0.x + n0.x, p0.y + n0.y },
+        { p0.x + n0.x + m0.x, p0.y + n0.y + m0.y },
+        { p0.x - n0.x + m0.x, p0.y - n0.y + m0.y },
+        { p0.x - n0.x, p0.y - n0.y },
+    };
+    oc_cpu_raster_push_polygon(builder, 4, points);
+}
+
+static void oc_cpu_raster_stroke_joint(oc_cpu_raster_builder* builder, oc_vec2 p0, oc_vec2 t0, oc_vec2 t1, oc_joint_type joint)
+{
+    oc_attributes* attributes = builder->attributes;
+
+    f32 normT0 = sqrtf(oc_square(t0.x) + oc_square(t0.y));
+    f32 normT1 = sqrtf(oc_square(t1.x) + oc_square(t1.y));
+    if(normT0 == 0 || normT1 == 0)
+    {
+        return;
+    }
+
+    oc_vec2 n0 = { -t0.y / normT0, t0.x / normT0 };
+    oc_vec2 n1 = { -t1.y / normT1, t1.x / normT1 };
+
+    //NOTE: flip normals so that they face outwards the angle
+    f32 crossZ = n0.x * n1.y - n0.y * n1.x;
+    if(crossZ > 0)
+    {
+        n0 = (oc_vec2){ -n0.x, -n0.y };
+        n1 = (oc_vec2){ -n1.x, -n1.y };
+    }
+
+    f32 halfW = 0.5 * attributes->width;
+    oc_vec2 u = { n0.x + n1.x, n0.y + n1.y };
+    f32 uNormSquare = u.x * u.x + u.y * u.y;
+
+    if(joint == OC_JOINT_MITER && uNormSquare > 0)
+    {
+        f32 alpha = attributes->width / uNormSquare;
+        oc_vec2 v = { u.x * alpha, u.y * alpha };
+        f32 excursionSquare = uNormSquare * oc_square(alpha - attributes->width / 4);
+
+        if(excursionSquare <= oc_square(attributes->maxJointExcursion))
+        {
+            oc_vec2 points[4] = {
+                p0,
+                { p0.x + n0.x * halfW, p0.y + n0.y * halfW },
+                { p0.x + v.x, p0.y + v.y },
+                { p0.x + n1.x * halfW, p0.y + n1.y * halfW },
+            };
+            oc_cpu_raster_push_polygon(builder, 4, points);
+            return;
+        }
+    }
+
+    //NOTE: bevel joint
+    oc_vec2 points[3] = {
+        p0,
+        { p0.x + n0.x * halfW, p0.y + n0.y * halfW },
+        { p0.x + n1.x * halfW, p0.y + n1.y * halfW },
+    };
+    oc_cpu_raster_push_polygon(builder, 3, points);
+}
+
+static bool oc_cpu_raster_is_stroke_element_null(oc_vec2 currentPoint, oc_path_elt* element)
+{
+    u32 count = oc_cpu_raster_elt_point_count(element->type);
+    for(u32 i = 0; i < count; i++)
+    {
+        if(element->p[i].x != currentPoint.x || element->p[i].y != currentPoint.y)
+        {
+            return (false);
+        }
+    }
+    return (true);
+}
+
+static void oc_cpu_raster_stroke_element(oc_cpu_raster_builder* builder,
+                                         oc_path_elt* element,
+                                         oc_vec2 currentPoint,
+                                         oc_vec2* startTangent,
+                                         oc_vec2* endTangent,
+                                         oc_vec2* endPoint)
+{
+    oc_cpu_rasterizer* rasterizer = builder->rasterizer;
+
+    oc_vec2 controlPoints[4] = { currentPoint, element->p[0], element->p[1], element->p[2] };
+    u32 endPointIndex = oc_cpu_raster_elt_point_count(element->type);
+
+    //NOTE: flatten in user space, then stroke each segment, with bevel joints between segments.
+    u32 count = oc_cpu_raster_flatten(rasterizer, element->type, controlPoints, builder->userTolerance);
+
+    oc_vec2 prev = currentPoint;
+    oc_vec2 prevTangent = { 0, 0 };
+    for(u32 i = 0; i < count; i++)
+    {
+        oc_vec2 next = rasterizer->flatPoints[i];
+        oc_vec2 tangent = { next.x - prev.x, next.y - prev.y };
+        if(tangent.x == 0 && tangent.y == 0)
+        {
+            continue;
+        }
+        oc_cpu_raster_stroke_segment(builder, prev, next);
+        if(prevTangent.x != 0 || prevTangent.y != 0)
+        {
+            oc_cpu_raster_stroke_joint(builder, prev, prevTangent, tangent, OC_JOINT_BEVEL);
+        }
+        prevTangent = tangent;
+        prev = next;
+    }
+
+    //NOTE: compute tangents from control points, skipping coincident points
+    for(u32 i = 1; i <= endPointIndex; i++)
+    {
+        if(controlPoints[i].x != controlPoints[0].x
+           || controlPoints[i].y != controlPoints[0].y)
+        {
+            *startTangent = (oc_vec2){ controlPoints[i].x - controlPoints[0].x,
+                                       controlPoints[i].y - controlPoints[0].y };
+            break;
+        }
+    }
+    *endPoint = controlPoints[endPointIndex];
+
+    for(i32 i = (i32)endPointIndex - 1; i >= 0; i--)
+    {
+        if(controlPoints[i].x != endPoint->x
+           || controlPoints[i].y != endPoint->y)
+        {
+            *endTangent = (oc_vec2){ endPoint->x - controlPoints[i].x,
+                                     endPoint->y - controlPoints[i].y };
+            break;
+        }
+    }
+}
+
+static u32 oc_cpu_raster_build_stroke_subpath(oc_cpu_raster_builder* builder,
+                                              oc_path_elt* elements,
+                                              u32 eltCount,
+                                              u32 startIndex,
+                                              oc_vec2 startPoint)
+{
+    oc_attributes* attributes = builder->attributes;
+
+    oc_vec2 currentPoint = startPoint;
+    oc_vec2 endPoint = { 0, 0 };
+    oc_vec2 previousEndTangent = { 0, 0 };
+    oc_vec2 firstTangent = { 0, 0 };
+    oc_vec2 startTangent = { 0, 0 };
+    oc_vec2 endTangent = { 0, 0 };
+
+    //NOTE skip elements that produce null tangents (these are degenerate zero length elements).
+    u32 eltIndex = startIndex;
+    while(eltIndex < eltCount
+          && elements[eltIndex].type != OC_PATH_MOVE
+          && oc_cpu_raster_is_stroke_element_null(currentPoint, elements + eltIndex))
+    {
+        eltIndex++;
+    }
+    if(eltIndex >= eltCount || elements[eltIndex].type == OC_PATH_MOVE)
+    {
+        return eltIndex;
+    }
+
+    oc_cpu_raster_stroke_element(builder, elements + eltIndex, currentPoint, &startTangent, &endTangent, &endPoint);
+    eltIndex++;
+
+    firstTangent = startTangent;
+    previousEndTangent = endTangent;
+    currentPoint = endPoint;
+
+    while(eltIndex < eltCount && elements[eltIndex].type != OC_PATH_MOVE)
+    {
+        while(eltIndex < eltCount
+              && elements[eltIndex].type != OC_PATH_MOVE
+              && oc_cpu_raster_is_stroke_element_null(currentPoint, elements + eltIndex))
+        {
+            eltIndex++;
+        }
+        if(eltIndex >= eltCount || elements[eltIndex].type == OC_PATH_MOVE)
+        {
+            break;
+        }
+
+        oc_cpu_raster_stroke_element(builder, elements + eltIndex, currentPoint, &startTangent, &endTangent, &endPoint);
+
+        if(attributes->joint != OC_JOINT_NONE)
+        {
+            oc_cpu_raster_stroke_joint(builder, currentPoint, previousEndTangent, startTangent, attributes->joint);
+        }
+        previousEndTangent = endTangent;
+        currentPoint = endPoint;
+
+        eltIndex++;
+    }
+    u32 subPathEltCount = eltIndex - startIndex;
+
+    if(subPathEltCount > 1
+       && startPoint.x == endPoint.x
+       && startPoint.y == endPoint.y)
+    {
+        if(attributes->joint != OC_JOINT_NONE)
+        {
+            oc_cpu_raster_stroke_joint(builder, endPoint, endTangent, firstTangent, attributes->joint);
+        }
+    }
+    else if(attributes->cap == OC_CAP_SQUARE)
+    {
+        oc_cpu_raster_stroke_cap(builder, startPoint, (oc_vec2){ -startTangent.x, -startTangent.y });
+        oc_cpu_raster_stroke_cap(builder, endPoint, endTangent);
+    }
+    return (eltIndex);
+}
+
+static void oc_cpu_raster_build_stroke(oc_cpu_raster_builder* builder, oc_path_elt* elements, oc_path_descriptor* path)
+{
+    if(builder->attributes->width <= 0)
+    {
+        return;
+    }
+
+    u32 eltCount = path->count;
+    oc_vec2 startPoint = path->startPoint;
+    u32 startIndex = 0;
+
+    while(startIndex < eltCount)
+    {
+        while(startIndex < eltCount && elements[startIndex].type == OC_PATH_MOVE)
+        {
+            startPoint = elements[startIndex].p[0];
+            startIndex++;
+        }
+        if(startIndex < eltCount)
+        {
+            startIndex = oc_cpu_raster_build_stroke_subpath(builder, elements, eltCount, startIndex, startPoint);
+        }
+    }
+}
+
+static void oc_cpu_raster_build_path(oc_cpu_rasterizer* rasterizer,
+                                     oc_primitive* primitive,
+                                     oc_attributes* attributes,
+                                     oc_path_elt* elements,
+                                     u32 eltCount,
+                                     oc_cpu_raster_image_proc imageProc,
+                                     void* imageUser)
+{
+    oc_vec2 scale = rasterizer->target.scale;
+
+    oc_mat2x3 scaleM = {
+        scale.x, 0, 0,
+        0, scale.y, 0
+    };
+
+    oc_cpu_raster_builder builder = {
+        .rasterizer = rasterizer,
+        .pathIndex = rasterizer->pathCount,
+        .attributes = attributes,
+        .userToDevice = oc_mat2x3_mul_m(scaleM, attributes->transform),
+        .userExtents = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX },
+        .deviceExtents = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX },
+    };
+
+    //NOTE: strokes are flattened in user space, so we scale the tolerance by the largest stretch of the transform.
+    oc_mat2x3 m = builder.userToDevice;
+    f32 stretch = oc_max(sqrtf(m.m[0] * m.m[0] + m.m[3] * m.m[3]), sqrtf(m.m[1] * m.m[1] + m.m[4] * m.m[4]));
+    builder.userTolerance = (stretch > 0) ? OC_CPU_RASTER_TOLERANCE / stretch : OC_CPU_RASTER_TOLERANCE;
+
+    oc_path_elt rectElements[OC_RECT_PRIMITIVE_MAX_ELEMENT_COUNT];
+    oc_path_descriptor path = primitive->path;
+
+    if(primitive->cmd == OC_CMD_RECT_FILL)
+    {
+        elements = rectElements;
+        path = (oc_path_descriptor){
+            .count = oc_rect_primitive_elements(primitive, rectElements),
+            .startPoint = rectElements[0].p[0],
+        };
+    }
+    else
+    {
+        if(path.startIndex >= eltCount)
+        {
+            return;
+        }
+        path.count = oc_min(path.count, eltCount - path.startIndex);
+    }
+
+    u32 edgeStart = rasterizer->edgeCount;
+
+    if(primitive->cmd == OC_CMD_STROKE)
+    {
+        oc_cpu_raster_build_stroke(&builder, elements + path.startIndex, &path);
+    }
+    else
+    {
+        oc_cpu_raster_build_fill(&builder, elements + path.startIndex, &path);
+    }
+
+    //NOTE: compute the path's box, clipped to the clip rect and the target
+    oc_vec4 clip = {
+        attributes->clip.x * scale.x,
+        attributes->clip.y * scale.y,
+        (attributes->clip.x + attributes->clip.w) * scale.x,
+        (attributes->clip.y + attributes->clip.h) * scale.y,
+    };
+    oc_vec4 box = {
+        oc_max(oc_max(builder.deviceExtents.x, clip.x), 0),
+        oc_max(oc_max(builder.deviceExtents.y, clip.y), 0),
+        oc_min(oc_min(builder.deviceExtents.z, clip.z), rasterizer->target.width),
+        oc_min(oc_min(builder.deviceExtents.w, clip.w), rasterizer->target.height),
+    };
+
+    if(rasterizer->edgeCount == edgeStart || box.x >= box.z || box.y >= box.w)
+    {
+        //NOTE: path is empty or out of view, discard its edges
+        rasterizer->edgeCount = edgeStart;
+        return;
+    }
+
+    rasterizer->paths = oc_cpu_raster_grow(rasterizer->paths, &rasterizer->pathCap, rasterizer->pathCount + 1, sizeof(oc_cpu_raster_path));
+    oc_cpu_raster_path* rasterPath = &rasterizer->paths[rasterizer->pathCount];
+    rasterizer->pathCount++;
+
+    memset(rasterPath, 0, sizeof(oc_cpu_raster_path));
+    rasterPath->cmd = (primitive->cmd == OC_CMD_STROKE) ? OC_CMD_STROKE : OC_CMD_FILL;
+    rasterPath->box = box;
+    rasterPath->clip = clip;
+    rasterPath->hasGradient = attributes->hasGradient;
+    rasterPath->blendSpace = attributes->blendSpace;
+
+    for(int i = 0; i < 4; i++)
+    {
+        //NOTE: the first color is stored in the primitive
+        oc_color c = oc_color_convert(i ? attributes->colors[i] : primitive->color, OC_COLOR_SPACE_RGB);
+        memcpy(rasterPath->colors[i].c, c.c, 4 * sizeof(f32));
+    }
+
+    if(!oc_image_is_nil(attributes->image) && imageProc)
+    {
+        rasterPath->image = imageProc(attributes->image, imageUser);
+    }
+
+    if(rasterPath->image.pixels || rasterPath->hasGradient)
+    {
+        //NOTE: compute the transform from device coordinates to uv coordinates, the same way the GPU renderers do.
+        oc_vec2 texSize;
+        oc_rect srcRegion;
+        if(rasterPath->image.pixels)
+        {
+            texSize = (oc_vec2){ rasterPath->image.width, rasterPath->image.height };
+            srcRegion = attributes->srcRegion;
+        }
+        else
+        {
+            texSize = (oc_vec2){ 1, 1 };
+            srcRegion = (oc_rect){ 0, 0, 1, 1 };
+        }
+
+        oc_rect destRegion = {
+            builder.userExtents.x,
+            builder.userExtents.y,
+            builder.userExtents.z - builder.userExtents.x,
+            builder.userExtents.w - builder.userExtents.y,
+        };
+
+        oc_mat2x3 srcRegionToImage = {
+            1 / texSize.x, 0, srcRegion.x / texSize.x,
+            0, 1 / texSize.y, srcRegion.y / texSize.y
+        };
+
+        oc_mat2x3 destRegionToSrcRegion = {
+            srcRegion.w / destRegion.w, 0, 0,
+            0, srcRegion.h / destRegion.h, 0
+        };
+
+        oc_mat2x3 userToDestRegion = {
+            1, 0, -destRegion.x,
+            0, 1, -destRegion.y
+        };
+
+        oc_mat2x3 screenToUser = oc_mat2x3_inv(builder.userToDevice);
+
+        oc_mat2x3 uvTransform = srcRegionToImage;
+        uvTransform = oc_mat2x3_mul_m(uvTransform, destRegionToSrcRegion);
+        uvTransform = oc_mat2x3_mul_m(uvTransform, userToDestRegion);
+        uvTransform = oc_mat2x3_mul_m(uvTransform, screenToUser);
+
+        rasterPath->uvTransform = uvTransform;
+    }
+
+    rasterPath->solid = !rasterPath->hasGradient && !rasterPath->image.pixels;
+    if(rasterPath->solid)
+    {
+        oc_vec4 c = rasterPath->colors[0];
+        rasterPath->color = (oc_vec4){ c.x * c.w, c.y * c.w, c.z * c.w, c.w };
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Shading
+//------------------------------------------------------------------------------------------
+
+static oc_vec4 oc_cpu_raster_sample_image(oc_cpu_raster_image* image, oc_vec2 uv)
+{
+    oc_vec4 color = { 0 };
+    if(uv.x >= 0 && uv.y >= 0 && uv.x <= 1 && uv.y <= 1)
+    {
+        f32 px = oc_clamp(uv.x * image->width - 0.5, 0, image->width - 1);
+        f32 py = oc_clamp(uv.y * image->height - 0.5, 0, image->height - 1);
+
+        u32 x0 = (u32)px;
+        u32 y0 = (u32)py;
+        u32 x1 = oc_min(x0 + 1, image->width - 1);
+        u32 y1 = oc_min(y0 + 1, image->height - 1);
+        f32 rx = px - x0;
+        f32 ry = py - y0;
+
+        u8* tl = image->pixels + (y0 * image->width + x0) * 4;
+        u8* tr = image->pixels + (y0 * image->width + x1) * 4;
+        u8* bl = image->pixels + (y1 * image->width + x0) * 4;
+        u8* br = image->pixels + (y1 * image->width + x1) * 4;
+
+        for(int i = 0; i < 4; i++)
+        {
+            f32 l = (1 - ry) * tl[i] + ry * bl[i];
+            f32 r = (1 - ry) * tr[i] + ry * br[i];
+            color.c[i] = ((1 - rx) * l + rx * r) / 255.;
+        }
+    }
+    return (color);
+}
+
+//NOTE: returns the premultiplied color of a path at a given point in device space
+static oc_vec4 oc_cpu_raster_path_color(oc_cpu_raster_path* path, f32 x, f32 y)
+{
+    oc_vec4 color;
+    oc_vec2 uv = oc_mat2x3_mul(path->uvTransform, (oc_vec2){ x, y });
+
+    if(!path->hasGradient)
+    {
+        color = path->colors[0];
+    }
+    else
+    {
+        oc_vec4 bl = path->colors[0];
+        oc_vec4 br = path->colors[1];
+        oc_vec4 tr = path->colors[2];
+        oc_vec4 tl = path->colors[3];
+
+        if(path->blendSpace == OC_GRADIENT_BLEND_SRGB)
+        {
+            for(int i = 0; i < 3; i++)
+            {
+                bl.c[i] = powf(bl.c[i], 0.454545);
+                br.c[i] = powf(br.c[i], 0.454545);
+                tr.c[i] = powf(tr.c[i], 0.454545);
+                tl.c[i] = powf(tl.c[i], 0.454545);
+            }
+        }
+
+        for(int i = 0; i < 4; i++)
+        {
+            f32 b = (1. - uv.x) * bl.c[i] + uv.x * br.c[i];
+            f32 t = (1. - uv.x) * tl.c[i] + uv.x * tr.c[i];
+            color.c[i] = uv.y * b + (1 - uv.y) * t;
+        }
+
+        if(path->blendSpace == OC_GRADIENT_BLEND_SRGB)
+        {
+            for(int i = 0; i < 3; i++)
+            {
+                color.c[i] = powf(color.c[i], 2.2);
+            }
+        }
+    }
+
+    color = (oc_vec4){ color.x * color.w, color.y * color.w, color.z * color.w, color.w };
+
+    if(path->image.pixels)
+    {
+        oc_vec4 texColor = oc_cpu_raster_sample_image(&path->image, uv);
+        color.x *= texColor.x * texColor.w;
+        color.y *= texColor.y * texColor.w;
+        color.z *= texColor.z * texColor.w;
+        color.w *= texColor.w;
+    }
+    return (color);
+}
+
+//NOTE: composite a premultiplied color over a row of premultiplied pixels, with per-pixel coverage
+static void oc_cpu_raster_blend_solid(f32* dst, f32* coverage, u32 count, oc_vec4 color)
+{
+#if OC_CPU_RASTER_SSE
+    __m128 src = _mm_loadu_ps(color.c);
+    __m128 one = _mm_set1_ps(1);
+    __m128 alpha = _mm_set1_ps(color.w);
+
+    for(u32 i = 0; i < count; i++)
+    {
+        if(coverage[i] == 0)
+        {
+            continue;
+        }
+        __m128 cov = _mm_set1_ps(coverage[i]);
+        __m128 d = _mm_loadu_ps(dst + 4 * i);
+        __m128 s = _mm_mul_ps(src, cov);
+        __m128 inv = _mm_sub_ps(one, _mm_mul_ps(alpha, cov));
+        _mm_storeu_ps(dst + 4 * i, _mm_add_ps(s, _mm_mul_ps(d, inv)));
+    }
+#elif OC_CPU_RASTER_NEON
+    float32x4_t src = vld1q_f32(color.c);
+
+    for(u32 i = 0; i < count; i++)
+    {
+        if(coverage[i] == 0)
+        {
+            continue;
+        }
+        float32x4_t d = vld1q_f32(dst + 4 * i);
+        float32x4_t s = vmulq_n_f32(src, coverage[i]);
+        float32x4_t inv = vdupq_n_f32(1 - color.w * coverage[i]);
+        vst1q_f32(dst + 4 * i, vmlaq_f32(s, d, inv));
+    }
+#else
+    for(u32 i = 0; i < count; i++)
+    {
+        f32 cov = coverage[i];
+        if(cov == 0)
+        {
+            continue;
+        }
+        f32 inv = 1 - color.w * cov;
+        for(int c = 0; c < 4; c++)
+        {
+            dst[4 * i + c] = color.c[c] * cov + dst[4 * i + c] * inv;
+        }
+    }
+#endif
+}
+
+static void oc_cpu_raster_blend_shaded(f32* dst, f32* coverage, u32 count, oc_cpu_raster_path* path, i32 x0, i32 y)
+{
+    for(u32 i = 0; i < count; i++)
+    {
+        f32 cov = coverage[i];
+        if(cov == 0)
+        {
+            continue;
+        }
+        //NOTE: like the GPU renderers, colors are evaluated at the pixel center
+        oc_vec4 color = oc_cpu_raster_path_color(path, x0 + i + 0.5, y + 0.5);
+        f32 inv = 1 - color.w * cov;
+        for(int c = 0; c < 4; c++)
+        {
+            dst[4 * i + c] = color.c[c] * cov + dst[4 * i + c] * inv;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------
+// Band rasterization
+//------------------------------------------------------------------------------------------
+
+static int oc_cpu_raster_crossing_cmp(const void* a, const void* b)
+{
+    f32 x = ((oc_cpu_raster_crossing*)a)->x;
+    f32 y = ((oc_cpu_raster_crossing*)b)->x;
+    return ((x > y) - (x < y));
+}
+
+static void oc_cpu_raster_sort_crossings(oc_cpu_raster_crossing* crossings, u32 count)
+{
+    if(count > OC_CPU_RASTER_INSERTION_SORT_MAX)
+    {
+        qsort(crossings, count, sizeof(oc_cpu_raster_crossing), oc_cpu_raster_crossing_cmp);
+    }
+    else
+    {
+        for(u32 i = 1; i < count; i++)
+        {
+            oc_cpu_raster_crossing c = crossings[i];
+            i32 j = i - 1;
+            while(j >= 0 && crossings[j].x > c.x)
+            {
+                crossings[j + 1] = crossings[j];
+                j--;
+            }
+            crossings[j + 1] = c;
+        }
+    }
+}
+
+static void oc_cpu_raster_band_path(oc_cpu_raster_worker* worker,
+                                    oc_cpu_raster_path* path,
+                                    u32 entryCount,
+                                    u32* entries,
+                                    i32 bandY0,
+                                    i32 bandY1)
+{
+    oc_cpu_rasterizer* rasterizer = worker->rasterizer;
+    u32 width = rasterizer->target.width;
+
+    i32 px0 = oc_max((i32)floorf(path->box.x), 0);
+    i32 px1 = oc_min((i32)ceilf(path->box.z), (i32)width);
+    i32 py0 = oc_max((i32)floorf(path->box.y), bandY0);
+    i32 py1 = oc_min((i32)ceilf(path->box.w), bandY1);
+
+    if(px0 >= px1 || py0 >= py1)
+    {
+        return;
+    }
+
+    worker->crossings = oc_cpu_raster_grow(worker->crossings, &worker->crossingCap, entryCount, sizeof(oc_cpu_raster_crossing));
+    worker->rowEdges = oc_cpu_raster_grow(worker->rowEdges, &worker->rowEdgeCap, entryCount, sizeof(oc_cpu_raster_edge*));
+
+    u32 sampleCount = rasterizer->sampleCount;
+    f32 invSampleCount = 1. / sampleCount;
+    const oc_vec2* offsets = rasterizer->sampleOffsets;
+    bool nonZero = (path->cmd == OC_CMD_STROKE);
+
+    for(i32 py = py0; py < py1; py++)
+    {
+        //NOTE: gather the edges that span this row, so that samples only test those
+        u32 rowEdgeCount = 0;
+        for(u32 entryIndex = 0; entryIndex < entryCount; entryIndex++)
+        {
+            oc_cpu_raster_edge* edge = &rasterizer->edges[entries[entryIndex]];
+            if(edge->y1 > py && edge->y0 < py + 1)
+            {
+                worker->rowEdges[rowEdgeCount] = edge;
+                rowEdgeCount++;
+            }
+        }
+        if(rowEdgeCount < 2)
+        {
+            continue;
+        }
+
+        i32* counts = worker->coverageCounts;
+        memset(counts + px0, 0, (px1 - px0 + 1) * sizeof(i32));
+        bool covered = false;
+
+        for(u32 sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++)
+        {
+            f32 sy = py + 0.5 + offsets[sampleIndex].y;
+            f32 ox = 0.5 + offsets[sampleIndex].x;
+
+            if(sy < path->clip.y || sy >= path->clip.w)
+            {
+                continue;
+            }
+
+            //NOTE: find crossings of the sample row with the path's edges
+            u32 crossingCount = 0;
+            for(u32 edgeIndex = 0; edgeIndex < rowEdgeCount; edgeIndex++)
+            {
+                oc_cpu_raster_edge* edge = worker->rowEdges[edgeIndex];
+                if(sy >= edge->y0 && sy < edge->y1)
+                {
+                    f32 x = edge->x0 + (sy - edge->y0) * edge->dxdy;
+                    worker->crossings[crossingCount] = (oc_cpu_raster_crossing){
+                        .x = oc_clamp(x, -1, (f32)width + 1),
+                        .winding = edge->winding,
+                    };
+                    crossingCount++;
+                }
+            }
+            if(crossingCount < 2)
+            {
+                continue;
+            }
+            oc_cpu_raster_sort_crossings(worker->crossings, crossingCount);
+
+            //NOTE: pixels whose sample lies inside the clip rect
+            i32 lo = oc_max(px0, (i32)ceilf(oc_max(path->clip.x, -1) - ox));
+            i32 hi = oc_min(px1, (i32)ceilf(oc_min(path->clip.z, (f32)width + 1) - ox));
+
+            //NOTE: accumulate spans of covered samples in a difference array
+            i32 winding = 0;
+            for(u32 i = 0; i + 1 < crossingCount; i++)
+            {
+                winding += worker->crossings[i].winding;
+
+                bool inside = nonZero ? (winding != 0) : (winding & 1);
+                if(inside)
+                {
+                    i32 a = oc_max((i32)ceilf(worker->crossings[i].x - ox), lo);
+                    i32 b = oc_min((i32)ceilf(worker->crossings[i + 1].x - ox), hi);
+                    if(a < b)
+                    {
+                        counts[a]++;
+                        counts[b]--;
+                        covered = true;
+                    }
+                }
+            }
+        }
+
+        if(!covered)
+        {
+            continue;
+        }
+
+        f32* coverage = worker->coverage;
+        i32 count = 0;
+        for(i32 x = px0; x < px1; x++)
+        {
+            count += counts[x];
+            coverage[x - px0] = count * invSampleCount;
+        }
+
+        f32* dst = worker->accum + ((py - bandY0) * width + px0) * 4;
+        if(path->solid)
+        {
+            oc_cpu_raster_blend_solid(dst, coverage, px1 - px0, path->color);
+        }
+        else
+        {
+            oc_cpu_raster_blend_shaded(dst, coverage, px1 - px0, path, px0, py);
+        }
+    }
+}
+
+static inline f32 oc_cpu_raster_encode_srgb(oc_cpu_rasterizer* rasterizer, f32 c)
+{
+    c = oc_clamp(c, 0, 1);
+    return (rasterizer->srgbLUT[(u32)(c * (OC_CPU_RASTER_SRGB_LUT_SIZE - 1) + 0.5)]);
+}
+
+//NOTE: encode the band's premultiplied linear colors to sRGB, and composite them over the target (or the clear color),
+//      like the GPU renderers' final blit.
+static void oc_cpu_raster_resolve_band(oc_cpu_raster_worker* worker, i32 bandY0, i32 bandY1)
+{
+    oc_cpu_rasterizer* rasterizer = worker->rasterizer;
+    oc_cpu_raster_target* target = &rasterizer->target;
+    u32 width = target->width;
+
+    for(i32 y = bandY0; y < bandY1; y++)
+    {
+        f32* src = worker->accum + (y - bandY0) * width * 4;
+        u8* dst = target->pixels + y * target->pitch;
+
+        for(u32 x = 0; x < width; x++, src += 4, dst += 4)
+        {
+            const u8* back = rasterizer->clear ? rasterizer->clearBytes : dst;
+            if(src[3] <= 0)
+            {
+                //NOTE: nothing was drawn over this pixel
+                memmove(dst, back, 4);
+                continue;
+            }
+            f32 alpha = oc_clamp(src[3], 0, 1);
+
+#if OC_CPU_RASTER_SSE
+            __m128 e = _mm_set_ps(alpha,
+                                  oc_cpu_raster_encode_srgb(rasterizer, src[2]),
+                                  oc_cpu_raster_encode_srgb(rasterizer, src[1]),
+                                  oc_cpu_raster_encode_srgb(rasterizer, src[0]));
+            u32 backPixel;
+            memcpy(&backPixel, back, 4);
+            __m128i zero = _mm_setzero_si128();
+            __m128i bi = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(backPixel), zero), zero);
+            __m128 b = _mm_cvtepi32_ps(bi);
+            __m128 out = _mm_add_ps(_mm_mul_ps(e, _mm_set1_ps(255)),
+                                    _mm_mul_ps(b, _mm_set1_ps(1 - alpha)));
+            __m128i oi = _mm_cvtps_epi32(out);
+            oi = _mm_packus_epi16(_mm_packs_epi32(oi, oi), zero);
+            u32 outPixel = _mm_cvtsi128_si32(oi);
+            memcpy(dst, &outPixel, 4);
+#else
+            f32 e[4] = {
+                oc_cpu_raster_encode_srgb(rasterizer, src[0]),
+                oc_cpu_raster_encode_srgb(rasterizer, src[1]),
+                oc_cpu_raster_encode_srgb(rasterizer, src[2]),
+                alpha,
+            };
+            u8 out[4];
+            for(int c = 0; c < 4; c++)
+            {
+                out[c] = (u8)oc_clamp(e[c] * 255 + back[c] * (1 - alpha) + 0.5, 0, 255);
+            }
+            memcpy(dst, out, 4);
+#endif
+        }
+    }
+}
+
+static void oc_cpu_raster_band(oc_cpu_raster_worker* worker, u32 bandIndex)
+{
+    oc_cpu_rasterizer* rasterizer = worker->rasterizer;
+    u32 width = rasterizer->target.width;
+
+    i32 bandY0 = bandIndex * OC_CPU_RASTER_BAND_HEIGHT;
+    i32 bandY1 = oc_min(bandY0 + OC_CPU_RASTER_BAND_HEIGHT, (i32)rasterizer->target.height);
+
+    u32 entryStart = rasterizer->bandOffsets[bandIndex];
+    u32 entryEnd = rasterizer->bandOffsets[bandIndex + 1];
+
+    if(entryStart == entryEnd && !rasterizer->clear)
+    {
+        //NOTE: nothing to draw, leave the target untouched
+        return;
+    }
+
+    memset(worker->accum, 0, (bandY1 - bandY0) * width * 4 * sizeof(f32));
+
+    //NOTE: entries are sorted by path, in submission order
+    u32* entries = rasterizer->bandEntries;
+    u32 entryIndex = entryStart;
+    while(entryIndex < entryEnd)
+    {
+        u32 pathIndex = rasterizer->edges[entries[entryIndex]].pathIndex;
+        u32 pathEnd = entryIndex + 1;
+        while(pathEnd < entryEnd && rasterizer->edges[entries[pathEnd]].pathIndex == pathIndex)
+        {
+            pathEnd++;
+        }
+
+        oc_cpu_raster_band_path(worker,
+                                &rasterizer->paths[pathIndex],
+                                pathEnd - entryIndex,
+                                entries + entryIndex,
+                                bandY0,
+                                bandY1);
+        entryIndex = pathEnd;
+    }
+
+    oc_cpu_raster_resolve_band(worker, bandY0, bandY1);
+}
+
+static void oc_cpu_raster_run_bands(oc_cpu_raster_worker* worker)
+{
+    oc_cpu_rasterizer* rasterizer = worker->rasterizer;
+    u32 width = rasterizer->target.width;
+
+    worker->accum = oc_cpu_raster_grow(worker->accum, &worker->accumCap, width * OC_CPU_RASTER_BAND_HEIGHT * 4, sizeof(f32));
+
+    u32 rowCap = worker->rowCap;
+    worker->coverageCounts = oc_cpu_raster_grow(worker->coverageCounts, &rowCap, width + 1, sizeof(i32));
+    worker->coverage = oc_cpu_raster_grow(worker->coverage, &worker->rowCap, width + 1, sizeof(f32));
+
+    oc_trace_begin("cpu raster bands");
+    while(true)
+    {
+        u32 bandIndex = atomic_fetch_add(&rasterizer->nextBand, 1);
+        if(bandIndex >= rasterizer->bandCount)
+        {
+            break;
+        }
+        oc_cpu_raster_band(worker, bandIndex);
+    }
+    oc_trace_end();
+}
+
+static i32 oc_cpu_raster_worker_proc(void* user)
+{
+    oc_cpu_raster_worker* worker = (oc_cpu_raster_worker*)user;
+    oc_cpu_rasterizer* rasterizer = worker->rasterizer;
+    u64 generation = 0;
+
+    oc_mutex_lock(rasterizer->mutex);
+    while(true)
+    {
+        while(!rasterizer->quit && rasterizer->generation == generation)
+        {
+            oc_condition_wait(rasterizer->startCond, rasterizer->mutex);
+        }
+        if(rasterizer->quit)
+        {
+            break;
+        }
+        generation = rasterizer->generation;
+        oc_mutex_unlock(rasterizer->mutex);
+
+        oc_cpu_raster_run_bands(worker);
+
+        oc_mutex_lock(rasterizer->mutex);
+        rasterizer->busyCount--;
+        if(rasterizer->busyCount == 0)
+        {
+            oc_condition_signal(rasterizer->doneCond);
+        }
+    }
+    oc_mutex_unlock(rasterizer->mutex);
+    return (0);
+}
+
+//------------------------------------------------------------------------------------------
+// Rasterizer API
+//------------------------------------------------------------------------------------------
+
+oc_cpu_rasterizer* oc_cpu_rasterizer_create(u32 threadCount)
+{
+    oc_cpu_rasterizer* rasterizer = oc_malloc_type(oc_cpu_rasterizer);
+    memset(rasterizer, 0, sizeof(oc_cpu_rasterizer));
+
+    rasterizer->threadCount = oc_clamp(threadCount, 1, OC_CPU_RASTER_MAX_THREAD_COUNT);
+    rasterizer->mutex = oc_mutex_create();
+    rasterizer->startCond = oc_condition_create();
+    rasterizer->doneCond = oc_condition_create();
+
+    for(u32 i = 0; i < OC_CPU_RASTER_SRGB_LUT_SIZE; i++)
+    {
+        f32 c = (f32)i / (OC_CPU_RASTER_SRGB_LUT_SIZE - 1);
+        rasterizer->srgbLUT[i] = (c <= 0.0031308) ? c * 12.92 : 1.055 * powf(c, 1. / 2.4) - 0.055;
+    }
+
+    //NOTE: worker 0 is the thread calling oc_cpu_rasterizer_render()
+    for(u32 i = 0; i < rasterizer->threadCount; i++)
+    {
+        oc_cpu_raster_worker* worker = &rasterizer->workers[i];
+        worker->rasterizer = rasterizer;
+        if(i)
+        {
+            worker->thread = oc_thread_create_with_name(oc_cpu_raster_worker_proc, worker, OC_STR8("cpu raster"));
+        }
+    }
+    return (rasterizer);
+}
+
+void oc_cpu_rasterizer_destroy(oc_cpu_rasterizer* rasterizer)
+{
+    oc_mutex_lock(rasterizer->mutex);
+    rasterizer->quit = true;
+    oc_condition_broadcast(rasterizer->startCond);
+    oc_mutex_unlock(rasterizer->mutex);
+
+    for(u32 i = 0; i < rasterizer->threadCount; i++)
+    {
+        oc_cpu_raster_worker* worker = &rasterizer->workers[i];
+        if(worker->thread)
+        {
+            oc_thread_join(worker->thread, 0);
+        }
+        free(worker->accum);
+        free(worker->coverageCounts);
+        free(worker->coverage);
+        free(worker->crossings);
+        free(worker->rowEdges);
+    }
+
+    oc_condition_destroy(rasterizer->doneCond);
+    oc_condition_destroy(rasterizer->startCond);
+    oc_mutex_destroy(rasterizer->mutex);
+
+    free(rasterizer->paths);
+    free(rasterizer->edges);
+    free(rasterizer->flatPoints);
+    free(rasterizer->bandOffsets);
+    free(rasterizer->bandEntries);
+    free(rasterizer);
+}
+
+static void oc_cpu_raster_bin_edges(oc_cpu_rasterizer* rasterizer)
+{
+    u32 bandCount = rasterizer->bandCount;
+    rasterizer->bandOffsets = oc_cpu_raster_grow(rasterizer->bandOffsets, &rasterizer->bandCap, bandCount + 1, sizeof(u32));
+    u32* offsets = rasterizer->bandOffsets;
+    memset(offsets, 0, (bandCount + 1) * sizeof(u32));
+
+    f32 height = rasterizer->target.height;
+
+    //NOTE: count edges per band, then compute each band's offset and fill the entries. Since edges are in
+    //      path order, the entries of each band stay sorted by path.
+    for(u32 pass = 0; pass < 2; pass++)
+    {
+        for(u32 edgeIndex = 0; edgeIndex < rasterizer->edgeCount; edgeIndex++)
+        {
+            oc_cpu_raster_edge* edge = &rasterizer->edges[edgeIndex];
+            if(edge->y1 <= 0 || edge->y0 >= height)
+            {
+                continue;
+            }
+            i32 firstBand = oc_max((i32)(oc_max(edge->y0, 0) / OC_CPU_RASTER_BAND_HEIGHT), 0);
+            i32 lastBand = oc_min((i32)(oc_min(edge->y1, height) / OC_CPU_RASTER_BAND_HEIGHT), (i32)bandCount - 1);
+
+            for(i32 band = firstBand; band <= lastBand; band++)
+            {
+                if(pass == 0)
+                {
+                    offsets[band + 1]++;
+                }
+                else
+                {
+                    rasterizer->bandEntries[offsets[band]] = edgeIndex;
+                    offsets[band]++;
+                }
+            }
+        }
+
+        if(pass == 0)
+        {
+            for(u32 band = 0; band < bandCount; band++)
+            {
+                offsets[band + 1] += offsets[band];
+            }
+            rasterizer->bandEntries = oc_cpu_raster_grow(rasterizer->bandEntries, &rasterizer->entryCap, offsets[bandCount], sizeof(u32));
+        }
+        else
+        {
+            //NOTE: offsets now point to the end of each band, shift them back to the start
+            for(i32 band = bandCount; band > 0; band--)
+            {
+                offsets[band] = offsets[band - 1];
+            }
+            offsets[0] = 0;
+        }
+    }
+}
+
+void oc_cpu_rasterizer_render(oc_cpu_rasterizer* rasterizer,
+                              oc_cpu_raster_target* target,
+                              oc_cpu_raster_image_proc imageProc,
+                              void* imageUser,
+                              u32 sampleCount,
+                              bool clear,
+                              oc_color clearColor,
+                              u32 primitiveCount,
+                              oc_primitive* primitives,
+                              u32 attributeCount,
+                              oc_attributes* attributes,
+                              u32 eltCount,
+                              oc_path_elt* elements)
+{
+    if(!target->width || !target->height || !target->pixels)
+    {
+        return;
+    }
+    if(!clear && !primitiveCount)
+    {
+        return;
+    }
+
+    rasterizer->target = *target;
+    rasterizer->clear = clear;
+    for(int i = 0; i < 4; i++)
+    {
+        rasterizer->clearBytes[i] = (u8)(oc_clamp(clearColor.c[i], 0, 1) * 255 + 0.5);
+    }
+
+    u32 offsetsIndex = OC_CPU_RASTER_OFFSETS_LOOKUP[oc_clamp(sampleCount, 1, OC_CPU_RASTER_MAX_SAMPLE_COUNT) - 1];
+    rasterizer->sampleCount = OC_CPU_RASTER_SAMPLE_COUNTS[offsetsIndex];
+    rasterizer->sampleOffsets = OC_CPU_RASTER_OFFSETS[offsetsIndex];
+
+    //NOTE: build paths and edges
+    rasterizer->pathCount = 0;
+    rasterizer->edgeCount = 0;
+
+    oc_trace_begin("cpu raster build paths");
+    for(u32 primitiveIndex = 0; primitiveIndex < primitiveCount; primitiveIndex++)
+    {
+        oc_primitive* primitive = &primitives[primitiveIndex];
+        if(primitive->attributesIndex >= attributeCount)
+        {
+            continue;
+        }
+        if(primitive->cmd == OC_CMD_RECT_FILL
+           || ((primitive->cmd == OC_CMD_FILL || primitive->cmd == OC_CMD_STROKE) && primitive->path.count))
+        {
+            oc_cpu_raster_build_path(rasterizer,
+                                     primitive,
+                                     &attributes[primitive->attributesIndex],
+                                     elements,
+                                     eltCount,
+                                     imageProc,
+                                     imageUser);
+        }
+    }
+    oc_trace_end();
+
+    //NOTE: bin edges and rasterize bands in parallel
+    rasterizer->bandCount = (target->height + OC_CPU_RASTER_BAND_HEIGHT - 1) / OC_CPU_RASTER_BAND_HEIGHT;
+
+    oc_trace_zone("cpu raster bin edges")
+    {
+        oc_cpu_raster_bin_edges(rasterizer);
+    }
+
+    atomic_store(&rasterizer->nextBand, 0);
+
+    if(rasterizer->threadCount > 1)
+    {
+        oc_mutex_lock(rasterizer->mutex);
+        rasterizer->generation++;
+        rasterizer->busyCount = rasterizer->threadCount - 1;
+        oc_condition_broadcast(rasterizer->startCond);
+        oc_mutex_unlock(rasterizer->mutex);
+    }
+
+    oc_cpu_raster_run_bands(&rasterizer->workers[0]);
+
+    if(rasterizer->threadCount > 1)
+    {
+        oc_mutex_lock(rasterizer->mutex);
+        while(rasterizer->busyCount)
+        {
+            oc_condition_wait(rasterizer->doneCond, rasterizer->mutex);
+        }
+        oc_mutex_unlock(rasterizer->mutex);
+    }
+}
@@ -0,0 +1,62 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "graphics_common.h"
+
+//------------------------------------------------------------------------------------------
+// CPU rasterizer
+//------------------------------------------------------------------------------------------
+//NOTE: software implementation of the canvas rasterization pipeline. It consumes the same
+//      oc_primitive/oc_path_elt streams as the GPU canvas renderers, and follows the same
+//      coverage rules (sample patterns, even-odd fills, non-zero strokes) and compositing
+//      (premultiplied linear colors, encoded to sRGB when written to the target), so that it
+//      can be used both as a fallback renderer and as a reference for golden-image tests.
+//
+//      The target is split in horizontal bands that are rasterized independently by a pool of
+//      worker threads. Output doesn't depend on the number of threads.
+
+typedef struct oc_cpu_raster_image
+{
+    u32 width;
+    u32 height;
+    u8* pixels; // RGBA8, non-premultiplied
+
+} oc_cpu_raster_image;
+
+typedef oc_cpu_raster_image (*oc_cpu_raster_image_proc)(oc_image image, void* user);
+
+typedef struct oc_cpu_raster_target
+{
+    u32 width;
+    u32 height;
+    u32 pitch;  // in bytes
+    u8* pixels; // RGBA8
+    oc_vec2 scale;
+
+} oc_cpu_raster_target;
+
+typedef struct oc_cpu_rasterizer oc_cpu_rasterizer;
+
+//NOTE: a thread count of 0 selects one thread. The calling thread always participates in rasterization.
+oc_cpu_rasterizer* oc_cpu_rasterizer_create(u32 threadCount);
+void oc_cpu_rasterizer_destroy(oc_cpu_rasterizer* rasterizer);
+
+void oc_cpu_rasterizer_render(oc_cpu_rasterizer* rasterizer,
+                              oc_cpu_raster_target* target,
+                              oc_cpu_raster_image_proc imageProc,
+                              void* imageUser,
+                              u32 sampleCount,
+                              bool clear,
+                              oc_color clearColor,
+                              u32 primitiveCount,
+                              oc_primitive* primitives,
+                              u32 attributeCount,
+                              oc_attributes* attributes,
+                              u32 eltCount,
+                              oc_path_elt* elements);
@@ -193,6 +193,40 @@ ORCA_API f32 oc_font_get_scale_for_em_pixels(oc_font font, f32 emSize);
 ORCA_API oc_text_metrics oc_font_text_metrics_utf32(oc_font font, f32 fontSize, oc_str32 codepoints);
 ORCA_API oc_text_metrics oc_font_text_metrics(oc_font font, f32 fontSize, oc_str8 text);
 
+typedef struct oc_glyph_run_cache_stats
+{
+    u64 hits;
+    u64 misses;
+    u64 evictions;
+    u32 runCount;
+} oc_glyph_run_cache_stats;
+
+//NOTE: oc_font_text_metrics() and oc_text_outlines() cache the glyphs and metrics of the strings they process,
+//      keyed by font and text.
+ORCA_API oc_glyph_run_cache_stats oc_glyph_run_cache_get_stats(void);
+
+//NOTE: shaping positions the glyphs of a string, applying the font's pair kerning ('kern' table or GPOS pair
+//      adjustments). Glyph positions are relative to the start of the text's baseline, and are given in pixels
+//      for the requested font size. Shaped strings are cached along with the glyph runs above.
+typedef struct oc_shaped_glyph
+{
+    u32 glyphIndex;
+    oc_vec2 position;
+    oc_vec2 advance;
+} oc_shaped_glyph;
+
+typedef struct oc_shaped_text
+{
+    oc_font font;
+    f32 fontSize;
+    u64 glyphCount;
+    oc_shaped_glyph* glyphs;
+    oc_text_metrics metrics;
+} oc_shaped_text;
+
+ORCA_API oc_shaped_text oc_font_shape_text(oc_allocator* allocator, oc_font font, f32 fontSize, oc_str8 text);
+ORCA_API void oc_font_shape_text_batch(oc_allocator* allocator, oc_font font, f32 fontSize, u32 count, oc_str8* texts, oc_shaped_text* results);
+
 //------------------------------------------------------------------------------------------
 //SECTION: images
 //------------------------------------------------------------------------------------------
@@ -290,6 +324,7 @@ ORCA_API void oc_close_path(void);
 ORCA_API oc_rect oc_glyph_outlines(oc_str32 glyphIndices);
 ORCA_API void oc_codepoints_outlines(oc_str32 string);
 ORCA_API void oc_text_outlines(oc_str8 string);
+ORCA_API void oc_shaped_text_outlines(oc_shaped_text text);
 
 //------------------------------------------------------------------------------------------
 //SECTION: clear/fill/stroke
@@ -298,6 +333,26 @@ ORCA_API void oc_clear(void);
 ORCA_API void oc_fill(void);
 ORCA_API void oc_stroke(void);
 
+//------------------------------------------------------------------------------------------
+//SECTION: command recording
+//------------------------------------------------------------------------------------------
+//NOTE: a recording captures the commands issued on the current canvas context between oc_canvas_record_begin()
+//      and oc_canvas_record_end(), along with their resolved attributes (colors, clip, transform, etc).
+//      oc_canvas_replay() appends them again to the current context, without rebuilding their paths, and leaves
+//      the context attributes as they were at the end of the recording. A recording can be reused for
+//      as many recording/replay cycles as needed.
+typedef struct oc_canvas_recording oc_canvas_recording;
+
+ORCA_API oc_canvas_recording* oc_canvas_recording_create(void);
+ORCA_API void oc_canvas_recording_destroy(oc_canvas_recording* recording);
+
+ORCA_API void oc_canvas_record_begin(oc_canvas_recording* recording);
+ORCA_API void oc_canvas_record_end(oc_canvas_recording* recording);
+
+//NOTE: returns false, without emitting anything, if the recording can't be replayed (eg. it was cut by oc_clear()
+//      or started in the middle of a path that it then filled or stroked).
+ORCA_API bool oc_canvas_replay(oc_canvas_recording* recording);
+
 //------------------------------------------------------------------------------------------
 //SECTION: shapes helpers
 //------------------------------------------------------------------------------------------
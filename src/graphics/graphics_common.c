@@ -22,6 +22,15 @@
 #include "graphics_common.h"
 #include "platform/platform_debug.h"
 #include "util/algebra.h"
+#include "util/hash.h"
+
+#if OC_ARCH_X64
+    #include <emmintrin.h>
+    #define OC_GLYPH_MAP_SSE 1
+#elif OC_ARCH_ARM64
+    #include <arm_neon.h>
+    #define OC_GLYPH_MAP_NEON 1
+#endif
 
 typedef struct oc_glyph_map_entry
 {
@@ -30,10 +39,31 @@ typedef struct oc_glyph_map_entry
 
 } oc_glyph_map_entry;
 
+//NOTE: codepoints are mapped to glyph indices through a two-level page table. The page index has an entry for each
+//      block of OC_GLYPH_PAGE_SIZE codepoints, which selects a page of glyph indices. Page 0 is an empty page shared by
+//      all blocks that don't intersect the font's ranges.
+enum
+{
+    OC_GLYPH_PAGE_SHIFT = 8,
+    OC_GLYPH_PAGE_SIZE = 1 << OC_GLYPH_PAGE_SHIFT,
+    OC_GLYPH_MAX_CODEPOINT = 0x10ffff,
+    OC_GLYPH_PAGE_INDEX_COUNT = (OC_GLYPH_MAX_CODEPOINT >> OC_GLYPH_PAGE_SHIFT) + 1,
+};
+
+//NOTE: glyph data is loaded from the font file the first time a glyph is used, and stored in pages of
+//      OC_GLYPH_DATA_PAGE_SIZE glyphs that are allocated on demand.
+enum
+{
+    OC_GLYPH_DATA_PAGE_SHIFT = 8,
+    OC_GLYPH_DATA_PAGE_SIZE = 1 << OC_GLYPH_DATA_PAGE_SHIFT,
+};
+
 typedef struct oc_glyph_data
 {
+    bool loaded;
     bool exists;
     oc_utf32 codePoint;
+    int fontGlyphIndex;
     oc_path_descriptor pathDescriptor;
     oc_glyph_metrics metrics;
     //...
@@ -45,25 +75,79 @@ enum
     OC_MATRIX_STACK_MAX_DEPTH = 64,
     OC_CLIP_STACK_MAX_DEPTH = 64,
     OC_MAX_PATH_ELEMENT_COUNT = 2 << 20,
-    OC_MAX_PRIMITIVE_COUNT = 8 << 14
+    OC_MAX_PRIMITIVE_COUNT = 8 << 14,
+    OC_ATTRIBUTES_CACHE_SIZE = 256,
+    OC_ATTRIBUTES_DEFAULT_LEN = 256,
 };
 
 typedef struct oc_font_data
 {
     oc_list_links freeListElt;
 
+    char* fileData;
+    stbtt_fontinfo stbttInfo;
+    bool hasKerning;
+
     u32 rangeCount;
     u32 glyphCount;
     u32 outlineCount;
+    u32 outlineCapacity;
     oc_glyph_map_entry* glyphMap;
-    oc_glyph_data* glyphs;
+    u16* glyphPageIndex;
+    u32* glyphPages;
+    oc_glyph_data** glyphDataPages;
+    oc_arena glyphArena;
     oc_path_elt* outlines;
 
+    //NOTE: run of consecutive codepoints around the space character that map to consecutive glyph indices
+    //      (eg. basic latin), which can be converted by adding an offset.
+    oc_utf32 directFirstCodePoint;
+    u32 directCount;
+    u32 directGlyphOffset;
+
     f32 unitsPerEm;
     oc_font_metrics metrics;
+    oc_glyph_metrics missingGlyphMetrics;
 
 } oc_font_data;
 
+//NOTE: glyph runs cache the glyph indices and unscaled metrics of strings that are measured or drawn
+//      repeatedly, eg. UI labels. They are keyed by font and text, and shared by all font sizes.
+enum
+{
+    OC_GLYPH_RUN_CACHE_BUCKET_COUNT = 1024,
+    OC_GLYPH_RUN_CACHE_MAX_COUNT = 1024,
+    OC_GLYPH_RUN_MAX_LENGTH = 1024,
+};
+
+typedef struct oc_glyph_run
+{
+    oc_list_links bucketElt;
+    oc_list_links lruElt;
+
+    oc_font font;
+    u64 hash;
+    oc_str8 text;
+    oc_str32 glyphIndices;
+    oc_text_metrics metrics;
+
+    //NOTE: kerned layout, computed the first time the run is shaped
+    bool shaped;
+    oc_vec2* positions;
+    f32* advances;
+    oc_text_metrics shapedMetrics;
+
+} oc_glyph_run;
+
+typedef struct oc_glyph_run_cache
+{
+    oc_list buckets[OC_GLYPH_RUN_CACHE_BUCKET_COUNT];
+    oc_list lru;
+    u32 count;
+    oc_glyph_run_cache_stats stats;
+
+} oc_glyph_run_cache;
+
 typedef struct oc_canvas_context_data oc_canvas_context_data;
 
 typedef enum oc_graphics_handle_kind
@@ -104,6 +188,8 @@ typedef struct oc_graphics_data
     oc_list canvasFreeList;
     oc_list fontFreeList;
 
+    oc_glyph_run_cache glyphRunCache;
+
 } oc_graphics_data;
 
 typedef struct oc_canvas_context_data
@@ -127,6 +213,11 @@ typedef struct oc_canvas_context_data
     u32 primitiveCount;
     oc_primitive primitives[OC_MAX_PRIMITIVE_COUNT];
 
+    u32 attributeCount;
+    u32 attributeCap;
+    oc_attributes* attributeBlocks; // grown on demand, and kept when the context is recycled
+    u32 attributesCache[OC_ATTRIBUTES_CACHE_SIZE]; // attribute block index + 1, 0 if empty
+
     //NOTE: these are used at render time
     i32 msaaSampleCount;
 
@@ -188,7 +279,7 @@ void oc_graphics_handle_recycle(u64 h)
     u32 index = h >> 32;
     u32 generation = h & 0xffffffff;
 
-    if(index * sizeof(oc_graphics_handle_slot) < oc_graphicsData.handleNextIndex)
+    if(index < oc_graphicsData.handleNextIndex)
     {
         oc_graphics_handle_slot* slot = &oc_graphicsData.handleArray[index];
         if(slot->generation == generation)
@@ -344,15 +435,112 @@ void oc_clip_stack_pop(oc_canvas_context_data* context)
     }
 }
 
+void oc_reset_commands(oc_canvas_context_data* context)
+{
+    context->primitiveCount = 0;
+    context->attributeCount = 0;
+    memset(context->attributesCache, 0, sizeof(context->attributesCache));
+}
+
+static u64 oc_attributes_hash(oc_attributes* attributes)
+{
+    //NOTE: oc_attributes is 8-byte aligned, so we can hash it word by word
+    u64 words[sizeof(oc_attributes) / sizeof(u64)];
+    memcpy(words, attributes, sizeof(words));
+
+    u64 hash = 0xcbf29ce484222325;
+    for(int i = 0; i < oc_array_size(words); i++)
+    {
+        hash = (hash ^ words[i]) * 0x100000001b3;
+        hash ^= hash >> 29;
+    }
+    return (hash);
+}
+
+//NOTE: grows the attribute blocks to hold at least count blocks. Returns false, and leaves the blocks untouched,
+//      if they can't be grown.
+static bool oc_reserve_attributes(oc_canvas_context_data* context, u32 count)
+{
+    if(count > context->attributeCap)
+    {
+        u32 newCap = oc_max(OC_ATTRIBUTES_DEFAULT_LEN, context->attributeCap * 2);
+        newCap = oc_min(oc_max(newCap, count), OC_MAX_PRIMITIVE_COUNT);
+        if(count > newCap)
+        {
+            return (false);
+        }
+        oc_attributes* blocks = realloc(context->attributeBlocks, newCap * sizeof(oc_attributes));
+        if(!blocks)
+        {
+            return (false);
+        }
+        context->attributeBlocks = blocks;
+        context->attributeCap = newCap;
+    }
+    return (true);
+}
+
+//NOTE: returns false if a new block was needed but couldn't be allocated
+static bool oc_intern_attributes_block(oc_canvas_context_data* context, oc_attributes* attributes, u32* index)
+{
+    //NOTE: consecutive primitives very often share the same state, so check the last block first
+    if(context->attributeCount
+       && !memcmp(&context->attributeBlocks[context->attributeCount - 1], attributes, sizeof(oc_attributes)))
+    {
+        *index = context->attributeCount - 1;
+        return (true);
+    }
+
+    u64 hash = oc_attributes_hash(attributes);
+    u32 slot = hash % OC_ATTRIBUTES_CACHE_SIZE;
+    u32 cached = context->attributesCache[slot];
+
+    if(cached && !memcmp(&context->attributeBlocks[cached - 1], attributes, sizeof(oc_attributes)))
+    {
+        *index = cached - 1;
+        return (true);
+    }
+
+    OC_ASSERT(context->attributeCount < OC_MAX_PRIMITIVE_COUNT);
+
+    if(!oc_reserve_attributes(context, context->attributeCount + 1))
+    {
+        return (false);
+    }
+
+    *index = context->attributeCount;
+    memcpy(&context->attributeBlocks[*index], attributes, sizeof(oc_attributes));
+    context->attributeCount++;
+    context->attributesCache[slot] = *index + 1;
+
+    return (true);
+}
+
+bool oc_intern_attributes(oc_canvas_context_data* context, u32* index)
+{
+    //NOTE: the block is copied from the context's attributes as a whole, so that padding bytes are stable and
+    //      blocks can be compared bytewise.
+    oc_attributes attributes;
+    memcpy(&attributes, &context->attributes, sizeof(oc_attributes));
+    attributes.colors[0] = (oc_color){ 0 };
+    attributes.transform = oc_matrix_stack_top(context);
+    attributes.clip = oc_clip_stack_top(context);
+
+    return (oc_intern_attributes_block(context, &attributes, index));
+}
+
 void oc_push_command(oc_canvas_context_data* context, oc_primitive primitive)
 {
     //NOTE(martin): push primitive and updates current stream, eventually patching a pending jump.
     OC_ASSERT(context->primitiveCount < OC_MAX_PRIMITIVE_COUNT);
 
+    if(!oc_intern_attributes(context, &primitive.attributesIndex))
+    {
+        oc_log_error("couldn't allocate canvas attributes, dropping command\n");
+        return;
+    }
+    primitive.color = context->attributes.colors[0];
     context->primitives[context->primitiveCount] = primitive;
-    context->primitives[context->primitiveCount].attributes = context->attributes;
-    context->primitives[context->primitiveCount].attributes.transform = oc_matrix_stack_top(context);
-    context->primitives[context->primitiveCount].attributes.clip = oc_clip_stack_top(context);
     context->primitiveCount++;
 }
 
@@ -398,6 +586,308 @@ oc_font_data* oc_font_data_from_handle(oc_font handle)
     return (data);
 }
 
+//------------------------------------------------------------------------------------------
+//NOTE: glyph run cache
+//------------------------------------------------------------------------------------------
+
+oc_glyph_run* oc_glyph_run_cache_lookup(oc_font font, oc_str8 text, u64 hash)
+{
+    oc_glyph_run_cache* cache = &oc_graphicsData.glyphRunCache;
+    u64 index = hash & (OC_GLYPH_RUN_CACHE_BUCKET_COUNT - 1);
+
+    oc_list_for(cache->buckets[index], run, oc_glyph_run, bucketElt)
+    {
+        if(run->hash == hash && run->font.h == font.h && !oc_str8_cmp(run->text, text))
+        {
+            //NOTE: move run to the front of the LRU list
+            oc_list_remove(&cache->lru, &run->lruElt);
+            oc_list_push_front(&cache->lru, &run->lruElt);
+            cache->stats.hits++;
+            return (run);
+        }
+    }
+    cache->stats.misses++;
+    return (0);
+}
+
+void oc_glyph_run_cache_remove(oc_glyph_run* run)
+{
+    oc_glyph_run_cache* cache = &oc_graphicsData.glyphRunCache;
+    oc_list_remove(&cache->buckets[run->hash & (OC_GLYPH_RUN_CACHE_BUCKET_COUNT - 1)], &run->bucketElt);
+    oc_list_remove(&cache->lru, &run->lruElt);
+    cache->count--;
+    free(run->positions);
+    free(run);
+}
+
+oc_glyph_run* oc_glyph_run_cache_insert(oc_font font, oc_str8 text, u64 hash, u64 glyphCount)
+{
+    oc_glyph_run_cache* cache = &oc_graphicsData.glyphRunCache;
+
+    if(cache->count >= OC_GLYPH_RUN_CACHE_MAX_COUNT)
+    {
+        oc_glyph_run* last = oc_list_last_elt(cache->lru, oc_glyph_run, lruElt);
+        oc_glyph_run_cache_remove(last);
+        cache->stats.evictions++;
+    }
+
+    //NOTE: the run's glyph indices and text are stored right after it. Glyph indices are left for the caller to fill.
+    oc_glyph_run* run = malloc(sizeof(oc_glyph_run) + glyphCount * sizeof(u32) + text.len);
+    if(run)
+    {
+        memset(run, 0, sizeof(oc_glyph_run));
+        run->font = font;
+        run->hash = hash;
+        run->glyphIndices = (oc_str32){ .ptr = (u32*)(run + 1), .len = glyphCount };
+        run->text = (oc_str8){ .ptr = (char*)(run->glyphIndices.ptr + glyphCount), .len = text.len };
+        memcpy(run->text.ptr, text.ptr, text.len);
+
+        oc_list_push_back(&cache->buckets[hash & (OC_GLYPH_RUN_CACHE_BUCKET_COUNT - 1)], &run->bucketElt);
+        oc_list_push_front(&cache->lru, &run->lruElt);
+        cache->count++;
+    }
+    return (run);
+}
+
+void oc_glyph_run_cache_purge_font(oc_font font)
+{
+    oc_glyph_run_cache* cache = &oc_graphicsData.glyphRunCache;
+    oc_list_for_safe(cache->lru, run, oc_glyph_run, lruElt)
+    {
+        if(run->font.h == font.h)
+        {
+            oc_glyph_run_cache_remove(run);
+        }
+    }
+}
+
+oc_glyph_run_cache_stats oc_glyph_run_cache_get_stats(void)
+{
+    oc_glyph_run_cache_stats stats = oc_graphicsData.glyphRunCache.stats;
+    stats.runCount = oc_graphicsData.glyphRunCache.count;
+    return (stats);
+}
+
+static inline u32 oc_font_lookup_glyph_index(oc_font_data* font, oc_utf32 codePoint)
+{
+    if(codePoint > OC_GLYPH_MAX_CODEPOINT)
+    {
+        return (0);
+    }
+    u32 page = font->glyphPageIndex[codePoint >> OC_GLYPH_PAGE_SHIFT];
+    return (font->glyphPages[(page << OC_GLYPH_PAGE_SHIFT) + (codePoint & (OC_GLYPH_PAGE_SIZE - 1))]);
+}
+
+void oc_font_build_glyph_pages(oc_font_data* font)
+{
+    font->glyphPageIndex = oc_malloc_array(u16, OC_GLYPH_PAGE_INDEX_COUNT);
+    memset(font->glyphPageIndex, 0, OC_GLYPH_PAGE_INDEX_COUNT * sizeof(u16));
+
+    //NOTE: allocate a page for each block that intersects a range
+    u32 pageCount = 1;
+    for(int rangeIndex = 0; rangeIndex < font->rangeCount; rangeIndex++)
+    {
+        oc_unicode_range range = font->glyphMap[rangeIndex].range;
+        if(!range.count || range.firstCodePoint > OC_GLYPH_MAX_CODEPOINT)
+        {
+            continue;
+        }
+        u32 lastCodePoint = oc_min(range.firstCodePoint + range.count - 1, OC_GLYPH_MAX_CODEPOINT);
+
+        for(u32 block = range.firstCodePoint >> OC_GLYPH_PAGE_SHIFT; block <= (lastCodePoint >> OC_GLYPH_PAGE_SHIFT); block++)
+        {
+            if(!font->glyphPageIndex[block])
+            {
+                font->glyphPageIndex[block] = pageCount;
+                pageCount++;
+            }
+        }
+    }
+
+    font->glyphPages = oc_malloc_array(u32, pageCount * OC_GLYPH_PAGE_SIZE);
+    memset(font->glyphPages, 0, pageCount * OC_GLYPH_PAGE_SIZE * sizeof(u32));
+
+    //NOTE: fill the pages. Codepoints that are already set are left untouched, so that codepoints in overlapping
+    //      ranges map to the first range that contains them.
+    for(int rangeIndex = 0; rangeIndex < font->rangeCount; rangeIndex++)
+    {
+        oc_unicode_range range = font->glyphMap[rangeIndex].range;
+        u32 firstGlyphIndex = font->glyphMap[rangeIndex].firstGlyphIndex;
+
+        for(u32 offset = 0; offset < range.count; offset++)
+        {
+            oc_utf32 codePoint = range.firstCodePoint + offset;
+            if(codePoint > OC_GLYPH_MAX_CODEPOINT)
+            {
+                break;
+            }
+            u32 page = font->glyphPageIndex[codePoint >> OC_GLYPH_PAGE_SHIFT];
+            u32* slot = &font->glyphPages[(page << OC_GLYPH_PAGE_SHIFT) + (codePoint & (OC_GLYPH_PAGE_SIZE - 1))];
+            if(!*slot)
+            {
+                *slot = firstGlyphIndex + offset;
+            }
+        }
+    }
+
+    //NOTE: find the direct run around the space character
+    u32 spaceGlyphIndex = oc_font_lookup_glyph_index(font, ' ');
+    if(spaceGlyphIndex)
+    {
+        u32 offset = spaceGlyphIndex - ' ';
+        oc_utf32 first = ' ';
+        oc_utf32 end = ' ' + 1;
+
+        while(first > 0 && oc_font_lookup_glyph_index(font, first - 1) == first - 1 + offset)
+        {
+            first--;
+        }
+        while(end <= OC_GLYPH_MAX_CODEPOINT && oc_font_lookup_glyph_index(font, end) == end + offset)
+        {
+            end++;
+        }
+        font->directFirstCodePoint = first;
+        font->directCount = end - first;
+        font->directGlyphOffset = offset;
+    }
+}
+
+void oc_font_load_glyph(oc_font_data* font, u32 glyphIndex, oc_glyph_data* glyph)
+{
+    glyph->loaded = true;
+
+    //NOTE: find the glyph's codepoint
+    oc_utf32 codePoint = 0;
+    bool found = false;
+    for(int rangeIndex = 0; rangeIndex < font->rangeCount; rangeIndex++)
+    {
+        oc_glyph_map_entry* entry = &font->glyphMap[rangeIndex];
+        if(glyphIndex >= entry->firstGlyphIndex && glyphIndex < entry->firstGlyphIndex + entry->range.count)
+        {
+            codePoint = entry->range.firstCodePoint + (glyphIndex - entry->firstGlyphIndex);
+            found = true;
+            break;
+        }
+    }
+
+    int stbttGlyphIndex = found ? stbtt_FindGlyphIndex(&font->stbttInfo, codePoint) : 0;
+    if(stbttGlyphIndex == 0)
+    {
+        //NOTE(martin): the codepoint is not found in the font, we leave the glyph info zeroed
+        return;
+    }
+
+    glyph->exists = true;
+    glyph->codePoint = codePoint;
+    glyph->fontGlyphIndex = stbttGlyphIndex;
+
+    //NOTE(martin): load glyph metric
+    int xAdvance, xBearing, x0, y0, x1, y1;
+    stbtt_GetGlyphHMetrics(&font->stbttInfo, stbttGlyphIndex, &xAdvance, &xBearing);
+    if(stbtt_GetGlyphBox(&font->stbttInfo, stbttGlyphIndex, &x0, &y0, &x1, &y1))
+    {
+        //NOTE(martin): stb stbtt_GetGlyphBox returns bottom left and top right corners, with y up,
+        //              so we have to set .y = -y1
+        glyph->metrics.ink = (oc_rect){
+            .x = x0,
+            .y = -y1,
+            .w = x1 - x0,
+            .h = y1 - y0
+        };
+    }
+    else
+    {
+        // NOTE(reuben): stbtt_GetGlyphBox() can fail if it fails to find the glyph offset
+        memset(&glyph->metrics.ink, 0, sizeof(glyph->metrics.ink));
+    }
+
+    glyph->metrics.advance = (oc_vec2){ xAdvance, 0 };
+
+    //NOTE(martin): load glyph outlines
+
+    stbtt_vertex* vertices = 0;
+    int vertexCount = stbtt_GetGlyphShape(&font->stbttInfo, stbttGlyphIndex, &vertices);
+
+    if(font->outlineCount + vertexCount > font->outlineCapacity)
+    {
+        u32 capacity = oc_max(font->outlineCount + vertexCount, font->outlineCapacity * 3 / 2);
+        capacity = oc_max(capacity, 1024);
+        oc_path_elt* outlines = realloc(font->outlines, capacity * sizeof(oc_path_elt));
+        if(!outlines)
+        {
+            stbtt_FreeShape(&font->stbttInfo, vertices);
+            return;
+        }
+        font->outlines = outlines;
+        font->outlineCapacity = capacity;
+    }
+
+    glyph->pathDescriptor = (oc_path_descriptor){ .startIndex = font->outlineCount,
+                                                  .count = vertexCount,
+                                                  .startPoint = { 0, 0 } };
+
+    oc_path_elt* elements = font->outlines + font->outlineCount;
+    font->outlineCount += vertexCount;
+
+    for(int vertIndex = 0; vertIndex < vertexCount; vertIndex++)
+    {
+        f32 x = vertices[vertIndex].x;
+        f32 y = vertices[vertIndex].y;
+        f32 cx = vertices[vertIndex].cx;
+        f32 cy = vertices[vertIndex].cy;
+        f32 cx1 = vertices[vertIndex].cx1;
+        f32 cy1 = vertices[vertIndex].cy1;
+
+        switch(vertices[vertIndex].type)
+        {
+            case STBTT_vmove:
+                elements[vertIndex].type = OC_PATH_MOVE;
+                elements[vertIndex].p[0] = (oc_vec2){ x, y };
+                break;
+
+            case STBTT_vline:
+                elements[vertIndex].type = OC_PATH_LINE;
+                elements[vertIndex].p[0] = (oc_vec2){ x, y };
+                break;
+
+            case STBTT_vcurve:
+            {
+                elements[vertIndex].type = OC_PATH_QUADRATIC;
+                elements[vertIndex].p[0] = (oc_vec2){ cx, cy };
+                elements[vertIndex].p[1] = (oc_vec2){ x, y };
+            }
+            break;
+
+            case STBTT_vcubic:
+                elements[vertIndex].type = OC_PATH_CUBIC;
+                elements[vertIndex].p[0] = (oc_vec2){ cx, cy };
+                elements[vertIndex].p[1] = (oc_vec2){ cx1, cy1 };
+                elements[vertIndex].p[2] = (oc_vec2){ x, y };
+                break;
+        }
+    }
+    stbtt_FreeShape(&font->stbttInfo, vertices);
+}
+
+oc_glyph_data* oc_font_get_glyph_data(oc_font_data* fontData, u32 glyphIndex)
+{
+    OC_DEBUG_ASSERT(glyphIndex);
+    OC_DEBUG_ASSERT(glyphIndex < fontData->glyphCount);
+
+    u32 slot = glyphIndex - 1;
+    oc_glyph_data** page = &fontData->glyphDataPages[slot >> OC_GLYPH_DATA_PAGE_SHIFT];
+    if(!*page)
+    {
+        *page = oc_arena_push_array(&fontData->glyphArena, oc_glyph_data, OC_GLYPH_DATA_PAGE_SIZE);
+    }
+    oc_glyph_data* glyph = &(*page)[slot & (OC_GLYPH_DATA_PAGE_SIZE - 1)];
+    if(!glyph->loaded)
+    {
+        oc_font_load_glyph(fontData, glyphIndex, glyph);
+    }
+    return (glyph);
+}
+
 oc_font oc_font_create_from_memory(oc_str8 mem, u32 rangeCount, oc_unicode_range* ranges)
 {
     if(!oc_graphicsData.init)
@@ -416,25 +906,30 @@ oc_font oc_font_create_from_memory(oc_str8 mem, u32 rangeCount, oc_unicode_range
         memset(font, 0, sizeof(oc_font_data));
         fontHandle = oc_font_handle_alloc(font);
 
-        stbtt_fontinfo stbttFontInfo;
-        stbtt_InitFont(&stbttFontInfo, (byte*)mem.ptr, 0);
+        //NOTE: keep a copy of the font file to load glyphs on demand
+        font->fileData = oc_malloc_array(char, mem.len);
+        memcpy(font->fileData, mem.ptr, mem.len);
+
+        stbtt_fontinfo* stbttFontInfo = &font->stbttInfo;
+        stbtt_InitFont(stbttFontInfo, (byte*)font->fileData, 0);
+        font->hasKerning = (stbttFontInfo->kern || stbttFontInfo->gpos);
 
         //NOTE(martin): load font metrics data
-        font->unitsPerEm = 1. / stbtt_ScaleForMappingEmToPixels(&stbttFontInfo, 1);
+        font->unitsPerEm = 1. / stbtt_ScaleForMappingEmToPixels(stbttFontInfo, 1);
 
         int ascent, descent, lineGap, x0, x1, y0, y1;
-        stbtt_GetFontVMetrics(&stbttFontInfo, &ascent, &descent, &lineGap);
-        stbtt_GetFontBoundingBox(&stbttFontInfo, &x0, &y0, &x1, &y1);
+        stbtt_GetFontVMetrics(stbttFontInfo, &ascent, &descent, &lineGap);
+        stbtt_GetFontBoundingBox(stbttFontInfo, &x0, &y0, &x1, &y1);
 
         font->metrics.ascent = ascent;
         font->metrics.descent = -descent;
         font->metrics.lineGap = lineGap;
         font->metrics.width = x1 - x0;
 
-        stbtt_GetCodepointBox(&stbttFontInfo, 'x', &x0, &y0, &x1, &y1);
+        stbtt_GetCodepointBox(stbttFontInfo, 'x', &x0, &y0, &x1, &y1);
         font->metrics.xHeight = y1 - y0;
 
-        stbtt_GetCodepointBox(&stbttFontInfo, 'M', &x0, &y0, &x1, &y1);
+        stbtt_GetCodepointBox(stbttFontInfo, 'M', &x0, &y0, &x1, &y1);
         font->metrics.capHeight = y1 - y0;
 
         //NOTE(martin): load codepoint ranges
@@ -451,137 +946,48 @@ oc_font oc_font_create_from_memory(oc_str8 mem, u32 rangeCount, oc_unicode_range
             font->glyphCount += ranges[i].count;
         }
 
-        font->glyphs = oc_malloc_array(oc_glyph_data, font->glyphCount);
+        oc_font_build_glyph_pages(font);
 
-        //NOTE(martin): first do a count of outlines
-        int outlineCount = 0;
-        for(int rangeIndex = 0; rangeIndex < rangeCount; rangeIndex++)
-        {
-            oc_utf32 codePoint = font->glyphMap[rangeIndex].range.firstCodePoint;
-            u32 firstGlyphIndex = font->glyphMap[rangeIndex].firstGlyphIndex;
-            u32 endGlyphIndex = firstGlyphIndex + font->glyphMap[rangeIndex].range.count;
+        u32 glyphDataPageCount = (font->glyphCount + OC_GLYPH_DATA_PAGE_SIZE - 1) >> OC_GLYPH_DATA_PAGE_SHIFT;
+        font->glyphDataPages = oc_malloc_array(oc_glyph_data*, glyphDataPageCount);
+        memset(font->glyphDataPages, 0, glyphDataPageCount * sizeof(oc_glyph_data*));
+        oc_arena_init(&font->glyphArena);
 
-            for(int glyphIndex = firstGlyphIndex;
-                glyphIndex < endGlyphIndex; glyphIndex++)
-            {
-                int stbttGlyphIndex = stbtt_FindGlyphIndex(&stbttFontInfo, codePoint);
-                if(stbttGlyphIndex == 0)
-                {
-                    //NOTE(martin): the codepoint is not found in the font
-                    codePoint++;
-                    continue;
-                }
-                //NOTE(martin): load glyph outlines
-                stbtt_vertex* vertices = 0;
-                outlineCount += stbtt_GetGlyphShape(&stbttFontInfo, stbttGlyphIndex, &vertices);
-                stbtt_FreeShape(&stbttFontInfo, vertices);
-                codePoint++;
-            }
-        }
-        //NOTE(martin): allocate outlines
-        font->outlines = oc_malloc_array(oc_path_elt, outlineCount);
-        font->outlineCount = 0;
+        //NOTE(martin): find metrics of missing characters. If there's no replacement glyph, try to get an 'X' to get
+        //              a somewhat correct dimensions to render an empty rectangle. Otherwise just use the max font width
+        oc_glyph_data* replacementGlyph = 0;
+        oc_glyph_data* xGlyph = 0;
 
-        //NOTE(martin): load metrics and outlines
-        for(int rangeIndex = 0; rangeIndex < rangeCount; rangeIndex++)
+        u32 glyphIndex = oc_font_lookup_glyph_index(font, 0xfffd);
+        if(glyphIndex && glyphIndex < font->glyphCount)
         {
-            oc_utf32 codePoint = font->glyphMap[rangeIndex].range.firstCodePoint;
-            u32 firstGlyphIndex = font->glyphMap[rangeIndex].firstGlyphIndex;
-            u32 endGlyphIndex = firstGlyphIndex + font->glyphMap[rangeIndex].range.count;
-
-            for(int glyphIndex = firstGlyphIndex;
-                glyphIndex < endGlyphIndex; glyphIndex++)
-            {
-                oc_glyph_data* glyph = &(font->glyphs[glyphIndex - 1]);
-
-                int stbttGlyphIndex = stbtt_FindGlyphIndex(&stbttFontInfo, codePoint);
-                if(stbttGlyphIndex == 0)
-                {
-                    //NOTE(martin): the codepoint is not found in the font, we zero the glyph info
-                    memset(glyph, 0, sizeof(*glyph));
-                    codePoint++;
-                    continue;
-                }
-
-                glyph->exists = true;
-                glyph->codePoint = codePoint;
-
-                //NOTE(martin): load glyph metric
-                int xAdvance, xBearing, x0, y0, x1, y1;
-                stbtt_GetGlyphHMetrics(&stbttFontInfo, stbttGlyphIndex, &xAdvance, &xBearing);
-                if(stbtt_GetGlyphBox(&stbttFontInfo, stbttGlyphIndex, &x0, &y0, &x1, &y1))
-                {
-                    //NOTE(martin): stb stbtt_GetGlyphBox returns bottom left and top right corners, with y up,
-                    //              so we have to set .y = -y1
-                    glyph->metrics.ink = (oc_rect){
-                        .x = x0,
-                        .y = -y1,
-                        .w = x1 - x0,
-                        .h = y1 - y0
-                    };
-                }
-                else
-                {
-                    // NOTE(reuben): stbtt_GetGlyphBox() can fail if it fails to find the glyph offset
-                    memset(&glyph->metrics.ink, 0, sizeof(glyph->metrics.ink));
-                }
-
-                glyph->metrics.advance = (oc_vec2){ xAdvance, 0 };
-
-                //NOTE(martin): load glyph outlines
-
-                stbtt_vertex* vertices = 0;
-                int vertexCount = stbtt_GetGlyphShape(&stbttFontInfo, stbttGlyphIndex, &vertices);
-
-                glyph->pathDescriptor = (oc_path_descriptor){ .startIndex = font->outlineCount,
-                                                              .count = vertexCount,
-                                                              .startPoint = { 0, 0 } };
-
-                oc_path_elt* elements = font->outlines + font->outlineCount;
-                font->outlineCount += vertexCount;
-                oc_vec2 currentPos = { 0, 0 };
-
-                for(int vertIndex = 0; vertIndex < vertexCount; vertIndex++)
-                {
-                    f32 x = vertices[vertIndex].x;
-                    f32 y = vertices[vertIndex].y;
-                    f32 cx = vertices[vertIndex].cx;
-                    f32 cy = vertices[vertIndex].cy;
-                    f32 cx1 = vertices[vertIndex].cx1;
-                    f32 cy1 = vertices[vertIndex].cy1;
-
-                    switch(vertices[vertIndex].type)
-                    {
-                        case STBTT_vmove:
-                            elements[vertIndex].type = OC_PATH_MOVE;
-                            elements[vertIndex].p[0] = (oc_vec2){ x, y };
-                            break;
-
-                        case STBTT_vline:
-                            elements[vertIndex].type = OC_PATH_LINE;
-                            elements[vertIndex].p[0] = (oc_vec2){ x, y };
-                            break;
+            replacementGlyph = oc_font_get_glyph_data(font, glyphIndex);
+        }
+        glyphIndex = oc_font_lookup_glyph_index(font, 'X');
+        if(glyphIndex && glyphIndex < font->glyphCount)
+        {
+            xGlyph = oc_font_get_glyph_data(font, glyphIndex);
+        }
 
-                        case STBTT_vcurve:
-                        {
-                            elements[vertIndex].type = OC_PATH_QUADRATIC;
-                            elements[vertIndex].p[0] = (oc_vec2){ cx, cy };
-                            elements[vertIndex].p[1] = (oc_vec2){ x, y };
-                        }
-                        break;
-
-                        case STBTT_vcubic:
-                            elements[vertIndex].type = OC_PATH_CUBIC;
-                            elements[vertIndex].p[0] = (oc_vec2){ cx, cy };
-                            elements[vertIndex].p[1] = (oc_vec2){ cx1, cy1 };
-                            elements[vertIndex].p[2] = (oc_vec2){ x, y };
-                            break;
-                    }
-                    currentPos = (oc_vec2){ x, y };
-                }
-                stbtt_FreeShape(&stbttFontInfo, vertices);
-                codePoint++;
-            }
+        if(replacementGlyph && replacementGlyph->exists)
+        {
+            font->missingGlyphMetrics = replacementGlyph->metrics;
+        }
+        else if(xGlyph && xGlyph->exists)
+        {
+            font->missingGlyphMetrics = xGlyph->metrics;
+        }
+        else
+        {
+            font->missingGlyphMetrics = (oc_glyph_metrics){
+                .ink = {
+                    .x = font->metrics.width * 0.1,
+                    .y = -font->metrics.ascent,
+                    .w = font->metrics.width * 0.8,
+                    .h = font->metrics.ascent,
+                },
+                .advance = { .x = font->metrics.width, .y = 0 },
+            };
         }
     }
     return (fontHandle);
@@ -632,9 +1038,15 @@ void oc_font_destroy(oc_font fontHandle)
     oc_font_data* fontData = oc_font_data_from_handle(fontHandle);
     if(fontData)
     {
+        oc_glyph_run_cache_purge_font(fontHandle);
+
+        free(fontData->fileData);
         free(fontData->glyphMap);
-        free(fontData->glyphs);
+        free(fontData->glyphPageIndex);
+        free(fontData->glyphPages);
+        free(fontData->glyphDataPages);
         free(fontData->outlines);
+        oc_arena_cleanup(&fontData->glyphArena);
 
         oc_list_push_front(&oc_graphicsData.fontFreeList, &fontData->freeListElt);
         oc_graphics_handle_recycle(fontHandle.h);
@@ -644,37 +1056,73 @@ void oc_font_destroy(oc_font fontHandle)
 oc_str32 oc_font_get_glyph_indices_from_font_data(oc_font_data* fontData, oc_str32 codePoints, oc_str32 backing)
 {
     u64 count = oc_min(codePoints.len, backing.len);
+    u64 i = 0;
 
-    for(int i = 0; i < count; i++)
+    //NOTE: convert groups of 4 codepoints that are all in the direct run by adding the run's offset,
+    //      and fall back to the page table otherwise. Note that codePoints and backing can alias.
+    if(fontData->directCount)
     {
-        u32 glyphIndex = 0;
-        for(int rangeIndex = 0; rangeIndex < fontData->rangeCount; rangeIndex++)
+#if OC_GLYPH_MAP_SSE
+        __m128i first = _mm_set1_epi32(fontData->directFirstCodePoint);
+        __m128i bias = _mm_set1_epi32(0x80000000);
+        __m128i limit = _mm_set1_epi32(fontData->directCount ^ 0x80000000);
+        __m128i offset = _mm_set1_epi32(fontData->directGlyphOffset);
+
+        for(; i + 4 <= count; i += 4)
         {
-            if(codePoints.ptr[i] >= fontData->glyphMap[rangeIndex].range.firstCodePoint
-               && codePoints.ptr[i] < (fontData->glyphMap[rangeIndex].range.firstCodePoint + fontData->glyphMap[rangeIndex].range.count))
+            __m128i c = _mm_loadu_si128((__m128i*)(codePoints.ptr + i));
+            //NOTE: unsigned (c - first) < directCount, using a signed compare on biased values
+            __m128i inRun = _mm_cmplt_epi32(_mm_xor_si128(_mm_sub_epi32(c, first), bias), limit);
+
+            if(_mm_movemask_epi8(inRun) == 0xffff)
             {
-                u32 rangeOffset = codePoints.ptr[i] - fontData->glyphMap[rangeIndex].range.firstCodePoint;
-                glyphIndex = fontData->glyphMap[rangeIndex].firstGlyphIndex + rangeOffset;
-                break;
+                _mm_storeu_si128((__m128i*)(backing.ptr + i), _mm_add_epi32(c, offset));
+            }
+            else
+            {
+                for(int j = 0; j < 4; j++)
+                {
+                    backing.ptr[i + j] = oc_font_lookup_glyph_index(fontData, codePoints.ptr[i + j]);
+                }
             }
         }
-        if(glyphIndex && !fontData->glyphs[glyphIndex].exists)
+#elif OC_GLYPH_MAP_NEON
+        uint32x4_t first = vdupq_n_u32(fontData->directFirstCodePoint);
+        uint32x4_t limit = vdupq_n_u32(fontData->directCount);
+        uint32x4_t offset = vdupq_n_u32(fontData->directGlyphOffset);
+
+        for(; i + 4 <= count; i += 4)
         {
-            backing.ptr[i] = 0;
+            uint32x4_t c = vld1q_u32(codePoints.ptr + i);
+            uint32x4_t inRun = vcltq_u32(vsubq_u32(c, first), limit);
+
+            if(vminvq_u32(inRun) == 0xffffffff)
+            {
+                vst1q_u32(backing.ptr + i, vaddq_u32(c, offset));
+            }
+            else
+            {
+                for(int j = 0; j < 4; j++)
+                {
+                    backing.ptr[i + j] = oc_font_lookup_glyph_index(fontData, codePoints.ptr[i + j]);
+                }
+            }
         }
-        backing.ptr[i] = glyphIndex;
+#endif
+    }
+
+    for(; i < count; i++)
+    {
+        backing.ptr[i] = oc_font_lookup_glyph_index(fontData, codePoints.ptr[i]);
     }
+
     oc_str32 res = { .ptr = backing.ptr, .len = count };
     return (res);
 }
 
 u32 oc_font_get_glyph_index_from_font_data(oc_font_data* fontData, oc_utf32 codePoint)
 {
-    u32 glyphIndex = 0;
-    oc_str32 codePoints = { .ptr = &codePoint, .len = 1 };
-    oc_str32 backing = { .ptr = &glyphIndex, 1 };
-    oc_font_get_glyph_indices_from_font_data(fontData, codePoints, backing);
-    return (glyphIndex);
+    return (oc_font_lookup_glyph_index(fontData, codePoint));
 }
 
 oc_str32 oc_font_get_glyph_indices(oc_font font, oc_str32 codePoints, oc_str32 backing)
@@ -703,13 +1151,6 @@ u32 oc_font_get_glyph_index(oc_font font, oc_utf32 codePoint)
     return (glyphIndex);
 }
 
-oc_glyph_data* oc_font_get_glyph_data(oc_font_data* fontData, u32 glyphIndex)
-{
-    OC_DEBUG_ASSERT(glyphIndex);
-    OC_DEBUG_ASSERT(glyphIndex < fontData->glyphCount);
-    return (&(fontData->glyphs[glyphIndex - 1]));
-}
-
 oc_font_metrics oc_font_get_metrics_unscaled(oc_font font)
 {
     oc_font_data* fontData = oc_font_data_from_handle(font);
@@ -796,54 +1237,29 @@ int oc_font_get_codepoint_metrics(oc_font font, oc_utf32 codePoint, oc_text_metr
 
 /////////////////////////////////////////////////
 
-oc_text_metrics oc_font_text_metrics_utf32(oc_font font, f32 fontSize, oc_str32 codePoints)
+f32 oc_font_get_kerning(oc_font_data* fontData, oc_glyph_data* glyph, u32 nextGlyphIndex)
 {
-    if(!codePoints.len || !codePoints.ptr)
+    if(!glyph->exists || glyph->codePoint == '\n' || !nextGlyphIndex || nextGlyphIndex >= fontData->glyphCount)
     {
-        return ((oc_text_metrics){ 0 });
-    }
-
-    oc_font_data* fontData = oc_font_data_from_handle(font);
-    if(!fontData)
-    {
-        return ((oc_text_metrics){ 0 });
+        return (0);
     }
-
-    oc_scratch scratch = oc_scratch_begin();
-    oc_str32 glyphIndices = oc_font_push_glyph_indices(scratch.allocator, font, codePoints);
-
-    //NOTE(martin): find width of missing character
-    //TODO(martin): should cache that at font creation...
-    oc_glyph_metrics missingGlyphMetrics = { 0 };
-    u32 missingGlyphIndex = oc_font_get_glyph_index_from_font_data(fontData, 0xfffd);
-
-    if(missingGlyphIndex)
+    oc_glyph_data* next = oc_font_get_glyph_data(fontData, nextGlyphIndex);
+    if(!next->exists)
     {
-        oc_font_get_glyph_metrics_from_font_data(fontData, (oc_str32){ .ptr = &missingGlyphIndex, .len = 1 }, &missingGlyphMetrics);
+        return (0);
     }
-    else
-    {
-        //NOTE(martin): could not find replacement glyph, try to get an 'X' to get a somewhat correct dimensions
-        //              to render an empty rectangle. Otherwise just render with the max font width
+    return (stbtt_GetGlyphKernAdvance(&fontData->stbttInfo, glyph->fontGlyphIndex, next->fontGlyphIndex));
+}
 
-        missingGlyphIndex = oc_font_get_glyph_index_from_font_data(fontData, 'X');
-        if(missingGlyphIndex)
-        {
-            oc_font_get_glyph_metrics_from_font_data(fontData, (oc_str32){ .ptr = &missingGlyphIndex, .len = 1 }, &missingGlyphMetrics);
-        }
-        else
-        {
-            missingGlyphMetrics = (oc_glyph_metrics){
-                .ink = {
-                    .x = fontData->metrics.width * 0.1,
-                    .y = -fontData->metrics.ascent,
-                    .w = fontData->metrics.width * 0.8,
-                    .h = fontData->metrics.ascent,
-                },
-                .advance = { .x = fontData->metrics.width, .y = 0 },
-            };
-        }
-    }
+//NOTE: if kern is true, the advance of each glyph is adjusted by its kerning with the next glyph.
+//      outPositions and outAdvances, if not null, receive the pen position and x advance of each glyph.
+oc_text_metrics oc_font_text_metrics_unscaled(oc_font_data* fontData,
+                                              oc_str32 glyphIndices,
+                                              bool kern,
+                                              oc_vec2* outPositions,
+                                              f32* outAdvances)
+{
+    kern = kern && fontData->hasKerning;
 
     //NOTE(martin): accumulate text extents
     oc_text_metrics metrics = { 0 };
@@ -865,7 +1281,7 @@ oc_text_metrics oc_font_text_metrics_utf32(oc_font font, f32 fontSize, oc_str32
         oc_glyph_metrics glyphMetrics;
         if(!glyphIndices.ptr[i] || glyphIndices.ptr[i] >= fontData->glyphCount)
         {
-            glyphMetrics = missingGlyphMetrics;
+            glyphMetrics = fontData->missingGlyphMetrics;
         }
         else
         {
@@ -873,13 +1289,27 @@ oc_text_metrics oc_font_text_metrics_utf32(oc_font font, f32 fontSize, oc_str32
             glyphMetrics = glyph->metrics;
         }
 
+        f32 advanceX = glyphMetrics.advance.x;
+        if(kern && glyph && i + 1 < glyphIndices.len)
+        {
+            advanceX += oc_font_get_kerning(fontData, glyph, glyphIndices.ptr[i + 1]);
+        }
+        if(outPositions)
+        {
+            outPositions[i] = metrics.advance;
+        }
+        if(outAdvances)
+        {
+            outAdvances[i] = advanceX;
+        }
+
         inkX0 = oc_min(inkX0, metrics.advance.x + glyphMetrics.ink.x);
         inkX1 = oc_max(inkX1, metrics.advance.x + glyphMetrics.ink.x + glyphMetrics.ink.w);
 
         inkY0 = oc_min(inkY0, metrics.advance.y + glyphMetrics.ink.y);
         inkY1 = oc_max(inkY1, metrics.advance.y + glyphMetrics.ink.y + glyphMetrics.ink.h);
 
-        metrics.advance.x += glyphMetrics.advance.x;
+        metrics.advance.x += advanceX;
         metrics.advance.y += glyphMetrics.advance.y;
 
         metrics.logical.w = oc_max(metrics.logical.w, metrics.advance.x);
@@ -895,44 +1325,214 @@ oc_text_metrics oc_font_text_metrics_utf32(oc_font font, f32 fontSize, oc_str32
             }
         }
     }
-    metrics.ink = (oc_rect){
-        inkX0,
-        inkY0,
-        inkX1 - inkX0,
-        inkY1 - inkY0
-    };
+    metrics.ink = (oc_rect){
+        inkX0,
+        inkY0,
+        inkX1 - inkX0,
+        inkY1 - inkY0
+    };
+
+    OC_ASSERT(metrics.ink.y <= 0);
+
+    return (metrics);
+}
+
+oc_text_metrics oc_font_text_metrics_scale(oc_text_metrics metrics, f32 fontScale)
+{
+    metrics.ink.x *= fontScale;
+    metrics.ink.y *= fontScale;
+    metrics.ink.w *= fontScale;
+    metrics.ink.h *= fontScale;
+    metrics.logical.x *= fontScale;
+    metrics.logical.y *= fontScale;
+    metrics.logical.w *= fontScale;
+    metrics.logical.h *= fontScale;
+    metrics.advance.x *= fontScale;
+    metrics.advance.y *= fontScale;
+
+    return (metrics);
+}
+
+oc_glyph_run* oc_font_get_glyph_run(oc_font font, oc_font_data* fontData, oc_str8 text)
+{
+    if(text.len > OC_GLYPH_RUN_MAX_LENGTH)
+    {
+        return (0);
+    }
+
+    u64 hash = oc_hash_xxh3_string_seed(text, font.h);
+    oc_glyph_run* run = oc_glyph_run_cache_lookup(font, text, hash);
+    if(!run)
+    {
+        u64 codePointCount = oc_utf8_codepoint_count_for_string(text);
+        run = oc_glyph_run_cache_insert(font, text, hash, codePointCount);
+        if(run)
+        {
+            run->glyphIndices = oc_utf8_to_codepoints(codePointCount, run->glyphIndices.ptr, text);
+            oc_font_get_glyph_indices_from_font_data(fontData, run->glyphIndices, run->glyphIndices);
+            run->metrics = oc_font_text_metrics_unscaled(fontData, run->glyphIndices, false, 0, 0);
+        }
+    }
+    return (run);
+}
+
+oc_text_metrics oc_font_text_metrics_utf32(oc_font font, f32 fontSize, oc_str32 codePoints)
+{
+    if(!codePoints.len || !codePoints.ptr)
+    {
+        return ((oc_text_metrics){ 0 });
+    }
+
+    oc_font_data* fontData = oc_font_data_from_handle(font);
+    if(!fontData)
+    {
+        return ((oc_text_metrics){ 0 });
+    }
+
+    oc_scratch scratch = oc_scratch_begin();
+    oc_str32 glyphIndices = oc_font_push_glyph_indices(scratch.allocator, font, codePoints);
+
+    oc_text_metrics metrics = oc_font_text_metrics_unscaled(fontData, glyphIndices, false, 0, 0);
+    metrics = oc_font_text_metrics_scale(metrics, fontSize / fontData->unitsPerEm);
+
+    oc_scratch_end(scratch);
+    return (metrics);
+}
+
+oc_text_metrics oc_font_text_metrics(oc_font font, f32 fontSize, oc_str8 text)
+{
+    if(!text.len || !text.ptr)
+    {
+        return ((oc_text_metrics){ 0 });
+    }
+
+    oc_font_data* fontData = oc_font_data_from_handle(font);
+    if(!fontData)
+    {
+        return ((oc_text_metrics){ 0 });
+    }
+
+    oc_text_metrics result = { 0 };
+    oc_glyph_run* run = oc_font_get_glyph_run(font, fontData, text);
+    if(run)
+    {
+        result = oc_font_text_metrics_scale(run->metrics, fontSize / fontData->unitsPerEm);
+    }
+    else
+    {
+        oc_scratch scratch = oc_scratch_begin();
+        oc_str32 codePoints = oc_utf8_push_to_codepoints(scratch.allocator, text);
+        result = oc_font_text_metrics_utf32(font, fontSize, codePoints);
+        oc_scratch_end(scratch);
+    }
+    return (result);
+}
+
+oc_glyph_run* oc_font_get_shaped_glyph_run(oc_font font, oc_font_data* fontData, oc_str8 text)
+{
+    oc_glyph_run* run = oc_font_get_glyph_run(font, fontData, text);
+    if(run && !run->shaped)
+    {
+        u64 count = run->glyphIndices.len;
+        run->positions = malloc(count * (sizeof(oc_vec2) + sizeof(f32)));
+        if(!run->positions)
+        {
+            return (0);
+        }
+        run->advances = (f32*)(run->positions + count);
+        run->shapedMetrics = oc_font_text_metrics_unscaled(fontData, run->glyphIndices, true, run->positions, run->advances);
+        run->shaped = true;
+    }
+    return (run);
+}
+
+oc_shaped_text oc_shaped_text_push(oc_allocator* allocator,
+                                   oc_font font,
+                                   oc_font_data* fontData,
+                                   f32 fontSize,
+                                   oc_str32 glyphIndices,
+                                   oc_vec2* positions,
+                                   f32* advances,
+                                   oc_text_metrics metrics)
+{
+    f32 scale = fontSize / fontData->unitsPerEm;
+
+    oc_shaped_text shaped = {
+        .font = font,
+        .fontSize = fontSize,
+        .metrics = oc_font_text_metrics_scale(metrics, scale),
+    };
+
+    shaped.glyphs = (oc_shaped_glyph*)oc_allocator_push_array_uninitialized(allocator, oc_shaped_glyph, glyphIndices.len);
+    if(shaped.glyphs)
+    {
+        shaped.glyphCount = glyphIndices.len;
+        for(u64 i = 0; i < glyphIndices.len; i++)
+        {
+            shaped.glyphs[i] = (oc_shaped_glyph){
+                .glyphIndex = glyphIndices.ptr[i],
+                .position = { positions[i].x * scale, positions[i].y * scale },
+                .advance = { advances[i] * scale, 0 },
+            };
+        }
+    }
+    return (shaped);
+}
+
+oc_shaped_text oc_font_shape_text_from_font_data(oc_allocator* allocator, oc_font font, oc_font_data* fontData, f32 fontSize, oc_str8 text)
+{
+    if(!text.len || !text.ptr)
+    {
+        return ((oc_shaped_text){ .font = font, .fontSize = fontSize });
+    }
 
-    OC_ASSERT(metrics.ink.y <= 0);
+    oc_shaped_text shaped = { 0 };
+    oc_glyph_run* run = oc_font_get_shaped_glyph_run(font, fontData, text);
+    if(run)
+    {
+        shaped = oc_shaped_text_push(allocator, font, fontData, fontSize, run->glyphIndices, run->positions, run->advances, run->shapedMetrics);
+    }
+    else
+    {
+        oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
 
-    f32 fontScale = oc_font_get_scale_for_em_pixels(font, fontSize);
+        oc_str32 codePoints = oc_utf8_push_to_codepoints(scratch.allocator, text);
+        oc_str32 glyphIndices = oc_font_push_glyph_indices(scratch.allocator, font, codePoints);
+        oc_vec2* positions = oc_arena_push_array_uninitialized(scratch.arena, oc_vec2, glyphIndices.len);
+        f32* advances = oc_arena_push_array_uninitialized(scratch.arena, f32, glyphIndices.len);
 
-    metrics.ink.x *= fontScale;
-    metrics.ink.y *= fontScale;
-    metrics.ink.w *= fontScale;
-    metrics.ink.h *= fontScale;
-    metrics.logical.x *= fontScale;
-    metrics.logical.y *= fontScale;
-    metrics.logical.w *= fontScale;
-    metrics.logical.h *= fontScale;
-    metrics.advance.x *= fontScale;
-    metrics.advance.y *= fontScale;
+        oc_text_metrics metrics = oc_font_text_metrics_unscaled(fontData, glyphIndices, true, positions, advances);
+        shaped = oc_shaped_text_push(allocator, font, fontData, fontSize, glyphIndices, positions, advances, metrics);
 
-    oc_scratch_end(scratch);
-    return (metrics);
+        oc_scratch_end(scratch);
+    }
+    return (shaped);
 }
 
-oc_text_metrics oc_font_text_metrics(oc_font font, f32 fontSize, oc_str8 text)
+oc_shaped_text oc_font_shape_text(oc_allocator* allocator, oc_font font, f32 fontSize, oc_str8 text)
 {
-    if(!text.len || !text.ptr)
+    oc_font_data* fontData = oc_font_data_from_handle(font);
+    if(!fontData)
     {
-        return ((oc_text_metrics){ 0 });
+        return ((oc_shaped_text){ 0 });
     }
+    return (oc_font_shape_text_from_font_data(allocator, font, fontData, fontSize, text));
+}
 
-    oc_scratch scratch = oc_scratch_begin();
-    oc_str32 codePoints = oc_utf8_push_to_codepoints(scratch.allocator, text);
-    oc_text_metrics result = oc_font_text_metrics_utf32(font, fontSize, codePoints);
-    oc_scratch_end(scratch);
-    return (result);
+void oc_font_shape_text_batch(oc_allocator* allocator, oc_font font, f32 fontSize, u32 count, oc_str8* texts, oc_shaped_text* results)
+{
+    oc_font_data* fontData = oc_font_data_from_handle(font);
+    for(u32 i = 0; i < count; i++)
+    {
+        if(fontData)
+        {
+            results[i] = oc_font_shape_text_from_font_data(allocator, font, fontData, fontSize, texts[i]);
+        }
+        else
+        {
+            results[i] = (oc_shaped_text){ 0 };
+        }
+    }
 }
 
 //------------------------------------------------------------------------------------------
@@ -963,6 +1563,11 @@ oc_canvas_context oc_canvas_context_create()
     if(!context)
     {
         context = oc_arena_push_type_uninitialized(&oc_graphicsData.resourceArena, oc_canvas_context_data);
+        if(context)
+        {
+            context->attributeCap = 0;
+            context->attributeBlocks = 0;
+        }
     }
     if(context)
     {
@@ -970,7 +1575,7 @@ oc_canvas_context oc_canvas_context_create()
         context->path = (oc_path_descriptor){ 0 };
         context->matrixStackSize = 0;
         context->clipStackSize = 0;
-        context->primitiveCount = 0;
+        oc_reset_commands(context);
         context->clearColor = (oc_color){ 0, 0, 0, 0 };
         context->msaaSampleCount = 8;
 
@@ -1035,10 +1640,12 @@ void oc_canvas_render(oc_canvas_renderer rendererHandle, oc_canvas_context conte
                                   context->clearColor,
                                   context->primitiveCount,
                                   context->primitives,
+                                  context->attributeCount,
+                                  context->attributeBlocks,
                                   eltCount,
                                   context->pathElements);
 
-        context->primitiveCount = 0;
+        oc_reset_commands(context);
         context->path.startIndex = 0;
         context->path.count = 0;
         context->clear = false;
@@ -1549,6 +2156,54 @@ void oc_close_path()
     context->subPathStartPoint = context->subPathLastPoint;
 }
 
+f32 oc_glyph_outlines_at(oc_canvas_context_data* context, oc_font_data* fontData, u32 glyphIndex, f32 xOffset, f32 yOffset, f32 scale)
+{
+    f32 flip = context->textFlip ? 1 : -1;
+
+    if(!glyphIndex || glyphIndex >= fontData->glyphCount)
+    {
+        oc_log_warning("code point is not present in font ranges\n");
+        //NOTE(martin): try to find the replacement character
+        glyphIndex = oc_font_get_glyph_index_from_font_data(fontData, 0xfffd);
+        if(!glyphIndex)
+        {
+            //NOTE(martin): could not find replacement glyph, render an empty rectangle using the missing glyph
+            //              metrics computed at font creation
+
+            oc_glyph_metrics missingGlyphMetrics = fontData->missingGlyphMetrics;
+
+            f32 oldStrokeWidth = context->attributes.width;
+
+            oc_set_width(missingGlyphMetrics.ink.w * 0.005);
+            oc_rectangle_stroke(xOffset + missingGlyphMetrics.ink.x * scale,
+                                yOffset + missingGlyphMetrics.ink.y * scale,
+                                missingGlyphMetrics.ink.w * scale * flip,
+                                missingGlyphMetrics.ink.h * scale);
+
+            oc_set_width(oldStrokeWidth);
+            oc_move_to(xOffset + missingGlyphMetrics.advance.x * scale, yOffset);
+            return (missingGlyphMetrics.advance.x * scale);
+        }
+    }
+
+    oc_glyph_data* glyph = oc_font_get_glyph_data(fontData, glyphIndex);
+
+    oc_path_push_elements(context, glyph->pathDescriptor.count, fontData->outlines + glyph->pathDescriptor.startIndex);
+
+    oc_path_elt* elements = context->pathElements + context->path.count + context->path.startIndex - glyph->pathDescriptor.count;
+    for(int eltIndex = 0; eltIndex < glyph->pathDescriptor.count; eltIndex++)
+    {
+        for(int pIndex = 0; pIndex < 3; pIndex++)
+        {
+            elements[eltIndex].p[pIndex].x = elements[eltIndex].p[pIndex].x * scale + xOffset;
+            elements[eltIndex].p[pIndex].y = elements[eltIndex].p[pIndex].y * scale * flip + yOffset;
+        }
+    }
+    oc_move_to(xOffset + scale * glyph->metrics.advance.x, yOffset);
+
+    return (scale * glyph->metrics.advance.x);
+}
+
 oc_rect oc_glyph_outlines_from_font_data(oc_font_data* fontData, oc_str32 glyphIndices)
 {
     oc_canvas_context_data* context = oc_currentCanvasContext;
@@ -1561,73 +2216,12 @@ oc_rect oc_glyph_outlines_from_font_data(oc_font_data* fontData, oc_str32 glyphI
 
     for(int i = 0; i < glyphIndices.len; i++)
     {
-        u32 glyphIndex = glyphIndices.ptr[i];
-
         f32 xOffset = context->subPathLastPoint.x;
         f32 yOffset = context->subPathLastPoint.y;
-        f32 flip = context->textFlip ? 1 : -1;
-
-        if(!glyphIndex || glyphIndex >= fontData->glyphCount)
-        {
-            oc_log_warning("code point is not present in font ranges\n");
-            //NOTE(martin): try to find the replacement character
-            glyphIndex = oc_font_get_glyph_index_from_font_data(fontData, 0xfffd);
-            if(!glyphIndex)
-            {
-                //NOTE(martin): could not find replacement glyph, try to get an 'X' to get a somewhat correct dimensions
-                //              to render an empty rectangle. Otherwise just render with the max font width
-
-                oc_glyph_metrics missingGlyphMetrics = { 0 };
-                u32 missingGlyphIndex = oc_font_get_glyph_index_from_font_data(fontData, 'X');
-
-                if(missingGlyphIndex)
-                {
-                    oc_font_get_glyph_metrics_from_font_data(fontData, (oc_str32){ .ptr = &missingGlyphIndex, .len = 1 }, &missingGlyphMetrics);
-                }
-                else
-                {
-                    missingGlyphMetrics = (oc_glyph_metrics){
-                        .ink = {
-                            .x = fontData->metrics.width * 0.1,
-                            .y = -fontData->metrics.ascent,
-                            .w = fontData->metrics.width * 0.8,
-                            .h = fontData->metrics.ascent,
-                        },
-                        .advance = { .x = fontData->metrics.width, .y = 0 },
-                    };
-                }
-
-                f32 oldStrokeWidth = context->attributes.width;
-
-                oc_set_width(missingGlyphMetrics.ink.w * 0.005);
-                oc_rectangle_stroke(xOffset + missingGlyphMetrics.ink.x * scale,
-                                    yOffset + missingGlyphMetrics.ink.y * scale,
-                                    missingGlyphMetrics.ink.w * scale * flip,
-                                    missingGlyphMetrics.ink.h * scale);
 
-                oc_set_width(oldStrokeWidth);
-                oc_move_to(xOffset + missingGlyphMetrics.advance.x * scale, yOffset);
-                maxWidth = oc_max(maxWidth, xOffset + missingGlyphMetrics.advance.x * scale - startX);
-                continue;
-            }
-        }
-
-        oc_glyph_data* glyph = oc_font_get_glyph_data(fontData, glyphIndex);
-
-        oc_path_push_elements(context, glyph->pathDescriptor.count, fontData->outlines + glyph->pathDescriptor.startIndex);
-
-        oc_path_elt* elements = context->pathElements + context->path.count + context->path.startIndex - glyph->pathDescriptor.count;
-        for(int eltIndex = 0; eltIndex < glyph->pathDescriptor.count; eltIndex++)
-        {
-            for(int pIndex = 0; pIndex < 3; pIndex++)
-            {
-                elements[eltIndex].p[pIndex].x = elements[eltIndex].p[pIndex].x * scale + xOffset;
-                elements[eltIndex].p[pIndex].y = elements[eltIndex].p[pIndex].y * scale * flip + yOffset;
-            }
-        }
-        oc_move_to(xOffset + scale * glyph->metrics.advance.x, yOffset);
+        f32 advance = oc_glyph_outlines_at(context, fontData, glyphIndices.ptr[i], xOffset, yOffset, scale);
 
-        maxWidth = oc_max(maxWidth, xOffset + scale * glyph->metrics.advance.x - startX);
+        maxWidth = oc_max(maxWidth, xOffset + advance - startX);
     }
     f32 lineHeight = (fontData->metrics.ascent + fontData->metrics.descent) * scale;
     oc_rect box = { startX, startY, maxWidth, context->subPathLastPoint.y - startY + lineHeight };
@@ -1683,13 +2277,52 @@ void oc_text_outlines(oc_str8 text)
         return;
     }
 
-    oc_scratch scratch = oc_scratch_begin();
-    oc_str32 codePoints = oc_utf8_push_to_codepoints(scratch.allocator, text);
-    oc_str32 glyphIndices = oc_font_push_glyph_indices(scratch.allocator, context->attributes.font, codePoints);
+    oc_glyph_run* run = oc_font_get_glyph_run(context->attributes.font, fontData, text);
+    if(run)
+    {
+        oc_glyph_outlines_from_font_data(fontData, run->glyphIndices);
+    }
+    else
+    {
+        oc_scratch scratch = oc_scratch_begin();
+        oc_str32 codePoints = oc_utf8_push_to_codepoints(scratch.allocator, text);
+        oc_str32 glyphIndices = oc_font_push_glyph_indices(scratch.allocator, context->attributes.font, codePoints);
 
-    oc_glyph_outlines_from_font_data(fontData, glyphIndices);
+        oc_glyph_outlines_from_font_data(fontData, glyphIndices);
 
-    oc_scratch_end(scratch);
+        oc_scratch_end(scratch);
+    }
+}
+
+void oc_shaped_text_outlines(oc_shaped_text shaped)
+{
+    oc_canvas_context_data* context = oc_currentCanvasContext;
+    if(!context)
+    {
+        return;
+    }
+    oc_font_data* fontData = oc_font_data_from_handle(shaped.font);
+    if(!fontData)
+    {
+        return;
+    }
+
+    f32 originX = context->subPathLastPoint.x;
+    f32 originY = context->subPathLastPoint.y;
+    f32 flip = context->textFlip ? 1 : -1;
+    f32 scale = shaped.fontSize / fontData->unitsPerEm;
+
+    for(u64 i = 0; i < shaped.glyphCount; i++)
+    {
+        oc_shaped_glyph* glyph = &shaped.glyphs[i];
+        oc_glyph_outlines_at(context,
+                             fontData,
+                             glyph->glyphIndex,
+                             originX + glyph->position.x,
+                             originY - flip * glyph->position.y,
+                             scale);
+    }
+    oc_move_to(originX + shaped.metrics.advance.x, originY - flip * shaped.metrics.advance.y);
 }
 
 //------------------------------------------------------------------------------------------
@@ -1701,7 +2334,7 @@ void oc_clear()
     oc_canvas_context_data* context = oc_currentCanvasContext;
     if(context)
     {
-        context->primitiveCount = 0;
+        oc_reset_commands(context);
         context->clearColor = context->attributes.colors[0];
         context->clear = true;
     }
@@ -1727,6 +2360,219 @@ void oc_stroke()
     }
 }
 
+//------------------------------------------------------------------------------------------
+//NOTE: command recording
+//------------------------------------------------------------------------------------------
+
+typedef struct oc_canvas_recording
+{
+    bool valid;
+    oc_canvas_context_data* context;
+    u32 primitiveStart;
+    u32 eltStart;
+
+    u32 primitiveCount;
+    u32 primitiveCap;
+    oc_primitive* primitives; // attributesIndex refers to the recording's attributes array
+
+    u32 attributeCount;
+    u32 attributeCap;
+    oc_attributes* attributes;
+
+    u32 eltCount;
+    u32 eltCap;
+    oc_path_elt* elements;
+
+    //NOTE: context state at the end of the recording
+    oc_attributes endAttributes;
+    oc_vec2 endPathStartPoint;
+    oc_vec2 endSubPathStartPoint;
+    oc_vec2 endSubPathLastPoint;
+
+} oc_canvas_recording;
+
+enum
+{
+    OC_CANVAS_RECORDING_DEFAULT_LEN = 16,
+};
+
+static void* oc_canvas_recording_grow(void* buffer, u32* cap, u32 needed, u32 eltSize)
+{
+    if(needed > *cap)
+    {
+        u32 newCap = oc_max(needed, oc_max(*cap + *cap / 2, OC_CANVAS_RECORDING_DEFAULT_LEN));
+        buffer = realloc(buffer, (u64)newCap * eltSize);
+        *cap = newCap;
+    }
+    return (buffer);
+}
+
+oc_canvas_recording* oc_canvas_recording_create(void)
+{
+    oc_canvas_recording* recording = oc_malloc_type(oc_canvas_recording);
+    if(recording)
+    {
+        memset(recording, 0, sizeof(oc_canvas_recording));
+    }
+    return (recording);
+}
+
+void oc_canvas_recording_destroy(oc_canvas_recording* recording)
+{
+    if(recording)
+    {
+        free(recording->primitives);
+        free(recording->attributes);
+        free(recording->elements);
+        free(recording);
+    }
+}
+
+void oc_canvas_record_begin(oc_canvas_recording* recording)
+{
+    oc_canvas_context_data* context = oc_currentCanvasContext;
+    if(!recording)
+    {
+        return;
+    }
+
+    recording->valid = (context != 0);
+    recording->context = context;
+    recording->primitiveCount = 0;
+    recording->attributeCount = 0;
+    recording->eltCount = 0;
+
+    if(context)
+    {
+        recording->primitiveStart = context->primitiveCount;
+        recording->eltStart = context->path.startIndex + context->path.count;
+    }
+}
+
+void oc_canvas_record_end(oc_canvas_recording* recording)
+{
+    oc_canvas_context_data* context = oc_currentCanvasContext;
+    if(!recording)
+    {
+        return;
+    }
+
+    //NOTE: only capture the path elements consumed by commands, ie. not those of a path still under construction
+    if(!recording->valid
+       || context != recording->context
+       || context->primitiveCount < recording->primitiveStart
+       || context->path.startIndex < recording->eltStart)
+    {
+        recording->valid = false;
+        return;
+    }
+
+    u32 primitiveCount = context->primitiveCount - recording->primitiveStart;
+    u32 eltCount = context->path.startIndex - recording->eltStart;
+
+    recording->primitives = oc_canvas_recording_grow(recording->primitives, &recording->primitiveCap, primitiveCount, sizeof(oc_primitive));
+    recording->elements = oc_canvas_recording_grow(recording->elements, &recording->eltCap, eltCount, sizeof(oc_path_elt));
+
+    u32 lastContextAttributes = 0;
+    for(u32 i = 0; i < primitiveCount; i++)
+    {
+        oc_primitive primitive = context->primitives[recording->primitiveStart + i];
+
+        if(primitive.cmd == OC_CMD_FILL || primitive.cmd == OC_CMD_STROKE)
+        {
+            if(primitive.path.startIndex < recording->eltStart)
+            {
+                //NOTE: the path was started before the recording
+                recording->valid = false;
+                return;
+            }
+            primitive.path.startIndex -= recording->eltStart;
+        }
+
+        if(!recording->attributeCount || primitive.attributesIndex != lastContextAttributes)
+        {
+            recording->attributes = oc_canvas_recording_grow(recording->attributes,
+                                                             &recording->attributeCap,
+                                                             recording->attributeCount + 1,
+                                                             sizeof(oc_attributes));
+            recording->attributes[recording->attributeCount] = context->attributeBlocks[primitive.attributesIndex];
+            recording->attributeCount++;
+            lastContextAttributes = primitive.attributesIndex;
+        }
+        primitive.attributesIndex = recording->attributeCount - 1;
+
+        recording->primitives[i] = primitive;
+    }
+    recording->primitiveCount = primitiveCount;
+
+    memcpy(recording->elements, context->pathElements + recording->eltStart, eltCount * sizeof(oc_path_elt));
+    recording->eltCount = eltCount;
+
+    recording->endAttributes = context->attributes;
+    recording->endPathStartPoint = context->path.startPoint;
+    recording->endSubPathStartPoint = context->subPathStartPoint;
+    recording->endSubPathLastPoint = context->subPathLastPoint;
+}
+
+bool oc_canvas_replay(oc_canvas_recording* recording)
+{
+    oc_canvas_context_data* context = oc_currentCanvasContext;
+    if(!context
+       || !recording
+       || !recording->valid
+       || context->primitiveCount + recording->primitiveCount > OC_MAX_PRIMITIVE_COUNT
+       || context->path.startIndex + context->path.count + recording->eltCount >= OC_MAX_PATH_ELEMENT_COUNT)
+    {
+        return (false);
+    }
+
+    //NOTE: reserve room for all the recorded attributes up front, so that interning them below can't fail midway
+    if(!oc_reserve_attributes(context, context->attributeCount + recording->attributeCount))
+    {
+        return (false);
+    }
+
+    //NOTE: insert the recorded elements before the current path, which may be under construction
+    u32 eltBase = context->path.startIndex;
+    memmove(context->pathElements + eltBase + recording->eltCount,
+            context->pathElements + eltBase,
+            context->path.count * sizeof(oc_path_elt));
+    memcpy(context->pathElements + eltBase, recording->elements, recording->eltCount * sizeof(oc_path_elt));
+    context->path.startIndex += recording->eltCount;
+
+    u32 lastRecordingAttributes = 0;
+    u32 attributesIndex = 0;
+    for(u32 i = 0; i < recording->primitiveCount; i++)
+    {
+        oc_primitive primitive = recording->primitives[i];
+
+        if(primitive.cmd == OC_CMD_FILL || primitive.cmd == OC_CMD_STROKE)
+        {
+            primitive.path.startIndex += eltBase;
+        }
+
+        if(i == 0 || primitive.attributesIndex != lastRecordingAttributes)
+        {
+            lastRecordingAttributes = primitive.attributesIndex;
+            oc_intern_attributes_block(context, &recording->attributes[primitive.attributesIndex], &attributesIndex);
+        }
+        primitive.attributesIndex = attributesIndex;
+
+        context->primitives[context->primitiveCount] = primitive;
+        context->primitiveCount++;
+    }
+
+    if(!context->path.count)
+    {
+        context->path.startPoint = recording->endPathStartPoint;
+        context->subPathStartPoint = recording->endSubPathStartPoint;
+        context->subPathLastPoint = recording->endSubPathLastPoint;
+    }
+    context->attributes = recording->endAttributes;
+
+    return (true);
+}
+
 //------------------------------------------------------------------------------------------
 //NOTE(martin): simple shape helpers
 //------------------------------------------------------------------------------------------
@@ -1740,12 +2586,6 @@ void oc_rectangle_path(f32 x, f32 y, f32 w, f32 h)
     oc_close_path();
 }
 
-void oc_rectangle_fill(f32 x, f32 y, f32 w, f32 h)
-{
-    oc_rectangle_path(x, y, w, h);
-    oc_fill();
-}
-
 void oc_rectangle_stroke(f32 x, f32 y, f32 w, f32 h)
 {
     oc_canvas_context_data* context = oc_currentCanvasContext;
@@ -1776,10 +2616,91 @@ void oc_rounded_rectangle_path(f32 x, f32 y, f32 w, f32 h, f32 r)
     oc_cubic_to(x, y + r - c, x + r - c, y, x + r, y);
 }
 
+u32 oc_rect_primitive_elements(oc_primitive* primitive, oc_path_elt* elements)
+{
+    f32 x = primitive->rect.x;
+    f32 y = primitive->rect.y;
+    f32 w = primitive->rect.w;
+    f32 h = primitive->rect.h;
+    f32 r = oc_min(primitive->radius, oc_min(w / 2, h / 2));
+
+    u32 count = 0;
+    if(r > 0)
+    {
+        f32 c = r * 4 * (sqrt(2) - 1) / 3;
+
+        elements[0] = (oc_path_elt){ .type = OC_PATH_MOVE, .p[0] = { x + r, y } };
+        elements[1] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x + w - r, y } };
+        elements[2] = (oc_path_elt){ .type = OC_PATH_CUBIC, .p = { { x + w - r + c, y }, { x + w, y + r - c }, { x + w, y + r } } };
+        elements[3] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x + w, y + h - r } };
+        elements[4] = (oc_path_elt){ .type = OC_PATH_CUBIC, .p = { { x + w, y + h - r + c }, { x + w - r + c, y + h }, { x + w - r, y + h } } };
+        elements[5] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x + r, y + h } };
+        elements[6] = (oc_path_elt){ .type = OC_PATH_CUBIC, .p = { { x + r - c, y + h }, { x, y + h - r + c }, { x, y + h - r } } };
+        elements[7] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x, y + r } };
+        elements[8] = (oc_path_elt){ .type = OC_PATH_CUBIC, .p = { { x, y + r - c }, { x + r - c, y }, { x + r, y } } };
+        count = 9;
+    }
+    else
+    {
+        elements[0] = (oc_path_elt){ .type = OC_PATH_MOVE, .p[0] = { x, y } };
+        elements[1] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x + w, y } };
+        elements[2] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x + w, y + h } };
+        elements[3] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x, y + h } };
+        elements[4] = (oc_path_elt){ .type = OC_PATH_LINE, .p[0] = { x, y } };
+        count = 5;
+    }
+    return (count);
+}
+
+static void oc_rect_fill(oc_canvas_context_data* context, oc_rect rect, f32 radius)
+{
+    if(context->path.count)
+    {
+        //NOTE: there's a pending path that must be filled along with the rectangle, use the general path
+        if(radius > 0)
+        {
+            oc_rounded_rectangle_path(rect.x, rect.y, rect.w, rect.h, radius);
+        }
+        else
+        {
+            oc_rectangle_path(rect.x, rect.y, rect.w, rect.h);
+        }
+        oc_fill();
+    }
+    else
+    {
+        //NOTE: fast path, push a single rect command instead of path elements.
+        oc_push_command(context, (oc_primitive){ .cmd = OC_CMD_RECT_FILL, .rect = rect, .radius = radius });
+
+        //NOTE: leave the sub-path points where oc_rectangle_path() or oc_rounded_rectangle_path() would, ie. at the
+        //      start of the rectangle's outline
+        oc_vec2 start = { rect.x, rect.y };
+        if(radius > 0)
+        {
+            start.x += oc_min(radius, oc_min(rect.w / 2, rect.h / 2));
+        }
+        context->subPathStartPoint = start;
+        context->subPathLastPoint = start;
+        oc_new_path(context);
+    }
+}
+
+void oc_rectangle_fill(f32 x, f32 y, f32 w, f32 h)
+{
+    oc_canvas_context_data* context = oc_currentCanvasContext;
+    if(context)
+    {
+        oc_rect_fill(context, (oc_rect){ x, y, w, h }, 0);
+    }
+}
+
 void oc_rounded_rectangle_fill(f32 x, f32 y, f32 w, f32 h, f32 r)
 {
-    oc_rounded_rectangle_path(x, y, w, h, r);
-    oc_fill();
+    oc_canvas_context_data* context = oc_currentCanvasContext;
+    if(context)
+    {
+        oc_rect_fill(context, (oc_rect){ x, y, w, h }, r);
+    }
 }
 
 void oc_rounded_rectangle_stroke(f32 x, f32 y, f32 w, f32 h, f32 r)
@@ -1965,13 +2886,7 @@ void oc_image_draw_region(oc_image image, oc_rect srcRegion, oc_rect dstRegion)
         context->attributes.colors[0] = (oc_color){ 1, 1, 1, 1 };
         context->attributes.hasGradient = false;
 
-        oc_move_to(dstRegion.x, dstRegion.y);
-        oc_line_to(dstRegion.x + dstRegion.w, dstRegion.y);
-        oc_line_to(dstRegion.x + dstRegion.w, dstRegion.y + dstRegion.h);
-        oc_line_to(dstRegion.x, dstRegion.y + dstRegion.h);
-        oc_close_path();
-
-        oc_fill();
+        oc_rect_fill(context, dstRegion, 0);
 
         context->attributes.image = oldImage;
         context->attributes.srcRegion = oldSrcRegion;
@@ -61,23 +61,43 @@ typedef enum
 {
     OC_CMD_FILL = 0,
     OC_CMD_STROKE,
-    OC_CMD_JUMP
+    OC_CMD_JUMP,
+    OC_CMD_RECT_FILL, // fills a (possibly rounded) rectangle without going through path elements
 } oc_primitive_cmd;
 
+//NOTE: primitives don't carry their attributes. Attribute blocks are interned once per frame in a separate
+//      array, and primitives reference them by index. The first color is the attribute that changes most
+//      often, so it is stored in the primitive instead, and colors[0] is left zeroed in attribute blocks.
 typedef struct oc_primitive
 {
     oc_primitive_cmd cmd;
-    oc_attributes attributes;
+    u32 attributesIndex;
+    oc_color color;
 
     union
     {
         oc_path_descriptor path;
-        oc_rect rect;
+
+        struct
+        {
+            oc_rect rect;
+            f32 radius;
+        };
+
         u32 jump;
     };
 
 } oc_primitive;
 
+enum
+{
+    OC_RECT_PRIMITIVE_MAX_ELEMENT_COUNT = 9,
+};
+
+//NOTE: expands an OC_CMD_RECT_FILL primitive into path elements, for consumers that only deal with paths.
+//      elements must have room for OC_RECT_PRIMITIVE_MAX_ELEMENT_COUNT elements. Returns the element count.
+u32 oc_rect_primitive_elements(oc_primitive* primitive, oc_path_elt* elements);
+
 ORCA_API void oc_canvas_renderer_submit(oc_canvas_renderer renderer,
                                         oc_surface surface,
                                         u32 msaaSampleCount,
@@ -85,5 +105,7 @@ ORCA_API void oc_canvas_renderer_submit(oc_canvas_renderer renderer,
                                         oc_color clearColor,
                                         u32 primitiveCount,
                                         oc_primitive* primitives,
+                                        u32 attributeCount,
+                                        oc_attributes* attributes,
                                         u32 eltCount,
                                         oc_path_elt* elements);
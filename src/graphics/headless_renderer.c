@@ -0,0 +1,423 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include "canvas_renderer.h"
+#include "cpu_rasterizer.h"
+#include "headless_renderer.h"
+#include "platform/platform_trace.h"
+
+typedef struct oc_headless_canvas_renderer
+{
+    oc_canvas_renderer_base base;
+    oc_headless_canvas_stats stats;
+
+    bool rasterize;
+    oc_cpu_rasterizer* rasterizer;
+
+} oc_headless_canvas_renderer;
+
+typedef struct oc_headless_surface
+{
+    oc_surface_base base;
+
+    u64 frameIndex;
+    bool capture;
+    oc_headless_canvas_capture lastFrame;
+    u32 primitiveCap;
+    u32 attributeCap;
+    u32 eltCap;
+
+    oc_headless_canvas_pixels pixels;
+    u64 pixelCap;
+
+} oc_headless_surface;
+
+typedef struct oc_headless_image
+{
+    oc_image_base base;
+    u8* pixels;
+
+} oc_headless_image;
+
+//------------------------------------------------------------------------------------------
+// surface
+//------------------------------------------------------------------------------------------
+
+static i32 oc_headless_surface_destroy_callback(void* user)
+{
+    oc_headless_surface* surface = (oc_headless_surface*)user;
+
+    oc_surface_base_cleanup((oc_surface_base*)surface);
+
+    free(surface->lastFrame.primitives);
+    free(surface->lastFrame.attributes);
+    free(surface->lastFrame.elements);
+    free(surface->pixels.pixels);
+    free(surface);
+    return 0;
+}
+
+void oc_headless_surface_destroy(oc_surface_base* base)
+{
+    oc_dispatch_on_main_thread_sync(oc_headless_surface_destroy_callback, base);
+}
+
+typedef struct oc_headless_surface_create_data
+{
+    oc_window window;
+    oc_surface surface;
+} oc_headless_surface_create_data;
+
+static i32 oc_headless_surface_create_callback(void* user)
+{
+    oc_headless_surface_create_data* data = (oc_headless_surface_create_data*)user;
+
+    oc_headless_surface* surface = 0;
+    oc_window_data* windowData = oc_window_ptr_from_handle(data->window);
+    if(windowData)
+    {
+        surface = oc_malloc_type(oc_headless_surface);
+        memset(surface, 0, sizeof(oc_headless_surface));
+
+        oc_surface_base_init_for_window((oc_surface_base*)surface, windowData);
+
+        surface->base.api = OC_SURFACE_HEADLESS;
+        surface->base.destroy = oc_headless_surface_destroy;
+    }
+
+    oc_surface handle = oc_surface_nil();
+    if(surface)
+    {
+        handle = oc_surface_handle_alloc((oc_surface_base*)surface);
+    }
+    data->surface = handle;
+    return 0;
+}
+
+oc_surface oc_headless_canvas_surface_create_for_window(oc_canvas_renderer_base* base, oc_window window)
+{
+    oc_headless_surface_create_data data = {
+        .window = window,
+    };
+
+    oc_dispatch_on_main_thread_sync(oc_headless_surface_create_callback, &data);
+
+    return (data.surface);
+}
+
+static oc_headless_surface* oc_headless_surface_from_handle(oc_surface handle)
+{
+    oc_surface_base* base = oc_surface_from_handle(handle);
+    if(base && base->api == OC_SURFACE_HEADLESS)
+    {
+        return ((oc_headless_surface*)base);
+    }
+    return (0);
+}
+
+void oc_headless_canvas_surface_set_capture(oc_surface handle, bool capture)
+{
+    oc_headless_surface* surface = oc_headless_surface_from_handle(handle);
+    if(surface)
+    {
+        surface->capture = capture;
+    }
+}
+
+oc_headless_canvas_capture oc_headless_canvas_surface_get_capture(oc_surface handle)
+{
+    oc_headless_canvas_capture capture = { 0 };
+    oc_headless_surface* surface = oc_headless_surface_from_handle(handle);
+    if(surface && surface->capture)
+    {
+        capture = surface->lastFrame;
+    }
+    return (capture);
+}
+
+oc_headless_canvas_pixels oc_headless_canvas_surface_get_pixels(oc_surface handle)
+{
+    oc_headless_canvas_pixels pixels = { 0 };
+    oc_headless_surface* surface = oc_headless_surface_from_handle(handle);
+    if(surface)
+    {
+        pixels = surface->pixels;
+    }
+    return (pixels);
+}
+
+static void oc_headless_surface_capture(oc_headless_surface* surface,
+                                        u32 sampleCount,
+                                        bool clear,
+                                        oc_color clearColor,
+                                        u32 primitiveCount,
+                                        oc_primitive* primitives,
+                                        u32 attributeCount,
+                                        oc_attributes* attributes,
+                                        u32 eltCount,
+                                        oc_path_elt* elements)
+{
+    if(primitiveCount > surface->primitiveCap)
+    {
+        surface->primitiveCap = oc_max(primitiveCount, 2 * surface->primitiveCap);
+        surface->lastFrame.primitives = realloc(surface->lastFrame.primitives, surface->primitiveCap * sizeof(oc_primitive));
+    }
+    if(attributeCount > surface->attributeCap)
+    {
+        surface->attributeCap = oc_max(attributeCount, 2 * surface->attributeCap);
+        surface->lastFrame.attributes = realloc(surface->lastFrame.attributes, surface->attributeCap * sizeof(oc_attributes));
+    }
+    if(eltCount > surface->eltCap)
+    {
+        surface->eltCap = oc_max(eltCount, 2 * surface->eltCap);
+        surface->lastFrame.elements = realloc(surface->lastFrame.elements, surface->eltCap * sizeof(oc_path_elt));
+    }
+
+    surface->lastFrame.frameIndex = surface->frameIndex;
+    surface->lastFrame.sampleCount = sampleCount;
+    surface->lastFrame.clear = clear;
+    surface->lastFrame.clearColor = clearColor;
+    surface->lastFrame.primitiveCount = primitiveCount;
+    surface->lastFrame.attributeCount = attributeCount;
+    surface->lastFrame.eltCount = eltCount;
+
+    if(primitiveCount)
+    {
+        memcpy(surface->lastFrame.primitives, primitives, primitiveCount * sizeof(oc_primitive));
+    }
+    if(attributeCount)
+    {
+        memcpy(surface->lastFrame.attributes, attributes, attributeCount * sizeof(oc_attributes));
+    }
+    if(eltCount)
+    {
+        memcpy(surface->lastFrame.elements, elements, eltCount * sizeof(oc_path_elt));
+    }
+}
+
+static oc_cpu_raster_image oc_headless_raster_image(oc_image handle, void* user)
+{
+    oc_cpu_raster_image result = { 0 };
+    oc_headless_image* image = (oc_headless_image*)oc_image_from_handle(handle);
+    if(image)
+    {
+        result.width = (u32)image->base.size.x;
+        result.height = (u32)image->base.size.y;
+        result.pixels = image->pixels;
+    }
+    return (result);
+}
+
+static void oc_headless_surface_rasterize(oc_headless_canvas_renderer* renderer,
+                                          oc_headless_surface* surface,
+                                          u32 sampleCount,
+                                          bool clear,
+                                          oc_color clearColor,
+                                          u32 primitiveCount,
+                                          oc_primitive* primitives,
+                                          u32 attributeCount,
+                                          oc_attributes* attributes,
+                                          u32 eltCount,
+                                          oc_path_elt* elements)
+{
+    oc_vec2 size = surface->base.getSize((oc_surface_base*)surface);
+    oc_vec2 scale = surface->base.contentsScaling((oc_surface_base*)surface);
+
+    u32 width = (u32)(size.x * scale.x);
+    u32 height = (u32)(size.y * scale.y);
+    u64 byteSize = (u64)width * height * 4;
+
+    if(byteSize > surface->pixelCap)
+    {
+        surface->pixels.pixels = realloc(surface->pixels.pixels, byteSize);
+        surface->pixelCap = byteSize;
+    }
+    if(width != surface->pixels.width || height != surface->pixels.height)
+    {
+        //NOTE: surface was resized, start from transparent pixels
+        memset(surface->pixels.pixels, 0, byteSize);
+        surface->pixels.width = width;
+        surface->pixels.height = height;
+    }
+
+    oc_cpu_raster_target target = {
+        .width = width,
+        .height = height,
+        .pitch = width * 4,
+        .pixels = surface->pixels.pixels,
+        .scale = scale,
+    };
+
+    oc_cpu_rasterizer_render(renderer->rasterizer,
+                             &target,
+                             oc_headless_raster_image,
+                             0,
+                             sampleCount,
+                             clear,
+                             clearColor,
+                             primitiveCount,
+                             primitives,
+                             attributeCount,
+                             attributes,
+                             eltCount,
+                             elements);
+}
+
+//------------------------------------------------------------------------------------------
+// renderer
+//------------------------------------------------------------------------------------------
+
+void oc_headless_canvas_submit(oc_canvas_renderer_base* rendererBase,
+                               oc_surface surfaceHandle,
+                               u32 sampleCount,
+                               bool clear,
+                               oc_color clearColor,
+                               u32 primitiveCount,
+                               oc_primitive* primitives,
+                               u32 attributeCount,
+                               oc_attributes* attributes,
+                               u32 eltCount,
+                               oc_path_elt* elements)
+{
+    oc_headless_canvas_renderer* renderer = (oc_headless_canvas_renderer*)rendererBase;
+    f64 submitStart = oc_clock_time(OC_CLOCK_MONOTONIC);
+
+    oc_headless_surface* surface = oc_headless_surface_from_handle(surfaceHandle);
+    if(surface)
+    {
+        if(surface->capture)
+        {
+            oc_trace_zone("headless capture")
+            {
+                oc_headless_surface_capture(surface, sampleCount, clear, clearColor, primitiveCount, primitives, attributeCount, attributes, eltCount, elements);
+            }
+        }
+        if(renderer->rasterize)
+        {
+            oc_trace_zone("headless rasterize")
+            {
+                oc_headless_surface_rasterize(renderer, surface, sampleCount, clear, clearColor, primitiveCount, primitives, attributeCount, attributes, eltCount, elements);
+            }
+        }
+        surface->frameIndex++;
+    }
+
+    renderer->stats.submitCount++;
+    renderer->stats.primitiveCount += primitiveCount;
+    renderer->stats.attributeCount += attributeCount;
+    renderer->stats.eltCount += eltCount;
+    renderer->stats.commandBytes += primitiveCount * sizeof(oc_primitive)
+                                  + attributeCount * sizeof(oc_attributes)
+                                  + eltCount * sizeof(oc_path_elt);
+    renderer->stats.submitTime += oc_clock_time(OC_CLOCK_MONOTONIC) - submitStart;
+}
+
+void oc_headless_canvas_present(oc_canvas_renderer_base* rendererBase, oc_surface surfaceHandle)
+{
+    oc_headless_canvas_renderer* renderer = (oc_headless_canvas_renderer*)rendererBase;
+    renderer->stats.presentCount++;
+}
+
+void oc_headless_canvas_destroy(oc_canvas_renderer_base* base)
+{
+    oc_headless_canvas_renderer* renderer = (oc_headless_canvas_renderer*)base;
+    oc_cpu_rasterizer_destroy(renderer->rasterizer);
+    free(renderer);
+}
+
+oc_image_base* oc_headless_canvas_image_create(oc_canvas_renderer_base* base, oc_vec2 size)
+{
+    oc_headless_image* image = oc_malloc_type(oc_headless_image);
+    if(image)
+    {
+        memset(image, 0, sizeof(oc_headless_image));
+        image->base.size = size;
+
+        //NOTE: keep the image's pixels around so that offscreen surfaces can be read back and rendered on the cpu.
+        u64 byteSize = (u64)size.x * (u64)size.y * 4;
+        image->pixels = calloc(byteSize, 1);
+    }
+    return ((oc_image_base*)image);
+}
+
+void oc_headless_canvas_image_destroy(oc_canvas_renderer_base* rendererBase, oc_image_base* imageBase)
+{
+    oc_headless_image* image = (oc_headless_image*)imageBase;
+    free(image->pixels);
+    free(image);
+}
+
+void oc_headless_canvas_image_upload_region(oc_canvas_renderer_base* rendererBase, oc_image_base* imageBase, oc_rect region, u8* pixels)
+{
+    oc_headless_image* image = (oc_headless_image*)imageBase;
+
+    u32 imageWidth = (u32)image->base.size.x;
+    u32 imageHeight = (u32)image->base.size.y;
+
+    u32 x0 = oc_min((u32)region.x, imageWidth);
+    u32 y0 = oc_min((u32)region.y, imageHeight);
+    u32 x1 = oc_min((u32)(region.x + region.w), imageWidth);
+    u32 y1 = oc_min((u32)(region.y + region.h), imageHeight);
+
+    u32 srcPitch = (u32)region.w * 4;
+
+    for(u32 y = y0; y < y1; y++)
+    {
+        memcpy(image->pixels + (y * imageWidth + x0) * 4,
+               pixels + (y - y0) * srcPitch,
+               (x1 - x0) * 4);
+    }
+}
+
+oc_canvas_renderer oc_canvas_renderer_create(void)
+{
+    oc_headless_canvas_renderer* renderer = oc_malloc_type(oc_headless_canvas_renderer);
+    memset(renderer, 0, sizeof(oc_headless_canvas_renderer));
+
+    renderer->base.destroy = oc_headless_canvas_destroy;
+    renderer->base.createSurfaceForWindow = oc_headless_canvas_surface_create_for_window;
+    renderer->base.imageCreate = oc_headless_canvas_image_create;
+    renderer->base.imageDestroy = oc_headless_canvas_image_destroy;
+    renderer->base.imageUploadRegion = oc_headless_canvas_image_upload_region;
+    renderer->base.submit = oc_headless_canvas_submit;
+    renderer->base.present = oc_headless_canvas_present;
+
+    renderer->rasterize = true;
+    renderer->rasterizer = oc_cpu_rasterizer_create(oc_processor_count());
+
+    oc_canvas_renderer handle = oc_canvas_renderer_handle_alloc((oc_canvas_renderer_base*)renderer);
+    return (handle);
+}
+
+oc_headless_canvas_stats oc_headless_canvas_get_stats(oc_canvas_renderer handle)
+{
+    oc_headless_canvas_stats stats = { 0 };
+    oc_canvas_renderer_base* base = oc_canvas_renderer_from_handle(handle);
+    if(base && base->submit == oc_headless_canvas_submit)
+    {
+        stats = ((oc_headless_canvas_renderer*)base)->stats;
+    }
+    return (stats);
+}
+
+void oc_headless_canvas_reset_stats(oc_canvas_renderer handle)
+{
+    oc_canvas_renderer_base* base = oc_canvas_renderer_from_handle(handle);
+    if(base && base->submit == oc_headless_canvas_submit)
+    {
+        ((oc_headless_canvas_renderer*)base)->stats = (oc_headless_canvas_stats){ 0 };
+    }
+}
+
+void oc_headless_canvas_set_rasterize(oc_canvas_renderer handle, bool rasterize)
+{
+    oc_canvas_renderer_base* base = oc_canvas_renderer_from_handle(handle);
+    if(base && base->submit == oc_headless_canvas_submit)
+    {
+        ((oc_headless_canvas_renderer*)base)->rasterize = rasterize;
+    }
+}
@@ -0,0 +1,68 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "graphics_common.h"
+
+//NOTE: the headless canvas renderer doesn't draw to the screen. By default, submissions to its
+//      surfaces are rasterized on the cpu into an offscreen RGBA8 buffer that can be read back.
+//      Rasterization can be turned off, in which case submissions are discarded (but still counted),
+//      which is enough to benchmark guest code and the encoding pipeline. Surfaces can also be put
+//      in capture mode, in which case they keep a copy of the last submitted command stream that
+//      can be inspected or replayed.
+
+typedef struct oc_headless_canvas_stats
+{
+    u64 submitCount;
+    u64 presentCount;
+    u64 primitiveCount;
+    u64 attributeCount;
+    u64 eltCount;
+    u64 commandBytes; // size of the primitive, attribute and path element streams that were submitted
+    f64 submitTime;   // total time spent in submit, in seconds
+
+} oc_headless_canvas_stats;
+
+typedef struct oc_headless_canvas_capture
+{
+    u64 frameIndex;
+    u32 sampleCount;
+    bool clear;
+    oc_color clearColor;
+
+    u32 primitiveCount;
+    oc_primitive* primitives;
+
+    u32 attributeCount;
+    oc_attributes* attributes;
+
+    u32 eltCount;
+    oc_path_elt* elements;
+
+} oc_headless_canvas_capture;
+
+typedef struct oc_headless_canvas_pixels
+{
+    u32 width;
+    u32 height;
+    u8* pixels; // RGBA8, sRGB encoded, premultiplied, rows are tightly packed
+
+} oc_headless_canvas_pixels;
+
+ORCA_API void oc_headless_canvas_set_rasterize(oc_canvas_renderer renderer, bool rasterize);
+
+ORCA_API oc_headless_canvas_stats oc_headless_canvas_get_stats(oc_canvas_renderer renderer);
+ORCA_API void oc_headless_canvas_reset_stats(oc_canvas_renderer renderer);
+
+ORCA_API void oc_headless_canvas_surface_set_capture(oc_surface surface, bool capture);
+
+//NOTE: the returned capture points to storage owned by the surface, and is only valid until the next submit
+ORCA_API oc_headless_canvas_capture oc_headless_canvas_surface_get_capture(oc_surface surface);
+
+//NOTE: the returned pixels are owned by the surface, and are only valid until the next submit
+ORCA_API oc_headless_canvas_pixels oc_headless_canvas_surface_get_pixels(oc_surface surface);
@@ -0,0 +1,66 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include "linux_surface.h"
+#include "surface.h"
+
+oc_vec2 oc_surface_base_get_size(oc_surface_base* surface)
+{
+    oc_vec2 size = { 0 };
+    if(surface->view.parent)
+    {
+        oc_rect rect = surface->view.parent->headless.contentRect;
+        size = (oc_vec2){ rect.w, rect.h };
+    }
+    return (size);
+}
+
+oc_vec2 oc_surface_base_contents_scaling(oc_surface_base* surface)
+{
+    return ((oc_vec2){ 1, 1 });
+}
+
+void oc_surface_base_bring_to_front(oc_surface_base* surface)
+{
+    oc_list_remove(&surface->view.parent->headless.surfaces, &surface->view.listElt);
+    oc_list_push_front(&surface->view.parent->headless.surfaces, &surface->view.listElt);
+}
+
+void oc_surface_base_send_to_back(oc_surface_base* surface)
+{
+    oc_list_remove(&surface->view.parent->headless.surfaces, &surface->view.listElt);
+    oc_list_push_back(&surface->view.parent->headless.surfaces, &surface->view.listElt);
+}
+
+bool oc_surface_base_get_hidden(oc_surface_base* surface)
+{
+    return (surface->view.hidden);
+}
+
+void oc_surface_base_set_hidden(oc_surface_base* surface, bool hidden)
+{
+    surface->view.hidden = hidden;
+}
+
+void oc_surface_base_cleanup(oc_surface_base* surface)
+{
+    oc_list_remove(&surface->view.parent->headless.surfaces, &surface->view.listElt);
+}
+
+void oc_surface_base_init_for_window(oc_surface_base* surface, oc_window_data* window)
+{
+    surface->getSize = oc_surface_base_get_size;
+    surface->contentsScaling = oc_surface_base_contents_scaling;
+    surface->bringToFront = oc_surface_base_bring_to_front;
+    surface->sendToBack = oc_surface_base_send_to_back;
+    surface->getHidden = oc_surface_base_get_hidden;
+    surface->setHidden = oc_surface_base_set_hidden;
+
+    surface->view.parent = window;
+    oc_list_push_front(&window->headless.surfaces, &surface->view.listElt);
+}
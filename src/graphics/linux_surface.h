@@ -0,0 +1,21 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "util/lists.h"
+
+typedef struct oc_window_data oc_window_data;
+
+//NOTE: headless views are not backed by anything, they just track their parent window
+typedef struct oc_view
+{
+    oc_list_links listElt;
+    oc_window_data* parent;
+    bool hidden;
+
+} oc_view;
@@ -70,6 +70,8 @@ void oc_canvas_renderer_submit(oc_canvas_renderer renderer,
                                oc_color clearColor,
                                u32 primitiveCount,
                                oc_primitive* primitives,
+                               u32 attributeCount,
+                               oc_attributes* attributes,
                                u32 eltCount,
                                oc_path_elt* elements)
 {
@@ -80,6 +82,8 @@ void oc_canvas_renderer_submit(oc_canvas_renderer renderer,
                                        &clearColor,
                                        primitiveCount,
                                        primitives,
+                                       attributeCount,
+                                       attributes,
                                        eltCount,
                                        elements);
 }
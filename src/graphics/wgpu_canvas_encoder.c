@@ -0,0 +1,1589 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include <stdatomic.h>
+
+#include "wgpu_canvas_encoder.h"
+#include "platform/platform_thread.h"
+#include "platform/platform_trace.h"
+
+enum
+{
+    OC_WGPU_CANVAS_ENCODER_MAX_THREAD_COUNT = 64,
+    OC_WGPU_CANVAS_ENCODE_CHUNK_SIZE = 64,        // number of primitives per parallel encoding job
+    OC_WGPU_CANVAS_ENCODE_WINDOW_CHUNK_COUNT = 8, // number of chunks per thread encoded before merging
+};
+
+//------------------------------------------------------------------------------------------
+// Path and element encoding
+//------------------------------------------------------------------------------------------
+
+static void oc_update_box_extents(oc_vec4* extents, oc_vec2 p)
+{
+    extents->x = oc_min(extents->x, p.x);
+    extents->y = oc_min(extents->y, p.y);
+    extents->z = oc_max(extents->z, p.x);
+    extents->w = oc_max(extents->w, p.y);
+}
+
+oc_wgpu_path_elt* oc_wgpu_canvas_push_element(oc_wgpu_canvas_encoding_context* context)
+{
+    if(context->eltCount >= context->eltCap)
+    {
+        int newCap = oc_max(OC_WGPU_CANVAS_BUFFER_DEFAULT_LEN, (int)(context->eltCap * 1.5));
+        while(context->eltCount >= newCap)
+        {
+            newCap = (int)(newCap * 1.5);
+        }
+        oc_wgpu_path_elt* elements = oc_arena_push_array(context->arena, oc_wgpu_path_elt, newCap);
+        if(context->eltCount)
+        {
+            memcpy(elements, context->elementData, context->eltCount * sizeof(oc_wgpu_path_elt));
+        }
+
+        context->elementData = elements;
+        context->eltCap = newCap;
+    }
+
+    oc_wgpu_path_elt* elt = &context->elementData[context->eltCount];
+    context->eltCount++;
+    return (elt);
+}
+
+oc_wgpu_path* oc_wgpu_canvas_push_path(oc_wgpu_canvas_encoding_context* context)
+{
+    if(context->pathCount >= context->pathCap)
+    {
+        int newCap = oc_max(OC_WGPU_CANVAS_BUFFER_DEFAULT_LEN, (int)(context->pathCap * 1.5));
+        while(context->pathCount >= newCap)
+        {
+            newCap = (int)(newCap * 1.5);
+        }
+        oc_wgpu_path* paths = oc_arena_push_array(context->arena, oc_wgpu_path, newCap);
+        if(context->pathCount)
+        {
+            memcpy(paths, context->pathData, context->pathCount * sizeof(oc_wgpu_path));
+        }
+
+        context->pathData = paths;
+        context->pathCap = newCap;
+    }
+
+    oc_wgpu_path* path = &context->pathData[context->pathCount];
+    context->pathCount++;
+    return (path);
+}
+
+static void oc_wgpu_canvas_encode_element(oc_wgpu_canvas_encoding_context* context, oc_path_elt_type kind, oc_vec2* p)
+{
+    oc_wgpu_path_elt* elt = oc_wgpu_canvas_push_element(context);
+    if(elt)
+    {
+        elt->pathIndex = context->pathCount;
+        int count = 0;
+        elt->kind = kind;
+
+        int maxSegmentCount = 0;
+        switch(kind)
+        {
+            case OC_PATH_LINE:
+                maxSegmentCount = 1;
+                count = 2;
+                break;
+
+            case OC_PATH_QUADRATIC:
+                maxSegmentCount = 3;
+                count = 3;
+                break;
+
+            case OC_PATH_CUBIC:
+                maxSegmentCount = 7;
+                count = 4;
+                break;
+
+            default:
+                break;
+        }
+        context->maxSegmentCount += maxSegmentCount;
+
+        oc_vec4 segBox = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+        for(int i = 0; i < count; i++)
+        {
+            oc_update_box_extents(&context->pathUserExtents, p[i]);
+
+            oc_vec2 screenP = oc_mat2x3_mul(context->attributes->transform, p[i]);
+
+            elt->p[i] = (oc_vec2){ screenP.x * context->scale.x, screenP.y * context->scale.y };
+
+            oc_update_box_extents(&context->pathScreenExtents, screenP);
+            oc_update_box_extents(&segBox, screenP);
+        }
+
+        //NOTE: we make a conservative guess. An element can never use more tile ops than the number of tiles it covers
+        // times the number of segments it can produce.
+
+        int firstTileX = segBox.x * context->scale.x / context->tileSize;
+        int firstTileY = segBox.y * context->scale.y / context->tileSize;
+        int lastTileX = segBox.z * context->scale.x / context->tileSize;
+        int lastTileY = segBox.w * context->scale.y / context->tileSize;
+
+        int nTilesX = lastTileX - firstTileX + 1;
+        int nTilesY = lastTileY - firstTileY + 1;
+
+        context->maxTileOpCount += (nTilesX * nTilesY) * maxSegmentCount;
+    }
+}
+
+void oc_wgpu_canvas_encode_path(oc_wgpu_canvas_encoding_context* context, oc_primitive* primitive)
+{
+    oc_wgpu_path* path = oc_wgpu_canvas_push_path(context);
+    oc_attributes* attributes = context->attributes;
+
+    if(path)
+    {
+        //NOTE: rect primitives are encoded as regular fills
+        path->cmd = (primitive->cmd == OC_CMD_STROKE) ? OC_CMD_STROKE : OC_CMD_FILL;
+
+        //NOTE:
+        //      We clamp boxes to int range so that they can be used to compute
+        //      integer tile coordinate without cast overflow. Since extents
+        //      specify top-left, bottom-right (not width/height), we can clamp
+        //      each component separately.
+
+        const f32 bound = (f32)(1 << 14);
+
+        path->box = (oc_vec4){
+            oc_clamp(context->pathScreenExtents.x * context->scale.x, -bound, bound),
+            oc_clamp(context->pathScreenExtents.y * context->scale.y, -bound, bound),
+            oc_clamp(context->pathScreenExtents.z * context->scale.x, -bound, bound),
+            oc_clamp(context->pathScreenExtents.w * context->scale.y, -bound, bound),
+        };
+
+        path->clip = (oc_vec4){
+            oc_clamp(attributes->clip.x * context->scale.x, -bound, bound),
+            oc_clamp(attributes->clip.y * context->scale.y, -bound, bound),
+            oc_clamp((attributes->clip.x + attributes->clip.w) * context->scale.x, -bound, bound),
+            oc_clamp((attributes->clip.y + attributes->clip.h) * context->scale.y, -bound, bound),
+        };
+
+        for(int i = 0; i < 4; i++)
+        {
+            //NOTE: the first color is stored in the primitive
+            oc_color c = oc_color_convert(i ? attributes->colors[i] : primitive->color, OC_COLOR_SPACE_RGB);
+            memcpy(path->colors[i].c, c.c, 4 * sizeof(f32));
+        }
+        path->hasGradient = attributes->hasGradient;
+        path->blendSpace = attributes->blendSpace;
+
+        if(!oc_image_is_nil(attributes->image) || attributes->hasGradient)
+        {
+            oc_vec2 texSize;
+            oc_rect srcRegion;
+            if(!oc_image_is_nil(attributes->image))
+            {
+                texSize = oc_image_size(attributes->image);
+                srcRegion = attributes->srcRegion;
+            }
+            else
+            {
+                texSize = (oc_vec2){ 1, 1 };
+                srcRegion = (oc_rect){ 0, 0, 1, 1 };
+            }
+
+            oc_rect destRegion = {
+                context->pathUserExtents.x,
+                context->pathUserExtents.y,
+                (context->pathUserExtents.z - context->pathUserExtents.x),
+                (context->pathUserExtents.w - context->pathUserExtents.y),
+            };
+
+            oc_mat2x3 srcRegionToImage = {
+                1 / texSize.x, 0, srcRegion.x / texSize.x,
+                0, 1 / texSize.y, srcRegion.y / texSize.y
+            };
+
+            oc_mat2x3 destRegionToSrcRegion = {
+                srcRegion.w / destRegion.w, 0, 0,
+                0, srcRegion.h / destRegion.h, 0
+            };
+
+            oc_mat2x3 userToDestRegion = {
+                1, 0, -destRegion.x,
+                0, 1, -destRegion.y
+            };
+
+            oc_mat2x3 scaleM = {
+                context->scale.x, 0, 0,
+                0, context->scale.y, 0
+            };
+            oc_mat2x3 userToScreen = oc_mat2x3_mul_m(scaleM, attributes->transform);
+            oc_mat2x3 screenToUser = oc_mat2x3_inv(userToScreen); //TODO should have scale here
+
+            oc_mat2x3 uvTransform = srcRegionToImage;
+            uvTransform = oc_mat2x3_mul_m(uvTransform, destRegionToSrcRegion);
+            uvTransform = oc_mat2x3_mul_m(uvTransform, userToDestRegion);
+            uvTransform = oc_mat2x3_mul_m(uvTransform, screenToUser);
+
+            //NOTE: mat3 layout is an array of oc_vec3, which are padded to _oc_vec4_ alignment
+            path->uvTransform[0] = uvTransform.m[0];
+            path->uvTransform[1] = uvTransform.m[3];
+            path->uvTransform[2] = 0;
+            path->uvTransform[3] = 0;
+            path->uvTransform[4] = uvTransform.m[1];
+            path->uvTransform[5] = uvTransform.m[4];
+            path->uvTransform[6] = 0;
+            path->uvTransform[7] = 0;
+            path->uvTransform[8] = uvTransform.m[2];
+            path->uvTransform[9] = uvTransform.m[5];
+            path->uvTransform[10] = 1;
+            path->uvTransform[11] = 0;
+
+            path->textureID = context->currentImageIndex;
+        }
+        else
+        {
+            path->textureID = -1;
+        }
+
+        int firstTileX = path->box.x / context->tileSize;
+        int firstTileY = path->box.y / context->tileSize;
+        int lastTileX = path->box.z / context->tileSize;
+        int lastTileY = path->box.w / context->tileSize;
+
+        int nTilesX = lastTileX - firstTileX + 1;
+        int nTilesY = lastTileY - firstTileY + 1;
+
+        context->maxBinQueueCount += (nTilesX * nTilesY);
+
+        //NOTE: each tile covered by a path may have one start and end op, or one fill op
+        context->maxTileOpCount += (nTilesX * nTilesY) * 2;
+    }
+}
+
+static bool oc_intersect_hull_legs(oc_vec2 p0, oc_vec2 p1, oc_vec2 p2, oc_vec2 p3, oc_vec2* intersection)
+{
+    /*NOTE: check intersection of lines (p0-p1) and (p2-p3)
+
+		P = p0 + u(p1-p0)
+		P = p2 + w(p3-p2)
+	*/
+    bool found = false;
+
+    f32 den = (p0.x - p1.x) * (p2.y - p3.y) - (p0.y - p1.y) * (p2.x - p3.x);
+    if(fabs(den) > 0.0001)
+    {
+        f32 u = ((p0.x - p2.x) * (p2.y - p3.y) - (p0.y - p2.y) * (p2.x - p3.x)) / den;
+        f32 w = ((p0.x - p2.x) * (p0.y - p1.y) - (p0.y - p2.y) * (p0.x - p1.x)) / den;
+
+        intersection->x = p0.x + u * (p1.x - p0.x);
+        intersection->y = p0.y + u * (p1.y - p0.y);
+        found = true;
+    }
+    return (found);
+}
+
+static bool oc_offset_hull(int count, oc_vec2* p, oc_vec2* result, f32 offset)
+{
+    //NOTE: we should have no more than two coincident points here. This means the leg between
+    //      those two points can't be offset, but we can set a double point at the start of first leg,
+    //      end of first leg, or we can join the first and last leg to create a missing middle one
+
+    oc_vec2 legs[3][2] = { 0 };
+    bool valid[3] = { 0 };
+
+    for(int i = 0; i < count - 1; i++)
+    {
+        oc_vec2 n = { p[i].y - p[i + 1].y,
+                      p[i + 1].x - p[i].x };
+
+        f32 norm = sqrt(n.x * n.x + n.y * n.y);
+        if(norm >= 1e-6)
+        {
+            n = oc_vec2_mul(offset / norm, n);
+            legs[i][0] = oc_vec2_add(p[i], n);
+            legs[i][1] = oc_vec2_add(p[i + 1], n);
+            valid[i] = true;
+        }
+    }
+
+    //NOTE: now we find intersections
+
+    // first point is either the start of the first or second leg
+    if(valid[0])
+    {
+        result[0] = legs[0][0];
+    }
+    else
+    {
+        OC_ASSERT(valid[1]);
+        result[0] = legs[1][0];
+    }
+
+    for(int i = 1; i < count - 1; i++)
+    {
+        //NOTE: we're computing the control point i, at the end of leg (i-1)
+
+        if(!valid[i - 1])
+        {
+            OC_ASSERT(valid[i]);
+            result[i] = legs[i][0];
+        }
+        else if(!valid[i])
+        {
+            OC_ASSERT(valid[i - 1]);
+            result[i] = legs[i - 1][0];
+        }
+        else
+        {
+            if(!oc_intersect_hull_legs(legs[i - 1][0], legs[i - 1][1], legs[i][0], legs[i][1], &result[i]))
+            {
+                // legs don't intersect.
+                return (false);
+            }
+        }
+    }
+
+    if(valid[count - 2])
+    {
+        result[count - 1] = legs[count - 2][1];
+    }
+    else
+    {
+        OC_ASSERT(valid[count - 3]);
+        result[count - 1] = legs[count - 3][1];
+    }
+
+    return (true);
+}
+
+static oc_vec2 oc_quadratic_get_point(oc_vec2 p[3], f32 t)
+{
+    oc_vec2 r;
+
+    f32 oneMt = 1 - t;
+    f32 oneMt2 = oc_square(oneMt);
+    f32 t2 = oc_square(t);
+
+    r.x = oneMt2 * p[0].x + 2 * oneMt * t * p[1].x + t2 * p[2].x;
+    r.y = oneMt2 * p[0].y + 2 * oneMt * t * p[1].y + t2 * p[2].y;
+
+    return (r);
+}
+
+static void oc_quadratic_split(oc_vec2 p[3], f32 t, oc_vec2 outLeft[3], oc_vec2 outRight[3])
+{
+    //NOTE(martin): split bezier curve p at parameter t, using De Casteljau's algorithm
+    //              the q_n are the points along the hull's segments at parameter t
+    //              s is the split point.
+
+    f32 oneMt = 1 - t;
+
+    oc_vec2 q0 = { oneMt * p[0].x + t * p[1].x,
+                   oneMt * p[0].y + t * p[1].y };
+
+    oc_vec2 q1 = { oneMt * p[1].x + t * p[2].x,
+                   oneMt * p[1].y + t * p[2].y };
+
+    oc_vec2 s = { oneMt * q0.x + t * q1.x,
+                  oneMt * q0.y + t * q1.y };
+
+    outLeft[0] = p[0];
+    outLeft[1] = q0;
+    outLeft[2] = s;
+
+    outRight[0] = s;
+    outRight[1] = q1;
+    outRight[2] = p[2];
+}
+
+static oc_vec2 oc_cubic_get_point(oc_vec2 p[4], f32 t)
+{
+    oc_vec2 r;
+
+    f32 oneMt = 1 - t;
+    f32 oneMt2 = oc_square(oneMt);
+    f32 oneMt3 = oneMt2 * oneMt;
+    f32 t2 = oc_square(t);
+    f32 t3 = t2 * t;
+
+    r.x = oneMt3 * p[0].x + 3 * oneMt2 * t * p[1].x + 3 * oneMt * t2 * p[2].x + t3 * p[3].x;
+    r.y = oneMt3 * p[0].y + 3 * oneMt2 * t * p[1].y + 3 * oneMt * t2 * p[2].y + t3 * p[3].y;
+
+    return (r);
+}
+
+static void oc_cubic_split(oc_vec2 p[4], f32 t, oc_vec2 outLeft[4], oc_vec2 outRight[4])
+{
+    //NOTE(martin): split bezier curve p at parameter t, using De Casteljau's algorithm
+    //              the q_n are the points along the hull's segments at parameter t
+    //              the r_n are the points along the (q_n, q_n+1) segments at parameter t
+    //              s is the split point.
+
+    oc_vec2 q0 = { (1 - t) * p[0].x + t * p[1].x,
+                   (1 - t) * p[0].y + t * p[1].y };
+
+    oc_vec2 q1 = { (1 - t) * p[1].x + t * p[2].x,
+                   (1 - t) * p[1].y + t * p[2].y };
+
+    oc_vec2 q2 = { (1 - t) * p[2].x + t * p[3].x,
+                   (1 - t) * p[2].y + t * p[3].y };
+
+    oc_vec2 r0 = { (1 - t) * q0.x + t * q1.x,
+                   (1 - t) * q0.y + t * q1.y };
+
+    oc_vec2 r1 = { (1 - t) * q1.x + t * q2.x,
+                   (1 - t) * q1.y + t * q2.y };
+
+    oc_vec2 s = { (1 - t) * r0.x + t * r1.x,
+                  (1 - t) * r0.y + t * r1.y };
+    ;
+
+    outLeft[0] = p[0];
+    outLeft[1] = q0;
+    outLeft[2] = r0;
+    outLeft[3] = s;
+
+    outRight[0] = s;
+    outRight[1] = r1;
+    outRight[2] = q2;
+    outRight[3] = p[3];
+}
+
+void oc_wgpu_encode_stroke_line(oc_wgpu_canvas_encoding_context* context, oc_vec2* p)
+{
+    if(p[0].x == p[1].x && p[0].y == p[1].y)
+    {
+        return;
+    }
+
+    f32 width = context->attributes->width;
+
+    oc_vec2 v = { p[1].x - p[0].x, p[1].y - p[0].y };
+    oc_vec2 n = { v.y, -v.x };
+    f32 norm = sqrt(n.x * n.x + n.y * n.y);
+    oc_vec2 offset = oc_vec2_mul(0.5 * width / norm, n);
+
+    oc_vec2 left[2] = { oc_vec2_add(p[0], offset), oc_vec2_add(p[1], offset) };
+    oc_vec2 right[2] = { oc_vec2_add(p[1], oc_vec2_mul(-1, offset)), oc_vec2_add(p[0], oc_vec2_mul(-1, offset)) };
+    oc_vec2 joint0[2] = { oc_vec2_add(p[0], oc_vec2_mul(-1, offset)), oc_vec2_add(p[0], offset) };
+    oc_vec2 joint1[2] = { oc_vec2_add(p[1], offset), oc_vec2_add(p[1], oc_vec2_mul(-1, offset)) };
+
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, right);
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, left);
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, joint0);
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, joint1);
+}
+
+enum
+{
+    OC_HULL_CHECK_SAMPLE_COUNT = 5
+};
+
+void oc_wgpu_encode_stroke_quadratic(oc_wgpu_canvas_encoding_context* context, oc_vec2* p)
+{
+    f32 width = context->attributes->width;
+    f32 tolerance = oc_min(context->attributes->tolerance, 0.5 * width);
+
+    //NOTE: check for degenerate line case
+    const f32 equalEps = 1e-3;
+    if(oc_vec2_close(p[0], p[1], equalEps))
+    {
+        oc_wgpu_encode_stroke_line(context, p + 1);
+        return;
+    }
+    else if(oc_vec2_close(p[1], p[2], equalEps))
+    {
+        oc_wgpu_encode_stroke_line(context, p);
+        return;
+    }
+
+    oc_vec2 leftHull[3];
+    oc_vec2 rightHull[3];
+
+    if(!oc_offset_hull(3, p, leftHull, width / 2)
+       || !oc_offset_hull(3, p, rightHull, -width / 2))
+    {
+        //TODO split and recurse
+        //NOTE: offsetting the hull failed, split the curve
+        oc_vec2 splitLeft[3];
+        oc_vec2 splitRight[3];
+        oc_quadratic_split(p, 0.5, splitLeft, splitRight);
+        oc_wgpu_encode_stroke_quadratic(context, splitLeft);
+        oc_wgpu_encode_stroke_quadratic(context, splitRight);
+    }
+    else
+    {
+        f32 checkSamples[OC_HULL_CHECK_SAMPLE_COUNT] = { 1. / 6, 2. / 6, 3. / 6, 4. / 6, 5. / 6 };
+
+        f32 d2LowBound = oc_square(0.5 * width - tolerance);
+        f32 d2HighBound = oc_square(0.5 * width + tolerance);
+
+        f32 maxOvershoot = 0;
+        f32 maxOvershootParameter = 0;
+
+        for(int i = 0; i < OC_HULL_CHECK_SAMPLE_COUNT; i++)
+        {
+            f32 t = checkSamples[i];
+
+            oc_vec2 c = oc_quadratic_get_point(p, t);
+            oc_vec2 cp = oc_quadratic_get_point(leftHull, t);
+            oc_vec2 cn = oc_quadratic_get_point(rightHull, t);
+
+            f32 positiveDistSquare = oc_square(c.x - cp.x) + oc_square(c.y - cp.y);
+            f32 negativeDistSquare = oc_square(c.x - cn.x) + oc_square(c.y - cn.y);
+
+            f32 positiveOvershoot = oc_max(positiveDistSquare - d2HighBound, d2LowBound - positiveDistSquare);
+            f32 negativeOvershoot = oc_max(negativeDistSquare - d2HighBound, d2LowBound - negativeDistSquare);
+
+            f32 overshoot = oc_max(positiveOvershoot, negativeOvershoot);
+
+            if(overshoot > maxOvershoot)
+            {
+                maxOvershoot = overshoot;
+                maxOvershootParameter = t;
+            }
+        }
+
+        if(maxOvershoot > 0)
+        {
+            oc_vec2 splitLeft[3];
+            oc_vec2 splitRight[3];
+            oc_quadratic_split(p, maxOvershootParameter, splitLeft, splitRight);
+            oc_wgpu_encode_stroke_quadratic(context, splitLeft);
+            oc_wgpu_encode_stroke_quadratic(context, splitRight);
+        }
+        else
+        {
+            oc_vec2 tmp = leftHull[0];
+            leftHull[0] = leftHull[2];
+            leftHull[2] = tmp;
+
+            oc_wgpu_canvas_encode_element(context, OC_PATH_QUADRATIC, rightHull);
+            oc_wgpu_canvas_encode_element(context, OC_PATH_QUADRATIC, leftHull);
+
+            oc_vec2 joint0[2] = { rightHull[2], leftHull[0] };
+            oc_vec2 joint1[2] = { leftHull[2], rightHull[0] };
+            oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, joint0);
+            oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, joint1);
+        }
+    }
+}
+
+void oc_wgpu_encode_stroke_cubic(oc_wgpu_canvas_encoding_context* context, oc_vec2* p)
+{
+    f32 width = context->attributes->width;
+    f32 tolerance = oc_min(context->attributes->tolerance, 0.5 * width);
+
+    //NOTE: check degenerate line cases
+    f32 equalEps = 1e-3;
+
+    if((oc_vec2_close(p[0], p[1], equalEps) && oc_vec2_close(p[2], p[3], equalEps))
+       || (oc_vec2_close(p[0], p[1], equalEps) && oc_vec2_close(p[1], p[2], equalEps))
+       || (oc_vec2_close(p[1], p[2], equalEps) && oc_vec2_close(p[2], p[3], equalEps)))
+    {
+        oc_vec2 line[2] = { p[0], p[3] };
+        oc_wgpu_encode_stroke_line(context, line);
+        return;
+    }
+    else if(oc_vec2_close(p[0], p[1], equalEps) && oc_vec2_close(p[1], p[3], equalEps))
+    {
+        oc_vec2 line[2] = { p[0], oc_vec2_add(oc_vec2_mul(5. / 9, p[0]), oc_vec2_mul(4. / 9, p[2])) };
+        oc_wgpu_encode_stroke_line(context, line);
+        return;
+    }
+    else if(oc_vec2_close(p[0], p[2], equalEps) && oc_vec2_close(p[2], p[3], equalEps))
+    {
+        oc_vec2 line[2] = { p[0], oc_vec2_add(oc_vec2_mul(5. / 9, p[0]), oc_vec2_mul(4. / 9, p[1])) };
+        oc_wgpu_encode_stroke_line(context, line);
+        return;
+    }
+
+    oc_vec2 leftHull[4];
+    oc_vec2 rightHull[4];
+
+    if(!oc_offset_hull(4, p, leftHull, width / 2)
+       || !oc_offset_hull(4, p, rightHull, -width / 2))
+    {
+        //TODO split and recurse
+        //NOTE: offsetting the hull failed, split the curve
+        oc_vec2 splitLeft[4];
+        oc_vec2 splitRight[4];
+        oc_cubic_split(p, 0.5, splitLeft, splitRight);
+        oc_wgpu_encode_stroke_cubic(context, splitLeft);
+        oc_wgpu_encode_stroke_cubic(context, splitRight);
+    }
+    else
+    {
+        f32 checkSamples[OC_HULL_CHECK_SAMPLE_COUNT] = { 1. / 6, 2. / 6, 3. / 6, 4. / 6, 5. / 6 };
+
+        f32 d2LowBound = oc_square(0.5 * width - tolerance);
+        f32 d2HighBound = oc_square(0.5 * width + tolerance);
+
+        f32 maxOvershoot = 0;
+        f32 maxOvershootParameter = 0;
+
+        for(int i = 0; i < OC_HULL_CHECK_SAMPLE_COUNT; i++)
+        {
+            f32 t = checkSamples[i];
+
+            oc_vec2 c = oc_cubic_get_point(p, t);
+            oc_vec2 cp = oc_cubic_get_point(leftHull, t);
+            oc_vec2 cn = oc_cubic_get_point(rightHull, t);
+
+            f32 positiveDistSquare = oc_square(c.x - cp.x) + oc_square(c.y - cp.y);
+            f32 negativeDistSquare = oc_square(c.x - cn.x) + oc_square(c.y - cn.y);
+
+            f32 positiveOvershoot = oc_max(positiveDistSquare - d2HighBound, d2LowBound - positiveDistSquare);
+            f32 negativeOvershoot = oc_max(negativeDistSquare - d2HighBound, d2LowBound - negativeDistSquare);
+
+            f32 overshoot = oc_max(positiveOvershoot, negativeOvershoot);
+
+            if(overshoot > maxOvershoot)
+            {
+                maxOvershoot = overshoot;
+                maxOvershootParameter = t;
+            }
+        }
+
+        if(maxOvershoot > 0)
+        {
+            oc_vec2 splitLeft[4];
+            oc_vec2 splitRight[4];
+            oc_cubic_split(p, maxOvershootParameter, splitLeft, splitRight);
+            oc_wgpu_encode_stroke_cubic(context, splitLeft);
+            oc_wgpu_encode_stroke_cubic(context, splitRight);
+        }
+        else
+        {
+            oc_vec2 tmp = leftHull[0];
+            leftHull[0] = leftHull[3];
+            leftHull[3] = tmp;
+            tmp = leftHull[1];
+            leftHull[1] = leftHull[2];
+            leftHull[2] = tmp;
+
+            oc_wgpu_canvas_encode_element(context, OC_PATH_CUBIC, rightHull);
+            oc_wgpu_canvas_encode_element(context, OC_PATH_CUBIC, leftHull);
+
+            oc_vec2 joint0[2] = { rightHull[3], leftHull[0] };
+            oc_vec2 joint1[2] = { leftHull[3], rightHull[0] };
+            oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, joint0);
+            oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, joint1);
+        }
+    }
+}
+
+void oc_wgpu_encode_stroke_element(oc_wgpu_canvas_encoding_context* context,
+                                   oc_path_elt* element,
+                                   oc_vec2 currentPoint,
+                                   oc_vec2* startTangent,
+                                   oc_vec2* endTangent,
+                                   oc_vec2* endPoint)
+{
+    oc_vec2 controlPoints[4] = { currentPoint, element->p[0], element->p[1], element->p[2] };
+    int endPointIndex = 0;
+
+    switch(element->type)
+    {
+        case OC_PATH_LINE:
+            oc_wgpu_encode_stroke_line(context, controlPoints);
+            endPointIndex = 1;
+            break;
+
+        case OC_PATH_QUADRATIC:
+            oc_wgpu_encode_stroke_quadratic(context, controlPoints);
+            endPointIndex = 2;
+            break;
+
+        case OC_PATH_CUBIC:
+            oc_wgpu_encode_stroke_cubic(context, controlPoints);
+            endPointIndex = 3;
+            break;
+
+        case OC_PATH_MOVE:
+            OC_ASSERT(0, "should be unreachable");
+            break;
+    }
+
+    //NOTE: ensure tangents are properly computed even in presence of coincident points
+    //TODO: see if we can do this in a less hacky way
+
+    for(int i = 1; i <= endPointIndex; i++)
+    {
+        if(controlPoints[i].x != controlPoints[0].x
+           || controlPoints[i].y != controlPoints[0].y)
+        {
+            *startTangent = (oc_vec2){ .x = controlPoints[i].x - controlPoints[0].x,
+                                       .y = controlPoints[i].y - controlPoints[0].y };
+            break;
+        }
+    }
+    *endPoint = controlPoints[endPointIndex];
+
+    for(int i = endPointIndex - 1; i >= 0; i--)
+    {
+        if(controlPoints[i].x != endPoint->x
+           || controlPoints[i].y != endPoint->y)
+        {
+            *endTangent = (oc_vec2){ .x = endPoint->x - controlPoints[i].x,
+                                     .y = endPoint->y - controlPoints[i].y };
+            break;
+        }
+    }
+    OC_DEBUG_ASSERT(startTangent->x != 0 || startTangent->y != 0);
+}
+
+void oc_wgpu_stroke_cap(oc_wgpu_canvas_encoding_context* context,
+                        oc_vec2 p0,
+                        oc_vec2 direction)
+{
+    oc_attributes* attributes = context->attributes;
+
+    //NOTE(martin): compute the tangent and normal vectors (multiplied by half width) at the cap point
+    f32 dn = sqrt(oc_square(direction.x) + oc_square(direction.y));
+    f32 alpha = 0.5 * attributes->width / dn;
+
+    oc_vec2 n0 = { -alpha * direction.y,
+                   alpha * direction.x };
+
+    oc_vec2 m0 = { alpha * direction.x,
+                   alpha * direction.y };
+
+    oc_vec2 points[] = { { p0.x + n0.x, p0.y + n0.y },
+                         { p0.x + n0.x + m0.x, p0.y + n0.y + m0.y },
+                         { p0.x - n0.x + m0.x, p0.y - n0.y + m0.y },
+                         { p0.x - n0.x, p0.y - n0.y },
+                         { p0.x + n0.x, p0.y + n0.y } };
+
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points);
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 1);
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 2);
+    oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 3);
+}
+
+void oc_wgpu_stroke_joint(oc_wgpu_canvas_encoding_context* context,
+                          oc_vec2 p0,
+                          oc_vec2 t0,
+                          oc_vec2 t1)
+{
+    oc_attributes* attributes = context->attributes;
+
+    //NOTE(martin): compute the normals at the joint point
+    f32 norm_t0 = sqrt(oc_square(t0.x) + oc_square(t0.y));
+    f32 norm_t1 = sqrt(oc_square(t1.x) + oc_square(t1.y));
+
+    oc_vec2 n0 = { -t0.y, t0.x };
+    n0.x /= norm_t0;
+    n0.y /= norm_t0;
+
+    oc_vec2 n1 = { -t1.y, t1.x };
+    n1.x /= norm_t1;
+    n1.y /= norm_t1;
+
+    //NOTE(martin): the sign of the cross product determines if the normals are facing outwards or inwards the angle.
+    //              we flip them to face outwards if needed
+    f32 crossZ = n0.x * n1.y - n0.y * n1.x;
+    if(crossZ > 0)
+    {
+        n0.x *= -1;
+        n0.y *= -1;
+        n1.x *= -1;
+        n1.y *= -1;
+    }
+
+    //NOTE(martin): use the same code as hull offset to find mitter point...
+    /*NOTE(martin): let vector u = (n0+n1) and vector v = pIntersect - p1
+		then v = u * (2*offset / norm(u)^2)
+		(this can be derived from writing the pythagoras theorems in the triangles of the joint)
+	*/
+    f32 halfW = 0.5 * attributes->width;
+    oc_vec2 u = { n0.x + n1.x, n0.y + n1.y };
+    f32 uNormSquare = u.x * u.x + u.y * u.y;
+    f32 alpha = attributes->width / uNormSquare;
+    oc_vec2 v = { u.x * alpha, u.y * alpha };
+
+    f32 excursionSquare = uNormSquare * oc_square(alpha - attributes->width / 4);
+
+    if(attributes->joint == OC_JOINT_MITER
+       && excursionSquare <= oc_square(attributes->maxJointExcursion))
+    {
+        //NOTE(martin): add a mitter joint
+        oc_vec2 points[] = { p0,
+                             { p0.x + n0.x * halfW, p0.y + n0.y * halfW },
+                             { p0.x + v.x, p0.y + v.y },
+                             { p0.x + n1.x * halfW, p0.y + n1.y * halfW },
+                             p0 };
+
+        oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points);
+        oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 1);
+        oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 2);
+        oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 3);
+    }
+    else
+    {
+        //NOTE(martin): add a bevel joint
+        oc_vec2 points[] = { p0,
+                             { p0.x + n0.x * halfW, p0.y + n0.y * halfW },
+                             { p0.x + n1.x * halfW, p0.y + n1.y * halfW },
+                             p0 };
+
+        oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points);
+        oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 1);
+        oc_wgpu_canvas_encode_element(context, OC_PATH_LINE, points + 2);
+    }
+}
+
+bool oc_wgpu_is_stroke_element_null(oc_vec2 currentPoint, oc_path_elt* element)
+{
+    i32 count = 0;
+    switch(element->type)
+    {
+        case OC_PATH_MOVE:
+            count = 0;
+            break;
+
+        case OC_PATH_LINE:
+            count = 1;
+            break;
+
+        case OC_PATH_QUADRATIC:
+            count = 2;
+            break;
+
+        case OC_PATH_CUBIC:
+            count = 3;
+            break;
+    }
+    bool allCoincidents = (currentPoint.x == element->p[0].x)
+                       && (currentPoint.y == element->p[0].y);
+
+    if(allCoincidents)
+    {
+        for(i32 i = 0; i < count - 1; i++)
+        {
+            if(element->p[i].x != element->p[i + 1].x
+               || element->p[i].y != element->p[i + 1].y)
+            {
+                allCoincidents = false;
+                break;
+            }
+        }
+    }
+    return allCoincidents;
+}
+
+u32 oc_wgpu_encode_stroke_subpath(oc_wgpu_canvas_encoding_context* context,
+                                  oc_path_elt* elements,
+                                  oc_path_descriptor* path,
+                                  u32 startIndex,
+                                  oc_vec2 startPoint)
+{
+    u32 eltCount = path->count;
+    OC_DEBUG_ASSERT(startIndex < eltCount);
+
+    oc_vec2 currentPoint = startPoint;
+    oc_vec2 endPoint = { 0, 0 };
+    oc_vec2 previousEndTangent = { 0, 0 };
+    oc_vec2 firstTangent = { 0, 0 };
+    oc_vec2 startTangent = { 0, 0 };
+    oc_vec2 endTangent = { 0, 0 };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    //TODO: review this code, see if we can gracefully handle coincident points / zero-length elements
+    //      or skip them less verbosely.
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    //NOTE skip elements that produce null tangents (these are degenerate zero length elements).
+    u32 eltIndex = startIndex;
+    while(eltIndex < eltCount
+          && elements[eltIndex].type != OC_PATH_MOVE
+          && oc_wgpu_is_stroke_element_null(currentPoint, elements + eltIndex))
+    {
+        eltIndex++;
+    }
+    if(eltIndex >= eltCount || elements[eltIndex].type == OC_PATH_MOVE)
+    {
+        return eltIndex;
+    }
+
+    //NOTE(martin): encode first element and compute first tangent.
+    oc_wgpu_encode_stroke_element(context, elements + eltIndex, currentPoint, &startTangent, &endTangent, &endPoint);
+    eltIndex++;
+
+    firstTangent = startTangent;
+    previousEndTangent = endTangent;
+    currentPoint = endPoint;
+
+    //NOTE(martin): encode subsequent elements along with their joints
+    oc_attributes* attributes = context->attributes;
+
+    while(eltIndex < eltCount && elements[eltIndex].type != OC_PATH_MOVE)
+    {
+        //NOTE skip elements that produce null tangents (these are degenerate zero length elements).
+        while(eltIndex < eltCount
+              && elements[eltIndex].type != OC_PATH_MOVE
+              && oc_wgpu_is_stroke_element_null(currentPoint, elements + eltIndex))
+        {
+            eltIndex++;
+        }
+        if(eltIndex >= eltCount || elements[eltIndex].type == OC_PATH_MOVE)
+        {
+            break;
+        }
+
+        oc_wgpu_encode_stroke_element(context, elements + eltIndex, currentPoint, &startTangent, &endTangent, &endPoint);
+
+        if(attributes->joint != OC_JOINT_NONE)
+        {
+            oc_wgpu_stroke_joint(context, currentPoint, previousEndTangent, startTangent);
+        }
+        previousEndTangent = endTangent;
+        currentPoint = endPoint;
+
+        eltIndex++;
+    }
+    u32 subPathEltCount = eltIndex - startIndex;
+
+    //NOTE(martin): draw end cap / joint. We ensure there's at least two segments to draw a closing joint
+    if(subPathEltCount > 1
+       && startPoint.x == endPoint.x
+       && startPoint.y == endPoint.y)
+    {
+        if(attributes->joint != OC_JOINT_NONE)
+        {
+            //NOTE(martin): add a closing joint if the path is closed
+            oc_wgpu_stroke_joint(context, endPoint, endTangent, firstTangent);
+        }
+    }
+    else if(attributes->cap == OC_CAP_SQUARE)
+    {
+        //NOTE(martin): add start and end cap
+        oc_wgpu_stroke_cap(context, startPoint, (oc_vec2){ -startTangent.x, -startTangent.y });
+        oc_wgpu_stroke_cap(context, endPoint, endTangent);
+    }
+    return (eltIndex);
+}
+
+void oc_wgpu_encode_stroke(oc_wgpu_canvas_encoding_context* context,
+                           oc_path_elt* elements,
+                           oc_path_descriptor* path)
+{
+    u32 eltCount = path->count;
+    OC_DEBUG_ASSERT(eltCount);
+
+    oc_vec2 startPoint = path->startPoint;
+    u32 startIndex = 0;
+
+    while(startIndex < eltCount)
+    {
+        //NOTE(martin): eliminate leading moves
+        while(startIndex < eltCount && elements[startIndex].type == OC_PATH_MOVE)
+        {
+            startPoint = elements[startIndex].p[0];
+            startIndex++;
+        }
+        if(startIndex < eltCount)
+        {
+            startIndex = oc_wgpu_encode_stroke_subpath(context, elements, path, startIndex, startPoint);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------------------
+// Primitive encoding
+//------------------------------------------------------------------------------------------
+
+static oc_vec2 oc_wgpu_canvas_elt_end_point(oc_path_elt* elt)
+{
+    switch(elt->type)
+    {
+        case OC_PATH_QUADRATIC:
+            return (elt->p[1]);
+        case OC_PATH_CUBIC:
+            return (elt->p[2]);
+        default:
+            return (elt->p[0]);
+    }
+}
+
+static u32 oc_wgpu_canvas_primitive_elements(oc_wgpu_canvas_encoding_context* context,
+                                             oc_primitive* primitive,
+                                             oc_path_elt* rectElements,
+                                             oc_path_elt** elements)
+{
+    //NOTE: rect primitives are expanded to path elements here
+    u32 eltCount = 0;
+    *elements = 0;
+
+    if(primitive->cmd == OC_CMD_RECT_FILL)
+    {
+        *elements = rectElements;
+        eltCount = oc_rect_primitive_elements(primitive, rectElements);
+    }
+    else if(primitive->path.startIndex < context->inputEltCount)
+    {
+        *elements = context->inputElements + primitive->path.startIndex;
+        eltCount = oc_min(primitive->path.count, context->inputEltCount - primitive->path.startIndex);
+    }
+    return (eltCount);
+}
+
+static bool oc_wgpu_canvas_bind_image(oc_wgpu_canvas_encoding_context* context, oc_attributes* attributes)
+{
+    if(attributes->image.h != 0)
+    {
+        context->currentImageIndex = -1;
+        for(int i = 0; i < context->imageCount; i++)
+        {
+            if(context->imageBindings[i].h == attributes->image.h)
+            {
+                context->currentImageIndex = i;
+            }
+        }
+        if(context->currentImageIndex <= 0)
+        {
+            if(context->imageCount < OC_WGPU_CANVAS_MAX_IMAGE_BINDINGS)
+            {
+                context->imageBindings[context->imageCount] = attributes->image;
+                context->currentImageIndex = context->imageCount;
+                context->imageCount++;
+            }
+            else
+            {
+                return (false);
+            }
+        }
+    }
+    else
+    {
+        context->currentImageIndex = -1;
+    }
+    return (true);
+}
+
+//NOTE: encodes the elements and path of a primitive. currentPos is the end point of the previous fill,
+//      and is updated by fills. Returns false if the primitive has no elements.
+static bool oc_wgpu_canvas_encode_primitive(oc_wgpu_canvas_encoding_context* context,
+                                            oc_primitive* primitive,
+                                            oc_attributes* attributes,
+                                            oc_vec2* currentPos)
+{
+    oc_path_elt rectElements[OC_RECT_PRIMITIVE_MAX_ELEMENT_COUNT];
+    oc_path_elt* elements = 0;
+    u32 eltCount = oc_wgpu_canvas_primitive_elements(context, primitive, rectElements, &elements);
+
+    if(eltCount)
+    {
+        context->primitive = primitive;
+        context->attributes = attributes;
+        context->pathScreenExtents = (oc_vec4){ FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+        context->pathUserExtents = (oc_vec4){ FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+        if(primitive->cmd == OC_CMD_STROKE)
+        {
+            oc_wgpu_encode_stroke(context, elements, &primitive->path);
+        }
+        else
+        {
+            for(int eltIndex = 0; eltIndex < eltCount; eltIndex++)
+            {
+                oc_path_elt* elt = &elements[eltIndex];
+
+                if(elt->type != OC_PATH_MOVE)
+                {
+                    oc_vec2 p[4] = { *currentPos, elt->p[0], elt->p[1], elt->p[2] };
+                    oc_wgpu_canvas_encode_element(context, elt->type, p);
+                }
+                *currentPos = oc_wgpu_canvas_elt_end_point(elt);
+            }
+        }
+        oc_wgpu_canvas_encode_path(context, primitive);
+    }
+    return (eltCount != 0);
+}
+
+static bool oc_wgpu_canvas_exceeds_limits(oc_wgpu_canvas_encoding_context* context)
+{
+    u64 bufferLimit = context->bufferLimit;
+    u64 maxTileQueues = oc_min(context->maxBinQueueCount, context->screenTilesCount);
+
+    return (context->pathCount * sizeof(oc_wgpu_path) >= bufferLimit
+            || context->eltCount * sizeof(oc_wgpu_path_elt) >= bufferLimit
+            || context->maxSegmentCount * sizeof(oc_wgpu_segment) >= bufferLimit
+            || context->pathCount * sizeof(oc_wgpu_path_bin) >= bufferLimit
+            || context->maxBinQueueCount * sizeof(oc_wgpu_bin_queue) >= bufferLimit
+            || maxTileQueues * sizeof(oc_wgpu_tile_queue) >= bufferLimit
+            || context->maxTileOpCount * sizeof(oc_wgpu_tile_op) >= bufferLimit);
+}
+
+//NOTE: returns the number of input primitives consumed by the batch
+static u32 oc_wgpu_canvas_encode_primitives_serial(oc_wgpu_canvas_encoding_context* context)
+{
+    // should be conveyed from one batch to the other
+    oc_vec2 currentPos = (oc_vec2){ 0, 0 };
+
+    u32 primitiveIndex = 0;
+    for(; primitiveIndex + context->pathBatchStart < context->inputPrimitiveCount; primitiveIndex++)
+    {
+        oc_primitive* primitive = &context->inputPrimitives[context->pathBatchStart + primitiveIndex];
+
+        if(primitive->attributesIndex >= context->inputAttributeCount)
+        {
+            oc_log_error("primitive references an invalid attributes block\n");
+            continue;
+        }
+        oc_attributes* attributes = &context->inputAttributes[primitive->attributesIndex];
+
+        if(!oc_wgpu_canvas_bind_image(context, attributes))
+        {
+            break;
+        }
+
+        u32 lastPathCount = context->pathCount;
+        u32 lastEltCount = context->eltCount;
+        u32 lastMaxSegmentCount = context->maxSegmentCount;
+        u32 lastMaxBinQueueCount = context->maxBinQueueCount;
+        u32 lastMaxTileOpCount = context->maxTileOpCount;
+
+        if(oc_wgpu_canvas_encode_primitive(context, primitive, attributes, &currentPos)
+           && oc_wgpu_canvas_exceeds_limits(context))
+        {
+            //NOTE: if batch overflows max GPU buffer size, rewind to last path and break the batch here.
+            context->pathCount = lastPathCount;
+            context->eltCount = lastEltCount;
+            context->maxSegmentCount = lastMaxSegmentCount;
+            context->maxBinQueueCount = lastMaxBinQueueCount;
+            context->maxTileOpCount = lastMaxTileOpCount;
+            //TODO flush counter?
+            break;
+        }
+    }
+    return (primitiveIndex);
+}
+
+//------------------------------------------------------------------------------------------
+// Parallel encoding
+//------------------------------------------------------------------------------------------
+//NOTE: primitives are encoded in windows of a few chunks per thread. The primitives of a window
+//      are first walked serially to assign image bindings, find where the batch ends if it runs
+//      out of bindings, and record the current position each primitive starts from. Chunks of
+//      consecutive primitives are then encoded by the worker threads into their own path and
+//      element arrays, and merged serially in primitive order. Buffer limits are checked during
+//      the merge, so batches are split at the same primitive as the serial encoder, and the output
+//      is the same. Windows bound the work that is thrown away when a batch is split.
+
+typedef struct oc_wgpu_canvas_encoded_primitive
+{
+    //NOTE: set by the serial pass
+    bool valid;
+    i32 imageIndex;
+    u32 imageCount;
+    oc_vec2 startPos;
+
+    //NOTE: set by the worker that encoded the primitive
+    bool encoded;
+    u32 workerIndex;
+    u32 pathIndex;
+    u32 firstElt;
+    u32 eltCount;
+    u32 maxSegmentCount;
+    u32 maxBinQueueCount;
+    u32 maxTileOpCount;
+
+} oc_wgpu_canvas_encoded_primitive;
+
+typedef struct oc_wgpu_canvas_encode_worker
+{
+    oc_wgpu_canvas_encoder* encoder;
+    u32 index;
+    oc_thread* thread;
+    oc_arena arena;
+    oc_wgpu_canvas_encoding_context context;
+
+} oc_wgpu_canvas_encode_worker;
+
+typedef struct oc_wgpu_canvas_encoder
+{
+    u32 threadCount;
+    oc_wgpu_canvas_encode_worker workers[OC_WGPU_CANVAS_ENCODER_MAX_THREAD_COUNT];
+
+    oc_mutex* mutex;
+    oc_condition* startCond;
+    oc_condition* doneCond;
+    u64 generation;
+    u32 busyCount;
+    bool quit;
+    _Atomic(u32) nextChunk;
+
+    //NOTE: current window
+    oc_wgpu_canvas_encoding_context* context;
+    u32 primitiveStart; // relative to context->pathBatchStart
+    u32 primitiveCount;
+    oc_wgpu_canvas_encoded_primitive* records;
+
+} oc_wgpu_canvas_encoder;
+
+static void oc_wgpu_canvas_encode_chunks(oc_wgpu_canvas_encode_worker* worker)
+{
+    oc_wgpu_canvas_encoder* encoder = worker->encoder;
+    oc_wgpu_canvas_encoding_context* context = &worker->context;
+
+    oc_arena_clear(&worker->arena);
+
+    *context = *encoder->context;
+    context->arena = &worker->arena;
+    context->pathData = 0;
+    context->pathCap = 0;
+    context->pathCount = 0;
+    context->elementData = 0;
+    context->eltCap = 0;
+    context->eltCount = 0;
+    context->maxSegmentCount = 0;
+    context->maxBinQueueCount = 0;
+    context->maxTileOpCount = 0;
+
+    u32 chunkCount = (encoder->primitiveCount + OC_WGPU_CANVAS_ENCODE_CHUNK_SIZE - 1) / OC_WGPU_CANVAS_ENCODE_CHUNK_SIZE;
+
+    oc_trace_begin("canvas encode chunks");
+    while(true)
+    {
+        u32 chunkIndex = atomic_fetch_add(&encoder->nextChunk, 1);
+        if(chunkIndex >= chunkCount)
+        {
+            break;
+        }
+        u32 start = chunkIndex * OC_WGPU_CANVAS_ENCODE_CHUNK_SIZE;
+        u32 end = oc_min(start + OC_WGPU_CANVAS_ENCODE_CHUNK_SIZE, encoder->primitiveCount);
+
+        oc_vec2 currentPos = encoder->records[start].startPos;
+
+        for(u32 recordIndex = start; recordIndex < end; recordIndex++)
+        {
+            oc_wgpu_canvas_encoded_primitive* record = &encoder->records[recordIndex];
+            if(!record->valid)
+            {
+                continue;
+            }
+            oc_primitive* primitive = &context->inputPrimitives[context->pathBatchStart + encoder->primitiveStart + recordIndex];
+            oc_attributes* attributes = &context->inputAttributes[primitive->attributesIndex];
+
+            u32 firstElt = context->eltCount;
+            u32 maxSegmentCount = context->maxSegmentCount;
+            u32 maxBinQueueCount = context->maxBinQueueCount;
+            u32 maxTileOpCount = context->maxTileOpCount;
+
+            context->currentImageIndex = record->imageIndex;
+
+            record->workerIndex = worker->index;
+            record->pathIndex = context->pathCount;
+            record->encoded = oc_wgpu_canvas_encode_primitive(context, primitive, attributes, &currentPos);
+            record->firstElt = firstElt;
+            record->eltCount = context->eltCount - firstElt;
+            record->maxSegmentCount = context->maxSegmentCount - maxSegmentCount;
+            record->maxBinQueueCount = context->maxBinQueueCount - maxBinQueueCount;
+            record->maxTileOpCount = context->maxTileOpCount - maxTileOpCount;
+        }
+    }
+    oc_trace_end();
+}
+
+static i32 oc_wgpu_canvas_encode_worker_proc(void* user)
+{
+    oc_wgpu_canvas_encode_worker* worker = (oc_wgpu_canvas_encode_worker*)user;
+    oc_wgpu_canvas_encoder* encoder = worker->encoder;
+    u64 generation = 0;
+
+    oc_mutex_lock(encoder->mutex);
+    while(true)
+    {
+        while(!encoder->quit && encoder->generation == generation)
+        {
+            oc_condition_wait(encoder->startCond, encoder->mutex);
+        }
+        if(encoder->quit)
+        {
+            break;
+        }
+        generation = encoder->generation;
+        oc_mutex_unlock(encoder->mutex);
+
+        oc_wgpu_canvas_encode_chunks(worker);
+
+        oc_mutex_lock(encoder->mutex);
+        encoder->busyCount--;
+        if(encoder->busyCount == 0)
+        {
+            oc_condition_signal(encoder->doneCond);
+        }
+    }
+    oc_mutex_unlock(encoder->mutex);
+    return (0);
+}
+
+static void oc_wgpu_canvas_reserve_output(oc_wgpu_canvas_encoding_context* context, u32 pathCount, u32 eltCount)
+{
+    if(context->pathCount + pathCount > context->pathCap)
+    {
+        u32 newCap = oc_max(context->pathCount + pathCount, (u32)(context->pathCap * 1.5));
+        oc_wgpu_path* paths = oc_arena_push_array_uninitialized(context->arena, oc_wgpu_path, newCap);
+        if(context->pathCount)
+        {
+            memcpy(paths, context->pathData, context->pathCount * sizeof(oc_wgpu_path));
+        }
+
+        context->pathData = paths;
+        context->pathCap = newCap;
+    }
+    if(context->eltCount + eltCount > context->eltCap)
+    {
+        u32 newCap = oc_max(context->eltCount + eltCount, (u32)(context->eltCap * 1.5));
+        oc_wgpu_path_elt* elements = oc_arena_push_array_uninitialized(context->arena, oc_wgpu_path_elt, newCap);
+        if(context->eltCount)
+        {
+            memcpy(elements, context->elementData, context->eltCount * sizeof(oc_wgpu_path_elt));
+        }
+
+        context->elementData = elements;
+        context->eltCap = newCap;
+    }
+}
+
+static u32 oc_wgpu_canvas_encode_primitives_parallel(oc_wgpu_canvas_encoding_context* context)
+{
+    oc_wgpu_canvas_encoder* encoder = context->encoder;
+
+    u32 remainingCount = context->inputPrimitiveCount - context->pathBatchStart;
+    u32 windowCap = encoder->threadCount * OC_WGPU_CANVAS_ENCODE_WINDOW_CHUNK_COUNT * OC_WGPU_CANVAS_ENCODE_CHUNK_SIZE;
+    oc_wgpu_canvas_encoded_primitive* records = oc_arena_push_array_uninitialized(context->arena,
+                                                                                  oc_wgpu_canvas_encoded_primitive,
+                                                                                  oc_min(windowCap, remainingCount));
+    oc_vec2 currentPos = (oc_vec2){ 0, 0 };
+    u32 primitiveIndex = 0;
+    bool done = false;
+
+    while(!done && primitiveIndex < remainingCount)
+    {
+        //NOTE: serial pass. This follows the serial encoder, except primitives are not encoded yet.
+        u32 windowStart = primitiveIndex;
+        u32 windowEnd = oc_min(windowStart + windowCap, remainingCount);
+        u32 windowCount = 0;
+
+        for(; windowStart + windowCount < windowEnd; windowCount++)
+        {
+            oc_wgpu_canvas_encoded_primitive* record = &records[windowCount];
+            memset(record, 0, sizeof(oc_wgpu_canvas_encoded_primitive));
+            record->startPos = currentPos;
+
+            oc_primitive* primitive = &context->inputPrimitives[context->pathBatchStart + windowStart + windowCount];
+
+            if(primitive->attributesIndex >= context->inputAttributeCount)
+            {
+                oc_log_error("primitive references an invalid attributes block\n");
+                continue;
+            }
+            oc_attributes* attributes = &context->inputAttributes[primitive->attributesIndex];
+
+            if(!oc_wgpu_canvas_bind_image(context, attributes))
+            {
+                done = true;
+                break;
+            }
+            record->valid = true;
+            record->imageIndex = context->currentImageIndex;
+            record->imageCount = context->imageCount;
+
+            if(primitive->cmd != OC_CMD_STROKE)
+            {
+                oc_path_elt rectElements[OC_RECT_PRIMITIVE_MAX_ELEMENT_COUNT];
+                oc_path_elt* elements = 0;
+                u32 eltCount = oc_wgpu_canvas_primitive_elements(context, primitive, rectElements, &elements);
+                if(eltCount)
+                {
+                    currentPos = oc_wgpu_canvas_elt_end_point(&elements[eltCount - 1]);
+                }
+            }
+        }
+
+        //NOTE: encode chunks in parallel
+        encoder->context = context;
+        encoder->primitiveStart = windowStart;
+        encoder->primitiveCount = windowCount;
+        encoder->records = records;
+        atomic_store(&encoder->nextChunk, 0);
+
+        oc_mutex_lock(encoder->mutex);
+        encoder->generation++;
+        encoder->busyCount = encoder->threadCount - 1;
+        oc_condition_broadcast(encoder->startCond);
+        oc_mutex_unlock(encoder->mutex);
+
+        oc_wgpu_canvas_encode_chunks(&encoder->workers[0]);
+
+        oc_mutex_lock(encoder->mutex);
+        while(encoder->busyCount)
+        {
+            oc_condition_wait(encoder->doneCond, encoder->mutex);
+        }
+        oc_mutex_unlock(encoder->mutex);
+
+        //NOTE: merge worker outputs in primitive order
+        oc_trace_begin("canvas encode merge");
+
+        u32 windowPathCount = 0;
+        u32 windowEltCount = 0;
+        for(u32 i = 0; i < encoder->threadCount; i++)
+        {
+            windowPathCount += encoder->workers[i].context.pathCount;
+            windowEltCount += encoder->workers[i].context.eltCount;
+        }
+        oc_wgpu_canvas_reserve_output(context, windowPathCount, windowEltCount);
+
+        u32 recordIndex = 0;
+        for(; recordIndex < windowCount; recordIndex++)
+        {
+            oc_wgpu_canvas_encoded_primitive* record = &records[recordIndex];
+            if(!record->encoded)
+            {
+                continue;
+            }
+
+            u32 pathIndex = context->pathCount;
+            u32 firstElt = context->eltCount;
+
+            context->pathCount += 1;
+            context->eltCount += record->eltCount;
+            context->maxSegmentCount += record->maxSegmentCount;
+            context->maxBinQueueCount += record->maxBinQueueCount;
+            context->maxTileOpCount += record->maxTileOpCount;
+
+            if(oc_wgpu_canvas_exceeds_limits(context))
+            {
+                //NOTE: if batch overflows max GPU buffer size, rewind to last path and break the batch here.
+                //      Image bindings are also rewound to what the serial encoder would have bound so far.
+                context->pathCount = pathIndex;
+                context->eltCount = firstElt;
+                context->maxSegmentCount -= record->maxSegmentCount;
+                context->maxBinQueueCount -= record->maxBinQueueCount;
+                context->maxTileOpCount -= record->maxTileOpCount;
+                context->imageCount = record->imageCount;
+                done = true;
+                break;
+            }
+
+            oc_wgpu_canvas_encoding_context* workerContext = &encoder->workers[record->workerIndex].context;
+
+            context->pathData[pathIndex] = workerContext->pathData[record->pathIndex];
+
+            oc_wgpu_path_elt* src = workerContext->elementData + record->firstElt;
+            oc_wgpu_path_elt* dst = context->elementData + firstElt;
+            for(u32 eltIndex = 0; eltIndex < record->eltCount; eltIndex++)
+            {
+                dst[eltIndex] = src[eltIndex];
+                dst[eltIndex].pathIndex = pathIndex;
+            }
+        }
+        primitiveIndex = windowStart + recordIndex;
+
+        oc_trace_end();
+    }
+    return (primitiveIndex);
+}
+
+//------------------------------------------------------------------------------------------
+// Encoder API
+//------------------------------------------------------------------------------------------
+
+oc_wgpu_canvas_encoder* oc_wgpu_canvas_encoder_create(u32 threadCount)
+{
+    oc_wgpu_canvas_encoder* encoder = oc_malloc_type(oc_wgpu_canvas_encoder);
+    memset(encoder, 0, sizeof(oc_wgpu_canvas_encoder));
+
+    encoder->threadCount = oc_clamp(threadCount, 1, OC_WGPU_CANVAS_ENCODER_MAX_THREAD_COUNT);
+    encoder->mutex = oc_mutex_create();
+    encoder->startCond = oc_condition_create();
+    encoder->doneCond = oc_condition_create();
+
+    //NOTE: worker 0 is the thread calling oc_wgpu_canvas_encode_primitives()
+    for(u32 i = 0; i < encoder->threadCount; i++)
+    {
+        oc_wgpu_canvas_encode_worker* worker = &encoder->workers[i];
+        worker->encoder = encoder;
+        worker->index = i;
+        oc_arena_init(&worker->arena);
+        if(i)
+        {
+            worker->thread = oc_thread_create_with_name(oc_wgpu_canvas_encode_worker_proc, worker, OC_STR8("canvas encoder"));
+        }
+    }
+    return (encoder);
+}
+
+void oc_wgpu_canvas_encoder_destroy(oc_wgpu_canvas_encoder* encoder)
+{
+    oc_mutex_lock(encoder->mutex);
+    encoder->quit = true;
+    oc_condition_broadcast(encoder->startCond);
+    oc_mutex_unlock(encoder->mutex);
+
+    for(u32 i = 0; i < encoder->threadCount; i++)
+    {
+        oc_wgpu_canvas_encode_worker* worker = &encoder->workers[i];
+        if(worker->thread)
+        {
+            oc_thread_join(worker->thread, 0);
+        }
+        oc_arena_cleanup(&worker->arena);
+    }
+
+    oc_condition_destroy(encoder->doneCond);
+    oc_condition_destroy(encoder->startCond);
+    oc_mutex_destroy(encoder->mutex);
+    free(encoder);
+}
+
+bool oc_wgpu_canvas_encode_primitives(oc_wgpu_canvas_encoding_context* context)
+{
+    if(context->pathBatchStart >= context->inputPrimitiveCount)
+    {
+        return (false);
+    }
+
+    context->pathData = 0;
+    context->pathCap = 0;
+    context->pathCount = 0;
+
+    context->elementData = 0;
+    context->eltCap = 0;
+    context->eltCount = 0;
+
+    context->maxSegmentCount = 0;
+    context->maxBinQueueCount = 0;
+    context->maxTileOpCount = 0;
+
+    context->imageCount = 0;
+    context->currentImageIndex = -1;
+
+    //NOTE: small batches are not worth the synchronization cost, encode them on the calling thread
+    u32 remainingCount = context->inputPrimitiveCount - context->pathBatchStart;
+    u32 primitiveCount = 0;
+
+    if(context->encoder
+       && context->encoder->threadCount > 1
+       && remainingCount > OC_WGPU_CANVAS_ENCODE_CHUNK_SIZE)
+    {
+        primitiveCount = oc_wgpu_canvas_encode_primitives_parallel(context);
+    }
+    else
+    {
+        primitiveCount = oc_wgpu_canvas_encode_primitives_serial(context);
+    }
+
+    context->pathBatchStart += primitiveCount;
+    return (true);
+}
@@ -0,0 +1,165 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "graphics_common.h"
+
+//------------------------------------------------------------------------------------------
+// WebGPU canvas encoder
+//------------------------------------------------------------------------------------------
+//NOTE: host side of the WebGPU canvas renderer. It converts the oc_primitive/oc_path_elt streams
+//      to the path and element buffers consumed by the compute passes (stroke expansion, curve
+//      splitting, path setup), and estimates the size of the intermediate GPU buffers. It doesn't
+//      depend on WebGPU, so that it can be tested and benchmarked without a GPU.
+//
+//      Primitives of a batch can be encoded in parallel by a pool of worker threads. Output is
+//      identical to the serial encoder, regardless of the number of threads.
+
+typedef struct oc_wgpu_path
+{
+    f32 uvTransform[12];
+    oc_vec4 colors[4];
+    oc_vec4 box;
+    oc_vec4 clip;
+    i32 cmd;
+    i32 textureID;
+    i32 hasGradient;
+    i32 blendSpace;
+    //...
+} oc_wgpu_path;
+
+typedef struct oc_wgpu_path_elt
+{
+    i32 pathIndex;
+    i32 kind;
+    oc_vec2 p[4];
+
+} oc_wgpu_path_elt;
+
+typedef struct oc_wgpu_segment
+{
+    int kind;
+    int pathIndex;
+    int windingIncrement;
+    int config;
+    oc_vec4 box;
+    f32 implicitMatrix[12];
+    oc_vec2 hullVertex;
+    f32 sign;
+    u32 debugID;
+} oc_wgpu_segment;
+
+typedef struct oc_wgpu_tile_op
+{
+    int kind;
+    int next;
+    int index;
+    int windingOffsetOrCrossRight;
+} oc_wgpu_tile_op;
+
+typedef struct oc_wgpu_bin_queue
+{
+    int windingOffset;
+    int first;
+    int last;
+} oc_wgpu_bin_queue;
+
+typedef struct oc_wgpu_path_bin
+{
+    int area[4];
+    int binQueues;
+    char pad0[12];
+} oc_wgpu_path_bin;
+
+typedef struct oc_wgpu_tile_queue
+{
+    oc_vec2 tileCoord;
+    int first;
+    char pad0[4];
+} oc_wgpu_tile_queue;
+
+typedef struct oc_wgpu_chunk
+{
+    int first;
+    int last;
+} oc_wgpu_chunk;
+
+typedef struct oc_wgpu_chunk_elt
+{
+    int next;
+    int path;
+} oc_wgpu_chunk_elt;
+
+enum
+{
+    OC_WGPU_CANVAS_BUFFER_DEFAULT_LEN = 1024,
+    OC_WGPU_CANVAS_MAX_IMAGE_BINDINGS = 8,
+};
+
+typedef struct oc_wgpu_canvas_renderer oc_wgpu_canvas_renderer;
+typedef struct oc_wgpu_canvas_encoder oc_wgpu_canvas_encoder;
+
+typedef struct oc_wgpu_canvas_encoding_context
+{
+    oc_wgpu_canvas_renderer* renderer;
+    oc_wgpu_canvas_encoder* encoder; // null selects the serial encoder
+
+    oc_arena* arena;
+
+    u32 pathBatchStart;
+
+    u32 inputPrimitiveCount;
+    oc_primitive* inputPrimitives;
+
+    u32 inputAttributeCount;
+    oc_attributes* inputAttributes;
+
+    u32 inputEltCount;
+    oc_path_elt* inputElements;
+
+    u32 pathCount;
+    u32 pathCap;
+    oc_wgpu_path* pathData;
+
+    u32 eltCount;
+    u32 eltCap;
+    oc_wgpu_path_elt* elementData;
+
+    u32 maxSegmentCount;
+    u32 maxBinQueueCount;
+    u32 maxTileOpCount;
+
+    u32 chunkCount;
+    u32 maxChunkEltCount;
+
+    oc_primitive* primitive;
+    oc_attributes* attributes;
+
+    oc_vec4 pathUserExtents;
+    oc_vec4 pathScreenExtents;
+
+    oc_vec2 screenSize;
+    oc_vec2 scale;
+    f32 tileSize;
+    u32 screenTilesCount;
+    u64 bufferLimit; // max size of a GPU buffer binding, batches are split to stay below that size
+
+    i32 currentImageIndex;
+    u32 imageCount;
+    oc_image imageBindings[OC_WGPU_CANVAS_MAX_IMAGE_BINDINGS];
+
+} oc_wgpu_canvas_encoding_context;
+
+//NOTE: a thread count of 0 selects one thread. The calling thread always participates in encoding.
+oc_wgpu_canvas_encoder* oc_wgpu_canvas_encoder_create(u32 threadCount);
+void oc_wgpu_canvas_encoder_destroy(oc_wgpu_canvas_encoder* encoder);
+
+//NOTE: encode the next batch of primitives, starting at context->pathBatchStart, into context->pathData
+//      and context->elementData, which are allocated in context->arena. Returns false when all
+//      primitives have been encoded.
+bool oc_wgpu_canvas_encode_primitives(oc_wgpu_canvas_encoding_context* context);
@@ -3,6 +3,7 @@
 #include "util/strings.h"
 #include "platform/io.h"
 #include "ext/libzip/lib/zip.h"
+#include <ctype.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -34,6 +35,31 @@ typedef struct oc_tool_options
     oc_str8 app;
 } oc_tool_options;
 
+//NOTE: files that are already compressed are stored as is, so that the runtime can serve them straight from
+//      a mapping of the archive, instead of decompressing them.
+static bool is_compressed_format(oc_str8 path)
+{
+    const char* extensions[] = { ".png", ".jpg", ".jpeg", ".gif", ".webp", ".ogg", ".mp3", ".flac", ".zip", ".gz", ".woff", ".woff2" };
+
+    oc_str8 ext = oc_path_slice_extension(path);
+    for(int i = 0; i < oc_array_size(extensions); i++)
+    {
+        if(ext.len == strlen(extensions[i]))
+        {
+            u64 j = 0;
+            while(j < ext.len && tolower(ext.ptr[j]) == extensions[i][j])
+            {
+                j++;
+            }
+            if(j == ext.len)
+            {
+                return (true);
+            }
+        }
+    }
+    return (false);
+}
+
 int add_to_archive(zip_t* zip, oc_str8 srcPath, oc_str8 dstPath)
 {
     oc_file srcFile = oc_catch(oc_file_open(srcPath, OC_FILE_ACCESS_READ, 0))
@@ -69,13 +95,18 @@ int add_to_archive(zip_t* zip, oc_str8 srcPath, oc_str8 dstPath)
     else
     {
         zip_source_t* source = zip_source_file(zip, srcPath.ptr, 0, ZIP_LENGTH_TO_END);
-        if(zip_file_add(zip, dstPath.ptr, source, ZIP_FL_OVERWRITE) == -1)
+        i64 index = zip_file_add(zip, dstPath.ptr, source, ZIP_FL_OVERWRITE);
+        if(index == -1)
         {
             oc_log_error("zip_file_add failed adding file %.*s: %s\n",
                          oc_str8_ip(dstPath),
                          zip_error_strerror(zip_get_error(zip)));
             return -1;
         }
+        if(is_compressed_format(dstPath))
+        {
+            zip_set_file_compression(zip, index, ZIP_CM_STORE, 0);
+        }
     }
     return 0;
 }
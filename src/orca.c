@@ -14,6 +14,7 @@
 #if OC_PLATFORM_WINDOWS
     #include "platform/native_debug.c"
     #include "platform/win32.c"
+    #include "platform/native_trace.c"
 #elif OC_PLATFORM_MACOS
     #include "platform/native_debug.c"
     #include "platform/unix_memory.c"
@@ -22,6 +23,7 @@
     #include "platform/osx_path.c"
     #include "platform/posix_io.c"
     #include "platform/posix_thread.c"
+    #include "platform/native_trace.c"
     #include "platform/unix_subprocess.c"
     #include "platform/osx_platform.c"
 /*
@@ -29,17 +31,17 @@
 	#include"platform/posix_socket.c"
 	*/
 
-#elif PLATFORM_LINUX
+#elif OC_PLATFORM_LINUX
     #include "platform/native_debug.c"
-    #include "platform/unix_base_memory.c"
+    #include "platform/unix_memory.c"
     #include "platform/linux_clock.c"
+    #include "platform/posix_path.c"
+    #include "platform/linux_path.c"
     #include "platform/posix_io.c"
-    #include "platform/platform_io_dialog.c"
     #include "platform/posix_thread.c"
-/*
-	#include"platform/unix_rng.c"
-	#include"platform/posix_socket.c"
-	*/
+    #include "platform/native_trace.c"
+    #include "platform/unix_subprocess.c"
+    #include "platform/linux_platform.c"
 #elif OC_PLATFORM_ORCA
     #include "platform/orca_debug.c"
     #include "platform/orca_clock.c"
@@ -57,10 +59,12 @@
 //---------------------------------------------------------------
 #include "util/algebra.c"
 #include "util/hash.c"
+#include "util/hash_map.c"
 #include "util/memory.c"
 #include "util/lists.c"
 #include "util/ringbuffer.c"
 #include "util/strings.c"
+#include "util/text_buffer.c"
 #include "util/utf8.c"
 #include "util/wrapped_types.c"
 #include "util/argparse.c"
@@ -97,12 +101,27 @@
         #endif
 
         #if OC_GRAPHICS_ENABLE_CANVAS
+            #include "graphics/wgpu_canvas_encoder.c"
             #include "graphics/wgpu_renderer.c"
         #endif
 
     #elif OC_PLATFORM_MACOS
         #include "platform/platform_io_dialog.c"
     //NOTE: macos application layer and graphics backends are defined in orca.m
+    #elif OC_PLATFORM_LINUX
+        #include "platform/platform_io_dialog.c"
+        #include "app/linux_app.c"
+        #include "graphics/graphics_common.c"
+        #include "graphics/canvas_renderer.c"
+        #include "graphics/surface.c"
+        #include "graphics/linux_surface.c"
+
+        #include "graphics/backends.h"
+
+        #if OC_GRAPHICS_ENABLE_HEADLESS
+            #include "graphics/cpu_rasterizer.c"
+            #include "graphics/headless_renderer.c"
+        #endif
     #elif OC_PLATFORM_ORCA
         #include "app/orca_app.c"
         #include "graphics/graphics_common.c"
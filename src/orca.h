@@ -10,10 +10,12 @@
 #include "util/algebra.h"
 #include "util/debug.h"
 #include "util/hash.h"
+#include "util/hash_map.h"
 #include "util/lists.h"
 #include "util/macros.h"
 #include "util/memory.h"
 #include "util/strings.h"
+#include "util/text_buffer.h"
 #include "util/typedefs.h"
 #include "util/utf8.h"
 #include "util/wrapped_types.h"
@@ -23,6 +25,7 @@
 #include "platform/platform_clock.h"
 #include "platform/io.h"
 #include "platform/path.h"
+#include "platform/platform_trace.h"
 
 #if !defined(OC_PLATFORM_ORCA) || !(OC_PLATFORM_ORCA)
     #include "platform/platform_thread.h"
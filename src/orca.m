@@ -28,5 +28,6 @@
 #endif
 
 #if OC_GRAPHICS_ENABLE_CANVAS
+    #include "graphics/wgpu_canvas_encoder.c"
     #include "graphics/wgpu_renderer.c"
 #endif
@@ -153,6 +153,54 @@ u64 oc_file_read(oc_file file, u64 size, char* buffer)
     return (cmp.size);
 }
 
+u64 oc_file_pwrite(oc_file file, u64 offset, u64 size, char* buffer)
+{
+    oc_io_req req = { .op = OC_IO_PWRITE,
+                      .handle = file,
+                      .offset = offset,
+                      .size = size,
+                      .buffer = buffer };
+
+    oc_io_cmp cmp = oc_io_wait_single_req(&req);
+    return (cmp.size);
+}
+
+u64 oc_file_pread(oc_file file, u64 offset, u64 size, char* buffer)
+{
+    oc_io_req req = { .op = OC_IO_PREAD,
+                      .handle = file,
+                      .offset = offset,
+                      .size = size,
+                      .buffer = buffer };
+
+    oc_io_cmp cmp = oc_io_wait_single_req(&req);
+    return (cmp.size);
+}
+
+u64 oc_file_writev(oc_file file, u64 offset, u64 count, oc_io_vec* vecs)
+{
+    oc_io_req req = { .op = OC_IO_WRITEV,
+                      .handle = file,
+                      .offset = offset,
+                      .size = count,
+                      .buffer = (char*)vecs };
+
+    oc_io_cmp cmp = oc_io_wait_single_req(&req);
+    return (cmp.size);
+}
+
+u64 oc_file_readv(oc_file file, u64 offset, u64 count, oc_io_vec* vecs)
+{
+    oc_io_req req = { .op = OC_IO_READV,
+                      .handle = file,
+                      .offset = offset,
+                      .size = count,
+                      .buffer = (char*)vecs };
+
+    oc_io_cmp cmp = oc_io_wait_single_req(&req);
+    return (cmp.size);
+}
+
 oc_io_error oc_file_last_error(oc_file file)
 {
     oc_io_req req = { .op = OC_OC_IO_ERROR,
@@ -313,59 +361,6 @@ oc_io_error oc_file_remove(oc_str8 path, oc_file_remove_options* optionsPtr)
     }
 }
 
-oc_io_error oc_file_copy_recursive(oc_str8 srcPath, oc_str8 dstPath, oc_file_copy_options* options)
-{
-    oc_file src = oc_catch(oc_file_open(srcPath,
-                                        OC_FILE_ACCESS_READ,
-                                        &(oc_file_open_options){
-                                            .root = options->srcRoot,
-                                        }))
-    {
-        return oc_last_error();
-    }
-    oc_file_status srcStatus = oc_file_get_status(src);
-
-    if(srcStatus.type == OC_FILE_DIRECTORY)
-    {
-        oc_scratch scratch = oc_scratch_begin();
-
-        //NOTE: if src is a directory, we create dst as a directory if it doesn't exist,
-        // and copy src/* into dst/*
-        oc_io_error error = oc_file_makedir(dstPath,
-                                            &(oc_file_makedir_options){
-                                                .root = options->dstRoot,
-                                                .resolve = options->dstResolve,
-                                                .flags = OC_FILE_MAKEDIR_IGNORE_EXISTING,
-                                            });
-        if(error != OC_IO_OK)
-        {
-            oc_file_close(src);
-            return error;
-        }
-
-        oc_file_list files = oc_file_listdir(scratch.allocator, src);
-        oc_file_close(src);
-
-        oc_file_list_for(files, file)
-        {
-            oc_str8 srcChild = oc_path_append(scratch.allocator, srcPath, file->basename);
-            oc_str8 dstChild = oc_path_append(scratch.allocator, dstPath, file->basename);
-            error = oc_file_copy_recursive(srcChild, dstChild, options);
-            if(error != OC_IO_OK)
-            {
-                break;
-            }
-        }
-        oc_scratch_end(scratch);
-        return error;
-    }
-    else
-    {
-        //NOTE: if src is not a directory, we copy file to file
-        return oc_file_copy(srcPath, dstPath, options);
-    }
-}
-
 oc_io_error oc_file_copy(oc_str8 src, oc_str8 dst, oc_file_copy_options* optionsPtr)
 {
     oc_file_copy_options options = optionsPtr
@@ -439,9 +434,39 @@ oc_io_error oc_file_copy(oc_str8 src, oc_str8 dst, oc_file_copy_options* options
     }
     else if(srcStat.type == OC_FILE_DIRECTORY)
     {
+        //NOTE: if src is a directory, we create dst as a directory if it doesn't exist,
+        // and copy src/* into dst/* with a single request
+        oc_io_error error = oc_file_makedir(dst,
+                                            &(oc_file_makedir_options){
+                                                .root = options.dstRoot,
+                                                .resolve = options.dstResolve,
+                                                .flags = OC_FILE_MAKEDIR_IGNORE_EXISTING,
+                                            });
+        if(error == OC_IO_OK)
+        {
+            oc_file dstDir = oc_catch(oc_file_open(dst,
+                                                   OC_FILE_ACCESS_WRITE,
+                                                   &(oc_file_open_options){
+                                                       .root = options.dstRoot,
+                                                       .resolve = options.dstResolve,
+                                                   }))
+            {
+                error = oc_last_error();
+            }
+            else
+            {
+                oc_io_req req = {
+                    .op = OC_IO_COPY,
+                    .handle = srcFile,
+                    .copy.dst = dstDir,
+                    .copy.flags = options.flags,
+                };
+                error = oc_io_wait_single_req(&req).error;
+                oc_file_close(dstDir);
+            }
+        }
         oc_file_close(srcFile);
-
-        return oc_file_copy_recursive(src, dst, &options);
+        return error;
     }
     else
     {
@@ -72,9 +72,26 @@ enum oc_io_op_enum
     OC_IO_COPY,
     OC_IO_GETNAME,
     OC_OC_IO_ERROR,
+    OC_IO_PREAD,
+    OC_IO_PWRITE,
+    OC_IO_READV,
+    OC_IO_WRITEV,
     //...
 };
 
+//NOTE: buffer of a vectored read or write. As in oc_io_req, the pointer is padded to 64 bits so that the
+//      layout is the same on wasm and on host.
+typedef struct oc_io_vec
+{
+    union
+    {
+        char* buffer;
+        u64 unused;
+    };
+
+    u64 size;
+} oc_io_vec;
+
 typedef struct oc_io_req
 {
     oc_io_req_id id;
@@ -188,6 +205,10 @@ ORCA_API i64 oc_file_pos(oc_file file);
 ORCA_API i64 oc_file_seek(oc_file file, i64 offset, oc_file_whence whence);
 ORCA_API u64 oc_file_write(oc_file file, u64 size, char* buffer);
 ORCA_API u64 oc_file_read(oc_file file, u64 size, char* buffer);
+ORCA_API u64 oc_file_pwrite(oc_file file, u64 offset, u64 size, char* buffer);
+ORCA_API u64 oc_file_pread(oc_file file, u64 offset, u64 size, char* buffer);
+ORCA_API u64 oc_file_writev(oc_file file, u64 offset, u64 count, oc_io_vec* vecs);
+ORCA_API u64 oc_file_readv(oc_file file, u64 offset, u64 count, oc_io_vec* vecs);
 ORCA_API oc_io_error oc_file_last_error(oc_file file);
 
 //----------------------------------------------------------------
@@ -0,0 +1,57 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include <time.h>
+
+#include "platform_clock.h"
+#include "util/typedefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oc_clock_init()
+{
+    //NOTE: nothing to do on linux, clock_gettime() doesn't need any setup
+}
+
+static inline f64 oc_linux_clock_seconds(clockid_t id)
+{
+    struct timespec ts = { 0 };
+    clock_gettime(id, &ts);
+    return ((f64)ts.tv_sec + (f64)ts.tv_nsec * 1e-9);
+}
+
+f64 oc_clock_time(oc_clock_kind clock)
+{
+    switch(clock)
+    {
+        case OC_CLOCK_MONOTONIC:
+        {
+            //NOTE: CLOCK_MONOTONIC_RAW is not subject to NTP frequency adjustments
+            return (oc_linux_clock_seconds(CLOCK_MONOTONIC_RAW));
+        }
+
+        case OC_CLOCK_UPTIME:
+        {
+            //NOTE: CLOCK_MONOTONIC doesn't increment while the system is suspended,
+            //      which matches the semantics of OC_CLOCK_UPTIME on other platforms
+            return (oc_linux_clock_seconds(CLOCK_MONOTONIC));
+        }
+
+        case OC_CLOCK_DATE:
+        {
+            return (oc_linux_clock_seconds(CLOCK_REALTIME));
+        }
+    }
+
+    return 0.0;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
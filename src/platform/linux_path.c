@@ -0,0 +1,62 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+bool oc_path_is_absolute(oc_str8 path)
+{
+    return (path.len && (path.ptr[0] == '/'));
+}
+
+oc_str8 oc_path_executable(oc_allocator* allocator)
+{
+    oc_str8 result = {};
+    char buffer[PATH_MAX];
+    ssize_t size = readlink("/proc/self/exe", buffer, PATH_MAX);
+    if(size > 0)
+    {
+        result.len = size;
+        result.ptr = oc_allocator_push_array(allocator, char, result.len + 1);
+        memcpy(result.ptr, buffer, result.len);
+        result.ptr[result.len] = '\0';
+    }
+    return (result);
+}
+
+oc_str8 oc_path_canonical(oc_allocator* allocator, oc_str8 path)
+{
+    oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
+    char* pathCString = oc_str8_to_cstring(scratch.allocator, path);
+
+    char* real = realpath(pathCString, 0);
+    oc_str8 result = {};
+    if(real)
+    {
+        result = oc_str8_push_cstring(allocator, real);
+        free(real);
+    }
+    oc_scratch_end(scratch);
+
+    return (result);
+}
+
+oc_str8 oc_path_executable_relative(oc_allocator* allocator, oc_str8 relPath)
+{
+    oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
+
+    oc_str8 executablePath = oc_path_executable(scratch.allocator);
+    oc_str8 dirPath = oc_path_slice_directory(executablePath);
+
+    oc_str8 path = oc_path_append(scratch.allocator, dirPath, relPath);
+    path = oc_path_canonical(allocator, path);
+
+    oc_scratch_end(scratch);
+    return (path);
+}
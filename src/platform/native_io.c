@@ -7,6 +7,8 @@
 **************************************************************************/
 
 #include "platform/path.h"
+#include "platform/platform_thread.h"
+#include "util/hash.h"
 #include "io.c"
 #include "native_io.h"
 
@@ -20,19 +22,148 @@ oc_file_table* oc_file_table_get_global()
     return (&oc_globalFileTable);
 }
 
+//------------------------------------------------------------------------
+// Resolved directories cache
+//------------------------------------------------------------------------
+static u64 oc_file_dir_cache_hash(oc_file root, oc_str8 path)
+{
+    return (oc_hash_xxh3_string_seed(path, root.h));
+}
+
+static void oc_file_dir_cache_evict(oc_file_dir_cache* cache, oc_file_dir_cache_entry* entry)
+{
+    if(entry->path.ptr)
+    {
+        oc_fd_close(entry->fd);
+        free(entry->path.ptr);
+        *entry = (oc_file_dir_cache_entry){ 0 };
+        cache->count--;
+    }
+}
+
+static oc_file_dir_cache_entry* oc_file_dir_cache_find(oc_file_dir_cache* cache, oc_file root, oc_str8 path)
+{
+    u64 hash = oc_file_dir_cache_hash(root, path);
+    oc_file_dir_cache_entry* entry = &cache->entries[hash % OC_IO_DIR_CACHE_SIZE];
+
+    if(entry->path.ptr
+       && entry->hash == hash
+       && entry->root.h == root.h
+       && !oc_str8_cmp(entry->path, path))
+    {
+        return (entry);
+    }
+    return (0);
+}
+
+static void oc_file_dir_cache_insert(oc_file_dir_cache* cache, oc_file root, oc_str8 path, oc_file_desc fd)
+{
+    //NOTE: the cache keeps its own duplicate of fd
+    u64 hash = oc_file_dir_cache_hash(root, path);
+    oc_file_dir_cache_entry* entry = &cache->entries[hash % OC_IO_DIR_CACHE_SIZE];
+
+    if(entry->path.ptr
+       && entry->hash == hash
+       && entry->root.h == root.h
+       && !oc_str8_cmp(entry->path, path))
+    {
+        return;
+    }
+
+    oc_file_desc dupFd = oc_fd_dup(fd);
+    char* pathBuffer = malloc(path.len);
+    if(oc_file_desc_is_nil(dupFd) || !pathBuffer)
+    {
+        if(!oc_file_desc_is_nil(dupFd))
+        {
+            oc_fd_close(dupFd);
+        }
+        free(pathBuffer);
+        return;
+    }
+    memcpy(pathBuffer, path.ptr, path.len);
+
+    oc_file_dir_cache_evict(cache, entry);
+
+    entry->root = root;
+    entry->hash = hash;
+    entry->path = oc_str8_from_buffer(path.len, pathBuffer);
+    entry->fd = dupFd;
+    cache->count++;
+}
+
+static void oc_file_dir_cache_remove_root(oc_file_dir_cache* cache, oc_file root)
+{
+    for(u32 i = 0; i < OC_IO_DIR_CACHE_SIZE && cache->count; i++)
+    {
+        oc_file_dir_cache_entry* entry = &cache->entries[i];
+        if(entry->path.ptr && entry->root.h == root.h)
+        {
+            oc_file_dir_cache_evict(cache, entry);
+        }
+    }
+}
+
+static void oc_file_dir_cache_invalidate(oc_file_dir_cache* cache, oc_file root, oc_str8 path)
+{
+    //NOTE: remove the entries for path and the directories below it. Entries of other roots could designate
+    //      the same directories through different paths, so we remove them too.
+    for(u32 i = 0; i < OC_IO_DIR_CACHE_SIZE && cache->count; i++)
+    {
+        oc_file_dir_cache_entry* entry = &cache->entries[i];
+        if(entry->path.ptr)
+        {
+            bool below = entry->root.h == root.h
+                      && entry->path.len >= path.len
+                      && !memcmp(entry->path.ptr, path.ptr, path.len)
+                      && (entry->path.len == path.len || !path.len || entry->path.ptr[path.len] == '/');
+
+            if(below || entry->root.h != root.h)
+            {
+                oc_file_dir_cache_evict(cache, entry);
+            }
+        }
+    }
+}
+
 oc_file_slot* oc_file_slot_alloc(oc_file_table* table)
 {
     oc_file_slot* slot = oc_list_pop_front_elt(&table->freeList, oc_file_slot, freeListElt);
-    if(!slot && table->nextSlot < OC_IO_MAX_FILE_SLOTS)
+    if(!slot && table->nextSlot < UINT32_MAX)
     {
-        slot = &table->slots[table->nextSlot];
+        u32 chunkIndex = table->nextSlot / OC_IO_FILE_SLOT_CHUNK_SIZE;
+        if(chunkIndex >= table->chunkCount)
+        {
+            if(table->chunkCount >= table->chunkCap)
+            {
+                u32 newCap = oc_max(8, table->chunkCap * 1.5);
+                oc_file_slot** newChunks = realloc(table->chunks, newCap * sizeof(oc_file_slot*));
+                if(!newChunks)
+                {
+                    return (0);
+                }
+                table->chunks = newChunks;
+                table->chunkCap = newCap;
+            }
+            oc_file_slot* chunk = oc_malloc_array(oc_file_slot, OC_IO_FILE_SLOT_CHUNK_SIZE);
+            if(!chunk)
+            {
+                return (0);
+            }
+            table->chunks[table->chunkCount] = chunk;
+            table->chunkCount++;
+        }
+        slot = &table->chunks[chunkIndex][table->nextSlot % OC_IO_FILE_SLOT_CHUNK_SIZE];
+        slot->index = table->nextSlot;
         slot->generation = 1;
         table->nextSlot++;
     }
     if(slot)
     {
+        u32 tmpIndex = slot->index;
         u32 tmpGeneration = slot->generation;
         memset(slot, 0, sizeof(oc_file_slot));
+        slot->index = tmpIndex;
         slot->generation = tmpGeneration;
     }
     return (slot);
@@ -44,13 +175,20 @@ void oc_file_slot_recycle(oc_file_table* table, oc_file_slot* slot)
     {
         free(slot->name.ptr);
     }
+    if(slot->blob && slot->blob->release)
+    {
+        slot->blob->release(slot->blob);
+    }
+    slot->blob = 0;
+    oc_file_dir_cache_remove_root(&table->dirCache, oc_file_from_slot(table, slot));
+
     slot->generation++;
     oc_list_push_front(&table->freeList, &slot->freeListElt);
 }
 
 oc_file oc_file_from_slot(oc_file_table* table, oc_file_slot* slot)
 {
-    u64 index = slot - table->slots;
+    u64 index = slot->index;
     u64 generation = slot->generation;
     oc_file handle = { .h = (generation << 32) | index };
     return (handle);
@@ -65,7 +203,7 @@ oc_file_slot* oc_file_slot_from_handle(oc_file_table* table, oc_file handle)
 
     if(index < table->nextSlot)
     {
-        oc_file_slot* candidate = &table->slots[index];
+        oc_file_slot* candidate = &table->chunks[index / OC_IO_FILE_SLOT_CHUNK_SIZE][index % OC_IO_FILE_SLOT_CHUNK_SIZE];
         if(candidate->generation == generation)
         {
             slot = candidate;
@@ -105,6 +243,10 @@ oc_io_cmp oc_io_wait_single_req(oc_io_req* req)
     Resolve rootFd and path to a parent directory fd and a file name,
     expanding symlinks and '..', and making sure the path doesn't escape
     rootFd.
+
+    When the platform can check this in one call (openat2() on linux),
+    the parent directory is opened directly. Otherwise we walk the path
+    one element at a time.
 -----------------------------------------------------------------------*/
 typedef struct oc_io_resolve_result
 {
@@ -114,9 +256,8 @@ typedef struct oc_io_resolve_result
     oc_str8 name;
 } oc_io_resolve_result;
 
-oc_io_resolve_result oc_io_resolve(oc_allocator* allocator, oc_file_desc rootFd, oc_str8 path, oc_file_resolve_flags resolveFlags)
+static oc_io_resolve_result oc_io_resolve_walk(oc_allocator* allocator, oc_file_desc rootFd, oc_str8 path, oc_file_resolve_flags resolveFlags)
 {
-
     oc_io_resolve_result result = { 0 };
     oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
 
@@ -160,7 +301,7 @@ oc_io_resolve_result oc_io_resolve(oc_allocator* allocator, oc_file_desc rootFd,
                 //NOTE: here we need to recompute fd from path. We can't just openat ".." because the directory
                 // associated with fd could have been moved, and we could potentially escape the root
                 oc_str8 normPath = oc_path_join(scratch.allocator, normElements);
-                oc_io_resolve_result r = oc_io_resolve(scratch.allocator, rootFd, normPath, OC_FILE_RESOLVE_SYMLINK_DONT_FOLLOW);
+                oc_io_resolve_result r = oc_io_resolve_walk(scratch.allocator, rootFd, normPath, OC_FILE_RESOLVE_SYMLINK_DONT_FOLLOW);
                 if(r.error != OC_IO_OK)
                 {
                     result.error = r.error;
@@ -297,6 +438,255 @@ oc_io_resolve_result oc_io_resolve(oc_allocator* allocator, oc_file_desc rootFd,
     return result;
 }
 
+static bool oc_io_resolve_beneath(oc_allocator* allocator,
+                                  oc_file_desc rootFd,
+                                  oc_str8 path,
+                                  oc_file_resolve_flags resolveFlags,
+                                  oc_io_resolve_result* result)
+{
+    /*NOTE: fast path, where the platform opens the parent directory in one call, checking that it doesn't
+        walk out of rootFd and doesn't go through symlinks. Since there are no symlinks, '..' can be
+        normalized lexically, and we only have to check the last element.
+
+        Returns false if the path should be resolved by walking it, because the platform doesn't support this,
+        or because the path ends with '.' or '..', or goes through a symlink that must be followed.
+    */
+    oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
+
+    oc_str8_list elements = oc_path_split(scratch.allocator, path);
+    oc_str8_elt* last = oc_typed_list_last(elements.list);
+
+    if(!last
+       || !oc_str8_cmp(last->string, OC_STR8("/"))
+       || !oc_str8_cmp(last->string, OC_STR8("."))
+       || !oc_str8_cmp(last->string, OC_STR8("..")))
+    {
+        oc_scratch_end(scratch);
+        return false;
+    }
+
+    oc_str8_list dirElements = { 0 };
+    oc_str8_list normElements = { 0 };
+    oc_str8_list_for(elements, elt)
+    {
+        if(elt == last)
+        {
+            break;
+        }
+        else if(!oc_str8_cmp(elt->string, OC_STR8("/")))
+        {
+            //NOTE: absolute paths are relative to rootFd
+            continue;
+        }
+        oc_str8_list_push(scratch.allocator, &dirElements, elt->string);
+
+        if(!oc_str8_cmp(elt->string, OC_STR8("..")))
+        {
+            //NOTE: if this walks out, the open below fails, so we don't care about the result
+            oc_str8_list_pop_back(&normElements);
+        }
+        else if(oc_str8_cmp(elt->string, OC_STR8(".")))
+        {
+            oc_str8_list_push(scratch.allocator, &normElements, elt->string);
+        }
+    }
+    oc_str8 dirPath = oc_str8_list_empty(dirElements)
+                        ? OC_STR8(".")
+                        : oc_path_join(scratch.allocator, dirElements);
+
+    oc_fd_result dir = oc_fd_open_dir_beneath(rootFd, dirPath);
+    if(dir.error == OC_IO_ERR_OP
+       || (dir.error == OC_IO_ERR_SYMLINK && !(resolveFlags & OC_FILE_RESOLVE_SYMLINK_DONT_FOLLOW)))
+    {
+        oc_scratch_end(scratch);
+        return false;
+    }
+    else if(dir.error != OC_IO_OK)
+    {
+        result->error = dir.error;
+        oc_scratch_end(scratch);
+        return true;
+    }
+
+    oc_fd_stat_result status = oc_fd_stat_at(dir.value, last->string);
+    if(status.error == OC_IO_OK
+       && status.value.type == OC_FILE_SYMLINK
+       && !(resolveFlags & (OC_FILE_RESOLVE_SYMLINK_DONT_FOLLOW | OC_FILE_RESOLVE_SYMLINK_OPEN_LAST)))
+    {
+        //NOTE: the last element must be followed, the walk takes care of it
+        oc_fd_close(dir.value);
+        oc_scratch_end(scratch);
+        return false;
+    }
+
+    if(status.error != OC_IO_OK && status.error != OC_IO_ERR_NO_ENTRY)
+    {
+        result->error = status.error;
+    }
+    else if(status.error == OC_IO_OK
+            && status.value.type != OC_FILE_SYMLINK
+            && status.value.type != OC_FILE_DIRECTORY
+            && status.value.type != OC_FILE_REGULAR)
+    {
+        //NOTE: same as the walk, which only accepts regular files, directories and symlinks
+        result->error = OC_IO_ERR_NOT_DIR;
+    }
+
+    if(result->error)
+    {
+        oc_fd_close(dir.value);
+    }
+    else
+    {
+        result->fd = dir.value;
+        result->name = oc_str8_push_copy(allocator, last->string);
+        result->path = oc_path_join(scratch.allocator, normElements);
+        result->path = oc_path_append(allocator, result->path, result->name);
+    }
+
+    oc_scratch_end(scratch);
+    return true;
+}
+
+oc_io_resolve_result oc_io_resolve(oc_allocator* allocator, oc_file_desc rootFd, oc_str8 path, oc_file_resolve_flags resolveFlags)
+{
+    oc_io_resolve_result result = { 0 };
+
+    //NOTE: the fast path only applies to paths under a root directory, paths relative to the current
+    //      directory are resolved by the walk.
+    if(!oc_file_desc_is_nil(rootFd) && oc_io_resolve_beneath(allocator, rootFd, path, resolveFlags, &result))
+    {
+        return result;
+    }
+    return oc_io_resolve_walk(allocator, rootFd, path, resolveFlags);
+}
+
+static oc_io_resolve_result oc_io_resolve_for_table(oc_allocator* allocator,
+                                                    oc_file_table* table,
+                                                    oc_file_slot* atSlot,
+                                                    oc_str8 path,
+                                                    oc_file_resolve_flags resolveFlags)
+{
+    /*NOTE: resolve path under atSlot. If the path has to be walked, start from the deepest ancestor of the
+        path that is in the directory cache, and cache the parent directory of the result.
+
+        Ancestors are looked up by their literal path, up to the first '..' element. Since the cached paths are
+        normalized and contain no symlinks, this gives the same directory as a full resolution, as long as the
+        entries are invalidated when directories are removed.
+
+        The cache isn't used when the platform can open the parent directory in one call, since that costs
+        about as much as a cache hit, and less than a cache miss.
+    */
+    if(!atSlot)
+    {
+        return (oc_io_resolve(allocator, oc_file_desc_nil(), path, resolveFlags));
+    }
+    if(atSlot->blob)
+    {
+        return ((oc_io_resolve_result){ .error = OC_IO_ERR_NOT_DIR });
+    }
+
+    oc_io_resolve_result result = { 0 };
+    if(oc_io_resolve_beneath(allocator, atSlot->fd, path, resolveFlags, &result))
+    {
+        return (result);
+    }
+
+    oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
+
+    oc_file root = oc_file_from_slot(table, atSlot);
+    oc_file_dir_cache* cache = &table->dirCache;
+
+    //NOTE: build the literal path of the parent elements, and the offset at which each prefix ends
+    oc_str8_list elements = oc_path_split(scratch.allocator, path);
+    u64 eltCount = oc_typed_list_count(elements.list);
+    u64* prefixEnds = oc_arena_push_array(scratch.arena, u64, eltCount + 1);
+    char* prefixBuffer = oc_arena_push_array(scratch.arena, char, path.len + 1);
+    u64 prefixCount = 0;
+    u64 prefixLen = 0;
+
+    oc_str8_elt* last = oc_typed_list_last(elements.list);
+    oc_str8_list_for(elements, elt)
+    {
+        if(elt == last || !oc_str8_cmp(elt->string, OC_STR8("..")))
+        {
+            break;
+        }
+        else if(oc_str8_cmp(elt->string, OC_STR8(".")) && oc_str8_cmp(elt->string, OC_STR8("/")))
+        {
+            if(prefixLen)
+            {
+                prefixBuffer[prefixLen] = '/';
+                prefixLen++;
+            }
+            memcpy(prefixBuffer + prefixLen, elt->string.ptr, elt->string.len);
+            prefixLen += elt->string.len;
+            prefixEnds[prefixCount] = prefixLen;
+            prefixCount++;
+        }
+    }
+
+    //NOTE: look for the deepest cached prefix, and resolve the rest of the path from there
+    bool resolved = false;
+
+    for(i64 prefixIndex = prefixCount - 1; prefixIndex >= 0 && cache->count; prefixIndex--)
+    {
+        oc_str8 prefix = oc_str8_from_buffer(prefixEnds[prefixIndex], prefixBuffer);
+        oc_file_dir_cache_entry* entry = oc_file_dir_cache_find(cache, root, prefix);
+        if(entry)
+        {
+            //NOTE: skip the elements that make up the prefix
+            oc_str8_list rest = { 0 };
+            u64 skipCount = prefixIndex + 1;
+            oc_str8_list_for(elements, elt)
+            {
+                if(skipCount
+                   && oc_str8_cmp(elt->string, OC_STR8("."))
+                   && oc_str8_cmp(elt->string, OC_STR8("/")))
+                {
+                    skipCount--;
+                }
+                else if(!skipCount)
+                {
+                    oc_str8_list_push(scratch.allocator, &rest, elt->string);
+                }
+            }
+            oc_str8 restPath = oc_path_join(scratch.allocator, rest);
+
+            //NOTE: if the rest of the path goes above the cached directory, through '..' or a symlink, it could
+            //      still be under the root, so we resolve it from the root.
+            result = oc_io_resolve(scratch.allocator, entry->fd, restPath, resolveFlags);
+            if(result.error != OC_IO_ERR_WALKOUT)
+            {
+                if(result.error == OC_IO_OK)
+                {
+                    result.name = oc_str8_push_copy(allocator, result.name);
+                    result.path = oc_path_append(allocator, prefix, result.path);
+                }
+                resolved = true;
+            }
+            break;
+        }
+    }
+
+    if(!resolved)
+    {
+        result = oc_io_resolve_walk(allocator, atSlot->fd, path, resolveFlags);
+    }
+
+    if(result.error == OC_IO_OK
+       && oc_str8_cmp(result.name, OC_STR8("."))
+       && result.path.len > result.name.len)
+    {
+        //NOTE: result.path is the normalized path of the parent directory, followed by '/' and the name
+        oc_str8 dirPath = oc_str8_slice(result.path, 0, result.path.len - result.name.len - 1);
+        oc_file_dir_cache_insert(cache, root, dirPath, result.fd);
+    }
+
+    oc_scratch_end(scratch);
+    return (result);
+}
+
 /*-----------------------------------------------------------------------
  Platform-agnostic IO handlers
 
@@ -360,9 +750,7 @@ oc_io_cmp oc_io_open(oc_io_req* req, oc_file_table* table)
             {
                 oc_scratch scratch = oc_scratch_begin();
 
-                oc_file_desc rootFd = atSlot ? atSlot->fd : oc_file_desc_nil();
-
-                oc_io_resolve_result resolve = oc_io_resolve(scratch.allocator, rootFd, path, req->resolveFlags);
+                oc_io_resolve_result resolve = oc_io_resolve_for_table(scratch.allocator, table, atSlot, path, req->resolveFlags);
                 if(resolve.error != OC_IO_OK)
                 {
                     cmp.error = resolve.error;
@@ -449,6 +837,16 @@ oc_io_cmp oc_io_stat(oc_io_req* req, oc_file_table* table)
     {
         cmp.error = OC_IO_ERR_ARG;
     }
+    else if(slot->blob)
+    {
+        oc_file_status status = {
+            .uid = slot->index,
+            .type = OC_FILE_REGULAR,
+            .perm = OC_FILE_OWNER_READ,
+            .size = slot->blob->contents.len,
+        };
+        memcpy(req->buffer, &status, sizeof(status));
+    }
     else
     {
         oc_fd_stat_result r = oc_fd_stat(slot->fd);
@@ -474,6 +872,38 @@ oc_io_cmp oc_io_seek(oc_io_req* req, oc_file_table* table)
         return cmp;
     }
 
+    if(slot->blob)
+    {
+        //NOTE: offsets are taken as signed, as with lseek()
+        i64 base = 0;
+        switch(req->whence)
+        {
+            case OC_FILE_SEEK_SET:
+                base = 0;
+                break;
+            case OC_FILE_SEEK_END:
+                base = slot->blob->contents.len;
+                break;
+            case OC_FILE_SEEK_CURRENT:
+                base = slot->blobOffset;
+                break;
+            default:
+                slot->error = cmp.error = OC_IO_ERR_ARG;
+                return (cmp);
+        }
+        i64 offset = base + (i64)req->offset;
+        if(offset < 0)
+        {
+            slot->error = cmp.error = OC_IO_ERR_ARG;
+        }
+        else
+        {
+            slot->blobOffset = offset;
+            cmp.result = offset;
+        }
+        return (cmp);
+    }
+
     cmp.result = oc_catch(oc_fd_seek(slot->fd, req->offset, req->whence))
     {
         slot->error = cmp.error = oc_last_error();
@@ -490,6 +920,16 @@ oc_io_cmp oc_io_read(oc_io_req* req, oc_file_table* table)
         return cmp;
     }
 
+    if(slot->blob)
+    {
+        u64 len = slot->blob->contents.len;
+        u64 size = (slot->blobOffset < len) ? oc_min(req->size, len - slot->blobOffset) : 0;
+        memcpy(req->buffer, slot->blob->contents.ptr + slot->blobOffset, size);
+        slot->blobOffset += size;
+        cmp.result = size;
+        return (cmp);
+    }
+
     cmp.result = oc_catch(oc_fd_read(slot->fd, req->size, req->buffer))
     {
         slot->error = cmp.error = oc_last_error();
@@ -516,6 +956,126 @@ oc_io_cmp oc_io_write(oc_io_req* req, oc_file_table* table)
     return (cmp);
 }
 
+static u64 oc_io_blob_pread(oc_file_blob* blob, u64 offset, u64 size, char* buffer)
+{
+    u64 len = blob->contents.len;
+    u64 n = (offset < len) ? oc_min(size, len - offset) : 0;
+    memcpy(buffer, blob->contents.ptr + offset, n);
+    return (n);
+}
+
+oc_io_cmp oc_io_pread(oc_io_req* req, oc_file_table* table)
+{
+    oc_io_cmp cmp = { 0 };
+    oc_file_slot* slot = oc_catch(oc_file_slot_with_access(table, req->handle, OC_FILE_ACCESS_READ))
+    {
+        cmp.error = oc_last_error();
+        return cmp;
+    }
+
+    if(req->offset < 0)
+    {
+        slot->error = cmp.error = OC_IO_ERR_ARG;
+    }
+    else if(slot->blob)
+    {
+        cmp.result = oc_io_blob_pread(slot->blob, req->offset, req->size, req->buffer);
+    }
+    else
+    {
+        cmp.result = oc_catch(oc_fd_pread(slot->fd, req->offset, req->size, req->buffer))
+        {
+            slot->error = cmp.error = oc_last_error();
+        }
+    }
+    return (cmp);
+}
+
+oc_io_cmp oc_io_pwrite(oc_io_req* req, oc_file_table* table)
+{
+    oc_io_cmp cmp = { 0 };
+    oc_file_slot* slot = oc_catch(oc_file_slot_with_access(table, req->handle, OC_FILE_ACCESS_WRITE))
+    {
+        cmp.error = oc_last_error();
+        return cmp;
+    }
+
+    if(req->offset < 0)
+    {
+        slot->error = cmp.error = OC_IO_ERR_ARG;
+    }
+    else
+    {
+        cmp.result = oc_catch(oc_fd_pwrite(slot->fd, req->offset, req->size, req->buffer))
+        {
+            slot->error = cmp.error = oc_last_error();
+        }
+    }
+    return (cmp);
+}
+
+oc_io_cmp oc_io_readv(oc_io_req* req, oc_file_table* table)
+{
+    //NOTE: for vectored operations, size is the number of oc_io_vec in buffer
+    oc_io_cmp cmp = { 0 };
+    oc_file_slot* slot = oc_catch(oc_file_slot_with_access(table, req->handle, OC_FILE_ACCESS_READ))
+    {
+        cmp.error = oc_last_error();
+        return cmp;
+    }
+
+    oc_io_vec* vecs = (oc_io_vec*)req->buffer;
+    if(req->offset < 0)
+    {
+        slot->error = cmp.error = OC_IO_ERR_ARG;
+    }
+    else if(slot->blob)
+    {
+        u64 total = 0;
+        for(u64 i = 0; i < req->size; i++)
+        {
+            u64 n = oc_io_blob_pread(slot->blob, req->offset + total, vecs[i].size, vecs[i].buffer);
+            total += n;
+            if(n < vecs[i].size)
+            {
+                break;
+            }
+        }
+        cmp.result = total;
+    }
+    else
+    {
+        cmp.result = oc_catch(oc_fd_preadv(slot->fd, req->offset, req->size, vecs))
+        {
+            slot->error = cmp.error = oc_last_error();
+        }
+    }
+    return (cmp);
+}
+
+oc_io_cmp oc_io_writev(oc_io_req* req, oc_file_table* table)
+{
+    oc_io_cmp cmp = { 0 };
+    oc_file_slot* slot = oc_catch(oc_file_slot_with_access(table, req->handle, OC_FILE_ACCESS_WRITE))
+    {
+        cmp.error = oc_last_error();
+        return cmp;
+    }
+
+    if(req->offset < 0)
+    {
+        slot->error = cmp.error = OC_IO_ERR_ARG;
+    }
+    else
+    {
+        cmp.result = oc_catch(oc_fd_pwritev(slot->fd, req->offset, req->size, (oc_io_vec*)req->buffer))
+        {
+            slot->error = cmp.error = oc_last_error();
+        }
+    }
+    return (cmp);
+}
+
 oc_io_cmp oc_io_getname(oc_io_req* req, oc_file_table* table)
 {
     oc_io_cmp cmp = { 0 };
@@ -594,8 +1154,6 @@ oc_io_cmp oc_io_makedir(oc_io_req* req, oc_file_table* table)
     {
         oc_scratch scratch = oc_scratch_begin();
 
-        oc_file_desc rootFd = atSlot ? atSlot->fd : oc_file_desc_nil();
-
         //////////////////////////////////////////////////////
         //TODO: here, if flags has OC_FILE_MAKEDIR_CREATE_PARENTS, we'd like to call
         // ourselves for each element with the OC_FILE_MAKEDIR_IGNORE_EXISTING flags set,
@@ -624,7 +1182,7 @@ oc_io_cmp oc_io_makedir(oc_io_req* req, oc_file_table* table)
         }
         else
         {
-            oc_io_resolve_result resolve = oc_io_resolve(scratch.allocator, rootFd, path, req->resolveFlags);
+            oc_io_resolve_result resolve = oc_io_resolve_for_table(scratch.allocator, table, atSlot, path, req->resolveFlags);
             if(resolve.error)
             {
                 cmp.error = resolve.error;
@@ -636,6 +1194,7 @@ oc_io_cmp oc_io_makedir(oc_io_req* req, oc_file_table* table)
                 {
                     cmp.error = OC_IO_OK;
                 }
+                oc_fd_close(resolve.fd);
             }
         }
         oc_scratch_end(scratch);
@@ -672,9 +1231,7 @@ oc_io_cmp oc_io_remove(oc_io_req* req, oc_file_table* table)
     {
         oc_scratch scratch = oc_scratch_begin();
 
-        oc_file_desc rootFd = atSlot ? atSlot->fd : oc_file_desc_nil();
-
-        oc_io_resolve_result resolve = oc_io_resolve(scratch.allocator, rootFd, path, OC_FILE_RESOLVE_SYMLINK_OPEN_LAST);
+        oc_io_resolve_result resolve = oc_io_resolve_for_table(scratch.allocator, table, atSlot, path, OC_FILE_RESOLVE_SYMLINK_OPEN_LAST);
         if(resolve.error)
         {
             cmp.error = resolve.error;
@@ -683,6 +1240,10 @@ oc_io_cmp oc_io_remove(oc_io_req* req, oc_file_table* table)
         {
             cmp.error = oc_fd_remove(resolve.fd, resolve.name, req->removeFlags);
             oc_fd_close(resolve.fd);
+
+            //NOTE: drop the cached directories that were removed, even if the removal failed midway
+            oc_file root = atSlot ? oc_file_from_slot(table, atSlot) : oc_file_nil();
+            oc_file_dir_cache_invalidate(&table->dirCache, root, resolve.path);
         }
 
         oc_scratch_end(scratch);
@@ -690,83 +1251,284 @@ oc_io_cmp oc_io_remove(oc_io_req* req, oc_file_table* table)
     return cmp;
 }
 
-/*
-oc_io_error oc_io_copy_recursive(oc_file srcDir, oc_file dstDir, oc_io_req* req, oc_file_table* table)
+//------------------------------------------------------------------------
+// Directory copy
+//------------------------------------------------------------------------
+/*NOTE:
+    Directories are copied in a single request. The calling thread walks the source tree, creates the directories
+    and queues the files, which are copied by a bounded pool of workers. The queue is bounded too, which also bounds
+    the number of directories kept open, since a directory is closed once all its files are copied. When the queue
+    is full, the calling thread copies a file itself, so that the copy progresses even without workers.
+
+    Only regular files and directories are copied. Symlinks are skipped, since they could point outside the source
+    tree.
+*/
+enum
+{
+    OC_IO_COPY_THREAD_COUNT = 8,
+    OC_IO_COPY_QUEUE_SIZE = 128,
+    OC_IO_COPY_PARALLEL_THRESHOLD = 16, // number of queued files after which the workers are started
+};
+
+typedef struct oc_io_copy_dir
+{
+    oc_file_desc src;
+    oc_file_desc dst;
+    u32 refCount;
+} oc_io_copy_dir;
+
+typedef struct oc_io_copy_job
+{
+    oc_io_copy_dir* dir;
+    oc_str8 name;
+} oc_io_copy_job;
+
+typedef struct oc_io_copy_tree
+{
+    oc_mutex* mutex;
+    oc_condition* condition;
+
+    u32 first;
+    u32 count;
+    oc_io_copy_job jobs[OC_IO_COPY_QUEUE_SIZE];
+    u64 queuedCount;
+    bool done;
+    oc_io_error error;
+
+    u32 threadCount;
+    oc_thread* threads[OC_IO_COPY_THREAD_COUNT];
+} oc_io_copy_tree;
+
+static void oc_io_copy_dir_release(oc_io_copy_dir* dir)
+{
+    dir->refCount--;
+    if(dir->refCount == 0)
+    {
+        oc_fd_close(dir->src);
+        oc_fd_close(dir->dst);
+        free(dir);
+    }
+}
+
+static oc_io_error oc_io_copy_file_at(oc_io_copy_dir* dir, oc_str8 name)
 {
     oc_io_error error = OC_IO_OK;
+
+    oc_file_desc src = oc_catch(oc_fd_open_at(dir->src, name, OC_FILE_ACCESS_READ, OC_FILE_OPEN_DEFAULT))
+    {
+        return (oc_last_error());
+    }
+
+    oc_file_desc dst = oc_catch(oc_fd_open_at(dir->dst, name, OC_FILE_ACCESS_WRITE, OC_FILE_OPEN_CREATE))
+    {
+        error = oc_last_error();
+    }
+    else
+    {
+        error = oc_fd_copyfile(src, dst);
+        oc_fd_close(dst);
+    }
+    oc_fd_close(src);
+    return (error);
+}
+
+//NOTE: pops a job and copies its file. Must be called with the tree mutex locked.
+static void oc_io_copy_tree_run_job(oc_io_copy_tree* tree)
+{
+    oc_io_copy_job job = tree->jobs[tree->first];
+    tree->first = (tree->first + 1) % OC_IO_COPY_QUEUE_SIZE;
+    tree->count--;
+    bool skip = (tree->error != OC_IO_OK);
+
+    oc_mutex_unlock(tree->mutex);
+
+    oc_io_error error = skip ? OC_IO_OK : oc_io_copy_file_at(job.dir, job.name);
+    free(job.name.ptr);
+
+    oc_mutex_lock(tree->mutex);
+
+    if(error && !tree->error)
+    {
+        tree->error = error;
+    }
+    oc_io_copy_dir_release(job.dir);
+}
+
+static i32 oc_io_copy_tree_worker(void* user)
+{
+    oc_io_copy_tree* tree = (oc_io_copy_tree*)user;
+
+    oc_mutex_lock(tree->mutex);
+    while(1)
+    {
+        while(!tree->count && !tree->done)
+        {
+            oc_condition_wait(tree->condition, tree->mutex);
+        }
+        if(!tree->count)
+        {
+            break;
+        }
+        oc_io_copy_tree_run_job(tree);
+    }
+    oc_mutex_unlock(tree->mutex);
+    return (0);
+}
+
+static void oc_io_copy_tree_push(oc_io_copy_tree* tree, oc_io_copy_dir* dir, oc_str8 name)
+{
+    oc_mutex_lock(tree->mutex);
+
+    while(tree->count == OC_IO_COPY_QUEUE_SIZE)
+    {
+        oc_io_copy_tree_run_job(tree);
+    }
+
+    oc_io_copy_job* job = &tree->jobs[(tree->first + tree->count) % OC_IO_COPY_QUEUE_SIZE];
+    job->dir = dir;
+    job->name.len = name.len;
+    job->name.ptr = malloc(name.len + 1);
+    memcpy(job->name.ptr, name.ptr, name.len);
+    job->name.ptr[name.len] = '\0';
+
+    dir->refCount++;
+    tree->count++;
+    tree->queuedCount++;
+
+    oc_condition_signal(tree->condition);
+    oc_mutex_unlock(tree->mutex);
+
+    //NOTE: small trees are copied by the calling thread, to avoid paying for the creation of the workers
+    if(tree->queuedCount == OC_IO_COPY_PARALLEL_THRESHOLD)
+    {
+        tree->threadCount = oc_clamp(oc_processor_count(), 1, OC_IO_COPY_THREAD_COUNT) - 1;
+        for(u32 i = 0; i < tree->threadCount; i++)
+        {
+            tree->threads[i] = oc_thread_create_with_name(oc_io_copy_tree_worker, tree, OC_STR8("io copy"));
+        }
+    }
+}
+
+static oc_io_error oc_io_copy_tree_error(oc_io_copy_tree* tree)
+{
+    oc_mutex_lock(tree->mutex);
+    oc_io_error error = tree->error;
+    oc_mutex_unlock(tree->mutex);
+    return (error);
+}
+
+static void oc_io_copy_tree_set_error(oc_io_copy_tree* tree, oc_io_error error)
+{
+    oc_mutex_lock(tree->mutex);
+    if(!tree->error)
+    {
+        tree->error = error;
+    }
+    oc_mutex_unlock(tree->mutex);
+}
+
+//NOTE: takes ownership of srcFd and dstFd
+static void oc_io_copy_tree_walk(oc_io_copy_tree* tree, oc_file_desc srcFd, oc_file_desc dstFd)
+{
+    oc_io_copy_dir* dir = malloc(sizeof(oc_io_copy_dir));
+    *dir = (oc_io_copy_dir){
+        .src = srcFd,
+        .dst = dstFd,
+        .refCount = 1,
+    };
+
     oc_scratch scratch = oc_scratch_begin();
 
-    oc_file_list list = oc_file_listdir(scratch.arena, srcDir);
+    oc_file_list list = oc_catch(oc_fd_listdir(scratch.allocator, srcFd))
+    {
+        oc_io_copy_tree_set_error(tree, oc_last_error());
+    }
+
     oc_file_list_for(list, elt)
     {
-        oc_file_result srcRes = oc_file_open(elt->basename,
-                                                  OC_FILE_ACCESS_WRITE,
-                                                  &(oc_file_open_options){
-                                                      .root = srcDir,
-                                                      .resolve = OC_FILE_RESOLVE_SYMLINK_OPEN_LAST,
-                                                  });
-        oc_file srcFile = oc_catch(srcRes)
+        if(oc_io_copy_tree_error(tree))
         {
-            error = srcRes.error;
             break;
         }
-        oc_file_status srcStatus = oc_file_get_status(srcFile);
-        if(srcStatus.type == OC_FILE_REGULAR || srcStatus.type == OC_FILE_SYMLINK)
+
+        oc_file_type type = elt->type;
+        if(type == OC_FILE_UNKNOWN)
         {
-            oc_file_slot* srcFileSlot = oc_file_slot_from_handle(table, srcFile);
+            //NOTE: some filesystems don't report the type of entries
+            oc_file_status status = oc_result_if(oc_fd_stat_at(srcFd, elt->basename))
+            {
+                type = status.type;
+            }
+        }
 
-            oc_fd_result dstRes = oc_fd_open_at(dstDir, elt->basename, OC_FILE_ACCESS_WRITE, OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE);
-            oc_file_desc dstFd = oc_catch(dstRes)
+        if(type == OC_FILE_REGULAR)
+        {
+            oc_io_copy_tree_push(tree, dir, elt->basename);
+        }
+        else if(type == OC_FILE_DIRECTORY)
+        {
+            oc_io_error error = oc_fd_makedir_at(dstFd, elt->basename);
+            if(error && error != OC_IO_ERR_EXISTS)
             {
-                oc_file_close(srcFile);
-                error = dstRes.error;
+                oc_io_copy_tree_set_error(tree, error);
                 break;
             }
-            int r = fcopyfile(srcFileSlot->fd, dstFd, COPYFILE_ALL);
-            if(r)
+
+            oc_file_desc srcChild = oc_catch(oc_fd_open_at(srcFd, elt->basename, OC_FILE_ACCESS_READ, OC_FILE_OPEN_DEFAULT))
             {
-                error = OC_IO_ERR_UNKNOWN; //TODO
+                oc_io_copy_tree_set_error(tree, oc_last_error());
+                break;
             }
-            oc_fd_close(dstFd);
-        }
-        else if(srcStatus.type == OC_FILE_DIRECTORY)
-        {
-            oc_file_makedir(elt->basename,
-                            &(oc_file_makedir_options){
-                                .root = dstDir,
-                                .flags = OC_FILE_MAKEDIR_IGNORE_EXISTING,
-                            });
-            oc_file_result dstRes = oc_file_open(elt->basename,
-                                                      OC_FILE_ACCESS_WRITE,
-                                                      &(oc_file_makedir_options){
-                                                          .root = dstDir,
-                                                          .resolve = OC_FILE_RESOLVE_SYMLINK_OPEN_LAST,
-                                                      });
-            oc_file dstFile = oc_catch(dstRes)
+            oc_file_desc dstChild = oc_catch(oc_fd_open_at(dstFd, elt->basename, OC_FILE_ACCESS_WRITE, OC_FILE_OPEN_DEFAULT))
             {
-                error = dstRes.error;
+                oc_fd_close(srcChild);
+                oc_io_copy_tree_set_error(tree, oc_last_error());
                 break;
             }
-            error = oc_io_copy_recursive(srcFile, dstFile, req, table);
-
-            oc_file_close(dstFile);
-        }
-        oc_file_close(srcFile);
-        if(error)
-        {
-            break;
+            oc_io_copy_tree_walk(tree, srcChild, dstChild);
         }
     }
 
     oc_scratch_end(scratch);
 
-    return error;
+    oc_mutex_lock(tree->mutex);
+    oc_io_copy_dir_release(dir);
+    oc_mutex_unlock(tree->mutex);
+}
+
+static oc_io_error oc_io_copy_directory(oc_file_desc srcFd, oc_file_desc dstFd)
+{
+    oc_io_copy_tree tree = {
+        .mutex = oc_mutex_create(),
+        .condition = oc_condition_create(),
+    };
+
+    oc_io_copy_tree_walk(&tree, oc_fd_dup(srcFd), oc_fd_dup(dstFd));
+
+    //NOTE: wake up the workers so that they exit once the queue is empty, and help them drain it
+    oc_mutex_lock(tree.mutex);
+    tree.done = true;
+    oc_condition_broadcast(tree.condition);
+    oc_mutex_unlock(tree.mutex);
+
+    oc_io_copy_tree_worker(&tree);
+
+    for(u32 i = 0; i < tree.threadCount; i++)
+    {
+        if(tree.threads[i])
+        {
+            oc_thread_join(tree.threads[i], 0);
+        }
+    }
+    oc_condition_destroy(tree.condition);
+    oc_mutex_destroy(tree.mutex);
+
+    return (tree.error);
 }
-*/
 
 oc_io_cmp oc_io_copy(oc_io_req* req, oc_file_table* table)
 {
-    //NOTE: this only copies files to files
+    //NOTE: this copies files to files, or the contents of a directory into another directory
     oc_io_cmp cmp = { 0 };
 
     oc_file_slot* srcSlot = oc_catch(oc_file_slot_with_access(table, req->handle, OC_FILE_ACCESS_READ))
@@ -781,6 +1543,19 @@ oc_io_cmp oc_io_copy(oc_io_req* req, oc_file_table* table)
         return cmp;
     }
 
+    if(srcSlot->type == OC_FILE_DIRECTORY)
+    {
+        if(dstSlot->type != OC_FILE_DIRECTORY)
+        {
+            cmp.error = OC_IO_ERR_NOT_DIR;
+        }
+        else
+        {
+            cmp.error = oc_io_copy_directory(srcSlot->fd, dstSlot->fd);
+        }
+        return cmp;
+    }
+
     if(srcSlot->type != OC_FILE_REGULAR
        && srcSlot->type != OC_FILE_SYMLINK
        && dstSlot->type != OC_FILE_REGULAR
@@ -790,11 +1565,85 @@ oc_io_cmp oc_io_copy(oc_io_req* req, oc_file_table* table)
         return cmp;
     }
 
-    oc_fd_copyfile(srcSlot->fd, dstSlot->fd);
-
+    if(srcSlot->blob)
+    {
+        oc_str8 contents = srcSlot->blob->contents;
+        for(u64 offset = 0; offset < contents.len;)
+        {
+            u64 n = oc_catch(oc_fd_write(dstSlot->fd, contents.len - offset, contents.ptr + offset))
+            {
+                cmp.error = oc_last_error();
+                break;
+            }
+            offset += n;
+        }
+    }
+    else if(dstSlot->blob)
+    {
+        cmp.error = OC_IO_ERR_PERM;
+    }
+    else
+    {
+        cmp.error = oc_fd_copyfile(srcSlot->fd, dstSlot->fd);
+    }
     return cmp;
 }
 
+oc_io_cmp oc_io_open_blob_for_table(oc_file_blob* blob, oc_str8 name, oc_file_table* table)
+{
+    oc_io_cmp cmp = { 0 };
+
+    oc_file_slot* slot = oc_file_slot_alloc(table);
+    if(!slot)
+    {
+        if(blob->release)
+        {
+            blob->release(blob);
+        }
+        cmp.error = OC_IO_ERR_MAX_FILES;
+    }
+    else
+    {
+        slot->type = OC_FILE_REGULAR;
+        slot->rights = OC_FILE_ACCESS_READ;
+        slot->fd = oc_file_desc_nil();
+        slot->blob = blob;
+        if(name.len)
+        {
+            slot->name.len = name.len;
+            slot->name.ptr = malloc(name.len);
+            memcpy(slot->name.ptr, name.ptr, name.len);
+        }
+        cmp.handle = oc_file_from_slot(table, slot);
+    }
+    return (cmp);
+}
+
+oc_str8 oc_file_map(oc_file file)
+{
+    oc_str8 map = { 0 };
+    oc_file_slot* slot = oc_file_slot_from_handle(&oc_globalFileTable, file);
+    if(slot && slot->type == OC_FILE_REGULAR && !slot->blob)
+    {
+        oc_file_status status = oc_result_if(oc_fd_stat(slot->fd))
+        {
+            if(status.size)
+            {
+                map = oc_fd_map(slot->fd, status.size);
+            }
+        }
+    }
+    return (map);
+}
+
+void oc_file_unmap(oc_str8 map)
+{
+    if(map.ptr)
+    {
+        oc_fd_unmap(map);
+    }
+}
+
 //-----------------------------------------------------------------------
 // IO Dispatch
 //-----------------------------------------------------------------------
@@ -834,6 +1683,22 @@ oc_io_cmp oc_io_wait_single_req_for_table(oc_io_req* req, oc_file_table* table)
             cmp = oc_io_seek(req, table);
             break;
 
+        case OC_IO_PREAD:
+            cmp = oc_io_pread(req, table);
+            break;
+
+        case OC_IO_PWRITE:
+            cmp = oc_io_pwrite(req, table);
+            break;
+
+        case OC_IO_READV:
+            cmp = oc_io_readv(req, table);
+            break;
+
+        case OC_IO_WRITEV:
+            cmp = oc_io_writev(req, table);
+            break;
+
         case OC_IO_GETNAME:
             cmp = oc_io_getname(req, table);
             break;
@@ -12,7 +12,7 @@
 #include "platform_io_dialog.h"
 #include "util/wrapped_types.h"
 
-#if OC_PLATFORM_MACOS || PLATFORM_LINUX
+#if OC_PLATFORM_MACOS || OC_PLATFORM_LINUX
 typedef int oc_file_desc;
     #define OC_FILE_AT_FDCWD AT_FDCWD
 #elif OC_PLATFORM_WINDOWS
@@ -28,8 +28,22 @@ typedef HANDLE oc_file_desc;
 // File table and file handle functions
 //-----------------------------------------------------------------------
 
+//NOTE: read-only contents that back a file slot in place of a file descriptor, eg. a resource served out of the
+//      app bundle. The release callback is called when the slot is closed. It can be null if the blob outlives
+//      the slot.
+typedef struct oc_file_blob oc_file_blob;
+typedef void (*oc_file_blob_release_proc)(oc_file_blob* blob);
+
+typedef struct oc_file_blob
+{
+    oc_str8 contents;
+    oc_file_blob_release_proc release;
+    void* user;
+} oc_file_blob;
+
 typedef struct oc_file_slot
 {
+    u32 index;
     u32 generation;
     oc_io_error error;
     bool fatal;
@@ -39,19 +53,45 @@ typedef struct oc_file_slot
     oc_file_access rights;
     oc_file_desc fd;
 
+    oc_file_blob* blob;
+    u64 blobOffset;
+
     oc_str8 name;
 } oc_file_slot;
 
 enum
 {
-    OC_IO_MAX_FILE_SLOTS = 256,
+    OC_IO_FILE_SLOT_CHUNK_SIZE = 256,
+    OC_IO_DIR_CACHE_SIZE = 128,
 };
 
+//NOTE: cache of directories resolved under a root handle, keyed by the root and the normalized path of the
+//      directory relative to that root. The cache is direct-mapped: an entry is replaced by any other entry that
+//      hashes to the same index.
+typedef struct oc_file_dir_cache_entry
+{
+    oc_file root;
+    u64 hash;
+    oc_str8 path;
+    oc_file_desc fd;
+} oc_file_dir_cache_entry;
+
+typedef struct oc_file_dir_cache
+{
+    u32 count;
+    oc_file_dir_cache_entry entries[OC_IO_DIR_CACHE_SIZE];
+} oc_file_dir_cache;
+
 typedef struct oc_file_table
 {
-    oc_file_slot slots[OC_IO_MAX_FILE_SLOTS];
+    //NOTE: slots are allocated by chunks, so that pointers to slots stay valid when the table grows
+    u32 chunkCount;
+    u32 chunkCap;
+    oc_file_slot** chunks;
     u32 nextSlot;
     oc_list freeList;
+
+    oc_file_dir_cache dirCache;
 } oc_file_table;
 
 ORCA_API oc_file_table* oc_file_table_get_global();
@@ -81,6 +121,13 @@ ORCA_API oc_file_open_with_dialog_result oc_file_open_with_dialog_for_table(oc_a
 
 ORCA_API oc_file_list oc_file_listdir_for_table(oc_allocator* allocator, oc_file directory, oc_file_table* table);
 
+//NOTE: opens a read-only file handle over a blob. If the open fails, the blob is released.
+ORCA_API oc_io_cmp oc_io_open_blob_for_table(oc_file_blob* blob, oc_str8 name, oc_file_table* table);
+
+//NOTE: maps the contents of a regular file read-only. Returns an empty string if the file can't be mapped.
+ORCA_API oc_str8 oc_file_map(oc_file file);
+ORCA_API void oc_file_unmap(oc_str8 map);
+
 typedef oc_result_type(oc_file_list, oc_io_error) oc_fd_listdir_result;
 
 oc_fd_listdir_result oc_fd_listdir(oc_allocator* allocator, oc_file_desc dirFd);
@@ -124,6 +171,13 @@ typedef oc_result_type(u64, oc_io_error) oc_fd_readwrite_result;
 oc_fd_readwrite_result oc_fd_read(oc_file_desc fd, u64 size, char* buffer);
 oc_fd_readwrite_result oc_fd_write(oc_file_desc fd, u64 size, char* buffer);
 
+//NOTE: positional reads and writes don't move the file position. Vectored versions read or write the buffers in
+//      order, starting at offset, and stop at the first short transfer.
+oc_fd_readwrite_result oc_fd_pread(oc_file_desc fd, u64 offset, u64 size, char* buffer);
+oc_fd_readwrite_result oc_fd_pwrite(oc_file_desc fd, u64 offset, u64 size, char* buffer);
+oc_fd_readwrite_result oc_fd_preadv(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs);
+oc_fd_readwrite_result oc_fd_pwritev(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs);
+
 oc_fd_result oc_fd_maketmp(oc_file_slot* slot, oc_file_maketmp_flags flags);
 oc_io_error oc_fd_makedir_at(oc_file_desc fd, oc_str8 path);
 oc_io_error oc_fd_remove(oc_file_desc rootFd, oc_str8 path, oc_file_remove_flags flags);
@@ -131,3 +185,17 @@ oc_io_error oc_fd_remove(oc_file_desc rootFd, oc_str8 path, oc_file_remove_flags
 typedef oc_result_type(oc_str8, oc_io_error) oc_fd_read_link_result;
 
 oc_fd_read_link_result oc_fd_read_link_at(oc_allocator* allocator, oc_file_desc rootFd, oc_str8 path);
+
+/*NOTE:
+    oc_fd_open_dir_beneath() opens the directory designated by rootFd & path without following any symlink. It fails
+    with OC_IO_ERR_SYMLINK if an element of path is a symlink, and with OC_IO_ERR_WALKOUT if path is absolute or goes
+    through '..' above rootFd.
+
+    Unlike the other primitives, it _does_ enforce that path stays beneath rootFd, so it can be used by the path
+    resolver as a shortcut. It returns OC_IO_ERR_OP if the platform can't do this check atomically, in which case the
+    resolver walks the path element by element.
+*/
+oc_fd_result oc_fd_open_dir_beneath(oc_file_desc rootFd, oc_str8 path);
+
+oc_str8 oc_fd_map(oc_file_desc fd, u64 size);
+void oc_fd_unmap(oc_str8 map);
@@ -0,0 +1,261 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include "platform_trace.h"
+#include "platform_clock.h"
+#include "platform_memory.h"
+#include "platform_thread.h"
+
+typedef struct oc_trace_event
+{
+    f64 time;
+    const char* name; // null for zone end events
+
+} oc_trace_event;
+
+typedef struct oc_trace_thread oc_trace_thread;
+
+typedef struct oc_trace_thread
+{
+    oc_trace_thread* next;
+    u32 id;
+    char name[OC_THREAD_NAME_MAX_SIZE];
+
+    //NOTE: head is the total number of events written by the owning thread. Events are written
+    //      to events[head % OC_TRACE_THREAD_EVENT_COUNT] before head is published with a release store,
+    //      so that a dumping thread can copy the buffer without stopping the writer.
+    _Atomic(u64) head;
+    oc_trace_event events[OC_TRACE_THREAD_EVENT_COUNT];
+
+} oc_trace_thread;
+
+typedef struct oc_trace_state
+{
+    _Atomic(bool) recording;
+    _Atomic(f64) startTime;
+    _Atomic(u32) nextThreadId;
+    _Atomic(oc_trace_thread*) threads;
+
+} oc_trace_state;
+
+static oc_trace_state oc_traceState = { 0 };
+
+oc_thread_local oc_trace_thread* oc_traceThread = 0;
+oc_thread_local char oc_traceThreadName[OC_THREAD_NAME_MAX_SIZE] = { 0 };
+
+void oc_trace_start(void)
+{
+    atomic_store(&oc_traceState.startTime, oc_clock_time(OC_CLOCK_MONOTONIC));
+    atomic_store_explicit(&oc_traceState.recording, true, memory_order_release);
+}
+
+void oc_trace_stop(void)
+{
+    atomic_store_explicit(&oc_traceState.recording, false, memory_order_release);
+}
+
+bool oc_trace_is_recording(void)
+{
+    return (atomic_load_explicit(&oc_traceState.recording, memory_order_relaxed));
+}
+
+void oc_trace_set_thread_name(oc_str8 name)
+{
+    u64 len = oc_min(name.len, OC_THREAD_NAME_MAX_SIZE - 1);
+    memcpy(oc_traceThreadName, name.ptr, len);
+    oc_traceThreadName[len] = '\0';
+
+    if(oc_traceThread)
+    {
+        memcpy(oc_traceThread->name, oc_traceThreadName, OC_THREAD_NAME_MAX_SIZE);
+    }
+}
+
+static oc_trace_thread* oc_trace_thread_get(void)
+{
+    //NOTE: threads register lazily on their first event while recording. Records are never freed,
+    //      so that the dump can walk the list without synchronizing with thread exit.
+    if(!oc_traceThread)
+    {
+        oc_trace_thread* thread = oc_malloc_type(oc_trace_thread);
+        if(!thread)
+        {
+            return (0);
+        }
+        thread->id = atomic_fetch_add(&oc_traceState.nextThreadId, 1) + 1;
+        memcpy(thread->name, oc_traceThreadName, OC_THREAD_NAME_MAX_SIZE);
+        atomic_init(&thread->head, 0);
+
+        oc_trace_thread* head = atomic_load(&oc_traceState.threads);
+        do
+        {
+            thread->next = head;
+        }
+        while(!atomic_compare_exchange_weak(&oc_traceState.threads, &head, thread));
+
+        oc_traceThread = thread;
+    }
+    return (oc_traceThread);
+}
+
+static void oc_trace_push_event(const char* name)
+{
+    oc_trace_thread* thread = oc_trace_thread_get();
+    if(thread)
+    {
+        u64 head = atomic_load_explicit(&thread->head, memory_order_relaxed);
+        oc_trace_event* event = &thread->events[head % OC_TRACE_THREAD_EVENT_COUNT];
+        event->time = oc_clock_time(OC_CLOCK_MONOTONIC);
+        event->name = name;
+        atomic_store_explicit(&thread->head, head + 1, memory_order_release);
+    }
+}
+
+void oc_trace_begin(const char* name)
+{
+    if(atomic_load_explicit(&oc_traceState.recording, memory_order_relaxed))
+    {
+        oc_trace_push_event(name);
+    }
+}
+
+void oc_trace_end(void)
+{
+    if(atomic_load_explicit(&oc_traceState.recording, memory_order_relaxed))
+    {
+        oc_trace_push_event(0);
+    }
+}
+
+//---------------------------------------------------------------
+// Chrome trace-event export
+//---------------------------------------------------------------
+
+static oc_str8 oc_trace_escape(oc_allocator* allocator, const char* string)
+{
+    oc_str8_list list = { 0 };
+    u64 len = strlen(string);
+    u64 start = 0;
+    for(u64 i = 0; i < len; i++)
+    {
+        u8 c = (u8)string[i];
+        if(c == '"' || c == '\\' || c < 0x20)
+        {
+            oc_str8_list_push(allocator, &list, oc_str8_from_buffer(i - start, (char*)string + start));
+            oc_str8_list_pushf(allocator, &list, "\\u%04x", c);
+            start = i + 1;
+        }
+    }
+    oc_str8_list_push(allocator, &list, oc_str8_from_buffer(len - start, (char*)string + start));
+    return (oc_str8_list_join(allocator, list));
+}
+
+oc_io_error oc_trace_dump(oc_str8 path)
+{
+    oc_scratch scratch = oc_scratch_begin();
+
+    f64 startTime = atomic_load(&oc_traceState.startTime);
+    oc_str8_list events = { 0 };
+
+    for(oc_trace_thread* thread = atomic_load(&oc_traceState.threads); thread; thread = thread->next)
+    {
+        //NOTE: copy the window of events that haven't been overwritten yet, then re-read head and
+        //      drop the entries the writer may have reused while we were copying.
+        u64 head = atomic_load_explicit(&thread->head, memory_order_acquire);
+        u64 first = (head > OC_TRACE_THREAD_EVENT_COUNT) ? head - OC_TRACE_THREAD_EVENT_COUNT : 0;
+        u64 count = head - first;
+
+        oc_trace_event* copy = oc_arena_push_array_uninitialized(scratch.arena, oc_trace_event, count);
+        for(u64 i = 0; i < count; i++)
+        {
+            copy[i] = thread->events[(first + i) % OC_TRACE_THREAD_EVENT_COUNT];
+        }
+        atomic_thread_fence(memory_order_acquire);
+
+        u64 newHead = atomic_load_explicit(&thread->head, memory_order_relaxed);
+        u64 skip = 0;
+        if(newHead - first > OC_TRACE_THREAD_EVENT_COUNT)
+        {
+            skip = oc_min(count, newHead - first - OC_TRACE_THREAD_EVENT_COUNT);
+        }
+
+        char name[OC_THREAD_NAME_MAX_SIZE];
+        memcpy(name, thread->name, OC_THREAD_NAME_MAX_SIZE);
+        name[OC_THREAD_NAME_MAX_SIZE - 1] = '\0';
+        if(name[0] == '\0')
+        {
+            snprintf(name, OC_THREAD_NAME_MAX_SIZE, "thread %u", thread->id);
+        }
+        oc_str8 escapedName = oc_trace_escape(scratch.allocator, name);
+
+        oc_str8_list_pushf(scratch.allocator,
+                           &events,
+                           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%.*s\"}}",
+                           thread->id,
+                           oc_str8_ip(escapedName));
+
+        //NOTE: end events whose begin event was lost (either overwritten or recorded before the trace was started)
+        //      are dropped. Unterminated zones are left open, trace viewers close them at the end of the trace.
+        u32 depth = 0;
+        for(u64 i = skip; i < count; i++)
+        {
+            oc_trace_event* event = &copy[i];
+            if(event->time < startTime)
+            {
+                continue;
+            }
+            f64 ts = (event->time - startTime) * 1e6;
+
+            if(event->name)
+            {
+                oc_str8 escaped = oc_trace_escape(scratch.allocator, event->name);
+                oc_str8_list_pushf(scratch.allocator,
+                                   &events,
+                                   "{\"name\":\"%.*s\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                                   oc_str8_ip(escaped),
+                                   thread->id,
+                                   ts);
+                depth++;
+            }
+            else if(depth)
+            {
+                oc_str8_list_pushf(scratch.allocator,
+                                   &events,
+                                   "{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                                   thread->id,
+                                   ts);
+                depth--;
+            }
+        }
+    }
+
+    oc_str8 json = oc_str8_list_collate(scratch.allocator,
+                                        events,
+                                        OC_STR8("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"),
+                                        OC_STR8(",\n"),
+                                        OC_STR8("\n]}\n"));
+
+    oc_io_error error = OC_IO_OK;
+    oc_file_result fileRes = oc_file_open(path,
+                                          OC_FILE_ACCESS_WRITE,
+                                          &(oc_file_open_options){
+                                              .flags = OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE,
+                                          });
+    oc_file file = oc_catch(fileRes)
+    {
+        error = fileRes.error;
+    }
+    else
+    {
+        oc_file_write(file, json.len, json.ptr);
+        error = oc_file_last_error(file);
+        oc_file_close(file);
+    }
+
+    oc_scratch_end(scratch);
+    return (error);
+}
@@ -85,6 +85,11 @@ ORCA_API int oc_condition_broadcast(oc_condition* cond);
 //---------------------------------------------------------------
 ORCA_API void oc_sleep_nano(u64 nanoseconds); // sleep for a given number of nanoseconds
 
+//---------------------------------------------------------------
+// Processor count
+//---------------------------------------------------------------
+ORCA_API u32 oc_processor_count(void); // number of online logical processors, at least 1
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
@@ -0,0 +1,61 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "platform.h"
+#include "platform/io.h"
+#include "util/macros.h"
+#include "util/strings.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+//---------------------------------------------------------------
+// Frame timeline tracing
+//---------------------------------------------------------------
+//NOTE: threads record begin/end timestamps of named zones into their own ring buffer, which
+//      can be dumped as a Chrome trace-event JSON file (open it in ui.perfetto.dev or chrome://tracing).
+//
+//      Recording is off by default. When it is off, beginning or ending a zone only costs a relaxed
+//      atomic load. Each thread keeps the last OC_TRACE_THREAD_EVENT_COUNT events, older events are
+//      overwritten. Zone names are stored by pointer, so they must outlive the trace (eg. string literals).
+
+enum
+{
+    OC_TRACE_THREAD_EVENT_COUNT = 1 << 16,
+};
+
+#if !OC_PLATFORM_ORCA
+
+ORCA_API void oc_trace_start(void);
+ORCA_API void oc_trace_stop(void);
+ORCA_API bool oc_trace_is_recording(void);
+
+ORCA_API void oc_trace_set_thread_name(oc_str8 name);
+ORCA_API void oc_trace_begin(const char* name);
+ORCA_API void oc_trace_end(void);
+
+//NOTE: writes the events recorded since the last call to oc_trace_start() to a JSON file.
+//      Can be called while recording.
+ORCA_API oc_io_error oc_trace_dump(oc_str8 path);
+
+    #define oc_trace_zone(name) oc_defer_loop(oc_trace_begin(name), oc_trace_end())
+
+#else
+
+    //NOTE: wasm modules don't record traces, the host traces the calls they make to the runtime instead.
+    #define oc_trace_begin(name)
+    #define oc_trace_end()
+    #define oc_trace_zone(name)
+
+#endif // !OC_PLATFORM_ORCA
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // __cplusplus
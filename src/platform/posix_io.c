@@ -13,10 +13,20 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <dirent.h>
 
+#if OC_PLATFORM_LINUX
+    #include <sys/ioctl.h>
+    #include <sys/sendfile.h>
+    #include <sys/syscall.h>
+    #include <linux/fs.h>
+    #include <linux/openat2.h>
+#endif
+
 #include "native_io.c"
 
 //------------------------------------------------------------------------
@@ -265,7 +275,21 @@ oc_fd_result oc_fd_open_at(oc_file_desc dirFd, oc_str8 path, oc_file_access acce
     int flags = oc_fd_convert_access_rights(accessRights);
     flags |= oc_fd_convert_open_flags(openFlags);
     flags = oc_fd_update_dir_flags_at(dirFd, pathCStr, flags);
+#if OC_PLATFORM_MACOS
     flags |= O_SYMLINK; //NOTE: always open symlink, don't follow.
+#else
+    //NOTE: linux has no O_SYMLINK. If the target is a symlink, O_PATH|O_NOFOLLOW gives us a
+    //      handle to the link itself, otherwise O_NOFOLLOW is a no-op.
+    struct stat linkStat;
+    if(!fstatat(dirFd, pathCStr, &linkStat, AT_SYMLINK_NOFOLLOW) && S_ISLNK(linkStat.st_mode))
+    {
+        flags = O_PATH | O_NOFOLLOW;
+    }
+    else
+    {
+        flags |= O_NOFOLLOW;
+    }
+#endif
 
     mode_t mode = S_IRUSR
                 | S_IWUSR
@@ -322,9 +346,16 @@ oc_fd_stat_result oc_fd_stat(oc_file_desc fd)
         status.perm = oc_fd_convert_perm_from_stat(s.st_mode);
         status.type = oc_fd_convert_type_from_stat(s.st_mode);
         status.size = s.st_size;
+#if OC_PLATFORM_MACOS
         status.creationDate = oc_datestamp_from_timespec(s.st_birthtimespec);
         status.accessDate = oc_datestamp_from_timespec(s.st_atimespec);
         status.modificationDate = oc_datestamp_from_timespec(s.st_mtimespec);
+#else
+        //NOTE: struct stat has no birth time on linux, use the status change time instead.
+        status.creationDate = oc_datestamp_from_timespec(s.st_ctim);
+        status.accessDate = oc_datestamp_from_timespec(s.st_atim);
+        status.modificationDate = oc_datestamp_from_timespec(s.st_mtim);
+#endif
 
         result = oc_result_value(oc_fd_stat_result, status);
     }
@@ -357,9 +388,16 @@ oc_fd_stat_result oc_fd_stat_at(oc_file_desc dirFd, oc_str8 path)
         status.perm = oc_fd_convert_perm_from_stat(s.st_mode);
         status.type = oc_fd_convert_type_from_stat(s.st_mode);
         status.size = s.st_size;
+#if OC_PLATFORM_MACOS
         status.creationDate = oc_datestamp_from_timespec(s.st_birthtimespec);
         status.accessDate = oc_datestamp_from_timespec(s.st_atimespec);
         status.modificationDate = oc_datestamp_from_timespec(s.st_mtimespec);
+#else
+        //NOTE: struct stat has no birth time on linux, use the status change time instead.
+        status.creationDate = oc_datestamp_from_timespec(s.st_ctim);
+        status.accessDate = oc_datestamp_from_timespec(s.st_atim);
+        status.modificationDate = oc_datestamp_from_timespec(s.st_mtim);
+#endif
 
         result = oc_result_value(oc_fd_stat_result, status);
     }
@@ -399,6 +437,101 @@ oc_fd_read_link_result oc_fd_read_link_at(oc_allocator* allocator, oc_file_desc
     return (result);
 }
 
+#if OC_PLATFORM_LINUX && defined(SYS_openat2)
+
+//NOTE: set once openat2() has failed for reasons other than the path, e.g. the kernel is older than 5.6 or
+//      a seccomp filter rejects it, so that we don't retry it on every open.
+static bool oc_fd_openat2Unsupported = false;
+
+oc_fd_result oc_fd_open_dir_beneath(oc_file_desc rootFd, oc_str8 path)
+{
+    if(oc_fd_openat2Unsupported || oc_file_desc_is_nil(rootFd))
+    {
+        return oc_result_error(oc_fd_result, OC_IO_ERR_OP);
+    }
+
+    oc_scratch scratch = oc_scratch_begin();
+    char* pathCStr = oc_str8_to_cstring(scratch.allocator, path);
+
+    struct open_how how = {
+        .flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC,
+        .resolve = RESOLVE_BENEATH | RESOLVE_NO_SYMLINKS,
+    };
+
+    int fd = -1;
+    do
+    {
+        fd = syscall(SYS_openat2, rootFd, pathCStr, &how, sizeof(how));
+    }
+    while(fd < 0 && errno == EINTR);
+
+    int err = errno;
+    oc_scratch_end(scratch);
+
+    if(fd >= 0)
+    {
+        return oc_result_value(oc_fd_result, fd);
+    }
+
+    oc_io_error error = OC_IO_OK;
+    switch(err)
+    {
+        case EXDEV:
+            //NOTE: path is absolute or goes through '..' above rootFd
+            error = OC_IO_ERR_WALKOUT;
+            break;
+
+        case ELOOP:
+            //NOTE: RESOLVE_NO_SYMLINKS hit a symlink
+            error = OC_IO_ERR_SYMLINK;
+            break;
+
+        case ENOSYS:
+        case EPERM:
+        case E2BIG:
+        case EINVAL:
+            oc_fd_openat2Unsupported = true;
+            error = OC_IO_ERR_OP;
+            break;
+
+        case EAGAIN:
+            //NOTE: a concurrent rename raced with a '..' lookup, let the resolver do the walk
+            error = OC_IO_ERR_OP;
+            break;
+
+        default:
+            errno = err;
+            error = oc_fd_convert_errno();
+            break;
+    }
+    return oc_result_error(oc_fd_result, error);
+}
+
+#else
+
+oc_fd_result oc_fd_open_dir_beneath(oc_file_desc rootFd, oc_str8 path)
+{
+    return oc_result_error(oc_fd_result, OC_IO_ERR_OP);
+}
+
+#endif
+
+oc_str8 oc_fd_map(oc_file_desc fd, u64 size)
+{
+    oc_str8 map = { 0 };
+    void* ptr = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(ptr != MAP_FAILED)
+    {
+        map = oc_str8_from_buffer(size, ptr);
+    }
+    return (map);
+}
+
+void oc_fd_unmap(oc_str8 map)
+{
+    munmap(map.ptr, map.len);
+}
+
 oc_fd_seek_result oc_fd_seek(oc_file_desc fd, u64 offset, oc_file_whence whence)
 {
     oc_fd_seek_result result = oc_result_value(oc_fd_seek_result, 0);
@@ -463,6 +596,118 @@ oc_fd_readwrite_result oc_fd_write(oc_file_desc fd, u64 size, char* buffer)
     }
 }
 
+oc_fd_readwrite_result oc_fd_pread(oc_file_desc fd, u64 offset, u64 size, char* buffer)
+{
+    ssize_t r = pread(fd, buffer, size, offset);
+    if(r < 0)
+    {
+        return oc_result_error(oc_fd_readwrite_result, oc_fd_convert_errno());
+    }
+    else
+    {
+        return oc_result_value(oc_fd_readwrite_result, (u64)r);
+    }
+}
+
+oc_fd_readwrite_result oc_fd_pwrite(oc_file_desc fd, u64 offset, u64 size, char* buffer)
+{
+    ssize_t r = pwrite(fd, buffer, size, offset);
+    if(r < 0)
+    {
+        return oc_result_error(oc_fd_readwrite_result, oc_fd_convert_errno());
+    }
+    else
+    {
+        return oc_result_value(oc_fd_readwrite_result, (u64)r);
+    }
+}
+
+#if OC_PLATFORM_LINUX
+
+enum
+{
+    OC_FD_IOV_BATCH = 64,
+};
+
+static oc_fd_readwrite_result oc_fd_preadv_pwritev(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs, bool write)
+{
+    //NOTE: submit the buffers in batches, since the number of iovecs per call is limited
+    u64 total = 0;
+    for(u64 first = 0; first < count;)
+    {
+        struct iovec iov[OC_FD_IOV_BATCH];
+        u64 batchCount = oc_min(count - first, OC_FD_IOV_BATCH);
+        u64 batchSize = 0;
+        for(u64 i = 0; i < batchCount; i++)
+        {
+            iov[i].iov_base = vecs[first + i].buffer;
+            iov[i].iov_len = vecs[first + i].size;
+            batchSize += vecs[first + i].size;
+        }
+
+        ssize_t r = write
+                      ? pwritev(fd, iov, batchCount, offset + total)
+                      : preadv(fd, iov, batchCount, offset + total);
+        if(r < 0)
+        {
+            if(total)
+            {
+                break;
+            }
+            return oc_result_error(oc_fd_readwrite_result, oc_fd_convert_errno());
+        }
+        total += r;
+        first += batchCount;
+
+        if((u64)r < batchSize)
+        {
+            break;
+        }
+    }
+    return oc_result_value(oc_fd_readwrite_result, total);
+}
+
+#else
+
+static oc_fd_readwrite_result oc_fd_preadv_pwritev(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs, bool write)
+{
+    //NOTE: preadv()/pwritev() are only available from macOS 11, so we issue one call per buffer
+    u64 total = 0;
+    for(u64 i = 0; i < count; i++)
+    {
+        ssize_t r = write
+                      ? pwrite(fd, vecs[i].buffer, vecs[i].size, offset + total)
+                      : pread(fd, vecs[i].buffer, vecs[i].size, offset + total);
+        if(r < 0)
+        {
+            if(total)
+            {
+                break;
+            }
+            return oc_result_error(oc_fd_readwrite_result, oc_fd_convert_errno());
+        }
+        total += r;
+
+        if((u64)r < vecs[i].size)
+        {
+            break;
+        }
+    }
+    return oc_result_value(oc_fd_readwrite_result, total);
+}
+
+#endif
+
+oc_fd_readwrite_result oc_fd_preadv(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs)
+{
+    return (oc_fd_preadv_pwritev(fd, offset, count, vecs, false));
+}
+
+oc_fd_readwrite_result oc_fd_pwritev(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs)
+{
+    return (oc_fd_preadv_pwritev(fd, offset, count, vecs, true));
+}
+
 oc_fd_result oc_fd_maketmp(oc_file_slot* slot, oc_file_maketmp_flags flags)
 {
     oc_scratch scratch = oc_scratch_begin();
@@ -540,7 +785,12 @@ oc_io_error oc_fd_remove(oc_file_desc rootFd, oc_str8 path, oc_file_remove_flags
         }
         else
         {
+#if OC_PLATFORM_MACOS
             int flags = AT_SYMLINK_NOFOLLOW_ANY;
+#else
+            //NOTE: unlinkat never follows the final symlink on linux
+            int flags = 0;
+#endif
             if(status.type == OC_FILE_DIRECTORY)
             {
                 flags |= AT_REMOVEDIR;
@@ -567,7 +817,8 @@ oc_fd_listdir_result oc_fd_listdir(oc_allocator* allocator, oc_file_desc dirFd)
 {
     oc_file_list list = { 0 };
 
-    DIR* dir = fdopendir(dirFd);
+    //NOTE: closedir() closes the underlying descriptor, so we open the stream on a copy
+    DIR* dir = fdopendir(dup(dirFd));
     if(dir)
     {
         struct dirent* entry = NULL;
@@ -612,7 +863,7 @@ oc_fd_listdir_result oc_fd_listdir(oc_allocator* allocator, oc_file_desc dirFd)
                     break;
             }
 
-            elt->basename = oc_str8_push_buffer(allocator, entry->d_namlen, entry->d_name);
+            elt->basename = oc_str8_push_buffer(allocator, strlen(entry->d_name), entry->d_name);
             elt->type = type;
         }
 
@@ -634,7 +885,7 @@ oc_file_list oc_file_listdir_for_table(oc_allocator* allocator, oc_file director
         return list;
     }
 
-    if(slot && !slot->fatal)
+    if(slot && !slot->fatal && !slot->blob)
     {
         DIR* dir = fdopendir(dup(slot->fd));
         if(dir)
@@ -681,7 +932,7 @@ oc_file_list oc_file_listdir_for_table(oc_allocator* allocator, oc_file director
                         break;
                 }
 
-                elt->basename = oc_str8_push_buffer(allocator, entry->d_namlen, entry->d_name);
+                elt->basename = oc_str8_push_buffer(allocator, strlen(entry->d_name), entry->d_name);
                 elt->type = type;
             }
 
@@ -696,8 +947,9 @@ oc_file_list oc_file_listdir_for_table(oc_allocator* allocator, oc_file director
     return list;
 }
 
+#if OC_PLATFORM_MACOS
 //TODO: this is not posix!
-#include <copyfile.h>
+    #include <copyfile.h>
 
 oc_io_error oc_fd_copyfile(oc_file_desc srcFd, oc_file_desc dstFd)
 {
@@ -709,6 +961,161 @@ oc_io_error oc_fd_copyfile(oc_file_desc srcFd, oc_file_desc dstFd)
     }
     return err;
 }
+#else
+static oc_io_error oc_fd_copyfile_readwrite(oc_file_desc srcFd, oc_file_desc dstFd)
+{
+    oc_io_error err = OC_IO_OK;
+    char chunk[64 << 10];
+
+    if(lseek(srcFd, 0, SEEK_SET) < 0 || ftruncate(dstFd, 0) || lseek(dstFd, 0, SEEK_SET) < 0)
+    {
+        return oc_fd_convert_errno();
+    }
+
+    while(1)
+    {
+        ssize_t n = read(srcFd, chunk, sizeof(chunk));
+        if(n == 0)
+        {
+            break;
+        }
+        else if(n < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            err = oc_fd_convert_errno();
+            break;
+        }
+
+        for(ssize_t written = 0; written < n;)
+        {
+            ssize_t w = write(dstFd, chunk + written, n - written);
+            if(w < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                return oc_fd_convert_errno();
+            }
+            written += w;
+        }
+    }
+    return err;
+}
+
+    #if OC_PLATFORM_LINUX
+
+typedef enum oc_fd_copy_result
+{
+    OC_FD_COPY_DONE,
+    OC_FD_COPY_ERROR,
+    OC_FD_COPY_UNSUPPORTED,
+} oc_fd_copy_result;
+
+static oc_fd_copy_result oc_fd_copyfile_range(oc_file_desc srcFd, oc_file_desc dstFd, bool useSendfile)
+{
+    //NOTE: copy_file_range() lets the filesystem share or copy the extents without going through user space.
+    //      It fails across filesystems on older kernels, and on some special filesystems, in which case we try
+    //      sendfile(), which still avoids the copy to user space.
+    off_t offset = 0;
+    while(1)
+    {
+        ssize_t n = 0;
+        if(useSendfile)
+        {
+            n = sendfile(dstFd, srcFd, &offset, 1 << 30);
+        }
+        else
+        {
+            off_t dstOffset = offset;
+            n = copy_file_range(srcFd, &offset, dstFd, &dstOffset, 1 << 30, 0);
+        }
+
+        if(n == 0)
+        {
+            return (OC_FD_COPY_DONE);
+        }
+        else if(n < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            else if(offset == 0
+                    && (errno == ENOSYS
+                        || errno == EXDEV
+                        || errno == EINVAL
+                        || errno == EOPNOTSUPP
+                        || errno == EBADF))
+            {
+                return (OC_FD_COPY_UNSUPPORTED);
+            }
+            return (OC_FD_COPY_ERROR);
+        }
+    }
+}
+
+oc_io_error oc_fd_copyfile(oc_file_desc srcFd, oc_file_desc dstFd)
+{
+    struct stat s;
+    if(fstat(srcFd, &s) || ftruncate(dstFd, 0))
+    {
+        return oc_fd_convert_errno();
+    }
+
+    oc_io_error err = OC_IO_OK;
+
+    //NOTE: first try to clone the file, which only shares its extents on copy-on-write filesystems, then copy it
+    //      in the kernel, and finally fall back to copying it through a buffer.
+    bool cloned = false;
+        #ifdef FICLONE
+    cloned = (ioctl(dstFd, FICLONE, srcFd) == 0);
+        #endif
+
+    if(!cloned)
+    {
+        oc_fd_copy_result result = oc_fd_copyfile_range(srcFd, dstFd, false);
+        if(result == OC_FD_COPY_UNSUPPORTED)
+        {
+            result = oc_fd_copyfile_range(srcFd, dstFd, true);
+        }
+
+        if(result == OC_FD_COPY_UNSUPPORTED)
+        {
+            err = oc_fd_copyfile_readwrite(srcFd, dstFd);
+        }
+        else if(result == OC_FD_COPY_ERROR)
+        {
+            err = oc_fd_convert_errno();
+        }
+    }
+
+    if(err == OC_IO_OK)
+    {
+        fchmod(dstFd, s.st_mode & 07777);
+    }
+    return err;
+}
+    #else
+
+oc_io_error oc_fd_copyfile(oc_file_desc srcFd, oc_file_desc dstFd)
+{
+    oc_io_error err = oc_fd_copyfile_readwrite(srcFd, dstFd);
+    if(err == OC_IO_OK)
+    {
+        struct stat s;
+        if(fstat(srcFd, &s) == 0)
+        {
+            fchmod(dstFd, s.st_mode & 07777);
+        }
+    }
+    return err;
+}
+    #endif
+#endif
 
 oc_str8 oc_file_tmp_directory_path(oc_allocator* allocator)
 {
@@ -13,6 +13,7 @@
 #include <unistd.h> // nanosleep()
 
 #include "platform_thread.h"
+#include "platform_trace.h"
 
 struct oc_thread
 {
@@ -29,7 +30,12 @@ static void* oc_thread_bootstrap(void* data)
     oc_thread* thread = (oc_thread*)data;
     if(thread->name.len)
     {
+    #if OC_PLATFORM_MACOS
         pthread_setname_np(thread->nameBuffer);
+    #else
+        pthread_setname_np(pthread_self(), thread->nameBuffer);
+    #endif
+        oc_trace_set_thread_name(thread->name);
     }
     i32 exitCode = thread->start(thread->userPointer);
     return ((void*)(ptrdiff_t)exitCode);
@@ -81,17 +87,26 @@ oc_str8 oc_thread_get_name(oc_thread* thread)
 
 u64 oc_thread_unique_id(oc_thread* thread)
 {
+#if OC_PLATFORM_MACOS
     u64 id;
     pthread_threadid_np(thread->pthread, &id);
     return (id);
+#else
+    //NOTE: pthread_t is an integer handle on linux, unique among live threads
+    return ((u64)thread->pthread);
+#endif
 }
 
 u64 oc_thread_self_id()
 {
     pthread_t thread = pthread_self();
+#if OC_PLATFORM_MACOS
     u64 id;
     pthread_threadid_np(thread, &id);
     return (id);
+#else
+    return ((u64)thread);
+#endif
 }
 
 int oc_thread_signal(oc_thread* thread, int sig)
@@ -249,8 +264,14 @@ int oc_condition_broadcast(oc_condition* cond)
 
 void oc_sleep_nano(u64 nanoseconds)
 {
-    timespec rqtp;
+    struct timespec rqtp;
     rqtp.tv_sec = nanoseconds / 1000000000;
     rqtp.tv_nsec = nanoseconds - rqtp.tv_sec * 1000000000;
     nanosleep(&rqtp, 0);
 }
+
+u32 oc_processor_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0 ? (u32)count : 1);
+}
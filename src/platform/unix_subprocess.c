@@ -1,5 +1,6 @@
 #include <unistd.h>
 #include <errno.h>
+#include <sys/wait.h>
 
 #include "subprocess.c"
 
@@ -441,6 +441,82 @@ oc_fd_readwrite_result oc_fd_write(oc_file_desc fd, u64 size, char* buffer)
     }
 }
 
+static oc_fd_readwrite_result oc_fd_pread_pwrite(oc_file_desc fd, u64 offset, u64 size, char* buffer, bool write)
+{
+    //NOTE: passing an offset in an OVERLAPPED struct makes the transfer positional. For synchronous handles,
+    //      this also moves the file pointer, so we restore it afterwards.
+    LARGE_INTEGER pos = { 0 };
+    SetFilePointerEx(fd, (LARGE_INTEGER){ 0 }, &pos, FILE_CURRENT);
+
+    OVERLAPPED overlapped = {
+        .Offset = (DWORD)(offset & 0xffffffff),
+        .OffsetHigh = (DWORD)(offset >> 32),
+    };
+    DWORD transferred = 0;
+    BOOL ok = write
+                ? WriteFile(fd, buffer, size, &transferred, &overlapped)
+                : ReadFile(fd, buffer, size, &transferred, &overlapped);
+
+    oc_fd_readwrite_result result = { 0 };
+    if(!ok && GetLastError() != ERROR_HANDLE_EOF)
+    {
+        result = oc_result_error(oc_fd_readwrite_result, oc_fd_last_error());
+    }
+    else
+    {
+        result = oc_result_value(oc_fd_readwrite_result, (u64)transferred);
+    }
+
+    SetFilePointerEx(fd, pos, NULL, FILE_BEGIN);
+    return (result);
+}
+
+oc_fd_readwrite_result oc_fd_pread(oc_file_desc fd, u64 offset, u64 size, char* buffer)
+{
+    return (oc_fd_pread_pwrite(fd, offset, size, buffer, false));
+}
+
+oc_fd_readwrite_result oc_fd_pwrite(oc_file_desc fd, u64 offset, u64 size, char* buffer)
+{
+    return (oc_fd_pread_pwrite(fd, offset, size, buffer, true));
+}
+
+static oc_fd_readwrite_result oc_fd_preadv_pwritev(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs, bool write)
+{
+    //NOTE: ReadFileScatter()/WriteFileGather() need page-sized buffers and unbuffered handles, so we issue one call
+    //      per buffer.
+    u64 total = 0;
+    for(u64 i = 0; i < count; i++)
+    {
+        oc_fd_readwrite_result r = oc_fd_pread_pwrite(fd, offset + total, vecs[i].size, vecs[i].buffer, write);
+        if(!oc_result_check(r))
+        {
+            if(total)
+            {
+                break;
+            }
+            return (r);
+        }
+        total += r.value;
+
+        if(r.value < vecs[i].size)
+        {
+            break;
+        }
+    }
+    return oc_result_value(oc_fd_readwrite_result, total);
+}
+
+oc_fd_readwrite_result oc_fd_preadv(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs)
+{
+    return (oc_fd_preadv_pwritev(fd, offset, count, vecs, false));
+}
+
+oc_fd_readwrite_result oc_fd_pwritev(oc_file_desc fd, u64 offset, u64 count, oc_io_vec* vecs)
+{
+    return (oc_fd_preadv_pwritev(fd, offset, count, vecs, true));
+}
+
 oc_io_error oc_fd_copyfile(oc_file_desc srcFd, oc_file_desc dstFd)
 {
     oc_io_error err = OC_IO_OK;
@@ -450,7 +526,7 @@ oc_io_error oc_fd_copyfile(oc_file_desc srcFd, oc_file_desc dstFd)
     oc_str16 dstPathW = win32_path_from_handle_null_terminated(scratch.allocator, dstFd);
 
     BOOL r = CopyFileW(srcPathW.ptr, dstPathW.ptr, FALSE);
-    if(r)
+    if(!r)
     {
         err = oc_fd_last_error();
     }
@@ -639,65 +715,113 @@ oc_fd_read_link_result oc_fd_read_link_at(oc_allocator* allocator, oc_file_desc
     return (oc_fd_read_link_result){ 0 };
 }
 
-oc_file_list oc_file_listdir_for_table(oc_allocator* allocator, oc_file directory, oc_file_table* table)
+oc_fd_result oc_fd_open_dir_beneath(oc_file_desc rootFd, oc_str8 path)
 {
-    oc_file_list list = { 0 };
+    //NOTE: no equivalent of openat2(RESOLVE_BENEATH), let the resolver walk the path
+    return oc_result_error(oc_fd_result, OC_IO_ERR_OP);
+}
 
-    oc_file_slot* slot = oc_file_slot_from_handle(table, directory);
-    if(slot && !slot->fatal)
+oc_str8 oc_fd_map(oc_file_desc fd, u64 size)
+{
+    oc_str8 map = { 0 };
+    HANDLE mapping = CreateFileMappingW(fd, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(mapping)
     {
-        oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
+        void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+        if(ptr)
+        {
+            map = oc_str8_from_buffer(size, ptr);
+        }
+        //NOTE: the view keeps the mapping alive
+        CloseHandle(mapping);
+    }
+    return (map);
+}
 
-        // Windows uses a trailing \* to determine it should enumerate all files in the folder
-        oc_str16 dirPathW = win32_get_path_at_null_terminated(scratch.allocator, slot->fd, OC_STR8("\\*"));
+void oc_fd_unmap(oc_str8 map)
+{
+    UnmapViewOfFile(map.ptr);
+}
 
-        WIN32_FIND_DATAW entry = { 0 };
+oc_fd_listdir_result oc_fd_listdir(oc_allocator* allocator, oc_file_desc dirFd)
+{
+    oc_file_list list = { 0 };
+    oc_io_error error = OC_IO_OK;
 
-        HANDLE handle = FindFirstFileW(dirPathW.ptr, &entry);
-        if(handle == INVALID_HANDLE_VALUE)
-        {
-            slot->error = oc_fd_last_error();
-        }
-        else
+    oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
+
+    // Windows uses a trailing \* to determine it should enumerate all files in the folder
+    oc_str16 dirPathW = win32_get_path_at_null_terminated(scratch.allocator, dirFd, OC_STR8("\\*"));
+
+    WIN32_FIND_DATAW entry = { 0 };
+
+    HANDLE handle = FindFirstFileW(dirPathW.ptr, &entry);
+    if(handle == INVALID_HANDLE_VALUE)
+    {
+        error = oc_fd_last_error();
+    }
+    else
+    {
+        do
         {
-            do
+            if(!StrCmpW(u".", entry.cFileName) || !StrCmpW(u"..", entry.cFileName))
             {
-                if(!StrCmpW(u".", entry.cFileName) || !StrCmpW(u"..", entry.cFileName))
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                oc_file_listdir_elt* elt = oc_allocator_push_type(allocator, oc_file_listdir_elt);
-                oc_list_push_back(&list.list, &elt->listElt);
+            oc_file_listdir_elt* elt = oc_allocator_push_type(allocator, oc_file_listdir_elt);
+            oc_list_push_back(&list.list, &elt->listElt);
 
-                ++list.eltCount;
+            ++list.eltCount;
 
-                elt->type = OC_FILE_UNKNOWN;
-                if(entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
-                {
-                    if(entry.dwReserved0 & IO_REPARSE_TAG_SYMLINK)
-                    {
-                        elt->type = OC_FILE_SYMLINK;
-                    }
-                }
-                if(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
-                {
-                    elt->type = OC_FILE_DIRECTORY;
-                }
-                else if(entry.dwFileAttributes & OC_WIN32_REGULAR_ATTRIBUTE_SET)
+            elt->type = OC_FILE_UNKNOWN;
+            if(entry.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+            {
+                if(entry.dwReserved0 & IO_REPARSE_TAG_SYMLINK)
                 {
-                    elt->type = OC_FILE_REGULAR;
+                    elt->type = OC_FILE_SYMLINK;
                 }
-
-                oc_str16 basename16 = { .ptr = entry.cFileName, lstrlenW(entry.cFileName) };
-                elt->basename = oc_win32_wide_to_utf8(allocator, basename16);
             }
-            while(FindNextFileW(handle, &entry));
+            if(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            {
+                elt->type = OC_FILE_DIRECTORY;
+            }
+            else if(entry.dwFileAttributes & OC_WIN32_REGULAR_ATTRIBUTE_SET)
+            {
+                elt->type = OC_FILE_REGULAR;
+            }
 
-            FindClose(handle);
+            oc_str16 basename16 = { .ptr = entry.cFileName, lstrlenW(entry.cFileName) };
+            elt->basename = oc_win32_wide_to_utf8(allocator, basename16);
         }
+        while(FindNextFileW(handle, &entry));
+
+        FindClose(handle);
+    }
+
+    oc_scratch_end(scratch);
+
+    if(error)
+    {
+        return oc_result_error(oc_fd_listdir_result, error);
+    }
+    else
+    {
+        return oc_result_value(oc_fd_listdir_result, list);
+    }
+}
+
+oc_file_list oc_file_listdir_for_table(oc_allocator* allocator, oc_file directory, oc_file_table* table)
+{
+    oc_file_list list = { 0 };
 
-        oc_scratch_end(scratch);
+    oc_file_slot* slot = oc_file_slot_from_handle(table, directory);
+    if(slot && !slot->fatal && !slot->blob)
+    {
+        list = oc_catch(oc_fd_listdir(allocator, slot->fd))
+        {
+            slot->error = oc_last_error();
+        }
     }
 
     return list;
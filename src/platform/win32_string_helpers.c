@@ -10,23 +10,49 @@
 #include <windows.h>
 
 #include "win32_string_helpers.h"
+#include "util/utf8.h"
 
 oc_str16 oc_win32_utf8_to_wide(oc_allocator* allocator, oc_str8 s)
 {
+    //NOTE: utf8 never takes less bytes than utf16 code units, and MultiByteToWideChar replaces each invalid byte by a
+    //      single code unit, so s.len + 1 code units are always enough. The leading ASCII characters are converted
+    //      directly, and the rest, if any, is converted by MultiByteToWideChar.
     oc_str16 res = { 0 };
-    res.len = 1 + MultiByteToWideChar(CP_UTF8, 0, s.ptr, s.len, NULL, 0);
-    res.ptr = oc_allocator_push_array(allocator, u16, res.len);
-    MultiByteToWideChar(CP_UTF8, 0, s.ptr, s.len, res.ptr, res.len);
+    res.ptr = oc_allocator_push_array(allocator, u16, s.len + 1);
+
+    u64 asciiCount = oc_utf8_ascii_to_utf16(s, res.ptr);
+    u64 count = asciiCount;
+    if(asciiCount < s.len)
+    {
+        count += MultiByteToWideChar(CP_UTF8, 0, s.ptr + asciiCount, s.len - asciiCount, res.ptr + asciiCount, s.len - asciiCount);
+    }
+    res.len = count + 1;
     res.ptr[res.len - 1] = '\0';
     return (res);
 }
 
 oc_str8 oc_win32_wide_to_utf8(oc_allocator* allocator, oc_str16 s)
 {
+    //NOTE: the leading ASCII characters are converted directly, optimistically assuming that the whole string is
+    //      ASCII. Otherwise the rest is converted by WideCharToMultiByte, in a larger buffer if needed.
     oc_str8 res = { 0 };
-    res.len = WideCharToMultiByte(CP_UTF8, 0, s.ptr, s.len, NULL, 0, NULL, NULL);
-    res.ptr = oc_allocator_push_array(allocator, char, res.len + 1);
-    WideCharToMultiByte(CP_UTF8, 0, s.ptr, s.len, res.ptr, res.len, NULL, NULL);
+    res.ptr = oc_allocator_push_array(allocator, char, s.len + 1);
+    res.len = oc_utf16_ascii_to_utf8(s, res.ptr);
+
+    if(res.len < s.len)
+    {
+        u16* rest = s.ptr + res.len;
+        int restLen = s.len - res.len;
+        int restSize = WideCharToMultiByte(CP_UTF8, 0, rest, restLen, NULL, 0, NULL, NULL);
+        if(res.len + restSize > s.len)
+        {
+            char* ptr = oc_allocator_push_array(allocator, char, res.len + restSize + 1);
+            memcpy(ptr, res.ptr, res.len);
+            res.ptr = ptr;
+        }
+        WideCharToMultiByte(CP_UTF8, 0, rest, restLen, res.ptr + res.len, restSize, NULL, NULL);
+        res.len += restSize;
+    }
     res.ptr[res.len] = '\0';
     return (res);
 }
@@ -11,6 +11,7 @@
 #include <winuser.h> // PostMessage
 
 #include "platform_thread.h"
+#include "platform_trace.h"
 
 struct oc_thread
 {
@@ -25,6 +26,10 @@ struct oc_thread
 static DWORD WINAPI oc_thread_bootstrap(LPVOID lpParameter)
 {
     oc_thread* thread = (oc_thread*)lpParameter;
+    if(thread->name.len)
+    {
+        oc_trace_set_thread_name(thread->name);
+    }
     i32 exitCode = thread->start(thread->userPointer);
     return (exitCode);
 }
@@ -258,3 +263,10 @@ void oc_sleep_nano(u64 nanoseconds)
 
     CloseHandle(timer);
 }
+
+u32 oc_processor_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1);
+}
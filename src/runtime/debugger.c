@@ -21,10 +21,33 @@ void debug_overlay_toggle(oc_debug_overlay* overlay)
 
     if(overlay->show)
     {
-        overlay->logScrollToLast = true;
+        overlay->logList.atEnd = true;
     }
 }
 
+log_entry* log_entry_at_index(oc_debug_overlay* overlay, u64 index)
+{
+    //NOTE: walk from the closest end of the list
+    log_entry* entry = 0;
+    if(index < overlay->entryCount / 2)
+    {
+        entry = oc_list_first_elt(overlay->logEntries, log_entry, listElt);
+        for(u64 i = 0; i < index && entry; i++)
+        {
+            entry = oc_list_next_elt(entry, log_entry, listElt);
+        }
+    }
+    else
+    {
+        entry = oc_list_last_elt(overlay->logEntries, log_entry, listElt);
+        for(u64 i = overlay->entryCount - 1; i > index && entry; i--)
+        {
+            entry = oc_list_prev_elt(entry, log_entry, listElt);
+        }
+    }
+    return (entry);
+}
+
 void log_entry_ui(oc_debug_overlay* overlay, log_entry* entry)
 {
     oc_scratch scratch = oc_scratch_begin();
@@ -140,45 +163,23 @@ void overlay_ui(oc_debug_overlay* overlay)
                     }
                 }
 
-                f32 scrollY = 0;
+                //NOTE: only the entries in view are built, so the cost of the console doesn't grow with the log
+                overlay->logList.rowCount = overlay->entryCount;
 
-                oc_ui_box* panel = oc_ui_box("log-view")
+                oc_ui_list("log-view", &overlay->logList)
                 {
-                    scrollY = panel->scroll.y;
-
-                    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
-                    oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PARENT, 1, 1 });
-                    oc_ui_style_set_i32(OC_UI_OVERFLOW_Y, OC_UI_OVERFLOW_SCROLL);
-
-                    oc_ui_box("contents")
+                    log_entry* entry = log_entry_at_index(overlay, overlay->logList.firstRow);
+                    for(u64 i = overlay->logList.firstRow; i < overlay->logList.endRow && entry; i++)
                     {
-                        oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
-                        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
-                        oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
-                        oc_ui_style_set_f32(OC_UI_MARGIN_Y, 5);
-
-                        oc_list_for(overlay->logEntries, entry, log_entry, listElt)
+                        oc_ui_list_row(i)
                         {
+                            //NOTE: the margin is part of the row's layout, so it is accounted for in the list's row heights
+                            oc_ui_style_set_f32(OC_UI_MARGIN_Y, 5);
                             log_entry_ui(overlay, entry);
                         }
+                        entry = oc_list_next_elt(entry, log_entry, listElt);
                     }
                 }
-
-                if(overlay->logScrollToLast)
-                {
-                    if(panel->scroll.y >= scrollY)
-                    {
-                        panel->scroll.y = oc_clamp_low(panel->contentSize.y - panel->rect.h, 0);
-                    }
-                    else
-                    {
-                        overlay->logScrollToLast = false;
-                    }
-                }
-                else if(panel->scroll.y >= (panel->contentSize.y - panel->rect.h) - 1)
-                {
-                    overlay->logScrollToLast = true;
-                }
             }
         }
 
@@ -250,7 +250,7 @@ oc_event* oc_runtime_clipboard_process_event_begin(oc_arena* arena, oc_runtime_c
     {
         bool isPressedOrRepeated = origEvent->key.action == OC_KEY_PRESS || origEvent->key.action == OC_KEY_REPEAT;
         oc_keymod_flags rawMods = origEvent->key.mods & ~OC_KEYMOD_MAIN_MODIFIER;
-#if OC_PLATFORM_WINDOWS
+#if OC_PLATFORM_WINDOWS || OC_PLATFORM_LINUX
         bool cutOrCopied = isPressedOrRepeated
                         && ((origEvent->key.keyCode == OC_KEY_X && rawMods == OC_KEYMOD_CTRL)
                             || (origEvent->key.keyCode == OC_KEY_DELETE && rawMods == OC_KEYMOD_SHIFT)
@@ -294,6 +294,7 @@ void oc_hostapi_clipboard_get_string(oc_wasm_allocator* wasmAllocator, oc_wasm_s
     oc_wasm_str8 result = { 0 };
     if(clipboard->isGetAllowed)
     {
+        oc_trace_begin("host clipboard get");
         oc_scratch scratch = oc_scratch_begin();
 
         oc_str8 string = oc_clipboard_get_string(scratch.allocator);
@@ -308,6 +309,7 @@ void oc_hostapi_clipboard_get_string(oc_wasm_allocator* wasmAllocator, oc_wasm_s
         returnPointer->ptr = returnAddr;
 
         oc_scratch_end(scratch);
+        oc_trace_end();
     }
     else
     {
@@ -323,7 +325,10 @@ void oc_hostapi_clipboard_set_string(oc_wasm_str8* value)
     if(time < clipboard->setAllowedUntil)
     {
         oc_str8 nativeValue = oc_wasm_str8_to_native(*value);
-        oc_clipboard_set_string(nativeValue);
+        oc_trace_zone("host clipboard set")
+        {
+            oc_clipboard_set_string(nativeValue);
+        }
     }
     else
     {
@@ -383,10 +388,15 @@ void oc_hostapi_io_wait_single_req(oc_io_req* wasmReq, oc_io_cmp* returnPointer)
 
     //TODO: lookup if operation needs a buffer in a compile-time table
     oc_io_op op = wasmReq->op;
+    oc_scratch scratch = oc_scratch_begin();
+
     if(op == OC_IO_OPEN
        || op == OC_IO_STAT
        || op == OC_IO_READ
-       || op == OC_IO_WRITE)
+       || op == OC_IO_WRITE
+       || op == OC_IO_PREAD
+       || op == OC_IO_PWRITE
+       || op == OC_IO_REMOVE)
     {
         //TODO have a separate oc_wasm_io_req struct, and marshall between wasm/native versions
         void* buffer = oc_wasm_address_to_ptr((oc_wasm_addr)(uintptr_t)req.buffer, req.size);
@@ -395,7 +405,7 @@ void oc_hostapi_io_wait_single_req(oc_io_req* wasmReq, oc_io_cmp* returnPointer)
             req.buffer = buffer;
 
             //TODO: lookup in a compile-time table which operations use a 'at' handle that must be replaced by root handle if 0.
-            if(req.op == OC_IO_OPEN)
+            if(req.op == OC_IO_OPEN || req.op == OC_IO_REMOVE)
             {
                 if(req.handle.h == 0)
                 {
@@ -409,10 +419,70 @@ void oc_hostapi_io_wait_single_req(oc_io_req* wasmReq, oc_io_cmp* returnPointer)
             cmp.error = OC_IO_ERR_ARG;
         }
     }
+    else if(op == OC_IO_READV || op == OC_IO_WRITEV)
+    {
+        //NOTE: buffer is an array of size oc_io_vec, whose buffers are wasm addresses. We copy it to a
+        //      native array, since we can't write native pointers back to wasm memory.
+        oc_io_vec* wasmVecs = 0;
+        if(req.size <= UINT32_MAX / sizeof(oc_io_vec))
+        {
+            wasmVecs = oc_wasm_address_to_ptr((oc_wasm_addr)(uintptr_t)req.buffer, req.size * sizeof(oc_io_vec));
+        }
+        if(wasmVecs)
+        {
+            oc_io_vec* vecs = oc_arena_push_array(scratch.arena, oc_io_vec, req.size);
+            for(u64 i = 0; i < req.size; i++)
+            {
+                vecs[i].size = wasmVecs[i].size;
+                if(vecs[i].size <= UINT32_MAX)
+                {
+                    vecs[i].buffer = oc_wasm_address_to_ptr((oc_wasm_addr)wasmVecs[i].unused, vecs[i].size);
+                }
+                if(!vecs[i].buffer && vecs[i].size)
+                {
+                    cmp.error = OC_IO_ERR_ARG;
+                    break;
+                }
+            }
+            req.buffer = (char*)vecs;
+        }
+        else
+        {
+            cmp.error = OC_IO_ERR_ARG;
+        }
+    }
+
     if(cmp.error == OC_IO_OK)
     {
-        cmp = oc_io_wait_single_req_for_table(&req, &orca->fileTable);
+        oc_trace_zone("host io")
+        {
+            //NOTE: resources of the app bundle are served from the archive until they're written to
+            bool handled = false;
+            if(req.op == OC_IO_OPEN)
+            {
+                handled = oc_bundle_handle_open(&orca->bundle, &orca->fileTable, orca->rootDir, &req, &cmp);
+            }
+            else if(req.op == OC_IO_CLOSE)
+            {
+                oc_bundle_handle_close(&orca->bundle, req.handle);
+            }
+            else if(req.op == OC_IO_REMOVE)
+            {
+                oc_bundle_handle_remove(&orca->bundle, orca->rootDir, &req);
+            }
+            else if(req.op == OC_IO_COPY)
+            {
+                //NOTE: copying a directory copies the files of the archive it contains, so we extract them first
+                oc_bundle_handle_listdir(&orca->bundle, orca->rootDir, req.handle);
+            }
+
+            if(!handled)
+            {
+                cmp = oc_io_wait_single_req_for_table(&req, &orca->fileTable);
+            }
+        }
     }
+    oc_scratch_end(scratch);
 
     *returnPointer = cmp;
 }
@@ -426,7 +496,10 @@ void oc_hostapi_file_open_with_request(oc_wasm_str8* path, oc_file_access rights
 
     if(nativePath.ptr)
     {
-        file = oc_file_open_with_request_for_table(nativePath, rights, flags, &orca->fileTable);
+        oc_trace_zone("host file open with request")
+        {
+            file = oc_file_open_with_request_for_table(nativePath, rights, flags, &orca->fileTable);
+        }
     }
     *returnPointer = file;
 }
@@ -475,7 +548,11 @@ void oc_hostapi_file_open_with_dialog(oc_wasm_allocator* wasmAllocator,
         eltIndex = elt->listElt.next;
     }
 
-    oc_file_open_with_dialog_result nativeResult = oc_file_open_with_dialog_for_table(scratch.allocator, rights, flags, &nativeDesc, &orca->fileTable);
+    oc_file_open_with_dialog_result nativeResult = { 0 };
+    oc_trace_zone("host file open with dialog")
+    {
+        nativeResult = oc_file_open_with_dialog_for_table(scratch.allocator, rights, flags, &nativeDesc, &orca->fileTable);
+    }
 
     oc_wasm_file_open_with_dialog_result result = {
         .button = nativeResult.button,
@@ -500,7 +577,12 @@ void oc_hostapi_file_listdir(oc_wasm_allocator* wasmAllocator, oc_file* director
     oc_scratch scratch = oc_scratch_begin();
 
     oc_runtime* orca = oc_runtime_get();
-    oc_file_list nativeList = oc_file_listdir_for_table(scratch.allocator, *directory, &orca->fileTable);
+    oc_file_list nativeList = { 0 };
+    oc_trace_zone("host file listdir")
+    {
+        oc_bundle_handle_listdir(&orca->bundle, orca->rootDir, *directory);
+        nativeList = oc_file_listdir_for_table(scratch.allocator, *directory, &orca->fileTable);
+    }
 
     oc_wasm_file_list wasmList = { 0 };
     wasmList.eltCount = nativeList.eltCount;
@@ -542,7 +624,10 @@ void oc_hostapi_image_destroy(oc_image* image)
 
 void oc_hostapi_image_upload_region_rgba8(oc_image* image, oc_rect* region, u8* pixels)
 {
-    oc_image_upload_region_rgba8(*image, *region, pixels);
+    oc_trace_zone("host image upload")
+    {
+        oc_image_upload_region_rgba8(*image, *region, pixels);
+    }
 }
 
 void oc_hostapi_surface_get_size(oc_surface* surface, oc_vec2* returnPointer)
@@ -568,6 +653,9 @@ void oc_hostapi_surface_send_to_back(oc_surface* surface)
 void oc_hostapi_canvas_renderer_create(oc_canvas_renderer* returnPointer)
 {
     *returnPointer = oc_canvas_renderer_create();
+#if OC_PLATFORM_LINUX
+    oc_headless_canvas_set_rasterize(*returnPointer, !s_no_raster);
+#endif
 }
 
 void oc_hostapi_canvas_surface_create(oc_canvas_renderer* renderer, oc_surface* returnPointer)
@@ -584,25 +672,36 @@ void oc_hostapi_canvas_renderer_submit(oc_canvas_renderer* renderer,
                                        oc_color* clearColor,
                                        u32 primitiveCount,
                                        oc_primitive* primitives,
+                                       u32 attributeCount,
+                                       oc_attributes* attributes,
                                        u32 eltCount,
                                        oc_path_elt* elements)
 {
-    oc_canvas_renderer_submit(*renderer,
-                              *surface,
-                              msaaSampleCount,
-                              clear,
-                              *clearColor,
-                              primitiveCount,
-                              primitives,
-                              eltCount,
-                              elements);
+    oc_trace_zone("host canvas submit")
+    {
+        oc_canvas_renderer_submit(*renderer,
+                                  *surface,
+                                  msaaSampleCount,
+                                  clear,
+                                  *clearColor,
+                                  primitiveCount,
+                                  primitives,
+                                  attributeCount,
+                                  attributes,
+                                  eltCount,
+                                  elements);
+    }
 }
 
 void oc_hostapi_canvas_present(oc_canvas_renderer* renderer, oc_surface* surface)
 {
-    oc_canvas_present(*renderer, *surface);
+    oc_trace_zone("host canvas present")
+    {
+        oc_canvas_present(*renderer, *surface);
+    }
 }
 
+#if OC_GRAPHICS_ENABLE_GLES
 void oc_hostapi_gles_surface_create(oc_surface* returnPointer)
 {
     *returnPointer = oc_gles_surface_create_for_window(__orcaApp.window);
@@ -615,5 +714,24 @@ void oc_hostapi_gles_surface_make_current(oc_surface* surface)
 
 void oc_hostapi_gles_surface_swap_buffers(oc_surface* surface)
 {
-    oc_gles_surface_swap_buffers(*surface);
+    oc_trace_zone("host gles swap buffers")
+    {
+        oc_gles_surface_swap_buffers(*surface);
+    }
+}
+#else
+//NOTE: no GLES surfaces on headless targets, guest code gets a nil surface
+void oc_hostapi_gles_surface_create(oc_surface* returnPointer)
+{
+    oc_log_warning("GLES surfaces are not supported on this platform\n");
+    *returnPointer = oc_surface_nil();
+}
+
+void oc_hostapi_gles_surface_make_current(oc_surface* surface)
+{
+}
+
+void oc_hostapi_gles_surface_swap_buffers(oc_surface* surface)
+{
 }
+#endif
@@ -17,7 +17,11 @@
 #include "util/ringbuffer.h"
 
 //TODO: wgpu-renderer: figure out graphics backends include selection
+#include "graphics/backends.h"
 #include "graphics/gles_surface.h"
+#if OC_PLATFORM_LINUX
+    #include "graphics/headless_renderer.h"
+#endif
 
 #include "runtime.h"
 
@@ -149,11 +153,16 @@ oc_event* queue_next_event(oc_arena* arena, oc_ringbuffer* queue)
 //------------------------------------------------------------------------
 
 static bool s_is_test_module = false;
+static i64 s_frame_count = 0;
+static bool s_no_raster = false;
+static oc_str8 s_trace_path = { 0 };
+static bool s_extract_bundle = false;
 
 //#include "bridge_io.c"
 //#include "runtime_clipboard.c"
 
 #include "runtime_memory.c"
+#include "runtime_bundle.c"
 
 #include "host_handlers.c"
 #include "wasmbind/core_stubs.c"
@@ -230,6 +239,15 @@ wa_status orca_invoke(wa_interpreter* interpreter, wa_instance* instance, wa_fun
     return status;
 }
 
+wa_status orca_invoke_export(oc_runtime* app, oc_export_kind kind, u32 argCount, wa_value* args, u32 retCount, wa_value* returns)
+{
+    //NOTE: export names are string literals, so they can be used as trace zone names
+    oc_trace_begin(OC_EXPORT_DESC[kind].name.ptr);
+    wa_status status = orca_invoke(app->env.interpreter, app->env.instance, app->env.exports[kind], argCount, args, retCount, returns);
+    oc_trace_end();
+    return status;
+}
+
 #if OC_PLATFORM_MACOS
 oc_str8 get_orca_home_dir(oc_allocator* allocator)
 {
@@ -269,102 +287,26 @@ oc_str8 get_orca_home_dir(oc_allocator* allocator)
     return path;
 }
 
-#endif
-
-int oc_zip_extract(oc_str8 src, oc_str8 dst)
+#elif OC_PLATFORM_LINUX
+oc_str8 get_orca_home_dir(oc_allocator* allocator)
 {
-    oc_scratch scratch = oc_scratch_begin();
-    const char* srcCStr = oc_str8_to_cstring(scratch.allocator, src);
-
-    zip_t* zip = zip_open(srcCStr, ZIP_RDONLY, 0);
-    if(!zip)
-    {
-        goto error;
-    }
-
-    i64 count = zip_get_num_entries(zip, 0);
-    for(i64 entryIndex = 0; entryIndex < count; entryIndex++)
-    {
-        oc_str8 name = OC_STR8(zip_get_name(zip, entryIndex, 0));
-        if(!name.ptr)
-        {
-            goto error;
-        }
-        else
-        {
-            oc_str8_list list = { 0 };
-            oc_str8_list_push(scratch.allocator, &list, dst);
-            oc_str8_list_push(scratch.allocator, &list, name);
-            oc_str8 dstPath = oc_path_join(scratch.allocator, list);
-
-            if(name.ptr[name.len - 1] == '/')
-            {
-                //NOTE: directory. Ignore since we create dirs when extracting files
-            }
-            else if(!oc_str8_cmp(oc_str8_slice(name, 0, 8), OC_STR8("__MACOSX")))
-            {
-                //NOTE: apple archiver's way of storing resource forks. Ignore
-            }
-            else
-            {
-                //NOTE: normal file
-                // first make the leading directories if they don't exist
-                oc_str8 dir = oc_path_slice_directory(dstPath);
-                if(oc_file_makedir(dir, &(oc_file_makedir_options){ .flags = OC_FILE_MAKEDIR_CREATE_PARENTS }) != 0)
-                {
-                    goto error;
-                }
+    oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
 
-                zip_file_t* srcFile = zip_fopen_index(zip, entryIndex, 0);
-                if(!srcFile)
-                {
-                    goto error;
-                }
-                FILE* dstFile = fopen(dstPath.ptr, "wb");
-                if(!dstFile)
-                {
-                    goto error;
-                }
+    char* home = getenv("HOME");
 
-                char chunk[1024];
-                while(1)
-                {
-                    i64 n = zip_fread(srcFile, chunk, 1024);
-                    if(n == 0)
-                    {
-                        break;
-                    }
-                    else if(n == -1)
-                    {
-                        fclose(dstFile);
-                        zip_fclose(srcFile);
-                        goto error;
-                    }
-                    else
-                    {
-                        fwrite(chunk, 1, n, dstFile);
-                    }
-                }
+    oc_str8_list list = { 0 };
+    oc_str8_list_push(scratch.allocator, &list, OC_STR8(home));
+    oc_str8_list_push(scratch.allocator, &list, OC_STR8(".orca"));
 
-                fclose(dstFile);
-                zip_fclose(srcFile);
-            }
-        }
-    }
+    oc_str8 path = oc_path_join(allocator, list);
 
-    zip_close(zip);
     oc_scratch_end(scratch);
-    return 0;
 
-error:
-    if(zip)
-    {
-        zip_close(zip);
-    }
-    oc_scratch_end(scratch);
-    return -1;
+    return path;
 }
 
+#endif
+
 #if OC_PLATFORM_MACOS
 oc_str8 standalone_app_name(oc_arena* arena)
 {
@@ -380,7 +322,7 @@ oc_str8 standalone_app_name(oc_arena* arena)
     oc_scratch_end(scratch);
     return result;
 }
-#elif OC_PLATFORM_WINDOWS
+#elif OC_PLATFORM_WINDOWS || OC_PLATFORM_LINUX
 
 oc_str8 standalone_app_name(oc_arena* arena)
 {
@@ -411,40 +353,7 @@ int load_app(oc_runtime* app)
         appName = oc_path_slice_stem(app->path);
     }
 
-    oc_str8 appDir = { 0 };
-    {
-        //NOTE: create a temp dir to uncompress the image and get its full path
-        oc_file tmpDir = oc_catch(oc_file_maketmp(OC_FILE_MAKETMP_DIRECTORY))
-        {
-            oc_log_error("Couldn't create temporary directory\n");
-            return -1;
-        }
-        oc_str8 tmpName = oc_catch(oc_file_name(scratch.allocator, tmpDir))
-        {
-            oc_log_error("Couldn't get temporary directory name\n");
-            return -1;
-        }
-        oc_str8 tmpFilesPath = oc_file_tmp_directory_path(scratch.allocator);
-        appDir = oc_path_append(scratch.allocator, tmpFilesPath, tmpName);
-        oc_file_close(tmpDir);
-    }
-
-    int err = oc_zip_extract(app->path, appDir);
-    if(err)
-    {
-        oc_log_error("Couldn't extract application: %i\n", err);
-        oc_scratch_end(scratch);
-        return -1;
-    }
-
-    //NOTE: copy data from app dir to user's dir
-    oc_str8 dataDirSrc = { 0 };
-    {
-        oc_str8_list list = { 0 };
-        oc_str8_list_push(scratch.allocator, &list, appDir);
-        oc_str8_list_push(scratch.allocator, &list, OC_STR8("data/"));
-        dataDirSrc = oc_path_join(scratch.allocator, list);
-    }
+    //NOTE: the app's data is served from the bundle, on top of the user's data dir
     oc_str8 dataDirDest = { 0 };
     {
         oc_str8_list list = { 0 };
@@ -459,34 +368,19 @@ int load_app(oc_runtime* app)
                         .flags = OC_FILE_MAKEDIR_CREATE_PARENTS | OC_FILE_MAKEDIR_IGNORE_EXISTING,
                     });
 
-    oc_file_copy(dataDirSrc,
-                 dataDirDest,
-                 &(oc_file_copy_options){
-                     .flags = OC_FILE_COPY_REPLACE_EXISTING,
-                 });
+    int err = oc_bundle_open(&app->bundle, app->path, dataDirDest, s_extract_bundle);
+    if(err)
+    {
+        oc_log_error("Couldn't open application bundle: %i\n", err);
+        oc_scratch_end(scratch);
+        return -1;
+    }
 
     //NOTE: loads wasm module
+    app->env.wasmBytecode = oc_bundle_read(app->env.arena.allocator, &app->bundle, OC_STR8("modules/main.wasm"));
+    if(!app->env.wasmBytecode.ptr)
     {
-        oc_str8_list list = { 0 };
-        oc_str8_list_push(scratch.allocator, &list, appDir);
-        oc_str8_list_push(scratch.allocator, &list, OC_STR8("modules/main.wasm"));
-        oc_str8 modulePath = oc_path_join(scratch.allocator, list);
-
-        //TODO: change for platform layer file IO functions
-        FILE* file = fopen(modulePath.ptr, "rb");
-        if(!file)
-        {
-            OC_ABORT("The application couldn't load: web assembly module '%s' not found", modulePath.ptr);
-        }
-
-        fseek(file, 0, SEEK_END);
-        u64 wasmSize = ftell(file);
-        rewind(file);
-
-        app->env.wasmBytecode.len = wasmSize;
-        app->env.wasmBytecode.ptr = oc_malloc_array(char, wasmSize);
-        fread(app->env.wasmBytecode.ptr, 1, app->env.wasmBytecode.len, file);
-        fclose(file);
+        OC_ABORT("The application couldn't load: web assembly module 'modules/main.wasm' not found");
     }
 
     app->env.module = wa_module_create(&app->env.arena, app->env.wasmBytecode);
@@ -604,6 +498,39 @@ int load_app(oc_runtime* app)
     return 0;
 }
 
+static int frame_time_cmp(const void* a, const void* b)
+{
+    f64 x = *(const f64*)a;
+    f64 y = *(const f64*)b;
+    return ((x > y) - (x < y));
+}
+
+void print_frame_stats(f64* frameTimes, i64 frameCount)
+{
+    if(frameCount <= 0)
+    {
+        return;
+    }
+
+    f64 total = 0;
+    for(i64 i = 0; i < frameCount; i++)
+    {
+        total += frameTimes[i];
+    }
+    qsort(frameTimes, frameCount, sizeof(f64), frame_time_cmp);
+
+    i64 p95Index = oc_min((i64)ceil(0.95 * frameCount) - 1, frameCount - 1);
+
+    printf("frames: %lli\n", (long long)frameCount);
+    printf("total:  %.3f ms\n", total * 1000);
+    printf("min:    %.3f ms\n", frameTimes[0] * 1000);
+    printf("avg:    %.3f ms\n", total / frameCount * 1000);
+    printf("median: %.3f ms\n", frameTimes[frameCount / 2] * 1000);
+    printf("p95:    %.3f ms\n", frameTimes[oc_max(p95Index, 0)] * 1000);
+    printf("max:    %.3f ms\n", frameTimes[frameCount - 1] * 1000);
+    fflush(stdout);
+}
+
 i32 vm_runloop(void* user)
 {
     oc_runtime* app = &__orcaApp;
@@ -623,7 +550,7 @@ i32 vm_runloop(void* user)
         wa_value returnCode = { 0 };
         if(exports[OC_EXPORT_ON_TEST])
         {
-            wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_ON_TEST], 0, NULL, 1, &returnCode);
+            wa_status status = orca_invoke_export(app, OC_EXPORT_ON_TEST, 0, NULL, 1, &returnCode);
             OC_WASM_TRAP(status);
 
             if(returnCode.valI32 != 0)
@@ -647,7 +574,7 @@ i32 vm_runloop(void* user)
     //NOTE: call init handler and frame resize
     if(exports[OC_EXPORT_ON_INIT])
     {
-        wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_ON_INIT], 0, NULL, 0, NULL);
+        wa_status status = orca_invoke_export(app, OC_EXPORT_ON_INIT, 0, NULL, 0, NULL);
         OC_WASM_TRAP(status);
     }
 
@@ -659,17 +586,30 @@ i32 vm_runloop(void* user)
         params[0].valI32 = (i32)content.w;
         params[1].valI32 = (i32)content.h;
 
-        wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_FRAME_RESIZE], oc_array_size(params), params, 0, NULL);
+        wa_status status = orca_invoke_export(app, OC_EXPORT_FRAME_RESIZE, oc_array_size(params), params, 0, NULL);
         OC_WASM_TRAP(status);
     }
 
+    //NOTE: when asked to run a fixed number of frames, record per-frame durations (excluding the vsync wait)
+    //      so that we can report timing stats on exit.
+    f64* frameTimes = 0;
+    i64 frameIndex = 0;
+    if(s_frame_count > 0)
+    {
+        frameTimes = oc_malloc_array(f64, s_frame_count);
+    }
+
     //NOTE: app event loop: get events and call appropriate handlers
 
     while(!app->quit)
     {
+        f64 frameStart = oc_clock_time(OC_CLOCK_MONOTONIC);
+        oc_trace_begin("frame");
+
         oc_scratch scratch = oc_scratch_begin();
         oc_event* event = 0;
 
+        oc_trace_begin("events");
         while(!app->quit && (event = queue_next_event(scratch.arena, &app->eventBuffer)) != 0)
         {
             if(exports[OC_EXPORT_RAW_EVENT])
@@ -697,7 +637,7 @@ i32 vm_runloop(void* user)
                         memcpy(eventPtr, events[i], sizeof(*events[i]));
 
                         wa_value eventOffset = { .valI32 = (i32)app->env.rawEventOffset };
-                        wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_RAW_EVENT], 1, &eventOffset, 0, NULL);
+                        wa_status status = orca_invoke_export(app, OC_EXPORT_RAW_EVENT, 1, &eventOffset, 0, NULL);
                         OC_WASM_TRAP(status);
                     }
                     else
@@ -721,7 +661,7 @@ i32 vm_runloop(void* user)
                         params[0].valI32 = (i32)event->move.content.w;
                         params[1].valI32 = (i32)event->move.content.h;
 
-                        wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_FRAME_RESIZE], oc_array_size(params), params, 0, NULL);
+                        wa_status status = orca_invoke_export(app, OC_EXPORT_FRAME_RESIZE, oc_array_size(params), params, 0, NULL);
                         OC_WASM_TRAP(status);
                     }
                 }
@@ -735,7 +675,7 @@ i32 vm_runloop(void* user)
                         {
                             wa_value button = { .valI32 = event->key.button };
 
-                            wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_MOUSE_DOWN], 1, &button, 0, NULL);
+                            wa_status status = orca_invoke_export(app, OC_EXPORT_MOUSE_DOWN, 1, &button, 0, NULL);
                             OC_WASM_TRAP(status);
                         }
                     }
@@ -745,7 +685,7 @@ i32 vm_runloop(void* user)
                         {
                             wa_value button = { .valI32 = event->key.button };
 
-                            wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_MOUSE_UP], 1, &button, 0, NULL);
+                            wa_status status = orca_invoke_export(app, OC_EXPORT_MOUSE_UP, 1, &button, 0, NULL);
                             OC_WASM_TRAP(status);
                         }
                     }
@@ -760,7 +700,7 @@ i32 vm_runloop(void* user)
                         params[0].valF32 = event->mouse.deltaX;
                         params[1].valF32 = event->mouse.deltaY;
 
-                        wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_MOUSE_WHEEL], oc_array_size(params), params, 0, NULL);
+                        wa_status status = orca_invoke_export(app, OC_EXPORT_MOUSE_WHEEL, oc_array_size(params), params, 0, NULL);
                         OC_WASM_TRAP(status);
                     }
                 }
@@ -776,7 +716,7 @@ i32 vm_runloop(void* user)
                         params[2].valF32 = event->mouse.deltaX;
                         params[3].valF32 = event->mouse.deltaY;
 
-                        wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_MOUSE_MOVE], oc_array_size(params), params, 0, NULL);
+                        wa_status status = orca_invoke_export(app, OC_EXPORT_MOUSE_MOVE, oc_array_size(params), params, 0, NULL);
                         OC_WASM_TRAP(status);
                     }
                 }
@@ -792,7 +732,7 @@ i32 vm_runloop(void* user)
                             params[0].valI32 = event->key.scanCode;
                             params[1].valI32 = event->key.keyCode;
 
-                            wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_KEY_DOWN], oc_array_size(params), params, 0, NULL);
+                            wa_status status = orca_invoke_export(app, OC_EXPORT_KEY_DOWN, oc_array_size(params), params, 0, NULL);
                             OC_WASM_TRAP(status);
                         }
                     }
@@ -804,7 +744,7 @@ i32 vm_runloop(void* user)
                             params[0].valI32 = event->key.scanCode;
                             params[1].valI32 = event->key.keyCode;
 
-                            wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_KEY_UP], oc_array_size(params), params, 0, NULL);
+                            wa_status status = orca_invoke_export(app, OC_EXPORT_KEY_UP, oc_array_size(params), params, 0, NULL);
                             OC_WASM_TRAP(status);
                         }
                     }
@@ -815,27 +755,50 @@ i32 vm_runloop(void* user)
                     break;
             }
         }
+        oc_trace_end();
 
         if(exports[OC_EXPORT_FRAME_REFRESH])
         {
-            wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_FRAME_REFRESH], 0, NULL, 0, NULL);
+            wa_status status = orca_invoke_export(app, OC_EXPORT_FRAME_REFRESH, 0, NULL, 0, NULL);
             OC_WASM_TRAP(status);
         }
 
         oc_scratch_end(scratch);
+        oc_trace_end();
 
-#if OC_PLATFORM_WINDOWS
+        if(frameTimes)
+        {
+            frameTimes[frameIndex] = oc_clock_time(OC_CLOCK_MONOTONIC) - frameStart;
+            frameIndex++;
+            if(frameIndex >= s_frame_count)
+            {
+                app->quit = true;
+                break;
+            }
+        }
+
+#if OC_PLATFORM_WINDOWS || OC_PLATFORM_LINUX
         //NOTE(martin): on windows we set all surfaces to non-synced, and do a single "manual" wait here.
         //              on macOS each surface is individually synced to the monitor refresh rate but don't block each other
-        oc_vsync_wait(app->window);
+        //              on linux there is no display, and the wait is driven by a fixed timestep clock.
+        oc_trace_zone("vsync wait")
+        {
+            oc_vsync_wait(app->window);
+        }
 #endif
     }
 
+    if(frameTimes)
+    {
+        print_frame_stats(frameTimes, frameIndex);
+        free(frameTimes);
+    }
+
     //NOTE: we exited the event loop, call the terminate handler and cleanup module/instance then quit
 
     if(exports[OC_EXPORT_TERMINATE])
     {
-        wa_status status = orca_invoke(app->env.interpreter, app->env.instance, exports[OC_EXPORT_TERMINATE], 0, NULL, 0, NULL);
+        wa_status status = orca_invoke_export(app, OC_EXPORT_TERMINATE, 0, NULL, 0, NULL);
         OC_WASM_TRAP(status);
     }
 
@@ -868,6 +831,34 @@ void debugger_resume_with_command(oc_runtime* app, oc_debugger_command command)
     vm_thread_resume(&app->env);
 }
 
+void trace_dump(void)
+{
+    oc_str8 path = s_trace_path.len ? s_trace_path : OC_STR8("orca_trace.json");
+    oc_io_error error = oc_trace_dump(path);
+    if(error == OC_IO_OK)
+    {
+        oc_log_info("Wrote frame trace to %.*s\n", oc_str8_ip(path));
+    }
+    else
+    {
+        oc_log_error("Couldn't write frame trace to %.*s (error %i)\n", oc_str8_ip(path), error);
+    }
+}
+
+void trace_toggle(void)
+{
+    if(oc_trace_is_recording())
+    {
+        oc_trace_stop();
+        trace_dump();
+    }
+    else
+    {
+        oc_log_info("Started recording frame trace\n");
+        oc_trace_start();
+    }
+}
+
 i32 control_runloop(void* user)
 {
     oc_runtime* app = (oc_runtime*)user;
@@ -877,7 +868,7 @@ i32 control_runloop(void* user)
     app->env.suspendCond = oc_condition_create();
     app->env.suspendMutex = oc_mutex_create();
 
-    oc_thread* vmThread = oc_thread_create(vm_runloop, app);
+    oc_thread* vmThread = oc_thread_create_with_name(vm_runloop, app, OC_STR8("vm"));
 
     while(!app->quit)
     {
@@ -994,6 +985,12 @@ i32 control_runloop(void* user)
                                     debug_overlay_toggle(&app->debugOverlay);
                                 }
                             }
+                            else if(event->key.keyCode == OC_KEY_T
+                                    && (event->key.mods & OC_KEYMOD_MAIN_MODIFIER)
+                                    && (event->key.mods & OC_KEYMOD_SHIFT))
+                            {
+                                trace_toggle();
+                            }
                         }
                     }
                     break;
@@ -1099,6 +1096,48 @@ int main(int argc, char** argv)
                                .desc = OC_STR8("Runs the application in test mode."),
                            });
 
+    oc_arg_parser_add_named_i64(&parser,
+                                OC_STR8("frames"),
+                                &s_frame_count,
+                                &(oc_arg_parser_arg_options){
+                                    .desc = OC_STR8("Run the given number of frames, then exit and print frame timing stats."),
+                                    .valueName = OC_STR8("count"),
+                                });
+
+    oc_arg_parser_add_flag(&parser,
+                           OC_STR8("extract"),
+                           &s_extract_bundle,
+                           &(oc_arg_parser_arg_options){
+                               .desc = OC_STR8("Extract the application's data at startup, instead of serving it from the application bundle."),
+                           });
+
+    oc_arg_parser_add_named_str8(&parser,
+                                 OC_STR8("trace"),
+                                 &s_trace_path,
+                                 &(oc_arg_parser_arg_options){
+                                     .desc = OC_STR8("Record a frame timeline trace from startup, and write it to the given file on exit. The trace can be opened in ui.perfetto.dev or chrome://tracing."),
+                                     .valueName = OC_STR8("file"),
+                                 });
+
+#if OC_PLATFORM_LINUX
+    f64 framePeriod = -1;
+    oc_arg_parser_add_named_f64(&parser,
+                                OC_STR8("frame-period"),
+                                &framePeriod,
+                                &(oc_arg_parser_arg_options){
+                                    .desc = OC_STR8("Fixed timestep of the frame clock, in seconds. 0 runs frames as fast as possible."),
+                                    .valueName = OC_STR8("seconds"),
+                                    .defaultValue.valF64 = -1,
+                                });
+
+    oc_arg_parser_add_flag(&parser,
+                           OC_STR8("no-raster"),
+                           &s_no_raster,
+                           &(oc_arg_parser_arg_options){
+                               .desc = OC_STR8("Discard canvas submissions instead of rasterizing them on the cpu."),
+                           });
+#endif
+
     if(oc_arg_parser_parse(&parser, argc, argv) != 0)
     {
         return -1;
@@ -1123,7 +1162,27 @@ int main(int argc, char** argv)
     oc_init();
     oc_clock_init();
 
+    oc_trace_set_thread_name(OC_STR8("main"));
+    if(s_trace_path.len)
+    {
+        oc_trace_start();
+    }
+
+#if OC_PLATFORM_LINUX
+    if(framePeriod >= 0)
+    {
+        oc_headless_set_frame_period(framePeriod);
+    }
+#endif
+
     app->debugOverlay.maxEntries = 200;
+    app->debugOverlay.logList = (oc_ui_list_info){
+        .rowHeight = 40,
+        .variableHeight = true,
+        .overscan = 2,
+        .followLast = true,
+        .atEnd = true,
+    };
     oc_arena_init(&app->debugOverlay.logArena);
 
     if(s_is_test_module == false)
@@ -1136,6 +1195,11 @@ int main(int argc, char** argv)
 
         app->debugOverlay.show = false;
         app->debugOverlay.renderer = oc_canvas_renderer_create();
+
+#if OC_PLATFORM_LINUX
+        oc_headless_canvas_set_rasterize(app->canvasRenderer, !s_no_raster);
+        oc_headless_canvas_set_rasterize(app->debugOverlay.renderer, !s_no_raster);
+#endif
         app->debugOverlay.surface = oc_canvas_surface_create_for_window(app->debugOverlay.renderer, app->window);
         app->debugOverlay.context = oc_canvas_context_create();
         app->debugOverlay.fontReg = orca_font_create("../resources/Menlo.ttf");
@@ -1150,7 +1214,7 @@ int main(int argc, char** argv)
     }
 
     //NOTE: start runloop
-    oc_thread* controlThread = oc_thread_create(control_runloop, app);
+    oc_thread* controlThread = oc_thread_create_with_name(control_runloop, app, OC_STR8("control"));
 
     while(!oc_should_quit())
     {
@@ -1162,6 +1226,12 @@ int main(int argc, char** argv)
     i64 exitCode = 0;
     oc_thread_join(controlThread, &exitCode);
 
+    if(oc_trace_is_recording())
+    {
+        oc_trace_stop();
+        trace_dump();
+    }
+
     if(s_is_test_module == false)
     {
         oc_canvas_context_destroy(app->debugOverlay.context);
@@ -1171,6 +1241,8 @@ int main(int argc, char** argv)
         oc_window_destroy(app->window);
     }
 
+    oc_bundle_close(&app->bundle);
+
     oc_terminate();
     return (int)(exitCode);
 }
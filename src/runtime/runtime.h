@@ -11,6 +11,7 @@
 #include "platform/native_io.h"
 #include "runtime_memory.h"
 #include "runtime_clipboard.h"
+#include "runtime_bundle.h"
 #include "warm/wasm.h"
 
 //------------------------------------------------------------------------
@@ -49,7 +50,7 @@ typedef struct oc_debug_overlay
     u32 entryCount;
     u32 maxEntries;
     u64 logEntryTotalCount;
-    bool logScrollToLast;
+    oc_ui_list_info logList;
 
 } oc_debug_overlay;
 
@@ -243,6 +244,7 @@ typedef struct oc_runtime
 
     oc_file_table fileTable;
     oc_file rootDir;
+    oc_bundle bundle;
 
     oc_str8 path;
     oc_wasm_env env;
@@ -0,0 +1,857 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "runtime_bundle.h"
+
+//------------------------------------------------------------------------
+// Entries lookup
+//------------------------------------------------------------------------
+
+static int oc_bundle_entry_cmp(const void* a, const void* b)
+{
+    return (oc_str8_cmp(((oc_bundle_entry*)a)->name, ((oc_bundle_entry*)b)->name));
+}
+
+//NOTE: returns the index of the first entry whose name is greater or equal to name
+static u64 oc_bundle_lower_bound(oc_bundle* bundle, oc_str8 name)
+{
+    u64 lo = 0;
+    u64 hi = bundle->entryCount;
+    while(lo < hi)
+    {
+        u64 mid = lo + (hi - lo) / 2;
+        if(oc_str8_cmp(bundle->entries[mid].name, name) < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return (lo);
+}
+
+static oc_bundle_entry* oc_bundle_find(oc_bundle* bundle, oc_str8 name)
+{
+    u64 index = oc_bundle_lower_bound(bundle, name);
+    if(index < bundle->entryCount && !oc_str8_cmp(bundle->entries[index].name, name))
+    {
+        return (&bundle->entries[index]);
+    }
+    return (0);
+}
+
+//NOTE: returns the range of entries under directory prefix. An empty prefix designates data/ itself.
+static void oc_bundle_find_dir(oc_bundle* bundle, oc_str8 prefix, u64* first, u64* end)
+{
+    if(!prefix.len)
+    {
+        *first = 0;
+        *end = bundle->entryCount;
+        return;
+    }
+
+    oc_scratch scratch = oc_scratch_begin();
+    oc_str8 dirPrefix = oc_str8_pushf(scratch.allocator, "%.*s/", oc_str8_ip(prefix));
+
+    u64 index = oc_bundle_lower_bound(bundle, dirPrefix);
+    *first = index;
+    while(index < bundle->entryCount
+          && bundle->entries[index].name.len > dirPrefix.len
+          && !memcmp(bundle->entries[index].name.ptr, dirPrefix.ptr, dirPrefix.len))
+    {
+        index++;
+    }
+    *end = index;
+
+    oc_scratch_end(scratch);
+}
+
+//NOTE: normalizes path relative to the directory prefix. Returns false if the path goes above data/.
+static bool oc_bundle_normalize_path(oc_allocator* allocator, oc_str8 prefix, oc_str8 path, oc_str8* result)
+{
+    char* buffer = oc_allocator_push_array_uninitialized(allocator, char, prefix.len + path.len + 1);
+    u64 len = 0;
+
+    //NOTE: absolute paths are relative to the app's root directory, ie. to data/
+    if(prefix.len && (!path.len || path.ptr[0] != '/'))
+    {
+        memcpy(buffer, prefix.ptr, prefix.len);
+        len = prefix.len;
+    }
+
+    u64 start = 0;
+    while(start < path.len)
+    {
+        u64 end = start;
+        while(end < path.len && path.ptr[end] != '/')
+        {
+            end++;
+        }
+        oc_str8 name = oc_str8_slice(path, start, end);
+        start = end + 1;
+
+        if(!name.len || !oc_str8_cmp(name, OC_STR8(".")))
+        {
+            continue;
+        }
+        else if(!oc_str8_cmp(name, OC_STR8("..")))
+        {
+            if(!len)
+            {
+                return (false);
+            }
+            while(len && buffer[len - 1] != '/')
+            {
+                len--;
+            }
+            len = len ? len - 1 : 0;
+        }
+        else
+        {
+            if(len)
+            {
+                buffer[len] = '/';
+                len++;
+            }
+            memcpy(buffer + len, name.ptr, name.len);
+            len += name.len;
+        }
+    }
+    *result = oc_str8_from_buffer(len, buffer);
+    return (true);
+}
+
+static oc_str8 oc_bundle_str8_dup(oc_str8 s)
+{
+    oc_str8 copy = { .ptr = malloc(s.len + 1), .len = s.len };
+    memcpy(copy.ptr, s.ptr, s.len);
+    copy.ptr[s.len] = '\0';
+    return (copy);
+}
+
+//------------------------------------------------------------------------
+// Stored entries offsets
+//------------------------------------------------------------------------
+
+static u32 oc_bundle_read_u16(char* p)
+{
+    u8* b = (u8*)p;
+    return (b[0] | (b[1] << 8));
+}
+
+static u32 oc_bundle_read_u32(char* p)
+{
+    u8* b = (u8*)p;
+    return (b[0] | (b[1] << 8) | (b[2] << 16) | ((u32)b[3] << 24));
+}
+
+static void oc_bundle_find_stored_offsets(oc_bundle* bundle)
+{
+    /*NOTE: libzip doesn't tell where the data of an entry is, so we read it from the central directory of the
+        mapped archive. Entries that are not stored, encrypted, or that use zip64 fields are left to libzip.
+    */
+    oc_str8 map = bundle->map;
+    if(map.len < 22)
+    {
+        return;
+    }
+
+    //NOTE: find the end of central directory record, which is followed by a comment of at most 64K
+    char* eocd = 0;
+    u64 searchStart = (map.len > 22 + 0xffff) ? map.len - 22 - 0xffff : 0;
+    for(u64 offset = map.len - 22;; offset--)
+    {
+        if(oc_bundle_read_u32(map.ptr + offset) == 0x06054b50)
+        {
+            eocd = map.ptr + offset;
+            break;
+        }
+        if(offset == searchStart)
+        {
+            break;
+        }
+    }
+    if(!eocd)
+    {
+        return;
+    }
+
+    u64 count = oc_bundle_read_u16(eocd + 10);
+    u64 offset = oc_bundle_read_u32(eocd + 16);
+
+    for(u64 i = 0; i < count; i++)
+    {
+        if(offset + 46 > map.len || oc_bundle_read_u32(map.ptr + offset) != 0x02014b50)
+        {
+            break;
+        }
+        char* header = map.ptr + offset;
+        u32 flags = oc_bundle_read_u16(header + 8);
+        u32 method = oc_bundle_read_u16(header + 10);
+        u64 compSize = oc_bundle_read_u32(header + 20);
+        u64 size = oc_bundle_read_u32(header + 24);
+        u64 nameLen = oc_bundle_read_u16(header + 28);
+        u64 extraLen = oc_bundle_read_u16(header + 30);
+        u64 commentLen = oc_bundle_read_u16(header + 32);
+        u64 localOffset = oc_bundle_read_u32(header + 42);
+
+        if(offset + 46 + nameLen > map.len)
+        {
+            break;
+        }
+        oc_str8 name = oc_str8_from_buffer(nameLen, header + 46);
+        offset += 46 + nameLen + extraLen + commentLen;
+
+        if(method != ZIP_CM_STORE
+           || (flags & 1)
+           || compSize != size
+           || size == 0xffffffff
+           || localOffset == 0xffffffff
+           || name.len <= 5
+           || memcmp(name.ptr, "data/", 5))
+        {
+            continue;
+        }
+
+        oc_bundle_entry* entry = oc_bundle_find(bundle, oc_str8_slice(name, 5, name.len));
+        if(entry && entry->size == size && localOffset + 30 <= map.len)
+        {
+            char* local = map.ptr + localOffset;
+            if(oc_bundle_read_u32(local) == 0x04034b50)
+            {
+                u64 dataOffset = localOffset + 30 + oc_bundle_read_u16(local + 26) + oc_bundle_read_u16(local + 28);
+                if(dataOffset + size <= map.len)
+                {
+                    entry->offset = dataOffset;
+                    entry->stored = true;
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------
+// Open/close
+//------------------------------------------------------------------------
+
+int oc_bundle_open(oc_bundle* bundle, oc_str8 path, oc_str8 dataDir, bool extractAll)
+{
+    memset(bundle, 0, sizeof(oc_bundle));
+
+    oc_scratch scratch = oc_scratch_begin();
+    int err = 0;
+
+    bundle->zip = zip_open(oc_str8_to_cstring(scratch.allocator, path), ZIP_RDONLY, 0);
+    if(!bundle->zip)
+    {
+        err = -1;
+    }
+    else
+    {
+        bundle->path = oc_bundle_str8_dup(path);
+        bundle->dataDir = oc_bundle_str8_dup(dataDir);
+
+        //NOTE: collect the regular files of data/, sorted by name
+        i64 count = zip_get_num_entries(bundle->zip, 0);
+        bundle->entries = oc_malloc_array(oc_bundle_entry, oc_max(count, 1));
+        memset(bundle->entries, 0, sizeof(oc_bundle_entry) * oc_max(count, 1));
+
+        for(i64 index = 0; index < count; index++)
+        {
+            zip_stat_t stat = { 0 };
+            if(zip_stat_index(bundle->zip, index, ZIP_FL_ENC_RAW, &stat) != 0 || !stat.name)
+            {
+                err = -1;
+                break;
+            }
+            oc_str8 name = OC_STR8(stat.name);
+            if(name.len > 5
+               && !memcmp(name.ptr, "data/", 5)
+               && name.ptr[name.len - 1] != '/')
+            {
+                oc_bundle_entry* entry = &bundle->entries[bundle->entryCount];
+                entry->name = oc_bundle_str8_dup(oc_str8_slice(name, 5, name.len));
+                entry->index = index;
+                entry->size = stat.size;
+                entry->bundle = bundle;
+                bundle->entryCount++;
+            }
+        }
+        qsort(bundle->entries, bundle->entryCount, sizeof(oc_bundle_entry), oc_bundle_entry_cmp);
+
+        if(!err && !extractAll)
+        {
+            bundle->archive = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, 0))
+            {
+                bundle->archive = oc_file_nil();
+            }
+            if(!oc_file_is_nil(bundle->archive))
+            {
+                bundle->map = oc_file_map(bundle->archive);
+            }
+            if(bundle->map.ptr)
+            {
+                oc_bundle_find_stored_offsets(bundle);
+            }
+            else
+            {
+                oc_log_warning("Couldn't map application bundle, extracting it instead\n");
+                extractAll = true;
+            }
+        }
+        bundle->extractAll = extractAll;
+
+        if(!err && extractAll)
+        {
+            err = oc_bundle_extract_all(bundle);
+        }
+    }
+
+    oc_scratch_end(scratch);
+    return (err);
+}
+
+void oc_bundle_close(oc_bundle* bundle)
+{
+    for(u64 i = 0; i < bundle->entryCount; i++)
+    {
+        oc_bundle_entry* entry = &bundle->entries[i];
+        if(entry->cached && !entry->stored)
+        {
+            free(entry->blob.contents.ptr);
+        }
+        free(entry->name.ptr);
+    }
+    free(bundle->entries);
+
+    for(u32 i = 0; i < bundle->dirCount; i++)
+    {
+        free(bundle->dirs[i].prefix.ptr);
+    }
+    free(bundle->dirs);
+
+    oc_file_unmap(bundle->map);
+    if(!oc_file_is_nil(bundle->archive))
+    {
+        oc_file_close(bundle->archive);
+    }
+    if(bundle->zip)
+    {
+        zip_close(bundle->zip);
+    }
+    free(bundle->dataDir.ptr);
+    free(bundle->path.ptr);
+
+    memset(bundle, 0, sizeof(oc_bundle));
+}
+
+//------------------------------------------------------------------------
+// Entries contents
+//------------------------------------------------------------------------
+
+static int oc_bundle_zip_read(zip_t* zip, i64 index, u64 size, char* buffer)
+{
+    zip_file_t* file = zip_fopen_index(zip, index, 0);
+    if(!file)
+    {
+        return (-1);
+    }
+    u64 offset = 0;
+    while(offset < size)
+    {
+        i64 n = zip_fread(file, buffer + offset, size - offset);
+        if(n <= 0)
+        {
+            break;
+        }
+        offset += n;
+    }
+    zip_fclose(file);
+    return ((offset == size) ? 0 : -1);
+}
+
+oc_str8 oc_bundle_read(oc_allocator* allocator, oc_bundle* bundle, oc_str8 name)
+{
+    oc_str8 result = { 0 };
+    oc_scratch scratch = oc_scratch_begin_next_allocator(allocator);
+
+    zip_stat_t stat = { 0 };
+    i64 index = zip_name_locate(bundle->zip, oc_str8_to_cstring(scratch.allocator, name), ZIP_FL_ENC_RAW);
+    if(index >= 0 && zip_stat_index(bundle->zip, index, 0, &stat) == 0)
+    {
+        char* buffer = oc_allocator_push_aligned_uninitialized(allocator, oc_max(stat.size, 1), 1);
+        if(buffer && oc_bundle_zip_read(bundle->zip, index, stat.size, buffer) == 0)
+        {
+            result = oc_str8_from_buffer(stat.size, buffer);
+        }
+    }
+
+    oc_scratch_end(scratch);
+    return (result);
+}
+
+static void oc_bundle_cache_trim(oc_bundle* bundle, u64 reserve)
+{
+    while(bundle->cacheSize + reserve > OC_BUNDLE_CACHE_SIZE)
+    {
+        oc_bundle_entry* entry = oc_list_pop_front_elt(&bundle->lru, oc_bundle_entry, lruElt);
+        if(!entry)
+        {
+            break;
+        }
+        free(entry->blob.contents.ptr);
+        entry->blob.contents = (oc_str8){ 0 };
+        entry->cached = false;
+        bundle->cacheSize -= entry->size;
+    }
+}
+
+static void oc_bundle_blob_release(oc_file_blob* blob)
+{
+    oc_bundle_entry* entry = (oc_bundle_entry*)blob->user;
+    oc_bundle* bundle = entry->bundle;
+
+    OC_DEBUG_ASSERT(entry->refCount);
+    entry->refCount--;
+    if(!entry->refCount && !entry->stored)
+    {
+        oc_list_push_back(&bundle->lru, &entry->lruElt);
+        oc_bundle_cache_trim(bundle, 0);
+    }
+}
+
+static oc_file_blob* oc_bundle_entry_acquire(oc_bundle* bundle, oc_bundle_entry* entry)
+{
+    if(!entry->cached)
+    {
+        if(entry->stored)
+        {
+            entry->blob.contents = oc_str8_slice(bundle->map, entry->offset, entry->offset + entry->size);
+        }
+        else
+        {
+            oc_bundle_cache_trim(bundle, entry->size);
+
+            char* buffer = malloc(oc_max(entry->size, 1));
+            if(!buffer)
+            {
+                return (0);
+            }
+            if(oc_bundle_zip_read(bundle->zip, entry->index, entry->size, buffer) != 0)
+            {
+                free(buffer);
+                return (0);
+            }
+            entry->blob.contents = oc_str8_from_buffer(entry->size, buffer);
+            bundle->cacheSize += entry->size;
+        }
+        entry->blob.release = oc_bundle_blob_release;
+        entry->blob.user = entry;
+        entry->cached = true;
+    }
+    else if(!entry->refCount && !entry->stored)
+    {
+        oc_list_remove(&bundle->lru, &entry->lruElt);
+    }
+    entry->refCount++;
+    return (&entry->blob);
+}
+
+//------------------------------------------------------------------------
+// Extraction
+//------------------------------------------------------------------------
+
+static oc_io_error oc_bundle_makedirs(oc_bundle* bundle, u64 first, u64 end)
+{
+    oc_io_error error = OC_IO_OK;
+    oc_scratch scratch = oc_scratch_begin();
+
+    //NOTE: entries are sorted, so entries of the same directory are next to each other
+    oc_str8 lastDir = { 0 };
+    for(u64 i = first; i < end && !error; i++)
+    {
+        oc_str8 dir = oc_path_slice_directory(bundle->entries[i].name);
+        if(i == first || oc_str8_cmp(dir, lastDir))
+        {
+            oc_str8 path = oc_path_append(scratch.allocator, bundle->dataDir, dir);
+            error = oc_file_makedir(path,
+                                    &(oc_file_makedir_options){
+                                        .flags = OC_FILE_MAKEDIR_CREATE_PARENTS | OC_FILE_MAKEDIR_IGNORE_EXISTING,
+                                    });
+            lastDir = dir;
+        }
+    }
+
+    oc_scratch_end(scratch);
+    return (error);
+}
+
+static oc_io_error oc_bundle_extract_entry(oc_bundle* bundle, oc_bundle_entry* entry)
+{
+    oc_io_error error = OC_IO_OK;
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_file_blob* blob = oc_bundle_entry_acquire(bundle, entry);
+    if(!blob)
+    {
+        error = OC_IO_ERR_UNKNOWN;
+    }
+    else
+    {
+        oc_str8 path = oc_path_append(scratch.allocator, bundle->dataDir, entry->name);
+        oc_file file = oc_catch(oc_file_open(path,
+                                             OC_FILE_ACCESS_WRITE,
+                                             &(oc_file_open_options){
+                                                 .flags = OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE,
+                                             }))
+        {
+            error = oc_last_error();
+        }
+        if(!error)
+        {
+            oc_file_write(file, blob->contents.len, blob->contents.ptr);
+            error = oc_file_last_error(file);
+            oc_file_close(file);
+        }
+        blob->release(blob);
+    }
+    if(!error)
+    {
+        entry->extracted = true;
+    }
+    else
+    {
+        oc_log_error("Couldn't extract bundle entry %.*s\n", oc_str8_ip(entry->name));
+    }
+
+    oc_scratch_end(scratch);
+    return (error);
+}
+
+static oc_io_error oc_bundle_extract_range(oc_bundle* bundle, u64 first, u64 end)
+{
+    oc_io_error error = oc_bundle_makedirs(bundle, first, end);
+    for(u64 i = first; i < end && !error; i++)
+    {
+        if(!bundle->entries[i].extracted)
+        {
+            error = oc_bundle_extract_entry(bundle, &bundle->entries[i]);
+        }
+    }
+    return (error);
+}
+
+typedef struct oc_bundle_extract_job
+{
+    oc_bundle* bundle;
+    _Atomic(u64) nextEntry;
+    _Atomic(bool) failed;
+} oc_bundle_extract_job;
+
+static i32 oc_bundle_extract_thread(void* user)
+{
+    oc_bundle_extract_job* job = (oc_bundle_extract_job*)user;
+    oc_bundle* bundle = job->bundle;
+
+    //NOTE: libzip archives can't be shared between threads, so each thread opens its own
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    zip_t* zip = zip_open(bundle->path.ptr, ZIP_RDONLY, 0);
+    char* chunk = malloc(OC_BUNDLE_EXTRACT_CHUNK_SIZE);
+    if(!zip || !chunk)
+    {
+        job->failed = true;
+    }
+
+    while(zip && !job->failed)
+    {
+        u64 index = atomic_fetch_add(&job->nextEntry, 1);
+        if(index >= bundle->entryCount)
+        {
+            break;
+        }
+        oc_bundle_entry* entry = &bundle->entries[index];
+
+        oc_str8 path = oc_path_append(arena.allocator, bundle->dataDir, entry->name);
+        FILE* dst = fopen(oc_str8_to_cstring(arena.allocator, path), "wb");
+        if(!dst)
+        {
+            job->failed = true;
+            break;
+        }
+
+        bool ok = true;
+        if(entry->stored)
+        {
+            oc_str8 contents = oc_str8_slice(bundle->map, entry->offset, entry->offset + entry->size);
+            ok = (fwrite(contents.ptr, 1, contents.len, dst) == contents.len);
+        }
+        else
+        {
+            zip_file_t* src = zip_fopen_index(zip, entry->index, 0);
+            ok = (src != 0);
+            while(ok)
+            {
+                i64 n = zip_fread(src, chunk, OC_BUNDLE_EXTRACT_CHUNK_SIZE);
+                if(n == 0)
+                {
+                    break;
+                }
+                ok = (n > 0) && (fwrite(chunk, 1, n, dst) == n);
+            }
+            if(src)
+            {
+                zip_fclose(src);
+            }
+        }
+        fclose(dst);
+
+        if(ok)
+        {
+            entry->extracted = true;
+        }
+        else
+        {
+            job->failed = true;
+        }
+        oc_arena_clear(&arena);
+    }
+
+    if(zip)
+    {
+        zip_close(zip);
+    }
+    free(chunk);
+    oc_arena_cleanup(&arena);
+    return (0);
+}
+
+int oc_bundle_extract_all(oc_bundle* bundle)
+{
+    if(oc_bundle_makedirs(bundle, 0, bundle->entryCount) != OC_IO_OK)
+    {
+        return (-1);
+    }
+
+    oc_bundle_extract_job job = { .bundle = bundle };
+
+    //NOTE: threads pull entries until there are none left, so the calling thread also takes part
+    u32 threadCount = oc_clamp(bundle->entryCount, 1, OC_BUNDLE_EXTRACT_THREAD_COUNT) - 1;
+    oc_thread* threads[OC_BUNDLE_EXTRACT_THREAD_COUNT] = { 0 };
+    for(u32 i = 0; i < threadCount; i++)
+    {
+        threads[i] = oc_thread_create_with_name(oc_bundle_extract_thread, &job, OC_STR8("bundle extract"));
+    }
+    oc_bundle_extract_thread(&job);
+
+    for(u32 i = 0; i < threadCount; i++)
+    {
+        if(threads[i])
+        {
+            oc_thread_join(threads[i], 0);
+        }
+    }
+    return (job.failed ? -1 : 0);
+}
+
+//------------------------------------------------------------------------
+// IO requests
+//------------------------------------------------------------------------
+
+static oc_bundle_dir* oc_bundle_find_handle(oc_bundle* bundle, oc_file handle)
+{
+    for(u32 i = 0; i < bundle->dirCount; i++)
+    {
+        if(bundle->dirs[i].handle.h == handle.h)
+        {
+            return (&bundle->dirs[i]);
+        }
+    }
+    return (0);
+}
+
+static void oc_bundle_push_dir(oc_bundle* bundle, oc_file handle, oc_file_access rights, oc_str8 prefix)
+{
+    if(bundle->dirCount >= bundle->dirCap)
+    {
+        u32 newCap = oc_max(8, bundle->dirCap * 1.5);
+        oc_bundle_dir* dirs = realloc(bundle->dirs, newCap * sizeof(oc_bundle_dir));
+        if(!dirs)
+        {
+            return;
+        }
+        bundle->dirs = dirs;
+        bundle->dirCap = newCap;
+    }
+    bundle->dirs[bundle->dirCount] = (oc_bundle_dir){
+        .handle = handle,
+        .rights = rights,
+        .prefix = oc_bundle_str8_dup(prefix),
+    };
+    bundle->dirCount++;
+}
+
+//NOTE: finds the path relative to data/ of the directory a request is relative to. Returns false if the
+//      directory isn't data/ itself or a directory of the archive.
+static bool oc_bundle_find_prefix(oc_bundle* bundle, oc_file rootDir, oc_file handle, oc_file_access rights, oc_str8* prefix)
+{
+    if(bundle->extractAll || !bundle->entryCount)
+    {
+        return (false);
+    }
+
+    //NOTE: the root directory is data/ itself. Other directories of the archive are registered when they are opened.
+    *prefix = (oc_str8){ 0 };
+    if(handle.h != rootDir.h)
+    {
+        oc_bundle_dir* dir = oc_bundle_find_handle(bundle, handle);
+        if(!dir || (dir->rights & rights) != rights)
+        {
+            return (false);
+        }
+        *prefix = dir->prefix;
+    }
+    return (true);
+}
+
+bool oc_bundle_handle_open(oc_bundle* bundle, oc_file_table* table, oc_file rootDir, oc_io_req* req, oc_io_cmp* cmp)
+{
+    /*NOTE: serve an open request from the archive if it designates an entry that wasn't extracted.
+        Returns false if the request must be handled by the file table.
+    */
+    oc_str8 prefix = { 0 };
+    if(!oc_bundle_find_prefix(bundle, rootDir, req->handle, req->open.rights, &prefix))
+    {
+        return (false);
+    }
+
+    bool handled = false;
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 name = { 0 };
+    if(oc_bundle_normalize_path(scratch.allocator, prefix, oc_str8_from_buffer(req->size, req->buffer), &name))
+    {
+        oc_bundle_entry* entry = oc_bundle_find(bundle, name);
+        if(entry)
+        {
+            if(entry->extracted)
+            {
+                //NOTE: the file table opens it from the user data directory
+            }
+            else if(!(req->open.rights & OC_FILE_ACCESS_WRITE)
+                    && !(req->open.flags & (OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE)))
+            {
+                oc_file_blob* blob = oc_bundle_entry_acquire(bundle, entry);
+                if(blob)
+                {
+                    *cmp = oc_io_open_blob_for_table(blob, oc_path_slice_filename(name), table);
+                    handled = true;
+                }
+            }
+            else
+            {
+                //NOTE: copy on write
+                oc_bundle_extract_range(bundle, entry - bundle->entries, entry - bundle->entries + 1);
+            }
+        }
+        else
+        {
+            u64 first = 0;
+            u64 end = 0;
+            oc_bundle_find_dir(bundle, name, &first, &end);
+            if(first != end)
+            {
+                //NOTE: directory of the archive. Create it in the user data directory, and remember its path
+                //      so that the files opened through it are served from the archive.
+                oc_bundle_makedirs(bundle, first, first + 1);
+
+                *cmp = oc_io_wait_single_req_for_table(req, table);
+                if(cmp->error == OC_IO_OK)
+                {
+                    oc_bundle_push_dir(bundle, cmp->handle, req->open.rights, name);
+                }
+                handled = true;
+            }
+        }
+    }
+
+    oc_scratch_end(scratch);
+    return (handled);
+}
+
+void oc_bundle_handle_remove(oc_bundle* bundle, oc_file rootDir, oc_io_req* req)
+{
+    /*NOTE: an entry that wasn't extracted only exists in the archive, so removing it from the user data directory
+        would fail, and the archive would keep serving it. We extract it first, so that the file table removes it
+        with the same checks and errors as when the whole bundle was extracted at startup, and so that it is then
+        looked up in the user data directory only. Directories of the archive are extracted with their entries, so
+        that removing them fails if they aren't empty.
+    */
+    oc_str8 prefix = { 0 };
+    if(!oc_bundle_find_prefix(bundle, rootDir, req->handle, 0, &prefix))
+    {
+        return;
+    }
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    oc_str8 name = { 0 };
+    if(oc_bundle_normalize_path(scratch.allocator, prefix, oc_str8_from_buffer(req->size, req->buffer), &name))
+    {
+        oc_bundle_entry* entry = oc_bundle_find(bundle, name);
+        if(entry)
+        {
+            if(!entry->extracted)
+            {
+                oc_bundle_extract_range(bundle, entry - bundle->entries, entry - bundle->entries + 1);
+            }
+        }
+        else
+        {
+            u64 first = 0;
+            u64 end = 0;
+            oc_bundle_find_dir(bundle, name, &first, &end);
+            oc_bundle_extract_range(bundle, first, end);
+        }
+    }
+
+    oc_scratch_end(scratch);
+}
+
+void oc_bundle_handle_close(oc_bundle* bundle, oc_file handle)
+{
+    for(u32 i = 0; i < bundle->dirCount; i++)
+    {
+        if(bundle->dirs[i].handle.h == handle.h)
+        {
+            free(bundle->dirs[i].prefix.ptr);
+            bundle->dirs[i] = bundle->dirs[bundle->dirCount - 1];
+            bundle->dirCount--;
+            break;
+        }
+    }
+}
+
+void oc_bundle_handle_listdir(oc_bundle* bundle, oc_file rootDir, oc_file directory)
+{
+    //NOTE: listing a directory must show the files of the archive, so we extract them first
+    oc_bundle_dir* dir = oc_bundle_find_handle(bundle, directory);
+    if(!bundle->extractAll && (directory.h == rootDir.h || dir))
+    {
+        oc_str8 prefix = dir ? dir->prefix : (oc_str8){ 0 };
+        u64 first = 0;
+        u64 end = 0;
+        oc_bundle_find_dir(bundle, prefix, &first, &end);
+        oc_bundle_extract_range(bundle, first, end);
+    }
+}
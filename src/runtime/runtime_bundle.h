@@ -0,0 +1,98 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "platform/native_io.h"
+#include "ext/libzip/lib/zip.h"
+
+//------------------------------------------------------------------------
+// App bundle
+//------------------------------------------------------------------------
+/*NOTE:
+    The app bundle is a zip archive, containing the wasm module in modules/ and the app's resources in data/.
+
+    Resources are served to the app straight out of the archive: opening an entry of data/ read-only at the app's
+    root directory returns a handle over a blob, which points into a mapping of the archive if the entry is stored,
+    or into a cache of decompressed entries if it is deflated.
+
+    The app's root directory is the user data directory, which is writable, so the archive is an overlay on top of
+    it. When an entry is opened for writing or removed, or when a directory containing entries is listed, the
+    entries are first extracted to the user data directory, and from then on they are served from there. This
+    keeps the behaviour of extracting the whole bundle at startup, without paying for it until it's needed.
+
+    If the archive can't be mapped, or if extraction is requested, all entries are extracted at startup instead,
+    using several threads.
+*/
+
+enum
+{
+    OC_BUNDLE_CACHE_SIZE = 64 << 20,
+    OC_BUNDLE_EXTRACT_THREAD_COUNT = 8,
+    OC_BUNDLE_EXTRACT_CHUNK_SIZE = 256 << 10,
+};
+
+typedef struct oc_bundle oc_bundle;
+
+typedef struct oc_bundle_entry
+{
+    oc_str8 name; // relative to data/
+    i64 index;
+    u64 size;
+    u64 offset; // offset of the data in the archive, for stored entries
+    bool stored;
+    bool extracted;
+
+    //NOTE: contents of the entry, shared by all the handles opened on it. Deflated entries are kept in the cache
+    //      while they are unreferenced, and evicted in least recently used order.
+    oc_file_blob blob;
+    u32 refCount;
+    bool cached;
+    oc_list_links lruElt;
+    oc_bundle* bundle;
+} oc_bundle_entry;
+
+typedef struct oc_bundle_dir
+{
+    oc_file handle;
+    oc_file_access rights;
+    oc_str8 prefix;
+} oc_bundle_dir;
+
+typedef struct oc_bundle
+{
+    oc_str8 path;
+    zip_t* zip;
+    oc_file archive;
+    oc_str8 map;
+
+    oc_str8 dataDir;
+
+    u64 entryCount;
+    oc_bundle_entry* entries; // sorted by name
+
+    u64 cacheSize;
+    oc_list lru;
+
+    //NOTE: directories of the archive opened by the app, and their path relative to data/
+    u32 dirCount;
+    u32 dirCap;
+    oc_bundle_dir* dirs;
+
+    bool extractAll;
+} oc_bundle;
+
+int oc_bundle_open(oc_bundle* bundle, oc_str8 path, oc_str8 dataDir, bool extractAll);
+void oc_bundle_close(oc_bundle* bundle);
+
+oc_str8 oc_bundle_read(oc_allocator* allocator, oc_bundle* bundle, oc_str8 name);
+int oc_bundle_extract_all(oc_bundle* bundle);
+
+bool oc_bundle_handle_open(oc_bundle* bundle, oc_file_table* table, oc_file rootDir, oc_io_req* req, oc_io_cmp* cmp);
+void oc_bundle_handle_remove(oc_bundle* bundle, oc_file rootDir, oc_io_req* req);
+void oc_bundle_handle_close(oc_bundle* bundle, oc_file handle);
+void oc_bundle_handle_listdir(oc_bundle* bundle, oc_file rootDir, oc_file directory);
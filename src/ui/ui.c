@@ -74,23 +74,38 @@ typedef struct oc_ui_pattern
 typedef struct oc_ui_style_rule
 {
     oc_list_links boxElt;
-    oc_list_links rulesetElt;
 
     oc_ui_box* owner;
     oc_ui_pattern pattern;
     oc_ui_attribute_mask mask;
     oc_ui_style style;
+    u64 hash;
 } oc_ui_style_rule;
 
+//NOTE: rules that are in scope during the styling pass are indexed by the hash of a selector they need to match next,
+//      so that boxes only test the rules that can match one of their tags or their key. Derived rules
+//      (ie rules whose first selectors already matched an ancestor) reference the original rule and the
+//      remaining part of its pattern instead of copying it.
+typedef struct oc_ui_rule_entry
+{
+    oc_list_links bucketElt;
+    oc_list_links levelElt;
+
+    oc_ui_style_rule* rule;
+    oc_ui_selector* selector;
+    u64 hash;
+    u64 order;
+    u32 bucket;
+} oc_ui_rule_entry;
+
 //-----------------------------------------------------------------------------
 // style variables structs
 //-----------------------------------------------------------------------------
 
 typedef struct oc_ui_var_stack
 {
-    oc_list_links bucketElt;
     oc_str8 name;
-    u64 hash;
+    u64 generation; // the stack's vars are stale if this isn't the context's current styleVarGeneration
     oc_list vars;
 } oc_ui_var_stack;
 
@@ -126,12 +141,6 @@ typedef struct oc_ui_var
 
 } oc_ui_var;
 
-typedef struct oc_ui_var_map
-{
-    u64 mask;
-    oc_list* buckets;
-} oc_ui_var_map;
-
 //-----------------------------------------------------------------------------
 // context structs
 //-----------------------------------------------------------------------------
@@ -161,9 +170,26 @@ struct oc_ui_stack_elt
     };
 };
 
+//NOTE: cached boxes are stored in a hash map keyed by their key hash, and in a dense array.
+//      The dense array is partitioned by generation: a box built in the current frame is swapped into the
+//      first liveCount entries, so that at the end of the frame the boxes that weren't built are exactly
+//      the tail of the array, and pruning only visits the boxes that died.
+typedef struct oc_ui_box_map
+{
+    oc_hash_map table;
+
+    u64 count;
+    u64 cap;
+    u64 liveCount;
+    oc_ui_box** boxes;
+
+} oc_ui_box_map;
+
 enum
 {
-    OC_UI_BOX_MAP_BUCKET_COUNT = 1024
+    OC_UI_BOX_MAP_INITIAL_COUNT = 1024,
+    OC_UI_VAR_MAP_INITIAL_COUNT = 256,
+    OC_UI_RULE_INDEX_BUCKET_COUNT = 256,
 };
 
 typedef struct oc_ui_context
@@ -181,7 +207,7 @@ typedef struct oc_ui_context
 
     oc_arena boxArena;
     oc_list boxFreeList;
-    oc_list boxMap[OC_UI_BOX_MAP_BUCKET_COUNT];
+    oc_ui_box_map boxMap;
 
     oc_ui_box* root;
     oc_ui_box* overlay;
@@ -195,13 +221,61 @@ typedef struct oc_ui_context
 
     oc_font defaultFont;
     oc_list nextBoxTags;
-    oc_ui_var_map styleVariables;
+    //NOTE: variable stacks by name. Stacks and their names live in styleVarArena and stay in the map across
+    //      frames, while their vars are allocated from the frame arena. Instead of clearing the map at the end of
+    //      each frame, we bump styleVarGeneration, and stacks stamped with an older generation are treated as empty.
+    oc_hash_map styleVariables;
+    oc_arena styleVarArena;
+    u64 styleVarGeneration;
     oc_ui_style_rule* workingRule;
 
+    oc_list ruleIndex[OC_UI_RULE_INDEX_BUCKET_COUNT];
+    u64 ruleOrder;
+
 } oc_ui_context;
 
 oc_thread_local oc_ui_context* oc_uiCurrentContext = 0;
 
+//-----------------------------------------------------------------------------
+// incremental update hashes
+//-----------------------------------------------------------------------------
+//NOTE: boxes are rebuilt every frame, so we detect which parts of the tree changed by hashing their inputs,
+//      and skip restyling, relayout and redrawing the parts whose hashes are the same as last frame.
+
+static const u64 OC_UI_HASH_SEED = 0x9e3779b97f4a7c15ULL;
+
+static u64 oc_ui_hash_mix(u64 hash, u64 word)
+{
+    u64 x = hash ^ word;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return (x ^ (x >> 31));
+}
+
+static u64 oc_ui_hash_bytes(u64 hash, u64 size, const void* data)
+{
+    const char* bytes = (const char*)data;
+    u64 offset = 0;
+    for(; offset + sizeof(u64) <= size; offset += sizeof(u64))
+    {
+        u64 word;
+        memcpy(&word, bytes + offset, sizeof(u64));
+        hash = oc_ui_hash_mix(hash, word);
+    }
+    if(offset < size)
+    {
+        u64 word = 0;
+        memcpy(&word, bytes + offset, size - offset);
+        hash = oc_ui_hash_mix(hash, word);
+    }
+    return (oc_ui_hash_mix(hash, size));
+}
+
+static u64 oc_ui_hash_str8(u64 hash, oc_str8 string)
+{
+    return (oc_ui_hash_bytes(hash, string.len, string.ptr));
+}
+
 //-----------------------------------------------------------------------------
 // Context init/cleanup and thread local context
 //-----------------------------------------------------------------------------
@@ -221,9 +295,10 @@ oc_ui_context* oc_ui_context_create(oc_font defaultFont)
 
     ui->defaultFont = defaultFont;
 
-    ui->styleVariables.mask = (4 << 10) - 1;
-    //TODO: we could avoid zero-init with a framecounter for each bucket
-    ui->styleVariables.buckets = oc_arena_push_array(ui->frameArena, oc_list, 4 << 10);
+    oc_hash_map_init(&ui->boxMap.table, 0, OC_UI_BOX_MAP_INITIAL_COUNT);
+    oc_hash_map_init(&ui->styleVariables, 0, OC_UI_VAR_MAP_INITIAL_COUNT);
+    oc_arena_init(&ui->styleVarArena);
+    ui->styleVarGeneration = 1;
 
     ui->init = true;
 
@@ -239,6 +314,15 @@ void oc_ui_context_destroy(oc_ui_context* context)
         oc_ui_set_context(0);
     }
 
+    for(u64 i = 0; i < context->boxMap.count; i++)
+    {
+        oc_canvas_recording_destroy(context->boxMap.boxes[i]->drawRecording);
+    }
+    oc_hash_map_cleanup(&context->boxMap.table);
+    free(context->boxMap.boxes);
+    oc_hash_map_cleanup(&context->styleVariables);
+    oc_arena_cleanup(&context->styleVarArena);
+
     for(int i = 0; i < 2; i++)
     {
         oc_arena_cleanup(&context->frameArenas[i]);
@@ -350,7 +434,7 @@ void oc_ui_box_pop(void)
 
 oc_ui_tag oc_ui_tag_make_str8(oc_str8 string)
 {
-    oc_ui_tag tag = { .hash = oc_hash_xx64_string(string) };
+    oc_ui_tag tag = { .hash = oc_hash_xxh3_string(string) };
     return (tag);
 }
 
@@ -402,7 +486,7 @@ oc_ui_key oc_ui_key_make_str8(oc_str8 string)
     }
 
     oc_ui_key key = { 0 };
-    key.hash = oc_hash_xx64_string_seed(string, seed);
+    key.hash = oc_hash_xxh3_string_seed(string, seed);
     return (key);
 }
 
@@ -417,7 +501,7 @@ oc_ui_key oc_ui_key_make_path(oc_str8_list path)
     }
     oc_typed_list_for(path.list, elt)
     {
-        seed = oc_hash_xx64_string_seed(elt->string, seed);
+        seed = oc_hash_xxh3_string_seed(elt->string, seed);
     }
     oc_ui_key key = { seed };
     return (key);
@@ -430,23 +514,46 @@ bool oc_ui_key_equal(oc_ui_key a, oc_ui_key b)
 
 void oc_ui_box_cache(oc_ui_context* ui, oc_ui_box* box)
 {
-    u64 index = box->key.hash & (OC_UI_BOX_MAP_BUCKET_COUNT - 1);
-    oc_list_push_back(&(ui->boxMap[index]), &box->bucketElt);
+    oc_ui_box_map* map = &ui->boxMap;
+    oc_hash_map_insert_u64(&map->table, box->key.hash, 0)->ptr = box;
+
+    if(map->count >= map->cap)
+    {
+        map->cap = oc_max(map->cap * 1.5, 256);
+        map->boxes = realloc(map->boxes, map->cap * sizeof(oc_ui_box*));
+        OC_ASSERT(map->boxes, "couldn't allocate box cache");
+    }
+    box->cacheIndex = map->count;
+    map->boxes[map->count] = box;
+    map->count++;
 }
 
-oc_ui_box* oc_ui_box_lookup_key(oc_ui_key key)
+static void oc_ui_box_cache_touch(oc_ui_context* ui, oc_ui_box* box)
 {
-    oc_ui_context* ui = oc_ui_get_context();
-    u64 index = key.hash & (OC_UI_BOX_MAP_BUCKET_COUNT - 1);
-
-    oc_list_for(ui->boxMap[index], box, oc_ui_box, bucketElt)
+    //NOTE: move the box to the live part of the dense array
+    oc_ui_box_map* map = &ui->boxMap;
+    if(box->cacheIndex >= map->liveCount)
     {
-        if(oc_ui_key_equal(key, box->key))
-        {
-            return (box);
-        }
+        oc_ui_box* other = map->boxes[map->liveCount];
+        map->boxes[box->cacheIndex] = other;
+        other->cacheIndex = box->cacheIndex;
+
+        map->boxes[map->liveCount] = box;
+        box->cacheIndex = map->liveCount;
+        map->liveCount++;
     }
-    return (0);
+}
+
+static void oc_ui_box_uncache(oc_ui_context* ui, oc_ui_box* box)
+{
+    oc_hash_map_erase_u64(&ui->boxMap.table, box->key.hash);
+}
+
+oc_ui_box* oc_ui_box_lookup_key(oc_ui_key key)
+{
+    oc_ui_context* ui = oc_ui_get_context();
+    oc_hash_map_entry* entry = oc_hash_map_find_u64(&ui->boxMap.table, key.hash);
+    return (entry ? entry->ptr : 0);
 }
 
 oc_ui_box* oc_ui_box_lookup_str8(oc_str8 string)
@@ -463,7 +570,7 @@ void oc_ui_pattern_push(oc_arena* arena, oc_ui_pattern* pattern, oc_ui_selector
 {
     oc_ui_selector* copy = oc_arena_push_type(arena, oc_ui_selector);
     *copy = selector;
-    copy->hash = oc_hash_xx64_string(copy->string);
+    copy->hash = oc_hash_xxh3_string(copy->string);
     oc_list_push_back(&pattern->l, &copy->listElt);
 
     OC_DEBUG_ASSERT(selector.kind < 2);
@@ -570,6 +677,7 @@ void oc_ui_style_rule_begin(oc_str8 patternString)
             //NOTE: create the rule and put it on the workbench
             oc_ui_style_rule* rule = oc_arena_push_type(ui->frameArena, oc_ui_style_rule);
             rule->pattern = pattern;
+            rule->hash = oc_ui_hash_str8(OC_UI_HASH_SEED, patternString);
 
             ui->workingRule = rule;
         }
@@ -583,10 +691,14 @@ void oc_ui_style_rule_end()
     {
         if(ui->workingRule)
         {
+            oc_ui_style_rule* rule = ui->workingRule;
+            rule->hash = oc_ui_hash_mix(rule->hash, rule->mask);
+            rule->hash = oc_ui_hash_bytes(rule->hash, sizeof(oc_ui_style), &rule->style);
+
             oc_ui_box* box = oc_ui_box_top();
             if(box)
             {
-                oc_list_push_back(&box->rules, &ui->workingRule->boxElt);
+                oc_list_push_back(&box->rules, &rule->boxElt);
             }
             ui->workingRule = 0;
         }
@@ -887,26 +999,18 @@ oc_ui_var* oc_ui_var_find(oc_str8 name)
 {
     oc_ui_context* ui = oc_ui_get_context();
 
-    u64 hash = oc_hash_xx64_string(name);
-    u64 index = hash & ui->styleVariables.mask;
-    oc_list bucket = ui->styleVariables.buckets[index];
-    oc_ui_var_stack* stack = 0;
+    oc_hash_map_entry* entry = oc_hash_map_find_str8(&ui->styleVariables, name);
 
-    oc_list_for(bucket, elt, oc_ui_var_stack, bucketElt)
+    oc_ui_var* var = 0;
+    if(entry)
     {
-        if(elt->hash == hash)
+        oc_ui_var_stack* stack = entry->ptr;
+        if(stack->generation == ui->styleVarGeneration)
         {
-            stack = elt;
-            break;
+            var = oc_list_first_elt(stack->vars, oc_ui_var, stackElt);
         }
     }
 
-    oc_ui_var* var = 0;
-    if(stack)
-    {
-        var = oc_list_first_elt(stack->vars, oc_ui_var, stackElt);
-    }
-
     return var;
 }
 
@@ -916,26 +1020,26 @@ void oc_ui_var_push(oc_str8 name, oc_ui_value value, bool alwaysSet, oc_list* sc
 
     oc_ui_var* var = oc_arena_push_type(ui->frameArena, oc_ui_var);
 
-    u64 hash = oc_hash_xx64_string(name);
-    u64 index = hash & ui->styleVariables.mask;
-    oc_list* bucket = &ui->styleVariables.buckets[index];
     oc_ui_var_stack* stack = 0;
-
-    oc_list_for(*bucket, elt, oc_ui_var_stack, bucketElt)
+    oc_hash_map_entry* entry = oc_hash_map_find_str8(&ui->styleVariables, name);
+    if(entry)
     {
-        if(elt->hash == hash)
-        {
-            stack = elt;
-            break;
-        }
+        stack = entry->ptr;
     }
-    if(!stack)
+    else
     {
-        stack = oc_arena_push_type(ui->frameArena, oc_ui_var_stack);
+        stack = oc_arena_push_type(&ui->styleVarArena, oc_ui_var_stack);
+        stack->name = oc_str8_push_copy(ui->styleVarArena.allocator, name);
 
-        stack->name = oc_str8_push_copy(ui->frameArena->allocator, name);
-        stack->hash = hash;
-        oc_list_push_back(bucket, &stack->bucketElt);
+        //NOTE: the key points to the stack's copy of the name, which lives as long as the stack
+        oc_hash_map_insert_str8(&ui->styleVariables, stack->name, 0)->ptr = stack;
+    }
+
+    if(stack->generation != ui->styleVarGeneration)
+    {
+        //NOTE: the stack's vars were pushed in a previous frame, and their memory has been recycled
+        stack->vars = (oc_list){ 0 };
+        stack->generation = ui->styleVarGeneration;
     }
 
     var->stack = stack;
@@ -1649,6 +1753,8 @@ oc_ui_box* oc_ui_box_begin_str8(oc_str8 string)
     //NOTE: setup hierarchy
     if(box->frameCounter != ui->frameCounter)
     {
+        oc_ui_box_cache_touch(ui, box);
+
         box->children = (oc_list){ 0 };
         box->childCount = 0;
         box->parent = oc_ui_box_top();
@@ -2295,19 +2401,22 @@ bool oc_ui_style_selector_match(oc_ui_box* box, oc_ui_style_rule* rule, oc_ui_se
     return (res);
 }
 
-oc_ui_style_rule* oc_ui_style_rule_match(oc_ui_context* ui, oc_ui_box* box, oc_ui_style_rule* rule, oc_ui_pattern_specificity* specArray)
+oc_ui_selector* oc_ui_style_rule_match(oc_ui_box* box, oc_ui_rule_entry* entry, oc_ui_pattern_specificity* specArray, u64* matchCount)
 {
-    oc_ui_selector* selector = oc_list_first_elt(rule->pattern.l, oc_ui_selector, listElt);
+    oc_ui_style_rule* rule = entry->rule;
+    oc_ui_selector* selector = entry->selector;
     bool match = oc_ui_style_selector_match(box, rule, selector);
+    *matchCount = 1;
 
     selector = oc_list_next_elt(selector, oc_ui_selector, listElt);
     while(match && selector && selector->op == OC_UI_SEL_AND)
     {
         match = match && oc_ui_style_selector_match(box, rule, selector);
         selector = oc_list_next_elt(selector, oc_ui_selector, listElt);
+        (*matchCount)++;
     }
 
-    oc_ui_style_rule* derived = 0;
+    oc_ui_selector* remaining = 0;
     if(match)
     {
         if(!selector)
@@ -2320,105 +2429,253 @@ oc_ui_style_rule* oc_ui_style_rule_match(oc_ui_context* ui, oc_ui_box* box, oc_u
         }
         else
         {
-            //NOTE create derived rule if there's more than one selector
-            derived = oc_arena_push_type(ui->frameArena, oc_ui_style_rule);
-            derived->mask = rule->mask;
-            derived->style = rule->style;
-            derived->pattern.l = (oc_list){ &selector->listElt, rule->pattern.l.last };
-            derived->pattern.specificity = rule->pattern.specificity;
+            //NOTE the rest of the pattern must be matched by descendants
+            remaining = selector;
         }
     }
-    return derived;
+    return remaining;
 }
 
-void oc_ui_styling_prepass(oc_ui_context* ui, oc_ui_box* box, oc_list* ruleset)
+void oc_ui_rule_index_push(oc_ui_context* ui, oc_ui_rule_entry* entry)
 {
-    oc_list saveParent = *ruleset;
-
-    //NOTE(martin): add box rules to the ruleset
-    oc_list_for(box->rules, rule, oc_ui_style_rule, boxElt)
+    //NOTE: all selectors of the leading compound must match the box, so we can index the entry by any of them.
+    //      We use the last one, since qualifiers such as status tags usually come after the element's tag
+    //      and are more selective.
+    oc_ui_selector* indexSelector = entry->selector;
+    oc_ui_selector* next = oc_list_next_elt(indexSelector, oc_ui_selector, listElt);
+    while(next && next->op == OC_UI_SEL_AND)
     {
-        oc_list_push_back(ruleset, &rule->rulesetElt);
+        indexSelector = next;
+        next = oc_list_next_elt(next, oc_ui_selector, listElt);
     }
 
-    //NOTE(martin): match ruleset against box, which may produce derived rules
-
-    oc_scratch scratch = oc_scratch_begin();
-
-    oc_ui_pattern_specificity* specArray = oc_arena_push_array(scratch.arena, oc_ui_pattern_specificity, OC_UI_ATTRIBUTE_COUNT);
+    entry->order = ui->ruleOrder++;
+    entry->bucket = indexSelector->hash & (OC_UI_RULE_INDEX_BUCKET_COUNT - 1);
+    oc_list_push_back(&ui->ruleIndex[entry->bucket], &entry->bucketElt);
+}
 
-    oc_list derivedRules = { 0 };
-    oc_list_for(*ruleset, rule, oc_ui_style_rule, rulesetElt)
+void oc_ui_rule_index_add_candidates(oc_ui_context* ui, u64 hash, u32* buckets, oc_list_links** cursors, u32* bucketCount)
+{
+    u32 bucket = hash & (OC_UI_RULE_INDEX_BUCKET_COUNT - 1);
+    if(!ui->ruleIndex[bucket].first)
     {
-        oc_ui_style_rule* derived = oc_ui_style_rule_match(ui, box, rule, specArray);
-        if(derived)
+        return;
+    }
+    for(u32 i = 0; i < *bucketCount; i++)
+    {
+        if(buckets[i] == bucket)
         {
-            oc_list_push_back(&derivedRules, &derived->rulesetElt);
+            return;
         }
     }
+    buckets[*bucketCount] = bucket;
+    cursors[*bucketCount] = ui->ruleIndex[bucket].first;
+    (*bucketCount)++;
+}
 
-    oc_scratch_end(scratch);
+bool oc_ui_box_style_settled(oc_ui_box* box)
+{
+    oc_ui_style* style = &box->style;
+    oc_ui_style* target = box->targetStyle;
 
-    //NOTE(martin): add derived rules to ruleset and recurse in children
-    if(ruleset->last)
+    bool settled = true;
+    for(int i = 0; i < OC_UI_AXIS_COUNT; i++)
     {
-        ruleset->last->next = derivedRules.first;
+        settled = settled
+               && style->size.c[i].value == target->size.c[i].value
+               && style->size.c[i].grow == target->size.c[i].grow
+               && style->size.c[i].shrink == target->size.c[i].shrink;
     }
-    if(derivedRules.first)
+    settled = settled
+           && !memcmp(&style->color, &target->color, sizeof(oc_color))
+           && !memcmp(&style->bgColor, &target->bgColor, sizeof(oc_color))
+           && !memcmp(&style->borderColor, &target->borderColor, sizeof(oc_color))
+           && style->fontSize == target->fontSize
+           && style->borderSize == target->borderSize
+           && style->roundness == target->roundness
+           && style->offset.x == target->offset.x
+           && style->offset.y == target->offset.y;
+
+    return (settled);
+}
+
+void oc_ui_box_compute_static_sizes(oc_ui_box* box, bool measureText)
+{
+    oc_ui_style* style = &box->style;
+
+    oc_ui_size desiredSize[2] = { box->style.size.c[OC_UI_AXIS_X],
+                                  box->style.size.c[OC_UI_AXIS_Y] };
+
+    if(measureText
+       && (desiredSize[OC_UI_AXIS_X].kind == OC_UI_SIZE_TEXT
+           || desiredSize[OC_UI_AXIS_Y].kind == OC_UI_SIZE_TEXT))
     {
-        derivedRules.first->prev = ruleset->last;
+        box->textBox = oc_font_text_metrics(style->font, style->fontSize, box->text).logical;
     }
-    if(derivedRules.last)
+
+    for(int i = 0; i < OC_UI_AXIS_COUNT; i++)
     {
-        ruleset->last = derivedRules.last;
+        oc_ui_size size = desiredSize[i];
+
+        if(size.kind == OC_UI_SIZE_TEXT)
+        {
+            f32 margin = style->layout.margin.c[i];
+            box->rect.c[2 + i] = box->textBox.c[2 + i] + margin * 2;
+        }
+        else if(size.kind == OC_UI_SIZE_PIXELS)
+        {
+            box->rect.c[2 + i] = size.value;
+        }
     }
+}
 
+void oc_ui_box_restore_static_sizes(oc_ui_box* box)
+{
     oc_list_for(box->children, child, oc_ui_box, listElt)
     {
-        oc_ui_styling_prepass(ui, child, ruleset);
+        oc_ui_box_restore_static_sizes(child);
     }
-
-    //NOTE(martin): restore ruleset to its previous state
-    *ruleset = saveParent;
-    if(ruleset->last)
+    if(!oc_ui_box_hidden(box))
     {
-        ruleset->last->next = 0;
+        oc_ui_box_compute_static_sizes(box, false);
     }
+}
 
-    //NOTE: compute static sizes
-    oc_ui_box_animate_style(ui, box);
+bool oc_ui_box_styling_clean(oc_ui_box* box, u64 rulesetHash)
+{
+    return (!box->fresh
+            && !box->animating
+            && box->subtreeHash == box->styledSubtreeHash
+            && rulesetHash == box->styledRulesetHash);
+}
 
-    if(oc_ui_box_hidden(box))
+void oc_ui_styling_prepass(oc_ui_context* ui, oc_ui_box* box, u64 rulesetHash)
+{
+    //NOTE: if the subtree and the rules it inherits are the same as when it was last styled, its styles
+    //      are still valid. We only need to reset the static sizes that the last layout may have modified.
+    if(oc_ui_box_styling_clean(box, rulesetHash))
     {
+        oc_ui_box_restore_static_sizes(box);
         return;
     }
 
-    oc_ui_style* style = &box->style;
-
-    oc_rect textBox = { 0 };
-    oc_ui_size desiredSize[2] = { box->style.size.c[OC_UI_AXIS_X],
-                                  box->style.size.c[OC_UI_AXIS_Y] };
+    oc_scratch scratch = oc_scratch_begin();
+    u64 saveOrder = ui->ruleOrder;
+    u64 childRulesetHash = rulesetHash;
+    oc_list levelEntries = { 0 };
 
-    if(desiredSize[OC_UI_AXIS_X].kind == OC_UI_SIZE_TEXT
-       || desiredSize[OC_UI_AXIS_Y].kind == OC_UI_SIZE_TEXT)
+    //NOTE(martin): add box rules to the rule index
+    oc_list_for(box->rules, rule, oc_ui_style_rule, boxElt)
     {
-        textBox = oc_font_text_metrics(style->font, style->fontSize, box->text).logical;
+        oc_ui_selector* selector = oc_list_first_elt(rule->pattern.l, oc_ui_selector, listElt);
+        if(selector)
+        {
+            oc_ui_rule_entry* entry = oc_arena_push_type(scratch.arena, oc_ui_rule_entry);
+            entry->rule = rule;
+            entry->selector = selector;
+            entry->hash = rule->hash;
+            oc_ui_rule_index_push(ui, entry);
+            oc_list_push_back(&levelEntries, &entry->levelElt);
+        }
+        childRulesetHash = oc_ui_hash_mix(childRulesetHash, rule->hash);
     }
 
-    for(int i = 0; i < OC_UI_AXIS_COUNT; i++)
+    //NOTE: collect the index buckets that can hold rules matching the box's key or one of its tags
+    u32 maxBucketCount = oc_list_count(box->tags) + 1;
+    oc_list_links** cursors = oc_arena_push_array(scratch.arena, oc_list_links*, maxBucketCount);
+    u32* buckets = oc_arena_push_array(scratch.arena, u32, maxBucketCount);
+    u32 bucketCount = 0;
+
+    if(box->keyString.len)
     {
-        oc_ui_size size = desiredSize[i];
+        u64 hash = oc_hash_xxh3_string(box->keyString);
+        oc_ui_rule_index_add_candidates(ui, hash, buckets, cursors, &bucketCount);
+    }
+    oc_list_for(box->tags, elt, oc_ui_tag_elt, listElt)
+    {
+        oc_ui_rule_index_add_candidates(ui, elt->tag.hash, buckets, cursors, &bucketCount);
+    }
 
-        if(size.kind == OC_UI_SIZE_TEXT)
+    //NOTE(martin): match candidate rules against box, in the order they were added to the index,
+    //              which may produce derived rules
+
+    oc_ui_pattern_specificity* specArray = oc_arena_push_array(scratch.arena, oc_ui_pattern_specificity, OC_UI_ATTRIBUTE_COUNT);
+
+    oc_list derivedEntries = { 0 };
+    while(true)
+    {
+        u32 next = 0;
+        oc_ui_rule_entry* entry = 0;
+        for(u32 i = 0; i < bucketCount; i++)
         {
-            f32 margin = style->layout.margin.c[i];
-            box->rect.c[2 + i] = textBox.c[2 + i] + margin * 2;
+            if(cursors[i])
+            {
+                oc_ui_rule_entry* candidate = oc_list_elt(cursors[i], oc_ui_rule_entry, bucketElt);
+                if(!entry || candidate->order < entry->order)
+                {
+                    entry = candidate;
+                    next = i;
+                }
+            }
         }
-        else if(size.kind == OC_UI_SIZE_PIXELS)
+        if(!entry)
         {
-            box->rect.c[2 + i] = size.value;
+            break;
         }
+        cursors[next] = cursors[next]->next;
+
+        u64 matchCount = 0;
+        oc_ui_selector* remaining = oc_ui_style_rule_match(box, entry, specArray, &matchCount);
+        if(remaining)
+        {
+            oc_ui_rule_entry* derived = oc_arena_push_type(scratch.arena, oc_ui_rule_entry);
+            derived->rule = entry->rule;
+            derived->selector = remaining;
+            derived->hash = oc_ui_hash_mix(entry->hash, matchCount);
+            oc_list_push_back(&derivedEntries, &derived->levelElt);
+            childRulesetHash = oc_ui_hash_mix(childRulesetHash, derived->hash);
+        }
+    }
+
+    //NOTE(martin): add derived rules to the rule index and recurse in children
+    oc_list_for(derivedEntries, derived, oc_ui_rule_entry, levelElt)
+    {
+        oc_ui_rule_index_push(ui, derived);
+    }
+
+    bool childrenAnimating = false;
+    oc_list_for(box->children, child, oc_ui_box, listElt)
+    {
+        oc_ui_styling_prepass(ui, child, childRulesetHash);
+        childrenAnimating = childrenAnimating || child->animating;
     }
+
+    //NOTE(martin): restore rule index to its previous state
+    oc_list_for(levelEntries, entry, oc_ui_rule_entry, levelElt)
+    {
+        oc_list_remove(&ui->ruleIndex[entry->bucket], &entry->bucketElt);
+    }
+    oc_list_for(derivedEntries, entry, oc_ui_rule_entry, levelElt)
+    {
+        oc_list_remove(&ui->ruleIndex[entry->bucket], &entry->bucketElt);
+    }
+    ui->ruleOrder = saveOrder;
+
+    oc_scratch_end(scratch);
+
+    //NOTE: compute static sizes
+    oc_ui_box_animate_style(ui, box);
+
+    box->animating = childrenAnimating || !oc_ui_box_style_settled(box);
+    box->styledSubtreeHash = box->subtreeHash;
+    box->styledRulesetHash = rulesetHash;
+
+    if(oc_ui_box_hidden(box))
+    {
+        return;
+    }
+
+    oc_ui_box_compute_static_sizes(box, true);
 }
 
 void oc_ui_layout_find_next_hovered_recursive(oc_ui_context* ui, oc_ui_box* box, oc_vec2 p)
@@ -2468,54 +2725,123 @@ oc_rect oc_rect_union(oc_rect r1, oc_rect r2)
     return res;
 }
 
-typedef struct oc_ui_layout_item
+//NOTE: the layout is solved over a flat snapshot of the frame's boxes, in breadth-first order. In that order the
+//      children of each node are contiguous, so a node only stores the index of its first child and its child
+//      count, and each pass over the tree is a loop over index ranges. The style attributes the solver uses are
+//      copied into separate arrays, so that the passes don't pull whole boxes and styles into the cache.
+//      Rects are written back to the boxes once the layout is solved.
+typedef struct oc_ui_layout_tree
 {
-    oc_list_links listElt;
-    oc_ui_box* box;
+    u32 count;
+    oc_ui_box** boxes;
 
-    bool wrapped;
-    //    oc_list lines;
-} oc_ui_layout_item;
+    u32* firstChild;
+    u32* childCount;
 
-typedef struct oc_ui_layout_line_elt
-{
-    oc_list_links listElt;
-    oc_ui_box* box;
-} oc_ui_layout_line_elt;
+    bool* hidden;
+    bool* wrapped;
+    oc_rect* rects;
+
+    oc_ui_box_size* sizes;
+    oc_ui_layout* layouts;
+    oc_ui_box_position* positions;
+    oc_ui_box_footprint* footprints;
+    oc_vec2* offsets;
+
+    u32* lineItems;
+
+} oc_ui_layout_tree;
 
 typedef struct oc_ui_layout_line
 {
-    oc_list_links listElt;
     oc_vec2 size;
     u32 itemCount;
-    oc_list items;
+    u32* items;
 } oc_ui_layout_line;
 
-void oc_ui_layout_line_alignment(oc_ui_box* box, oc_ui_layout_line* line)
+oc_ui_layout_tree oc_ui_layout_tree_build(oc_arena* arena, oc_ui_box* root, u32 maxCount)
+{
+    oc_ui_layout_tree tree = { 0 };
+
+    tree.boxes = oc_arena_push_array(arena, oc_ui_box*, maxCount);
+    tree.firstChild = oc_arena_push_array(arena, u32, maxCount);
+    tree.childCount = oc_arena_push_array(arena, u32, maxCount);
+    tree.hidden = oc_arena_push_array(arena, bool, maxCount);
+    tree.wrapped = oc_arena_push_array(arena, bool, maxCount);
+    tree.rects = oc_arena_push_array(arena, oc_rect, maxCount);
+    tree.sizes = oc_arena_push_array(arena, oc_ui_box_size, maxCount);
+    tree.layouts = oc_arena_push_array(arena, oc_ui_layout, maxCount);
+    tree.positions = oc_arena_push_array(arena, oc_ui_box_position, maxCount);
+    tree.footprints = oc_arena_push_array(arena, oc_ui_box_footprint, maxCount);
+    tree.offsets = oc_arena_push_array(arena, oc_vec2, maxCount);
+    tree.lineItems = oc_arena_push_array(arena, u32, maxCount);
+
+    //NOTE: collect boxes in breadth-first order
+    tree.boxes[0] = root;
+    tree.count = 1;
+
+    for(u32 node = 0; node < tree.count; node++)
+    {
+        tree.firstChild[node] = tree.count;
+        oc_list_for(tree.boxes[node]->children, child, oc_ui_box, listElt)
+        {
+            OC_ASSERT(tree.count < maxCount);
+            tree.boxes[tree.count] = child;
+            tree.count++;
+        }
+        tree.childCount[node] = tree.count - tree.firstChild[node];
+    }
+
+    //NOTE: snapshot the attributes used by the solver, and set max size default value if needed
+    for(u32 node = 0; node < tree.count; node++)
+    {
+        oc_ui_box* box = tree.boxes[node];
+        for(int i = 0; i < OC_UI_AXIS_COUNT; i++)
+        {
+            if(box->style.size.c[i].max == 0)
+            {
+                box->style.size.c[i].max = FLT_MAX;
+            }
+        }
+        tree.hidden[node] = oc_ui_box_hidden(box);
+        tree.rects[node] = box->rect;
+        tree.sizes[node] = box->style.size;
+        tree.layouts[node] = box->style.layout;
+        tree.positions[node] = box->style.position;
+        tree.footprints[node] = box->style.footprint;
+        tree.offsets[node] = box->style.offset;
+    }
+    return (tree);
+}
+
+void oc_ui_layout_line_alignment(oc_ui_layout_tree* tree, u32 node, oc_ui_layout_line* line)
 {
-    oc_ui_axis mainAxis = box->style.layout.axis;
+    oc_ui_layout* layout = &tree->layouts[node];
+    oc_rect* rect = &tree->rects[node];
+    oc_ui_axis mainAxis = layout->axis;
     oc_ui_axis crossAxis = (mainAxis + 1) % OC_UI_AXIS_COUNT;
 
     // main axis alignment
-    f32 availableSpaceMainAxis = box->rect.c[2 + mainAxis] - 2 * box->style.layout.margin.c[mainAxis];
+    f32 availableSpaceMainAxis = rect->c[2 + mainAxis] - 2 * layout->margin.c[mainAxis];
 
-    if(box->style.layout.alignLine.c[mainAxis] == OC_UI_ALIGN_JUSTIFY)
+    if(layout->alignLine.c[mainAxis] == OC_UI_ALIGN_JUSTIFY)
     {
         if(line->itemCount > 1)
         {
             f32 spacing = (availableSpaceMainAxis - line->size.c[mainAxis]) / (line->itemCount - 1);
             if(spacing > 0)
             {
-                oc_list_for_indexed(line->items, it, oc_ui_layout_line_elt, listElt)
+                for(u32 i = 0; i < line->itemCount; i++)
                 {
+                    oc_rect* itemRect = &tree->rects[line->items[i]];
+
                     //NOTE: re-spacing calc can overshoot just enough to create spurious scrollbars, so
                     // we clamp the new position to the max acceptable one
-                    f32 maxX = floor(box->rect.c[2 + mainAxis]
-                                     - box->style.layout.margin.c[mainAxis]
-                                     - it.elt->box->rect.c[2 + mainAxis]);
+                    f32 maxX = floor(rect->c[2 + mainAxis]
+                                     - layout->margin.c[mainAxis]
+                                     - itemRect->c[2 + mainAxis]);
 
-                    it.elt->box->rect.x = oc_clamp_high(it.elt->box->rect.x + spacing * it.index,
-                                                        maxX);
+                    itemRect->x = oc_clamp_high(itemRect->x + spacing * i, maxX);
                 }
             }
         }
@@ -2524,99 +2850,101 @@ void oc_ui_layout_line_alignment(oc_ui_box* box, oc_ui_layout_line* line)
     {
         f32 offsetMainAxis = 0;
 
-        if(box->style.layout.alignLine.c[mainAxis] == OC_UI_ALIGN_END)
+        if(layout->alignLine.c[mainAxis] == OC_UI_ALIGN_END)
         {
             offsetMainAxis = oc_clamp_low(availableSpaceMainAxis - line->size.c[mainAxis], 0);
         }
-        else if(box->style.layout.alignLine.c[mainAxis] == OC_UI_ALIGN_CENTER)
+        else if(layout->alignLine.c[mainAxis] == OC_UI_ALIGN_CENTER)
         {
             offsetMainAxis = oc_clamp_low((availableSpaceMainAxis - line->size.c[mainAxis]) / 2.0, 0);
         }
 
-        oc_list_for(line->items, item, oc_ui_layout_line_elt, listElt)
+        for(u32 i = 0; i < line->itemCount; i++)
         {
-            item->box->rect.c[mainAxis] += offsetMainAxis;
+            tree->rects[line->items[i]].c[mainAxis] += offsetMainAxis;
         }
     }
 
     // cross axis alignment
-    oc_list_for(line->items, item, oc_ui_layout_line_elt, listElt)
+    for(u32 i = 0; i < line->itemCount; i++)
     {
-        if(box->style.layout.alignLine.c[crossAxis] == OC_UI_ALIGN_END)
+        oc_rect* itemRect = &tree->rects[line->items[i]];
+        if(layout->alignLine.c[crossAxis] == OC_UI_ALIGN_END)
         {
-            item->box->rect.c[crossAxis] += oc_clamp_low(line->size.c[crossAxis] - item->box->rect.c[2 + crossAxis], 0);
+            itemRect->c[crossAxis] += oc_clamp_low(line->size.c[crossAxis] - itemRect->c[2 + crossAxis], 0);
         }
-        else if(box->style.layout.alignLine.c[crossAxis] == OC_UI_ALIGN_CENTER)
+        else if(layout->alignLine.c[crossAxis] == OC_UI_ALIGN_CENTER)
         {
-            item->box->rect.c[crossAxis] += oc_clamp_low((line->size.c[crossAxis] - item->box->rect.c[2 + crossAxis]) / 2.0, 0);
+            itemRect->c[crossAxis] += oc_clamp_low((line->size.c[crossAxis] - itemRect->c[2 + crossAxis]) / 2.0, 0);
         }
     }
 }
 
-void oc_ui_layout_contents(oc_ui_box* box, bool wrap)
+void oc_ui_layout_contents(oc_ui_layout_tree* tree, u32 node, bool wrap)
 {
-    oc_scratch scratch = oc_scratch_begin();
-
-    oc_ui_axis mainAxis = box->style.layout.axis;
+    oc_ui_layout* layout = &tree->layouts[node];
+    oc_rect* rect = &tree->rects[node];
+    oc_ui_axis mainAxis = layout->axis;
     oc_ui_axis crossAxis = (mainAxis + 1) % OC_UI_AXIS_COUNT;
 
     u32 colIndex = 0;
-    f32 wrapThreshold = box->rect.c[2 + mainAxis] - box->style.layout.margin.c[mainAxis];
+    f32 wrapThreshold = rect->c[2 + mainAxis] - layout->margin.c[mainAxis];
     oc_vec2 start = {
-        box->style.layout.margin.x,
-        box->style.layout.margin.y,
+        layout->margin.x,
+        layout->margin.y,
     };
     oc_vec2 pos = start;
-    oc_ui_layout_line line = { 0 };
+    oc_ui_layout_line line = { .items = tree->lineItems };
 
     oc_vec2 flowSize = { 0 };
 
-    oc_list_for(box->children, child, oc_ui_box, listElt)
+    u32 firstChild = tree->firstChild[node];
+    u32 endChild = firstChild + tree->childCount[node];
+
+    for(u32 child = firstChild; child < endChild; child++)
     {
-        if(!oc_ui_box_hidden(child))
+        if(!tree->hidden[child])
         {
-            switch(child->style.position)
+            switch(tree->positions[child])
             {
                 case OC_UI_POSITION_PARENT:
                 case OC_UI_POSITION_FRAME:
                 {
-                    child->rect.xy = child->style.offset;
+                    tree->rects[child].xy = tree->offsets[child];
                 }
                 break;
 
                 case OC_UI_POSITION_FLOW:
                 {
-                    f32 childSize = child->rect.c[2 + mainAxis];
+                    f32 childSize = tree->rects[child].c[2 + mainAxis];
 
                     if(wrap
                        && colIndex
-                       && child->style.footprint == OC_UI_FOOTPRINT_SOLID
+                       && tree->footprints[child] == OC_UI_FOOTPRINT_SOLID
                        && pos.c[mainAxis] + childSize > wrapThreshold)
                     {
                         //NOTE: new line
                         pos.c[mainAxis] = start.c[mainAxis];
-                        pos.c[crossAxis] += line.size.c[crossAxis] + box->style.layout.spacing;
+                        pos.c[crossAxis] += line.size.c[crossAxis] + layout->spacing;
                         colIndex = 0;
 
-                        oc_ui_layout_line_alignment(box, &line);
+                        oc_ui_layout_line_alignment(tree, node, &line);
                         flowSize.c[mainAxis] = oc_max(flowSize.c[mainAxis], line.size.c[mainAxis]);
-                        flowSize.c[crossAxis] += line.size.c[crossAxis] + box->style.layout.spacing;
+                        flowSize.c[crossAxis] += line.size.c[crossAxis] + layout->spacing;
 
-                        line = (oc_ui_layout_line){ 0 };
+                        line = (oc_ui_layout_line){ .items = line.items + line.itemCount };
                     }
                     //NOTE: set child position and add it to current line
-                    child->rect.xy = pos;
+                    tree->rects[child].xy = pos;
 
-                    oc_ui_layout_line_elt* lineElt = oc_arena_push_type(scratch.arena, oc_ui_layout_line_elt);
-                    lineElt->box = child;
-                    oc_list_push_back(&line.items, &lineElt->listElt);
+                    line.items[line.itemCount] = child;
                     line.itemCount++;
 
-                    if(child->style.footprint == OC_UI_FOOTPRINT_SOLID)
+                    if(tree->footprints[child] == OC_UI_FOOTPRINT_SOLID)
                     {
                         line.size.c[mainAxis] = pos.c[mainAxis] - start.c[mainAxis] + childSize;
-                        line.size.c[crossAxis] = oc_max(line.size.c[crossAxis], child->rect.c[2 + crossAxis]);
-                        pos.c[mainAxis] += childSize + box->style.layout.spacing;
+                        line.size.c[crossAxis] = oc_max(line.size.c[crossAxis], tree->rects[child].c[2 + crossAxis]);
+                        pos.c[mainAxis] += childSize + layout->spacing;
                     }
                     colIndex++;
                 }
@@ -2625,7 +2953,7 @@ void oc_ui_layout_contents(oc_ui_box* box, bool wrap)
         }
     }
     //NOTE: align last line
-    oc_ui_layout_line_alignment(box, &line);
+    oc_ui_layout_line_alignment(tree, node, &line);
     flowSize.c[mainAxis] = oc_max(flowSize.c[mainAxis], line.size.c[mainAxis]);
     flowSize.c[crossAxis] += line.size.c[crossAxis];
 
@@ -2634,8 +2962,8 @@ void oc_ui_layout_contents(oc_ui_box* box, bool wrap)
 
     for(int axis = OC_UI_AXIS_X; axis < OC_UI_AXIS_COUNT; axis++)
     {
-        f32 availableSpace = box->rect.c[2 + axis] - 2 * box->style.layout.margin.c[axis];
-        switch(box->style.layout.align.c[axis])
+        f32 availableSpace = rect->c[2 + axis] - 2 * layout->margin.c[axis];
+        switch(layout->align.c[axis])
         {
             case OC_UI_ALIGN_END:
                 alignOffset.c[axis] = oc_clamp_low(availableSpace - flowSize.c[axis], 0);
@@ -2648,66 +2976,71 @@ void oc_ui_layout_contents(oc_ui_box* box, bool wrap)
                 break;
         }
     }
-    oc_list_for(box->children, child, oc_ui_box, listElt)
+    for(u32 child = firstChild; child < endChild; child++)
     {
-        if(!oc_ui_box_hidden(child)
-           && child->style.position == OC_UI_POSITION_FLOW)
+        if(!tree->hidden[child]
+           && tree->positions[child] == OC_UI_POSITION_FLOW)
         {
-            child->rect.x += alignOffset.x;
-            child->rect.y += alignOffset.y;
+            tree->rects[child].x += alignOffset.x;
+            tree->rects[child].y += alignOffset.y;
         }
     }
-
-    oc_scratch_end(scratch);
 }
 
-oc_rect oc_ui_layout_contents_rect(oc_ui_box* box)
+oc_rect oc_ui_layout_contents_rect(oc_ui_layout_tree* tree, u32 node)
 {
     oc_rect flowRect = { 0, 0, -1, -1 };
     oc_rect fixedRect = { 0, 0, -1, -1 };
 
-    oc_list_for(box->children, child, oc_ui_box, listElt)
+    u32 firstChild = tree->firstChild[node];
+    u32 endChild = firstChild + tree->childCount[node];
+
+    for(u32 child = firstChild; child < endChild; child++)
     {
-        if(!oc_ui_box_hidden(child) && child->style.footprint == OC_UI_FOOTPRINT_SOLID)
+        if(!tree->hidden[child] && tree->footprints[child] == OC_UI_FOOTPRINT_SOLID)
         {
-            if(child->style.position == OC_UI_POSITION_FLOW)
+            if(tree->positions[child] == OC_UI_POSITION_FLOW)
             {
-                flowRect = oc_rect_union(flowRect, child->rect);
+                flowRect = oc_rect_union(flowRect, tree->rects[child]);
             }
             else
             {
-                fixedRect = oc_rect_union(fixedRect, child->rect);
+                fixedRect = oc_rect_union(fixedRect, tree->rects[child]);
             }
         }
     }
-    flowRect.x -= box->style.layout.margin.x;
-    flowRect.y -= box->style.layout.margin.y;
-    flowRect.w += 2 * box->style.layout.margin.x;
-    flowRect.h += 2 * box->style.layout.margin.y;
+    oc_ui_layout* layout = &tree->layouts[node];
+    flowRect.x -= layout->margin.x;
+    flowRect.y -= layout->margin.y;
+    flowRect.w += 2 * layout->margin.x;
+    flowRect.h += 2 * layout->margin.y;
 
     oc_rect contentRect = oc_rect_union(flowRect, fixedRect);
     return contentRect;
 }
 
-oc_vec2 oc_ui_layout_flow_size(oc_ui_box* box)
+oc_vec2 oc_ui_layout_flow_size(oc_ui_layout_tree* tree, u32 node)
 {
     oc_rect contentRect = { 0, 0, -1, -1 };
 
-    oc_list_for(box->children, child, oc_ui_box, listElt)
+    u32 firstChild = tree->firstChild[node];
+    u32 endChild = firstChild + tree->childCount[node];
+
+    for(u32 child = firstChild; child < endChild; child++)
     {
-        if(!oc_ui_box_hidden(child)
-           && child->style.position == OC_UI_POSITION_FLOW
-           && child->style.footprint == OC_UI_FOOTPRINT_SOLID)
+        if(!tree->hidden[child]
+           && tree->positions[child] == OC_UI_POSITION_FLOW
+           && tree->footprints[child] == OC_UI_FOOTPRINT_SOLID)
         {
-            contentRect = oc_rect_union(contentRect, child->rect);
+            contentRect = oc_rect_union(contentRect, tree->rects[child]);
         }
     }
     return contentRect.wh;
 }
 
-oc_vec2 oc_ui_layout_contents_size_positive(oc_ui_box* box)
+oc_vec2 oc_ui_layout_contents_size_positive(oc_ui_layout_tree* tree, u32 node)
 {
-    oc_rect rect = oc_ui_layout_contents_rect(box);
+    oc_rect rect = oc_ui_layout_contents_rect(tree, node);
     f32 x0 = oc_clamp_low(rect.x, 0);
     f32 y0 = oc_clamp_low(rect.y, 0);
     f32 x1 = oc_clamp_low(rect.x + rect.w, 0);
@@ -2716,11 +3049,48 @@ oc_vec2 oc_ui_layout_contents_size_positive(oc_ui_box* box)
     return (oc_vec2){ x1 - x0, y1 - y0 };
 }
 
+void oc_ui_box_compute_hashes(oc_ui_box* box)
+{
+    u64 hash = oc_ui_hash_mix(OC_UI_HASH_SEED, box->key.hash);
+    hash = oc_ui_hash_str8(hash, box->keyString);
+
+    oc_list_for(box->tags, elt, oc_ui_tag_elt, listElt)
+    {
+        hash = oc_ui_hash_mix(hash, elt->tag.hash);
+    }
+    oc_list_for(box->rules, rule, oc_ui_style_rule, boxElt)
+    {
+        hash = oc_ui_hash_mix(hash, rule->hash);
+    }
+    hash = oc_ui_hash_bytes(hash, sizeof(oc_ui_style), box->targetStyle);
+    hash = oc_ui_hash_str8(hash, box->text);
+    hash = oc_ui_hash_mix(hash, box->closed | (box->parentClosed << 1) | (box->overlay << 2));
+    hash = oc_ui_hash_bytes(hash, sizeof(oc_vec2), &box->scroll);
+
+    box->inputHash = hash;
+
+    u64 subtreeHash = oc_ui_hash_mix(hash, box->childCount);
+    oc_list_for(box->children, child, oc_ui_box, listElt)
+    {
+        oc_ui_box_compute_hashes(child);
+        subtreeHash = oc_ui_hash_mix(subtreeHash, child->subtreeHash);
+    }
+    box->subtreeHash = subtreeHash;
+}
+
 void oc_ui_solve_layout(oc_ui_context* ui)
 {
+    //NOTE: if no box changed since last frame, styles and layout are still valid and we only need to
+    //      rebuild the overlay hierarchy and find the hovered box.
+    oc_ui_box_compute_hashes(ui->root);
+
+    bool clean = oc_ui_box_styling_clean(ui->root, OC_UI_HASH_SEED);
+
     //NOTE: style and compute static sizes
-    oc_list rules = { 0 };
-    oc_ui_styling_prepass(ui, ui->root, &rules);
+    if(!clean)
+    {
+        oc_ui_styling_prepass(ui, ui->root, OC_UI_HASH_SEED);
+    }
 
     //NOTE: reparent overlay boxes
     oc_list_for(ui->overlayList, box, oc_ui_box, overlayElt)
@@ -2735,33 +3105,21 @@ void oc_ui_solve_layout(oc_ui_context* ui)
         }
     }
 
-    //NOTE: collect boxes into a breadth-first-order list
+    if(clean)
+    {
+        oc_ui_layout_find_next_hovered(ui, oc_ui_mouse_position());
+        return;
+    }
+
+    //NOTE: snapshot the tree. All the boxes in the tree were built this frame, so the live part of the box cache
+    //      bounds the number of boxes.
     oc_scratch scratch = oc_scratch_begin();
 
-    oc_list boxes = { 0 };
-    oc_ui_layout_item* rootElt = oc_arena_push_type(scratch.arena, oc_ui_layout_item);
-    rootElt->box = ui->root;
-    oc_list_push_back(&boxes, &rootElt->listElt);
+    oc_ui_layout_tree tree = oc_ui_layout_tree_build(scratch.arena, ui->root, ui->boxMap.liveCount);
 
-    oc_list_for(boxes, elt, oc_ui_layout_item, listElt)
-    {
-        //NOTE: push children to the end of the list
-        oc_list_for(elt->box->children, child, oc_ui_box, listElt)
-        {
-            oc_ui_layout_item* childElt = oc_arena_push_type(scratch.arena, oc_ui_layout_item);
-            childElt->box = child;
-            oc_list_push_back(&boxes, &childElt->listElt);
-        }
-
-        //NOTE: set max size default value if needed while we're at it
-        for(int i = 0; i < OC_UI_AXIS_COUNT; i++)
-        {
-            if(elt->box->style.size.c[i].max == 0)
-            {
-                elt->box->style.size.c[i].max = FLT_MAX;
-            }
-        }
-    }
+    oc_rect* rects = tree.rects;
+    oc_ui_box_size* sizes = tree.sizes;
+    oc_ui_layout* layouts = tree.layouts;
 
     bool wrapped = false;
 
@@ -2769,110 +3127,112 @@ void oc_ui_solve_layout(oc_ui_context* ui)
     {
         wrapped = false;
         //NOTE: compute children sum and desired size, bottom-up
-        oc_list_for_reverse(boxes, elt, oc_ui_layout_item, listElt)
+        for(i64 node = tree.count - 1; node >= 0; node--)
         {
-            oc_ui_box* box = elt->box;
-            oc_ui_axis mainAxis = box->style.layout.axis;
+            oc_ui_axis mainAxis = layouts[node].axis;
             oc_ui_axis crossAxis = (mainAxis + 1) % OC_UI_AXIS_COUNT;
 
             //NOTE: layout children into a single line
-            oc_ui_layout_contents(box, elt->wrapped);
+            oc_ui_layout_contents(&tree, node, tree.wrapped[node]);
 
             //NOTE: Compute children-dependent sizes.
             // (Text and pixels size have already been computed in styling pass)
-            oc_vec2 positiveContentSize = oc_ui_layout_contents_size_positive(box);
+            oc_vec2 positiveContentSize = oc_ui_layout_contents_size_positive(&tree, node);
 
-            if(box->style.size.c[mainAxis].kind == OC_UI_SIZE_CHILDREN)
+            if(sizes[node].c[mainAxis].kind == OC_UI_SIZE_CHILDREN)
             {
-                box->rect.c[2 + mainAxis] = positiveContentSize.c[mainAxis];
+                rects[node].c[2 + mainAxis] = positiveContentSize.c[mainAxis];
             }
-            if(box->style.size.c[crossAxis].kind == OC_UI_SIZE_CHILDREN)
+            if(sizes[node].c[crossAxis].kind == OC_UI_SIZE_CHILDREN)
             {
-                box->rect.c[2 + crossAxis] = positiveContentSize.c[crossAxis];
+                rects[node].c[2 + crossAxis] = positiveContentSize.c[crossAxis];
             }
 
             //NOTE: clamp to min/max size
             for(int i = 0; i < OC_UI_AXIS_COUNT; i++)
             {
-                box->rect.c[2 + i] = oc_clamp(box->rect.c[2 + i],
-                                              box->style.size.c[i].min,
-                                              box->style.size.c[i].max);
+                rects[node].c[2 + i] = oc_clamp(rects[node].c[2 + i],
+                                                sizes[node].c[i].min,
+                                                sizes[node].c[i].max);
             }
         }
 
         //NOTE: shrink/grow/wrap, top-down
-        oc_list_for(boxes, elt, oc_ui_layout_item, listElt)
+        for(u32 node = 0; node < tree.count; node++)
         {
-            oc_ui_box* box = elt->box;
-            oc_ui_axis mainAxis = box->style.layout.axis;
+            oc_ui_layout* layout = &layouts[node];
+            oc_ui_axis mainAxis = layout->axis;
             oc_ui_axis crossAxis = (mainAxis + 1) % OC_UI_AXIS_COUNT;
 
+            u32 childCount = tree.childCount[node];
+            u32 firstChild = tree.firstChild[node];
+            u32 endChild = firstChild + childCount;
+
             //NOTE: compute size of parent-dependent children
             for(int axis = 0; axis < OC_UI_AXIS_COUNT; axis++)
             {
-                f32 availableParentSize = box->rect.c[2 + axis]
-                                        - 2 * box->style.layout.margin.c[axis];
+                f32 availableParentSize = rects[node].c[2 + axis]
+                                        - 2 * layout->margin.c[axis];
 
-                if(axis == box->style.layout.axis)
+                if(axis == layout->axis)
                 {
-                    availableParentSize -= 2 * (box->childCount - 1) * box->style.layout.spacing;
+                    availableParentSize -= 2 * (childCount - 1) * layout->spacing;
                 }
 
-                oc_list_for(box->children, child, oc_ui_box, listElt)
+                for(u32 child = firstChild; child < endChild; child++)
                 {
-
-                    switch(child->style.size.c[axis].kind)
+                    switch(sizes[child].c[axis].kind)
                     {
                         case OC_UI_SIZE_PARENT:
                         {
-                            child->rect.c[2 + axis] = availableParentSize * child->style.size.c[axis].value;
+                            rects[child].c[2 + axis] = availableParentSize * sizes[child].c[axis].value;
                         }
                         break;
 
                         case OC_UI_SIZE_PARENT_MINUS_PIXELS:
                         {
-                            child->rect.c[2 + axis] = availableParentSize - child->style.size.c[axis].value;
+                            rects[child].c[2 + axis] = availableParentSize - sizes[child].c[axis].value;
                         }
                         break;
 
                         default:
                             break;
                     }
-                    child->rect.c[2 + axis] = oc_clamp(child->rect.c[2 + axis],
-                                                       child->style.size.c[axis].min,
-                                                       child->style.size.c[axis].max);
+                    rects[child].c[2 + axis] = oc_clamp(rects[child].c[2 + axis],
+                                                        sizes[child].c[axis].min,
+                                                        sizes[child].c[axis].max);
                 }
             }
 
             //NOTE: relayout & compute contents size here to take parent-dependent children into account
-            oc_ui_layout_contents(box, elt->wrapped);
-            oc_vec2 flowSize = oc_ui_layout_flow_size(box);
+            oc_ui_layout_contents(&tree, node, tree.wrapped[node]);
+            oc_vec2 flowSize = oc_ui_layout_flow_size(&tree, node);
 
             //NOTE: grow/shrink in cross axis
             //NOTE: give remaining space to each indidual child according to its shrink/grow weight, up to its min/max size
-            oc_list_for(box->children, child, oc_ui_box, listElt)
+            for(u32 child = firstChild; child < endChild; child++)
             {
                 //NOTE: compute remaining space in cross axis
 
-                f32 remainingSpace = box->rect.c[2 + crossAxis]
-                                   - 2 * box->style.layout.margin.c[crossAxis]
-                                   - child->rect.c[2 + crossAxis];
+                f32 remainingSpace = rects[node].c[2 + crossAxis]
+                                   - 2 * layout->margin.c[crossAxis]
+                                   - rects[child].c[2 + crossAxis];
 
                 //NOTE: should remove child borders?
                 f32 weight = remainingSpace > 0
-                               ? child->style.size.c[crossAxis].grow
-                               : child->style.size.c[crossAxis].shrink;
+                               ? sizes[child].c[crossAxis].grow
+                               : sizes[child].c[crossAxis].shrink;
 
-                child->rect.c[2 + crossAxis] = oc_clamp(child->rect.c[2 + crossAxis] + remainingSpace * weight,
-                                                        child->style.size.c[crossAxis].min,
-                                                        child->style.size.c[crossAxis].max);
+                rects[child].c[2 + crossAxis] = oc_clamp(rects[child].c[2 + crossAxis] + remainingSpace * weight,
+                                                         sizes[child].c[crossAxis].min,
+                                                         sizes[child].c[crossAxis].max);
             }
 
             //NOTE: grow/shrink in main axis
             {
                 //NOTE: compute remaining space
-                f32 remainingSpace = box->rect.c[2 + mainAxis]
-                                   - 2 * box->style.layout.margin.c[mainAxis]
+                f32 remainingSpace = rects[node].c[2 + mainAxis]
+                                   - 2 * layout->margin.c[mainAxis]
                                    - flowSize.c[mainAxis];
 
                 //NOTE: distribute remaining space among children, proportionally to their shrink/grow weight
@@ -2883,47 +3243,47 @@ void oc_ui_solve_layout(oc_ui_context* ui)
                     //NOTE: compute total weight of children that can still grow/shrink
                     f32 totalWeight = 0;
 
-                    oc_list_for(box->children, child, oc_ui_box, listElt)
+                    for(u32 child = firstChild; child < endChild; child++)
                     {
-                        if(child->style.position == OC_UI_POSITION_FLOW
-                           && child->style.footprint == OC_UI_FOOTPRINT_SOLID)
+                        if(tree.positions[child] == OC_UI_POSITION_FLOW
+                           && tree.footprints[child] == OC_UI_FOOTPRINT_SOLID)
                         {
-                            if(remainingSpace > 0 && child->rect.c[2 + mainAxis] < child->style.size.c[mainAxis].max)
+                            if(remainingSpace > 0 && rects[child].c[2 + mainAxis] < sizes[child].c[mainAxis].max)
                             {
-                                totalWeight += child->style.size.c[mainAxis].grow;
+                                totalWeight += sizes[child].c[mainAxis].grow;
                             }
-                            else if(remainingSpace < 0 && child->rect.c[2 + mainAxis] > child->style.size.c[mainAxis].min)
+                            else if(remainingSpace < 0 && rects[child].c[2 + mainAxis] > sizes[child].c[mainAxis].min)
                             {
-                                totalWeight += child->style.size.c[mainAxis].shrink;
+                                totalWeight += sizes[child].c[mainAxis].shrink;
                             }
                         }
                     }
                     if(totalWeight)
                     {
                         //NOTE: distribute space among children that can still grow/shrink, up to their min/max size
-                        oc_list_for(box->children, child, oc_ui_box, listElt)
+                        for(u32 child = firstChild; child < endChild; child++)
                         {
-                            if(child->style.position == OC_UI_POSITION_FLOW
-                               && child->style.footprint == OC_UI_FOOTPRINT_SOLID)
+                            if(tree.positions[child] == OC_UI_POSITION_FLOW
+                               && tree.footprints[child] == OC_UI_FOOTPRINT_SOLID)
                             {
                                 f32 childWeight = 0;
-                                if(remainingSpace > 0 && child->rect.c[2 + mainAxis] < child->style.size.c[mainAxis].max)
+                                if(remainingSpace > 0 && rects[child].c[2 + mainAxis] < sizes[child].c[mainAxis].max)
                                 {
-                                    childWeight = child->style.size.c[mainAxis].grow;
+                                    childWeight = sizes[child].c[mainAxis].grow;
                                 }
-                                else if(remainingSpace < 0 && child->rect.c[2 + mainAxis] > child->style.size.c[mainAxis].min)
+                                else if(remainingSpace < 0 && rects[child].c[2 + mainAxis] > sizes[child].c[mainAxis].min)
                                 {
-                                    childWeight = child->style.size.c[mainAxis].shrink;
+                                    childWeight = sizes[child].c[mainAxis].shrink;
                                 }
 
                                 f32 addSpace = remainingSpace * childWeight / totalWeight;
 
-                                f32 newSize = oc_clamp(child->rect.c[2 + mainAxis] + addSpace,
-                                                       child->style.size.c[mainAxis].min,
-                                                       child->style.size.c[mainAxis].max);
+                                f32 newSize = oc_clamp(rects[child].c[2 + mainAxis] + addSpace,
+                                                       sizes[child].c[mainAxis].min,
+                                                       sizes[child].c[mainAxis].max);
 
-                                newRemainingSpace -= newSize - child->rect.c[2 + mainAxis];
-                                child->rect.c[2 + mainAxis] = newSize;
+                                newRemainingSpace -= newSize - rects[child].c[2 + mainAxis];
+                                rects[child].c[2 + mainAxis] = newSize;
                             }
                         }
                     }
@@ -2936,51 +3296,56 @@ void oc_ui_solve_layout(oc_ui_context* ui)
 
                 //NOTE: if we still overflow, wrap if possible
                 if(remainingSpace < 0
-                   && box->style.layout.wrap
-                   && box->style.size.c[crossAxis].kind == OC_UI_SIZE_CHILDREN
-                   && !elt->wrapped)
+                   && layout->wrap
+                   && sizes[node].c[crossAxis].kind == OC_UI_SIZE_CHILDREN
+                   && !tree.wrapped[node])
                 {
                     //NOTE: mark element as wrapping, and signal that we want to relayout.
-                    elt->wrapped = true;
+                    tree.wrapped[node] = true;
                     wrapped = true;
                 }
             }
 
             //NOTE: relayout with shrinked sizes
-            oc_ui_layout_contents(box, box->style.layout.wrap);
+            oc_ui_layout_contents(&tree, node, layout->wrap);
         }
     }
 
     while(wrapped);
 
     //NOTE: compute rects, top down
-    oc_list_for(boxes, elt, oc_ui_layout_item, listElt)
+    for(u32 node = 0; node < tree.count; node++)
     {
-        oc_ui_box* box = elt->box;
+        oc_ui_box* box = tree.boxes[node];
+        u32 firstChild = tree.firstChild[node];
+        u32 endChild = firstChild + tree.childCount[node];
 
-        oc_list_for(box->children, child, oc_ui_box, listElt)
+        for(u32 child = firstChild; child < endChild; child++)
         {
-            child->rect.x += box->rect.x;
-            child->rect.y += box->rect.y;
+            rects[child].x += rects[node].x;
+            rects[child].y += rects[node].y;
         }
 
         //TODO: align whole (multi-line) contents inside box
 
         //NOTE: clamp scroll to max contents and offset children by it. We take into account all content here, not
         // just the positive quadrant.
-        box->contentSize = oc_ui_layout_contents_size_positive(box);
+        box->contentSize = oc_ui_layout_contents_size_positive(&tree, node);
 
-        box->scroll.x = oc_clamp(box->scroll.x, 0, box->contentSize.x - box->rect.w);
-        box->scroll.y = oc_clamp(box->scroll.y, 0, box->contentSize.y - box->rect.h);
+        box->scroll.x = oc_clamp(box->scroll.x, 0, box->contentSize.x - rects[node].w);
+        box->scroll.y = oc_clamp(box->scroll.y, 0, box->contentSize.y - rects[node].h);
 
-        oc_list_for(box->children, child, oc_ui_box, listElt)
+        for(u32 child = firstChild; child < endChild; child++)
         {
-            if(child->style.position != OC_UI_POSITION_FRAME)
+            if(tree.positions[child] != OC_UI_POSITION_FRAME)
             {
-                child->rect.x -= box->scroll.x;
-                child->rect.y -= box->scroll.y;
+                rects[child].x -= box->scroll.x;
+                rects[child].y -= box->scroll.y;
             }
         }
+
+        //NOTE: the box's rect is final once its parent has been processed
+        box->rect = rects[node];
     }
 
     oc_scratch_end(scratch);
@@ -3019,6 +3384,34 @@ void oc_ui_rectangle_stroke(oc_rect rect, f32 roundness)
     }
 }
 
+u64 oc_ui_box_draw_hash(oc_ui_box* box)
+{
+    u64 hash = oc_ui_hash_bytes(OC_UI_HASH_SEED, sizeof(oc_ui_style), &box->style);
+    hash = oc_ui_hash_bytes(hash, sizeof(oc_rect), &box->rect);
+    hash = oc_ui_hash_str8(hash, box->text);
+
+    //NOTE: canvas state that isn't set by oc_ui_draw_box()
+    oc_mat2x3 matrix = oc_matrix_top();
+    oc_rect clip = oc_clip_top();
+    oc_rect imageRegion = oc_get_image_source_region();
+    oc_vec2 position = oc_get_position();
+    f32 width = oc_get_width();
+    f32 tolerance = oc_get_tolerance();
+    f32 maxJointExcursion = oc_get_max_joint_excursion();
+
+    hash = oc_ui_hash_bytes(hash, sizeof(oc_mat2x3), &matrix);
+    hash = oc_ui_hash_bytes(hash, sizeof(oc_rect), &clip);
+    hash = oc_ui_hash_bytes(hash, sizeof(oc_rect), &imageRegion);
+    hash = oc_ui_hash_bytes(hash, sizeof(oc_vec2), &position);
+    hash = oc_ui_hash_bytes(hash, sizeof(f32), &width);
+    hash = oc_ui_hash_bytes(hash, sizeof(f32), &tolerance);
+    hash = oc_ui_hash_bytes(hash, sizeof(f32), &maxJointExcursion);
+    hash = oc_ui_hash_mix(hash, oc_get_image().h);
+    hash = oc_ui_hash_mix(hash, oc_get_joint() | (oc_get_cap() << 8) | (oc_get_text_flip() << 16));
+
+    return (hash);
+}
+
 void oc_ui_draw_box(oc_ui_box* box)
 {
     if(oc_ui_box_hidden(box))
@@ -3089,12 +3482,39 @@ void oc_ui_draw_box(oc_ui_box* box)
         oc_ui_draw_box(child);
     }
 
+    //NOTE: text and border commands only depend on the box's style, rect and text, and on the canvas state
+    //      they inherit, so we replay the commands recorded last frame when none of those changed.
+    bool drawText = draw
+                 && !(style->drawMask & OC_UI_DRAW_MASK_TEXT)
+                 && box->text.len
+                 && !oc_font_is_nil(style->font)
+                 && style->fontSize > 0;
+
+    bool drawBorder = draw
+                   && !(style->drawMask & OC_UI_DRAW_MASK_BORDER)
+                   && style->borderSize != 0
+                   && style->borderColor.a != 0;
+
+    bool record = false;
+    if(drawText || drawBorder)
+    {
+        u64 drawHash = oc_ui_box_draw_hash(box);
+        if(!box->drawRecording
+           || box->drawHash != drawHash
+           || !oc_canvas_replay(box->drawRecording))
+        {
+            if(!box->drawRecording)
+            {
+                box->drawRecording = oc_canvas_recording_create();
+            }
+            box->drawHash = drawHash;
+            record = true;
+            oc_canvas_record_begin(box->drawRecording);
+        }
+    }
+
     //NOTE: draw text
-    if(draw
-       && !(style->drawMask & OC_UI_DRAW_MASK_TEXT)
-       && box->text.len
-       && !oc_font_is_nil(style->font)
-       && style->fontSize > 0)
+    if(record && drawText)
     {
         oc_rect textBox = oc_font_text_metrics(style->font, style->fontSize, box->text).logical;
 
@@ -3141,26 +3561,26 @@ void oc_ui_draw_box(oc_ui_box* box)
         oc_fill();
     }
 
-    if(draw)
+    //NOTE: draw border
+    if(record && drawBorder)
     {
-        //NOTE: draw border
-        if(!(style->drawMask & OC_UI_DRAW_MASK_BORDER)
-           && style->borderSize != 0
-           && style->borderColor.a != 0)
-        {
-            oc_set_width(style->borderSize);
-            oc_set_color(style->borderColor);
+        oc_set_width(style->borderSize);
+        oc_set_color(style->borderColor);
 
-            oc_rect rect = {
-                box->rect.x + 0.5 * style->borderSize,
-                box->rect.y + 0.5 * style->borderSize,
-                box->rect.w - style->borderSize,
-                box->rect.h - style->borderSize,
-            };
-            f32 roundness = style->roundness ? style->roundness + style->borderSize : 0;
+        oc_rect rect = {
+            box->rect.x + 0.5 * style->borderSize,
+            box->rect.y + 0.5 * style->borderSize,
+            box->rect.w - style->borderSize,
+            box->rect.h - style->borderSize,
+        };
+        f32 roundness = style->roundness ? style->roundness + style->borderSize : 0;
 
-            oc_ui_rectangle_stroke(rect, roundness);
-        }
+        oc_ui_rectangle_stroke(rect, roundness);
+    }
+
+    if(record)
+    {
+        oc_canvas_record_end(box->drawRecording);
     }
 
     if(box->style.layout.overflow.x != OC_UI_OVERFLOW_ALLOW
@@ -3192,6 +3612,7 @@ void oc_ui_frame_begin(oc_vec2 size)
     oc_ui_context* ui = oc_ui_get_context();
 
     ui->frameCounter++;
+    ui->boxMap.liveCount = 0;
     f64 time = oc_clock_time(OC_CLOCK_MONOTONIC);
     ui->lastFrameDuration = time - ui->frameTime;
     ui->frameTime = time;
@@ -3308,26 +3729,26 @@ void oc_ui_frame_end(void)
     //NOTE: layout
     oc_ui_solve_layout(ui);
 
-    //NOTE: prune unused boxes
-    for(int i = 0; i < OC_UI_BOX_MAP_BUCKET_COUNT; i++)
+    //NOTE: prune unused boxes, ie the boxes past the live part of the cache
+    oc_ui_box_map* map = &ui->boxMap;
+    for(u64 i = map->liveCount; i < map->count; i++)
     {
-        oc_list_for_safe(ui->boxMap[i], box, oc_ui_box, bucketElt)
-        {
-            if(box->frameCounter < ui->frameCounter)
-            {
-                oc_list_remove(&ui->boxMap[i], &box->bucketElt);
-                oc_list_push_front(&ui->boxFreeList, &box->listElt);
-            }
-        }
+        oc_ui_box* box = map->boxes[i];
+        OC_DEBUG_ASSERT(box->frameCounter < ui->frameCounter);
+
+        oc_canvas_recording_destroy(box->drawRecording);
+        box->drawRecording = 0;
+
+        oc_ui_box_uncache(ui, box);
+        oc_list_push_front(&ui->boxFreeList, &box->listElt);
     }
+    map->count = map->liveCount;
 
     ui->frameArena = (ui->frameArena == &ui->frameArenas[0]) ? &ui->frameArenas[1] : &ui->frameArenas[0];
     oc_arena_clear(ui->frameArena);
 
     oc_input_next_frame(&ui->input);
 
-    //NOTE: we allocate variables map here so that we can push vars from outside frame
-    ui->styleVariables.buckets = oc_arena_push_array(ui->frameArena, oc_list, 4 << 10);
-    //TODO: we could avoid this with a framecounter for each bucket
-    memset(ui->styleVariables.buckets, 0, sizeof(oc_list) * (4 << 10));
+    //NOTE: invalidate the variable stacks here so that we can push vars from outside frame
+    ui->styleVarGeneration++;
 }
@@ -271,7 +271,7 @@ struct oc_ui_box
     bool overlay;
 
     // keying and caching
-    oc_list_links bucketElt;
+    u64 cacheIndex; // index in the context's dense array of cached boxes
     oc_ui_key key;
     u64 frameCounter;
 
@@ -296,6 +296,17 @@ struct oc_ui_box
 
     oc_list styleVariables;
 
+    // incremental update
+    u64 inputHash;   // hash of this frame's builder inputs (key, tags, rules, style, text, scroll, etc)
+    u64 subtreeHash; // hash of the inputs of the whole subtree
+    u64 styledSubtreeHash;
+    u64 styledRulesetHash;
+    bool animating; // style of the box or of one of its descendants hasn't reached its target yet
+    oc_rect textBox;
+
+    oc_canvas_recording* drawRecording;
+    u64 drawHash;
+
     // signals
     oc_ui_sig sig;
 
@@ -355,6 +366,7 @@ ORCA_API oc_ui_box* oc_ui_box_end(void);
 #define oc_ui_box(name) oc_ui_box_str8(OC_STR8(name))
 
 ORCA_API oc_ui_box* oc_ui_box_top();
+ORCA_API oc_ui_box* oc_ui_box_lookup_str8(oc_str8 string);
 
 ORCA_API void oc_ui_box_set_draw_proc(oc_ui_box* box, oc_ui_box_draw_proc proc, void* data);
 ORCA_API void oc_ui_box_set_text(oc_ui_box* box, oc_str8 text);
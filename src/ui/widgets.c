@@ -1651,6 +1651,7 @@ typedef struct oc_ui_text_box_render_data
     i32 mark;
     f64 frameTime;
     f64 cursorBlinkStart;
+    oc_color selectionColor;
 
 } oc_ui_text_box_render_data;
 
@@ -1706,10 +1707,7 @@ void oc_ui_text_box_render(oc_ui_box* box, void* data)
             selectBox.x += beforeSelectBox.x + beforeSelectBox.w;
             selectBox.y += textY;
 
-            /////////////////////////////////////////////////////////////////
-            //TODO: use style oc_set_color(ui->theme->palette->blue2);
-            /////////////////////////////////////////////////////////////////
-            oc_set_color_rgba(0.074, 0.361, 0.722, 1);
+            oc_set_color(renderData->selectionColor);
             oc_rectangle_fill(selectBox.x, selectBox.y, selectBox.w, lineHeight);
 
             oc_set_font(style->font);
@@ -1985,6 +1983,7 @@ oc_ui_text_box_result oc_ui_text_box_str8(oc_str8 key, oc_arena* arena, oc_ui_te
                     editCommandCount = OC_UI_EDIT_COMMAND_MACOS_COUNT;
                     break;
                 case OC_HOST_PLATFORM_WINDOWS:
+                case OC_HOST_PLATFORM_LINUX:
                     editCommands = OC_UI_EDIT_COMMANDS_WINDOWS;
                     editCommandCount = OC_UI_EDIT_COMMAND_WINDOWS_COUNT;
                     break;
@@ -2058,6 +2057,7 @@ oc_ui_text_box_result oc_ui_text_box_str8(oc_str8 key, oc_arena* arena, oc_ui_te
                 .mark = info->mark,
                 .frameTime = oc_ui_frame_time(),
                 .cursorBlinkStart = info->cursorBlinkStart,
+                .selectionColor = oc_ui_var_get_color_str8(OC_UI_THEME_PRIMARY_DISABLED),
             };
 
             oc_ui_set_draw_proc(oc_ui_text_box_render, renderData);
@@ -2073,6 +2073,7 @@ oc_ui_text_box_result oc_ui_text_box_str8(oc_str8 key, oc_arena* arena, oc_ui_te
                 .mark = info->mark,
                 .frameTime = oc_ui_frame_time(),
                 .cursorBlinkStart = info->cursorBlinkStart,
+                .selectionColor = oc_ui_var_get_color_str8(OC_UI_THEME_PRIMARY_DISABLED),
             };
 
             if(info->text.len)
@@ -2096,3 +2097,1311 @@ oc_ui_text_box_result oc_ui_text_box(const char* name, oc_arena* arena, oc_ui_te
 {
     return oc_ui_text_box_str8(OC_STR8(name), arena, info);
 }
+
+//------------------------------------------------------------------------------
+// list
+//------------------------------------------------------------------------------
+
+typedef struct oc_ui_list_frame
+{
+    oc_ui_list_info* info;
+    oc_ui_table_info* table;
+    oc_ui_box* list;
+
+    bool needsScroll;
+    f32 thumbRatio;
+    f32 scrollValue;
+    f64 maxScroll; // in pixels for fixed height rows, in rows for variable height rows
+
+} oc_ui_list_frame;
+
+//NOTE: must be called with the rows box on top of the box stack, so that row keys resolve to the
+//      boxes built during the previous frame
+f32 oc_ui_list_row_height(oc_ui_list_info* info, u64 index)
+{
+    f32 height = info->rowHeight;
+    if(info->variableHeight)
+    {
+        oc_scratch scratch = oc_scratch_begin();
+        oc_str8 key = oc_str8_pushf(scratch.allocator, "%llu", index);
+        oc_ui_box* row = oc_ui_box_lookup_str8(key);
+        if(row && row->rect.h > 0)
+        {
+            height = row->rect.h;
+        }
+        oc_scratch_end(scratch);
+    }
+    return (oc_max(height, 1));
+}
+
+f32 oc_ui_list_layout_fixed(oc_ui_list_info* info, oc_ui_list_frame* frame, f32 viewHeight, f32 delta)
+{
+    f64 rowHeight = oc_max(info->rowHeight, 1);
+    f64 contentHeight = info->rowCount * rowHeight;
+    f64 maxPos = oc_max(contentHeight - viewHeight, 0);
+
+    f64 pos = info->scrollRow * rowHeight + info->scrollOffset + delta;
+    if(info->followLast && info->atEnd && delta >= 0)
+    {
+        pos = maxPos;
+    }
+    pos = oc_clamp(pos, 0, maxPos);
+
+    info->scrollRow = oc_min((u64)(pos / rowHeight), info->rowCount - 1);
+    info->scrollOffset = pos - info->scrollRow * rowHeight;
+    info->atEnd = (pos >= maxPos);
+
+    info->firstRow = info->scrollRow - oc_min(info->overscan, info->scrollRow);
+    info->endRow = oc_min((u64)ceil((pos + viewHeight) / rowHeight) + info->overscan, info->rowCount);
+
+    frame->needsScroll = (maxPos > 0);
+    frame->thumbRatio = viewHeight / contentHeight;
+    frame->scrollValue = (maxPos > 0) ? pos / maxPos : 0;
+    frame->maxScroll = maxPos;
+
+    return ((info->scrollRow - info->firstRow) * rowHeight + info->scrollOffset);
+}
+
+f32 oc_ui_list_layout_variable(oc_ui_list_info* info, oc_ui_list_frame* frame, f32 viewHeight, f32 delta)
+{
+    //NOTE: scroll position is kept relative to a row, so we only ever need the heights of the rows around the view.
+    //      The scroll limit is the position at which the last rows fill the view.
+    u64 maxRow = info->rowCount;
+    f32 maxOffset = 0;
+    f32 fill = 0;
+    while(maxRow > 0 && fill < viewHeight)
+    {
+        maxRow--;
+        fill += oc_ui_list_row_height(info, maxRow);
+    }
+    maxOffset = oc_max(fill - viewHeight, 0);
+
+    if(info->followLast && info->atEnd && delta >= 0)
+    {
+        info->scrollRow = maxRow;
+        info->scrollOffset = maxOffset;
+    }
+    else
+    {
+        info->scrollOffset += delta;
+        while(info->scrollOffset < 0 && info->scrollRow > 0)
+        {
+            info->scrollRow--;
+            info->scrollOffset += oc_ui_list_row_height(info, info->scrollRow);
+        }
+        info->scrollOffset = oc_max(info->scrollOffset, 0);
+
+        while(info->scrollRow < maxRow && info->scrollOffset >= oc_ui_list_row_height(info, info->scrollRow))
+        {
+            info->scrollOffset -= oc_ui_list_row_height(info, info->scrollRow);
+            info->scrollRow++;
+        }
+        if(info->scrollRow > maxRow
+           || (info->scrollRow == maxRow && info->scrollOffset > maxOffset))
+        {
+            info->scrollRow = maxRow;
+            info->scrollOffset = maxOffset;
+        }
+    }
+    info->atEnd = (info->scrollRow == maxRow && info->scrollOffset >= maxOffset);
+
+    //NOTE: rows above the view
+    info->firstRow = info->scrollRow - oc_min(info->overscan, info->scrollRow);
+    f32 startY = info->scrollOffset;
+    for(u64 row = info->firstRow; row < info->scrollRow; row++)
+    {
+        startY += oc_ui_list_row_height(info, row);
+    }
+
+    //NOTE: rows in view
+    u64 row = info->scrollRow;
+    f32 y = -info->scrollOffset;
+    while(row < info->rowCount && y < viewHeight)
+    {
+        y += oc_ui_list_row_height(info, row);
+        row++;
+    }
+    info->endRow = oc_min(row + info->overscan, info->rowCount);
+
+    //NOTE: the scrollbar works in row units, since we don't know the height of all rows
+    f64 pos = info->scrollRow + info->scrollOffset / oc_ui_list_row_height(info, info->scrollRow);
+    f64 maxPos = maxRow + maxOffset / oc_ui_list_row_height(info, maxRow);
+
+    frame->needsScroll = (maxPos > 0);
+    frame->thumbRatio = (f32)(row - info->scrollRow) / info->rowCount;
+    frame->scrollValue = (maxPos > 0) ? pos / maxPos : 0;
+    frame->maxScroll = maxPos;
+
+    return (startY);
+}
+
+oc_ui_box* oc_ui_list_begin_str8(oc_str8 key, oc_ui_list_info* info)
+{
+    oc_ui_box* list = oc_ui_box_begin_str8(key);
+    oc_ui_tag("list");
+
+    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+    oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PARENT, 1, 1 });
+    oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+    oc_ui_style_set_i32(OC_UI_OVERFLOW_X, OC_UI_OVERFLOW_CLIP);
+    oc_ui_style_set_i32(OC_UI_OVERFLOW_Y, OC_UI_OVERFLOW_CLIP);
+
+    oc_ui_sig sig = oc_ui_box_get_sig(list);
+    f32 delta = sig.hover ? sig.wheel.y : 0;
+
+    //NOTE: the view height is taken from the previous frame's layout. On the first frame we only build the
+    //      overscan rows.
+    f32 viewHeight = list->rect.h;
+
+    oc_ui_box* rows = oc_ui_box_begin("rows");
+    oc_ui_style_set_i32(OC_UI_POSITION, OC_UI_POSITION_PARENT);
+    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+    oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+    oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+
+    oc_ui_list_frame* frame = (oc_ui_list_frame*)oc_ui_box_user_data_push(rows, sizeof(oc_ui_list_frame));
+    *frame = (oc_ui_list_frame){
+        .info = info,
+        .list = list,
+    };
+
+    f32 startY = 0;
+    if(info->rowCount)
+    {
+        if(info->scrollRow >= info->rowCount)
+        {
+            info->scrollRow = info->rowCount - 1;
+            info->scrollOffset = 0;
+        }
+
+        if(info->variableHeight)
+        {
+            startY = oc_ui_list_layout_variable(info, frame, viewHeight, delta);
+        }
+        else
+        {
+            startY = oc_ui_list_layout_fixed(info, frame, viewHeight, delta);
+        }
+    }
+    else
+    {
+        info->scrollRow = 0;
+        info->scrollOffset = 0;
+        info->atEnd = true;
+        info->firstRow = 0;
+        info->endRow = 0;
+    }
+
+    oc_ui_style_set_f32(OC_UI_OFFSET_Y, -startY);
+
+    return (list);
+}
+
+oc_ui_box* oc_ui_list_begin(const char* key, oc_ui_list_info* info)
+{
+    return (oc_ui_list_begin_str8(OC_STR8(key), info));
+}
+
+oc_ui_box* oc_ui_list_end(void)
+{
+    oc_ui_box* rows = oc_ui_box_end();
+    oc_ui_list_frame* frame = (oc_ui_list_frame*)oc_ui_box_user_data_get(rows);
+    oc_ui_list_info* info = frame->info;
+    oc_ui_box* list = frame->list;
+
+    if(frame->needsScroll)
+    {
+        f32 scrollValue = frame->scrollValue;
+        oc_ui_scrollbar_str8(OC_STR8("scrollbar"),
+                             (oc_rect){ list->rect.w - 8, 0, 8, list->rect.h },
+                             frame->thumbRatio,
+                             &scrollValue,
+                             false);
+
+        if(scrollValue != frame->scrollValue)
+        {
+            //NOTE: thumb was dragged, the new position is applied on next frame
+            f64 pos = scrollValue * frame->maxScroll;
+            if(info->variableHeight)
+            {
+                info->scrollRow = oc_min((u64)pos, info->rowCount - 1);
+                info->scrollOffset = (pos - info->scrollRow) * oc_max(info->rowHeight, 1);
+            }
+            else
+            {
+                f64 rowHeight = oc_max(info->rowHeight, 1);
+                info->scrollRow = oc_min((u64)(pos / rowHeight), info->rowCount - 1);
+                info->scrollOffset = pos - info->scrollRow * rowHeight;
+            }
+            info->atEnd = (scrollValue >= 1);
+        }
+    }
+
+    return (oc_ui_box_end());
+}
+
+oc_ui_box* oc_ui_list_row_begin(u64 index)
+{
+    oc_ui_box* rows = oc_ui_box_top();
+    oc_ui_list_frame* frame = (oc_ui_list_frame*)oc_ui_box_user_data_get(rows);
+    OC_DEBUG_ASSERT(frame, "oc_ui_list_row_begin() must be called inside a list");
+
+    oc_scratch scratch = oc_scratch_begin();
+    oc_str8 key = oc_str8_pushf(scratch.allocator, "%llu", index);
+    oc_ui_box* row = oc_ui_box_begin_str8(key);
+    oc_scratch_end(scratch);
+
+    oc_ui_tag("row");
+    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+    if(frame->info->variableHeight)
+    {
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+    }
+    else
+    {
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PIXELS, frame->info->rowHeight });
+    }
+    if(frame->table)
+    {
+        oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_X);
+    }
+    return (row);
+}
+
+oc_ui_box* oc_ui_list_row_end(void)
+{
+    return (oc_ui_box_end());
+}
+
+//------------------------------------------------------------------------------
+// table
+//------------------------------------------------------------------------------
+
+oc_ui_box* oc_ui_table_begin_str8(oc_str8 key, oc_ui_table_info* info)
+{
+    oc_ui_box* table = oc_ui_box_begin_str8(key);
+    oc_ui_tag("table");
+
+    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+    oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PARENT, 1, 1 });
+    oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_Y);
+
+    oc_ui_box("header")
+    {
+        oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+        oc_ui_style_set_i32(OC_UI_AXIS, OC_UI_AXIS_X);
+        oc_ui_style_set_var_str8(OC_UI_BG_COLOR, OC_UI_THEME_BG_2);
+
+        oc_scratch scratch = oc_scratch_begin();
+        for(u32 i = 0; i < info->columnCount; i++)
+        {
+            oc_str8 columnKey = oc_str8_pushf(scratch.allocator, "%u", i);
+            oc_ui_box_str8(columnKey)
+            {
+                oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, info->columnWidths[i] });
+                oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+                oc_ui_style_set_var_str8(OC_UI_MARGIN_X, OC_UI_THEME_SPACING_TIGHT);
+                oc_ui_style_set_var_str8(OC_UI_MARGIN_Y, OC_UI_THEME_SPACING_EXTRA_TIGHT);
+                oc_ui_style_set_i32(OC_UI_OVERFLOW_X, OC_UI_OVERFLOW_CLIP);
+
+                if(info->columnTitles)
+                {
+                    oc_ui_label_str8(OC_STR8("title"), info->columnTitles[i]);
+                }
+            }
+        }
+        oc_scratch_end(scratch);
+    }
+
+    oc_ui_list_begin("list", &info->list);
+
+    oc_ui_list_frame* frame = (oc_ui_list_frame*)oc_ui_user_data_get();
+    frame->table = info;
+
+    return (table);
+}
+
+oc_ui_box* oc_ui_table_begin(const char* key, oc_ui_table_info* info)
+{
+    return (oc_ui_table_begin_str8(OC_STR8(key), info));
+}
+
+oc_ui_box* oc_ui_table_end(void)
+{
+    oc_ui_list_end();
+    return (oc_ui_box_end());
+}
+
+oc_ui_box* oc_ui_table_cell_begin(u32 column)
+{
+    oc_ui_box* row = oc_ui_box_top();
+    oc_ui_list_frame* frame = row->parent ? (oc_ui_list_frame*)oc_ui_box_user_data_get(row->parent) : 0;
+    OC_DEBUG_ASSERT(frame && frame->table, "oc_ui_table_cell_begin() must be called inside a table row");
+
+    oc_scratch scratch = oc_scratch_begin();
+    oc_str8 key = oc_str8_pushf(scratch.allocator, "%u", column);
+    oc_ui_box* cell = oc_ui_box_begin_str8(key);
+    oc_scratch_end(scratch);
+
+    f32 width = (column < frame->table->columnCount) ? frame->table->columnWidths[column] : 0;
+
+    oc_ui_tag("cell");
+    oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PIXELS, width });
+    if(frame->info->variableHeight)
+    {
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_CHILDREN });
+    }
+    else
+    {
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PARENT, 1 });
+    }
+    oc_ui_style_set_var_str8(OC_UI_MARGIN_X, OC_UI_THEME_SPACING_TIGHT);
+    oc_ui_style_set_i32(OC_UI_OVERFLOW_X, OC_UI_OVERFLOW_CLIP);
+
+    return (cell);
+}
+
+oc_ui_box* oc_ui_table_cell_end(void)
+{
+    return (oc_ui_box_end());
+}
+
+//------------------------------------------------------------------------------
+// text editor
+//------------------------------------------------------------------------------
+
+void oc_ui_text_editor_clear_layout(oc_ui_text_editor_info* info)
+{
+    for(u64 i = 0; i < info->lineCount; i++)
+    {
+        free(info->lines[i].glyphs);
+    }
+    info->lineCount = 0;
+}
+
+void oc_ui_text_editor_cleanup(oc_ui_text_editor_info* info)
+{
+    oc_ui_text_editor_clear_layout(info);
+    free(info->lines);
+    info->lines = 0;
+    info->lineCap = 0;
+}
+
+void oc_ui_text_editor_invalidate(oc_ui_text_editor_info* info, oc_text_edit edit)
+{
+    if(!edit.removed && !edit.inserted)
+    {
+        return;
+    }
+    //NOTE: drop the lines touched by the edit and renumber the lines that follow it
+    u64 lastLine = edit.firstLine + edit.removedLines;
+    u64 count = 0;
+    for(u64 i = 0; i < info->lineCount; i++)
+    {
+        oc_ui_text_editor_line* line = &info->lines[i];
+        if(line->line >= edit.firstLine && line->line <= lastLine)
+        {
+            free(line->glyphs);
+            continue;
+        }
+        if(line->line > lastLine)
+        {
+            line->line = line->line - edit.removedLines + edit.insertedLines;
+        }
+        info->lines[count] = *line;
+        count++;
+    }
+    info->lineCount = count;
+}
+
+u64 oc_ui_text_editor_layout_index(oc_ui_text_editor_info* info, u64 line)
+{
+    u64 lo = 0;
+    u64 hi = info->lineCount;
+    while(lo < hi)
+    {
+        u64 mid = lo + (hi - lo) / 2;
+        if(info->lines[mid].line < line)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return (lo);
+}
+
+//NOTE: the returned pointer is only valid until the next call, which may grow the cache
+oc_ui_text_editor_line* oc_ui_text_editor_get_line(oc_ui_text_editor_info* info, u64 line)
+{
+    u64 index = oc_ui_text_editor_layout_index(info, line);
+    if(index < info->lineCount && info->lines[index].line == line)
+    {
+        return (&info->lines[index]);
+    }
+
+    oc_scratch scratch = oc_scratch_begin();
+
+    u64 start = oc_text_buffer_line_start(info->buffer, line);
+    u64 end = oc_text_buffer_line_end(info->buffer, line);
+    if(end > start && oc_text_buffer_codepoint_at(info->buffer, end - 1) == '\r')
+    {
+        end--;
+    }
+    oc_str8 text = oc_text_buffer_push_str8(scratch.arena, info->buffer, start, end - start);
+    oc_shaped_text shaped = oc_font_shape_text(scratch.allocator, info->font, info->fontSize, text);
+
+    if(info->lineCount >= info->lineCap)
+    {
+        info->lineCap = oc_max(16, info->lineCap + info->lineCap / 2);
+        info->lines = realloc(info->lines, info->lineCap * sizeof(oc_ui_text_editor_line));
+    }
+    memmove(&info->lines[index + 1], &info->lines[index], (info->lineCount - index) * sizeof(oc_ui_text_editor_line));
+    info->lineCount++;
+
+    oc_ui_text_editor_line* result = &info->lines[index];
+    *result = (oc_ui_text_editor_line){
+        .line = line,
+        .width = shaped.metrics.advance.x,
+        .glyphCount = shaped.glyphCount,
+    };
+    if(shaped.glyphCount)
+    {
+        result->glyphs = oc_malloc_array(oc_shaped_glyph, shaped.glyphCount);
+        memcpy(result->glyphs, shaped.glyphs, shaped.glyphCount * sizeof(oc_shaped_glyph));
+    }
+
+    oc_scratch_end(scratch);
+    return (result);
+}
+
+void oc_ui_text_editor_prune_layout(oc_ui_text_editor_info* info, u64 firstLine, u64 endLine, u64 keepLine)
+{
+    u64 count = 0;
+    for(u64 i = 0; i < info->lineCount; i++)
+    {
+        oc_ui_text_editor_line* line = &info->lines[i];
+        if((line->line < firstLine || line->line >= endLine) && line->line != keepLine)
+        {
+            free(line->glyphs);
+        }
+        else
+        {
+            info->lines[count] = *line;
+            count++;
+        }
+    }
+    info->lineCount = count;
+}
+
+f32 oc_ui_text_editor_column_x(oc_ui_text_editor_line* line, u64 column)
+{
+    return (column < line->glyphCount ? line->glyphs[column].position.x : line->width);
+}
+
+u64 oc_ui_text_editor_column_at_x(oc_ui_text_editor_line* line, f32 x)
+{
+    //NOTE: first glyph whose center is past x
+    u64 lo = 0;
+    u64 hi = line->glyphCount;
+    while(lo < hi)
+    {
+        u64 mid = lo + (hi - lo) / 2;
+        oc_shaped_glyph* glyph = &line->glyphs[mid];
+        if(glyph->position.x + 0.5 * glyph->advance.x <= x)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return (lo);
+}
+
+u64 oc_ui_text_editor_find_word_start(oc_text_buffer* buffer, u64 offset)
+{
+    u64 length = oc_text_buffer_length(buffer);
+    u64 c = offset;
+    if(offset >= length)
+    {
+        return (c);
+    }
+    oc_utf32 start = oc_text_buffer_codepoint_at(buffer, offset);
+    if(oc_ui_edit_is_whitespace(start))
+    {
+        while(c > 0 && oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, c - 1)))
+        {
+            c--;
+        }
+    }
+    else if(!oc_ui_edit_is_word_separator(start))
+    {
+        while(c > 0
+              && !oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, c - 1))
+              && !oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, c - 1)))
+        {
+            c--;
+        }
+    }
+    return (c);
+}
+
+u64 oc_ui_text_editor_find_word_end(oc_text_buffer* buffer, u64 offset)
+{
+    u64 length = oc_text_buffer_length(buffer);
+    u64 c = oc_min(offset + 1, length);
+    if(offset >= length)
+    {
+        return (c);
+    }
+    oc_utf32 start = oc_text_buffer_codepoint_at(buffer, offset);
+    if(oc_ui_edit_is_whitespace(start))
+    {
+        while(c < length && oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, c)))
+        {
+            c++;
+        }
+    }
+    else if(!oc_ui_edit_is_word_separator(start))
+    {
+        while(c < length
+              && !oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, c))
+              && !oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, c)))
+        {
+            c++;
+        }
+    }
+    return (c);
+}
+
+void oc_ui_text_editor_perform_move(oc_ui_text_editor_info* info, oc_ui_edit_move move, int direction)
+{
+    oc_text_buffer* buffer = info->buffer;
+    u64 length = oc_text_buffer_length(buffer);
+
+    switch(move)
+    {
+        case OC_UI_EDIT_MOVE_NONE:
+            break;
+
+        case OC_UI_EDIT_MOVE_CHAR:
+        {
+            if(direction < 0 && info->cursor > 0)
+            {
+                info->cursor--;
+            }
+            else if(direction > 0 && info->cursor < length)
+            {
+                info->cursor++;
+            }
+        }
+        break;
+
+        case OC_UI_EDIT_MOVE_LINE:
+        {
+            u64 line = oc_text_buffer_line_of_offset(buffer, info->cursor);
+            if(direction < 0)
+            {
+                info->cursor = oc_text_buffer_line_start(buffer, line);
+            }
+            else if(direction > 0)
+            {
+                info->cursor = oc_text_buffer_line_end(buffer, line);
+            }
+        }
+        break;
+
+        case OC_UI_EDIT_MOVE_WORD:
+        {
+            //NOTE: same word break rules as oc_ui_edit_perform_move()
+            if(direction < 0)
+            {
+                while(info->cursor > 0 && oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, info->cursor - 1)))
+                {
+                    info->cursor--;
+                }
+
+                if(info->cursor > 0 && oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, info->cursor - 1)))
+                {
+                    info->cursor--;
+                    while(info->cursor > 0 && oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, info->cursor - 1)))
+                    {
+                        info->cursor--;
+                    }
+                }
+                else
+                {
+                    while(info->cursor > 0
+                          && !oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, info->cursor - 1))
+                          && !oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, info->cursor - 1)))
+                    {
+                        info->cursor--;
+                    }
+                }
+            }
+            else if(direction > 0)
+            {
+                if(info->cursor < length && oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, info->cursor)))
+                {
+                    info->cursor++;
+                    while(info->cursor < length && oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, info->cursor)))
+                    {
+                        info->cursor++;
+                    }
+                }
+                else
+                {
+                    while(info->cursor < length
+                          && !oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, info->cursor))
+                          && !oc_ui_edit_is_word_separator(oc_text_buffer_codepoint_at(buffer, info->cursor)))
+                    {
+                        info->cursor++;
+                    }
+                }
+
+                while(info->cursor < length && oc_ui_edit_is_whitespace(oc_text_buffer_codepoint_at(buffer, info->cursor)))
+                {
+                    info->cursor++;
+                }
+            }
+        }
+        break;
+    }
+}
+
+void oc_ui_text_editor_move_vertical(oc_ui_text_editor_info* info, i64 lineDelta)
+{
+    oc_text_buffer* buffer = info->buffer;
+    u64 line = oc_text_buffer_line_of_offset(buffer, info->cursor);
+    u64 lineCount = oc_text_buffer_line_count(buffer);
+
+    if(info->cursorX < 0)
+    {
+        u64 column = info->cursor - oc_text_buffer_line_start(buffer, line);
+        info->cursorX = oc_ui_text_editor_column_x(oc_ui_text_editor_get_line(info, line), column);
+    }
+
+    if(lineDelta < 0 && line == 0)
+    {
+        info->cursor = 0;
+    }
+    else if(lineDelta > 0 && line + 1 >= lineCount)
+    {
+        info->cursor = oc_text_buffer_length(buffer);
+    }
+    else
+    {
+        u64 target = (lineDelta < 0) ? line - oc_min((u64)-lineDelta, line)
+                                     : oc_min(line + lineDelta, lineCount - 1);
+        u64 column = oc_ui_text_editor_column_at_x(oc_ui_text_editor_get_line(info, target), info->cursorX);
+        info->cursor = oc_text_buffer_line_start(buffer, target) + column;
+    }
+}
+
+bool oc_ui_text_editor_replace_selection(oc_ui_text_editor_info* info, oc_str32 input)
+{
+    u64 start = oc_min(info->cursor, info->mark);
+    u64 end = oc_max(info->cursor, info->mark);
+    if(start == end && !input.len)
+    {
+        return (false);
+    }
+    oc_text_edit edit = oc_text_buffer_replace(info->buffer, start, end - start, input);
+    oc_ui_text_editor_invalidate(info, edit);
+
+    info->cursor = start + input.len;
+    info->mark = info->cursor;
+    return (true);
+}
+
+bool oc_ui_text_editor_perform_operation(oc_ui_text_editor_info* info, oc_ui_edit_op operation, oc_ui_edit_move move, int direction)
+{
+    bool changed = false;
+    oc_arena* frameArena = oc_ui_frame_arena();
+
+    switch(operation)
+    {
+        case OC_UI_EDIT_MOVE:
+        {
+            bool wasSelectionEmpty = info->cursor == info->mark;
+
+            //NOTE: we place the cursor on the direction-most side of the selection before performing the move
+            info->cursor = direction < 0 ? oc_min(info->cursor, info->mark) : oc_max(info->cursor, info->mark);
+
+            if(wasSelectionEmpty || move != OC_UI_EDIT_MOVE_CHAR)
+            {
+                oc_ui_text_editor_perform_move(info, move, direction);
+            }
+            info->mark = info->cursor;
+        }
+        break;
+
+        case OC_UI_EDIT_SELECT:
+        {
+            oc_ui_text_editor_perform_move(info, move, direction);
+        }
+        break;
+
+        case OC_UI_EDIT_SELECT_EXTEND:
+        {
+            if((direction > 0) != (info->cursor > info->mark))
+            {
+                u64 tmp = info->cursor;
+                info->cursor = info->mark;
+                info->mark = tmp;
+            }
+            oc_ui_text_editor_perform_move(info, move, direction);
+        }
+        break;
+
+        case OC_UI_EDIT_DELETE:
+        {
+            if(info->cursor == info->mark)
+            {
+                oc_ui_text_editor_perform_move(info, move, direction);
+            }
+            changed = oc_ui_text_editor_replace_selection(info, (oc_str32){ 0 });
+        }
+        break;
+
+        case OC_UI_EDIT_CUT:
+        case OC_UI_EDIT_COPY:
+        {
+            if(info->cursor != info->mark)
+            {
+                u64 start = oc_min(info->cursor, info->mark);
+                u64 end = oc_max(info->cursor, info->mark);
+                oc_str8 string = oc_text_buffer_push_str8(frameArena, info->buffer, start, end - start);
+                oc_clipboard_set_string(string);
+
+                if(operation == OC_UI_EDIT_CUT)
+                {
+                    changed = oc_ui_text_editor_replace_selection(info, (oc_str32){ 0 });
+                }
+            }
+        }
+        break;
+
+        case OC_UI_EDIT_PASTE:
+        {
+#if !OC_PLATFORM_ORCA
+            oc_str8 string = oc_clipboard_get_string(frameArena->allocator);
+            oc_str32 input = oc_utf8_push_to_codepoints(frameArena->allocator, string);
+            changed = oc_ui_text_editor_replace_selection(info, input);
+#endif
+        }
+        break;
+
+        case OC_UI_EDIT_SELECT_ALL:
+        {
+            info->cursor = oc_text_buffer_length(info->buffer);
+            info->mark = 0;
+        }
+        break;
+    }
+    info->cursorBlinkStart = oc_ui_frame_time();
+
+    return (changed);
+}
+
+typedef struct oc_ui_text_editor_render_line
+{
+    //NOTE: glyphs point into the editor's layout cache, which is only modified while building the next frame
+    u64 glyphCount;
+    oc_shaped_glyph* glyphs;
+    f32 selectStartX;
+    f32 selectEndX;
+} oc_ui_text_editor_render_line;
+
+typedef struct oc_ui_text_editor_render_data
+{
+    oc_font font;
+    f32 fontSize;
+    f32 lineHeight;
+
+    u64 lineCount;
+    oc_ui_text_editor_render_line* lines;
+    f32 firstLineY;
+    f32 scrollX;
+    oc_color selectionColor;
+
+    bool showCaret;
+    u64 caretLine; // relative to the first rendered line
+    f32 caretX;
+
+} oc_ui_text_editor_render_data;
+
+void oc_ui_text_editor_render(oc_ui_box* box, void* data)
+{
+    oc_ui_text_editor_render_data* renderData = (oc_ui_text_editor_render_data*)data;
+    oc_ui_style* style = &box->style;
+
+    oc_rect rect = {
+        box->rect.x + box->style.layout.margin.x,
+        box->rect.y + box->style.layout.margin.y,
+        box->rect.w - 2 * box->style.layout.margin.x,
+        box->rect.h - 2 * box->style.layout.margin.y,
+    };
+    oc_font_metrics extents = oc_font_get_metrics(renderData->font, renderData->fontSize);
+    f32 textX = rect.x - renderData->scrollX;
+
+    oc_clip_push(rect.x, rect.y, rect.w, rect.h);
+
+    oc_set_color(renderData->selectionColor);
+    for(u64 i = 0; i < renderData->lineCount; i++)
+    {
+        oc_ui_text_editor_render_line* line = &renderData->lines[i];
+        if(line->selectEndX > line->selectStartX)
+        {
+            f32 lineY = rect.y + renderData->firstLineY + i * renderData->lineHeight;
+            oc_rectangle_fill(textX + line->selectStartX, lineY, line->selectEndX - line->selectStartX, renderData->lineHeight);
+        }
+    }
+
+    oc_set_font(renderData->font);
+    oc_set_font_size(renderData->fontSize);
+    oc_set_color(style->color);
+
+    for(u64 i = 0; i < renderData->lineCount; i++)
+    {
+        oc_ui_text_editor_render_line* line = &renderData->lines[i];
+        if(line->glyphCount)
+        {
+            f32 lineY = rect.y + renderData->firstLineY + i * renderData->lineHeight;
+            oc_shaped_text shaped = {
+                .font = renderData->font,
+                .fontSize = renderData->fontSize,
+                .glyphCount = line->glyphCount,
+                .glyphs = line->glyphs,
+            };
+            oc_move_to(textX, lineY + extents.ascent);
+            oc_shaped_text_outlines(shaped);
+            oc_fill();
+        }
+    }
+
+    if(renderData->showCaret)
+    {
+        f32 caretY = rect.y + renderData->firstLineY + renderData->caretLine * renderData->lineHeight;
+        oc_rectangle_fill(textX + renderData->caretX, caretY, 1, renderData->lineHeight);
+    }
+
+    oc_clip_pop();
+}
+
+oc_ui_text_editor_result oc_ui_text_editor_str8(oc_str8 key, oc_ui_text_editor_info* info)
+{
+    oc_ui_text_editor_result result = { 0 };
+
+    oc_arena* frameArena = oc_ui_frame_arena();
+    oc_input_state* input = oc_ui_input();
+    oc_text_buffer* buffer = info->buffer;
+
+    oc_ui_box* box = oc_ui_box_str8(key)
+    {
+        result.box = box;
+
+        oc_ui_style_set_size(OC_UI_WIDTH, (oc_ui_size){ OC_UI_SIZE_PARENT, 1, 1 });
+        oc_ui_style_set_size(OC_UI_HEIGHT, (oc_ui_size){ OC_UI_SIZE_PARENT, 1, 1 });
+
+        oc_ui_style_set_f32(OC_UI_MARGIN_X, 12);
+        oc_ui_style_set_f32(OC_UI_MARGIN_Y, 6);
+        oc_ui_style_set_var_str8(OC_UI_BG_COLOR, OC_UI_THEME_FILL_0);
+        oc_ui_style_set_var_str8(OC_UI_ROUNDNESS, OC_UI_THEME_ROUNDNESS_SMALL);
+        oc_ui_style_set_f32(OC_UI_BORDER_SIZE, 1);
+
+        oc_ui_style_set_var_str8(OC_UI_COLOR, OC_UI_THEME_TEXT_0);
+        oc_ui_style_set_var_str8(OC_UI_TEXT_SIZE, OC_UI_THEME_TEXT_SIZE_REGULAR);
+        oc_ui_style_set_var_str8(OC_UI_FONT, OC_UI_THEME_FONT_REGULAR);
+
+        oc_ui_tag("text-editor");
+        oc_ui_style_rule(".text-editor.focus")
+        {
+            oc_ui_style_set_var_str8(OC_UI_BORDER_COLOR, OC_UI_THEME_PRIMARY);
+        }
+
+        oc_ui_sig sig = oc_ui_box_get_sig(box);
+
+        //NOTE: the style and rect come from the previous frame, as with the text box
+        oc_font font = box->style.font;
+        f32 fontSize = box->style.fontSize;
+        if(font.h != info->font.h || fontSize != info->fontSize)
+        {
+            oc_ui_text_editor_clear_layout(info);
+            info->font = font;
+            info->fontSize = fontSize;
+        }
+        oc_font_metrics extents = oc_font_get_metrics(font, fontSize);
+        f32 lineHeight = oc_max(extents.ascent + extents.descent + extents.lineGap, 1);
+
+        oc_rect textRect = {
+            box->rect.x + box->style.layout.margin.x,
+            box->rect.y + box->style.layout.margin.y,
+            box->rect.w - 2 * box->style.layout.margin.x,
+            box->rect.h - 2 * box->style.layout.margin.y,
+        };
+
+        u64 length = oc_text_buffer_length(buffer);
+        info->cursor = oc_min(info->cursor, length);
+        info->mark = oc_min(info->mark, length);
+
+        bool revealCursor = false;
+
+        if(sig.hover)
+        {
+            info->scrollX += sig.wheel.x;
+            info->scrollY += sig.wheel.y;
+        }
+
+        if(sig.pressed)
+        {
+            if(!sig.focus)
+            {
+                oc_ui_box_request_focus(box);
+            }
+            info->cursorBlinkStart = oc_ui_frame_time();
+            oc_text_buffer_undo_boundary(buffer);
+        }
+
+        if(sig.pressed || sig.active)
+        {
+            //NOTE: set cursor/extend selection on mouse press or drag
+            oc_vec2 pos = oc_mouse_position(input);
+            f64 y = pos.y - textRect.y + info->scrollY;
+            u64 line = (y <= 0) ? 0 : oc_min((u64)(y / lineHeight), oc_text_buffer_line_count(buffer) - 1);
+            u64 column = oc_ui_text_editor_column_at_x(oc_ui_text_editor_get_line(info, line), pos.x - textRect.x + info->scrollX);
+            u64 lineStart = oc_text_buffer_line_start(buffer, line);
+            u64 lineEnd = oc_text_buffer_line_end(buffer, line);
+            u64 newCursor = oc_min(lineStart + column, lineEnd);
+
+            //NOTE: the hovered char is the one left of the cursor if the mouse is past its center
+            u64 hoveredChar = newCursor;
+            if(newCursor > lineStart
+               && (newCursor == lineEnd
+                   || pos.x - textRect.x + info->scrollX < oc_ui_text_editor_column_x(oc_ui_text_editor_get_line(info, line), column)))
+            {
+                hoveredChar = newCursor - 1;
+            }
+
+            if(sig.doubleClicked)
+            {
+                info->cursor = oc_ui_text_editor_find_word_end(buffer, hoveredChar);
+                info->mark = oc_ui_text_editor_find_word_start(buffer, hoveredChar);
+                info->selectionMode = OC_UI_EDIT_MOVE_WORD;
+                info->wordSelectionInitialCursor = info->cursor;
+                info->wordSelectionInitialMark = info->mark;
+            }
+            else if(sig.tripleClicked)
+            {
+                info->cursor = oc_min(lineEnd + 1, length);
+                info->mark = lineStart;
+                info->selectionMode = OC_UI_EDIT_MOVE_LINE;
+                info->wordSelectionInitialCursor = info->cursor;
+                info->wordSelectionInitialMark = info->mark;
+            }
+            else if(sig.pressed && (oc_key_mods(input) & OC_KEYMOD_SHIFT))
+            {
+                info->cursor = newCursor;
+                info->selectionMode = OC_UI_EDIT_MOVE_CHAR;
+            }
+            else if(sig.pressed)
+            {
+                info->cursor = newCursor;
+                info->mark = newCursor;
+                info->selectionMode = OC_UI_EDIT_MOVE_CHAR;
+            }
+            else if(info->selectionMode == OC_UI_EDIT_MOVE_CHAR)
+            {
+                info->cursor = newCursor;
+            }
+            else
+            {
+                //NOTE: extend word or line selection from the initially selected range
+                u64 initialStart = info->wordSelectionInitialMark;
+                u64 initialEnd = info->wordSelectionInitialCursor;
+                bool word = (info->selectionMode == OC_UI_EDIT_MOVE_WORD);
+
+                if(newCursor >= initialStart)
+                {
+                    info->mark = initialStart;
+                    info->cursor = word ? oc_ui_text_editor_find_word_end(buffer, hoveredChar) : oc_min(lineEnd + 1, length);
+                    info->cursor = oc_max(info->cursor, initialEnd);
+                }
+                else
+                {
+                    info->mark = initialEnd;
+                    info->cursor = word ? oc_ui_text_editor_find_word_start(buffer, hoveredChar) : lineStart;
+                }
+            }
+            info->cursorX = -1;
+            revealCursor = sig.active;
+        }
+        else
+        {
+            info->selectionMode = OC_UI_EDIT_MOVE_CHAR;
+        }
+
+        if(!sig.hover && sig.focus)
+        {
+            if(oc_mouse_pressed(input, OC_MOUSE_LEFT) || oc_mouse_pressed(input, OC_MOUSE_RIGHT) || oc_mouse_pressed(input, OC_MOUSE_MIDDLE))
+            {
+                //NOTE loose focus
+                oc_ui_box_release_focus(box);
+            }
+        }
+
+        if(sig.focus)
+        {
+            u64 oldCursor = info->cursor;
+            u64 oldMark = info->mark;
+
+            //NOTE replace selection with input codepoints
+            oc_str32 inputCodepoints = oc_input_text_utf32(frameArena->allocator, input);
+            if(inputCodepoints.len)
+            {
+                result.changed |= oc_ui_text_editor_replace_selection(info, inputCodepoints);
+                info->cursorBlinkStart = oc_ui_frame_time();
+            }
+            if(oc_key_press_count(input, OC_KEY_ENTER) || oc_key_repeat_count(input, OC_KEY_ENTER))
+            {
+                oc_utf32 newline = '\n';
+                result.changed |= oc_ui_text_editor_replace_selection(info, (oc_str32){ .ptr = &newline, .len = 1 });
+                info->cursorBlinkStart = oc_ui_frame_time();
+            }
+
+            //NOTE handle vertical moves, undo/redo, then the shortcuts shared with the text box
+            oc_keymod_flags mods = oc_key_mods(input);
+            i64 pageLines = oc_max((i64)(textRect.h / lineHeight) - 1, 1);
+            struct
+            {
+                oc_key_code key;
+                i64 lines;
+            } verticalMoves[] = {
+                { OC_KEY_UP, -1 },
+                { OC_KEY_DOWN, 1 },
+                { OC_KEY_PAGE_UP, -pageLines },
+                { OC_KEY_PAGE_DOWN, pageLines },
+            };
+            bool handled = false;
+
+            if(!(mods & ~OC_KEYMOD_SHIFT))
+            {
+                for(int i = 0; i < oc_array_size(verticalMoves); i++)
+                {
+                    if(oc_key_press_count(input, verticalMoves[i].key) || oc_key_repeat_count(input, verticalMoves[i].key))
+                    {
+                        oc_ui_text_editor_move_vertical(info, verticalMoves[i].lines);
+                        if(!(mods & OC_KEYMOD_SHIFT))
+                        {
+                            info->mark = info->cursor;
+                        }
+                        info->cursorBlinkStart = oc_ui_frame_time();
+                        handled = true;
+                        break;
+                    }
+                }
+            }
+
+            if(!handled && (mods & OC_KEYMOD_MAIN_MODIFIER))
+            {
+                bool undo = oc_key_press_count(input, OC_KEY_Z) || oc_key_repeat_count(input, OC_KEY_Z);
+                bool redo = oc_key_press_count(input, OC_KEY_Y) || oc_key_repeat_count(input, OC_KEY_Y);
+                if(undo && (mods & OC_KEYMOD_SHIFT))
+                {
+                    undo = false;
+                    redo = true;
+                }
+                if(undo || redo)
+                {
+                    oc_text_edit edit = undo ? oc_text_buffer_undo(buffer) : oc_text_buffer_redo(buffer);
+                    if(edit.removed || edit.inserted)
+                    {
+                        oc_ui_text_editor_invalidate(info, edit);
+                        info->cursor = edit.offset + edit.inserted;
+                        info->mark = info->cursor;
+                        result.changed = true;
+                    }
+                    info->cursorBlinkStart = oc_ui_frame_time();
+                    handled = true;
+                }
+            }
+
+            if(!handled)
+            {
+                const oc_ui_edit_command* editCommands;
+                u32 editCommandCount;
+                oc_host_platform hostPlatform = oc_get_host_platform();
+                switch(hostPlatform)
+                {
+                    case OC_HOST_PLATFORM_MACOS:
+                        editCommands = OC_UI_EDIT_COMMANDS_MACOS;
+                        editCommandCount = OC_UI_EDIT_COMMAND_MACOS_COUNT;
+                        break;
+                    case OC_HOST_PLATFORM_WINDOWS:
+                    case OC_HOST_PLATFORM_LINUX:
+                        editCommands = OC_UI_EDIT_COMMANDS_WINDOWS;
+                        editCommandCount = OC_UI_EDIT_COMMAND_WINDOWS_COUNT;
+                        break;
+                    default:
+                        OC_ASSERT(0, "unknown host platform: %i", hostPlatform);
+                }
+
+                for(int i = 0; i < editCommandCount; i++)
+                {
+                    const oc_ui_edit_command* command = &(editCommands[i]);
+
+                    if((oc_key_press_count(input, command->key) || oc_key_repeat_count(input, command->key))
+                       && (mods & ~OC_KEYMOD_MAIN_MODIFIER) == command->mods)
+                    {
+                        result.changed |= oc_ui_text_editor_perform_operation(info, command->operation, command->move, command->direction);
+                        info->cursorX = -1;
+                        break;
+                    }
+                }
+            }
+
+            if(sig.pasted)
+            {
+                oc_str8 pastedText = oc_clipboard_pasted_text(input);
+                oc_str32 pasted = oc_utf8_push_to_codepoints(frameArena->allocator, pastedText);
+                result.changed |= oc_ui_text_editor_replace_selection(info, pasted);
+            }
+
+            if(result.changed)
+            {
+                info->cursorX = -1;
+            }
+            if(result.changed || info->cursor != oldCursor || info->mark != oldMark)
+            {
+                revealCursor = true;
+                if(!result.changed)
+                {
+                    //NOTE: don't group edits made at different places
+                    oc_text_buffer_undo_boundary(buffer);
+                }
+            }
+        }
+
+        //NOTE: scroll to keep the cursor in view, then clamp scrolling to the contents
+        u64 lineCount = oc_text_buffer_line_count(buffer);
+        u64 cursorLine = oc_text_buffer_line_of_offset(buffer, info->cursor);
+        u64 cursorColumn = info->cursor - oc_text_buffer_line_start(buffer, cursorLine);
+        f32 cursorX = oc_ui_text_editor_column_x(oc_ui_text_editor_get_line(info, cursorLine), cursorColumn);
+
+        if(revealCursor)
+        {
+            f64 cursorY = cursorLine * (f64)lineHeight;
+            if(cursorY < info->scrollY)
+            {
+                info->scrollY = cursorY;
+            }
+            else if(cursorY + lineHeight > info->scrollY + textRect.h)
+            {
+                info->scrollY = cursorY + lineHeight - textRect.h;
+            }
+            if(cursorX < info->scrollX)
+            {
+                info->scrollX = cursorX;
+            }
+            else if(cursorX + 1 > info->scrollX + textRect.w)
+            {
+                info->scrollX = cursorX + 1 - textRect.w;
+            }
+        }
+
+        f64 contentHeight = lineCount * (f64)lineHeight;
+        f64 maxScrollY = oc_max(contentHeight - textRect.h, 0);
+        info->scrollY = oc_clamp(info->scrollY, 0, maxScrollY);
+
+        //NOTE: shape the lines in view. Lines that were already shaped are reused from the cache.
+        u64 firstLine = oc_min((u64)(info->scrollY / lineHeight), lineCount - 1);
+        u64 endLine = oc_min((u64)ceil((info->scrollY + textRect.h) / lineHeight), lineCount);
+        endLine = oc_max(endLine, firstLine + 1);
+
+        f32 maxWidth = 0;
+        for(u64 line = firstLine; line < endLine; line++)
+        {
+            maxWidth = oc_max(maxWidth, oc_ui_text_editor_get_line(info, line)->width);
+        }
+        info->scrollX = oc_clamp(info->scrollX, 0, oc_max(maxWidth + 1 - textRect.w, oc_max(cursorX + 1 - textRect.w, 0)));
+
+        //NOTE: drop cached lines that went out of view, keeping the cursor line for vertical moves
+        oc_ui_text_editor_prune_layout(info, firstLine, endLine, cursorLine);
+
+        //NOTE: set renderer
+        u64 selectStart = oc_min(info->cursor, info->mark);
+        u64 selectEnd = oc_max(info->cursor, info->mark);
+        u64 selectStartLine = oc_text_buffer_line_of_offset(buffer, selectStart);
+        u64 selectEndLine = oc_text_buffer_line_of_offset(buffer, selectEnd);
+
+        oc_ui_text_editor_render_data* renderData = oc_arena_push_type(frameArena, oc_ui_text_editor_render_data);
+        *renderData = (oc_ui_text_editor_render_data){
+            .font = font,
+            .fontSize = fontSize,
+            .lineHeight = lineHeight,
+            .lineCount = endLine - firstLine,
+            .lines = oc_arena_push_array(frameArena, oc_ui_text_editor_render_line, endLine - firstLine),
+            .firstLineY = firstLine * (f64)lineHeight - info->scrollY,
+            .scrollX = info->scrollX,
+            .selectionColor = oc_ui_var_get_color_str8(OC_UI_THEME_PRIMARY_DISABLED),
+            .showCaret = sig.focus
+                      && selectStart == selectEnd
+                      && !((u64)(2 * (oc_ui_frame_time() - info->cursorBlinkStart)) & 1)
+                      && cursorLine >= firstLine
+                      && cursorLine < endLine,
+            .caretLine = cursorLine - firstLine,
+            .caretX = cursorX,
+        };
+
+        for(u64 line = firstLine; line < endLine; line++)
+        {
+            oc_ui_text_editor_line* layout = oc_ui_text_editor_get_line(info, line);
+            oc_ui_text_editor_render_line* renderLine = &renderData->lines[line - firstLine];
+            renderLine->glyphCount = layout->glyphCount;
+            renderLine->glyphs = layout->glyphs;
+
+            if(sig.focus && selectStart != selectEnd && line >= selectStartLine && line <= selectEndLine)
+            {
+                u64 lineStart = oc_text_buffer_line_start(buffer, line);
+                renderLine->selectStartX = (line == selectStartLine)
+                                             ? oc_ui_text_editor_column_x(layout, selectStart - lineStart)
+                                             : 0;
+                //NOTE: selected line breaks are shown as a quarter em
+                renderLine->selectEndX = (line == selectEndLine)
+                                           ? oc_ui_text_editor_column_x(layout, selectEnd - lineStart)
+                                           : layout->width + 0.25 * fontSize;
+            }
+        }
+
+        oc_ui_set_draw_proc(oc_ui_text_editor_render, renderData);
+
+        //NOTE: vertical scrollbar
+        if(maxScrollY > 0)
+        {
+            f32 scrollValue = info->scrollY / maxScrollY;
+            f32 oldScrollValue = scrollValue;
+            oc_ui_scrollbar_str8(OC_STR8("scrollbar"),
+                                 (oc_rect){ box->rect.w - 8, 0, 8, box->rect.h },
+                                 textRect.h / contentHeight,
+                                 &scrollValue,
+                                 false);
+            if(scrollValue != oldScrollValue)
+            {
+                //NOTE: thumb was dragged, the new position is applied on next frame
+                info->scrollY = scrollValue * maxScrollY;
+            }
+        }
+    }
+
+    return (result);
+}
+
+oc_ui_text_editor_result oc_ui_text_editor(const char* key, oc_ui_text_editor_info* info)
+{
+    return (oc_ui_text_editor_str8(OC_STR8(key), info));
+}
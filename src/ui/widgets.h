@@ -37,6 +37,12 @@ ORCA_API oc_ui_sig oc_ui_checkbox_str8(oc_str8 key, bool* checked);
 ORCA_API oc_ui_box* oc_ui_slider(const char* name, f32* value);
 ORCA_API oc_ui_box* oc_ui_slider_str8(oc_str8 name, f32* value);
 
+//------------------------------------------------------------------------
+// Scrollbar
+//------------------------------------------------------------------------
+ORCA_API oc_ui_box* oc_ui_scrollbar(const char* name, oc_rect rect, f32 thumbRatio, f32* scrollValue, bool horizontal);
+ORCA_API oc_ui_box* oc_ui_scrollbar_str8(oc_str8 name, oc_rect rect, f32 thumbRatio, f32* scrollValue, bool horizontal);
+
 //------------------------------------------------------------------------
 // Tooltip
 //------------------------------------------------------------------------
@@ -127,6 +133,115 @@ typedef struct oc_ui_radio_group_info
 ORCA_API oc_ui_radio_group_info oc_ui_radio_group(const char* key, oc_ui_radio_group_info* info);
 ORCA_API oc_ui_radio_group_info oc_ui_radio_group_str8(oc_str8 key, oc_ui_radio_group_info* info);
 
+//------------------------------------------------------------------------
+// List
+//------------------------------------------------------------------------
+//NOTE: virtualized list. Only the rows in view (plus overscan rows above and below) are built each frame.
+//      oc_ui_list_begin() sets info->firstRow and info->endRow to the range of rows the caller must build,
+//      using oc_ui_list_row_begin()/oc_ui_list_row_end().
+//
+//      If variableHeight is set, rows are sized by their contents. Heights are taken from the previous
+//      layout of each row, and rowHeight is used as an estimate for rows that haven't been laid out yet.
+typedef struct oc_ui_list_info
+{
+    u64 rowCount;
+    f32 rowHeight;
+    bool variableHeight;
+    u32 overscan;
+    bool followLast; // keep the last row in view when rows are added while scrolled to the end
+
+    // scroll position, as a row index and a pixel offset into that row
+    u64 scrollRow;
+    f32 scrollOffset;
+    bool atEnd;
+
+    // range of rows to build this frame
+    u64 firstRow;
+    u64 endRow;
+} oc_ui_list_info;
+
+ORCA_API oc_ui_box* oc_ui_list_begin(const char* key, oc_ui_list_info* info);
+ORCA_API oc_ui_box* oc_ui_list_begin_str8(oc_str8 key, oc_ui_list_info* info);
+ORCA_API oc_ui_box* oc_ui_list_end(void);
+#define oc_ui_list(key, info) oc_defer_loop(oc_ui_list_begin(key, info), oc_ui_list_end())
+
+ORCA_API oc_ui_box* oc_ui_list_row_begin(u64 index);
+ORCA_API oc_ui_box* oc_ui_list_row_end(void);
+#define oc_ui_list_row(index) oc_defer_loop(oc_ui_list_row_begin(index), oc_ui_list_row_end())
+
+//------------------------------------------------------------------------
+// Table
+//------------------------------------------------------------------------
+//NOTE: a list with a header row and fixed-width columns. Rows are built with oc_ui_list_row_begin()/end(),
+//      and each cell with oc_ui_table_cell_begin()/end().
+typedef struct oc_ui_table_info
+{
+    oc_ui_list_info list;
+    u32 columnCount;
+    oc_str8* columnTitles;
+    f32* columnWidths;
+} oc_ui_table_info;
+
+ORCA_API oc_ui_box* oc_ui_table_begin(const char* key, oc_ui_table_info* info);
+ORCA_API oc_ui_box* oc_ui_table_begin_str8(oc_str8 key, oc_ui_table_info* info);
+ORCA_API oc_ui_box* oc_ui_table_end(void);
+#define oc_ui_table(key, info) oc_defer_loop(oc_ui_table_begin(key, info), oc_ui_table_end())
+
+ORCA_API oc_ui_box* oc_ui_table_cell_begin(u32 column);
+ORCA_API oc_ui_box* oc_ui_table_cell_end(void);
+#define oc_ui_table_cell(column) oc_defer_loop(oc_ui_table_cell_begin(column), oc_ui_table_cell_end())
+
+//------------------------------------------------------------------------
+// Text Editor
+//------------------------------------------------------------------------
+
+//NOTE: multi-line editor over an oc_text_buffer. Only the lines in view are shaped and drawn. Shaped lines
+//      are kept in a cache that is invalidated per edit, so that typing only re-measures the edited lines.
+//      Edits made to the buffer outside of the editor must be reported with oc_ui_text_editor_invalidate().
+typedef struct oc_ui_text_editor_line
+{
+    u64 line;
+    f32 width;
+    u64 glyphCount;
+    oc_shaped_glyph* glyphs;
+} oc_ui_text_editor_line;
+
+typedef struct oc_ui_text_editor_info
+{
+    oc_text_buffer* buffer;
+
+    u64 cursor;
+    u64 mark;
+    f32 cursorX; // preferred x position for vertical moves, or -1
+
+    oc_ui_edit_move selectionMode;
+    u64 wordSelectionInitialCursor;
+    u64 wordSelectionInitialMark;
+    f64 cursorBlinkStart;
+
+    f32 scrollX;
+    f64 scrollY;
+
+    //NOTE: layout cache, sorted by line
+    oc_font font;
+    f32 fontSize;
+    u64 lineCount;
+    u64 lineCap;
+    oc_ui_text_editor_line* lines;
+
+} oc_ui_text_editor_info;
+
+typedef struct oc_ui_text_editor_result
+{
+    bool changed;
+    oc_ui_box* box;
+} oc_ui_text_editor_result;
+
+ORCA_API oc_ui_text_editor_result oc_ui_text_editor(const char* key, oc_ui_text_editor_info* info);
+ORCA_API oc_ui_text_editor_result oc_ui_text_editor_str8(oc_str8 key, oc_ui_text_editor_info* info);
+ORCA_API void oc_ui_text_editor_invalidate(oc_ui_text_editor_info* info, oc_text_edit edit);
+ORCA_API void oc_ui_text_editor_cleanup(oc_ui_text_editor_info* info);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -8,77 +8,129 @@
 #include "hash.h"
 #include "platform/platform.h"
 
-//xxhash64, copy-pasted from https://github.com/demetri/scribbles/blob/master/hashing/ub_aware_hash_functions.c
+#if OC_ARCH_X64
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define OC_XXH3_AVX2 1
+    #else
+        #include <emmintrin.h>
+        #define OC_XXH3_SSE2 1
+    #endif
+#endif
+
+#if OC_COMPILER_CL
+    #include <intrin.h>
+#endif
+
+//------------------------------------------------------------------------
+// xxHash64
+//------------------------------------------------------------------------
+//NOTE: adapted from https://github.com/demetri/scribbles/blob/master/hashing/ub_aware_hash_functions.c
 // Thanks to Demetri Spanos
 
-uint64_t xxh_64(const void* key, int len, uint64_t h)
+static inline u64 oc_hash_rotl64(u64 x, u32 r)
 {
-    // primes used in mul-rot updates
-    uint64_t p1 = 0x9e3779b185ebca87, p2 = 0xc2b2ae3d27d4eb4f,
-             p3 = 0x165667b19e3779f9, p4 = 0x85ebca77c2b2ae63, p5 = 0x27d4eb2f165667c5;
+    return ((x << r) | (x >> (64 - r)));
+}
 
-    // inital 32-byte (4x8) wide hash state
-    uint64_t s[4] = { h + p1 + p2, h + p2, h, h - p1 };
+static inline u64 oc_hash_read64(const u8* p)
+{
+    u64 x;
+    memcpy(&x, p, sizeof(u64));
+    return (x);
+}
 
-    // bulk work: process all 32 byte blocks
-    for(int i = 0; i < (len / 32); i++)
-    {
-        uint64_t b[4];
-        memcpy(b, (const char*)key + 4 * i, sizeof(b));
+static inline u32 oc_hash_read32(const u8* p)
+{
+    u32 x;
+    memcpy(&x, p, sizeof(u32));
+    return (x);
+}
 
-        for(int j = 0; j < 4; j++)
-            b[j] = b[j] * p2 + s[j];
-        for(int j = 0; j < 4; j++)
-            s[j] = ((b[j] << 31) | (b[j] >> 33)) * p1;
-    }
+static const u64 OC_XXH_PRIME64_1 = 0x9e3779b185ebca87ULL;
+static const u64 OC_XXH_PRIME64_2 = 0xc2b2ae3d27d4eb4fULL;
+static const u64 OC_XXH_PRIME64_3 = 0x165667b19e3779f9ULL;
+static const u64 OC_XXH_PRIME64_4 = 0x85ebca77c2b2ae63ULL;
+static const u64 OC_XXH_PRIME64_5 = 0x27d4eb2f165667c5ULL;
+
+static const u32 OC_XXH_PRIME32_1 = 0x9e3779b1U;
+static const u32 OC_XXH_PRIME32_2 = 0x85ebca77U;
+static const u32 OC_XXH_PRIME32_3 = 0xc2b2ae3dU;
+
+static inline u64 xxh_64_round(u64 acc, u64 input)
+{
+    acc += input * OC_XXH_PRIME64_2;
+    return (oc_hash_rotl64(acc, 31) * OC_XXH_PRIME64_1);
+}
+
+static inline u64 xxh_64_avalanche(u64 h)
+{
+    h = (h ^ (h >> 33)) * OC_XXH_PRIME64_2;
+    h = (h ^ (h >> 29)) * OC_XXH_PRIME64_3;
+    return (h ^ (h >> 32));
+}
+
+u64 xxh_64(const void* key, u64 len, u64 seed)
+{
+    const u8* p = (const u8*)key;
+    const u8* end = p + len;
+    u64 h = 0;
 
-    // mix 32-byte state down to 8-byte state, initalize to value for short keys
-    uint64_t s64 = (s[2] + p5);
     if(len >= 32)
     {
-        s64 = ((s[0] << 1) | (s[0] >> 63)) + ((s[1] << 7) | (s[1] >> 57)) + ((s[2] << 12) | (s[2] >> 52)) + ((s[3] << 18) | (s[3] >> 46));
+        // inital 32-byte (4x8) wide hash state
+        u64 s[4] = {
+            seed + OC_XXH_PRIME64_1 + OC_XXH_PRIME64_2,
+            seed + OC_XXH_PRIME64_2,
+            seed,
+            seed - OC_XXH_PRIME64_1,
+        };
+
+        // bulk work: process all 32 byte stripes
+        for(; end - p >= 32; p += 32)
+        {
+            s[0] = xxh_64_round(s[0], oc_hash_read64(p));
+            s[1] = xxh_64_round(s[1], oc_hash_read64(p + 8));
+            s[2] = xxh_64_round(s[2], oc_hash_read64(p + 16));
+            s[3] = xxh_64_round(s[3], oc_hash_read64(p + 24));
+        }
+
+        // mix 32-byte state down to 8-byte state
+        h = oc_hash_rotl64(s[0], 1) + oc_hash_rotl64(s[1], 7) + oc_hash_rotl64(s[2], 12) + oc_hash_rotl64(s[3], 18);
         for(int i = 0; i < 4; i++)
         {
-            uint64_t ps = (((s[i] * p2) << 31) | ((s[i] * p2) >> 33)) * p1;
-            s64 = (s64 ^ ps) * p1 + p4;
+            h = (h ^ xxh_64_round(0, s[i])) * OC_XXH_PRIME64_1 + OC_XXH_PRIME64_4;
         }
     }
-    s64 += len;
+    else
+    {
+        h = seed + OC_XXH_PRIME64_5;
+    }
+    h += len;
 
     // up to 31 bytes remain, process 0-3 8 byte blocks
-    uint8_t* tail = (uint8_t*)((const char*)key + (len / 32) * 32);
-    for(int i = 0; i < (len & 31) / 8; i++, tail += 8)
+    for(; end - p >= 8; p += 8)
     {
-        uint64_t b;
-        memcpy(&b, tail, sizeof(uint64_t));
-
-        b *= p2;
-        b = (((b << 31) | (b >> 33)) * p1) ^ s64;
-        s64 = ((b << 27) | (b >> 37)) * p1 + p4;
+        h ^= xxh_64_round(0, oc_hash_read64(p));
+        h = oc_hash_rotl64(h, 27) * OC_XXH_PRIME64_1 + OC_XXH_PRIME64_4;
     }
 
     // up to 7 bytes remain, process 0-1 4 byte block
-    for(int i = 0; i < (len & 7) / 4; i++, tail += 4)
+    if(end - p >= 4)
     {
-        uint32_t b32;
-        memcpy(&b32, tail, sizeof(b32));
-        uint64_t b = b32;
-
-        b = (s64 ^ b) * p1;
-        s64 = ((b << 23) | (b >> 41)) * p2 + p3;
+        h ^= (u64)oc_hash_read32(p) * OC_XXH_PRIME64_1;
+        h = oc_hash_rotl64(h, 23) * OC_XXH_PRIME64_2 + OC_XXH_PRIME64_3;
+        p += 4;
     }
 
     // up to 3 bytes remain, process 0-3 1 byte blocks
-    for(int i = 0; i < (len & 3); i++, tail++)
+    for(; p < end; p++)
     {
-        uint64_t b = s64 ^ (*tail) * p5;
-        s64 = ((b << 11) | (b >> 53)) * p1;
+        h ^= (*p) * OC_XXH_PRIME64_5;
+        h = oc_hash_rotl64(h, 11) * OC_XXH_PRIME64_1;
     }
 
-    // finalization mix
-    s64 = (s64 ^ (s64 >> 33)) * p2;
-    s64 = (s64 ^ (s64 >> 29)) * p3;
-    return (s64 ^ (s64 >> 32));
+    return (xxh_64_avalanche(h));
 }
 
 u64 oc_hash_xx64_string_seed(oc_str8 string, u64 seed)
@@ -91,6 +143,487 @@ u64 oc_hash_xx64_string(oc_str8 string)
     return (xxh_64(string.ptr, string.len, 0));
 }
 
+//------------------------------------------------------------------------
+// XXH3
+//------------------------------------------------------------------------
+/*NOTE:
+    This is the 64-bit variant of XXH3, from https://github.com/Cyan4973/xxHash, and gives the same results.
+
+    Inputs up to 240 bytes are mixed with a few 64x64->128 bit multiplies against a 192-byte "secret". Longer inputs
+    are processed in 64-byte stripes accumulated into 8 lanes, with a scramble of the lanes after each block of 16
+    stripes. The accumulation loop is vectorized with AVX2 when the target CPU has it, or with SSE2 on other x64
+    CPUs. Other targets use a scalar loop, which compilers vectorize reasonably well.
+
+    A non-zero seed is folded into the secret, so long inputs hashed with a seed first pay for deriving a secret.
+*/
+
+enum
+{
+    OC_XXH3_STRIPE_LEN = 64,
+    OC_XXH3_SECRET_CONSUME_RATE = 8,
+    OC_XXH3_ACC_COUNT = 8,
+    OC_XXH3_MIDSIZE_MAX = 240,
+    OC_XXH3_SECRET_SIZE_MIN = 136,
+    OC_XXH3_MIDSIZE_START_OFFSET = 3,
+    OC_XXH3_MIDSIZE_LAST_OFFSET = 17,
+    OC_XXH3_SECRET_LASTACC_START = 7,
+    OC_XXH3_SECRET_MERGEACCS_START = 11,
+    OC_XXH3_SECRET_LIMIT = OC_HASH_XXH3_SECRET_SIZE - OC_XXH3_STRIPE_LEN,
+    OC_XXH3_BLOCK_STRIPES = OC_XXH3_SECRET_LIMIT / OC_XXH3_SECRET_CONSUME_RATE,
+    OC_XXH3_BUFFER_STRIPES = OC_HASH_XXH3_BUFFER_SIZE / OC_XXH3_STRIPE_LEN,
+};
+
+static const u64 OC_XXH3_PRIME_MX1 = 0x165667919e3779f9ULL;
+static const u64 OC_XXH3_PRIME_MX2 = 0x9fb21c651e98df25ULL;
+
+static const u8 OC_XXH3_DEFAULT_SECRET[OC_HASH_XXH3_SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static inline u32 oc_hash_swap32(u32 x)
+{
+    return ((x << 24) | ((x << 8) & 0x00ff0000) | ((x >> 8) & 0x0000ff00) | (x >> 24));
+}
+
+static inline u64 oc_hash_swap64(u64 x)
+{
+    return (((u64)oc_hash_swap32((u32)x) << 32) | oc_hash_swap32((u32)(x >> 32)));
+}
+
+//NOTE: multiplies two u64 into a 128-bit product, and xors its two halves
+static inline u64 oc_xxh3_mul128_fold64(u64 a, u64 b)
+{
+#if defined(__SIZEOF_INT128__) && (OC_ARCH_X64 || OC_ARCH_ARM64)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    return ((u64)product ^ (u64)(product >> 64));
+#elif OC_COMPILER_CL && OC_ARCH_X64
+    u64 hi = 0;
+    u64 lo = _umul128(a, b, &hi);
+    return (lo ^ hi);
+#else
+    u64 loLo = (a & 0xffffffff) * (b & 0xffffffff);
+    u64 hiLo = (a >> 32) * (b & 0xffffffff);
+    u64 loHi = (a & 0xffffffff) * (b >> 32);
+    u64 hiHi = (a >> 32) * (b >> 32);
+
+    u64 cross = (loLo >> 32) + (hiLo & 0xffffffff) + loHi;
+    u64 hi = (hiLo >> 32) + (cross >> 32) + hiHi;
+    u64 lo = (cross << 32) | (loLo & 0xffffffff);
+    return (lo ^ hi);
+#endif
+}
+
+static inline u64 oc_xxh3_avalanche(u64 h)
+{
+    h ^= h >> 37;
+    h *= OC_XXH3_PRIME_MX1;
+    return (h ^ (h >> 32));
+}
+
+static inline u64 oc_xxh3_rrmxmx(u64 h, u64 len)
+{
+    h ^= oc_hash_rotl64(h, 49) ^ oc_hash_rotl64(h, 24);
+    h *= OC_XXH3_PRIME_MX2;
+    h ^= (h >> 35) + len;
+    h *= OC_XXH3_PRIME_MX2;
+    return (h ^ (h >> 28));
+}
+
+static inline u64 oc_xxh3_mix16(const u8* input, const u8* secret, u64 seed)
+{
+    return (oc_xxh3_mul128_fold64(oc_hash_read64(input) ^ (oc_hash_read64(secret) + seed),
+                                  oc_hash_read64(input + 8) ^ (oc_hash_read64(secret + 8) - seed)));
+}
+
+static u64 oc_xxh3_len_0_to_16(const u8* input, u64 len, const u8* secret, u64 seed)
+{
+    if(len > 8)
+    {
+        u64 bitflip1 = (oc_hash_read64(secret + 24) ^ oc_hash_read64(secret + 32)) + seed;
+        u64 bitflip2 = (oc_hash_read64(secret + 40) ^ oc_hash_read64(secret + 48)) - seed;
+        u64 lo = oc_hash_read64(input) ^ bitflip1;
+        u64 hi = oc_hash_read64(input + len - 8) ^ bitflip2;
+        u64 acc = len + oc_hash_swap64(lo) + hi + oc_xxh3_mul128_fold64(lo, hi);
+        return (oc_xxh3_avalanche(acc));
+    }
+    else if(len >= 4)
+    {
+        seed ^= (u64)oc_hash_swap32((u32)seed) << 32;
+        u64 bitflip = (oc_hash_read64(secret + 8) ^ oc_hash_read64(secret + 16)) - seed;
+        u64 input64 = oc_hash_read32(input + len - 4) + ((u64)oc_hash_read32(input) << 32);
+        return (oc_xxh3_rrmxmx(input64 ^ bitflip, len));
+    }
+    else if(len)
+    {
+        u32 combined = ((u32)input[0] << 16) | ((u32)input[len >> 1] << 24) | ((u32)input[len - 1]) | ((u32)len << 8);
+        u64 bitflip = (oc_hash_read32(secret) ^ oc_hash_read32(secret + 4)) + seed;
+        return (xxh_64_avalanche((u64)combined ^ bitflip));
+    }
+    else
+    {
+        return (xxh_64_avalanche(seed ^ (oc_hash_read64(secret + 56) ^ oc_hash_read64(secret + 64))));
+    }
+}
+
+static u64 oc_xxh3_len_17_to_128(const u8* input, u64 len, const u8* secret, u64 seed)
+{
+    u64 acc = len * OC_XXH_PRIME64_1;
+    if(len > 32)
+    {
+        if(len > 64)
+        {
+            if(len > 96)
+            {
+                acc += oc_xxh3_mix16(input + 48, secret + 96, seed);
+                acc += oc_xxh3_mix16(input + len - 64, secret + 112, seed);
+            }
+            acc += oc_xxh3_mix16(input + 32, secret + 64, seed);
+            acc += oc_xxh3_mix16(input + len - 48, secret + 80, seed);
+        }
+        acc += oc_xxh3_mix16(input + 16, secret + 32, seed);
+        acc += oc_xxh3_mix16(input + len - 32, secret + 48, seed);
+    }
+    acc += oc_xxh3_mix16(input, secret, seed);
+    acc += oc_xxh3_mix16(input + len - 16, secret + 16, seed);
+    return (oc_xxh3_avalanche(acc));
+}
+
+static u64 oc_xxh3_len_129_to_240(const u8* input, u64 len, const u8* secret, u64 seed)
+{
+    u64 acc = len * OC_XXH_PRIME64_1;
+    u64 roundCount = len / 16;
+
+    for(u64 i = 0; i < 8; i++)
+    {
+        acc += oc_xxh3_mix16(input + 16 * i, secret + 16 * i, seed);
+    }
+    acc = oc_xxh3_avalanche(acc);
+
+    u64 accEnd = oc_xxh3_mix16(input + len - 16, secret + OC_XXH3_SECRET_SIZE_MIN - OC_XXH3_MIDSIZE_LAST_OFFSET, seed);
+    for(u64 i = 8; i < roundCount; i++)
+    {
+        accEnd += oc_xxh3_mix16(input + 16 * i, secret + 16 * (i - 8) + OC_XXH3_MIDSIZE_START_OFFSET, seed);
+    }
+    return (oc_xxh3_avalanche(acc + accEnd));
+}
+
+#if OC_XXH3_SSE2
+//NOTE: multiply the low and high 32 bits of each lane, and add the input with adjacent lanes swapped
+static inline __m128i oc_xxh3_accumulate_sse2(__m128i acc, const u8* input, const u8* secret)
+{
+    __m128i data = _mm_loadu_si128((const __m128i*)input);
+    __m128i dataKey = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*)secret));
+    __m128i product = _mm_mul_epu32(dataKey, _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)));
+    return (_mm_add_epi64(acc, _mm_add_epi64(product, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)))));
+}
+#endif
+
+//NOTE: accumulates stripeCount consecutive stripes, using the secret at an 8-byte offset for each stripe
+static void oc_xxh3_accumulate(u64* acc, const u8* input, const u8* secret, u64 stripeCount)
+{
+#if OC_XXH3_AVX2
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+
+    for(u64 n = 0; n < stripeCount; n++)
+    {
+        const u8* in = input + n * OC_XXH3_STRIPE_LEN;
+        const u8* key = secret + n * OC_XXH3_SECRET_CONSUME_RATE;
+
+        __m256i data0 = _mm256_loadu_si256((const __m256i*)in);
+        __m256i data1 = _mm256_loadu_si256((const __m256i*)(in + 32));
+        __m256i dataKey0 = _mm256_xor_si256(data0, _mm256_loadu_si256((const __m256i*)key));
+        __m256i dataKey1 = _mm256_xor_si256(data1, _mm256_loadu_si256((const __m256i*)(key + 32)));
+
+        //NOTE: multiply the low and high 32 bits of each lane, and add the input with adjacent lanes swapped
+        __m256i product0 = _mm256_mul_epu32(dataKey0, _mm256_shuffle_epi32(dataKey0, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m256i product1 = _mm256_mul_epu32(dataKey1, _mm256_shuffle_epi32(dataKey1, _MM_SHUFFLE(0, 3, 0, 1)));
+        a0 = _mm256_add_epi64(a0, _mm256_add_epi64(product0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2))));
+        a1 = _mm256_add_epi64(a1, _mm256_add_epi64(product1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+#elif OC_XXH3_SSE2
+    __m128i a0 = _mm_loadu_si128((const __m128i*)acc);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(acc + 2));
+    __m128i a2 = _mm_loadu_si128((const __m128i*)(acc + 4));
+    __m128i a3 = _mm_loadu_si128((const __m128i*)(acc + 6));
+
+    for(u64 n = 0; n < stripeCount; n++)
+    {
+        const u8* in = input + n * OC_XXH3_STRIPE_LEN;
+        const u8* key = secret + n * OC_XXH3_SECRET_CONSUME_RATE;
+
+        a0 = oc_xxh3_accumulate_sse2(a0, in, key);
+        a1 = oc_xxh3_accumulate_sse2(a1, in + 16, key + 16);
+        a2 = oc_xxh3_accumulate_sse2(a2, in + 32, key + 32);
+        a3 = oc_xxh3_accumulate_sse2(a3, in + 48, key + 48);
+    }
+
+    _mm_storeu_si128((__m128i*)acc, a0);
+    _mm_storeu_si128((__m128i*)(acc + 2), a1);
+    _mm_storeu_si128((__m128i*)(acc + 4), a2);
+    _mm_storeu_si128((__m128i*)(acc + 6), a3);
+#else
+    for(u64 n = 0; n < stripeCount; n++)
+    {
+        const u8* in = input + n * OC_XXH3_STRIPE_LEN;
+        const u8* key = secret + n * OC_XXH3_SECRET_CONSUME_RATE;
+
+        for(int i = 0; i < OC_XXH3_ACC_COUNT; i++)
+        {
+            u64 data = oc_hash_read64(in + 8 * i);
+            u64 dataKey = data ^ oc_hash_read64(key + 8 * i);
+            acc[i ^ 1] += data;
+            acc[i] += (dataKey & 0xffffffff) * (dataKey >> 32);
+        }
+    }
+#endif
+}
+
+static void oc_xxh3_scramble(u64* acc, const u8* secret)
+{
+#if OC_XXH3_AVX2
+    __m256i prime = _mm256_set1_epi32((int)OC_XXH_PRIME32_1);
+    for(int i = 0; i < 2; i++)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(acc + 4 * i));
+        a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(secret + 32 * i)));
+
+        __m256i productLo = _mm256_mul_epu32(a, prime);
+        __m256i productHi = _mm256_mul_epu32(_mm256_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        a = _mm256_add_epi64(productLo, _mm256_slli_epi64(productHi, 32));
+        _mm256_storeu_si256((__m256i*)(acc + 4 * i), a);
+    }
+#elif OC_XXH3_SSE2
+    __m128i prime = _mm_set1_epi32((int)OC_XXH_PRIME32_1);
+    for(int i = 0; i < 4; i++)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+        a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(secret + 16 * i)));
+
+        __m128i productLo = _mm_mul_epu32(a, prime);
+        __m128i productHi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        a = _mm_add_epi64(productLo, _mm_slli_epi64(productHi, 32));
+        _mm_storeu_si128((__m128i*)(acc + 2 * i), a);
+    }
+#else
+    for(int i = 0; i < OC_XXH3_ACC_COUNT; i++)
+    {
+        u64 a = acc[i];
+        a ^= a >> 47;
+        a ^= oc_hash_read64(secret + 8 * i);
+        acc[i] = a * OC_XXH_PRIME32_1;
+    }
+#endif
+}
+
+static void oc_xxh3_init_acc(u64* acc)
+{
+    acc[0] = OC_XXH_PRIME32_3;
+    acc[1] = OC_XXH_PRIME64_1;
+    acc[2] = OC_XXH_PRIME64_2;
+    acc[3] = OC_XXH_PRIME64_3;
+    acc[4] = OC_XXH_PRIME64_4;
+    acc[5] = OC_XXH_PRIME32_2;
+    acc[6] = OC_XXH_PRIME64_5;
+    acc[7] = OC_XXH_PRIME32_1;
+}
+
+static u64 oc_xxh3_merge_accs(const u64* acc, const u8* secret, u64 start)
+{
+    u64 result = start;
+    for(int i = 0; i < 4; i++)
+    {
+        result += oc_xxh3_mul128_fold64(acc[2 * i] ^ oc_hash_read64(secret + 16 * i),
+                                        acc[2 * i + 1] ^ oc_hash_read64(secret + 16 * i + 8));
+    }
+    return (oc_xxh3_avalanche(result));
+}
+
+static void oc_xxh3_init_secret(u8* secret, u64 seed)
+{
+    for(int i = 0; i < OC_HASH_XXH3_SECRET_SIZE / 16; i++)
+    {
+        u64 lo = oc_hash_read64(OC_XXH3_DEFAULT_SECRET + 16 * i) + seed;
+        u64 hi = oc_hash_read64(OC_XXH3_DEFAULT_SECRET + 16 * i + 8) - seed;
+        memcpy(secret + 16 * i, &lo, sizeof(u64));
+        memcpy(secret + 16 * i + 8, &hi, sizeof(u64));
+    }
+}
+
+static u64 oc_xxh3_long(const u8* input, u64 len, const u8* secret)
+{
+    u64 acc[OC_XXH3_ACC_COUNT];
+    oc_xxh3_init_acc(acc);
+
+    u64 blockLen = OC_XXH3_STRIPE_LEN * OC_XXH3_BLOCK_STRIPES;
+    u64 blockCount = (len - 1) / blockLen;
+
+    for(u64 n = 0; n < blockCount; n++)
+    {
+        oc_xxh3_accumulate(acc, input + n * blockLen, secret, OC_XXH3_BLOCK_STRIPES);
+        oc_xxh3_scramble(acc, secret + OC_XXH3_SECRET_LIMIT);
+    }
+
+    //NOTE: last partial block, and last stripe, which can overlap the previous one
+    u64 stripeCount = ((len - 1) - blockLen * blockCount) / OC_XXH3_STRIPE_LEN;
+    oc_xxh3_accumulate(acc, input + blockCount * blockLen, secret, stripeCount);
+    oc_xxh3_accumulate(acc, input + len - OC_XXH3_STRIPE_LEN, secret + OC_XXH3_SECRET_LIMIT - OC_XXH3_SECRET_LASTACC_START, 1);
+
+    return (oc_xxh3_merge_accs(acc, secret + OC_XXH3_SECRET_MERGEACCS_START, len * OC_XXH_PRIME64_1));
+}
+
+static u64 oc_xxh3(const u8* input, u64 len, u64 seed)
+{
+    if(len <= 16)
+    {
+        return (oc_xxh3_len_0_to_16(input, len, OC_XXH3_DEFAULT_SECRET, seed));
+    }
+    else if(len <= 128)
+    {
+        return (oc_xxh3_len_17_to_128(input, len, OC_XXH3_DEFAULT_SECRET, seed));
+    }
+    else if(len <= OC_XXH3_MIDSIZE_MAX)
+    {
+        return (oc_xxh3_len_129_to_240(input, len, OC_XXH3_DEFAULT_SECRET, seed));
+    }
+    else if(seed == 0)
+    {
+        return (oc_xxh3_long(input, len, OC_XXH3_DEFAULT_SECRET));
+    }
+    else
+    {
+        u8 secret[OC_HASH_XXH3_SECRET_SIZE];
+        oc_xxh3_init_secret(secret, seed);
+        return (oc_xxh3_long(input, len, secret));
+    }
+}
+
+u64 oc_hash_xxh3_string_seed(oc_str8 string, u64 seed)
+{
+    return (oc_xxh3((const u8*)string.ptr, string.len, seed));
+}
+
+u64 oc_hash_xxh3_string(oc_str8 string)
+{
+    return (oc_xxh3((const u8*)string.ptr, string.len, 0));
+}
+
+void oc_hash_xxh3_init(oc_hash_xxh3_state* state, u64 seed)
+{
+    memset(state, 0, sizeof(oc_hash_xxh3_state));
+    oc_xxh3_init_acc(state->acc);
+    oc_xxh3_init_secret(state->secret, seed);
+    state->seed = seed;
+}
+
+//NOTE: accumulates stripes, scrambling the accumulators each time a block is complete
+static void oc_xxh3_consume_stripes(oc_hash_xxh3_state* state, const u8* input, u64 stripeCount)
+{
+    while(stripeCount)
+    {
+        u64 count = oc_min(stripeCount, OC_XXH3_BLOCK_STRIPES - state->blockStripes);
+        oc_xxh3_accumulate(state->acc, input, state->secret + state->blockStripes * OC_XXH3_SECRET_CONSUME_RATE, count);
+        input += count * OC_XXH3_STRIPE_LEN;
+        stripeCount -= count;
+        state->blockStripes += count;
+
+        if(state->blockStripes == OC_XXH3_BLOCK_STRIPES)
+        {
+            oc_xxh3_scramble(state->acc, state->secret + OC_XXH3_SECRET_LIMIT);
+            state->blockStripes = 0;
+        }
+    }
+}
+
+/*NOTE:
+    The last stripe of the input is processed differently from the others, and the digest of short inputs is
+    computed from the whole input, so the state always keeps some bytes buffered: input is only consumed when
+    more bytes follow it. When the buffer is flushed, the last stripe is kept at the end of the buffer, so that
+    the digest can build the last stripe from it.
+*/
+void oc_hash_xxh3_update(oc_hash_xxh3_state* state, oc_str8 data)
+{
+    const u8* input = (const u8*)data.ptr;
+    const u8* end = input + data.len;
+    state->totalLen += data.len;
+
+    if(data.len <= OC_HASH_XXH3_BUFFER_SIZE - state->bufferedSize)
+    {
+        if(data.len)
+        {
+            memcpy(state->buffer + state->bufferedSize, input, data.len);
+            state->bufferedSize += data.len;
+        }
+        return;
+    }
+
+    if(state->bufferedSize)
+    {
+        u64 loadSize = OC_HASH_XXH3_BUFFER_SIZE - state->bufferedSize;
+        memcpy(state->buffer + state->bufferedSize, input, loadSize);
+        input += loadSize;
+        oc_xxh3_consume_stripes(state, state->buffer, OC_XXH3_BUFFER_STRIPES);
+        state->bufferedSize = 0;
+    }
+
+    if(end - input > OC_HASH_XXH3_BUFFER_SIZE)
+    {
+        u64 stripeCount = (end - 1 - input) / OC_XXH3_STRIPE_LEN;
+        oc_xxh3_consume_stripes(state, input, stripeCount);
+        input += stripeCount * OC_XXH3_STRIPE_LEN;
+        memcpy(state->buffer + OC_HASH_XXH3_BUFFER_SIZE - OC_XXH3_STRIPE_LEN, input - OC_XXH3_STRIPE_LEN, OC_XXH3_STRIPE_LEN);
+    }
+
+    memcpy(state->buffer, input, end - input);
+    state->bufferedSize = end - input;
+}
+
+u64 oc_hash_xxh3_digest(oc_hash_xxh3_state* state)
+{
+    if(state->totalLen <= OC_XXH3_MIDSIZE_MAX)
+    {
+        return (oc_xxh3(state->buffer, state->totalLen, state->seed));
+    }
+
+    //NOTE: work on a copy of the state, so that more data can be added after computing a digest
+    oc_hash_xxh3_state copy = *state;
+    const u8* lastStripe = 0;
+    u8 lastStripeBuffer[OC_XXH3_STRIPE_LEN];
+
+    if(copy.bufferedSize >= OC_XXH3_STRIPE_LEN)
+    {
+        u64 stripeCount = (copy.bufferedSize - 1) / OC_XXH3_STRIPE_LEN;
+        oc_xxh3_consume_stripes(&copy, copy.buffer, stripeCount);
+        lastStripe = copy.buffer + copy.bufferedSize - OC_XXH3_STRIPE_LEN;
+    }
+    else
+    {
+        u64 catchupSize = OC_XXH3_STRIPE_LEN - copy.bufferedSize;
+        memcpy(lastStripeBuffer, copy.buffer + OC_HASH_XXH3_BUFFER_SIZE - catchupSize, catchupSize);
+        memcpy(lastStripeBuffer + catchupSize, copy.buffer, copy.bufferedSize);
+        lastStripe = lastStripeBuffer;
+    }
+    oc_xxh3_accumulate(copy.acc, lastStripe, copy.secret + OC_XXH3_SECRET_LIMIT - OC_XXH3_SECRET_LASTACC_START, 1);
+
+    return (oc_xxh3_merge_accs(copy.acc, copy.secret + OC_XXH3_SECRET_MERGEACCS_START, copy.totalLen * OC_XXH_PRIME64_1));
+}
+
 #if 0 //NOTE(martin): keep that here cause we could want to use them when aes is available, but we don't for now
     #if OC_ARCH_X64
         #include <immintrin.h>
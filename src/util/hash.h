@@ -14,9 +14,37 @@
 extern "C" {
 #endif
 
+//NOTE: xxHash64
 ORCA_API u64 oc_hash_xx64_string_seed(oc_str8 string, u64 seed);
 ORCA_API u64 oc_hash_xx64_string(oc_str8 string);
 
+//NOTE: XXH3, 64-bit variant. It is faster than xxHash64 at all sizes, and is the hash used for in-memory tables.
+ORCA_API u64 oc_hash_xxh3_string_seed(oc_str8 string, u64 seed);
+ORCA_API u64 oc_hash_xxh3_string(oc_str8 string);
+
+//NOTE: streaming XXH3, to hash data that isn't in one contiguous buffer. Feeding a string in any number of pieces
+//      gives the same result as oc_hash_xxh3_string_seed().
+enum
+{
+    OC_HASH_XXH3_SECRET_SIZE = 192,
+    OC_HASH_XXH3_BUFFER_SIZE = 256,
+};
+
+typedef struct oc_hash_xxh3_state
+{
+    u64 acc[8];
+    u8 secret[OC_HASH_XXH3_SECRET_SIZE];
+    u8 buffer[OC_HASH_XXH3_BUFFER_SIZE];
+    u64 bufferedSize;
+    u64 blockStripes; // number of stripes accumulated in the current block
+    u64 totalLen;
+    u64 seed;
+} oc_hash_xxh3_state;
+
+ORCA_API void oc_hash_xxh3_init(oc_hash_xxh3_state* state, u64 seed);
+ORCA_API void oc_hash_xxh3_update(oc_hash_xxh3_state* state, oc_str8 data);
+ORCA_API u64 oc_hash_xxh3_digest(oc_hash_xxh3_state* state);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
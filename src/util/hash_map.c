@@ -0,0 +1,455 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include "hash_map.h"
+#include "hash.h"
+#include "platform/platform.h"
+
+/*NOTE:
+    Control bytes are either OC_HASH_MAP_EMPTY, OC_HASH_MAP_DELETED, or the low 7 bits of the hash of the key
+    stored in the slot. The high bits of the hash give the first slot of the probe sequence.
+
+    Probing loads a group of control bytes starting at any slot, so the first group's bytes are mirrored after the
+    last slot, and groups that wrap around the table can be loaded at once. A probe sequence visits groups in
+    triangular steps, which covers the whole table since the number of slots is a power of two. The sequence stops
+    at the first group that has an empty slot, so the table always keeps some empty slots, and erased entries are
+    marked as deleted unless no probe sequence can ever have gone past them.
+
+    Group matches are returned as bit masks, with one bit per matching slot at bit (index << OC_HASH_MAP_MASK_SHIFT).
+*/
+#if OC_ARCH_X64
+    #include <emmintrin.h>
+    #define OC_HASH_MAP_SSE2 1
+    #define OC_HASH_MAP_GROUP_WIDTH 16
+    #define OC_HASH_MAP_MASK_SHIFT 0
+#elif OC_ARCH_ARM64
+    #include <arm_neon.h>
+    #define OC_HASH_MAP_NEON 1
+    #define OC_HASH_MAP_GROUP_WIDTH 16
+    #define OC_HASH_MAP_MASK_SHIFT 2
+#else
+    #define OC_HASH_MAP_GROUP_WIDTH 8
+    #define OC_HASH_MAP_MASK_SHIFT 3
+#endif
+
+#if OC_COMPILER_CL
+    #include <intrin.h>
+#endif
+
+enum
+{
+    OC_HASH_MAP_EMPTY = 0x80,
+    OC_HASH_MAP_DELETED = 0xfe,
+    OC_HASH_MAP_MIN_CAP = 16,
+};
+
+static const u64 OC_HASH_MAP_NOT_FOUND = UINT64_MAX;
+
+static inline u32 oc_hash_map_ctz(u64 x)
+{
+#if OC_COMPILER_CL
+    unsigned long index = 0;
+    _BitScanForward64(&index, x);
+    return (index);
+#else
+    return (__builtin_ctzll(x));
+#endif
+}
+
+static inline u32 oc_hash_map_clz(u64 x)
+{
+#if OC_COMPILER_CL
+    unsigned long index = 0;
+    _BitScanReverse64(&index, x);
+    return (63 - index);
+#else
+    return (__builtin_clzll(x));
+#endif
+}
+
+#if OC_HASH_MAP_SSE2
+
+static inline u64 oc_hash_map_group_match(const u8* ctrl, u8 h2)
+{
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2))));
+}
+
+static inline u64 oc_hash_map_group_match_empty(const u8* ctrl)
+{
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)OC_HASH_MAP_EMPTY))));
+}
+
+static inline u64 oc_hash_map_group_match_empty_or_deleted(const u8* ctrl)
+{
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (_mm_movemask_epi8(group));
+}
+
+#elif OC_HASH_MAP_NEON
+
+//NOTE: narrow the comparison results to 4 bits per slot, and keep one of them
+static inline u64 oc_hash_map_neon_mask(uint8x16_t cmp)
+{
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return (vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL);
+}
+
+static inline u64 oc_hash_map_group_match(const u8* ctrl, u8 h2)
+{
+    return (oc_hash_map_neon_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2))));
+}
+
+static inline u64 oc_hash_map_group_match_empty(const u8* ctrl)
+{
+    return (oc_hash_map_neon_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(OC_HASH_MAP_EMPTY))));
+}
+
+static inline u64 oc_hash_map_group_match_empty_or_deleted(const u8* ctrl)
+{
+    return (oc_hash_map_neon_mask(vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl)))));
+}
+
+#else
+
+static const u64 OC_HASH_MAP_LSBS = 0x0101010101010101ULL;
+static const u64 OC_HASH_MAP_MSBS = 0x8080808080808080ULL;
+
+static inline u64 oc_hash_map_group_load(const u8* ctrl)
+{
+    u64 group = 0;
+    memcpy(&group, ctrl, sizeof(u64));
+    return (group);
+}
+
+//NOTE: this can report false positives, but only for slots following a real match, and keys are compared anyway
+static inline u64 oc_hash_map_group_match(const u8* ctrl, u8 h2)
+{
+    u64 x = oc_hash_map_group_load(ctrl) ^ (OC_HASH_MAP_LSBS * h2);
+    return ((x - OC_HASH_MAP_LSBS) & ~x & OC_HASH_MAP_MSBS);
+}
+
+//NOTE: empty bytes have their high bit set and their bit 1 cleared, deleted bytes have both set
+static inline u64 oc_hash_map_group_match_empty(const u8* ctrl)
+{
+    u64 group = oc_hash_map_group_load(ctrl);
+    return (group & ~(group << 6) & OC_HASH_MAP_MSBS);
+}
+
+static inline u64 oc_hash_map_group_match_empty_or_deleted(const u8* ctrl)
+{
+    return (oc_hash_map_group_load(ctrl) & OC_HASH_MAP_MSBS);
+}
+
+#endif
+
+static inline u64 oc_hash_map_mix_u64(u64 key)
+{
+    //NOTE: murmur3 finalizer, so that sequential keys are spread over the table
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return (key);
+}
+
+static inline u64 oc_hash_map_growth(u64 cap)
+{
+    //NOTE: keep the load factor under 7/8
+    return (cap - cap / 8);
+}
+
+static inline void oc_hash_map_set_ctrl(oc_hash_map* map, u64 index, u8 c)
+{
+    u64 mask = map->cap - 1;
+    map->ctrl[index] = c;
+    map->ctrl[((index - OC_HASH_MAP_GROUP_WIDTH) & mask) + OC_HASH_MAP_GROUP_WIDTH] = c;
+}
+
+static u64 oc_hash_map_find_index(oc_hash_map* map, u64 hash, u64 key, oc_str8* string)
+{
+    if(!map->count)
+    {
+        return (OC_HASH_MAP_NOT_FOUND);
+    }
+
+    u64 mask = map->cap - 1;
+    u8 h2 = hash & 0x7f;
+    u64 pos = (hash >> 7) & mask;
+
+    for(u64 step = OC_HASH_MAP_GROUP_WIDTH;; step += OC_HASH_MAP_GROUP_WIDTH)
+    {
+        const u8* group = map->ctrl + pos;
+        for(u64 match = oc_hash_map_group_match(group, h2); match; match &= match - 1)
+        {
+            u64 index = (pos + (oc_hash_map_ctz(match) >> OC_HASH_MAP_MASK_SHIFT)) & mask;
+            oc_hash_map_entry* entry = &map->entries[index];
+            if(entry->key == key && (!string || !oc_str8_cmp(entry->string, *string)))
+            {
+                return (index);
+            }
+        }
+        if(oc_hash_map_group_match_empty(group))
+        {
+            return (OC_HASH_MAP_NOT_FOUND);
+        }
+        pos = (pos + step) & mask;
+    }
+}
+
+static u64 oc_hash_map_find_free_index(oc_hash_map* map, u64 hash)
+{
+    u64 mask = map->cap - 1;
+    u64 pos = (hash >> 7) & mask;
+
+    for(u64 step = OC_HASH_MAP_GROUP_WIDTH;; step += OC_HASH_MAP_GROUP_WIDTH)
+    {
+        u64 match = oc_hash_map_group_match_empty_or_deleted(map->ctrl + pos);
+        if(match)
+        {
+            return ((pos + (oc_hash_map_ctz(match) >> OC_HASH_MAP_MASK_SHIFT)) & mask);
+        }
+        pos = (pos + step) & mask;
+    }
+}
+
+static inline u64 oc_hash_map_entry_hash(oc_hash_map_entry* entry)
+{
+    //NOTE: the key of string entries is already the hash of the string
+    return (entry->string.ptr ? entry->key : oc_hash_map_mix_u64(entry->key));
+}
+
+static void oc_hash_map_resize(oc_hash_map* map, u64 cap)
+{
+    u8* oldCtrl = map->ctrl;
+    oc_hash_map_entry* oldEntries = map->entries;
+    u64 oldCap = map->cap;
+
+    u64 ctrlSize = cap + OC_HASH_MAP_GROUP_WIDTH;
+    if(map->allocator)
+    {
+        map->ctrl = oc_allocator_push_aligned_uninitialized(map->allocator, ctrlSize, 16);
+        map->entries = oc_allocator_push_array_uninitialized(map->allocator, oc_hash_map_entry, cap);
+    }
+    else
+    {
+        map->ctrl = oc_malloc_array(u8, ctrlSize);
+        map->entries = oc_malloc_array(oc_hash_map_entry, cap);
+    }
+    OC_ASSERT(map->ctrl && map->entries, "couldn't allocate hash map");
+
+    memset(map->ctrl, OC_HASH_MAP_EMPTY, ctrlSize);
+    map->cap = cap;
+
+    for(u64 i = 0; i < oldCap; i++)
+    {
+        if(!(oldCtrl[i] & 0x80))
+        {
+            u64 hash = oc_hash_map_entry_hash(&oldEntries[i]);
+            u64 index = oc_hash_map_find_free_index(map, hash);
+            oc_hash_map_set_ctrl(map, index, hash & 0x7f);
+            map->entries[index] = oldEntries[i];
+        }
+    }
+    map->growthLeft = oc_hash_map_growth(cap) - map->count;
+
+    if(!map->allocator)
+    {
+        free(oldCtrl);
+        free(oldEntries);
+    }
+}
+
+void oc_hash_map_init(oc_hash_map* map, oc_allocator* allocator, u64 capacity)
+{
+    memset(map, 0, sizeof(oc_hash_map));
+    map->allocator = allocator;
+    if(capacity)
+    {
+        oc_hash_map_reserve(map, capacity);
+    }
+}
+
+void oc_hash_map_cleanup(oc_hash_map* map)
+{
+    if(!map->allocator)
+    {
+        free(map->ctrl);
+        free(map->entries);
+    }
+    memset(map, 0, sizeof(oc_hash_map));
+}
+
+void oc_hash_map_clear(oc_hash_map* map)
+{
+    if(map->cap)
+    {
+        memset(map->ctrl, OC_HASH_MAP_EMPTY, map->cap + OC_HASH_MAP_GROUP_WIDTH);
+        map->count = 0;
+        map->growthLeft = oc_hash_map_growth(map->cap);
+    }
+}
+
+void oc_hash_map_reserve(oc_hash_map* map, u64 count)
+{
+    u64 cap = oc_max(map->cap, OC_HASH_MAP_MIN_CAP);
+    while(oc_hash_map_growth(cap) < count)
+    {
+        cap *= 2;
+    }
+    if(cap != map->cap)
+    {
+        oc_hash_map_resize(map, cap);
+    }
+}
+
+static oc_hash_map_entry* oc_hash_map_insert_hash(oc_hash_map* map, u64 hash, u64 key, oc_str8* string, bool* inserted)
+{
+    u64 index = oc_hash_map_find_index(map, hash, key, string);
+    if(index != OC_HASH_MAP_NOT_FOUND)
+    {
+        if(inserted)
+        {
+            *inserted = false;
+        }
+        return (&map->entries[index]);
+    }
+
+    if(!map->cap)
+    {
+        oc_hash_map_reserve(map, 1);
+    }
+    index = oc_hash_map_find_free_index(map, hash);
+
+    if(map->ctrl[index] == OC_HASH_MAP_EMPTY && !map->growthLeft)
+    {
+        //NOTE: if at least half the slots that can be filled are deleted, rehash in place to drop them, otherwise grow
+        u64 cap = (map->count <= oc_hash_map_growth(map->cap) / 2) ? map->cap : map->cap * 2;
+        oc_hash_map_resize(map, cap);
+        index = oc_hash_map_find_free_index(map, hash);
+    }
+
+    if(map->ctrl[index] == OC_HASH_MAP_EMPTY)
+    {
+        map->growthLeft--;
+    }
+    oc_hash_map_set_ctrl(map, index, hash & 0x7f);
+    map->count++;
+
+    oc_hash_map_entry* entry = &map->entries[index];
+    entry->key = key;
+    entry->string = string ? *string : (oc_str8){ 0 };
+    entry->value = 0;
+
+    if(inserted)
+    {
+        *inserted = true;
+    }
+    return (entry);
+}
+
+void oc_hash_map_erase_entry(oc_hash_map* map, oc_hash_map_entry* entry)
+{
+    u64 mask = map->cap - 1;
+    u64 index = entry - map->entries;
+    u64 before = (index - OC_HASH_MAP_GROUP_WIDTH) & mask;
+
+    //NOTE: if the run of full slots around this slot is shorter than a group, every group containing this slot
+    //      also contains an empty slot, so no probe sequence went past it, and it can be marked empty.
+    u64 emptyAfter = oc_hash_map_group_match_empty(map->ctrl + index);
+    u64 emptyBefore = oc_hash_map_group_match_empty(map->ctrl + before);
+
+    bool neverFull = false;
+    if(emptyAfter && emptyBefore)
+    {
+        u64 fullAfter = oc_hash_map_ctz(emptyAfter) >> OC_HASH_MAP_MASK_SHIFT;
+        u64 fullBefore = OC_HASH_MAP_GROUP_WIDTH - 1 - ((63 - oc_hash_map_clz(emptyBefore)) >> OC_HASH_MAP_MASK_SHIFT);
+        neverFull = (fullAfter + fullBefore < OC_HASH_MAP_GROUP_WIDTH);
+    }
+
+    if(neverFull)
+    {
+        oc_hash_map_set_ctrl(map, index, OC_HASH_MAP_EMPTY);
+        map->growthLeft++;
+    }
+    else
+    {
+        oc_hash_map_set_ctrl(map, index, OC_HASH_MAP_DELETED);
+    }
+    map->count--;
+}
+
+oc_hash_map_entry* oc_hash_map_find_u64(oc_hash_map* map, u64 key)
+{
+    u64 index = oc_hash_map_find_index(map, oc_hash_map_mix_u64(key), key, 0);
+    return ((index == OC_HASH_MAP_NOT_FOUND) ? 0 : &map->entries[index]);
+}
+
+oc_hash_map_entry* oc_hash_map_insert_u64(oc_hash_map* map, u64 key, bool* inserted)
+{
+    return (oc_hash_map_insert_hash(map, oc_hash_map_mix_u64(key), key, 0, inserted));
+}
+
+bool oc_hash_map_erase_u64(oc_hash_map* map, u64 key)
+{
+    oc_hash_map_entry* entry = oc_hash_map_find_u64(map, key);
+    if(entry)
+    {
+        oc_hash_map_erase_entry(map, entry);
+    }
+    return (entry != 0);
+}
+
+//NOTE: string entries are told apart from u64 entries by a non-null string pointer
+static oc_str8 oc_hash_map_key_str8(oc_str8 key)
+{
+    if(!key.ptr)
+    {
+        key.ptr = (char*)"";
+    }
+    return (key);
+}
+
+oc_hash_map_entry* oc_hash_map_find_str8(oc_hash_map* map, oc_str8 key)
+{
+    key = oc_hash_map_key_str8(key);
+    u64 hash = oc_hash_xxh3_string(key);
+    u64 index = oc_hash_map_find_index(map, hash, hash, &key);
+    return ((index == OC_HASH_MAP_NOT_FOUND) ? 0 : &map->entries[index]);
+}
+
+oc_hash_map_entry* oc_hash_map_insert_str8(oc_hash_map* map, oc_str8 key, bool* inserted)
+{
+    key = oc_hash_map_key_str8(key);
+    u64 hash = oc_hash_xxh3_string(key);
+    return (oc_hash_map_insert_hash(map, hash, hash, &key, inserted));
+}
+
+bool oc_hash_map_erase_str8(oc_hash_map* map, oc_str8 key)
+{
+    oc_hash_map_entry* entry = oc_hash_map_find_str8(map, key);
+    if(entry)
+    {
+        oc_hash_map_erase_entry(map, entry);
+    }
+    return (entry != 0);
+}
+
+oc_hash_map_entry* oc_hash_map_next(oc_hash_map* map, oc_hash_map_entry* entry)
+{
+    u64 index = entry ? (entry - map->entries) + 1 : 0;
+    for(; index < map->cap; index++)
+    {
+        if(!(map->ctrl[index] & 0x80))
+        {
+            return (&map->entries[index]);
+        }
+    }
+    return (0);
+}
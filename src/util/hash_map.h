@@ -0,0 +1,80 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "util/memory.h"
+#include "util/strings.h"
+#include "util/typedefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------------
+// Hash map
+//------------------------------------------------------------------------
+/*NOTE:
+    oc_hash_map is an open-addressing hash table, keyed either by u64 or by strings. A given map must use only one
+    kind of key. String keys are not copied, so they must outlive their entry.
+
+    The table is laid out like a "swiss table": each slot has a control byte that holds 7 bits of the key's hash, or
+    marks the slot as empty or deleted. Lookups compare a whole group of control bytes at a time (with SSE2 or NEON
+    when available, or with 64-bit words otherwise), and only compare keys whose control byte matches.
+
+    Tables are pushed on the allocator passed to oc_hash_map_init(), so that maps can live in an arena. Since
+    allocators can't free memory, a map that grows leaves its old tables behind. If allocator is null, tables are
+    malloc'ed instead, and freed when the map grows or is cleaned up.
+
+    Pointers to entries are invalidated by insertions, but not by erasures.
+*/
+
+typedef struct oc_hash_map_entry
+{
+    u64 key;        // the key of u64 maps, or the hash of the key of string maps
+    oc_str8 string; // the key of string maps
+
+    union
+    {
+        u64 value;
+        void* ptr;
+    };
+} oc_hash_map_entry;
+
+typedef struct oc_hash_map
+{
+    oc_allocator* allocator;
+    u64 count;
+    u64 cap;        // number of slots, a power of two
+    u64 growthLeft; // number of empty slots that can be filled before rehashing
+    u8* ctrl;
+    oc_hash_map_entry* entries;
+} oc_hash_map;
+
+ORCA_API void oc_hash_map_init(oc_hash_map* map, oc_allocator* allocator, u64 capacity);
+ORCA_API void oc_hash_map_cleanup(oc_hash_map* map);
+ORCA_API void oc_hash_map_clear(oc_hash_map* map);
+ORCA_API void oc_hash_map_reserve(oc_hash_map* map, u64 count);
+
+ORCA_API oc_hash_map_entry* oc_hash_map_find_u64(oc_hash_map* map, u64 key);
+ORCA_API oc_hash_map_entry* oc_hash_map_insert_u64(oc_hash_map* map, u64 key, bool* inserted); //NOTE: returns the existing entry if the key is already present
+ORCA_API bool oc_hash_map_erase_u64(oc_hash_map* map, u64 key);
+
+ORCA_API oc_hash_map_entry* oc_hash_map_find_str8(oc_hash_map* map, oc_str8 key);
+ORCA_API oc_hash_map_entry* oc_hash_map_insert_str8(oc_hash_map* map, oc_str8 key, bool* inserted); //NOTE: returns the existing entry if the key is already present
+ORCA_API bool oc_hash_map_erase_str8(oc_hash_map* map, oc_str8 key);
+
+ORCA_API void oc_hash_map_erase_entry(oc_hash_map* map, oc_hash_map_entry* entry);
+ORCA_API oc_hash_map_entry* oc_hash_map_next(oc_hash_map* map, oc_hash_map_entry* entry); //NOTE: returns the first entry if entry is null
+
+#define oc_hash_map_for(map, entry)                                    \
+    for(oc_hash_map_entry* entry = oc_hash_map_next((map), 0); entry != 0; \
+        entry = oc_hash_map_next((map), entry))
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -111,7 +111,7 @@ json_lex json_lex_number(json_parser* parser)
     u64 numberU64 = 0;
     bool minus = false;
 
-    if(parser->offset < contents.len && contents.ptr[0] == '-')
+    if(parser->offset < contents.len && contents.ptr[parser->offset] == '-')
     {
         minus = true;
         parser->offset++;
@@ -202,6 +202,8 @@ json_lex json_lex_string(json_parser* parser)
                     case 't':
                     case '"':
                     case '\\':
+                    case '/':
+                    case 'u':
                         break;
                     default:
                         lex.kind = JSON_LEX_UNKNOWN_ESCAPE;
@@ -395,6 +397,34 @@ void json_node_add_child(json_node* node, json_node* child)
     node->childCount++;
 }
 
+u32 json_parse_hex4(const char* ptr)
+{
+    u32 value = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        char c = ptr[i];
+        u32 digit = 0;
+        if(c >= '0' && c <= '9')
+        {
+            digit = c - '0';
+        }
+        else if(c >= 'a' && c <= 'f')
+        {
+            digit = c - 'a' + 10;
+        }
+        else if(c >= 'A' && c <= 'F')
+        {
+            digit = c - 'A' + 10;
+        }
+        else
+        {
+            OC_ASSERT(0, "unreachable");
+        }
+        value = value * 16 + digit;
+    }
+    return (value);
+}
+
 oc_str8 json_convert_escaped_string(oc_allocator* allocator, oc_str8 string)
 {
     oc_str8 result = {
@@ -432,30 +462,28 @@ oc_str8 json_convert_escaped_string(oc_allocator* allocator, oc_str8 string)
                 case '\\':
                     result.ptr[result.len] = '\\';
                     break;
+                case '/':
+                    result.ptr[result.len] = '/';
+                    break;
 
                 case 'u':
                 {
-                    u32 codepoint = 0;
-                    offset++;
-                    for(int i = 0; i < 4; i++)
+                    u32 codepoint = json_parse_hex4(string.ptr + offset + 1);
+                    offset += 4;
+
+                    //NOTE: characters outside the BMP are encoded as a surrogate pair
+                    if(codepoint >= 0xd800 && codepoint < 0xdc00
+                       && offset + 6 < string.len
+                       && string.ptr[offset + 1] == '\\'
+                       && string.ptr[offset + 2] == 'u')
                     {
-                        char c = string.ptr[offset + i];
-                        u32 digit = 0;
-                        if(c >= '0' && c <= '9')
+                        u32 low = json_parse_hex4(string.ptr + offset + 3);
+                        if(low >= 0xdc00 && low < 0xe000)
                         {
-                            digit = c - '0';
+                            codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                            offset += 6;
                         }
-                        else if(c >= 'a' && c <= 'f')
-                        {
-                            digit = c - 'a' + 10;
-                        }
-                        else
-                        {
-                            OC_ASSERT(0, "unreachable");
-                        }
-                        codepoint = codepoint * 16 + digit;
                     }
-                    offset += 3;
 
                     oc_str8 enc = oc_utf8_encode(result.ptr + result.len, codepoint);
                     result.len += enc.len - 1;
@@ -482,7 +510,7 @@ json_node* json_parse_object(json_parser* parser)
 {
     json_node* node = json_node_alloc(parser, JSON_OBJECT);
 
-    json_lex lex = json_lex_consume_if(parser, JSON_LEX_RBRACKET);
+    json_lex lex = json_lex_consume_if(parser, JSON_LEX_RBRACE);
     if(lex.kind != JSON_LEX_RBRACE)
     {
         do
@@ -694,3 +722,766 @@ json_node* json_find(json_node* node, oc_str8 name)
     }
     return (res);
 }
+
+//------------------------------------------------------------------------
+// Streaming reader
+//------------------------------------------------------------------------
+/*NOTE:
+    json_reader walks the input one token at a time, without allocating anything. Strings and keys are returned as
+    slices of the input, without the quotes and with their escape sequences left as is. Use
+    json_convert_escaped_string() on tokens that have the escaped flag set to get the actual string.
+
+    The reader checks the structure of the document, and returns a JSON_TOKEN_ERROR token on the first error, and
+    on every call after that.
+*/
+
+typedef enum json_token_kind
+{
+    JSON_TOKEN_ERROR,
+    JSON_TOKEN_END,
+    JSON_TOKEN_OBJECT_BEGIN,
+    JSON_TOKEN_OBJECT_END,
+    JSON_TOKEN_LIST_BEGIN,
+    JSON_TOKEN_LIST_END,
+    JSON_TOKEN_KEY,
+    JSON_TOKEN_STRING,
+    JSON_TOKEN_NUM_F64,
+    JSON_TOKEN_NUM_I64,
+    JSON_TOKEN_TRUE,
+    JSON_TOKEN_FALSE,
+    JSON_TOKEN_NULL,
+} json_token_kind;
+
+const char* json_token_kind_strings[] = {
+    "error",
+    "end",
+    "object begin",
+    "object end",
+    "list begin",
+    "list end",
+    "key",
+    "string",
+    "num f64",
+    "num i64",
+    "true",
+    "false",
+    "null",
+};
+
+typedef struct json_token
+{
+    json_token_kind kind;
+    oc_str8 string; // contents of strings and keys, text of other tokens, or location of the error
+    bool escaped;   // the string contains escape sequences
+    u32 depth;      // nesting depth of the token. Begin and end tokens have the depth of their container.
+
+    f64 numF64;
+    i64 numI64;
+
+} json_token;
+
+enum
+{
+    JSON_READER_MAX_DEPTH = 256,
+};
+
+typedef enum json_reader_expect
+{
+    JSON_EXPECT_VALUE,
+    JSON_EXPECT_VALUE_OR_LIST_END,
+    JSON_EXPECT_KEY,
+    JSON_EXPECT_KEY_OR_OBJECT_END,
+    JSON_EXPECT_COMMA_OR_END,
+    JSON_EXPECT_EOF,
+    JSON_EXPECT_NOTHING,
+} json_reader_expect;
+
+typedef struct json_reader
+{
+    oc_str8 contents;
+    u64 offset;
+    json_reader_expect expect;
+
+    //NOTE: one bit per nesting level, set for objects and cleared for lists
+    u32 depth;
+    u64 objectBits[JSON_READER_MAX_DEPTH / 64];
+
+    bool failed;
+    json_token error;
+} json_reader;
+
+void json_reader_init(json_reader* reader, oc_str8 contents)
+{
+    memset(reader, 0, sizeof(json_reader));
+    reader->contents = contents;
+    reader->expect = JSON_EXPECT_VALUE;
+}
+
+json_token json_reader_fail(json_reader* reader, u64 offset, const char* message)
+{
+    //NOTE: the error token's string points at the error location
+    reader->error = (json_token){
+        .kind = JSON_TOKEN_ERROR,
+        .string = {
+            .ptr = reader->contents.ptr + offset,
+            .len = (offset < reader->contents.len) ? 1 : 0,
+        },
+        .depth = reader->depth,
+    };
+    reader->failed = true;
+    reader->offset = offset;
+    reader->expect = JSON_EXPECT_NOTHING;
+    oc_log_error("json: %s at offset %llu\n", message, (unsigned long long)offset);
+    return (reader->error);
+}
+
+bool json_reader_in_object(json_reader* reader)
+{
+    u32 level = reader->depth - 1;
+    return ((reader->objectBits[level / 64] >> (level % 64)) & 1);
+}
+
+void json_reader_skip_blanks(json_reader* reader)
+{
+    const char* ptr = reader->contents.ptr;
+    u64 len = reader->contents.len;
+    u64 offset = reader->offset;
+    while(offset < len && (ptr[offset] == ' ' || ptr[offset] == '\n' || ptr[offset] == '\r' || ptr[offset] == '\t'))
+    {
+        offset++;
+    }
+    reader->offset = offset;
+}
+
+//NOTE: offset of the closing quote of a string starting at offset, or contents.len if there is none
+u64 json_reader_scan_string(json_reader* reader, u64 offset, bool* escaped)
+{
+    const u8* ptr = (const u8*)reader->contents.ptr;
+    u64 len = reader->contents.len;
+
+    //NOTE: skip 8 bytes at a time until a word contains a quote, a backslash or a control character
+    const u64 ones = 0x0101010101010101ULL;
+    const u64 highBits = 0x8080808080808080ULL;
+    while(offset + 8 <= len)
+    {
+        u64 word = 0;
+        memcpy(&word, ptr + offset, 8);
+        u64 quotes = word ^ (ones * '"');
+        u64 backslashes = word ^ (ones * '\\');
+        u64 special = ((quotes - ones) & ~quotes)
+                    | ((backslashes - ones) & ~backslashes)
+                    | ((word - ones * 0x20) & ~word);
+        if(special & highBits)
+        {
+            break;
+        }
+        offset += 8;
+    }
+
+    while(offset < len)
+    {
+        u8 c = ptr[offset];
+        if(c == '"')
+        {
+            return (offset);
+        }
+        else if(c == '\\')
+        {
+            *escaped = true;
+            offset += 2;
+        }
+        else
+        {
+            offset++;
+        }
+    }
+    return (len);
+}
+
+bool json_check_escapes(oc_str8 string)
+{
+    for(u64 offset = 0; offset < string.len; offset++)
+    {
+        if(string.ptr[offset] == '\\')
+        {
+            offset++;
+            switch(string.ptr[offset])
+            {
+                case 'b':
+                case 'f':
+                case 'n':
+                case 'r':
+                case 't':
+                case '"':
+                case '\\':
+                case '/':
+                    break;
+                case 'u':
+                {
+                    if(offset + 4 >= string.len)
+                    {
+                        return (false);
+                    }
+                    for(int i = 1; i <= 4; i++)
+                    {
+                        char c = string.ptr[offset + i];
+                        if(!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')))
+                        {
+                            return (false);
+                        }
+                    }
+                    offset += 4;
+                }
+                break;
+                default:
+                    return (false);
+            }
+        }
+    }
+    return (true);
+}
+
+static const f64 JSON_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+json_token json_reader_number(json_reader* reader)
+{
+    const char* ptr = reader->contents.ptr;
+    u64 len = reader->contents.len;
+    u64 start = reader->offset;
+    u64 offset = start;
+
+    json_token token = { .kind = JSON_TOKEN_NUM_I64, .depth = reader->depth };
+
+    bool minus = false;
+    if(ptr[offset] == '-')
+    {
+        minus = true;
+        offset++;
+    }
+
+    u64 mantissa = 0;
+    u32 digitCount = 0;
+    i32 exponent = 0;
+
+    u64 intStart = offset;
+    while(offset < len && ptr[offset] >= '0' && ptr[offset] <= '9')
+    {
+        if(digitCount < 19)
+        {
+            mantissa = mantissa * 10 + (ptr[offset] - '0');
+            digitCount += (mantissa != 0) ? 1 : 0;
+        }
+        else
+        {
+            exponent++;
+        }
+        offset++;
+    }
+    if(offset == intStart || (ptr[intStart] == '0' && offset - intStart > 1))
+    {
+        return (json_reader_fail(reader, intStart, "invalid number"));
+    }
+
+    if(offset < len && ptr[offset] == '.')
+    {
+        token.kind = JSON_TOKEN_NUM_F64;
+        offset++;
+        u64 fracStart = offset;
+        while(offset < len && ptr[offset] >= '0' && ptr[offset] <= '9')
+        {
+            if(digitCount < 19)
+            {
+                mantissa = mantissa * 10 + (ptr[offset] - '0');
+                digitCount += (mantissa != 0) ? 1 : 0;
+                exponent--;
+            }
+            offset++;
+        }
+        if(offset == fracStart)
+        {
+            return (json_reader_fail(reader, offset, "invalid number"));
+        }
+    }
+
+    if(offset < len && (ptr[offset] == 'e' || ptr[offset] == 'E'))
+    {
+        token.kind = JSON_TOKEN_NUM_F64;
+        offset++;
+        bool expMinus = false;
+        if(offset < len && (ptr[offset] == '-' || ptr[offset] == '+'))
+        {
+            expMinus = (ptr[offset] == '-');
+            offset++;
+        }
+        u64 expStart = offset;
+        i32 explicitExponent = 0;
+        while(offset < len && ptr[offset] >= '0' && ptr[offset] <= '9')
+        {
+            if(explicitExponent < 100000)
+            {
+                explicitExponent = explicitExponent * 10 + (ptr[offset] - '0');
+            }
+            offset++;
+        }
+        if(offset == expStart)
+        {
+            return (json_reader_fail(reader, offset, "invalid number"));
+        }
+        exponent += expMinus ? -explicitExponent : explicitExponent;
+    }
+
+    token.string = oc_str8_slice(reader->contents, start, offset);
+    reader->offset = offset;
+
+    if(token.kind == JSON_TOKEN_NUM_I64 && digitCount < 19)
+    {
+        token.numI64 = minus ? -(i64)mantissa : (i64)mantissa;
+        token.numF64 = (f64)token.numI64;
+    }
+    else
+    {
+        token.kind = JSON_TOKEN_NUM_F64;
+
+        //NOTE: the result is exact when the mantissa and the power of ten are exactly representable. Otherwise
+        //      fall back to strtod().
+        if(mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22)
+        {
+            token.numF64 = (exponent < 0) ? (f64)mantissa / JSON_POWERS_OF_TEN[-exponent]
+                                          : (f64)mantissa * JSON_POWERS_OF_TEN[exponent];
+            if(minus)
+            {
+                token.numF64 = -token.numF64;
+            }
+        }
+        else
+        {
+            oc_scratch scratch = oc_scratch_begin();
+            token.numF64 = strtod(oc_str8_push_copy(scratch.allocator, token.string).ptr, 0);
+            oc_scratch_end(scratch);
+        }
+        token.numI64 = (i64)token.numF64;
+    }
+    return (token);
+}
+
+json_token json_reader_value(json_reader* reader)
+{
+    const char* ptr = reader->contents.ptr;
+    u64 len = reader->contents.len;
+    u64 offset = reader->offset;
+    json_token token = { .depth = reader->depth };
+
+    if(offset >= len)
+    {
+        return (json_reader_fail(reader, offset, "unexpected end of input"));
+    }
+
+    char c = ptr[offset];
+    switch(c)
+    {
+        case '{':
+        case '[':
+        {
+            if(reader->depth >= JSON_READER_MAX_DEPTH)
+            {
+                return (json_reader_fail(reader, offset, "nesting too deep"));
+            }
+            u32 level = reader->depth;
+            if(c == '{')
+            {
+                reader->objectBits[level / 64] |= (1ULL << (level % 64));
+                reader->expect = JSON_EXPECT_KEY_OR_OBJECT_END;
+                token.kind = JSON_TOKEN_OBJECT_BEGIN;
+            }
+            else
+            {
+                reader->objectBits[level / 64] &= ~(1ULL << (level % 64));
+                reader->expect = JSON_EXPECT_VALUE_OR_LIST_END;
+                token.kind = JSON_TOKEN_LIST_BEGIN;
+            }
+            reader->depth++;
+            token.string = oc_str8_slice(reader->contents, offset, offset + 1);
+            reader->offset = offset + 1;
+            return (token);
+        }
+
+        case '"':
+        {
+            u64 end = json_reader_scan_string(reader, offset + 1, &token.escaped);
+            if(end >= len)
+            {
+                return (json_reader_fail(reader, offset, "unterminated string"));
+            }
+            token.kind = JSON_TOKEN_STRING;
+            token.string = oc_str8_slice(reader->contents, offset + 1, end);
+            if(token.escaped && !json_check_escapes(token.string))
+            {
+                return (json_reader_fail(reader, offset, "invalid escape sequence"));
+            }
+            reader->offset = end + 1;
+        }
+        break;
+
+        case 't':
+        case 'f':
+        case 'n':
+        {
+            u64 rem = len - offset;
+            if(rem >= 4 && !memcmp(ptr + offset, "true", 4))
+            {
+                token.kind = JSON_TOKEN_TRUE;
+                token.string = oc_str8_slice(reader->contents, offset, offset + 4);
+            }
+            else if(rem >= 5 && !memcmp(ptr + offset, "false", 5))
+            {
+                token.kind = JSON_TOKEN_FALSE;
+                token.string = oc_str8_slice(reader->contents, offset, offset + 5);
+            }
+            else if(rem >= 4 && !memcmp(ptr + offset, "null", 4))
+            {
+                token.kind = JSON_TOKEN_NULL;
+                token.string = oc_str8_slice(reader->contents, offset, offset + 4);
+            }
+            else
+            {
+                return (json_reader_fail(reader, offset, "unexpected character"));
+            }
+            reader->offset = offset + token.string.len;
+        }
+        break;
+
+        default:
+        {
+            if(c == '-' || (c >= '0' && c <= '9'))
+            {
+                token = json_reader_number(reader);
+                if(token.kind == JSON_TOKEN_ERROR)
+                {
+                    return (token);
+                }
+            }
+            else
+            {
+                return (json_reader_fail(reader, offset, "unexpected character"));
+            }
+        }
+        break;
+    }
+
+    reader->expect = reader->depth ? JSON_EXPECT_COMMA_OR_END : JSON_EXPECT_EOF;
+    return (token);
+}
+
+json_token json_reader_end_container(json_reader* reader, char c)
+{
+    bool inObject = json_reader_in_object(reader);
+    if((c == '}') != inObject)
+    {
+        return (json_reader_fail(reader, reader->offset, "mismatched closing bracket"));
+    }
+    reader->depth--;
+    json_token token = {
+        .kind = inObject ? JSON_TOKEN_OBJECT_END : JSON_TOKEN_LIST_END,
+        .string = oc_str8_slice(reader->contents, reader->offset, reader->offset + 1),
+        .depth = reader->depth,
+    };
+    reader->offset++;
+    reader->expect = reader->depth ? JSON_EXPECT_COMMA_OR_END : JSON_EXPECT_EOF;
+    return (token);
+}
+
+json_token json_reader_key(json_reader* reader)
+{
+    u64 offset = reader->offset;
+    if(offset >= reader->contents.len || reader->contents.ptr[offset] != '"')
+    {
+        return (json_reader_fail(reader, offset, "expected a key"));
+    }
+
+    json_token token = { .kind = JSON_TOKEN_KEY, .depth = reader->depth };
+    u64 end = json_reader_scan_string(reader, offset + 1, &token.escaped);
+    if(end >= reader->contents.len)
+    {
+        return (json_reader_fail(reader, offset, "unterminated string"));
+    }
+    token.string = oc_str8_slice(reader->contents, offset + 1, end);
+    if(token.escaped && !json_check_escapes(token.string))
+    {
+        return (json_reader_fail(reader, offset, "invalid escape sequence"));
+    }
+
+    reader->offset = end + 1;
+    json_reader_skip_blanks(reader);
+    if(reader->offset >= reader->contents.len || reader->contents.ptr[reader->offset] != ':')
+    {
+        return (json_reader_fail(reader, reader->offset, "expected a colon"));
+    }
+    reader->offset++;
+    reader->expect = JSON_EXPECT_VALUE;
+    return (token);
+}
+
+json_token json_reader_next(json_reader* reader)
+{
+    json_reader_skip_blanks(reader);
+
+    const char* ptr = reader->contents.ptr;
+    u64 len = reader->contents.len;
+    char c = (reader->offset < len) ? ptr[reader->offset] : '\0';
+
+    switch(reader->expect)
+    {
+        case JSON_EXPECT_VALUE:
+            return (json_reader_value(reader));
+
+        case JSON_EXPECT_VALUE_OR_LIST_END:
+            if(c == ']')
+            {
+                return (json_reader_end_container(reader, c));
+            }
+            return (json_reader_value(reader));
+
+        case JSON_EXPECT_KEY:
+            return (json_reader_key(reader));
+
+        case JSON_EXPECT_KEY_OR_OBJECT_END:
+            if(c == '}')
+            {
+                return (json_reader_end_container(reader, c));
+            }
+            return (json_reader_key(reader));
+
+        case JSON_EXPECT_COMMA_OR_END:
+            if(c == ',')
+            {
+                reader->offset++;
+                json_reader_skip_blanks(reader);
+                if(json_reader_in_object(reader))
+                {
+                    return (json_reader_key(reader));
+                }
+                return (json_reader_value(reader));
+            }
+            else if(c == '}' || c == ']')
+            {
+                return (json_reader_end_container(reader, c));
+            }
+            return (json_reader_fail(reader, reader->offset, "expected a comma or a closing bracket"));
+
+        case JSON_EXPECT_EOF:
+            if(reader->offset < len)
+            {
+                return (json_reader_fail(reader, reader->offset, "unexpected characters after the end of the document"));
+            }
+            reader->expect = JSON_EXPECT_NOTHING;
+            return ((json_token){
+                .kind = JSON_TOKEN_END,
+                .string = { .ptr = (char*)ptr + len, .len = 0 },
+            });
+
+        case JSON_EXPECT_NOTHING:
+        default:
+            break;
+    }
+    //NOTE: after the end of the document, keep returning the end token, or the error token
+    if(reader->failed)
+    {
+        return (reader->error);
+    }
+    return ((json_token){ .kind = JSON_TOKEN_END, .string = { .ptr = (char*)ptr + len, .len = 0 } });
+}
+
+//NOTE: skip the value started by token, ie. if token begins an object or a list, read up to its end token
+json_token json_reader_skip(json_reader* reader, json_token token)
+{
+    if(token.kind == JSON_TOKEN_OBJECT_BEGIN || token.kind == JSON_TOKEN_LIST_BEGIN)
+    {
+        u32 depth = token.depth;
+        do
+        {
+            token = json_reader_next(reader);
+        }
+        while(token.kind != JSON_TOKEN_ERROR && reader->depth > depth);
+    }
+    return (token);
+}
+
+//------------------------------------------------------------------------
+// Flat document
+//------------------------------------------------------------------------
+/*NOTE:
+    json_doc stores a whole document in a single array of values, in document order. The value at index 0 is the
+    root, and the descendants of a value are stored right after it, up to its end index. Strings and keys point
+    into the input when they have no escape sequence, so the input must outlive the document.
+
+    Iterate over the children of value i with json_doc_for(doc, i, child).
+*/
+
+typedef struct json_value
+{
+    json_node_kind kind;
+    u32 end; // index of the first value after this value's descendants
+    u32 childCount;
+    u32 keyHash;
+    oc_str8 key;
+
+    union
+    {
+        oc_str8 string;
+
+        struct
+        {
+            f64 numF64;
+            i64 numI64;
+        };
+    };
+
+} json_value;
+
+typedef struct json_doc
+{
+    u32 count;
+    u32 cap;
+    json_value* values;
+} json_doc;
+
+#define json_doc_for(doc, parent, child) \
+    for(u32 child = (parent) + 1; child < (doc)->values[(parent)].end; child = (doc)->values[child].end)
+
+json_value* json_doc_push(oc_allocator* allocator, json_doc* doc)
+{
+    if(doc->count >= doc->cap)
+    {
+        u32 cap = doc->cap ? doc->cap + doc->cap / 2 : 64;
+        json_value* values = oc_allocator_push_array(allocator, json_value, cap);
+        if(doc->count)
+        {
+            memcpy(values, doc->values, doc->count * sizeof(json_value));
+        }
+        doc->values = values;
+        doc->cap = cap;
+    }
+    json_value* value = &doc->values[doc->count];
+    doc->count++;
+    memset(value, 0, sizeof(json_value));
+    return (value);
+}
+
+oc_str8 json_token_string(oc_allocator* allocator, json_token* token)
+{
+    return (token->escaped ? json_convert_escaped_string(allocator, token->string) : token->string);
+}
+
+//NOTE: returns a document with no values if the input is not valid
+json_doc json_doc_parse(oc_allocator* allocator, oc_str8 string)
+{
+    json_doc doc = { 0 };
+
+    //NOTE: reserve about one value per 16 bytes of input, to avoid growing too often
+    doc.cap = oc_clamp(string.len / 16, 64, UINT32_MAX / 2);
+    doc.values = oc_allocator_push_array(allocator, json_value, doc.cap);
+
+    json_reader reader;
+    json_reader_init(&reader, string);
+
+    u32 stack[JSON_READER_MAX_DEPTH];
+    u32 depth = 0;
+    oc_str8 key = { 0 };
+    u32 keyHash = 0;
+
+    while(true)
+    {
+        json_token token = json_reader_next(&reader);
+        if(token.kind == JSON_TOKEN_END)
+        {
+            break;
+        }
+        else if(token.kind == JSON_TOKEN_ERROR)
+        {
+            doc.count = 0;
+            break;
+        }
+        else if(token.kind == JSON_TOKEN_KEY)
+        {
+            key = json_token_string(allocator, &token);
+            keyHash = (u32)oc_hash_xxh3_string(key);
+        }
+        else if(token.kind == JSON_TOKEN_OBJECT_END || token.kind == JSON_TOKEN_LIST_END)
+        {
+            depth--;
+            doc.values[stack[depth]].end = doc.count;
+        }
+        else
+        {
+            u32 index = doc.count;
+            json_value* value = json_doc_push(allocator, &doc);
+            value->end = index + 1;
+            value->key = key;
+            value->keyHash = keyHash;
+            key = (oc_str8){ 0 };
+            keyHash = 0;
+
+            if(depth)
+            {
+                doc.values[stack[depth - 1]].childCount++;
+            }
+
+            switch(token.kind)
+            {
+                case JSON_TOKEN_OBJECT_BEGIN:
+                    value->kind = JSON_OBJECT;
+                    stack[depth++] = index;
+                    break;
+                case JSON_TOKEN_LIST_BEGIN:
+                    value->kind = JSON_LIST;
+                    stack[depth++] = index;
+                    break;
+                case JSON_TOKEN_STRING:
+                    value->kind = JSON_STRING;
+                    value->string = json_token_string(allocator, &token);
+                    break;
+                case JSON_TOKEN_NUM_F64:
+                    value->kind = JSON_NUM_F64;
+                    value->numF64 = token.numF64;
+                    value->numI64 = token.numI64;
+                    break;
+                case JSON_TOKEN_NUM_I64:
+                    value->kind = JSON_NUM_I64;
+                    value->numF64 = token.numF64;
+                    value->numI64 = token.numI64;
+                    break;
+                case JSON_TOKEN_TRUE:
+                    value->kind = JSON_TRUE;
+                    break;
+                case JSON_TOKEN_FALSE:
+                    value->kind = JSON_FALSE;
+                    break;
+                default:
+                    value->kind = JSON_NULL;
+                    break;
+            }
+        }
+    }
+    return (doc);
+}
+
+//NOTE: returns the index of the child of object with the given key, or 0 if there is none
+u32 json_doc_find(json_doc* doc, u32 object, oc_str8 key)
+{
+    if(object < doc->count && doc->values[object].kind == JSON_OBJECT)
+    {
+        u32 hash = (u32)oc_hash_xxh3_string(key);
+        json_doc_for(doc, object, child)
+        {
+            json_value* value = &doc->values[child];
+            if(value->keyHash == hash && !oc_str8_cmp(value->key, key))
+            {
+                return (child);
+            }
+        }
+    }
+    return (0);
+}
@@ -10,6 +10,14 @@
 #include "platform/platform.h"
 #include "platform/platform_memory.h"
 
+#if !OC_PLATFORM_ORCA
+    #include "platform/platform_thread.h"
+#endif
+
+#if OC_COMPILER_CL
+    #include <intrin.h>
+#endif
+
 //--------------------------------------------------------------------------------
 //NOTE(martin): allocator interface
 //--------------------------------------------------------------------------------
@@ -283,3 +291,441 @@ void oc_scratch_end(oc_scratch scope)
     scope.arena->currentChunk = scope.chunk;
     scope.arena->currentChunk->offset = scope.offset;
 }
+
+//--------------------------------------------------------------------------------
+//NOTE: size-class pool allocator
+//--------------------------------------------------------------------------------
+/*NOTE:
+    Size classes are multiples of 16 bytes up to 128 bytes, and then 4 classes per power of two, up to
+    OC_POOL_MAX_SIZE, which bounds the space wasted by rounding up a size to its class at 25%. Blocks are carved
+    from slabs that are aligned on the largest power of two dividing the class size, so blocks of power of two
+    classes are aligned on their size. Allocations with an alignment larger than OC_POOL_MIN_ALIGNMENT go in the
+    smallest power of two class that fits their size and alignment.
+
+    Each class carves its slabs lazily, and slabs double in size, so that rarely used classes don't reserve much.
+
+    In OC_DEBUG builds, blocks that aren't allocated are always filled with OC_POOL_POISON_FREE, apart from their
+    free list link, and allocated blocks are filled with OC_POOL_POISON_ALLOC.
+*/
+
+enum
+{
+    OC_POOL_SMALL_CLASS_COUNT = 8, // classes of 16 to 128 bytes, in steps of 16
+    OC_POOL_SLAB_MIN_SIZE = 4 << 10,
+    OC_POOL_SLAB_MAX_SIZE = 64 << 10,
+    OC_POOL_SLAB_MIN_BLOCKS = 4,
+    OC_POOL_CACHE_MIN_BATCH = 4,
+    OC_POOL_CACHE_MAX_BATCH = 32,
+    OC_POOL_POISON_FREE = 0xdd,
+    OC_POOL_POISON_ALLOC = 0xcd,
+};
+
+typedef struct oc_pool_large_header
+{
+    oc_list_links listElt;
+    char* mem;
+    u64 size;
+} oc_pool_large_header;
+
+static inline u32 oc_pool_msb(u64 x)
+{
+#if OC_COMPILER_CL
+    unsigned long index = 0;
+    _BitScanReverse64(&index, x);
+    return (index);
+#else
+    return (63 - __builtin_clzll(x));
+#endif
+}
+
+static u32 oc_pool_class_index(u64 size, u64 alignment)
+{
+    if(alignment > OC_POOL_MIN_ALIGNMENT)
+    {
+        size = oc_max(size, alignment);
+        size = (size > 1) ? (2ULL << oc_pool_msb(size - 1)) : 1;
+    }
+    if(size > OC_POOL_MAX_SIZE)
+    {
+        return (OC_POOL_SIZE_CLASS_COUNT);
+    }
+    else if(size <= OC_POOL_SMALL_CLASS_COUNT * 16)
+    {
+        return ((oc_max(size, 1) - 1) / 16);
+    }
+    else
+    {
+        u64 s = size - 1;
+        u32 msb = oc_pool_msb(s);
+        return (OC_POOL_SMALL_CLASS_COUNT + (msb - 7) * 4 + ((s >> (msb - 2)) & 3));
+    }
+}
+
+static u64 oc_pool_class_size(u32 index)
+{
+    if(index < OC_POOL_SMALL_CLASS_COUNT)
+    {
+        return ((index + 1) * 16);
+    }
+    else
+    {
+        u32 msb = 7 + (index - OC_POOL_SMALL_CLASS_COUNT) / 4;
+        u32 sub = (index - OC_POOL_SMALL_CLASS_COUNT) % 4;
+        return ((u64)(5 + sub) << (msb - 2));
+    }
+}
+
+static void oc_pool_lock(oc_pool* pool)
+{
+#if !OC_PLATFORM_ORCA
+    if(pool->mutex)
+    {
+        oc_mutex_lock(pool->mutex);
+    }
+#endif
+}
+
+static void oc_pool_unlock(oc_pool* pool)
+{
+#if !OC_PLATFORM_ORCA
+    if(pool->mutex)
+    {
+        oc_mutex_unlock(pool->mutex);
+    }
+#endif
+}
+
+static void oc_pool_poison_free(oc_pool_block* block, u64 blockSize)
+{
+#ifdef OC_DEBUG
+    memset(block, OC_POOL_POISON_FREE, blockSize);
+#endif
+}
+
+static void oc_pool_poison_alloc(oc_pool_block* block, u64 blockSize)
+{
+#ifdef OC_DEBUG
+    char* bytes = (char*)block;
+    for(u64 i = sizeof(oc_pool_block); i < blockSize; i++)
+    {
+        if((u8)bytes[i] != OC_POOL_POISON_FREE)
+        {
+            OC_ABORT("pool block %p of size %llu was written to at offset %llu after being freed",
+                     block,
+                     (unsigned long long)blockSize,
+                     (unsigned long long)i);
+        }
+    }
+    memset(block, OC_POOL_POISON_ALLOC, blockSize);
+#endif
+}
+
+//NOTE: pops a free block of a class, carving a new slab if needed. The pool must be locked.
+static oc_pool_block* oc_pool_class_pop(oc_pool* pool, u32 index)
+{
+    oc_pool_class* sizeClass = &pool->classes[index];
+    u64 blockSize = oc_pool_class_size(index);
+
+    oc_pool_block* block = sizeClass->freeList;
+    if(block)
+    {
+        sizeClass->freeList = block->next;
+    }
+    else
+    {
+        if((u64)(sizeClass->slabEnd - sizeClass->slabPtr) < blockSize)
+        {
+            sizeClass->slabSize = sizeClass->slabSize ? oc_min(sizeClass->slabSize * 2, OC_POOL_SLAB_MAX_SIZE) : OC_POOL_SLAB_MIN_SIZE;
+            u64 blockCount = oc_max(sizeClass->slabSize / blockSize, OC_POOL_SLAB_MIN_BLOCKS);
+            u64 slabSize = blockCount * blockSize;
+
+            //NOTE: align the slab on the largest power of two dividing the block size
+            sizeClass->slabPtr = oc_arena_push_aligned_uninitialized(&pool->arena, slabSize, blockSize & (~blockSize + 1));
+            sizeClass->slabEnd = sizeClass->slabPtr + slabSize;
+            pool->slabSize += slabSize;
+        }
+        block = (oc_pool_block*)sizeClass->slabPtr;
+        sizeClass->slabPtr += blockSize;
+
+        oc_pool_poison_free(block, blockSize);
+    }
+    pool->blockSize += blockSize;
+    return (block);
+}
+
+//NOTE: pushes a block on the free list of a class. The pool must be locked.
+static void oc_pool_class_push(oc_pool* pool, u32 index, oc_pool_block* block)
+{
+    oc_pool_class* sizeClass = &pool->classes[index];
+    block->next = sizeClass->freeList;
+    sizeClass->freeList = block;
+    pool->blockSize -= oc_pool_class_size(index);
+}
+
+static void* oc_pool_large_push(oc_pool* pool, u64 size, u64 alignment)
+{
+    alignment = oc_max(alignment, OC_POOL_MIN_ALIGNMENT);
+
+    char* mem = malloc(size + alignment + sizeof(oc_pool_large_header));
+    OC_ASSERT(mem, "couldn't allocate memory");
+
+    char* p = (char*)oc_align_up_pow2((u64)(mem + sizeof(oc_pool_large_header)), alignment);
+    oc_pool_large_header* header = (oc_pool_large_header*)(p - sizeof(oc_pool_large_header));
+    header->mem = mem;
+    header->size = size;
+
+    oc_pool_lock(pool);
+    oc_list_push_back(&pool->largeAllocations, &header->listElt);
+    pool->largeSize += size;
+    oc_pool_unlock(pool);
+
+    return (p);
+}
+
+static void oc_pool_large_free(oc_pool* pool, void* ptr)
+{
+    oc_pool_large_header* header = (oc_pool_large_header*)((char*)ptr - sizeof(oc_pool_large_header));
+
+    oc_pool_lock(pool);
+    oc_list_remove(&pool->largeAllocations, &header->listElt);
+    pool->largeSize -= header->size;
+    oc_pool_unlock(pool);
+
+    free(header->mem);
+}
+
+static void* oc_pool_allocator_push(oc_allocator* allocator, u64 size, u64 align)
+{
+    return (oc_pool_push_aligned_uninitialized((oc_pool*)allocator, size, align));
+}
+
+void oc_pool_init(oc_pool* pool)
+{
+    oc_pool_init_with_options(pool, &(oc_pool_options){ 0 });
+}
+
+void oc_pool_init_with_options(oc_pool* pool, oc_pool_options* options)
+{
+    memset(pool, 0, sizeof(oc_pool));
+
+    pool->push = oc_pool_allocator_push;
+    pool->allocator = (oc_allocator*)pool;
+
+    oc_arena_init_with_options(&pool->arena, &(oc_arena_options){ .base = options->base });
+
+#if !OC_PLATFORM_ORCA
+    if(options->threadSafe)
+    {
+        pool->mutex = oc_mutex_create();
+    }
+#endif
+}
+
+void oc_pool_cleanup(oc_pool* pool)
+{
+    oc_list_for_safe(pool->largeAllocations, header, oc_pool_large_header, listElt)
+    {
+        free(header->mem);
+    }
+#if !OC_PLATFORM_ORCA
+    if(pool->mutex)
+    {
+        oc_mutex_destroy(pool->mutex);
+    }
+#endif
+    oc_arena_cleanup(&pool->arena);
+    memset(pool, 0, sizeof(oc_pool));
+}
+
+void* oc_pool_push_aligned_uninitialized(oc_pool* pool, u64 size, u64 alignment)
+{
+    if(!size)
+    {
+        return (0);
+    }
+
+    u32 index = oc_pool_class_index(size, alignment);
+    if(index >= OC_POOL_SIZE_CLASS_COUNT)
+    {
+        return (oc_pool_large_push(pool, size, alignment));
+    }
+
+    oc_pool_lock(pool);
+    oc_pool_block* block = oc_pool_class_pop(pool, index);
+    oc_pool_unlock(pool);
+
+    oc_pool_poison_alloc(block, oc_pool_class_size(index));
+    return (block);
+}
+
+void* oc_pool_push_aligned(oc_pool* pool, u64 size, u64 alignment)
+{
+    void* p = oc_pool_push_aligned_uninitialized(pool, size, alignment);
+    if(size && p)
+    {
+        memset(p, 0, size);
+    }
+    return (p);
+}
+
+void* oc_pool_push_uninitialized(oc_pool* pool, u64 size)
+{
+    return (oc_pool_push_aligned_uninitialized(pool, size, 1));
+}
+
+void* oc_pool_push(oc_pool* pool, u64 size)
+{
+    return (oc_pool_push_aligned(pool, size, 1));
+}
+
+void oc_pool_free_aligned(oc_pool* pool, void* ptr, u64 size, u64 alignment)
+{
+    if(!ptr || !size)
+    {
+        return;
+    }
+
+    u32 index = oc_pool_class_index(size, alignment);
+    if(index >= OC_POOL_SIZE_CLASS_COUNT)
+    {
+        oc_pool_large_free(pool, ptr);
+        return;
+    }
+
+    oc_pool_poison_free(ptr, oc_pool_class_size(index));
+
+    oc_pool_lock(pool);
+    oc_pool_class_push(pool, index, (oc_pool_block*)ptr);
+    oc_pool_unlock(pool);
+}
+
+void oc_pool_free(oc_pool* pool, void* ptr, u64 size)
+{
+    oc_pool_free_aligned(pool, ptr, size, 1);
+}
+
+//NOTE: pool caches
+
+static u64 oc_pool_cache_batch(u32 index)
+{
+    //NOTE: exchange about 4KB worth of blocks with the pool at a time
+    u64 batch = (4 << 10) / oc_pool_class_size(index);
+    return (oc_clamp(batch, OC_POOL_CACHE_MIN_BATCH, OC_POOL_CACHE_MAX_BATCH));
+}
+
+static void* oc_pool_cache_allocator_push(oc_allocator* allocator, u64 size, u64 align)
+{
+    return (oc_pool_cache_push_aligned_uninitialized((oc_pool_cache*)allocator, size, align));
+}
+
+void oc_pool_cache_init(oc_pool_cache* cache, oc_pool* pool)
+{
+    memset(cache, 0, sizeof(oc_pool_cache));
+    cache->push = oc_pool_cache_allocator_push;
+    cache->allocator = (oc_allocator*)cache;
+    cache->pool = pool;
+}
+
+void oc_pool_cache_flush(oc_pool_cache* cache)
+{
+    oc_pool_lock(cache->pool);
+    for(u32 index = 0; index < OC_POOL_SIZE_CLASS_COUNT; index++)
+    {
+        oc_pool_cache_class* sizeClass = &cache->classes[index];
+        while(sizeClass->freeList)
+        {
+            oc_pool_block* block = sizeClass->freeList;
+            sizeClass->freeList = block->next;
+            oc_pool_class_push(cache->pool, index, block);
+        }
+        sizeClass->count = 0;
+    }
+    oc_pool_unlock(cache->pool);
+}
+
+void* oc_pool_cache_push_aligned_uninitialized(oc_pool_cache* cache, u64 size, u64 alignment)
+{
+    if(!size)
+    {
+        return (0);
+    }
+
+    u32 index = oc_pool_class_index(size, alignment);
+    if(index >= OC_POOL_SIZE_CLASS_COUNT)
+    {
+        return (oc_pool_large_push(cache->pool, size, alignment));
+    }
+
+    oc_pool_cache_class* sizeClass = &cache->classes[index];
+    if(!sizeClass->freeList)
+    {
+        u64 batch = oc_pool_cache_batch(index);
+
+        oc_pool_lock(cache->pool);
+        for(u64 i = 0; i < batch; i++)
+        {
+            oc_pool_block* block = oc_pool_class_pop(cache->pool, index);
+            block->next = sizeClass->freeList;
+            sizeClass->freeList = block;
+        }
+        oc_pool_unlock(cache->pool);
+
+        sizeClass->count = batch;
+    }
+
+    oc_pool_block* block = sizeClass->freeList;
+    sizeClass->freeList = block->next;
+    sizeClass->count--;
+
+    oc_pool_poison_alloc(block, oc_pool_class_size(index));
+    return (block);
+}
+
+void* oc_pool_cache_push_aligned(oc_pool_cache* cache, u64 size, u64 alignment)
+{
+    void* p = oc_pool_cache_push_aligned_uninitialized(cache, size, alignment);
+    if(size && p)
+    {
+        memset(p, 0, size);
+    }
+    return (p);
+}
+
+void oc_pool_cache_free_aligned(oc_pool_cache* cache, void* ptr, u64 size, u64 alignment)
+{
+    if(!ptr || !size)
+    {
+        return;
+    }
+
+    u32 index = oc_pool_class_index(size, alignment);
+    if(index >= OC_POOL_SIZE_CLASS_COUNT)
+    {
+        oc_pool_large_free(cache->pool, ptr);
+        return;
+    }
+
+    oc_pool_poison_free(ptr, oc_pool_class_size(index));
+
+    oc_pool_cache_class* sizeClass = &cache->classes[index];
+    oc_pool_block* block = (oc_pool_block*)ptr;
+    block->next = sizeClass->freeList;
+    sizeClass->freeList = block;
+    sizeClass->count++;
+
+    //NOTE: give a batch of blocks back to the pool when the cache holds two batches
+    u64 batch = oc_pool_cache_batch(index);
+    if(sizeClass->count > 2 * batch)
+    {
+        oc_pool_lock(cache->pool);
+        for(u64 i = 0; i < batch; i++)
+        {
+            block = sizeClass->freeList;
+            sizeClass->freeList = block->next;
+            oc_pool_class_push(cache->pool, index, block);
+        }
+        oc_pool_unlock(cache->pool);
+
+        sizeClass->count -= batch;
+    }
+}
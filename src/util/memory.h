@@ -104,6 +104,114 @@ ORCA_API oc_scratch oc_scratch_begin_next_arena(oc_arena* used);
 
 ORCA_API void oc_scratch_end(oc_scratch scratch);
 
+//--------------------------------------------------------------------------------
+//NOTE: size-class pool allocator
+//--------------------------------------------------------------------------------
+/*NOTE:
+    oc_pool hands out blocks from a set of size classes, and keeps a free list per class, so that structures with a
+    lot of churn can free and reuse memory without writing their own free lists. Blocks are carved from slabs pushed
+    on an arena, and are only given back to the system when the pool is cleaned up.
+
+    oc_pool implements the oc_allocator interface, so it can be passed to functions taking an oc_allocator*. Frees
+    are sized: blocks have no header, so oc_pool_free() must be passed the size (and alignment) used to allocate the
+    block. Allocations larger than OC_POOL_MAX_SIZE are malloc'ed and freed individually.
+
+    A pool is not thread-safe unless it is initialized with the threadSafe option. Threads sharing a pool can each
+    use an oc_pool_cache, which keeps a few free blocks per size class and only locks the pool to exchange blocks
+    with it in batches.
+
+    In OC_DEBUG builds, freed blocks are filled with a poison pattern, which is checked when the block is reused, to
+    catch writes through dangling pointers, and new blocks are filled with a different pattern.
+*/
+
+enum
+{
+    OC_POOL_SIZE_CLASS_COUNT = 32,
+    OC_POOL_MAX_SIZE = 8 << 10,
+    OC_POOL_MIN_ALIGNMENT = 16,
+};
+
+typedef struct oc_pool_block
+{
+    struct oc_pool_block* next;
+} oc_pool_block;
+
+typedef struct oc_pool_class
+{
+    oc_pool_block* freeList;
+    char* slabPtr; // part of the current slab that hasn't been carved into blocks yet
+    char* slabEnd;
+    u64 slabSize;
+} oc_pool_class;
+
+typedef struct oc_mutex oc_mutex;
+
+typedef struct oc_pool_options
+{
+    oc_platform_memory* base;
+    bool threadSafe;
+} oc_pool_options;
+
+typedef struct oc_pool
+{
+    oc_allocator_push_proc push;
+    oc_allocator* allocator;
+
+    oc_arena arena;
+    oc_mutex* mutex;
+    oc_pool_class classes[OC_POOL_SIZE_CLASS_COUNT];
+
+    oc_list largeAllocations;
+
+    u64 slabSize;  // total size of the slabs pushed on the arena
+    u64 blockSize; // total size of the blocks currently allocated, including blocks held by caches
+    u64 largeSize; // total size of the allocations larger than OC_POOL_MAX_SIZE
+
+} oc_pool;
+
+ORCA_API void oc_pool_init(oc_pool* pool);
+ORCA_API void oc_pool_init_with_options(oc_pool* pool, oc_pool_options* options);
+ORCA_API void oc_pool_cleanup(oc_pool* pool);
+
+ORCA_API void* oc_pool_push(oc_pool* pool, u64 size);
+ORCA_API void* oc_pool_push_aligned(oc_pool* pool, u64 size, u64 alignment);
+ORCA_API void* oc_pool_push_uninitialized(oc_pool* pool, u64 size);
+ORCA_API void* oc_pool_push_aligned_uninitialized(oc_pool* pool, u64 size, u64 alignment);
+
+ORCA_API void oc_pool_free(oc_pool* pool, void* ptr, u64 size);
+ORCA_API void oc_pool_free_aligned(oc_pool* pool, void* ptr, u64 size, u64 alignment);
+
+#define oc_pool_push_type(pool, type) ((type*)oc_pool_push_aligned(pool, sizeof(type), _Alignof(type)))
+#define oc_pool_push_array(pool, type, count) ((type*)oc_pool_push_aligned(pool, sizeof(type) * (count), _Alignof(type)))
+#define oc_pool_free_type(pool, ptr, type) oc_pool_free_aligned(pool, ptr, sizeof(type), _Alignof(type))
+#define oc_pool_free_array(pool, ptr, type, count) oc_pool_free_aligned(pool, ptr, sizeof(type) * (count), _Alignof(type))
+
+typedef struct oc_pool_cache_class
+{
+    oc_pool_block* freeList;
+    u64 count;
+} oc_pool_cache_class;
+
+typedef struct oc_pool_cache
+{
+    oc_allocator_push_proc push;
+    oc_allocator* allocator;
+
+    oc_pool* pool;
+    oc_pool_cache_class classes[OC_POOL_SIZE_CLASS_COUNT];
+
+} oc_pool_cache;
+
+ORCA_API void oc_pool_cache_init(oc_pool_cache* cache, oc_pool* pool);
+ORCA_API void oc_pool_cache_flush(oc_pool_cache* cache); //NOTE: gives all cached blocks back to the pool
+
+ORCA_API void* oc_pool_cache_push_aligned(oc_pool_cache* cache, u64 size, u64 alignment);
+ORCA_API void* oc_pool_cache_push_aligned_uninitialized(oc_pool_cache* cache, u64 size, u64 alignment);
+ORCA_API void oc_pool_cache_free_aligned(oc_pool_cache* cache, void* ptr, u64 size, u64 alignment);
+
+#define oc_pool_cache_push_type(cache, type) ((type*)oc_pool_cache_push_aligned(cache, sizeof(type), _Alignof(type)))
+#define oc_pool_cache_free_type(cache, ptr, type) oc_pool_cache_free_aligned(cache, ptr, sizeof(type), _Alignof(type))
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -131,7 +131,7 @@ oc_str8 oc_str8_list_pop_back(oc_str8_list* list)
     oc_str8_elt* elt = oc_typed_list_pop_back(&list->list);
     if(elt)
     {
-        OC_DEBUG_ASSERT(elt->string.len < list->len);
+        OC_DEBUG_ASSERT(elt->string.len <= list->len);
         list->len -= elt->string.len;
         string = elt->string;
     }
@@ -153,7 +153,7 @@ oc_str8 oc_str8_list_pop_front(oc_str8_list* list)
     oc_str8_elt* elt = oc_typed_list_pop_front(&list->list);
     if(elt)
     {
-        OC_DEBUG_ASSERT(elt->string.len < list->len);
+        OC_DEBUG_ASSERT(elt->string.len <= list->len);
         list->len -= elt->string.len;
         string = elt->string;
     }
@@ -175,7 +175,7 @@ oc_str8 oc_str8_list_collate(oc_allocator* allocator, oc_str8_list list, oc_str8
     str.len = prefix.len + list.len + postfix.len;
     if(oc_typed_list_count(list.list) && separator.len)
     {
-        str.len += oc_typed_list_count(list.list) * separator.len - 1;
+        str.len += (oc_typed_list_count(list.list) - 1) * separator.len;
     }
 
     str.ptr = oc_allocator_push_array(allocator, char, str.len + 1);
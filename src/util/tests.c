@@ -211,3 +211,23 @@ void oc_test_summary(oc_test_info* info)
            info->totalFailed,
            info->totalPassed + info->totalSkipped + info->totalFailed);
 }
+
+//NOTE: xorshift32 generator, so that randomized tests run the same sequence from a given seed
+typedef struct oc_test_rng
+{
+    u32 state;
+} oc_test_rng;
+
+oc_test_rng oc_test_rng_seed(u32 seed)
+{
+    //NOTE: xorshift never leaves the zero state
+    return ((oc_test_rng){ .state = seed ? seed : 1 });
+}
+
+u32 oc_test_rng_next(oc_test_rng* rng)
+{
+    rng->state ^= rng->state << 13;
+    rng->state ^= rng->state >> 17;
+    rng->state ^= rng->state << 5;
+    return (rng->state);
+}
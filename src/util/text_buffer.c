@@ -0,0 +1,754 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#include <stdlib.h> // realloc, free
+#include <string.h>
+
+#include "text_buffer.h"
+#include "debug.h"
+#include "utf8.h"
+
+enum
+{
+    OC_TEXT_BUFFER_DEFAULT_LEN = 16,
+};
+
+static void* oc_text_buffer_grow(void* array, u64* cap, u64 needed, u64 eltSize)
+{
+    if(needed > *cap)
+    {
+        u64 newCap = oc_max(needed, oc_max(*cap + *cap / 2, OC_TEXT_BUFFER_DEFAULT_LEN));
+        array = realloc(array, newCap * eltSize);
+        OC_ASSERT(array, "failed to grow text buffer");
+        *cap = newCap;
+    }
+    return (array);
+}
+
+//------------------------------------------------------------------------------------------
+// Storage
+//------------------------------------------------------------------------------------------
+
+static void oc_text_storage_append(oc_text_storage* storage, u64 count, oc_utf32* codepoints)
+{
+    if(!count)
+    {
+        return;
+    }
+    storage->text = oc_text_buffer_grow(storage->text, &storage->cap, storage->len + count, sizeof(oc_utf32));
+    memcpy(storage->text + storage->len, codepoints, count * sizeof(oc_utf32));
+
+    for(u64 i = 0; i < count; i++)
+    {
+        if(codepoints[i] == '\n')
+        {
+            storage->newlines = oc_text_buffer_grow(storage->newlines, &storage->newlineCap, storage->newlineCount + 1, sizeof(u64));
+            storage->newlines[storage->newlineCount] = storage->len + i;
+            storage->newlineCount++;
+        }
+    }
+    storage->len += count;
+}
+
+static void oc_text_storage_cleanup(oc_text_storage* storage)
+{
+    free(storage->text);
+    free(storage->newlines);
+    memset(storage, 0, sizeof(oc_text_storage));
+}
+
+//NOTE: index of the first newline at or after offset
+static u64 oc_text_storage_newline_index(oc_text_storage* storage, u64 offset)
+{
+    u64 lo = 0;
+    u64 hi = storage->newlineCount;
+    while(lo < hi)
+    {
+        u64 mid = lo + (hi - lo) / 2;
+        if(storage->newlines[mid] < offset)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return (lo);
+}
+
+static u64 oc_text_storage_count_newlines(oc_text_storage* storage, u64 start, u64 end)
+{
+    if(start >= end || !storage->newlineCount)
+    {
+        return (0);
+    }
+    return (oc_text_storage_newline_index(storage, end) - oc_text_storage_newline_index(storage, start));
+}
+
+//------------------------------------------------------------------------------------------
+// Piece tree
+//------------------------------------------------------------------------------------------
+
+static u32 oc_text_node_alloc(oc_text_buffer* buffer, oc_text_buffer_source source, u64 start, u64 length)
+{
+    u32 index = buffer->freeList;
+    if(index)
+    {
+        buffer->freeList = buffer->nodes[index].left;
+    }
+    else
+    {
+        u64 cap = buffer->nodeCap;
+        buffer->nodes = oc_text_buffer_grow(buffer->nodes, &cap, buffer->nodeCount + 1, sizeof(oc_text_piece_node));
+        buffer->nodeCap = cap;
+        index = buffer->nodeCount;
+        buffer->nodeCount++;
+    }
+
+    //NOTE: xorshift priorities keep the treap balanced in expectation
+    u32 x = buffer->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    buffer->seed = x;
+
+    oc_text_piece_node* node = &buffer->nodes[index];
+    node->left = 0;
+    node->right = 0;
+    node->priority = x;
+    node->source = source;
+    node->start = start;
+    node->length = length;
+    node->lines = oc_text_storage_count_newlines(&buffer->storage[source], start, start + length);
+    node->subtreeLength = node->length;
+    node->subtreeLines = node->lines;
+
+    return (index);
+}
+
+static void oc_text_node_free_tree(oc_text_buffer* buffer, u32 index)
+{
+    if(index)
+    {
+        oc_text_piece_node* node = &buffer->nodes[index];
+        oc_text_node_free_tree(buffer, node->left);
+        oc_text_node_free_tree(buffer, node->right);
+        node->left = buffer->freeList;
+        buffer->freeList = index;
+    }
+}
+
+static void oc_text_node_update(oc_text_buffer* buffer, u32 index)
+{
+    oc_text_piece_node* node = &buffer->nodes[index];
+    oc_text_piece_node* left = &buffer->nodes[node->left];
+    oc_text_piece_node* right = &buffer->nodes[node->right];
+    node->subtreeLength = left->subtreeLength + node->length + right->subtreeLength;
+    node->subtreeLines = left->subtreeLines + node->lines + right->subtreeLines;
+}
+
+static u32 oc_text_node_merge(oc_text_buffer* buffer, u32 a, u32 b)
+{
+    if(!a)
+    {
+        return (b);
+    }
+    if(!b)
+    {
+        return (a);
+    }
+    if(buffer->nodes[a].priority > buffer->nodes[b].priority)
+    {
+        u32 right = oc_text_node_merge(buffer, buffer->nodes[a].right, b);
+        buffer->nodes[a].right = right;
+        oc_text_node_update(buffer, a);
+        return (a);
+    }
+    else
+    {
+        u32 left = oc_text_node_merge(buffer, a, buffer->nodes[b].left);
+        buffer->nodes[b].left = left;
+        oc_text_node_update(buffer, b);
+        return (b);
+    }
+}
+
+//NOTE: splits the tree so that outLeft holds the first 'offset' codepoints. A piece straddling
+//      the split point is cut in two.
+static void oc_text_node_split(oc_text_buffer* buffer, u32 index, u64 offset, u32* outLeft, u32* outRight)
+{
+    if(!index)
+    {
+        *outLeft = 0;
+        *outRight = 0;
+        return;
+    }
+    //NOTE: don't keep node pointers across calls that may allocate
+    u64 leftLength = buffer->nodes[buffer->nodes[index].left].subtreeLength;
+    u64 length = buffer->nodes[index].length;
+
+    if(offset <= leftLength)
+    {
+        u32 left = 0;
+        oc_text_node_split(buffer, buffer->nodes[index].left, offset, outLeft, &left);
+        buffer->nodes[index].left = left;
+        oc_text_node_update(buffer, index);
+        *outRight = index;
+    }
+    else if(offset >= leftLength + length)
+    {
+        u32 right = 0;
+        oc_text_node_split(buffer, buffer->nodes[index].right, offset - leftLength - length, &right, outRight);
+        buffer->nodes[index].right = right;
+        oc_text_node_update(buffer, index);
+        *outLeft = index;
+    }
+    else
+    {
+        u64 cut = offset - leftLength;
+        u32 tail = oc_text_node_alloc(buffer,
+                                      buffer->nodes[index].source,
+                                      buffer->nodes[index].start + cut,
+                                      length - cut);
+
+        oc_text_piece_node* node = &buffer->nodes[index];
+        u32 oldRight = node->right;
+        node->right = 0;
+        node->length = cut;
+        node->lines -= buffer->nodes[tail].lines;
+        oc_text_node_update(buffer, index);
+
+        *outLeft = index;
+        *outRight = oc_text_node_merge(buffer, tail, oldRight);
+    }
+}
+
+static u32 oc_text_node_from_spans(oc_text_buffer* buffer, u64 count, oc_text_span* spans)
+{
+    u32 root = 0;
+    for(u64 i = 0; i < count; i++)
+    {
+        u32 node = oc_text_node_alloc(buffer, spans[i].source, spans[i].start, spans[i].length);
+        root = oc_text_node_merge(buffer, root, node);
+    }
+    return (root);
+}
+
+static void oc_text_node_push_spans(oc_text_buffer* buffer, u32 index)
+{
+    if(index)
+    {
+        oc_text_node_push_spans(buffer, buffer->nodes[index].left);
+
+        buffer->spans = oc_text_buffer_grow(buffer->spans, &buffer->spanCap, buffer->spanCount + 1, sizeof(oc_text_span));
+        oc_text_piece_node* node = &buffer->nodes[index];
+        buffer->spans[buffer->spanCount] = (oc_text_span){
+            .source = node->source,
+            .start = node->start,
+            .length = node->length,
+        };
+        buffer->spanCount++;
+
+        oc_text_node_push_spans(buffer, buffer->nodes[index].right);
+    }
+}
+
+static u64 oc_text_node_copy(oc_text_buffer* buffer, u32 index, u64 start, u64 end, oc_utf32* dst)
+{
+    //NOTE: copies the intersection of [start, end) with the subtree, where offsets are relative to the subtree
+    if(!index || start >= end)
+    {
+        return (0);
+    }
+    oc_text_piece_node* node = &buffer->nodes[index];
+    u64 leftLength = buffer->nodes[node->left].subtreeLength;
+    u64 pieceEnd = leftLength + node->length;
+    u64 written = 0;
+
+    if(start < leftLength)
+    {
+        written += oc_text_node_copy(buffer, node->left, start, oc_min(end, leftLength), dst);
+    }
+
+    u64 copyStart = oc_max(start, leftLength);
+    u64 copyEnd = oc_min(end, pieceEnd);
+    if(copyStart < copyEnd)
+    {
+        oc_utf32* src = buffer->storage[node->source].text + node->start + (copyStart - leftLength);
+        memcpy(dst + written, src, (copyEnd - copyStart) * sizeof(oc_utf32));
+        written += copyEnd - copyStart;
+    }
+
+    if(end > pieceEnd)
+    {
+        written += oc_text_node_copy(buffer, node->right, oc_max(start, pieceEnd) - pieceEnd, end - pieceEnd, dst + written);
+    }
+    return (written);
+}
+
+//------------------------------------------------------------------------------------------
+// Init / cleanup
+//------------------------------------------------------------------------------------------
+
+void oc_text_buffer_init(oc_text_buffer* buffer)
+{
+    memset(buffer, 0, sizeof(oc_text_buffer));
+    buffer->seed = 0x9e3779b9;
+
+    //NOTE: node 0 is the nil node, so that child accesses never need to be checked
+    u64 cap = 0;
+    buffer->nodes = oc_text_buffer_grow(0, &cap, 1, sizeof(oc_text_piece_node));
+    buffer->nodeCap = cap;
+    memset(&buffer->nodes[0], 0, sizeof(oc_text_piece_node));
+    buffer->nodeCount = 1;
+}
+
+void oc_text_buffer_init_from_str32(oc_text_buffer* buffer, oc_str32 codepoints)
+{
+    oc_text_buffer_init(buffer);
+    if(codepoints.len)
+    {
+        oc_text_storage_append(&buffer->storage[OC_TEXT_BUFFER_ORIGINAL], codepoints.len, codepoints.ptr);
+        buffer->root = oc_text_node_alloc(buffer, OC_TEXT_BUFFER_ORIGINAL, 0, codepoints.len);
+    }
+}
+
+void oc_text_buffer_init_from_str8(oc_text_buffer* buffer, oc_str8 string)
+{
+    oc_text_buffer_init(buffer);
+
+    u64 count = oc_utf8_codepoint_count_for_string(string);
+    if(count)
+    {
+        oc_text_storage* storage = &buffer->storage[OC_TEXT_BUFFER_ORIGINAL];
+        storage->text = oc_text_buffer_grow(0, &storage->cap, count, sizeof(oc_utf32));
+        storage->len = oc_utf8_to_codepoints(count, storage->text, string).len;
+
+        for(u64 i = 0; i < storage->len; i++)
+        {
+            if(storage->text[i] == '\n')
+            {
+                storage->newlines = oc_text_buffer_grow(storage->newlines, &storage->newlineCap, storage->newlineCount + 1, sizeof(u64));
+                storage->newlines[storage->newlineCount] = i;
+                storage->newlineCount++;
+            }
+        }
+        buffer->root = oc_text_node_alloc(buffer, OC_TEXT_BUFFER_ORIGINAL, 0, storage->len);
+    }
+}
+
+void oc_text_buffer_cleanup(oc_text_buffer* buffer)
+{
+    oc_text_storage_cleanup(&buffer->storage[OC_TEXT_BUFFER_ORIGINAL]);
+    oc_text_storage_cleanup(&buffer->storage[OC_TEXT_BUFFER_ADD]);
+    free(buffer->nodes);
+    free(buffer->deltas);
+    free(buffer->spans);
+    memset(buffer, 0, sizeof(oc_text_buffer));
+}
+
+//------------------------------------------------------------------------------------------
+// Queries
+//------------------------------------------------------------------------------------------
+
+u64 oc_text_buffer_length(oc_text_buffer* buffer)
+{
+    return (buffer->nodes[buffer->root].subtreeLength);
+}
+
+u64 oc_text_buffer_line_count(oc_text_buffer* buffer)
+{
+    return (buffer->nodes[buffer->root].subtreeLines + 1);
+}
+
+u64 oc_text_buffer_line_start(oc_text_buffer* buffer, u64 line)
+{
+    if(line == 0)
+    {
+        return (0);
+    }
+    if(line >= oc_text_buffer_line_count(buffer))
+    {
+        return (oc_text_buffer_length(buffer));
+    }
+
+    //NOTE: find the offset just past the line-th newline
+    u64 target = line - 1;
+    u64 base = 0;
+    u32 index = buffer->root;
+    while(index)
+    {
+        oc_text_piece_node* node = &buffer->nodes[index];
+        oc_text_piece_node* left = &buffer->nodes[node->left];
+
+        if(target < left->subtreeLines)
+        {
+            index = node->left;
+        }
+        else if(target < left->subtreeLines + node->lines)
+        {
+            oc_text_storage* storage = &buffer->storage[node->source];
+            u64 first = oc_text_storage_newline_index(storage, node->start);
+            u64 newline = storage->newlines[first + target - left->subtreeLines];
+            return (base + left->subtreeLength + (newline - node->start) + 1);
+        }
+        else
+        {
+            target -= left->subtreeLines + node->lines;
+            base += left->subtreeLength + node->length;
+            index = node->right;
+        }
+    }
+    return (oc_text_buffer_length(buffer));
+}
+
+u64 oc_text_buffer_line_end(oc_text_buffer* buffer, u64 line)
+{
+    if(line + 1 < oc_text_buffer_line_count(buffer))
+    {
+        return (oc_text_buffer_line_start(buffer, line + 1) - 1);
+    }
+    return (oc_text_buffer_length(buffer));
+}
+
+u64 oc_text_buffer_line_of_offset(oc_text_buffer* buffer, u64 offset)
+{
+    u64 line = 0;
+    u32 index = buffer->root;
+    while(index)
+    {
+        oc_text_piece_node* node = &buffer->nodes[index];
+        oc_text_piece_node* left = &buffer->nodes[node->left];
+
+        if(offset < left->subtreeLength)
+        {
+            index = node->left;
+        }
+        else
+        {
+            offset -= left->subtreeLength;
+            line += left->subtreeLines;
+
+            if(offset < node->length)
+            {
+                line += oc_text_storage_count_newlines(&buffer->storage[node->source], node->start, node->start + offset);
+                break;
+            }
+            offset -= node->length;
+            line += node->lines;
+            index = node->right;
+        }
+    }
+    return (line);
+}
+
+oc_utf32 oc_text_buffer_codepoint_at(oc_text_buffer* buffer, u64 offset)
+{
+    u32 index = buffer->root;
+    while(index)
+    {
+        oc_text_piece_node* node = &buffer->nodes[index];
+        u64 leftLength = buffer->nodes[node->left].subtreeLength;
+
+        if(offset < leftLength)
+        {
+            index = node->left;
+        }
+        else if(offset < leftLength + node->length)
+        {
+            return (buffer->storage[node->source].text[node->start + offset - leftLength]);
+        }
+        else
+        {
+            offset -= leftLength + node->length;
+            index = node->right;
+        }
+    }
+    return (0);
+}
+
+u64 oc_text_buffer_copy(oc_text_buffer* buffer, u64 offset, u64 count, oc_utf32* dst)
+{
+    u64 length = oc_text_buffer_length(buffer);
+    offset = oc_min(offset, length);
+    count = oc_min(count, length - offset);
+    return (oc_text_node_copy(buffer, buffer->root, offset, offset + count, dst));
+}
+
+oc_str32 oc_text_buffer_push_range(oc_arena* arena, oc_text_buffer* buffer, u64 offset, u64 count)
+{
+    u64 length = oc_text_buffer_length(buffer);
+    offset = oc_min(offset, length);
+    count = oc_min(count, length - offset);
+
+    oc_str32 result = {
+        .ptr = oc_arena_push_array_uninitialized(arena, oc_utf32, count),
+        .len = count,
+    };
+    oc_text_buffer_copy(buffer, offset, count, result.ptr);
+    return (result);
+}
+
+oc_str8 oc_text_buffer_push_str8(oc_arena* arena, oc_text_buffer* buffer, u64 offset, u64 count)
+{
+    oc_scratch scratch = oc_scratch_begin_next_arena(arena);
+    oc_str32 codepoints = oc_text_buffer_push_range(scratch.arena, buffer, offset, count);
+    oc_str8 result = oc_utf8_push_from_codepoints((oc_allocator*)arena, codepoints);
+    oc_scratch_end(scratch);
+    return (result);
+}
+
+//------------------------------------------------------------------------------------------
+// Edits and history
+//------------------------------------------------------------------------------------------
+
+static bool oc_text_node_extend_last(oc_text_buffer* buffer, u32 index, u64 addStart, u64 count, u64 lines)
+{
+    //NOTE: if the last piece of the tree ends exactly where the add buffer ended before the
+    //      edit, extend it instead of creating a new piece. This keeps typing from creating
+    //      one piece per keystroke.
+    if(!index)
+    {
+        return (false);
+    }
+    oc_text_piece_node* node = &buffer->nodes[index];
+    bool extended = false;
+    if(node->right)
+    {
+        extended = oc_text_node_extend_last(buffer, node->right, addStart, count, lines);
+    }
+    else if(node->source == OC_TEXT_BUFFER_ADD && node->start + node->length == addStart)
+    {
+        node->length += count;
+        node->lines += lines;
+        extended = true;
+    }
+    if(extended)
+    {
+        oc_text_node_update(buffer, index);
+    }
+    return (extended);
+}
+
+static void oc_text_spans_reverse(oc_text_span* spans, u64 count)
+{
+    for(u64 i = 0; i < count / 2; i++)
+    {
+        oc_text_span tmp = spans[i];
+        spans[i] = spans[count - 1 - i];
+        spans[count - 1 - i] = tmp;
+    }
+}
+
+static bool oc_text_buffer_coalesce(oc_text_buffer* buffer, oc_text_delta* delta)
+{
+    //NOTE: merge runs of typing, backspaces or forward deletes into the previous delta, so that
+    //      they are undone together.
+    if(!buffer->undoCount)
+    {
+        return (false);
+    }
+    oc_text_delta* prev = &buffer->deltas[buffer->undoCount - 1];
+    if(prev->sealed)
+    {
+        return (false);
+    }
+
+    if(!delta->removedCount
+       && prev->offset + prev->insertedCount == delta->offset
+       && prev->insertedStart + prev->insertedCount == delta->insertedStart)
+    {
+        prev->insertedCount += delta->insertedCount;
+        return (true);
+    }
+    else if(!delta->insertedCount && !prev->insertedCount && prev->removedCount)
+    {
+        if(delta->offset == prev->offset)
+        {
+            //NOTE: forward delete, new spans follow the previous ones
+            prev->removedCount += delta->removedCount;
+            prev->removedSpanCount += delta->removedSpanCount;
+            return (true);
+        }
+        else if(delta->offset + delta->removedCount == prev->offset)
+        {
+            //NOTE: backspace, new spans go in front of the previous ones. Rotate the tail of the
+            //      span array.
+            oc_text_span* spans = buffer->spans + prev->removedFirstSpan;
+            u64 total = prev->removedSpanCount + delta->removedSpanCount;
+            oc_text_spans_reverse(spans, prev->removedSpanCount);
+            oc_text_spans_reverse(spans + prev->removedSpanCount, delta->removedSpanCount);
+            oc_text_spans_reverse(spans, total);
+
+            prev->offset = delta->offset;
+            prev->removedCount += delta->removedCount;
+            prev->removedSpanCount = total;
+            return (true);
+        }
+    }
+    return (false);
+}
+
+static oc_text_edit oc_text_buffer_apply(oc_text_buffer* buffer,
+                                         u64 offset,
+                                         u64 count,
+                                         u64 spanCount,
+                                         oc_text_span* spans)
+{
+    oc_text_edit edit = {
+        .offset = offset,
+        .removed = count,
+        .firstLine = oc_text_buffer_line_of_offset(buffer, offset),
+    };
+
+    u32 left = 0;
+    u32 rest = 0;
+    u32 mid = 0;
+    u32 right = 0;
+    oc_text_node_split(buffer, buffer->root, offset, &left, &rest);
+    oc_text_node_split(buffer, rest, count, &mid, &right);
+
+    edit.removedLines = buffer->nodes[mid].subtreeLines;
+    oc_text_node_free_tree(buffer, mid);
+
+    u32 inserted = oc_text_node_from_spans(buffer, spanCount, spans);
+    edit.inserted = buffer->nodes[inserted].subtreeLength;
+    edit.insertedLines = buffer->nodes[inserted].subtreeLines;
+
+    buffer->root = oc_text_node_merge(buffer, oc_text_node_merge(buffer, left, inserted), right);
+    return (edit);
+}
+
+oc_text_edit oc_text_buffer_replace(oc_text_buffer* buffer, u64 offset, u64 count, oc_str32 codepoints)
+{
+    u64 length = oc_text_buffer_length(buffer);
+    offset = oc_min(offset, length);
+    count = oc_min(count, length - offset);
+
+    oc_text_edit edit = {
+        .offset = offset,
+        .removed = count,
+        .inserted = codepoints.len,
+    };
+    if(!count && !codepoints.len)
+    {
+        return (edit);
+    }
+    edit.firstLine = oc_text_buffer_line_of_offset(buffer, offset);
+
+    //NOTE: drop the redo history
+    if(buffer->undoCount < buffer->deltaCount)
+    {
+        buffer->spanCount = buffer->deltas[buffer->undoCount].removedFirstSpan;
+        buffer->deltaCount = buffer->undoCount;
+    }
+
+    u32 left = 0;
+    u32 rest = 0;
+    u32 mid = 0;
+    u32 right = 0;
+    oc_text_node_split(buffer, buffer->root, offset, &left, &rest);
+    oc_text_node_split(buffer, rest, count, &mid, &right);
+
+    //NOTE: the removed pieces are recorded as spans of the immutable buffers
+    oc_text_delta delta = {
+        .offset = offset,
+        .removedCount = count,
+        .removedFirstSpan = buffer->spanCount,
+    };
+    oc_text_node_push_spans(buffer, mid);
+    delta.removedSpanCount = buffer->spanCount - delta.removedFirstSpan;
+    edit.removedLines = buffer->nodes[mid].subtreeLines;
+    oc_text_node_free_tree(buffer, mid);
+
+    //NOTE: append inserted text to the add buffer
+    oc_text_storage* add = &buffer->storage[OC_TEXT_BUFFER_ADD];
+    u64 addStart = add->len;
+    u64 addNewlines = add->newlineCount;
+    oc_text_storage_append(add, codepoints.len, codepoints.ptr);
+    edit.insertedLines = add->newlineCount - addNewlines;
+
+    delta.insertedStart = addStart;
+    delta.insertedCount = codepoints.len;
+
+    if(codepoints.len && !oc_text_node_extend_last(buffer, left, addStart, codepoints.len, edit.insertedLines))
+    {
+        u32 node = oc_text_node_alloc(buffer, OC_TEXT_BUFFER_ADD, addStart, codepoints.len);
+        left = oc_text_node_merge(buffer, left, node);
+    }
+    buffer->root = oc_text_node_merge(buffer, left, right);
+
+    if(!oc_text_buffer_coalesce(buffer, &delta))
+    {
+        buffer->deltas = oc_text_buffer_grow(buffer->deltas, &buffer->deltaCap, buffer->deltaCount + 1, sizeof(oc_text_delta));
+        buffer->deltas[buffer->deltaCount] = delta;
+        buffer->deltaCount++;
+        buffer->undoCount = buffer->deltaCount;
+    }
+    if(edit.insertedLines)
+    {
+        //NOTE: don't group edits across line breaks
+        oc_text_buffer_undo_boundary(buffer);
+    }
+    return (edit);
+}
+
+void oc_text_buffer_undo_boundary(oc_text_buffer* buffer)
+{
+    if(buffer->undoCount)
+    {
+        buffer->deltas[buffer->undoCount - 1].sealed = true;
+    }
+}
+
+bool oc_text_buffer_can_undo(oc_text_buffer* buffer)
+{
+    return (buffer->undoCount > 0);
+}
+
+bool oc_text_buffer_can_redo(oc_text_buffer* buffer)
+{
+    return (buffer->undoCount < buffer->deltaCount);
+}
+
+oc_text_edit oc_text_buffer_undo(oc_text_buffer* buffer)
+{
+    oc_text_edit edit = { 0 };
+    if(buffer->undoCount)
+    {
+        buffer->undoCount--;
+        oc_text_delta* delta = &buffer->deltas[buffer->undoCount];
+        delta->sealed = true;
+
+        edit = oc_text_buffer_apply(buffer,
+                                    delta->offset,
+                                    delta->insertedCount,
+                                    delta->removedSpanCount,
+                                    buffer->spans + delta->removedFirstSpan);
+        oc_text_buffer_undo_boundary(buffer);
+    }
+    return (edit);
+}
+
+oc_text_edit oc_text_buffer_redo(oc_text_buffer* buffer)
+{
+    oc_text_edit edit = { 0 };
+    if(buffer->undoCount < buffer->deltaCount)
+    {
+        oc_text_delta* delta = &buffer->deltas[buffer->undoCount];
+        buffer->undoCount++;
+
+        oc_text_span span = {
+            .source = OC_TEXT_BUFFER_ADD,
+            .start = delta->insertedStart,
+            .length = delta->insertedCount,
+        };
+        edit = oc_text_buffer_apply(buffer, delta->offset, delta->removedCount, span.length ? 1 : 0, &span);
+    }
+    return (edit);
+}
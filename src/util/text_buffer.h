@@ -0,0 +1,140 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#pragma once
+
+#include "memory.h"
+#include "strings.h"
+#include "typedefs.h"
+#include "utf8.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//NOTE: A piece table of codepoints. The document is described by a sequence of pieces that
+//      reference either the original text or an append-only add buffer. Pieces are kept in
+//      an implicit treap that maintains codepoint and line counts per subtree, so that edits,
+//      offset lookups and line lookups are logarithmic in the number of pieces.
+//      Undo history is stored as edit deltas that reference spans of those immutable buffers,
+//      so no text is ever copied to record an edit.
+
+typedef enum oc_text_buffer_source
+{
+    OC_TEXT_BUFFER_ORIGINAL = 0,
+    OC_TEXT_BUFFER_ADD = 1,
+} oc_text_buffer_source;
+
+typedef struct oc_text_span
+{
+    oc_text_buffer_source source;
+    u64 start;
+    u64 length;
+} oc_text_span;
+
+typedef struct oc_text_piece_node
+{
+    u32 left;
+    u32 right;
+    u32 priority;
+    oc_text_buffer_source source;
+
+    u64 start;
+    u64 length;
+    u64 lines;
+
+    u64 subtreeLength;
+    u64 subtreeLines;
+
+} oc_text_piece_node;
+
+typedef struct oc_text_storage
+{
+    oc_utf32* text;
+    u64 len;
+    u64 cap;
+
+    u64* newlines; //NOTE: sorted offsets of '\n' codepoints in text
+    u64 newlineCount;
+    u64 newlineCap;
+
+} oc_text_storage;
+
+typedef struct oc_text_delta
+{
+    u64 offset;
+
+    u64 insertedStart; // in the add buffer
+    u64 insertedCount;
+
+    u64 removedCount;
+    u64 removedFirstSpan;
+    u64 removedSpanCount;
+
+    bool sealed;
+
+} oc_text_delta;
+
+//NOTE: describes a change of the document, whether it comes from an edit, an undo or a redo:
+//      at offset, 'removed' codepoints were replaced by 'inserted' codepoints.
+typedef struct oc_text_edit
+{
+    u64 offset;
+    u64 removed;
+    u64 inserted;
+    u64 firstLine;
+    u64 removedLines;
+    u64 insertedLines;
+} oc_text_edit;
+
+typedef struct oc_text_buffer
+{
+    oc_text_storage storage[2];
+
+    oc_text_piece_node* nodes; //NOTE: node 0 is the nil node
+    u32 nodeCount;
+    u32 nodeCap;
+    u32 freeList;
+    u32 root;
+    u32 seed;
+
+    oc_text_delta* deltas;
+    u64 deltaCount;
+    u64 deltaCap;
+    u64 undoCount; //NOTE: deltas past undoCount can be redone
+
+    oc_text_span* spans;
+    u64 spanCount;
+    u64 spanCap;
+
+} oc_text_buffer;
+
+ORCA_API void oc_text_buffer_init(oc_text_buffer* buffer);
+ORCA_API void oc_text_buffer_init_from_str8(oc_text_buffer* buffer, oc_str8 string);
+ORCA_API void oc_text_buffer_init_from_str32(oc_text_buffer* buffer, oc_str32 codepoints);
+ORCA_API void oc_text_buffer_cleanup(oc_text_buffer* buffer);
+
+ORCA_API u64 oc_text_buffer_length(oc_text_buffer* buffer);
+ORCA_API u64 oc_text_buffer_line_count(oc_text_buffer* buffer);
+ORCA_API u64 oc_text_buffer_line_start(oc_text_buffer* buffer, u64 line);
+ORCA_API u64 oc_text_buffer_line_end(oc_text_buffer* buffer, u64 line); //NOTE: offset of the line's '\n', or end of text
+ORCA_API u64 oc_text_buffer_line_of_offset(oc_text_buffer* buffer, u64 offset);
+ORCA_API oc_utf32 oc_text_buffer_codepoint_at(oc_text_buffer* buffer, u64 offset);
+ORCA_API u64 oc_text_buffer_copy(oc_text_buffer* buffer, u64 offset, u64 count, oc_utf32* dst);
+ORCA_API oc_str32 oc_text_buffer_push_range(oc_arena* arena, oc_text_buffer* buffer, u64 offset, u64 count);
+ORCA_API oc_str8 oc_text_buffer_push_str8(oc_arena* arena, oc_text_buffer* buffer, u64 offset, u64 count);
+
+ORCA_API oc_text_edit oc_text_buffer_replace(oc_text_buffer* buffer, u64 offset, u64 count, oc_str32 codepoints);
+ORCA_API void oc_text_buffer_undo_boundary(oc_text_buffer* buffer);
+ORCA_API bool oc_text_buffer_can_undo(oc_text_buffer* buffer);
+ORCA_API bool oc_text_buffer_can_redo(oc_text_buffer* buffer);
+ORCA_API oc_text_edit oc_text_buffer_undo(oc_text_buffer* buffer);
+ORCA_API oc_text_edit oc_text_buffer_redo(oc_text_buffer* buffer);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -7,6 +7,7 @@
 **************************************************************************/
 
 #include "utf8.h"
+#include "platform/platform.h"
 
 //-----------------------------------------------------------------
 //	utf-8 gore
@@ -27,6 +28,739 @@ static const char trailingBytesForUTF8[256] = {
     2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5
 };
 
+//-----------------------------------------------------------------
+//NOTE: vectorized kernels
+//-----------------------------------------------------------------
+/*NOTE:
+    The string functions below skip over runs of valid utf8 with vectorized kernels, and decode the invalid
+    sequences one at a time with oc_utf8_decode_at(), so that they return exactly the same results as decoding the
+    whole string one codepoint at a time.
+
+    Validation uses the lookup algorithm from Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per
+    Byte", with AVX2 or SSSE3 on x64, and with NEON on arm64. The kernel is selected at compile time, so the AVX2
+    version is only used when the target CPU has it. Without a vectorized validator (eg. on wasm), runs of ASCII
+    characters are skipped using SSE2 or 64-bit words, and other sequences are validated one at a time.
+*/
+#if OC_ARCH_X64
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define OC_UTF8_AVX2 1
+        #define OC_UTF8_LOOKUP 1
+    #elif defined(__SSSE3__)
+        #include <tmmintrin.h>
+        #define OC_UTF8_SSSE3 1
+        #define OC_UTF8_LOOKUP 1
+    #else
+        #include <emmintrin.h>
+    #endif
+    #define OC_UTF8_SSE2 1
+#elif OC_ARCH_ARM64
+    #include <arm_neon.h>
+    #define OC_UTF8_NEON 1
+    #define OC_UTF8_LOOKUP 1
+#endif
+
+#if OC_COMPILER_CL
+    #include <intrin.h>
+#endif
+
+enum
+{
+    //NOTE: maximum number of bytes validated ahead of the bytes being processed, to bound the work done by
+    //      functions that can stop early
+    OC_UTF8_WINDOW_SIZE = 4 << 10,
+};
+
+static inline u32 oc_utf8_ctz32(u32 x)
+{
+#if OC_COMPILER_CL
+    unsigned long index = 0;
+    _BitScanForward(&index, x);
+    return (index);
+#else
+    return (__builtin_ctz(x));
+#endif
+}
+
+static inline u32 oc_utf8_ctz64(u64 x)
+{
+#if OC_COMPILER_CL
+    unsigned long index = 0;
+    _BitScanForward64(&index, x);
+    return (index);
+#else
+    return (__builtin_ctzll(x));
+#endif
+}
+
+static inline u32 oc_utf8_popcount32(u32 x)
+{
+#if OC_COMPILER_CL
+    return (__popcnt(x));
+#else
+    return (__builtin_popcount(x));
+#endif
+}
+
+static inline u64 oc_utf8_load64(const u8* s)
+{
+    u64 word = 0;
+    memcpy(&word, s, sizeof(u64));
+    return (word);
+}
+
+static const u64 OC_UTF8_WORD_ONES = 0x0101010101010101ULL;
+static const u64 OC_UTF8_WORD_HIGH_BITS = 0x8080808080808080ULL;
+
+//NOTE: number of codepoint starts in s, stopping at the first null byte. size is set to the number of bytes scanned.
+static u64 oc_utf8_count_starts(const u8* s, u64 len, u64* size)
+{
+    u64 count = 0;
+    u64 i = 0;
+#if OC_UTF8_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lastContinuation = _mm_set1_epi8((char)0xbf);
+    for(; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)))
+        {
+            break;
+        }
+        //NOTE: as signed bytes, start bytes are greater than the last continuation byte
+        count += oc_utf8_popcount32(_mm_movemask_epi8(_mm_cmpgt_epi8(v, lastContinuation)));
+    }
+#elif OC_UTF8_NEON
+    const int8x16_t lastContinuation = vdupq_n_s8((i8)0xbf);
+    for(; i + 16 <= len; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(s + i);
+        if(vminvq_u8(v) == 0)
+        {
+            break;
+        }
+        uint8x16_t starts = vcgtq_s8(vreinterpretq_s8_u8(v), lastContinuation);
+        count += vaddvq_u8(vshrq_n_u8(starts, 7));
+    }
+#else
+    for(; i + 8 <= len; i += 8)
+    {
+        u64 word = oc_utf8_load64(s + i);
+        if((word - OC_UTF8_WORD_ONES) & ~word & OC_UTF8_WORD_HIGH_BITS)
+        {
+            break;
+        }
+        //NOTE: continuation bytes have their high bit set and the next bit cleared
+        u64 continuations = word & ~(word << 1) & OC_UTF8_WORD_HIGH_BITS;
+        count += 8 - oc_utf8_popcount32((u32)(continuations >> 32)) - oc_utf8_popcount32((u32)continuations);
+    }
+#endif
+    for(; i < len && s[i]; i++)
+    {
+        count += oc_utf8_is_start_byte(s[i]) ? 1 : 0;
+    }
+    *size = i;
+    return (count);
+}
+
+//NOTE: convert the leading ASCII characters of s to dst, and return their number
+static u64 oc_utf8_ascii_to_utf32(const u8* s, u64 len, oc_utf32* dst)
+{
+    u64 i = 0;
+#if OC_UTF8_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        if(_mm_movemask_epi8(v))
+        {
+            break;
+        }
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+#elif OC_UTF8_NEON
+    for(; i + 16 <= len; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(s + i);
+        if(vmaxvq_u8(v) >= 0x80)
+        {
+            break;
+        }
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        vst1q_u32(dst + i, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(lo)));
+        vst1q_u32(dst + i + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(dst + i + 12, vmovl_u16(vget_high_u16(hi)));
+    }
+#else
+    for(; i + 8 <= len; i += 8)
+    {
+        if(oc_utf8_load64(s + i) & OC_UTF8_WORD_HIGH_BITS)
+        {
+            break;
+        }
+        for(u64 j = 0; j < 8; j++)
+        {
+            dst[i + j] = s[i + j];
+        }
+    }
+#endif
+    for(; i < len && s[i] < 0x80; i++)
+    {
+        dst[i] = s[i];
+    }
+    return (i);
+}
+
+//NOTE: convert the leading ASCII codepoints of src to dst, and return their number
+static u64 oc_utf8_ascii_from_utf32(const oc_utf32* src, u64 count, u8* dst)
+{
+    u64 i = 0;
+#if OC_UTF8_SSE2
+    const __m128i notAscii = _mm_set1_epi32(~0x7f);
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src + i + 8));
+        __m128i d = _mm_loadu_si128((const __m128i*)(src + i + 12));
+        __m128i bits = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), notAscii);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(bits, _mm_setzero_si128())) != 0xffff)
+        {
+            break;
+        }
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128((__m128i*)(dst + i), packed);
+    }
+#elif OC_UTF8_NEON
+    for(; i + 8 <= count; i += 8)
+    {
+        uint32x4_t a = vld1q_u32(src + i);
+        uint32x4_t b = vld1q_u32(src + i + 4);
+        if(vmaxvq_u32(vorrq_u32(a, b)) >= 0x80)
+        {
+            break;
+        }
+        vst1_u8(dst + i, vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b))));
+    }
+#endif
+    for(; i < count && src[i] < 0x80; i++)
+    {
+        dst[i] = (u8)src[i];
+    }
+    return (i);
+}
+
+static const u8 OC_UTF8_SIZE_FROM_HIGH_NIBBLE[16] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 3, 4 };
+static const u8 OC_UTF8_LEADING_BITS_MASK[5] = { 0, 0x7f, 0x1f, 0x0f, 0x07 };
+static const u8 OC_UTF8_LEADING_BITS_MARK[5] = { 0, 0x00, 0xc0, 0xe0, 0xf0 };
+
+//NOTE: encode codePoints, which must all be valid, into dst. The caller must make sure that dst has room for 4 bytes
+//      per codepoint, as this writes 4 bytes per codepoint, and advances by the size of the encoded sequence.
+static u64 oc_utf8_encode_valid(const oc_utf32* codePoints, u64 count, u8* dst)
+{
+    u64 offset = 0;
+    for(u64 i = 0; i < count; i++)
+    {
+        oc_utf32 codePoint = codePoints[i];
+        u32 size = 1 + (codePoint >= 0x80) + (codePoint >= 0x800) + (codePoint >= 0x10000);
+        u32 bits = codePoint << (6 * (4 - size));
+        u32 bytes = (OC_UTF8_LEADING_BITS_MARK[size] | (bits >> 18))
+                  | ((0x80 | ((bits >> 12) & 0x3f)) << 8)
+                  | ((0x80 | ((bits >> 6) & 0x3f)) << 16)
+                  | ((0x80 | (bits & 0x3f)) << 24);
+        //NOTE: all the supported targets are little endian
+        memcpy(dst + offset, &bytes, 4);
+        offset += size;
+    }
+    return (offset);
+}
+
+//NOTE: size of the next chunk of s to validate, ending on a codepoint boundary unless s is invalid
+static u64 oc_utf8_window_size(const u8* s, u64 len, u64 maxSize)
+{
+    u64 size = len;
+    if(size > maxSize)
+    {
+        size = maxSize;
+        for(int i = 0; i < 3 && size > 1 && !oc_utf8_is_start_byte(s[size]); i++)
+        {
+            size--;
+        }
+    }
+    return (size);
+}
+
+#if OC_UTF8_LOOKUP
+
+//NOTE: decode len bytes of valid utf8, or up to maxCount codepoints. count is set to the number of codepoints
+//      decoded, and the number of bytes decoded is returned.
+static u64 oc_utf8_decode_valid(const u8* s, u64 len, u64 maxCount, oc_utf32* dst, u64* count)
+{
+    u64 offset = 0;
+    u64 n = 0;
+
+    //NOTE: decode 16 bytes chunks, converting ASCII chunks with the vectorized kernel, and other chunks without
+    //      branching on the size of each sequence. This reads up to 3 bytes past the end of the chunk.
+    while(offset + 16 + 3 <= len && n + 16 <= maxCount)
+    {
+        u64 end = offset + 16;
+        if(!((oc_utf8_load64(s + offset) | oc_utf8_load64(s + offset + 8)) & OC_UTF8_WORD_HIGH_BITS))
+        {
+            oc_utf8_ascii_to_utf32(s + offset, 16, dst + n);
+            offset += 16;
+            n += 16;
+            continue;
+        }
+
+        while(offset < end)
+        {
+            //NOTE: the size is computed from the leading byte, which is known to be valid
+            u8 b0 = s[offset];
+            u32 size = 1 + (b0 >= 0xc0) + (b0 >= 0xe0) + (b0 >= 0xf0);
+            u32 bits = ((b0 & OC_UTF8_LEADING_BITS_MASK[size]) << 18)
+                     | ((s[offset + 1] & 0x3f) << 12)
+                     | ((s[offset + 2] & 0x3f) << 6)
+                     | (s[offset + 3] & 0x3f);
+            dst[n] = bits >> (6 * (4 - size));
+            offset += size;
+            n++;
+        }
+    }
+
+    while(offset < len && n < maxCount)
+    {
+        u8 b0 = s[offset];
+        u32 size = OC_UTF8_SIZE_FROM_HIGH_NIBBLE[b0 >> 4];
+        oc_utf32 codePoint = b0 & OC_UTF8_LEADING_BITS_MASK[size];
+        for(u32 i = 1; i < size; i++)
+        {
+            codePoint = (codePoint << 6) | (s[offset + i] & 0x3f);
+        }
+        dst[n] = codePoint;
+        offset += size;
+        n++;
+    }
+    *count = n;
+    return (offset);
+}
+
+
+    #if OC_UTF8_AVX2
+typedef __m256i oc_utf8_vec;
+
+enum
+{
+    OC_UTF8_VEC_SIZE = 32
+};
+
+        #define oc_utf8_vec_load(p) _mm256_loadu_si256((const __m256i*)(p))
+        #define oc_utf8_vec_table(t) _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(t)))
+        #define oc_utf8_vec_splat(x) _mm256_set1_epi8((char)(x))
+        #define oc_utf8_vec_and(a, b) _mm256_and_si256(a, b)
+        #define oc_utf8_vec_or(a, b) _mm256_or_si256(a, b)
+        #define oc_utf8_vec_xor(a, b) _mm256_xor_si256(a, b)
+        #define oc_utf8_vec_subs(a, b) _mm256_subs_epu8(a, b)
+        #define oc_utf8_vec_lookup(t, i) _mm256_shuffle_epi8(t, i)
+        #define oc_utf8_vec_high_nibble(v) _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f))
+        #define oc_utf8_vec_prev(v, prev, n) _mm256_alignr_epi8(v, _mm256_permute2x128_si256(prev, v, 0x21), 16 - (n))
+        #define oc_utf8_vec_any(v) (!_mm256_testz_si256(v, v))
+        #define oc_utf8_vec_is_ascii(v) (_mm256_movemask_epi8(v) == 0)
+
+    #elif OC_UTF8_SSSE3
+typedef __m128i oc_utf8_vec;
+
+enum
+{
+    OC_UTF8_VEC_SIZE = 16
+};
+
+        #define oc_utf8_vec_load(p) _mm_loadu_si128((const __m128i*)(p))
+        #define oc_utf8_vec_table(t) _mm_loadu_si128((const __m128i*)(t))
+        #define oc_utf8_vec_splat(x) _mm_set1_epi8((char)(x))
+        #define oc_utf8_vec_and(a, b) _mm_and_si128(a, b)
+        #define oc_utf8_vec_or(a, b) _mm_or_si128(a, b)
+        #define oc_utf8_vec_xor(a, b) _mm_xor_si128(a, b)
+        #define oc_utf8_vec_subs(a, b) _mm_subs_epu8(a, b)
+        #define oc_utf8_vec_lookup(t, i) _mm_shuffle_epi8(t, i)
+        #define oc_utf8_vec_high_nibble(v) _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f))
+        #define oc_utf8_vec_prev(v, prev, n) _mm_alignr_epi8(v, prev, 16 - (n))
+        #define oc_utf8_vec_any(v) (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xffff)
+        #define oc_utf8_vec_is_ascii(v) (_mm_movemask_epi8(v) == 0)
+
+    #elif OC_UTF8_NEON
+typedef uint8x16_t oc_utf8_vec;
+
+enum
+{
+    OC_UTF8_VEC_SIZE = 16
+};
+
+        #define oc_utf8_vec_load(p) vld1q_u8(p)
+        #define oc_utf8_vec_table(t) vld1q_u8(t)
+        #define oc_utf8_vec_splat(x) vdupq_n_u8(x)
+        #define oc_utf8_vec_and(a, b) vandq_u8(a, b)
+        #define oc_utf8_vec_or(a, b) vorrq_u8(a, b)
+        #define oc_utf8_vec_xor(a, b) veorq_u8(a, b)
+        #define oc_utf8_vec_subs(a, b) vqsubq_u8(a, b)
+        #define oc_utf8_vec_lookup(t, i) vqtbl1q_u8(t, i)
+        #define oc_utf8_vec_high_nibble(v) vshrq_n_u8(v, 4)
+        #define oc_utf8_vec_prev(v, prev, n) vextq_u8(prev, v, 16 - (n))
+        #define oc_utf8_vec_any(v) (vmaxvq_u8(v) != 0)
+        #define oc_utf8_vec_is_ascii(v) (vmaxvq_u8(v) < 0x80)
+    #endif
+
+//NOTE: error classes of a pair of bytes, looked up from the nibbles of the first byte and the high nibble of the
+//      second byte. A pair is invalid when all three lookups share a bit.
+enum
+{
+    OC_UTF8_TOO_SHORT = 1 << 0,      // 11______ 0_______ / 11______ 11______
+    OC_UTF8_TOO_LONG = 1 << 1,       // 0_______ 10______
+    OC_UTF8_OVERLONG_3 = 1 << 2,     // 11100000 100_____
+    OC_UTF8_TOO_LARGE = 1 << 3,      // 11110100 1001____ / 11110100 101_____ / 11110101+ 1001____ / ...
+    OC_UTF8_SURROGATE = 1 << 4,      // 11101101 101_____
+    OC_UTF8_OVERLONG_2 = 1 << 5,     // 1100000_ 10______
+    OC_UTF8_TOO_LARGE_1000 = 1 << 6, // 11110101+ 1000____
+    OC_UTF8_OVERLONG_4 = 1 << 6,     // 11110000 1000____
+    OC_UTF8_TWO_CONTS = 1 << 7,      // 10______ 10______
+    OC_UTF8_CARRY = OC_UTF8_TOO_SHORT | OC_UTF8_TOO_LONG | OC_UTF8_TWO_CONTS,
+};
+
+static const u8 OC_UTF8_BYTE_1_HIGH[16] = {
+    // 0_______ ________
+    OC_UTF8_TOO_LONG,
+    OC_UTF8_TOO_LONG,
+    OC_UTF8_TOO_LONG,
+    OC_UTF8_TOO_LONG,
+    OC_UTF8_TOO_LONG,
+    OC_UTF8_TOO_LONG,
+    OC_UTF8_TOO_LONG,
+    OC_UTF8_TOO_LONG,
+    // 10______ ________
+    OC_UTF8_TWO_CONTS,
+    OC_UTF8_TWO_CONTS,
+    OC_UTF8_TWO_CONTS,
+    OC_UTF8_TWO_CONTS,
+    // 1100____ ________
+    OC_UTF8_TOO_SHORT | OC_UTF8_OVERLONG_2,
+    // 1101____ ________
+    OC_UTF8_TOO_SHORT,
+    // 1110____ ________
+    OC_UTF8_TOO_SHORT | OC_UTF8_OVERLONG_3 | OC_UTF8_SURROGATE,
+    // 1111____ ________
+    OC_UTF8_TOO_SHORT | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000 | OC_UTF8_OVERLONG_4,
+};
+
+static const u8 OC_UTF8_BYTE_1_LOW[16] = {
+    // ____0000 ________
+    OC_UTF8_CARRY | OC_UTF8_OVERLONG_3 | OC_UTF8_OVERLONG_2 | OC_UTF8_OVERLONG_4,
+    // ____0001 ________
+    OC_UTF8_CARRY | OC_UTF8_OVERLONG_2,
+    // ____001_ ________
+    OC_UTF8_CARRY,
+    OC_UTF8_CARRY,
+    // ____0100 ________
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE,
+    // ____0101 ________
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    // ____011_ ________
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    // ____1___ ________
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    // ____1101 ________
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000 | OC_UTF8_SURROGATE,
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+    OC_UTF8_CARRY | OC_UTF8_TOO_LARGE | OC_UTF8_TOO_LARGE_1000,
+};
+
+static const u8 OC_UTF8_BYTE_2_HIGH[16] = {
+    // ________ 0_______
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    // ________ 1000____
+    OC_UTF8_TOO_LONG | OC_UTF8_OVERLONG_2 | OC_UTF8_TWO_CONTS | OC_UTF8_OVERLONG_3 | OC_UTF8_TOO_LARGE_1000 | OC_UTF8_OVERLONG_4,
+    // ________ 1001____
+    OC_UTF8_TOO_LONG | OC_UTF8_OVERLONG_2 | OC_UTF8_TWO_CONTS | OC_UTF8_OVERLONG_3 | OC_UTF8_TOO_LARGE,
+    // ________ 101_____
+    OC_UTF8_TOO_LONG | OC_UTF8_OVERLONG_2 | OC_UTF8_TWO_CONTS | OC_UTF8_SURROGATE | OC_UTF8_TOO_LARGE,
+    OC_UTF8_TOO_LONG | OC_UTF8_OVERLONG_2 | OC_UTF8_TWO_CONTS | OC_UTF8_SURROGATE | OC_UTF8_TOO_LARGE,
+    // ________ 11______
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+    OC_UTF8_TOO_SHORT,
+};
+
+//NOTE: a block is incomplete if one of its last three bytes starts a sequence that doesn't fit in the block. The
+//      maximum allowed values of the last OC_UTF8_VEC_SIZE bytes are loaded from the end of this table.
+static const u8 OC_UTF8_INCOMPLETE_MAX[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+};
+
+/*NOTE:
+    Return the size of a prefix of s made of complete, valid utf8 sequences, and set error if the rest of s starts
+    with an invalid or incomplete sequence. When there's an error, it is located in the block following the returned
+    prefix, give or take the three bytes of the last sequence before it.
+*/
+static u64 oc_utf8_valid_blocks(const u8* s, u64 len, bool* error)
+{
+    const oc_utf8_vec byte1High = oc_utf8_vec_table(OC_UTF8_BYTE_1_HIGH);
+    const oc_utf8_vec byte1Low = oc_utf8_vec_table(OC_UTF8_BYTE_1_LOW);
+    const oc_utf8_vec byte2High = oc_utf8_vec_table(OC_UTF8_BYTE_2_HIGH);
+    const oc_utf8_vec incompleteMax = oc_utf8_vec_load(OC_UTF8_INCOMPLETE_MAX + 32 - OC_UTF8_VEC_SIZE);
+    const oc_utf8_vec lowNibble = oc_utf8_vec_splat(0x0f);
+    const oc_utf8_vec zero = oc_utf8_vec_splat(0);
+
+    oc_utf8_vec prevInput = zero;
+    oc_utf8_vec prevIncomplete = zero;
+    u64 offset = 0;
+
+    *error = false;
+
+    for(; offset < len; offset += OC_UTF8_VEC_SIZE)
+    {
+        oc_utf8_vec input;
+        if(len - offset >= OC_UTF8_VEC_SIZE)
+        {
+            input = oc_utf8_vec_load(s + offset);
+        }
+        else
+        {
+            //NOTE: the last block is padded with null bytes, which terminate any incomplete sequence
+            u8 tail[OC_UTF8_VEC_SIZE] = { 0 };
+            memcpy(tail, s + offset, len - offset);
+            input = oc_utf8_vec_load(tail);
+        }
+
+        oc_utf8_vec blockError;
+        if(oc_utf8_vec_is_ascii(input))
+        {
+            blockError = prevIncomplete;
+            prevIncomplete = zero;
+        }
+        else
+        {
+            oc_utf8_vec prev1 = oc_utf8_vec_prev(input, prevInput, 1);
+            oc_utf8_vec specialCases = oc_utf8_vec_and(
+                oc_utf8_vec_and(oc_utf8_vec_lookup(byte1High, oc_utf8_vec_high_nibble(prev1)),
+                                oc_utf8_vec_lookup(byte1Low, oc_utf8_vec_and(prev1, lowNibble))),
+                oc_utf8_vec_lookup(byte2High, oc_utf8_vec_high_nibble(input)));
+
+            //NOTE: the second and third bytes after a 3 or 4 bytes lead must be continuation bytes, which is the
+            //      only case where a continuation byte follows another one (TWO_CONTS).
+            oc_utf8_vec prev2 = oc_utf8_vec_prev(input, prevInput, 2);
+            oc_utf8_vec prev3 = oc_utf8_vec_prev(input, prevInput, 3);
+            oc_utf8_vec mustBeContinuation = oc_utf8_vec_or(oc_utf8_vec_subs(prev2, oc_utf8_vec_splat(0xe0 - 0x80)),
+                                                            oc_utf8_vec_subs(prev3, oc_utf8_vec_splat(0xf0 - 0x80)));
+
+            blockError = oc_utf8_vec_xor(oc_utf8_vec_and(mustBeContinuation, oc_utf8_vec_splat(0x80)), specialCases);
+            prevIncomplete = oc_utf8_vec_subs(input, incompleteMax);
+        }
+
+        if(oc_utf8_vec_any(blockError))
+        {
+            *error = true;
+            break;
+        }
+        prevInput = input;
+    }
+
+    if(!*error)
+    {
+        if(!oc_utf8_vec_any(prevIncomplete))
+        {
+            return (len);
+        }
+        *error = true;
+        offset = len;
+    }
+
+    //NOTE: back up to the leading byte of the last sequence before the error, which might be part of it
+    for(u64 i = 1; i <= 3 && i <= offset; i++)
+    {
+        u8 b = s[offset - i];
+        if(b >= 0xc0)
+        {
+            return (offset - i);
+        }
+        if(b < 0x80)
+        {
+            break;
+        }
+    }
+    return (offset);
+}
+
+//NOTE: decode the longest valid prefix of s, or up to maxCount codepoints, and set error if it is followed by an
+//      invalid sequence
+static u64 oc_utf8_decode_valid_prefix(const u8* s, u64 len, u64 maxCount, oc_utf32* dst, u64* count, bool* error)
+{
+    //NOTE: don't validate much more than the bytes needed for maxCount codepoints
+    u64 maxWindowSize = OC_UTF8_WINDOW_SIZE;
+    if(maxCount < OC_UTF8_WINDOW_SIZE / 4)
+    {
+        maxWindowSize = maxCount * 4;
+    }
+    u64 windowSize = oc_utf8_window_size(s, len, maxWindowSize);
+    u64 validSize = oc_utf8_valid_blocks(s, windowSize, error);
+    return (oc_utf8_decode_valid(s, validSize, maxCount, dst, count));
+}
+
+#else
+
+enum
+{
+    OC_UTF8_VEC_SIZE = 16
+};
+
+//NOTE: number of leading ASCII bytes of s
+static u64 oc_utf8_ascii_prefix(const u8* s, u64 len)
+{
+    u64 i = 0;
+#if OC_UTF8_SSE2
+    for(; i + 16 <= len; i += 16)
+    {
+        u32 mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(s + i)));
+        if(mask)
+        {
+            return (i + oc_utf8_ctz32(mask));
+        }
+    }
+#elif OC_UTF8_NEON
+    for(; i + 16 <= len; i += 16)
+    {
+        if(vmaxvq_u8(vld1q_u8(s + i)) >= 0x80)
+        {
+            break;
+        }
+    }
+#else
+    for(; i + 8 <= len; i += 8)
+    {
+        u64 high = oc_utf8_load64(s + i) & OC_UTF8_WORD_HIGH_BITS;
+        if(high)
+        {
+            return (i + oc_utf8_ctz64(high) / 8);
+        }
+    }
+#endif
+    while(i < len && s[i] < 0x80)
+    {
+        i++;
+    }
+    return (i);
+}
+
+//NOTE: size of the multibyte sequence at the start of s, or 0 if it is invalid
+static u32 oc_utf8_multibyte_size(const u8* s, u64 len)
+{
+    u8 b0 = s[0];
+    u32 size = OC_UTF8_SIZE_FROM_HIGH_NIBBLE[b0 >> 4];
+    if(size > len || b0 < 0xc2 || b0 > 0xf4)
+    {
+        return (0);
+    }
+
+    //NOTE: the range of the second byte excludes overlong encodings, surrogates, and codepoints past U+10FFFF
+    u8 b1 = s[1];
+    u8 min = (b0 == 0xe0) ? 0xa0 : ((b0 == 0xf0) ? 0x90 : 0x80);
+    u8 max = (b0 == 0xed) ? 0x9f : ((b0 == 0xf4) ? 0x8f : 0xbf);
+    bool valid = (b1 >= min && b1 <= max);
+    for(u32 i = 2; i < size; i++)
+    {
+        valid = valid && ((s[i] & 0xc0) == 0x80);
+    }
+    return (valid ? size : 0);
+}
+
+static u64 oc_utf8_valid_blocks(const u8* s, u64 len, bool* error)
+{
+    u64 offset = 0;
+    *error = false;
+    while(offset < len)
+    {
+        if(s[offset] < 0x80)
+        {
+            offset += oc_utf8_ascii_prefix(s + offset, len - offset);
+            continue;
+        }
+        u32 size = oc_utf8_multibyte_size(s + offset, len - offset);
+        if(!size)
+        {
+            *error = true;
+            break;
+        }
+        offset += size;
+    }
+    return (offset);
+}
+
+static u64 oc_utf8_decode_valid_prefix(const u8* s, u64 len, u64 maxCount, oc_utf32* dst, u64* count, bool* error)
+{
+    //NOTE: validate the sequences while decoding them, instead of validating them first
+    u64 offset = 0;
+    u64 n = 0;
+    *error = false;
+    while(offset < len && n < maxCount)
+    {
+        if(offset + 16 <= len
+           && n + 16 <= maxCount
+           && !((oc_utf8_load64(s + offset) | oc_utf8_load64(s + offset + 8)) & OC_UTF8_WORD_HIGH_BITS))
+        {
+            oc_utf8_ascii_to_utf32(s + offset, 16, dst + n);
+            offset += 16;
+            n += 16;
+            continue;
+        }
+
+        u8 b0 = s[offset];
+        if(b0 < 0x80)
+        {
+            dst[n] = b0;
+            offset++;
+            n++;
+            continue;
+        }
+
+        u32 size = oc_utf8_multibyte_size(s + offset, len - offset);
+        if(!size)
+        {
+            *error = true;
+            break;
+        }
+        oc_utf32 codePoint = b0 & OC_UTF8_LEADING_BITS_MASK[size];
+        for(u32 i = 1; i < size; i++)
+        {
+            codePoint = (codePoint << 6) | (s[offset + i] & 0x3f);
+        }
+        dst[n] = codePoint;
+        offset += size;
+        n++;
+    }
+    *count = n;
+    return (offset);
+}
+
+#endif
+
 //-----------------------------------------------------------------
 //NOTE: getting sizes / offsets / indices
 //-----------------------------------------------------------------
@@ -59,14 +793,40 @@ u32 oc_utf8_codepoint_size(oc_utf32 codePoint)
 
 u64 oc_utf8_codepoint_count_for_string(oc_str8 string)
 {
+    const u8* s = (const u8*)string.ptr;
     u64 byteOffset = 0;
     u64 codePointIndex = 0;
-    for(;
-        (byteOffset < string.len) && (string.ptr[byteOffset] != 0);
-        codePointIndex++)
+    while(byteOffset < string.len)
     {
-        oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
-        byteOffset += decode.size;
+        bool error = false;
+        u64 windowSize = oc_utf8_window_size(s + byteOffset, string.len - byteOffset, OC_UTF8_WINDOW_SIZE);
+        u64 validSize = oc_utf8_valid_blocks(s + byteOffset, windowSize, &error);
+
+        u64 scanned = 0;
+        codePointIndex += oc_utf8_count_starts(s + byteOffset, validSize, &scanned);
+        byteOffset += scanned;
+        if(scanned < validSize)
+        {
+            //NOTE: stop at the null byte
+            break;
+        }
+
+        if(error)
+        {
+            //NOTE: count the codepoints of the invalid block one at a time
+            u64 end = oc_min(byteOffset + OC_UTF8_VEC_SIZE, string.len);
+            for(;
+                (byteOffset < end) && (string.ptr[byteOffset] != 0);
+                codePointIndex++)
+            {
+                oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
+                byteOffset += decode.size;
+            }
+            if(byteOffset < end)
+            {
+                break;
+            }
+        }
     }
     return (codePointIndex);
 }
@@ -214,6 +974,33 @@ oc_utf8_dec oc_utf8_decode(oc_str8 string)
     return (oc_utf8_decode_at(string, 0));
 }
 
+u64 oc_utf8_valid_prefix_size(oc_str8 string)
+{
+    const u8* s = (const u8*)string.ptr;
+    u64 byteOffset = 0;
+    while(byteOffset < string.len)
+    {
+        bool error = false;
+        byteOffset += oc_utf8_valid_blocks(s + byteOffset, string.len - byteOffset, &error);
+
+        if(error)
+        {
+            //NOTE: find the invalid sequence in the block
+            u64 end = oc_min(byteOffset + OC_UTF8_VEC_SIZE, string.len);
+            while(byteOffset < end)
+            {
+                oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
+                if(decode.status != OC_UTF8_OK)
+                {
+                    return (byteOffset);
+                }
+                byteOffset += decode.size;
+            }
+        }
+    }
+    return (string.len);
+}
+
 oc_str8 oc_utf8_encode(char* dest, oc_utf32 codePoint)
 {
     u64 sz = 0;
@@ -249,13 +1036,32 @@ oc_str8 oc_utf8_encode(char* dest, oc_utf32 codePoint)
 
 oc_str32 oc_utf8_to_codepoints(u64 maxCount, oc_utf32* backing, oc_str8 string)
 {
+    const u8* s = (const u8*)string.ptr;
     u64 codePointIndex = 0;
     u64 byteOffset = 0;
-    for(; codePointIndex < maxCount && byteOffset < string.len; codePointIndex++)
+    while(codePointIndex < maxCount && byteOffset < string.len)
     {
-        oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
-        backing[codePointIndex] = decode.codepoint;
-        byteOffset += decode.size;
+        bool error = false;
+        u64 count = 0;
+        byteOffset += oc_utf8_decode_valid_prefix(s + byteOffset,
+                                                  string.len - byteOffset,
+                                                  maxCount - codePointIndex,
+                                                  backing + codePointIndex,
+                                                  &count,
+                                                  &error);
+        codePointIndex += count;
+
+        if(error)
+        {
+            //NOTE: decode the invalid block one codepoint at a time
+            u64 end = oc_min(byteOffset + OC_UTF8_VEC_SIZE, string.len);
+            for(; codePointIndex < maxCount && byteOffset < end; codePointIndex++)
+            {
+                oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
+                backing[codePointIndex] = decode.codepoint;
+                byteOffset += decode.size;
+            }
+        }
     }
     oc_str32 res = { .ptr = backing, .len = codePointIndex };
     return (res);
@@ -264,21 +1070,133 @@ oc_str32 oc_utf8_to_codepoints(u64 maxCount, oc_utf32* backing, oc_str8 string)
 oc_str8 oc_utf8_from_codepoints(u64 maxBytes, char* backing, oc_str32 codePoints)
 {
     u64 byteOffset = 0;
-    for(u64 codePointIndex = 0; (codePointIndex < codePoints.len); codePointIndex++)
+    u64 codePointIndex = 0;
+
+    while(codePointIndex < codePoints.len)
     {
-        oc_utf32 codePoint = codePoints.ptr[codePointIndex];
-        u32 byteCount = oc_utf8_codepoint_size(codePoint);
-        if(byteOffset + byteCount > maxBytes)
+        const oc_utf32* chunk = codePoints.ptr + codePointIndex;
+        if(codePointIndex + 16 <= codePoints.len && byteOffset + 16 * 4 <= maxBytes)
         {
-            break;
+            //NOTE: encode a chunk of 16 codepoints, converting ASCII chunks with the vectorized kernel, and other
+            //      chunks without branching on the size of each codepoint. This writes up to 3 bytes past the encoded
+            //      string, within maxBytes.
+            oc_utf32 bits = 0;
+            u32 valid = 1;
+            for(u64 i = 0; i < 16; i++)
+            {
+                bits |= chunk[i];
+                valid &= (chunk[i] < 0x110000);
+            }
+            if(bits < 0x80)
+            {
+                oc_utf8_ascii_from_utf32(chunk, 16, (u8*)backing + byteOffset);
+                byteOffset += 16;
+                codePointIndex += 16;
+                continue;
+            }
+            else if(valid)
+            {
+                byteOffset += oc_utf8_encode_valid(chunk, 16, (u8*)backing + byteOffset);
+                codePointIndex += 16;
+                continue;
+            }
+        }
+        else
+        {
+            u64 ascii = oc_utf8_ascii_from_utf32(chunk,
+                                                 oc_min(codePoints.len - codePointIndex, maxBytes - byteOffset),
+                                                 (u8*)backing + byteOffset);
+            codePointIndex += ascii;
+            byteOffset += ascii;
+        }
+
+        if(codePointIndex < codePoints.len)
+        {
+            oc_utf32 codePoint = codePoints.ptr[codePointIndex];
+            u32 byteCount = oc_utf8_codepoint_size(codePoint);
+            if(byteOffset + byteCount > maxBytes)
+            {
+                break;
+            }
+            oc_utf8_encode(backing + byteOffset, codePoint);
+            byteOffset += byteCount;
+            codePointIndex++;
         }
-        oc_utf8_encode(backing + byteOffset, codePoint);
-        byteOffset += byteCount;
     }
     oc_str8 res = { .ptr = backing, .len = byteOffset };
     return (res);
 }
 
+u64 oc_utf8_ascii_to_utf16(oc_str8 src, u16* dst)
+{
+    const u8* s = (const u8*)src.ptr;
+    u64 i = 0;
+#if OC_UTF8_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 16 <= src.len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        if(_mm_movemask_epi8(v))
+        {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#elif OC_UTF8_NEON
+    for(; i + 16 <= src.len; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(s + i);
+        if(vmaxvq_u8(v) >= 0x80)
+        {
+            break;
+        }
+        vst1q_u16(dst + i, vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(dst + i + 8, vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+    for(; i < src.len && s[i] < 0x80; i++)
+    {
+        dst[i] = s[i];
+    }
+    return (i);
+}
+
+u64 oc_utf16_ascii_to_utf8(oc_str16 src, char* dst)
+{
+    u64 i = 0;
+#if OC_UTF8_SSE2
+    const __m128i notAscii = _mm_set1_epi16(~0x7f);
+    for(; i + 16 <= src.len; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src.ptr + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src.ptr + i + 8));
+        __m128i bits = _mm_and_si128(_mm_or_si128(a, b), notAscii);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(bits, _mm_setzero_si128())) != 0xffff)
+        {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+    }
+#elif OC_UTF8_NEON
+    for(; i + 16 <= src.len; i += 16)
+    {
+        uint16x8_t a = vld1q_u16(src.ptr + i);
+        uint16x8_t b = vld1q_u16(src.ptr + i + 8);
+        if(vmaxvq_u16(vorrq_u16(a, b)) >= 0x80)
+        {
+            break;
+        }
+        vst1q_u8((u8*)dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+#endif
+    for(; i < src.len && src.ptr[i] < 0x80; i++)
+    {
+        dst[i] = (char)src.ptr[i];
+    }
+    return (i);
+}
+
 oc_str32 oc_utf8_push_to_codepoints(oc_allocator* allocator, oc_str8 string)
 {
     u64 count = oc_utf8_codepoint_count_for_string(string);
@@ -54,6 +54,7 @@ typedef struct oc_utf8_dec
 
 ORCA_API oc_utf8_dec oc_utf8_decode(oc_str8 string);                //NOTE: decode a single oc_utf8 sequence at start of string
 ORCA_API oc_utf8_dec oc_utf8_decode_at(oc_str8 string, u64 offset); //NOTE: decode a single oc_utf8 sequence starting at byte offset
+ORCA_API u64 oc_utf8_valid_prefix_size(oc_str8 string);               //NOTE: size of the longest prefix of string that decodes without errors
 ORCA_API oc_str8 oc_utf8_encode(char* dst, oc_utf32 codePoint);     //NOTE: encode codepoint into backing buffer dst
 
 ORCA_API oc_str32 oc_utf8_to_codepoints(u64 maxCount, oc_utf32* backing, oc_str8 string);
@@ -62,6 +63,11 @@ ORCA_API oc_str8 oc_utf8_from_codepoints(u64 maxBytes, char* backing, oc_str32 c
 ORCA_API oc_str32 oc_utf8_push_to_codepoints(oc_allocator* allocator, oc_str8 string);
 ORCA_API oc_str8 oc_utf8_push_from_codepoints(oc_allocator* allocator, oc_str32 codePoints);
 
+//NOTE: convert the leading ASCII characters of src to dst, which must have room for src.len elements, and return
+//      the number of characters converted
+ORCA_API u64 oc_utf8_ascii_to_utf16(oc_str8 src, u16* dst);
+ORCA_API u64 oc_utf16_ascii_to_utf8(oc_str16 src, char* dst);
+
 //-----------------------------------------------------------------
 // oc_utf8 range struct and X-macros for defining oc_utf8 ranges
 //-----------------------------------------------------------------
@@ -684,32 +684,27 @@ void wa_debug_info_import_variables(wa_module* module, wa_debug_info* info, dw_i
 // emitting bytecode mapping
 //-------------------------------------------------------------------------
 
+//NOTE: if a location is pushed several times, the first mapping is kept
+
 void wa_warm_to_wasm_loc_push(wa_module* module, u32 funcIndex, u32 codeIndex, wa_instr* instr)
 {
-    wa_bytecode_mapping* mapping = oc_arena_push_type(module->arena, wa_bytecode_mapping);
-    mapping->funcIndex = funcIndex;
-    mapping->codeIndex = codeIndex;
-    mapping->instr = instr;
-
     u64 id = (u64)funcIndex << 32 | (u64)codeIndex;
-    u64 hash = oc_hash_xx64_string((oc_str8){ .ptr = (char*)&id, .len = 8 });
-    u64 index = hash % module->debugInfo->warmToWasmMapLen;
-
-    oc_list_push_back(&module->debugInfo->warmToWasmMap[index], &mapping->listElt);
+    bool inserted = false;
+    oc_hash_map_entry* entry = oc_hash_map_insert_u64(&module->debugInfo->warmToWasmMap, id, &inserted);
+    if(inserted)
+    {
+        entry->ptr = instr;
+    }
 }
 
 void wa_wasm_to_warm_loc_push(wa_module* module, u32 funcIndex, u32 codeIndex, wa_instr* instr)
 {
-    wa_bytecode_mapping* mapping = oc_arena_push_type(module->arena, wa_bytecode_mapping);
-    mapping->funcIndex = funcIndex;
-    mapping->codeIndex = codeIndex;
-    mapping->instr = instr;
-
-    u64 id = mapping->instr->loc.start;
-    u64 hash = oc_hash_xx64_string((oc_str8){ .ptr = (char*)&id, .len = 8 });
-    u64 index = hash % module->debugInfo->wasmToWarmMapLen;
-
-    oc_list_push_back(&module->debugInfo->wasmToWarmMap[index], &mapping->listElt);
+    bool inserted = false;
+    oc_hash_map_entry* entry = oc_hash_map_insert_u64(&module->debugInfo->wasmToWarmMap, instr->loc.start, &inserted);
+    if(inserted)
+    {
+        entry->value = (u64)funcIndex << 32 | (u64)codeIndex;
+    }
 }
 
 //-------------------------------------------------------------------------
@@ -856,12 +851,15 @@ wa_debug_info* wa_debug_info_create(wa_module* module, oc_str8 contents)
 {
     wa_debug_info* info = oc_arena_push_type(module->arena, wa_debug_info);
 
-    //NOTE: alloc warm to wasm maps
-    //TODO: tune size
-    info->warmToWasmMapLen = 4096;
-    info->warmToWasmMap = oc_arena_push_array(module->arena, oc_list, 4096);
-    info->wasmToWarmMapLen = 4096;
-    info->wasmToWarmMap = oc_arena_push_array(module->arena, oc_list, 4096);
+    //NOTE: alloc warm to wasm maps, sized for one mapping per wasm instruction. The warm to wasm map grows
+    //      if more opcodes are emitted.
+    u64 instrCount = 0;
+    for(u32 funcIndex = 0; funcIndex < module->functionCount; funcIndex++)
+    {
+        instrCount += oc_list_count(module->functions[funcIndex].instructions);
+    }
+    oc_hash_map_init(&info->warmToWasmMap, module->arena->allocator, instrCount);
+    oc_hash_map_init(&info->wasmToWarmMap, module->arena->allocator, instrCount);
 
 #if WA_ENABLE_DEBUGGER
     //NOTE: get dwarf sections
@@ -24,21 +24,12 @@ typedef struct wa_wasm_loc
 wa_wasm_loc wa_wasm_loc_from_warm_loc(wa_warm_loc loc)
 {
     u64 id = (u64)loc.funcIndex << 32 | (u64)loc.codeIndex;
-    u64 hash = oc_hash_xx64_string((oc_str8){ .ptr = (char*)&id, .len = 8 });
-    u64 index = hash % loc.module->debugInfo->warmToWasmMapLen;
+    oc_hash_map_entry* entry = oc_hash_map_find_u64(&loc.module->debugInfo->warmToWasmMap, id);
 
-    wa_instr* instr = 0;
-    oc_list_for(loc.module->debugInfo->warmToWasmMap[index], mapping, wa_bytecode_mapping, listElt)
-    {
-        if(mapping->funcIndex == loc.funcIndex && mapping->codeIndex == loc.codeIndex)
-        {
-            instr = mapping->instr;
-            break;
-        }
-    }
     wa_wasm_loc result = { 0 };
-    if(instr)
+    if(entry)
     {
+        wa_instr* instr = entry->ptr;
         result.module = loc.module;
         result.offset = instr->loc.start;
     }
@@ -56,20 +47,12 @@ wa_warm_loc wa_warm_loc_from_wasm_loc(wa_wasm_loc loc)
 {
     wa_warm_loc result = { 0 };
 
-    u64 id = loc.offset;
-    u64 hash = oc_hash_xx64_string((oc_str8){ .ptr = (char*)&id, .len = 8 });
-    u64 index = hash % loc.module->debugInfo->wasmToWarmMapLen;
-
-    wa_instr* instr = 0;
-    oc_list_for(loc.module->debugInfo->wasmToWarmMap[index], mapping, wa_bytecode_mapping, listElt)
+    oc_hash_map_entry* entry = oc_hash_map_find_u64(&loc.module->debugInfo->wasmToWarmMap, loc.offset);
+    if(entry)
     {
-        if(mapping->instr->loc.start == loc.offset)
-        {
-            result.module = loc.module;
-            result.funcIndex = mapping->funcIndex;
-            result.codeIndex = mapping->codeIndex;
-            break;
-        }
+        result.module = loc.module;
+        result.funcIndex = entry->value >> 32;
+        result.codeIndex = entry->value & 0xffffffff;
     }
     OC_DEBUG_ASSERT(result.module);
 
@@ -38,16 +38,6 @@ typedef struct wa_wasm_to_line_entry
     wa_line_loc loc;
 } wa_wasm_to_line_entry;
 
-typedef struct wa_bytecode_mapping
-{
-    oc_list_links listElt;
-
-    u32 funcIndex;
-    u32 codeIndex;
-    wa_instr* instr;
-
-} wa_bytecode_mapping;
-
 //------------------------------------------------------------------------
 // wasm stack slot to register mappings
 //------------------------------------------------------------------------
@@ -213,11 +203,11 @@ typedef struct wa_debug_info
     u64 wasmToLineCount;
     wa_wasm_to_line_entry* wasmToLine;
 
-    u32 warmToWasmMapLen;
-    oc_list* warmToWasmMap;
+    //NOTE: maps (funcIndex << 32 | codeIndex) to the wasm instruction the warm opcode was emitted for
+    oc_hash_map warmToWasmMap;
 
-    u32 wasmToWarmMapLen;
-    oc_list* wasmToWarmMap;
+    //NOTE: maps wasm offsets to the (funcIndex << 32 | codeIndex) of the corresponding warm opcode
+    oc_hash_map wasmToWarmMap;
 
     wa_register_map** registerMaps;
 
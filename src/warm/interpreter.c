@@ -2211,7 +2211,11 @@ wa_interpreter* wa_interpreter_create(oc_arena* arena)
     oc_platform_memory_commit(alloc, interpreter->localsBuffer, WA_LOCALS_BUFFER_SIZE * sizeof(wa_value));
 
     interpreter->locals = interpreter->localsBuffer;
-    oc_arena_init(&interpreter->arena);
+    oc_pool_init(&interpreter->pool);
+
+    oc_hash_map_init(&interpreter->breakpointMap, 0, 0);
+    oc_hash_map_init(&interpreter->lineBreakpointMap, 0, 0);
+    oc_hash_map_init(&interpreter->trapMap, 0, 0);
 
     interpreter->controlStack[0] = (wa_call_frame){
         .native = true,
@@ -2226,7 +2230,11 @@ void wa_interpreter_destroy(wa_interpreter* interpreter)
     oc_platform_memory* alloc = oc_platform_memory_default();
     oc_platform_memory_release(alloc, interpreter->localsBuffer, WA_LOCALS_BUFFER_SIZE * sizeof(wa_value));
 
-    oc_arena_cleanup(&interpreter->arena);
+    oc_hash_map_cleanup(&interpreter->breakpointMap);
+    oc_hash_map_cleanup(&interpreter->lineBreakpointMap);
+    oc_hash_map_cleanup(&interpreter->trapMap);
+
+    oc_pool_cleanup(&interpreter->pool);
 }
 
 wa_status wa_interpreter_init(wa_interpreter* interpreter,
@@ -2396,19 +2404,27 @@ typedef struct wa_trap
     u64 count;
 } wa_trap;
 
+static u64 wa_warm_loc_key(wa_warm_loc* loc)
+{
+    return (((u64)loc->funcIndex << 32) | loc->codeIndex);
+}
+
+static u64 wa_line_loc_key(wa_line_loc* loc)
+{
+    return ((loc->fileIndex << 32) | (loc->line & 0xffffffff));
+}
+
 wa_breakpoint* wa_interpreter_find_breakpoint(wa_interpreter* interpreter, wa_warm_loc* loc)
 {
     wa_breakpoint* result = 0;
 
-    oc_list_for(interpreter->breakpoints, bp, wa_breakpoint, listElt)
+    oc_hash_map_entry* entry = oc_hash_map_find_u64(&interpreter->breakpointMap, wa_warm_loc_key(loc));
+    if(entry)
     {
-        if(bp->isLine == false
-           && bp->warmLoc.module == loc->module
-           && bp->warmLoc.funcIndex == loc->funcIndex
-           && bp->warmLoc.codeIndex == loc->codeIndex)
+        wa_breakpoint* bp = entry->ptr;
+        if(bp->warmLoc.module == loc->module)
         {
             result = bp;
-            break;
         }
     }
 
@@ -2419,14 +2435,13 @@ wa_breakpoint* wa_interpreter_find_breakpoint_line(wa_interpreter* interpreter,
 {
     wa_breakpoint* result = 0;
 
-    oc_list_for(interpreter->breakpoints, bp, wa_breakpoint, listElt)
+    oc_hash_map_entry* entry = oc_hash_map_find_u64(&interpreter->lineBreakpointMap, wa_line_loc_key(loc));
+    if(entry)
     {
-        if(bp->isLine == true
-           && bp->lineLoc.fileIndex == loc->fileIndex
-           && bp->lineLoc.line == loc->line)
+        wa_breakpoint* bp = entry->ptr;
+        if(bp->lineLoc.fileIndex == loc->fileIndex && bp->lineLoc.line == loc->line)
         {
             result = bp;
-            break;
         }
     }
 
@@ -2437,14 +2452,13 @@ wa_trap* wa_interpreter_find_trap(wa_interpreter* interpreter, wa_warm_loc* loc)
 {
     wa_trap* result = 0;
 
-    oc_list_for(interpreter->traps, trap, wa_trap, listElt)
+    oc_hash_map_entry* entry = oc_hash_map_find_u64(&interpreter->trapMap, wa_warm_loc_key(loc));
+    if(entry)
     {
-        if(trap->loc.module == loc->module
-           && trap->loc.funcIndex == loc->funcIndex
-           && trap->loc.codeIndex == loc->codeIndex)
+        wa_trap* trap = entry->ptr;
+        if(trap->loc.module == loc->module)
         {
             result = trap;
-            break;
         }
     }
 
@@ -2456,17 +2470,10 @@ void wa_interpreter_add_trap(wa_interpreter* interpreter, wa_warm_loc* loc)
     wa_trap* trap = wa_interpreter_find_trap(interpreter, loc);
     if(!trap)
     {
-        trap = oc_list_pop_front_elt(&interpreter->trapFreeList, wa_trap, listElt);
-        if(!trap)
-        {
-            trap = oc_arena_push_type(&interpreter->arena, wa_trap);
-        }
-        else
-        {
-            memset(trap, 0, sizeof(wa_trap));
-        }
+        trap = oc_pool_push_type(&interpreter->pool, wa_trap);
         trap->loc = *loc;
         oc_list_push_back(&interpreter->traps, &trap->listElt);
+        oc_hash_map_insert_u64(&interpreter->trapMap, wa_warm_loc_key(loc), 0)->ptr = trap;
 
         wa_func* func = &interpreter->instance->functions[trap->loc.funcIndex];
         trap->savedOpcode = func->code[trap->loc.codeIndex];
@@ -2487,7 +2494,8 @@ void wa_interpreter_remove_trap(wa_interpreter* interpreter, wa_warm_loc* loc)
             func->code[trap->loc.codeIndex] = trap->savedOpcode;
 
             oc_list_remove(&interpreter->traps, &trap->listElt);
-            oc_list_push_front(&interpreter->trapFreeList, &trap->listElt);
+            oc_hash_map_erase_u64(&interpreter->trapMap, wa_warm_loc_key(&trap->loc));
+            oc_pool_free_type(&interpreter->pool, trap, wa_trap);
         }
     }
 }
@@ -2497,14 +2505,11 @@ wa_breakpoint* wa_interpreter_add_breakpoint(wa_interpreter* interpreter, wa_war
     wa_breakpoint* bp = wa_interpreter_find_breakpoint(interpreter, loc);
     if(bp == 0)
     {
-        bp = oc_list_pop_front_elt(&interpreter->breakpointFreeList, wa_breakpoint, listElt);
-        if(!bp)
-        {
-            bp = oc_arena_push_type(&interpreter->arena, wa_breakpoint);
-        }
+        bp = oc_pool_push_type(&interpreter->pool, wa_breakpoint);
         bp->isLine = false;
         bp->warmLoc = *loc;
         oc_list_push_back(&interpreter->breakpoints, &bp->listElt);
+        oc_hash_map_insert_u64(&interpreter->breakpointMap, wa_warm_loc_key(loc), 0)->ptr = bp;
 
         wa_interpreter_add_trap(interpreter, loc);
     }
@@ -2524,14 +2529,11 @@ wa_breakpoint* wa_interpreter_add_breakpoint_line(wa_interpreter* interpreter, w
         if(warmLoc.module)
         {
 
-            bp = oc_list_pop_front_elt(&interpreter->breakpointFreeList, wa_breakpoint, listElt);
-            if(!bp)
-            {
-                bp = oc_arena_push_type(&interpreter->arena, wa_breakpoint);
-            }
+            bp = oc_pool_push_type(&interpreter->pool, wa_breakpoint);
             bp->isLine = true;
             bp->lineLoc = *loc;
             oc_list_push_back(&interpreter->breakpoints, &bp->listElt);
+            oc_hash_map_insert_u64(&interpreter->lineBreakpointMap, wa_line_loc_key(loc), 0)->ptr = bp;
 
             wa_interpreter_add_trap(interpreter, &warmLoc);
         }
@@ -2546,15 +2548,17 @@ void wa_interpreter_remove_breakpoint(wa_interpreter* interpreter, wa_breakpoint
     {
         loc = wa_warm_loc_from_line_loc(interpreter->instance->module,
                                         bp->lineLoc);
+        oc_hash_map_erase_u64(&interpreter->lineBreakpointMap, wa_line_loc_key(&bp->lineLoc));
     }
     else
     {
         loc = bp->warmLoc;
+        oc_hash_map_erase_u64(&interpreter->breakpointMap, wa_warm_loc_key(&bp->warmLoc));
     }
     wa_interpreter_remove_trap(interpreter, &loc);
 
     oc_list_remove(&interpreter->breakpoints, &bp->listElt);
-    oc_list_push_back(&interpreter->breakpointFreeList, &bp->listElt);
+    oc_pool_free_type(&interpreter->pool, bp, wa_breakpoint);
 }
 
 wa_instr_op wa_trap_saved_opcode(wa_trap* trap)
@@ -363,11 +363,15 @@ typedef struct wa_interpreter
     _Atomic(bool) suspend;
     bool terminated;
 
-    oc_arena arena;
+    oc_pool pool; // breakpoints and traps
     oc_list breakpoints;
-    oc_list breakpointFreeList;
     oc_list traps;
-    oc_list trapFreeList;
+
+    //NOTE: the lists above are kept for iteration, these maps index breakpoints and traps by location.
+    //      Warm locations are keyed by funcIndex<<32 | codeIndex, and line locations by fileIndex<<32 | line.
+    oc_hash_map breakpointMap;
+    oc_hash_map lineBreakpointMap;
+    oc_hash_map trapMap;
 
     wa_code cachedRegs[WA_MAX_REG];
 
@@ -0,0 +1,351 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+#define OC_NO_APP_LAYER 1
+#include "orca.c"
+#include "graphics/graphics_common.c"
+#include "graphics/wgpu_canvas_encoder.c"
+#include "util/tests.c"
+
+//------------------------------------------------------------------------------------------
+// Test scene
+//------------------------------------------------------------------------------------------
+
+enum
+{
+    TEST_IMAGE_COUNT = OC_WGPU_CANVAS_MAX_IMAGE_BINDINGS + 4,
+};
+
+typedef struct test_scene
+{
+    u32 primitiveCount;
+    oc_primitive* primitives;
+    u32 attributeCount;
+    oc_attributes* attributes;
+    u32 eltCount;
+    oc_path_elt* elements;
+
+} test_scene;
+
+static u32 test_rand(u64* state)
+{
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return ((u32)(*state >> 33));
+}
+
+static f32 test_randf(u64* state, f32 min, f32 max)
+{
+    return (min + (max - min) * (test_rand(state) & 0xffff) / 65535.f);
+}
+
+static oc_vec2 test_rand_point(u64* state, oc_vec2 center)
+{
+    return ((oc_vec2){ center.x + test_randf(state, -50, 50), center.y + test_randf(state, -50, 50) });
+}
+
+//NOTE: random mix of fills, strokes and rects, using different attributes, gradients and a few
+//      more images than can be bound in a batch. Some fills don't start with a move, so that they
+//      depend on the end point of the previous fill.
+static test_scene test_scene_create(oc_arena* arena, u32 primitiveCount, u64 seed)
+{
+    test_scene scene = { 0 };
+    u64 state = seed;
+
+    scene.attributeCount = 64;
+    scene.attributes = oc_arena_push_array(arena, oc_attributes, scene.attributeCount);
+
+    for(u32 i = 0; i < scene.attributeCount; i++)
+    {
+        oc_attributes* attributes = &scene.attributes[i];
+        memset(attributes, 0, sizeof(oc_attributes));
+
+        f32 scale = test_randf(&state, 0.5, 2);
+        attributes->transform = (oc_mat2x3){ scale, 0, test_randf(&state, -100, 100),
+                                             0, scale, test_randf(&state, -100, 100) };
+        attributes->clip = (oc_rect){ -FLT_MAX / 2, -FLT_MAX / 2, FLT_MAX, FLT_MAX };
+        attributes->width = test_randf(&state, 1, 20);
+        attributes->tolerance = 1;
+        attributes->joint = test_rand(&state) % 3;
+        attributes->maxJointExcursion = 10;
+        attributes->cap = test_rand(&state) % 2;
+
+        for(u32 colorIndex = 0; colorIndex < 4; colorIndex++)
+        {
+            attributes->colors[colorIndex] = (oc_color){ { test_randf(&state, 0, 1), 0.5, 0.5, 1 }, OC_COLOR_SPACE_RGB };
+        }
+        if(i < TEST_IMAGE_COUNT)
+        {
+            attributes->image = (oc_image){ 1 + i };
+            attributes->srcRegion = (oc_rect){ 0, 0, 16, 16 };
+        }
+        else if(i % 4 == 1)
+        {
+            attributes->hasGradient = true;
+        }
+    }
+
+    scene.primitiveCount = primitiveCount;
+    scene.primitives = oc_arena_push_array(arena, oc_primitive, primitiveCount);
+    scene.elements = oc_arena_push_array(arena, oc_path_elt, primitiveCount * 16);
+
+    for(u32 i = 0; i < primitiveCount; i++)
+    {
+        oc_primitive* primitive = &scene.primitives[i];
+        memset(primitive, 0, sizeof(oc_primitive));
+
+        //NOTE: textured primitives are rare, so that batches span many primitives
+        if(test_rand(&state) % 256)
+        {
+            primitive->attributesIndex = TEST_IMAGE_COUNT + test_rand(&state) % (scene.attributeCount - TEST_IMAGE_COUNT);
+        }
+        else
+        {
+            primitive->attributesIndex = test_rand(&state) % scene.attributeCount;
+        }
+        primitive->color = (oc_color){ { 1, test_randf(&state, 0, 1), 0, 1 }, OC_COLOR_SPACE_RGB };
+
+        oc_vec2 center = { test_randf(&state, 0, 1000), test_randf(&state, 0, 800) };
+        u32 kind = test_rand(&state) % 8;
+        if(kind < 2)
+        {
+            primitive->cmd = OC_CMD_RECT_FILL;
+            primitive->rect = (oc_rect){ center.x, center.y, test_randf(&state, 1, 100), test_randf(&state, 1, 100) };
+            primitive->radius = (kind == 0) ? test_randf(&state, 1, 20) : 0;
+        }
+        else
+        {
+            primitive->cmd = (kind < 5) ? OC_CMD_FILL : OC_CMD_STROKE;
+            primitive->path.startIndex = scene.eltCount;
+
+            u32 count = 2 + test_rand(&state) % 11;
+            for(u32 eltIndex = 0; eltIndex < count; eltIndex++)
+            {
+                oc_path_elt* elt = &scene.elements[scene.eltCount + eltIndex];
+                if(eltIndex == 0 && (primitive->cmd == OC_CMD_STROKE || test_rand(&state) % 4))
+                {
+                    elt->type = OC_PATH_MOVE;
+                }
+                else if(eltIndex > 2 && test_rand(&state) % 8 == 0)
+                {
+                    elt->type = OC_PATH_MOVE;
+                }
+                else
+                {
+                    elt->type = OC_PATH_LINE + test_rand(&state) % 3;
+                }
+                for(u32 pointIndex = 0; pointIndex < 3; pointIndex++)
+                {
+                    elt->p[pointIndex] = test_rand_point(&state, center);
+                }
+            }
+            primitive->path.count = count;
+            primitive->path.startPoint = scene.elements[scene.eltCount].p[0];
+            scene.eltCount += count;
+        }
+    }
+    return (scene);
+}
+
+//------------------------------------------------------------------------------------------
+// Encoding
+//------------------------------------------------------------------------------------------
+
+typedef struct test_batch
+{
+    oc_list_links listElt;
+    u32 pathBatchStart;
+    u32 pathCount;
+    u32 eltCount;
+    u32 maxSegmentCount;
+    u32 maxBinQueueCount;
+    u32 maxTileOpCount;
+    u32 imageCount;
+    oc_image imageBindings[OC_WGPU_CANVAS_MAX_IMAGE_BINDINGS];
+    oc_wgpu_path* paths;
+    oc_wgpu_path_elt* elements;
+
+} test_batch;
+
+static oc_list test_encode(oc_arena* arena, test_scene* scene, oc_wgpu_canvas_encoder* encoder, u64 bufferLimit)
+{
+    oc_list batches = { 0 };
+
+    oc_wgpu_canvas_encoding_context context = {
+        .encoder = encoder,
+        .inputPrimitiveCount = scene->primitiveCount,
+        .inputPrimitives = scene->primitives,
+        .inputAttributeCount = scene->attributeCount,
+        .inputAttributes = scene->attributes,
+        .inputEltCount = scene->eltCount,
+        .inputElements = scene->elements,
+        .screenSize = { 1000, 800 },
+        .scale = { 2, 2 },
+        .tileSize = 16,
+        .screenTilesCount = (2000 / 16) * (1600 / 16),
+        .bufferLimit = bufferLimit,
+    };
+
+    while(true)
+    {
+        oc_scratch scratch = oc_scratch_begin_on_arena(arena);
+        context.arena = arena;
+        u32 pathBatchStart = context.pathBatchStart;
+
+        if(!oc_wgpu_canvas_encode_primitives(&context))
+        {
+            break;
+        }
+
+        //NOTE: copy results before the encoder's arena memory is reused
+        oc_wgpu_path* paths = oc_malloc_array(oc_wgpu_path, context.pathCount);
+        oc_wgpu_path_elt* elements = oc_malloc_array(oc_wgpu_path_elt, context.eltCount);
+        memcpy(paths, context.pathData, context.pathCount * sizeof(oc_wgpu_path));
+        memcpy(elements, context.elementData, context.eltCount * sizeof(oc_wgpu_path_elt));
+
+        oc_scratch_end(scratch);
+
+        test_batch* batch = oc_arena_push_type(arena, test_batch);
+        *batch = (test_batch){
+            .pathBatchStart = pathBatchStart,
+            .pathCount = context.pathCount,
+            .eltCount = context.eltCount,
+            .maxSegmentCount = context.maxSegmentCount,
+            .maxBinQueueCount = context.maxBinQueueCount,
+            .maxTileOpCount = context.maxTileOpCount,
+            .imageCount = context.imageCount,
+            .paths = paths,
+            .elements = elements,
+        };
+        memcpy(batch->imageBindings, context.imageBindings, sizeof(batch->imageBindings));
+        oc_list_push_back(&batches, &batch->listElt);
+    }
+    return (batches);
+}
+
+static void test_free_batches(oc_list batches)
+{
+    oc_list_for(batches, batch, test_batch, listElt)
+    {
+        free(batch->paths);
+        free(batch->elements);
+    }
+}
+
+//NOTE: compares the fields that are written by the encoder. uvTransform is only written for
+//      textured and gradient paths, and unused element points are left as is.
+static bool test_compare_batches(oc_test_info* info, oc_list expected, oc_list actual)
+{
+    test_batch* a = oc_list_first_elt(expected, test_batch, listElt);
+    test_batch* b = oc_list_first_elt(actual, test_batch, listElt);
+
+    for(; a && b; a = oc_list_next_elt(a, test_batch, listElt), b = oc_list_next_elt(b, test_batch, listElt))
+    {
+        if(a->pathBatchStart != b->pathBatchStart
+           || a->pathCount != b->pathCount
+           || a->eltCount != b->eltCount
+           || a->maxSegmentCount != b->maxSegmentCount
+           || a->maxBinQueueCount != b->maxBinQueueCount
+           || a->maxTileOpCount != b->maxTileOpCount
+           || a->imageCount != b->imageCount
+           || memcmp(a->imageBindings, b->imageBindings, a->imageCount * sizeof(oc_image)))
+        {
+            oc_test_fail(info, "batch starting at primitive %u differs", a->pathBatchStart);
+            return (false);
+        }
+        for(u32 pathIndex = 0; pathIndex < a->pathCount; pathIndex++)
+        {
+            oc_wgpu_path* pa = &a->paths[pathIndex];
+            oc_wgpu_path* pb = &b->paths[pathIndex];
+            u64 offset = offsetof(oc_wgpu_path, colors);
+            bool textured = pa->textureID >= 0 || pa->hasGradient;
+
+            if(memcmp((char*)pa + offset, (char*)pb + offset, sizeof(oc_wgpu_path) - offset)
+               || (textured && memcmp(pa->uvTransform, pb->uvTransform, sizeof(pa->uvTransform))))
+            {
+                oc_test_fail(info, "path %u of batch starting at primitive %u differs", pathIndex, a->pathBatchStart);
+                return (false);
+            }
+        }
+        for(u32 eltIndex = 0; eltIndex < a->eltCount; eltIndex++)
+        {
+            oc_wgpu_path_elt* ea = &a->elements[eltIndex];
+            oc_wgpu_path_elt* eb = &b->elements[eltIndex];
+            u32 pointCount = (ea->kind == OC_PATH_LINE) ? 2 : ((ea->kind == OC_PATH_QUADRATIC) ? 3 : 4);
+
+            if(ea->pathIndex != eb->pathIndex
+               || ea->kind != eb->kind
+               || memcmp(ea->p, eb->p, pointCount * sizeof(oc_vec2)))
+            {
+                oc_test_fail(info, "element %u of batch starting at primitive %u differs", eltIndex, a->pathBatchStart);
+                return (false);
+            }
+        }
+    }
+    if(a || b)
+    {
+        oc_test_fail(info, "batch count differs");
+        return (false);
+    }
+    return (true);
+}
+
+//------------------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------------------
+
+static void test_parallel_encoding(oc_test_info* info, u32 threadCount)
+{
+    oc_arena arena = { 0 };
+    oc_arena_init(&arena);
+
+    test_scene scene = test_scene_create(&arena, 20000, 12345);
+    oc_wgpu_canvas_encoder* encoder = oc_wgpu_canvas_encoder_create(threadCount);
+
+    u64 limits[] = { UINT32_MAX, 64 << 20, 16 << 20 };
+
+    for(u32 i = 0; i < oc_array_size(limits); i++)
+    {
+        oc_str8 name = oc_str8_pushf(arena.allocator, "buffer limit %llu", (unsigned long long)limits[i]);
+        oc_test_str8(info, name)
+        {
+            oc_list serial = test_encode(&arena, &scene, 0, limits[i]);
+            oc_list parallel = test_encode(&arena, &scene, encoder, limits[i]);
+
+            if(oc_list_empty(serial))
+            {
+                oc_test_fail(info, "no batch encoded");
+            }
+            else
+            {
+                test_compare_batches(info, serial, parallel);
+            }
+            test_free_batches(serial);
+            test_free_batches(parallel);
+        }
+    }
+
+    oc_wgpu_canvas_encoder_destroy(encoder);
+    oc_arena_cleanup(&arena);
+}
+
+int main(int argc, char** argv)
+{
+    oc_test_info info = { 0 };
+    oc_test_init(&info, "canvas_encoder", OC_TEST_PRINT_ALL);
+
+    oc_test_group(&info, "serial and parallel encoders match (2 threads)")
+    {
+        test_parallel_encoding(&info, 2);
+    }
+    oc_test_group(&info, "serial and parallel encoders match (7 threads)")
+    {
+        test_parallel_encoding(&info, 7);
+    }
+
+    oc_test_summary(&info);
+    return info.totalFailed ? -1 : 0;
+}
@@ -163,6 +163,113 @@ void test_seek(oc_test_info* info, oc_arena* arena)
     }
 }
 
+void test_positional(oc_test_info* info, oc_arena* arena)
+{
+    oc_test(info, "pread")
+    {
+        oc_str8 path = oc_path_append(arena->allocator, TEST_DIR, OC_STR8("data/regular.txt"));
+
+        oc_file f = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, 0))
+        {
+            oc_test_fail(info, "Can't open file %.*s for reading", oc_str8_ip(path));
+        }
+        else
+        {
+            char buffer[256];
+            u64 n = oc_file_pread(f, 11, 7, buffer);
+            if(oc_str8_cmp(oc_str8_from_buffer(n, buffer), OC_STR8("regular")))
+            {
+                oc_test_fail(info, "pread didn't return the expected string");
+            }
+
+            //NOTE: reading past the end of the file returns a short count
+            n = oc_file_pread(f, 19, 256, buffer);
+            if(oc_file_last_error(f) || oc_str8_cmp(oc_str8_from_buffer(n, buffer), OC_STR8("txt")))
+            {
+                oc_test_fail(info, "pread at the end of the file didn't return a short count");
+            }
+
+            //NOTE: the file position is unchanged
+            check_string(info, f, OC_STR8("Hello from regular.txt"));
+        }
+        oc_file_close(f);
+    }
+
+    oc_test(info, "readv")
+    {
+        oc_str8 path = oc_path_append(arena->allocator, TEST_DIR, OC_STR8("data/regular.txt"));
+
+        oc_file f = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, 0))
+        {
+            oc_test_fail(info, "Can't open file %.*s for reading", oc_str8_ip(path));
+        }
+        else
+        {
+            char hello[5];
+            char from[6];
+            char rest[256];
+            oc_io_vec vecs[] = {
+                { .buffer = hello, .size = sizeof(hello) },
+                { .buffer = from, .size = sizeof(from) },
+                { .buffer = rest, .size = sizeof(rest) },
+            };
+            u64 n = oc_file_readv(f, 0, oc_array_size(vecs), vecs);
+            if(n != 22
+               || oc_str8_cmp(oc_str8_from_buffer(5, hello), OC_STR8("Hello"))
+               || oc_str8_cmp(oc_str8_from_buffer(6, from), OC_STR8(" from "))
+               || oc_str8_cmp(oc_str8_from_buffer(11, rest), OC_STR8("regular.txt")))
+            {
+                oc_test_fail(info, "readv didn't return the expected strings");
+            }
+            check_string(info, f, OC_STR8("Hello from regular.txt"));
+        }
+        oc_file_close(f);
+    }
+
+    oc_test(info, "pwrite and writev")
+    {
+        oc_str8 path = oc_path_append(arena->allocator, TEST_DIR, OC_STR8("data/positional_test.txt"));
+
+        oc_file f = oc_catch(oc_file_open(path,
+                                          OC_FILE_ACCESS_READ | OC_FILE_ACCESS_WRITE,
+                                          &(oc_file_open_options){
+                                              .flags = OC_FILE_OPEN_CREATE | OC_FILE_OPEN_TRUNCATE,
+                                          }))
+        {
+            oc_test_fail(info, "Can't create/open file %.*s for writing", oc_str8_ip(path));
+        }
+        else
+        {
+            oc_file_write(f, 12, "............");
+
+            oc_io_vec vecs[] = {
+                { .buffer = "ab", .size = 2 },
+                { .buffer = "cde", .size = 3 },
+            };
+            if(oc_file_pwrite(f, 0, 3, "xyz") != 3
+               || oc_file_writev(f, 6, oc_array_size(vecs), vecs) != 5)
+            {
+                oc_test_fail(info, "Error while writing %.*s", oc_str8_ip(path));
+            }
+
+            //NOTE: the file position is still at the end of the first write
+            oc_file_write(f, 2, "!!");
+            oc_file_seek(f, 0, OC_FILE_SEEK_SET);
+            check_string(info, f, OC_STR8("xyz...abcde.!!"));
+
+            //NOTE: positional writes require write access
+            oc_file_close(f);
+            f = oc_file_open(path, OC_FILE_ACCESS_READ, 0).value;
+            if(oc_file_pwrite(f, 0, 3, "xyz") || oc_file_last_error(f) != OC_IO_ERR_PERM)
+            {
+                oc_test_fail(info, "Incorrectly wrote to read-only file");
+            }
+        }
+        oc_file_close(f);
+        remove(path.ptr);
+    }
+}
+
 void test_stat_size(oc_test_info* info, oc_arena* arena)
 {
     oc_test(info, "size")
@@ -1458,10 +1565,188 @@ void test_copy(oc_test_info* info, oc_arena* arena)
         oc_file_close(test);
     }
 
+    oc_test(info, "copy large tree")
+    {
+        //NOTE: enough files to fill the copy queue and start the copy workers
+        u32 dirCount = 4;
+        u32 fileCount = 2 * OC_IO_COPY_QUEUE_SIZE;
+        for(u32 dirIndex = 0; dirIndex < dirCount; dirIndex++)
+        {
+            oc_str8 dir = oc_str8_pushf(arena->allocator, "tree/dir%u", dirIndex);
+            oc_file_makedir(dir,
+                            &(oc_file_makedir_options){
+                                .root = tmpDir,
+                                .flags = OC_FILE_MAKEDIR_CREATE_PARENTS,
+                            });
+
+            for(u32 fileIndex = 0; fileIndex < fileCount; fileIndex++)
+            {
+                oc_str8 path = oc_str8_pushf(arena->allocator, "tree/dir%u/file%u.txt", dirIndex, fileIndex);
+                oc_file f = oc_file_open(path,
+                                         OC_FILE_ACCESS_WRITE,
+                                         &(oc_file_open_options){
+                                             .root = tmpDir,
+                                             .flags = OC_FILE_OPEN_CREATE,
+                                         })
+                                .value;
+                oc_file_write(f, path.len, path.ptr);
+                oc_file_close(f);
+            }
+        }
+
+        oc_io_error error = oc_file_copy(OC_STR8("tree"),
+                                         OC_STR8("treecopy"),
+                                         &(oc_file_copy_options){
+                                             .srcRoot = tmpDir,
+                                             .dstRoot = tmpDir,
+                                         });
+        if(error != OC_IO_OK)
+        {
+            oc_test_fail(info, "copy large tree failed.");
+        }
+
+        bool ok = (error == OC_IO_OK);
+        for(u32 dirIndex = 0; dirIndex < dirCount && ok; dirIndex++)
+        {
+            for(u32 fileIndex = 0; fileIndex < fileCount && ok; fileIndex++)
+            {
+                oc_str8 path = oc_str8_pushf(arena->allocator, "treecopy/dir%u/file%u.txt", dirIndex, fileIndex);
+                oc_file f = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, &(oc_file_open_options){ .root = tmpDir }))
+                {
+                    oc_test_fail(info, "Couldn't open copied file %.*s.", oc_str8_ip(path));
+                    ok = false;
+                }
+                else
+                {
+                    ok = !check_string(info, f, oc_str8_pushf(arena->allocator, "tree/dir%u/file%u.txt", dirIndex, fileIndex));
+                    oc_file_close(f);
+                }
+            }
+        }
+        oc_file_remove(OC_STR8("tree"), &(oc_file_remove_options){ .root = tmpDir, .flags = OC_FILE_REMOVE_RECURSIVE });
+        oc_file_remove(OC_STR8("treecopy"), &(oc_file_remove_options){ .root = tmpDir, .flags = OC_FILE_REMOVE_RECURSIVE });
+    }
+
     oc_file_close(dataDir);
     oc_file_close(tmpDir);
 }
 
+void test_file_table(oc_test_info* info, oc_arena* arena)
+{
+    oc_test(info, "open more files than a slot chunk")
+    {
+        oc_str8 path = oc_path_append(arena->allocator, TEST_DIR, OC_STR8("data/regular.txt"));
+
+        u32 fileCount = 3 * OC_IO_FILE_SLOT_CHUNK_SIZE + 1;
+        oc_file* files = oc_arena_push_array(arena, oc_file, fileCount);
+        u32 openCount = 0;
+
+        for(; openCount < fileCount; openCount++)
+        {
+            files[openCount] = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, 0))
+            {
+                oc_test_fail(info, "Can't open file %u", openCount);
+                break;
+            }
+        }
+        if(openCount == fileCount)
+        {
+            check_string(info, files[0], OC_STR8("Hello from regular.txt"));
+            check_string(info, files[fileCount - 1], OC_STR8("Hello from regular.txt"));
+        }
+        for(u32 i = 0; i < openCount; i++)
+        {
+            oc_file_close(files[i]);
+        }
+    }
+}
+
+void test_dir_cache(oc_test_info* info, oc_arena* arena)
+{
+    oc_file tmpDir = oc_file_nil();
+    oc_test(info, "make tmp dir")
+    {
+        tmpDir = oc_catch(oc_file_maketmp(OC_FILE_MAKETMP_DIRECTORY))
+        {
+            oc_test_fail(info, "Can't make tmp directory.");
+        }
+    }
+
+    oc_str8 path = OC_STR8("assets/textures/a.txt");
+
+    for(int pass = 0; pass < 2; pass++)
+    {
+        oc_test(info, pass ? "recreate removed directory" : "create directory")
+        {
+            oc_io_error error = oc_file_makedir(OC_STR8("assets/textures"),
+                                                &(oc_file_makedir_options){
+                                                    .root = tmpDir,
+                                                    .flags = OC_FILE_MAKEDIR_CREATE_PARENTS,
+                                                });
+            if(error != OC_IO_OK)
+            {
+                oc_test_fail(info, "Can't create directory.");
+            }
+
+            oc_str8 contents = pass ? OC_STR8("second") : OC_STR8("first");
+            oc_file f = oc_catch(oc_file_open(path,
+                                              OC_FILE_ACCESS_WRITE,
+                                              &(oc_file_open_options){
+                                                  .root = tmpDir,
+                                                  .flags = OC_FILE_OPEN_CREATE,
+                                              }))
+            {
+                oc_test_fail(info, "Can't create file.");
+            }
+            else
+            {
+                oc_file_write(f, contents.len, contents.ptr);
+                oc_file_close(f);
+            }
+
+            //NOTE: open twice, so that the second open goes through the cached directory
+            for(int i = 0; i < 2; i++)
+            {
+                f = oc_catch(oc_file_open(path, OC_FILE_ACCESS_READ, &(oc_file_open_options){ .root = tmpDir }))
+                {
+                    oc_test_fail(info, "Can't open file.");
+                }
+                else
+                {
+                    check_string(info, f, contents);
+                    oc_file_close(f);
+                }
+            }
+        }
+
+        oc_test(info, pass ? "remove recreated directory" : "remove directory")
+        {
+            oc_io_error error = oc_file_remove(OC_STR8("assets"),
+                                               &(oc_file_remove_options){
+                                                   .root = tmpDir,
+                                                   .flags = OC_FILE_REMOVE_DIR | OC_FILE_REMOVE_RECURSIVE,
+                                               });
+            if(error != OC_IO_OK)
+            {
+                oc_test_fail(info, "Can't remove directory.");
+            }
+
+            oc_file_result result = oc_file_open(path, OC_FILE_ACCESS_READ, &(oc_file_open_options){ .root = tmpDir });
+            if(oc_result_check(result))
+            {
+                oc_test_fail(info, "Opened file in removed directory.");
+                oc_file_close(result.value);
+            }
+            else if(result.error != OC_IO_ERR_NO_ENTRY)
+            {
+                oc_test_fail(info, "Opening file in removed directory should error with OC_IO_ERR_NO_ENTRY.");
+            }
+        }
+    }
+
+    oc_file_close(tmpDir);
+}
+
 oc_str8 parseTestDir(int argc, const char** argv, oc_arena* arena)
 {
     const char* test_dir_arg_prefix = "--test-dir=";
@@ -1505,6 +1790,11 @@ int main(int argc, const char** argv)
     {
         test_seek(&info, scratch.arena);
     }
+
+    oc_test_group(&info, "positional")
+    {
+        test_positional(&info, scratch.arena);
+    }
     oc_test_group(&info, "stat")
     {
         test_stat_size(&info, scratch.arena);
@@ -1545,6 +1835,14 @@ int main(int argc, const char** argv)
     {
         test_copy(&info, scratch.arena);
     }
+    oc_test_group(&info, "file table")
+    {
+        test_file_table(&info, scratch.arena);
+    }
+    oc_test_group(&info, "dir cache")
+    {
+        test_dir_cache(&info, scratch.arena);
+    }
 
     oc_test_summary(&info);
     return info.totalFailed ? -1 : 0;
@@ -0,0 +1,267 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#define OC_NO_APP_LAYER 1
+#include "orca.c"
+#include "util/tests.c"
+
+//NOTE: expected values were computed with the reference xxHash library (v0.8.3), on a buffer filled by
+//      fill_buffer(). Lengths are chosen around the boundaries between the code paths of each hash.
+enum
+{
+    BUFFER_SIZE = 10000,
+};
+
+static const u64 SEED = 0x9e3779b185ebca8dULL;
+
+typedef struct known_answer
+{
+    u64 len;
+    u64 seed;
+    u64 xx64;
+    u64 xxh3;
+} known_answer;
+
+static const known_answer KNOWN_ANSWERS[] = {
+    { 0, 0x0000000000000000ULL, 0xef46db3751d8e999ULL, 0x2d06800538d394c2ULL },
+    { 0, 0x9e3779b185ebca8dULL, 0x0b303d920ec349dfULL, 0xa8a6b918b2f0364aULL },
+    { 1, 0x0000000000000000ULL, 0xe934a84adb052768ULL, 0xc44bdff4074eecdbULL },
+    { 1, 0x9e3779b185ebca8dULL, 0x9c6678669fcd2e6dULL, 0x032be332dd766ef8ULL },
+    { 2, 0x0000000000000000ULL, 0x5d48cd60a77e23ffULL, 0x7a9978044cb8a8bbULL },
+    { 2, 0x9e3779b185ebca8dULL, 0x8469cbf08335c09cULL, 0x764b35c90519ad88ULL },
+    { 3, 0x0000000000000000ULL, 0xff7e1959cb50794aULL, 0x54247382a8d6b94dULL },
+    { 3, 0x9e3779b185ebca8dULL, 0x281b7cbb86cc6a05ULL, 0x634b8990b4976373ULL },
+    { 4, 0x0000000000000000ULL, 0x9136a0dca57457eeULL, 0xe5dc74bc51848a51ULL },
+    { 4, 0x9e3779b185ebca8dULL, 0xccfe4ead7e01983cULL, 0xaa2e7eccb0c8f747ULL },
+    { 5, 0x0000000000000000ULL, 0x9b046fb1397f09a5ULL, 0xe4243f00720306bbULL },
+    { 5, 0x9e3779b185ebca8dULL, 0x9099058d286ef837ULL, 0x5a67c87e50ed80edULL },
+    { 7, 0x0000000000000000ULL, 0x6c83909a9f01ed25ULL, 0x9941e0007f555e50ULL },
+    { 7, 0x9e3779b185ebca8dULL, 0x3c18df70e6ef9d24ULL, 0x75bdab43463f0151ULL },
+    { 8, 0x0000000000000000ULL, 0xcdbcf538e71d1348ULL, 0x24ccc9acaa9f65e4ULL },
+    { 8, 0x9e3779b185ebca8dULL, 0x768161b4e5a58dfaULL, 0x8f973410999b8f6bULL },
+    { 9, 0x0000000000000000ULL, 0x554b1ae991eda6b6ULL, 0x14d5001c15dd3f2bULL },
+    { 9, 0x9e3779b185ebca8dULL, 0x6a7ef24927b938a0ULL, 0xb3ae7333d9013f60ULL },
+    { 15, 0x0000000000000000ULL, 0x180719316d622d84ULL, 0x45556d4d6e1798bcULL },
+    { 15, 0x9e3779b185ebca8dULL, 0xac31ee102e5cf442ULL, 0x710dd5318f6f16d5ULL },
+    { 16, 0x0000000000000000ULL, 0x98c90b57fdfcb55cULL, 0x981b17d36c7498c9ULL },
+    { 16, 0x9e3779b185ebca8dULL, 0x85446bba49cb7df1ULL, 0x663f29333b4db6b1ULL },
+    { 17, 0x0000000000000000ULL, 0x0d39a2d051a30c2cULL, 0x796f5acd3a60f862ULL },
+    { 17, 0x9e3779b185ebca8dULL, 0x1dd902d73122eda0ULL, 0xf3ec5067f4306db3ULL },
+    { 31, 0x0000000000000000ULL, 0x299b39a290e6d783ULL, 0x5d516692ca764c50ULL },
+    { 31, 0x9e3779b185ebca8dULL, 0x51aaf1a336575f00ULL, 0x9b37274259c549c6ULL },
+    { 32, 0x0000000000000000ULL, 0x18b216492bb44b70ULL, 0x9feaddbdbf57eed3ULL },
+    { 32, 0x9e3779b185ebca8dULL, 0x21d817283f4b6283ULL, 0x2199fab1534893d9ULL },
+    { 33, 0x0000000000000000ULL, 0x55c8dc3e578f5b59ULL, 0xabfb2d081b400a10ULL },
+    { 33, 0x9e3779b185ebca8dULL, 0xb09782549294df85ULL, 0xad56348da574bb6dULL },
+    { 63, 0x0000000000000000ULL, 0xa9efbe0fa0f3f4e7ULL, 0x83d74a75f2c2577aULL },
+    { 63, 0x9e3779b185ebca8dULL, 0x34c3933dc0040446ULL, 0xc3ab9c8b53960dc7ULL },
+    { 64, 0x0000000000000000ULL, 0xef558f8acac2b5cdULL, 0x9cb48487720ec49dULL },
+    { 64, 0x9e3779b185ebca8dULL, 0xf90d26fed8023d61ULL, 0x4fe8895db9b8c077ULL },
+    { 65, 0x0000000000000000ULL, 0xde0f20dc2631af7aULL, 0xfd81aac4bebc3883ULL },
+    { 65, 0x9e3779b185ebca8dULL, 0x7814174cd6405beeULL, 0xad80aeec1fc9e0a7ULL },
+    { 96, 0x0000000000000000ULL, 0x105064e743edd1d9ULL, 0x935a769a7f94776fULL },
+    { 96, 0x9e3779b185ebca8dULL, 0x12cdf1480c876275ULL, 0x70cf51937e500540ULL },
+    { 97, 0x0000000000000000ULL, 0x097b16e4e9b0a2e3ULL, 0xca4ca268fd3c3a6cULL },
+    { 97, 0x9e3779b185ebca8dULL, 0xee752f0a58b68c2eULL, 0xee461d3add7ee6c9ULL },
+    { 127, 0x0000000000000000ULL, 0x3c7a21119aa662b0ULL, 0x2408ed71323d6096ULL },
+    { 127, 0x9e3779b185ebca8dULL, 0x9238093f3286f85aULL, 0x41d2f0c3f483208fULL },
+    { 128, 0x0000000000000000ULL, 0x90ca021457d96dc5ULL, 0xfcff24126754d861ULL },
+    { 128, 0x9e3779b185ebca8dULL, 0xfcef9beb2ce440a6ULL, 0x73fde75280646649ULL },
+    { 129, 0x0000000000000000ULL, 0x41c280132d697abaULL, 0x98f1b0a679a2ca29ULL },
+    { 129, 0x9e3779b185ebca8dULL, 0xaeb872c374eabf84ULL, 0x21fffdbca099c844ULL },
+    { 200, 0x0000000000000000ULL, 0x4d863378a2052d65ULL, 0xbddca58935d7c038ULL },
+    { 200, 0x9e3779b185ebca8dULL, 0xa3f3efda734b1256ULL, 0x5b899e984b88db8dULL },
+    { 239, 0x0000000000000000ULL, 0xb93713464372da03ULL, 0x16ce2b9d3b28805dULL },
+    { 239, 0x9e3779b185ebca8dULL, 0x82726d5d62f72187ULL, 0xf59f5c23fcebd3b7ULL },
+    { 240, 0x0000000000000000ULL, 0xb81838d483baee53ULL, 0x81c3c2b67f568ccfULL },
+    { 240, 0x9e3779b185ebca8dULL, 0x7c3c8490fe0c1b94ULL, 0xcc0f58c27ef3d8eeULL },
+    { 241, 0x0000000000000000ULL, 0x95d76c8b4d8fc4d6ULL, 0xc5a639ecd2030e5eULL },
+    { 241, 0x9e3779b185ebca8dULL, 0x6bd0db4ef4123409ULL, 0xdda9b0a161d4829aULL },
+    { 255, 0x0000000000000000ULL, 0xa80f35bb0dc8e3a7ULL, 0xe98f979f4ed8a197ULL },
+    { 255, 0x9e3779b185ebca8dULL, 0x03d699d52e8cd292ULL, 0x2aca7901d9538c75ULL },
+    { 256, 0x0000000000000000ULL, 0x5e3f5bf94d574981ULL, 0x55de574ad89d0ac5ULL },
+    { 256, 0x9e3779b185ebca8dULL, 0xa1cbbc0da72934feULL, 0x4d30234b7a3aa61cULL },
+    { 257, 0x0000000000000000ULL, 0xd36cf327dcf12221ULL, 0xb17fd5a8ae75bb0bULL },
+    { 257, 0x9e3779b185ebca8dULL, 0xb509344503e68f3aULL, 0x802a6fbf3cacd97cULL },
+    { 511, 0x0000000000000000ULL, 0xc049a218675dc378ULL, 0x8089715b163e7fc0ULL },
+    { 511, 0x9e3779b185ebca8dULL, 0x5d5c3ce0316b5583ULL, 0x90ec0377ba8d6002ULL },
+    { 512, 0x0000000000000000ULL, 0x4358d2fdd62b58a7ULL, 0x617e49599013cb6bULL },
+    { 512, 0x9e3779b185ebca8dULL, 0x6e1a3c5263d2def2ULL, 0x3ce457de14c27708ULL },
+    { 1023, 0x0000000000000000ULL, 0xaac72718b7620924ULL, 0x87a8f7b2f2e22496ULL },
+    { 1023, 0x9e3779b185ebca8dULL, 0xa471caee31ba9f8aULL, 0x0f0f02de8590e1b5ULL },
+    { 1024, 0x0000000000000000ULL, 0x4775bf7cace4d177ULL, 0xdd85c9b5c1109c5cULL },
+    { 1024, 0x9e3779b185ebca8dULL, 0xcfbc5e785ff33ccdULL, 0xef368a8a2ebabaefULL },
+    { 1025, 0x0000000000000000ULL, 0x847fa6006d7c2ac0ULL, 0xd870c0fa13211c6aULL },
+    { 1025, 0x9e3779b185ebca8dULL, 0x880172cbae03711fULL, 0x96792bcf9af88519ULL },
+    { 2047, 0x0000000000000000ULL, 0xf3a36f0a22c9e50aULL, 0xb36ece19fca2197fULL },
+    { 2047, 0x9e3779b185ebca8dULL, 0xba73b142c86d9e12ULL, 0x8111bb82842ed0aeULL },
+    { 2048, 0x0000000000000000ULL, 0x5940f2752bc04387ULL, 0xdd59e2c3a5f038e0ULL },
+    { 2048, 0x9e3779b185ebca8dULL, 0x896b632400e68878ULL, 0x66f81670669ababcULL },
+    { 2049, 0x0000000000000000ULL, 0x3bac0fef077cbfb5ULL, 0xd3afa4329779b921ULL },
+    { 2049, 0x9e3779b185ebca8dULL, 0xf0a0e59e9a2b90aaULL, 0xe48083836cd58024ULL },
+    { 4096, 0x0000000000000000ULL, 0xab77f4af85f4e70bULL, 0xe91206429d1f48f9ULL },
+    { 4096, 0x9e3779b185ebca8dULL, 0x7b950d3ad86dcd2cULL, 0x2a3bbb20a5439dcdULL },
+    { 10000, 0x0000000000000000ULL, 0x5bdc1f52e70f2a4cULL, 0xbcd883507019ca90ULL },
+    { 10000, 0x9e3779b185ebca8dULL, 0x7d58ccb8cb3eb5d0ULL, 0xcb4fc4745fe1706bULL },
+};
+
+typedef struct known_string
+{
+    oc_str8 string;
+    u64 xx64;
+    u64 xxh3;
+} known_string;
+
+static const known_string KNOWN_STRINGS[] = {
+    { OC_STR8_LIT(""), 0xef46db3751d8e999ULL, 0x2d06800538d394c2ULL },
+    { OC_STR8_LIT("a"), 0xd24ec4f1a98c6e5bULL, 0xe6c632b61e964e1fULL },
+    { OC_STR8_LIT("abc"), 0x44bc2cf5ad770999ULL, 0x78af5f94892f3950ULL },
+    { OC_STR8_LIT("message digest"), 0x066ed728fceeb3beULL, 0x160d8e9329be94f9ULL },
+    { OC_STR8_LIT("abcdefghijklmnopqrstuvwxyz"), 0xcfe1f278fa89835cULL, 0x810f9ca067fbb90cULL },
+    { OC_STR8_LIT("The quick brown fox jumps over the lazy dog"), 0x0b242d361fda71bcULL, 0xce7d19a5418fb365ULL },
+};
+
+static u8 buffer[BUFFER_SIZE];
+
+static void fill_buffer(void)
+{
+    u64 gen = 0x9e3779b1;
+    for(u64 i = 0; i < BUFFER_SIZE; i++)
+    {
+        buffer[i] = (u8)(gen >> 56);
+        gen *= SEED;
+    }
+}
+
+void test_known_answers(oc_test_info* info)
+{
+    oc_test_group(info, "known answers")
+    {
+        oc_test(info, "xxHash64")
+        {
+            for(u64 i = 0; i < oc_array_size(KNOWN_ANSWERS) && !info->statusSet; i++)
+            {
+                const known_answer* answer = &KNOWN_ANSWERS[i];
+                u64 hash = oc_hash_xx64_string_seed((oc_str8){ (char*)buffer, answer->len }, answer->seed);
+                if(hash != answer->xx64)
+                {
+                    oc_test_fail(info, "length %llu, seed %llx: got %016llx, expected %016llx.",
+                                 (unsigned long long)answer->len,
+                                 (unsigned long long)answer->seed,
+                                 (unsigned long long)hash,
+                                 (unsigned long long)answer->xx64);
+                }
+            }
+            for(u64 i = 0; i < oc_array_size(KNOWN_STRINGS) && !info->statusSet; i++)
+            {
+                if(oc_hash_xx64_string(KNOWN_STRINGS[i].string) != KNOWN_STRINGS[i].xx64)
+                {
+                    oc_test_fail(info, "wrong hash for \"%.*s\".", oc_str8_ip(KNOWN_STRINGS[i].string));
+                }
+            }
+        }
+
+        oc_test(info, "XXH3")
+        {
+            for(u64 i = 0; i < oc_array_size(KNOWN_ANSWERS) && !info->statusSet; i++)
+            {
+                const known_answer* answer = &KNOWN_ANSWERS[i];
+                u64 hash = oc_hash_xxh3_string_seed((oc_str8){ (char*)buffer, answer->len }, answer->seed);
+                if(hash != answer->xxh3)
+                {
+                    oc_test_fail(info, "length %llu, seed %llx: got %016llx, expected %016llx.",
+                                 (unsigned long long)answer->len,
+                                 (unsigned long long)answer->seed,
+                                 (unsigned long long)hash,
+                                 (unsigned long long)answer->xxh3);
+                }
+            }
+            for(u64 i = 0; i < oc_array_size(KNOWN_STRINGS) && !info->statusSet; i++)
+            {
+                if(oc_hash_xxh3_string(KNOWN_STRINGS[i].string) != KNOWN_STRINGS[i].xxh3)
+                {
+                    oc_test_fail(info, "wrong hash for \"%.*s\".", oc_str8_ip(KNOWN_STRINGS[i].string));
+                }
+            }
+        }
+    }
+}
+
+void test_streaming(oc_test_info* info)
+{
+    oc_test_group(info, "streaming")
+    {
+        oc_test(info, "known answers")
+        {
+            //NOTE: feed each input in pieces of varying sizes, so that pieces straddle the internal buffer
+            u64 pieceSizes[] = { 1, 7, 64, 100, 255, 256, 1000 };
+
+            for(u64 i = 0; i < oc_array_size(KNOWN_ANSWERS) && !info->statusSet; i++)
+            {
+                const known_answer* answer = &KNOWN_ANSWERS[i];
+                for(u64 j = 0; j < oc_array_size(pieceSizes) && !info->statusSet; j++)
+                {
+                    oc_hash_xxh3_state state;
+                    oc_hash_xxh3_init(&state, answer->seed);
+
+                    u64 offset = 0;
+                    for(u64 k = 0; offset < answer->len; k++)
+                    {
+                        u64 size = oc_min(pieceSizes[(j + k) % oc_array_size(pieceSizes)], answer->len - offset);
+                        oc_hash_xxh3_update(&state, (oc_str8){ (char*)buffer + offset, size });
+                        offset += size;
+                    }
+
+                    u64 hash = oc_hash_xxh3_digest(&state);
+                    if(hash != answer->xxh3)
+                    {
+                        oc_test_fail(info, "length %llu, pieces of %llu bytes: got %016llx, expected %016llx.",
+                                     (unsigned long long)answer->len,
+                                     (unsigned long long)pieceSizes[j],
+                                     (unsigned long long)hash,
+                                     (unsigned long long)answer->xxh3);
+                    }
+                }
+            }
+        }
+
+        oc_test(info, "intermediate digests")
+        {
+            //NOTE: taking a digest must not change the state
+            oc_hash_xxh3_state state;
+            oc_hash_xxh3_init(&state, 0);
+
+            u64 offset = 0;
+            while(offset < BUFFER_SIZE && !info->statusSet)
+            {
+                u64 size = oc_min((u64)333, BUFFER_SIZE - offset);
+                oc_hash_xxh3_update(&state, (oc_str8){ (char*)buffer + offset, size });
+                offset += size;
+
+                u64 hash = oc_hash_xxh3_digest(&state);
+                if(hash != oc_hash_xxh3_string((oc_str8){ (char*)buffer, offset }))
+                {
+                    oc_test_fail(info, "wrong digest after %llu bytes.", (unsigned long long)offset);
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    oc_test_info info = { 0 };
+    oc_test_init(&info, "hash", OC_TEST_PRINT_ALL);
+
+    fill_buffer();
+    test_known_answers(&info);
+    test_streaming(&info);
+
+    oc_test_summary(&info);
+    return info.totalFailed ? -1 : 0;
+}
@@ -0,0 +1,270 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#define OC_NO_APP_LAYER 1
+#include "orca.c"
+#include "util/tests.c"
+
+enum
+{
+    KEY_RANGE = 4096,
+    ITERATION_COUNT = 200000,
+};
+
+static oc_test_rng rng;
+
+//NOTE: checks the map against a reference array indexed by key, where a value of 0 means the key is absent
+static bool check_map(oc_hash_map* map, u64* reference, u64 keyStride)
+{
+    u64 count = 0;
+    for(u64 i = 0; i < KEY_RANGE; i++)
+    {
+        oc_hash_map_entry* entry = oc_hash_map_find_u64(map, i * keyStride);
+        if((entry != 0) != (reference[i] != 0) || (entry && entry->value != reference[i]))
+        {
+            return (false);
+        }
+        count += reference[i] ? 1 : 0;
+    }
+
+    u64 iterated = 0;
+    oc_hash_map_for(map, entry)
+    {
+        u64 index = entry->key / keyStride;
+        if(index >= KEY_RANGE || reference[index] != entry->value)
+        {
+            return (false);
+        }
+        iterated++;
+    }
+    return (count == map->count && iterated == count);
+}
+
+static bool random_ops(oc_hash_map* map, u64 keyStride)
+{
+    u64* reference = calloc(KEY_RANGE, sizeof(u64));
+    bool result = true;
+
+    for(u64 i = 0; i < ITERATION_COUNT && result; i++)
+    {
+        u64 index = oc_test_rng_next(&rng) % KEY_RANGE;
+        u64 key = index * keyStride;
+        u32 op = oc_test_rng_next(&rng) % 8;
+
+        if(op < 4)
+        {
+            bool inserted = false;
+            oc_hash_map_entry* entry = oc_hash_map_insert_u64(map, key, &inserted);
+            if(inserted != (reference[index] == 0) || entry->key != key)
+            {
+                result = false;
+            }
+            entry->value = i + 1;
+            reference[index] = i + 1;
+        }
+        else if(op < 7)
+        {
+            bool erased = oc_hash_map_erase_u64(map, key);
+            if(erased != (reference[index] != 0))
+            {
+                result = false;
+            }
+            reference[index] = 0;
+        }
+        else
+        {
+            oc_hash_map_entry* entry = oc_hash_map_find_u64(map, key);
+            if((entry != 0) != (reference[index] != 0))
+            {
+                result = false;
+            }
+        }
+
+        if(i % 10000 == 0)
+        {
+            result = result && check_map(map, reference, keyStride);
+        }
+    }
+    result = result && check_map(map, reference, keyStride);
+
+    free(reference);
+    return (result);
+}
+
+void test_u64(oc_test_info* info)
+{
+    oc_test_group(info, "u64 keys")
+    {
+        oc_test(info, "random operations")
+        {
+            oc_hash_map map;
+            oc_hash_map_init(&map, 0, 0);
+            if(!random_ops(&map, 1))
+            {
+                oc_test_fail(info, "map doesn't match reference.");
+            }
+            oc_hash_map_cleanup(&map);
+        }
+
+        oc_test(info, "colliding keys")
+        {
+            //NOTE: keys with the same low bits, that only differ in bits above the table size
+            oc_hash_map map;
+            oc_hash_map_init(&map, 0, 0);
+            if(!random_ops(&map, 1ULL << 40))
+            {
+                oc_test_fail(info, "map doesn't match reference.");
+            }
+            oc_hash_map_cleanup(&map);
+        }
+
+        oc_test(info, "arena allocator")
+        {
+            oc_arena arena;
+            oc_arena_init(&arena);
+            oc_hash_map map;
+            oc_hash_map_init(&map, arena.allocator, 10);
+            if(!random_ops(&map, 3))
+            {
+                oc_test_fail(info, "map doesn't match reference.");
+            }
+            oc_arena_cleanup(&arena);
+        }
+
+        oc_test(info, "erase while iterating")
+        {
+            oc_hash_map map;
+            oc_hash_map_init(&map, 0, 0);
+            for(u64 i = 0; i < 1000; i++)
+            {
+                oc_hash_map_insert_u64(&map, i, 0)->value = i;
+            }
+            oc_hash_map_for(&map, entry)
+            {
+                if(entry->key % 2)
+                {
+                    oc_hash_map_erase_entry(&map, entry);
+                }
+            }
+            bool ok = (map.count == 500);
+            for(u64 i = 0; i < 1000 && ok; i++)
+            {
+                ok = ((oc_hash_map_find_u64(&map, i) != 0) == !(i % 2));
+            }
+            if(!ok)
+            {
+                oc_test_fail(info, "wrong entries after erasing.");
+            }
+
+            oc_hash_map_clear(&map);
+            if(map.count || oc_hash_map_find_u64(&map, 0) || oc_hash_map_next(&map, 0))
+            {
+                oc_test_fail(info, "map not empty after clearing.");
+            }
+            oc_hash_map_cleanup(&map);
+        }
+
+        oc_test(info, "tombstone reuse")
+        {
+            //NOTE: a map with a stable size but a churning set of keys can grow once, to keep enough room between
+            //      rehashes, but must then reuse deleted slots instead of growing forever
+            oc_hash_map map;
+            oc_hash_map_init(&map, 0, 100);
+            u64 cap = map.cap;
+            for(u64 i = 0; i < 100000; i++)
+            {
+                oc_hash_map_insert_u64(&map, i, 0);
+                if(i >= 100)
+                {
+                    oc_hash_map_erase_u64(&map, i - 100);
+                }
+            }
+            if(map.count != 100 || map.cap > 2 * cap)
+            {
+                oc_test_fail(info, "map grew to %llu slots.", (unsigned long long)map.cap);
+            }
+            oc_hash_map_cleanup(&map);
+        }
+    }
+}
+
+void test_str8(oc_test_info* info)
+{
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    oc_test_group(info, "string keys")
+    {
+        oc_test(info, "insert, find and erase")
+        {
+            oc_hash_map map;
+            oc_hash_map_init(&map, arena.allocator, 0);
+
+            oc_str8* keys = oc_arena_push_array(&arena, oc_str8, KEY_RANGE);
+            for(u64 i = 0; i < KEY_RANGE; i++)
+            {
+                keys[i] = oc_str8_pushf(arena.allocator, "key_%llu", (unsigned long long)i);
+                bool inserted = false;
+                oc_hash_map_insert_str8(&map, keys[i], &inserted)->value = i;
+                if(!inserted)
+                {
+                    oc_test_fail(info, "key %llu already present.", (unsigned long long)i);
+                    break;
+                }
+            }
+
+            //NOTE: look up copies of the keys, to check that strings are compared by contents
+            for(u64 i = 0; i < KEY_RANGE && !info->statusSet; i++)
+            {
+                oc_str8 copy = oc_str8_push_copy(arena.allocator, keys[i]);
+                oc_hash_map_entry* entry = oc_hash_map_find_str8(&map, copy);
+                if(!entry || entry->value != i || oc_str8_cmp(entry->string, keys[i]))
+                {
+                    oc_test_fail(info, "couldn't find key %llu.", (unsigned long long)i);
+                }
+                if((i % 3 == 0) && !oc_hash_map_erase_str8(&map, copy))
+                {
+                    oc_test_fail(info, "couldn't erase key %llu.", (unsigned long long)i);
+                }
+            }
+            for(u64 i = 0; i < KEY_RANGE && !info->statusSet; i++)
+            {
+                if((oc_hash_map_find_str8(&map, keys[i]) != 0) != (i % 3 != 0))
+                {
+                    oc_test_fail(info, "wrong state for key %llu.", (unsigned long long)i);
+                }
+            }
+            if(oc_hash_map_find_str8(&map, OC_STR8("key")) || oc_hash_map_find_str8(&map, (oc_str8){ 0 }))
+            {
+                oc_test_fail(info, "found a missing key.");
+            }
+
+            bool inserted = false;
+            oc_hash_map_insert_str8(&map, (oc_str8){ 0 }, &inserted);
+            if(!inserted || !oc_hash_map_find_str8(&map, OC_STR8("")))
+            {
+                oc_test_fail(info, "couldn't insert the empty string.");
+            }
+        }
+    }
+
+    oc_arena_cleanup(&arena);
+}
+
+int main()
+{
+    oc_test_info info = { 0 };
+    oc_test_init(&info, "hash_map", OC_TEST_PRINT_ALL);
+    rng = oc_test_rng_seed(1234567);
+
+    test_u64(&info);
+    test_str8(&info);
+
+    oc_test_summary(&info);
+    return info.totalFailed ? -1 : 0;
+}
@@ -0,0 +1,366 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#define OC_NO_APP_LAYER 1
+#include "orca.c"
+#include "util/json.c"
+#include "util/tests.c"
+
+static oc_test_rng rng;
+
+static void random_string(oc_str8_list* list, oc_arena* arena)
+{
+    static const char* pieces[] = { "a", "orca", "key", " ", "_", "\\n", "\\\"", "\\\\", "\\u00e9", "\\/", "\\ud83d\\ude00", "\xc3\xa9" };
+
+    oc_str8_list_push(arena->allocator, list, OC_STR8("\""));
+    u32 count = oc_test_rng_next(&rng) % 8;
+    for(u32 i = 0; i < count; i++)
+    {
+        oc_str8_list_push(arena->allocator, list, OC_STR8(pieces[oc_test_rng_next(&rng) % oc_array_size(pieces)]));
+    }
+    oc_str8_list_push(arena->allocator, list, OC_STR8("\""));
+}
+
+//NOTE: generates documents using only the features supported by json_parse_str8(), ie. no exponents, and fractions
+//      that are exact in binary, so that both parsers give the same numbers.
+static void random_value(oc_str8_list* list, oc_arena* arena, int depth)
+{
+    u32 kind = oc_test_rng_next(&rng) % ((depth < 6) ? 8 : 6);
+    switch(kind)
+    {
+        case 0:
+            oc_str8_list_push(arena->allocator, list, OC_STR8("null"));
+            break;
+        case 1:
+            oc_str8_list_push(arena->allocator, list, (oc_test_rng_next(&rng) % 2) ? OC_STR8("true") : OC_STR8("false"));
+            break;
+        case 2:
+        {
+            i64 number = (i64)(oc_test_rng_next(&rng) % 2000000) - 1000000;
+            oc_str8_list_pushf(arena->allocator, list, "%lli", (long long)number);
+        }
+        break;
+        case 3:
+        {
+            i32 number = (i32)(oc_test_rng_next(&rng) % 2000) - 1000;
+            u32 eighths = oc_test_rng_next(&rng) % 8;
+            oc_str8_list_pushf(arena->allocator, list, "%s%d.%03d", (number < 0) ? "-" : "", abs(number), eighths * 125);
+        }
+        break;
+        case 4:
+        case 5:
+            random_string(list, arena);
+            break;
+        case 6:
+        case 7:
+        {
+            bool object = (kind == 6);
+            oc_str8_list_push(arena->allocator, list, object ? OC_STR8("{") : OC_STR8("[ "));
+            u32 count = oc_test_rng_next(&rng) % 6;
+            for(u32 i = 0; i < count; i++)
+            {
+                if(i)
+                {
+                    oc_str8_list_push(arena->allocator, list, OC_STR8(",\n"));
+                }
+                if(object)
+                {
+                    random_string(list, arena);
+                    oc_str8_list_push(arena->allocator, list, OC_STR8(" : "));
+                }
+                random_value(list, arena, depth + 1);
+            }
+            oc_str8_list_push(arena->allocator, list, object ? OC_STR8("}") : OC_STR8(" ]"));
+        }
+        break;
+    }
+}
+
+static bool compare_values(json_node* node, json_doc* doc, u32 index)
+{
+    json_value* value = &doc->values[index];
+    if(node->kind != value->kind || node->childCount != value->childCount)
+    {
+        return (false);
+    }
+    switch(node->kind)
+    {
+        case JSON_NUM_F64:
+            return (node->numF64 == value->numF64);
+        case JSON_NUM_I64:
+            return (node->numI64 == value->numI64);
+        case JSON_STRING:
+            return (!oc_str8_cmp(node->string, value->string));
+        case JSON_OBJECT:
+        case JSON_LIST:
+        {
+            json_node* child = oc_list_first_elt(node->children, json_node, listElt);
+            json_doc_for(doc, index, childIndex)
+            {
+                if(oc_str8_cmp(child->name, doc->values[childIndex].key)
+                   || !compare_values(child, doc, childIndex))
+                {
+                    return (false);
+                }
+                child = oc_list_next_elt(child, json_node, listElt);
+            }
+        }
+        break;
+        default:
+            break;
+    }
+    return (true);
+}
+
+void test_reader(oc_test_info* info)
+{
+    oc_test_group(info, "reader")
+    {
+        oc_test(info, "tokens")
+        {
+            oc_str8 string = OC_STR8("{ \"a\": [1, -2.5e1, \"x\\ny\"], \"b\": {}, \"c\": [], \"d\": true, \"e\": false, \"f\": null }");
+
+            json_token_kind expected[] = {
+                JSON_TOKEN_OBJECT_BEGIN,
+                JSON_TOKEN_KEY,
+                JSON_TOKEN_LIST_BEGIN,
+                JSON_TOKEN_NUM_I64,
+                JSON_TOKEN_NUM_F64,
+                JSON_TOKEN_STRING,
+                JSON_TOKEN_LIST_END,
+                JSON_TOKEN_KEY,
+                JSON_TOKEN_OBJECT_BEGIN,
+                JSON_TOKEN_OBJECT_END,
+                JSON_TOKEN_KEY,
+                JSON_TOKEN_LIST_BEGIN,
+                JSON_TOKEN_LIST_END,
+                JSON_TOKEN_KEY,
+                JSON_TOKEN_TRUE,
+                JSON_TOKEN_KEY,
+                JSON_TOKEN_FALSE,
+                JSON_TOKEN_KEY,
+                JSON_TOKEN_NULL,
+                JSON_TOKEN_OBJECT_END,
+                JSON_TOKEN_END,
+            };
+
+            json_reader reader;
+            json_reader_init(&reader, string);
+
+            for(u32 i = 0; i < oc_array_size(expected); i++)
+            {
+                json_token token = json_reader_next(&reader);
+                if(token.kind != expected[i])
+                {
+                    oc_test_fail(info, "expected %s, got %s at token %u.", json_token_kind_strings[expected[i]], json_token_kind_strings[token.kind], i);
+                    break;
+                }
+                if(token.kind == JSON_TOKEN_NUM_F64 && token.numF64 != -25)
+                {
+                    oc_test_fail(info, "wrong number %f.", token.numF64);
+                }
+                if(token.kind == JSON_TOKEN_STRING && (!token.escaped || oc_str8_cmp(token.string, OC_STR8("x\\ny"))))
+                {
+                    oc_test_fail(info, "wrong string %.*s.", oc_str8_ip(token.string));
+                }
+            }
+        }
+
+        oc_test(info, "numbers")
+        {
+            struct
+            {
+                const char* string;
+                json_token_kind kind;
+                f64 value;
+            } cases[] = {
+                { "0", JSON_TOKEN_NUM_I64, 0 },
+                { "-0", JSON_TOKEN_NUM_I64, 0 },
+                { "-17", JSON_TOKEN_NUM_I64, -17 },
+                { "123456789012345678", JSON_TOKEN_NUM_I64, 123456789012345678.0 },
+                { "0.1", JSON_TOKEN_NUM_F64, 0.1 },
+                { "-0.000123", JSON_TOKEN_NUM_F64, -0.000123 },
+                { "3.14159", JSON_TOKEN_NUM_F64, 3.14159 },
+                { "1e10", JSON_TOKEN_NUM_F64, 1e10 },
+                { "2.5E-3", JSON_TOKEN_NUM_F64, 2.5e-3 },
+                { "1e+2", JSON_TOKEN_NUM_F64, 100 },
+                { "1.7976931348623157e308", JSON_TOKEN_NUM_F64, 1.7976931348623157e308 },
+                { "4.9e-324", JSON_TOKEN_NUM_F64, 4.9e-324 },
+                { "12345678901234567890", JSON_TOKEN_NUM_F64, 12345678901234567890.0 },
+                { "0.30000000000000004", JSON_TOKEN_NUM_F64, 0.30000000000000004 },
+            };
+
+            for(u32 i = 0; i < oc_array_size(cases); i++)
+            {
+                json_reader reader;
+                json_reader_init(&reader, OC_STR8(cases[i].string));
+                json_token token = json_reader_next(&reader);
+
+                if(token.kind != cases[i].kind
+                   || token.numF64 != cases[i].value
+                   || json_reader_next(&reader).kind != JSON_TOKEN_END)
+                {
+                    oc_test_fail(info, "wrong result for %s.", cases[i].string);
+                }
+            }
+        }
+
+        oc_test(info, "errors")
+        {
+            const char* cases[] = {
+                "",
+                "{",
+                "[1, 2",
+                "[1, 2,]",
+                "{\"a\": 1,}",
+                "{\"a\" 1}",
+                "{1: 2}",
+                "[1}",
+                "{\"a\": 1]",
+                "01",
+                "1.",
+                "-",
+                "1e",
+                ".5",
+                "tru",
+                "\"abc",
+                "\"\\x\"",
+                "\"\\u12g4\"",
+                "[] []",
+                "nul",
+            };
+
+            for(u32 i = 0; i < oc_array_size(cases); i++)
+            {
+                json_reader reader;
+                json_reader_init(&reader, OC_STR8(cases[i]));
+                json_token token = { 0 };
+                for(int j = 0; j < 16; j++)
+                {
+                    token = json_reader_next(&reader);
+                    if(token.kind == JSON_TOKEN_ERROR || token.kind == JSON_TOKEN_END)
+                    {
+                        break;
+                    }
+                }
+                if(token.kind != JSON_TOKEN_ERROR || json_reader_next(&reader).kind != JSON_TOKEN_ERROR)
+                {
+                    oc_test_fail(info, "accepted invalid document '%s'.", cases[i]);
+                }
+            }
+        }
+
+        oc_test(info, "skip")
+        {
+            json_reader reader;
+            json_reader_init(&reader, OC_STR8("{\"skipped\": {\"a\": [1, [2], {\"b\": 3}]}, \"next\": 4}"));
+
+            json_reader_next(&reader);
+            json_reader_next(&reader);
+            json_token token = json_reader_skip(&reader, json_reader_next(&reader));
+            if(token.kind != JSON_TOKEN_OBJECT_END || token.depth != 1)
+            {
+                oc_test_fail(info, "skip stopped at %s.", json_token_kind_strings[token.kind]);
+            }
+            token = json_reader_next(&reader);
+            if(token.kind != JSON_TOKEN_KEY || oc_str8_cmp(token.string, OC_STR8("next")))
+            {
+                oc_test_fail(info, "wrong token after skip.");
+            }
+        }
+    }
+}
+
+void test_doc(oc_test_info* info)
+{
+    oc_arena arena;
+    oc_arena_init(&arena);
+
+    oc_test_group(info, "document")
+    {
+        oc_test(info, "find")
+        {
+            oc_str8 string = OC_STR8("{\"name\": \"orca\", \"version\": [0, 1], \"escaped\\tkey\": \"a\\u00e9\\ud83d\\ude00\", \"empty\": {}}");
+            json_doc doc = json_doc_parse(arena.allocator, string);
+
+            u32 name = json_doc_find(&doc, 0, OC_STR8("name"));
+            u32 version = json_doc_find(&doc, 0, OC_STR8("version"));
+            u32 escaped = json_doc_find(&doc, 0, OC_STR8("escaped\tkey"));
+            u32 empty = json_doc_find(&doc, 0, OC_STR8("empty"));
+
+            if(!doc.count || doc.values[0].childCount != 4)
+            {
+                oc_test_fail(info, "wrong root.");
+            }
+            else if(!name || oc_str8_cmp(doc.values[name].string, OC_STR8("orca")))
+            {
+                oc_test_fail(info, "wrong name.");
+            }
+            else if(!version || doc.values[version].childCount != 2 || doc.values[version + 2].numI64 != 1)
+            {
+                oc_test_fail(info, "wrong version.");
+            }
+            else if(!escaped || oc_str8_cmp(doc.values[escaped].string, OC_STR8("a\xc3\xa9\xf0\x9f\x98\x80")))
+            {
+                oc_test_fail(info, "wrong escaped string.");
+            }
+            else if(!empty || doc.values[empty].kind != JSON_OBJECT || doc.values[empty].end != doc.count)
+            {
+                oc_test_fail(info, "wrong empty object.");
+            }
+            else if(json_doc_find(&doc, 0, OC_STR8("missing")) || json_doc_find(&doc, version, OC_STR8("name")))
+            {
+                oc_test_fail(info, "found a missing key.");
+            }
+        }
+
+        oc_test(info, "invalid")
+        {
+            json_doc doc = json_doc_parse(arena.allocator, OC_STR8("{\"a\": [1, 2}"));
+            if(doc.count)
+            {
+                oc_test_fail(info, "parsed an invalid document.");
+            }
+        }
+
+        oc_test(info, "compare with json_parse_str8()")
+        {
+            for(u64 i = 0; i < 2000 && !info->statusSet; i++)
+            {
+                oc_arena_clear(&arena);
+
+                oc_str8_list list = { 0 };
+                random_value(&list, &arena, 0);
+                oc_str8 string = oc_str8_list_join(arena.allocator, list);
+
+                json_node* node = json_parse_str8(arena.allocator, string);
+                json_doc doc = json_doc_parse(arena.allocator, string);
+
+                if(!node || !doc.count || !compare_values(node, &doc, 0))
+                {
+                    oc_test_fail(info, "mismatch for '%.*s'.", oc_str8_ip(string));
+                }
+            }
+        }
+    }
+
+    oc_arena_cleanup(&arena);
+}
+
+int main()
+{
+    oc_test_info info = { 0 };
+    oc_test_init(&info, "json", OC_TEST_PRINT_ALL);
+    rng = oc_test_rng_seed(1234567);
+
+    test_reader(&info);
+    test_doc(&info);
+
+    oc_test_summary(&info);
+    return info.totalFailed ? -1 : 0;
+}
@@ -0,0 +1,318 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#define OC_NO_APP_LAYER 1
+#include "orca.c"
+#include "util/tests.c"
+
+enum
+{
+    SLOT_COUNT = 4096,
+    ITERATION_COUNT = 200000,
+    THREAD_COUNT = 4,
+};
+
+//NOTE: sizes are mostly small, with a few allocations above the largest size class
+static u64 random_size(oc_test_rng* rng)
+{
+    u32 r = oc_test_rng_next(rng);
+    switch(r % 8)
+    {
+        case 0:
+            return (1 + (r >> 8) % (3 * OC_POOL_MAX_SIZE));
+        case 1:
+        case 2:
+            return (1 + (r >> 8) % 1024);
+        default:
+            return (1 + (r >> 8) % 128);
+    }
+}
+
+typedef struct slot
+{
+    u8* ptr;
+    u64 size;
+    u64 alignment;
+    u8 pattern;
+} slot;
+
+static bool check_slot(slot* s)
+{
+    for(u64 i = 0; i < s->size; i++)
+    {
+        if(s->ptr[i] != s->pattern)
+        {
+            return (false);
+        }
+    }
+    return (true);
+}
+
+//NOTE: allocates and frees blocks at random, through the pool or a cache, filling each block with its own pattern
+//      and checking it before freeing it, to catch blocks that overlap.
+static bool random_ops(oc_pool* pool, oc_pool_cache* cache, u32 seed)
+{
+    slot* slots = calloc(SLOT_COUNT, sizeof(slot));
+    oc_test_rng rng = oc_test_rng_seed(seed);
+    bool result = true;
+
+    for(u64 i = 0; i < ITERATION_COUNT && result; i++)
+    {
+        slot* s = &slots[oc_test_rng_next(&rng) % SLOT_COUNT];
+        if(s->ptr)
+        {
+            result = check_slot(s);
+            if(cache)
+            {
+                oc_pool_cache_free_aligned(cache, s->ptr, s->size, s->alignment);
+            }
+            else
+            {
+                oc_pool_free_aligned(pool, s->ptr, s->size, s->alignment);
+            }
+            s->ptr = 0;
+        }
+        else
+        {
+            s->size = random_size(&rng);
+            s->alignment = 1ULL << (oc_test_rng_next(&rng) % 8);
+            s->pattern = (u8)i;
+            s->ptr = cache ? oc_pool_cache_push_aligned_uninitialized(cache, s->size, s->alignment)
+                           : oc_pool_push_aligned_uninitialized(pool, s->size, s->alignment);
+            if((u64)s->ptr & (s->alignment - 1))
+            {
+                result = false;
+            }
+            memset(s->ptr, s->pattern, s->size);
+        }
+    }
+
+    for(u64 i = 0; i < SLOT_COUNT; i++)
+    {
+        slot* s = &slots[i];
+        if(s->ptr)
+        {
+            result = result && check_slot(s);
+            if(cache)
+            {
+                oc_pool_cache_free_aligned(cache, s->ptr, s->size, s->alignment);
+            }
+            else
+            {
+                oc_pool_free_aligned(pool, s->ptr, s->size, s->alignment);
+            }
+        }
+    }
+    free(slots);
+    return (result);
+}
+
+void test_size_classes(oc_test_info* info)
+{
+    oc_test_group(info, "size classes")
+    {
+        oc_test(info, "blocks fit their size and alignment")
+        {
+            for(u64 size = 1; size <= OC_POOL_MAX_SIZE && !info->statusSet; size++)
+            {
+                for(u64 alignment = 1; alignment <= OC_POOL_MAX_SIZE && !info->statusSet; alignment *= 2)
+                {
+                    u32 index = oc_pool_class_index(size, alignment);
+                    u64 classSize = oc_pool_class_size(index);
+                    u64 slabAlignment = classSize & (~classSize + 1);
+                    if(index >= OC_POOL_SIZE_CLASS_COUNT || classSize < size || slabAlignment < oc_max(alignment, OC_POOL_MIN_ALIGNMENT))
+                    {
+                        oc_test_fail(info, "size %llu, alignment %llu: got class %u of size %llu.",
+                                     (unsigned long long)size,
+                                     (unsigned long long)alignment,
+                                     index,
+                                     (unsigned long long)classSize);
+                    }
+                }
+            }
+        }
+
+        oc_test(info, "classes are tight")
+        {
+            //NOTE: a size must go in the smallest class that fits it, and waste at most 25% above 128 bytes
+            for(u64 size = 1; size <= OC_POOL_MAX_SIZE && !info->statusSet; size++)
+            {
+                u32 index = oc_pool_class_index(size, 1);
+                u64 classSize = oc_pool_class_size(index);
+                if((index && oc_pool_class_size(index - 1) >= size) || (size > 128 && classSize > size + size / 4))
+                {
+                    oc_test_fail(info, "size %llu got class %u of size %llu.", (unsigned long long)size, index, (unsigned long long)classSize);
+                }
+            }
+            if(oc_pool_class_index(OC_POOL_MAX_SIZE + 1, 1) != OC_POOL_SIZE_CLASS_COUNT)
+            {
+                oc_test_fail(info, "sizes above OC_POOL_MAX_SIZE should be large allocations.");
+            }
+        }
+    }
+}
+
+void test_pool(oc_test_info* info)
+{
+    oc_test_group(info, "pool")
+    {
+        oc_test(info, "random operations")
+        {
+            oc_pool pool;
+            oc_pool_init(&pool);
+            if(!random_ops(&pool, 0, 1234567))
+            {
+                oc_test_fail(info, "corrupted or misaligned block.");
+            }
+            if(pool.blockSize || pool.largeSize)
+            {
+                oc_test_fail(info, "%llu bytes still allocated after freeing everything.", (unsigned long long)(pool.blockSize + pool.largeSize));
+            }
+
+            //NOTE: freed blocks are reused, so doing it again must not carve new slabs
+            u64 slabSize = pool.slabSize;
+            random_ops(&pool, 0, 1234567);
+            if(pool.slabSize != slabSize)
+            {
+                oc_test_fail(info, "slabs grew from %llu to %llu bytes.", (unsigned long long)slabSize, (unsigned long long)pool.slabSize);
+            }
+            oc_pool_cleanup(&pool);
+        }
+
+        oc_test(info, "allocator interface")
+        {
+            oc_pool pool;
+            oc_pool_init(&pool);
+
+            oc_str8 string = oc_str8_push_copy(pool.allocator, OC_STR8("hello, pool"));
+            u64* array = oc_allocator_push_array(pool.allocator, u64, 100);
+            bool zeroed = true;
+            for(int i = 0; i < 100; i++)
+            {
+                zeroed = zeroed && (array[i] == 0);
+            }
+            if(oc_str8_cmp(string, OC_STR8("hello, pool")) || !zeroed)
+            {
+                oc_test_fail(info, "wrong contents.");
+            }
+            oc_pool_free(&pool, string.ptr, string.len);
+            oc_pool_free_array(&pool, array, u64, 100);
+            if(pool.blockSize)
+            {
+                oc_test_fail(info, "blocks not freed.");
+            }
+            oc_pool_cleanup(&pool);
+        }
+
+#ifdef OC_DEBUG
+        oc_test(info, "poisoning")
+        {
+            oc_pool pool;
+            oc_pool_init(&pool);
+            u8* p = oc_pool_push_uninitialized(&pool, 64);
+            bool poisoned = true;
+            for(int i = 0; i < 64; i++)
+            {
+                poisoned = poisoned && (p[i] == OC_POOL_POISON_ALLOC);
+            }
+            oc_pool_free(&pool, p, 64);
+            for(int i = sizeof(oc_pool_block); i < 64; i++)
+            {
+                poisoned = poisoned && (p[i] == OC_POOL_POISON_FREE);
+            }
+            if(!poisoned)
+            {
+                oc_test_fail(info, "blocks are not poisoned.");
+            }
+            oc_pool_cleanup(&pool);
+        }
+#endif
+    }
+}
+
+typedef struct thread_data
+{
+    oc_pool* pool;
+    u32 seed;
+    bool result;
+} thread_data;
+
+i32 thread_proc(void* user)
+{
+    thread_data* data = (thread_data*)user;
+    oc_pool_cache cache;
+    oc_pool_cache_init(&cache, data->pool);
+    data->result = random_ops(data->pool, &cache, data->seed);
+    oc_pool_cache_flush(&cache);
+    return (0);
+}
+
+void test_caches(oc_test_info* info)
+{
+    oc_test_group(info, "caches")
+    {
+        oc_test(info, "random operations")
+        {
+            oc_pool pool;
+            oc_pool_init(&pool);
+            oc_pool_cache cache;
+            oc_pool_cache_init(&cache, &pool);
+
+            if(!random_ops(&pool, &cache, 7654321))
+            {
+                oc_test_fail(info, "corrupted or misaligned block.");
+            }
+            oc_pool_cache_flush(&cache);
+            if(pool.blockSize || pool.largeSize)
+            {
+                oc_test_fail(info, "%llu bytes still allocated after flushing.", (unsigned long long)(pool.blockSize + pool.largeSize));
+            }
+            oc_pool_cleanup(&pool);
+        }
+
+        oc_test(info, "threads")
+        {
+            oc_pool pool;
+            oc_pool_init_with_options(&pool, &(oc_pool_options){ .threadSafe = true });
+
+            thread_data data[THREAD_COUNT] = { 0 };
+            oc_thread* threads[THREAD_COUNT] = { 0 };
+            for(int i = 0; i < THREAD_COUNT; i++)
+            {
+                data[i] = (thread_data){ .pool = &pool, .seed = 1000 + i };
+                threads[i] = oc_thread_create(thread_proc, &data[i]);
+            }
+            for(int i = 0; i < THREAD_COUNT; i++)
+            {
+                oc_thread_join(threads[i], 0);
+                if(!data[i].result)
+                {
+                    oc_test_fail(info, "corrupted or misaligned block in thread %i.", i);
+                }
+            }
+            if(pool.blockSize || pool.largeSize)
+            {
+                oc_test_fail(info, "%llu bytes still allocated after flushing.", (unsigned long long)(pool.blockSize + pool.largeSize));
+            }
+            oc_pool_cleanup(&pool);
+        }
+    }
+}
+
+int main()
+{
+    oc_test_info info = { 0 };
+    oc_test_init(&info, "pool", OC_TEST_PRINT_ALL);
+
+    test_size_classes(&info);
+    test_pool(&info);
+    test_caches(&info);
+
+    oc_test_summary(&info);
+    return info.totalFailed ? -1 : 0;
+}
@@ -0,0 +1,295 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#define OC_NO_APP_LAYER 1
+#include "orca.c"
+#include "util/tests.c"
+
+//NOTE: a flat array of codepoints used as a reference implementation
+typedef struct reference_text
+{
+    oc_utf32* text;
+    u64 len;
+    u64 cap;
+} reference_text;
+
+static void reference_replace(reference_text* ref, u64 offset, u64 count, oc_str32 codepoints)
+{
+    if(ref->len - count + codepoints.len > ref->cap)
+    {
+        ref->cap = (ref->len - count + codepoints.len) * 2;
+        ref->text = realloc(ref->text, ref->cap * sizeof(oc_utf32));
+    }
+    memmove(ref->text + offset + codepoints.len, ref->text + offset + count, (ref->len - offset - count) * sizeof(oc_utf32));
+    memcpy(ref->text + offset, codepoints.ptr, codepoints.len * sizeof(oc_utf32));
+    ref->len = ref->len - count + codepoints.len;
+}
+
+static bool check_contents(oc_text_buffer* buffer, reference_text* ref)
+{
+    if(oc_text_buffer_length(buffer) != ref->len)
+    {
+        return (false);
+    }
+    oc_scratch scratch = oc_scratch_begin();
+    oc_str32 contents = oc_text_buffer_push_range(scratch.arena, buffer, 0, ref->len);
+    bool result = !memcmp(contents.ptr, ref->text, ref->len * sizeof(oc_utf32));
+    oc_scratch_end(scratch);
+    return (result);
+}
+
+static bool check_lines(oc_text_buffer* buffer, reference_text* ref)
+{
+    u64 line = 0;
+    u64 lineStart = 0;
+    for(u64 i = 0; i <= ref->len; i++)
+    {
+        if(oc_text_buffer_line_of_offset(buffer, i) != line)
+        {
+            return (false);
+        }
+        if(i == ref->len || ref->text[i] == '\n')
+        {
+            if(oc_text_buffer_line_start(buffer, line) != lineStart
+               || oc_text_buffer_line_end(buffer, line) != i)
+            {
+                return (false);
+            }
+            line++;
+            lineStart = i + 1;
+        }
+    }
+    return (oc_text_buffer_line_count(buffer) == line);
+}
+
+static oc_test_rng rng;
+
+void test_basic(oc_test_info* info)
+{
+    oc_test_group(info, "basic")
+    {
+        oc_text_buffer buffer;
+        oc_text_buffer_init_from_str8(&buffer, OC_STR8("hello\nworld\nété"));
+
+        oc_test(info, "init")
+        {
+            if(oc_text_buffer_length(&buffer) != 15 || oc_text_buffer_line_count(&buffer) != 3)
+            {
+                oc_test_fail(info, "wrong length or line count after init.");
+            }
+            if(oc_text_buffer_codepoint_at(&buffer, 12) != 0xe9)
+            {
+                oc_test_fail(info, "wrong codepoint at offset.");
+            }
+        }
+
+        oc_test(info, "lines")
+        {
+            if(oc_text_buffer_line_start(&buffer, 1) != 6
+               || oc_text_buffer_line_end(&buffer, 1) != 11
+               || oc_text_buffer_line_start(&buffer, 2) != 12
+               || oc_text_buffer_line_end(&buffer, 2) != 15
+               || oc_text_buffer_line_of_offset(&buffer, 11) != 1
+               || oc_text_buffer_line_of_offset(&buffer, 12) != 2)
+            {
+                oc_test_fail(info, "wrong line boundaries.");
+            }
+        }
+
+        oc_test(info, "replace")
+        {
+            oc_utf32 codepoints[] = { 'X', '\n', 'Y' };
+            oc_text_edit edit = oc_text_buffer_replace(&buffer, 2, 6, (oc_str32){ .ptr = codepoints, .len = 3 });
+
+            oc_scratch scratch = oc_scratch_begin();
+            oc_str8 contents = oc_text_buffer_push_str8(scratch.arena, &buffer, 0, oc_text_buffer_length(&buffer));
+            if(oc_str8_cmp(contents, OC_STR8("heX\nYrld\nété")))
+            {
+                oc_test_fail(info, "wrong contents after replace.");
+            }
+            if(edit.firstLine != 0 || edit.removedLines != 1 || edit.insertedLines != 1)
+            {
+                oc_test_fail(info, "wrong edit description.");
+            }
+            oc_scratch_end(scratch);
+        }
+
+        oc_test(info, "undo/redo")
+        {
+            oc_text_edit edit = oc_text_buffer_undo(&buffer);
+            oc_scratch scratch = oc_scratch_begin();
+            oc_str8 contents = oc_text_buffer_push_str8(scratch.arena, &buffer, 0, oc_text_buffer_length(&buffer));
+            if(oc_str8_cmp(contents, OC_STR8("hello\nworld\nété")) || edit.offset != 2 || edit.inserted != 6)
+            {
+                oc_test_fail(info, "undo didn't restore text.");
+            }
+            oc_text_buffer_redo(&buffer);
+            contents = oc_text_buffer_push_str8(scratch.arena, &buffer, 0, oc_text_buffer_length(&buffer));
+            if(oc_str8_cmp(contents, OC_STR8("heX\nYrld\nété")))
+            {
+                oc_test_fail(info, "redo didn't reapply edit.");
+            }
+            oc_scratch_end(scratch);
+        }
+
+        oc_text_buffer_cleanup(&buffer);
+    }
+}
+
+void test_coalescing(oc_test_info* info)
+{
+    oc_test_group(info, "coalescing")
+    {
+        oc_text_buffer buffer;
+        oc_text_buffer_init(&buffer);
+
+        oc_test(info, "typing")
+        {
+            const char* word = "abc def";
+            for(u64 i = 0; word[i]; i++)
+            {
+                oc_utf32 c = word[i];
+                oc_text_buffer_replace(&buffer, i, 0, (oc_str32){ .ptr = &c, .len = 1 });
+            }
+            if(buffer.deltaCount != 1 || buffer.nodeCount != 2)
+            {
+                oc_test_fail(info, "typing wasn't coalesced.");
+            }
+        }
+
+        oc_test(info, "backspace")
+        {
+            oc_text_buffer_undo_boundary(&buffer);
+            for(u64 i = 0; i < 3; i++)
+            {
+                oc_text_buffer_replace(&buffer, oc_text_buffer_length(&buffer) - 1, 1, (oc_str32){ 0 });
+            }
+            if(buffer.deltaCount != 2 || oc_text_buffer_length(&buffer) != 4)
+            {
+                oc_test_fail(info, "backspaces weren't coalesced.");
+            }
+            oc_text_buffer_undo(&buffer);
+            if(oc_text_buffer_length(&buffer) != 7 || oc_text_buffer_codepoint_at(&buffer, 6) != 'f')
+            {
+                oc_test_fail(info, "coalesced backspaces weren't undone in order.");
+            }
+        }
+
+        oc_text_buffer_cleanup(&buffer);
+    }
+}
+
+void test_random_edits(oc_test_info* info)
+{
+    oc_test_group(info, "random edits")
+    {
+        enum
+        {
+            EDIT_COUNT = 2000,
+            CHECK_PERIOD = 97,
+        };
+
+        oc_text_buffer buffer;
+        oc_text_buffer_init_from_str8(&buffer, OC_STR8("The quick brown fox\njumps over\nthe lazy dog\n"));
+
+        reference_text ref = { 0 };
+        oc_scratch scratch = oc_scratch_begin();
+        oc_str32 init = oc_text_buffer_push_range(scratch.arena, &buffer, 0, oc_text_buffer_length(&buffer));
+        reference_replace(&ref, 0, 0, init);
+
+        //NOTE: keep snapshots of the reference to check undo and redo
+        reference_text snapshots[EDIT_COUNT + 1] = { 0 };
+        reference_replace(&snapshots[0], 0, 0, init);
+        oc_scratch_end(scratch);
+
+        oc_test(info, "edits")
+        {
+            for(u64 i = 0; i < EDIT_COUNT && !info->statusSet; i++)
+            {
+                u64 offset = oc_test_rng_next(&rng) % (ref.len + 1);
+                u64 count = (oc_test_rng_next(&rng) % 4 == 0) ? oc_test_rng_next(&rng) % (ref.len - offset + 1) % 16 : 0;
+
+                oc_utf32 codepoints[8];
+                u64 insertCount = 1 + oc_test_rng_next(&rng) % 7;
+                for(u64 j = 0; j < insertCount; j++)
+                {
+                    u32 r = oc_test_rng_next(&rng) % 8;
+                    codepoints[j] = (r == 0) ? '\n' : 'a' + oc_test_rng_next(&rng) % 26;
+                }
+                oc_str32 insert = { .ptr = codepoints, .len = insertCount };
+
+                oc_text_buffer_replace(&buffer, offset, count, insert);
+                oc_text_buffer_undo_boundary(&buffer);
+                reference_replace(&ref, offset, count, insert);
+                reference_replace(&snapshots[i + 1], 0, 0, (oc_str32){ .ptr = ref.text, .len = ref.len });
+
+                if(!check_contents(&buffer, &ref))
+                {
+                    oc_test_fail(info, "contents mismatch after edit %llu.", (unsigned long long)i);
+                }
+                else if(i % CHECK_PERIOD == 0 && !check_lines(&buffer, &ref))
+                {
+                    oc_test_fail(info, "line index mismatch after edit %llu.", (unsigned long long)i);
+                }
+            }
+        }
+
+        oc_test(info, "undo all")
+        {
+            for(i64 i = buffer.undoCount; i > 0 && !info->statusSet; i--)
+            {
+                oc_text_buffer_undo(&buffer);
+                if(!check_contents(&buffer, &snapshots[i - 1]))
+                {
+                    oc_test_fail(info, "contents mismatch after undoing edit %lli.", (long long)(i - 1));
+                }
+            }
+            if(!info->statusSet && !check_lines(&buffer, &snapshots[0]))
+            {
+                oc_test_fail(info, "line index mismatch after undoing all edits.");
+            }
+        }
+
+        oc_test(info, "redo all")
+        {
+            for(u64 i = 1; oc_text_buffer_can_redo(&buffer) && !info->statusSet; i++)
+            {
+                oc_text_buffer_redo(&buffer);
+                if(!check_contents(&buffer, &snapshots[i]))
+                {
+                    oc_test_fail(info, "contents mismatch after redoing edit %llu.", (unsigned long long)(i - 1));
+                }
+            }
+            if(!info->statusSet && !check_lines(&buffer, &ref))
+            {
+                oc_test_fail(info, "line index mismatch after redoing all edits.");
+            }
+        }
+
+        for(u64 i = 0; i <= EDIT_COUNT; i++)
+        {
+            free(snapshots[i].text);
+        }
+        free(ref.text);
+        oc_text_buffer_cleanup(&buffer);
+    }
+}
+
+int main()
+{
+    oc_test_info info = { 0 };
+    oc_test_init(&info, "text_buffer", OC_TEST_PRINT_ALL);
+    rng = oc_test_rng_seed(1234567);
+
+    test_basic(&info);
+    test_coalescing(&info);
+    test_random_edits(&info);
+
+    oc_test_summary(&info);
+    return info.totalFailed ? -1 : 0;
+}
@@ -0,0 +1,337 @@
+/*************************************************************************
+*
+*  Orca
+*  Copyright 2023 Martin Fouilleul and the Orca project contributors
+*  See LICENSE.txt for licensing information
+*
+**************************************************************************/
+
+#define OC_NO_APP_LAYER 1
+#include "orca.c"
+#include "util/tests.c"
+
+//NOTE: reference implementations, decoding one codepoint at a time
+static u64 reference_count(oc_str8 string)
+{
+    u64 byteOffset = 0;
+    u64 count = 0;
+    for(; (byteOffset < string.len) && (string.ptr[byteOffset] != 0); count++)
+    {
+        byteOffset += oc_utf8_decode_at(string, byteOffset).size;
+    }
+    return (count);
+}
+
+static u64 reference_to_codepoints(u64 maxCount, oc_utf32* backing, oc_str8 string)
+{
+    u64 count = 0;
+    u64 byteOffset = 0;
+    for(; count < maxCount && byteOffset < string.len; count++)
+    {
+        oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
+        backing[count] = decode.codepoint;
+        byteOffset += decode.size;
+    }
+    return (count);
+}
+
+static u64 reference_from_codepoints(u64 maxBytes, char* backing, oc_str32 codePoints)
+{
+    u64 byteOffset = 0;
+    for(u64 i = 0; i < codePoints.len; i++)
+    {
+        u32 byteCount = oc_utf8_codepoint_size(codePoints.ptr[i]);
+        if(byteOffset + byteCount > maxBytes)
+        {
+            break;
+        }
+        oc_utf8_encode(backing + byteOffset, codePoints.ptr[i]);
+        byteOffset += byteCount;
+    }
+    return (byteOffset);
+}
+
+static u64 reference_valid_prefix_size(oc_str8 string)
+{
+    u64 byteOffset = 0;
+    while(byteOffset < string.len)
+    {
+        oc_utf8_dec decode = oc_utf8_decode_at(string, byteOffset);
+        if(decode.status != OC_UTF8_OK)
+        {
+            break;
+        }
+        byteOffset += decode.size;
+    }
+    return (oc_min(byteOffset, string.len));
+}
+
+static oc_test_rng rng;
+
+static oc_utf32 random_codepoint(void)
+{
+    switch(oc_test_rng_next(&rng) % 6)
+    {
+        case 0:
+        case 1:
+            return (0x20 + oc_test_rng_next(&rng) % 0x5f);
+        case 2:
+            return (0x80 + oc_test_rng_next(&rng) % 0x780);
+        case 3:
+            return (0x800 + oc_test_rng_next(&rng) % 0xf800);
+        case 4:
+            return (0x10000 + oc_test_rng_next(&rng) % 0x100000);
+        default:
+            return (oc_test_rng_next(&rng) % 0x110000);
+    }
+}
+
+//NOTE: random text, mostly valid, with runs of ASCII long enough to use the vectorized paths, and mutations that
+//      produce every kind of invalid sequence
+static u64 random_text(char* buffer, u64 cap)
+{
+    u64 len = 0;
+    u64 targetLen = oc_test_rng_next(&rng) % cap;
+    while(len + 4 <= targetLen)
+    {
+        if(oc_test_rng_next(&rng) % 4 == 0)
+        {
+            u64 run = oc_test_rng_next(&rng) % 80;
+            run = oc_min(run, targetLen - len);
+            for(u64 i = 0; i < run; i++)
+            {
+                buffer[len++] = 'a' + (i % 26);
+            }
+        }
+        else
+        {
+            len += oc_utf8_encode(buffer + len, random_codepoint()).len;
+        }
+    }
+
+    u32 mutationCount = (oc_test_rng_next(&rng) % 2) ? 0 : oc_test_rng_next(&rng) % 8;
+    for(u32 i = 0; i < mutationCount && len; i++)
+    {
+        u64 at = oc_test_rng_next(&rng) % len;
+        switch(oc_test_rng_next(&rng) % 5)
+        {
+            case 0:
+                buffer[at] = (char)oc_test_rng_next(&rng);
+                break;
+            case 1:
+                buffer[at] = (char)(0x80 | (oc_test_rng_next(&rng) & 0x3f));
+                break;
+            case 2:
+                buffer[at] = (char)(0xc0 | (oc_test_rng_next(&rng) & 0x3f));
+                break;
+            case 3:
+                buffer[at] = 0;
+                break;
+            default:
+            {
+                //NOTE: surrogates, overlong encodings and codepoints past U+10FFFF
+                const char* sequences[] = { "\xed\xa0\x80", "\xed\xbf\xbf", "\xe0\x80\xaf", "\xf0\x8f\xbf\xbf", "\xc1\xbf", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80" };
+                const char* sequence = sequences[oc_test_rng_next(&rng) % oc_array_size(sequences)];
+                for(u64 j = 0; sequence[j] && at + j < len; j++)
+                {
+                    buffer[at + j] = sequence[j];
+                }
+            }
+            break;
+        }
+    }
+    //NOTE: sometimes cut the text in the middle of a sequence
+    if(len && oc_test_rng_next(&rng) % 4 == 0)
+    {
+        u64 cut = oc_test_rng_next(&rng) % 3;
+        len -= oc_min(len, cut);
+    }
+    return (len);
+}
+
+enum
+{
+    TEXT_CAP = 600,
+    ITERATION_COUNT = 200000,
+};
+
+void test_decoding(oc_test_info* info)
+{
+    oc_test_group(info, "decoding")
+    {
+        char* text = malloc(TEXT_CAP);
+        oc_utf32* expected = malloc(TEXT_CAP * sizeof(oc_utf32));
+        oc_utf32* result = malloc(TEXT_CAP * sizeof(oc_utf32));
+
+        oc_test(info, "fixed cases")
+        {
+            const char* cases[] = {
+                "",
+                "ascii only, longer than a single block of the vectorized kernels",
+                "caf\xc3\xa9 na\xc3\xafve \xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e \xf0\x9f\x98\x80 and some more text after it",
+                "stray \x80 continuation in a long enough string to be vectorized",
+                "truncated 4 bytes sequence at the very end of the string \xf0\x9f\x98",
+                "surrogate \xed\xa0\x80 and overlong \xe0\x80\xaf and too large \xf4\x90\x80\x80 sequences",
+                "null byte \0 in the middle of a long enough string to be vectorized",
+            };
+            for(u64 i = 0; i < oc_array_size(cases); i++)
+            {
+                oc_str8 string = OC_STR8(cases[i]);
+                if(i == oc_array_size(cases) - 1)
+                {
+                    string.len = 66;
+                }
+                if(oc_utf8_codepoint_count_for_string(string) != reference_count(string)
+                   || oc_utf8_valid_prefix_size(string) != reference_valid_prefix_size(string))
+                {
+                    oc_test_fail(info, "mismatch for case %llu.", (unsigned long long)i);
+                    break;
+                }
+                u64 count = reference_to_codepoints(TEXT_CAP, expected, string);
+                oc_str32 codepoints = oc_utf8_to_codepoints(TEXT_CAP, result, string);
+                if(codepoints.len != count || memcmp(codepoints.ptr, expected, count * sizeof(oc_utf32)))
+                {
+                    oc_test_fail(info, "codepoints mismatch for case %llu.", (unsigned long long)i);
+                    break;
+                }
+            }
+        }
+
+        oc_test(info, "random text")
+        {
+            for(u64 i = 0; i < ITERATION_COUNT && !info->statusSet; i++)
+            {
+                //NOTE: use unaligned strings to exercise the block boundaries
+                u64 shift = oc_test_rng_next(&rng) % 8;
+                oc_str8 string = oc_str8_from_buffer(random_text(text + shift, TEXT_CAP - shift), text + shift);
+
+                if(oc_utf8_codepoint_count_for_string(string) != reference_count(string))
+                {
+                    oc_test_fail(info, "codepoint count mismatch at iteration %llu.", (unsigned long long)i);
+                }
+                else if(oc_utf8_valid_prefix_size(string) != reference_valid_prefix_size(string))
+                {
+                    oc_test_fail(info, "valid prefix mismatch at iteration %llu.", (unsigned long long)i);
+                }
+                else
+                {
+                    u64 maxCount = (oc_test_rng_next(&rng) % 2) ? TEXT_CAP : oc_test_rng_next(&rng) % TEXT_CAP;
+                    u64 count = reference_to_codepoints(maxCount, expected, string);
+                    oc_str32 codepoints = oc_utf8_to_codepoints(maxCount, result, string);
+                    if(codepoints.len != count || memcmp(codepoints.ptr, expected, count * sizeof(oc_utf32)))
+                    {
+                        oc_test_fail(info, "codepoints mismatch at iteration %llu.", (unsigned long long)i);
+                    }
+                }
+            }
+        }
+
+        free(result);
+        free(expected);
+        free(text);
+    }
+}
+
+void test_encoding(oc_test_info* info)
+{
+    oc_test_group(info, "encoding")
+    {
+        oc_utf32* codepoints = malloc(TEXT_CAP * sizeof(oc_utf32));
+        char* expected = malloc(4 * TEXT_CAP);
+        char* result = malloc(4 * TEXT_CAP);
+
+        oc_test(info, "random codepoints")
+        {
+            for(u64 i = 0; i < ITERATION_COUNT && !info->statusSet; i++)
+            {
+                u64 count = oc_test_rng_next(&rng) % TEXT_CAP;
+                bool ascii = oc_test_rng_next(&rng) % 2;
+                for(u64 j = 0; j < count; j++)
+                {
+                    //NOTE: include codepoints past U+10FFFF, which aren't encoded
+                    u32 r = oc_test_rng_next(&rng) % 64;
+                    codepoints[j] = (ascii && r) ? 'a' + r % 26 : ((r == 0) ? 0x110000 + oc_test_rng_next(&rng) % 16 : random_codepoint());
+                }
+                oc_str32 string = { .ptr = codepoints, .len = count };
+                u64 maxBytes = (oc_test_rng_next(&rng) % 2) ? 4 * TEXT_CAP : oc_test_rng_next(&rng) % (2 * TEXT_CAP);
+
+                u64 size = reference_from_codepoints(maxBytes, expected, string);
+                oc_str8 encoded = oc_utf8_from_codepoints(maxBytes, result, string);
+                if(encoded.len != size || memcmp(encoded.ptr, expected, size))
+                {
+                    oc_test_fail(info, "encoding mismatch at iteration %llu.", (unsigned long long)i);
+                }
+            }
+        }
+
+        free(result);
+        free(expected);
+        free(codepoints);
+    }
+}
+
+void test_utf16(oc_test_info* info)
+{
+    oc_test_group(info, "utf16")
+    {
+        oc_test(info, "ascii prefix")
+        {
+            char text[100];
+            u16 wide[100];
+            char back[100];
+            for(u64 i = 0; i < 10000 && !info->statusSet; i++)
+            {
+                u64 len = oc_test_rng_next(&rng) % 100;
+                for(u64 j = 0; j < len; j++)
+                {
+                    text[j] = (oc_test_rng_next(&rng) % 40) ? 'a' + oc_test_rng_next(&rng) % 26 : (char)(0x80 | oc_test_rng_next(&rng));
+                }
+                u64 expected = 0;
+                while(expected < len && (u8)text[expected] < 0x80)
+                {
+                    expected++;
+                }
+                u64 count = oc_utf8_ascii_to_utf16(oc_str8_from_buffer(len, text), wide);
+                if(count != expected)
+                {
+                    oc_test_fail(info, "wrong utf8 ascii prefix at iteration %llu.", (unsigned long long)i);
+                    break;
+                }
+                for(u64 j = 0; j < count; j++)
+                {
+                    if(wide[j] != text[j])
+                    {
+                        oc_test_fail(info, "wrong utf16 conversion at iteration %llu.", (unsigned long long)i);
+                        break;
+                    }
+                }
+
+                //NOTE: append a non-ASCII code unit, which must stop the conversion back
+                u64 wideLen = count;
+                if(oc_test_rng_next(&rng) % 2 && wideLen < 100)
+                {
+                    wide[wideLen++] = 0x80 + oc_test_rng_next(&rng) % 0xff00;
+                }
+                if(oc_utf16_ascii_to_utf8((oc_str16){ .ptr = wide, .len = wideLen }, back) != count
+                   || memcmp(back, text, count))
+                {
+                    oc_test_fail(info, "wrong utf8 conversion at iteration %llu.", (unsigned long long)i);
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    oc_test_info info = { 0 };
+    oc_test_init(&info, "utf8", OC_TEST_PRINT_ALL);
+    rng = oc_test_rng_seed(1234567);
+
+    test_decoding(&info);
+    test_encoding(&info);
+    test_utf16(&info);
+
+    oc_test_summary(&info);
+    return info.totalFailed ? -1 : 0;
+}
@@ -109,9 +109,45 @@ int test_listdir(void)
     return success;
 }
 
+int test_remove(void)
+{
+    oc_log_info("remove");
+
+    //NOTE: remove_me ships with the app and isn't opened before being removed, so it is still only in the bundle
+    oc_io_error err = oc_file_remove(OC_STR8("remove_me"), 0);
+    TEST_FAIL_ERR(err);
+
+    oc_file_result openRes = oc_file_open(OC_STR8("remove_me"), OC_FILE_ACCESS_READ, 0);
+    if(openRes.error != OC_IO_ERR_NO_ENTRY)
+    {
+        oc_log_error("removed file can still be opened, error %d\n", openRes.error);
+        if(openRes.error == OC_IO_OK)
+        {
+            oc_file_close(openRes.value);
+        }
+        return (-1);
+    }
+
+    //NOTE: a directory that still contains resources of the bundle isn't empty
+    err = oc_file_remove(OC_STR8("nested1/nested2"), &(oc_file_remove_options){ .flags = OC_FILE_REMOVE_DIR });
+    if(err == OC_IO_OK)
+    {
+        oc_log_error("removed a directory that isn't empty\n");
+        return (-1);
+    }
+
+    return (0);
+}
+
 ORCA_EXPORT i32 oc_on_test(void)
 {
     oc_log_info("testing: wasm_fileio\n");
+
+    //NOTE: test removal first, since listing directories extracts all the resources they contain
+    if(test_remove())
+    {
+        return (-1);
+    }
     if(test_listdir())
     {
         return (-1);